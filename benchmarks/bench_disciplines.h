@@ -0,0 +1,162 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include <explicit.h>
+
+namespace philote
+{
+namespace bench
+{
+    /**
+     * @brief Paraboloid discipline of the paraboloid example
+     */
+    class Paraboloid : public ExplicitDiscipline
+    {
+    public:
+        void Setup() override
+        {
+            AddInput("x", {1}, "m");
+            AddInput("y", {1}, "m");
+            AddOutput("f_xy", {1}, "m**2");
+        }
+
+        void SetupPartials() override
+        {
+            DeclarePartials("f_xy", "x");
+            DeclarePartials("f_xy", "y");
+        }
+
+        void Compute(const Variables &inputs, Variables &outputs) override
+        {
+            double x = inputs.at("x")(0);
+            double y = inputs.at("y")(0);
+
+            outputs.at("f_xy")(0) = std::pow(x - 3.0, 2.0) + x * y +
+                                    std::pow(y + 4.0, 2.0) - 3.0;
+        }
+
+        void ComputePartials(const Variables &inputs, Partials &jac) override
+        {
+            double x = inputs.at("x")(0);
+            double y = inputs.at("y")(0);
+
+            jac[std::make_pair("f_xy", "x")](0) = 2.0 * x - 6.0 + y;
+            jac[std::make_pair("f_xy", "y")](0) = 2.0 * y + 8.0 + x;
+        }
+    };
+
+    /**
+     * @brief Rosenbrock discipline of the rosenbrock example with a fixed dimension
+     */
+    class Rosenbrock : public ExplicitDiscipline
+    {
+    public:
+        explicit Rosenbrock(int64_t n) : n_(n) {}
+
+        void Setup() override
+        {
+            AddInput("x", {n_}, "");
+            AddOutput("f", {1}, "");
+        }
+
+        void SetupPartials() override
+        {
+            DeclarePartials("f", "x");
+        }
+
+        void Compute(const Variables &inputs, Variables &outputs) override
+        {
+            const Variable &x = inputs.at("x");
+
+            double f = 0.0;
+            for (int64_t i = 0; i < n_ - 1; ++i)
+                f += 100.0 * std::pow(x(i + 1) - x(i) * x(i), 2) + std::pow(1.0 - x(i), 2);
+
+            outputs.at("f")(0) = f;
+        }
+
+        void ComputePartials(const Variables &inputs, Partials &jac) override
+        {
+            const Variable &x = inputs.at("x");
+            Variable &gradient = jac[std::make_pair("f", "x")];
+            gradient.Fill(0.0);
+
+            for (int64_t i = 0; i < n_ - 1; ++i)
+            {
+                gradient(i) += -400.0 * x(i) * (x(i + 1) - x(i) * x(i)) - 2.0 * (1.0 - x(i));
+                gradient(i + 1) += 200.0 * (x(i + 1) - x(i) * x(i));
+            }
+        }
+
+    private:
+        int64_t n_;
+    };
+
+    /**
+     * @brief Runs Setup and SetupPartials as the server does on a Setup RPC
+     */
+    inline void Configure(Discipline &discipline)
+    {
+        discipline.Initialize();
+        discipline.Setup();
+        discipline.SetupPartials();
+    }
+
+    /**
+     * @brief Input variables for the variable meta data of a discipline
+     *
+     * @param discipline configured discipline
+     * @return Variables inputs with values 0.5, 1.5, 2.5, ...
+     */
+    inline Variables MakeInputs(const Discipline &discipline)
+    {
+        Variables inputs;
+        for (const VariableMetaData &var : discipline.var_meta())
+        {
+            if (var.type() != kInput)
+                continue;
+
+            Variable value(var);
+            for (size_t i = 0; i < value.Size(); ++i)
+                value(i) = 0.5 + static_cast<double>(i % 7);
+            inputs[var.name()] = value;
+        }
+        return inputs;
+    }
+}
+}
@@ -0,0 +1,155 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <grpcpp/grpcpp.h>
+
+#include <explicit.h>
+
+#include "bench_disciplines.h"
+
+using philote::ExplicitClient;
+using philote::ServerEngine;
+using philote::Variables;
+using philote::bench::Paraboloid;
+using philote::bench::Rosenbrock;
+
+namespace
+{
+    /**
+     * @brief Discipline server and connected client on a loopback port
+     */
+    class Loopback
+    {
+    public:
+        Loopback(std::shared_ptr<philote::ExplicitDiscipline> discipline, ServerEngine engine)
+            : discipline_(std::move(discipline))
+        {
+            int port = 0;
+            grpc::ServerBuilder builder;
+            builder.AddListeningPort("127.0.0.1:0", grpc::InsecureServerCredentials(), &port);
+            discipline_->RegisterServices(builder, engine);
+            server_ = builder.BuildAndStart();
+            if (!server_ or port == 0)
+                throw std::runtime_error("Failed to start the benchmark server");
+
+            client_.ConnectChannel(grpc::CreateChannel("127.0.0.1:" + std::to_string(port),
+                                                       grpc::InsecureChannelCredentials()));
+            client_.GetInfo();
+            client_.Setup();
+            client_.GetVariableDefinitions();
+            client_.GetPartialDefinitions();
+
+            // the client only knows the meta data, so use the server-side
+            // discipline to build matching inputs
+            inputs_ = philote::bench::MakeInputs(*discipline_);
+        }
+
+        ~Loopback()
+        {
+            server_->Shutdown();
+            server_->Wait();
+        }
+
+        ExplicitClient &client() noexcept { return client_; }
+        const Variables &inputs() const noexcept { return inputs_; }
+
+    private:
+        std::shared_ptr<philote::ExplicitDiscipline> discipline_;
+        std::unique_ptr<grpc::Server> server_;
+        ExplicitClient client_;
+        Variables inputs_;
+    };
+
+    ServerEngine Engine(const benchmark::State &state)
+    {
+        return state.range(0) == 0 ? ServerEngine::kSynchronous : ServerEngine::kCallback;
+    }
+}
+
+// paraboloid example: function evaluations (engine: 0 synchronous, 1 callback)
+static void BM_LoopbackParaboloidFunction(benchmark::State &state)
+{
+    Loopback loopback(std::make_shared<Paraboloid>(), Engine(state));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(loopback.client().ComputeFunction(loopback.inputs()));
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoopbackParaboloidFunction)->Arg(0)->Arg(1)->UseRealTime();
+
+// paraboloid example: gradient evaluations
+static void BM_LoopbackParaboloidGradient(benchmark::State &state)
+{
+    Loopback loopback(std::make_shared<Paraboloid>(), Engine(state));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(loopback.client().ComputeGradient(loopback.inputs()));
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoopbackParaboloidGradient)->Arg(0)->Arg(1)->UseRealTime();
+
+// rosenbrock example of dimension n: function evaluations
+static void BM_LoopbackRosenbrockFunction(benchmark::State &state)
+{
+    const int64_t n = state.range(1);
+    Loopback loopback(std::make_shared<Rosenbrock>(n), Engine(state));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(loopback.client().ComputeFunction(loopback.inputs()));
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * n * static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_LoopbackRosenbrockFunction)
+    ->ArgsProduct({{0, 1}, {2, 1 << 10, 1 << 16}})
+    ->UseRealTime();
+
+// rosenbrock example of dimension n: gradient evaluations
+static void BM_LoopbackRosenbrockGradient(benchmark::State &state)
+{
+    const int64_t n = state.range(1);
+    Loopback loopback(std::make_shared<Rosenbrock>(n), Engine(state));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(loopback.client().ComputeGradient(loopback.inputs()));
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * 2 * n * static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_LoopbackRosenbrockGradient)
+    ->ArgsProduct({{0, 1}, {2, 1 << 10, 1 << 16}})
+    ->UseRealTime();
@@ -0,0 +1,136 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <grpcpp/grpcpp.h>
+
+#include <callback_server.h>
+#include <explicit.h>
+
+#include "bench_disciplines.h"
+
+using philote::Array;
+using philote::BufferedArrayStream;
+using philote::ExplicitServer;
+using philote::Variables;
+using philote::bench::Rosenbrock;
+
+namespace
+{
+    /**
+     * @brief Server logic of a discipline driven without gRPC
+     *
+     * Runs the ComputeFunction and ComputeGradient server logic on in-memory
+     * streams, so the benchmarks measure the server Impl templates (stream
+     * parsing, workspace handling, compute, and chunking) without transport.
+     */
+    class InProcessServer
+    {
+    public:
+        InProcessServer(std::shared_ptr<philote::ExplicitDiscipline> discipline, size_t chunk_size)
+            : discipline_(std::move(discipline))
+        {
+            discipline_->stream_opts().set_num_double(static_cast<int64_t>(chunk_size));
+            philote::bench::Configure(*discipline_);
+            server_.LinkPointers(discipline_);
+
+            // client messages of one call
+            Variables inputs = philote::bench::MakeInputs(*discipline_);
+            for (const auto &input : inputs)
+                input.second.Send(input.first, "", &messages_, chunk_size);
+        }
+
+        ~InProcessServer() { server_.UnlinkPointers(); }
+
+        size_t Function()
+        {
+            BufferedArrayStream stream;
+            for (const Array &message : messages_)
+                stream.Push(Array(message));
+
+            grpc::Status status = server_.ComputeFunctionForTesting(&context_, &stream);
+            if (!status.ok())
+                throw std::runtime_error(status.error_message());
+            return stream.written().size();
+        }
+
+        size_t Gradient()
+        {
+            BufferedArrayStream stream;
+            for (const Array &message : messages_)
+                stream.Push(Array(message));
+
+            grpc::Status status = server_.ComputeGradientForTesting(&context_, &stream);
+            if (!status.ok())
+                throw std::runtime_error(status.error_message());
+            return stream.written().size();
+        }
+
+    private:
+        std::shared_ptr<philote::ExplicitDiscipline> discipline_;
+        ExplicitServer server_;
+        grpc::ServerContext context_;
+        std::vector<Array> messages_;
+    };
+}
+
+// ComputeFunction server logic for the Rosenbrock function of dimension n
+static void BM_InProcessComputeFunction(benchmark::State &state)
+{
+    const int64_t n = state.range(0);
+    InProcessServer server(std::make_shared<Rosenbrock>(n), static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(server.Function());
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * n * static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_InProcessComputeFunction)
+    ->ArgsProduct({{2, 1 << 10, 1 << 16}, {1000, 10000}});
+
+// ComputeGradient server logic for the Rosenbrock function of dimension n
+static void BM_InProcessComputeGradient(benchmark::State &state)
+{
+    const int64_t n = state.range(0);
+    InProcessServer server(std::make_shared<Rosenbrock>(n), static_cast<size_t>(state.range(1)));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(server.Gradient());
+
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * 2 * n * static_cast<int64_t>(sizeof(double)));
+}
+BENCHMARK(BM_InProcessComputeGradient)
+    ->ArgsProduct({{2, 1 << 10, 1 << 16}, {1000, 10000}});
@@ -0,0 +1,151 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <variable.h>
+
+using philote::Array;
+using philote::Variable;
+
+namespace
+{
+    // variable sizes (number of doubles) and chunk sizes (num_double)
+    void VariableArguments(benchmark::internal::Benchmark *bench)
+    {
+        for (int64_t size : {1 << 10, 1 << 16, 1 << 20})
+        {
+            for (int64_t chunk : {100, 1000, 10000})
+                bench->Args({size, chunk});
+        }
+    }
+
+    Variable MakeVariable(size_t size)
+    {
+        Variable var(philote::kOutput, {size});
+        for (size_t i = 0; i < size; ++i)
+            var(i) = static_cast<double>(i);
+        return var;
+    }
+}
+
+// serializes a variable into chunk messages, as Send does
+static void BM_VariableCreateChunk(benchmark::State &state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    const size_t chunk = static_cast<size_t>(state.range(1));
+    Variable var = MakeVariable(size);
+    Array message;
+
+    for (auto _ : state)
+    {
+        for (size_t start = 0; start < size; start += chunk)
+        {
+            const size_t end = std::min(start + chunk, size) - 1;
+            var.CreateChunk(start, end, message);
+            benchmark::DoNotOptimize(message);
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(double)));
+}
+BENCHMARK(BM_VariableCreateChunk)->Apply(VariableArguments);
+
+// receives a variable from chunk messages
+static void BM_VariableAssignChunk(benchmark::State &state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    const size_t chunk = static_cast<size_t>(state.range(1));
+    Variable source = MakeVariable(size);
+    Variable target(philote::kOutput, {size});
+
+    std::vector<Array> messages;
+    source.Send("x", "", &messages, chunk);
+
+    for (auto _ : state)
+    {
+        for (const Array &message : messages)
+            target.AssignChunk(message);
+        benchmark::DoNotOptimize(target.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(double)));
+}
+BENCHMARK(BM_VariableAssignChunk)->Apply(VariableArguments);
+
+// serializes a variable into a list of messages (includes message allocation)
+static void BM_VariableSendToList(benchmark::State &state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    const size_t chunk = static_cast<size_t>(state.range(1));
+    Variable var = MakeVariable(size);
+
+    for (auto _ : state)
+    {
+        std::vector<Array> messages;
+        var.Send("x", "", &messages, chunk);
+        benchmark::DoNotOptimize(messages.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(double)));
+}
+BENCHMARK(BM_VariableSendToList)->Apply(VariableArguments);
+
+// round trip through the protobuf wire format
+static void BM_VariableSerializeChunks(benchmark::State &state)
+{
+    const size_t size = static_cast<size_t>(state.range(0));
+    const size_t chunk = static_cast<size_t>(state.range(1));
+    Variable source = MakeVariable(size);
+    Variable target(philote::kOutput, {size});
+
+    std::vector<Array> messages;
+    source.Send("x", "", &messages, chunk);
+
+    std::string buffer;
+    Array parsed;
+    for (auto _ : state)
+    {
+        for (const Array &message : messages)
+        {
+            message.SerializeToString(&buffer);
+            parsed.ParseFromString(buffer);
+            target.AssignChunk(parsed);
+        }
+        benchmark::DoNotOptimize(target.data());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size * sizeof(double)));
+}
+BENCHMARK(BM_VariableSerializeChunks)->Apply(VariableArguments);
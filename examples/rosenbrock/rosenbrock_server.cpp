@@ -28,9 +28,7 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
-#include <cmath>
 #include <iostream>
-#include <vector>
 
 #include <grpcpp/grpcpp.h>
 
@@ -48,8 +46,6 @@ using philote::Variables;
 using std::cout;
 using std::endl;
 using std::make_pair;
-using std::pow;
-using std::vector;
 
 class Rosenbrock : public ExplicitDiscipline
 {
@@ -106,20 +102,15 @@ private:
     // Computes
     void Compute(const philote::Variables &inputs, philote::Variables &outputs) override
     {
-		// preallocate and assign the inputs
-        vector<double> x(n_);
-		for (int i = 0; i < inputs.at("x").Size(); i++)
-		{
-			x.at(i) = inputs.at("x")(i);
-		}
+		// view the inputs in place (no copies or per-element checks)
+		philote::ArrayView<const double> x = inputs.at("x").values();
 
 		// compute the function
 		double f = 0.0;
-		for (int i = 0; i < n_ - 1; ++i)
+		for (size_t i = 0; i + 1 < x.size(); ++i)
 		{
-			double x_i = x[i];
-			double x_i1 = x[i + 1];
-			f += 100.0 * std::pow(x_i1 - x_i * x_i, 2) + std::pow(1.0 - x_i, 2);
+			double r = x[i + 1] - x[i] * x[i];
+			f += 100.0 * r * r + (1.0 - x[i]) * (1.0 - x[i]);
 		}
 
         outputs.at("f")(0) = f;
@@ -127,29 +118,43 @@ private:
 
     void ComputePartials(const philote::Variables &inputs, Partials &jac) override
     {
-		// preallocate and assign the inputs
-		vector<double> x(n_);
-		for (int i = 0; i < inputs.at("x").Size(); i++)
+		philote::ArrayView<const double> x = inputs.at("x").values();
+		philote::ArrayView<double> gradient = jac[make_pair("f", "x")].values();
+
+		for (double &value : gradient)
+			value = 0.0;
+
+		for (size_t i = 0; i + 1 < x.size(); ++i)
 		{
-			x.at(i) = inputs.at("x")(i);
+			double r = x[i + 1] - x[i] * x[i];
+
+			gradient[i] += -400.0 * x[i] * r - 2.0 * (1.0 - x[i]);
+			gradient[i + 1] += 200.0 * r;
 		}
+    }
 
-		std::vector<double> gradient(n_, 0.0);
+    // Computes the function and gradient in one pass over the inputs
+    void ComputeWithPartials(const philote::FlatVariables &inputs,
+                             philote::FlatVariables &outputs,
+                             Partials &jac) override
+    {
+		philote::ArrayView<const double> x = inputs.at("x").values();
+		philote::ArrayView<double> df_dx = jac[make_pair("f", "x")].values();
 
-		for (int i = 0; i < n_ - 1; ++i)
-		{
-			double x_i = x.at(i);
-			double x_i1 = x.at(i + 1);
+		for (double &value : df_dx)
+			value = 0.0;
 
-			double dx_i = -400.0 * x_i * (x_i1 - x_i * x_i) - 2.0 * (1.0 - x_i);
-			double dx_i1 = 200.0 * (x_i1 - x_i * x_i);
+		double f = 0.0;
+		for (size_t i = 0; i + 1 < x.size(); ++i)
+		{
+			double r = x[i + 1] - x[i] * x[i];
 
-			gradient.at(i) += dx_i;
-			gradient.at(i + 1) += dx_i1;
+			f += 100.0 * r * r + (1.0 - x[i]) * (1.0 - x[i]);
+			df_dx[i] += -400.0 * x[i] * r - 2.0 * (1.0 - x[i]);
+			df_dx[i + 1] += 200.0 * r;
 		}
 
-		for (int i = 0; i < n_; ++i)
-			jac[make_pair("f", "x")](i) = gradient.at(i);
+		outputs.at("f")(0) = f;
     }
 };
 
@@ -158,6 +163,9 @@ int main()
     std::string address("localhost:50051");
     auto service = std::make_shared<Rosenbrock>();
 
+    // optimizers request the gradient at the points they evaluate
+    service->EnablePartialsMemoization();
+
     ServerBuilder builder;
     builder.AddListeningPort(address, grpc::InsecureServerCredentials());
     service->RegisterServices(builder);
@@ -0,0 +1,358 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/status.h>
+#include <grpcpp/support/sync_stream.h>
+
+#include <cancellation.h>
+#include <data.pb.h>
+
+namespace philote
+{
+    /**
+     * @brief Limits of the evaluations a server accepts at the same time
+     *
+     * A limit of zero disables the corresponding check.
+     */
+    struct AdmissionLimits
+    {
+        //! evaluations computing at the same time
+        size_t max_concurrent = 0;
+
+        //! evaluations waiting for one of the max_concurrent slots
+        size_t max_queued = 0;
+
+        //! input bytes held by the admitted evaluations
+        size_t max_buffered_bytes = 0;
+
+        //! time clients are asked to wait before retrying a rejected call
+        std::chrono::milliseconds retry_after{100};
+    };
+
+    /**
+     * @brief Admits or rejects the compute RPCs of a server
+     *
+     * Calls beyond max_concurrent + max_queued, or whose inputs would exceed
+     * max_buffered_bytes, are rejected right away with RESOURCE_EXHAUSTED
+     * and a retry-after hint in the trailing metadata
+     * (kRetryAfterMetadataKey). Admitted calls wait for one of the
+     * max_concurrent slots before they compute, either blocking (Start) or
+     * by being handed a released slot (TryStart).
+     *
+     * Clients may declare the size of their inputs (kInputBytesMetadataKey),
+     * so that calls are rejected before any input is read. The inputs of
+     * other calls, and the inputs beyond the declared size, are counted as
+     * they are read. A call is never rejected
+     * for its input size while no other call holds input bytes, so that
+     * inputs larger than the limit are still served one at a time.
+     */
+    class AdmissionController
+    {
+    public:
+        /**
+         * @brief Admission of one evaluation
+         *
+         * Releases its slot and input bytes when destroyed.
+         */
+        class Ticket
+        {
+        public:
+            Ticket() = default;
+
+            ~Ticket() noexcept { Release(); }
+
+            Ticket(Ticket &&other) noexcept;
+            Ticket &operator=(Ticket &&other) noexcept;
+
+            Ticket(const Ticket &) = delete;
+            Ticket &operator=(const Ticket &) = delete;
+
+            //! Checks whether the ticket holds an admission
+            explicit operator bool() const noexcept { return controller_ != nullptr; }
+
+            /**
+             * @brief Waits for a slot to compute in
+             *
+             * @param context server context of the call, checked for cancellation while waiting
+             * @return false if the call was cancelled while waiting
+             */
+            bool Start(const grpc::ServerContextBase *context);
+
+            /**
+             * @brief Takes a slot to compute in without blocking
+             *
+             * If no slot is free, the ticket joins the queue of waiting calls
+             * and ready is called once a released slot was handed to it. ready
+             * runs on the thread releasing the slot, possibly while it holds
+             * its own locks, so it must neither block nor throw (e.g., it
+             * queues a task). The ticket must not be destroyed while it waits.
+             *
+             * @param ready called once the ticket holds a slot, if it does not yet
+             * @return true if the ticket holds a slot; false if ready will be called
+             */
+            bool TryStart(std::function<void()> ready);
+
+            /**
+             * @brief Leaves the queue of calls waiting for a slot (see TryStart)
+             *
+             * @return true if the ticket left the queue; false if it was not
+             * waiting, e.g., because a slot was handed to it (then ready is called)
+             */
+            bool CancelStart() noexcept;
+
+            /**
+             * @brief Counts input bytes read by the call
+             *
+             * Bytes within the input size declared by the call are already
+             * counted; only the bytes beyond it are checked against the
+             * limit.
+             *
+             * @param bytes size of the received message
+             * @return false if the bytes exceed the limit
+             */
+            bool Reserve(size_t bytes) noexcept;
+
+            //! Releases the slot and the input bytes of the call
+            void Release() noexcept;
+
+        private:
+            friend class AdmissionController;
+
+            //! controller that admitted the call (nullptr if not admitted)
+            AdmissionController *controller_ = nullptr;
+
+            //! input bytes counted for the call
+            size_t bytes_ = 0;
+
+            //! whether the call holds a compute slot
+            bool running_ = false;
+
+            //! input bytes read by the call
+            size_t received_ = 0;
+
+            //! whether the ticket waits in the queue of the controller (see TryStart)
+            bool waiting_ = false;
+
+            //! Takes over the admission of another ticket
+            void MoveFrom(Ticket &other) noexcept;
+        };
+
+        AdmissionController() = default;
+
+        AdmissionController(const AdmissionController &) = delete;
+        AdmissionController &operator=(const AdmissionController &) = delete;
+
+        /**
+         * @brief Sets the limits
+         *
+         * @param limits new limits, applied to the following admissions
+         */
+        void SetLimits(const AdmissionLimits &limits);
+
+        //! Returns the current limits
+        AdmissionLimits limits() const;
+
+        /**
+         * @brief Admits a call or rejects it
+         *
+         * @param context server context of the call (receives the retry-after hint)
+         * @param ticket receives the admission
+         * @return grpc::Status OK or RESOURCE_EXHAUSTED
+         */
+        grpc::Status Admit(grpc::ServerContextBase *context, Ticket &ticket);
+
+        /**
+         * @brief Rejects a call
+         *
+         * @param context server context of the call (receives the retry-after hint)
+         * @param reason exhausted resource
+         * @return grpc::Status RESOURCE_EXHAUSTED
+         */
+        grpc::Status Reject(grpc::ServerContextBase *context, const std::string &reason);
+
+        //! Number of calls computing
+        size_t running() const;
+
+        //! Number of admitted calls waiting for a slot
+        size_t queued() const;
+
+        //! Input bytes held by the admitted calls
+        size_t buffered_bytes() const;
+
+        //! Number of rejected calls
+        uint64_t rejected() const;
+
+    private:
+        mutable std::mutex mutex_;
+
+        //! signals released compute slots
+        std::condition_variable released_;
+
+        AdmissionLimits limits_;
+
+        //! tickets waiting for a slot without blocking, with their ready callbacks
+        std::deque<std::pair<Ticket *, std::function<void()>>> waiting_;
+
+        size_t running_ = 0;
+        size_t queued_ = 0;
+        size_t bytes_ = 0;
+        uint64_t rejected_ = 0;
+
+        /**
+         * @brief Hands free slots to the waiting tickets (mutex_ must be held)
+         *
+         * @return ready callbacks of the tickets that received a slot, to be
+         * called once mutex_ is released
+         */
+        std::vector<std::function<void()>> HandOver();
+    };
+
+    /**
+     * @brief Server stream counting the input bytes of an admitted call
+     *
+     * Ends the inputs once the call exceeds the input byte limit, cancels
+     * the cancellation token of the call so that it does not compute, and
+     * drops its results; the call is then rejected (see AdmitCall).
+     */
+    class AdmittedArrayStream : public grpc::ServerReaderWriterInterface<Array, Array>
+    {
+    public:
+        using grpc::internal::WriterInterface<Array>::Write;
+
+        /**
+         * @param stream stream of the call
+         * @param ticket admission of the call
+         * @param context server context of the call, whose cancellation
+         * token is cancelled once the inputs exceed the limit
+         */
+        AdmittedArrayStream(grpc::ServerReaderWriterInterface<Array, Array> *stream,
+                            AdmissionController::Ticket &ticket, grpc::ServerContextBase *context);
+
+        //! Checks whether the inputs exceeded the input byte limit
+        bool exceeded() const noexcept { return exceeded_; }
+
+        void SendInitialMetadata() override;
+
+        bool Write(const Array &msg, grpc::WriteOptions options) override;
+
+        bool NextMessageSize(uint32_t *sz) override;
+
+        bool Read(Array *msg) override;
+
+    private:
+        //! wrapped stream
+        grpc::ServerReaderWriterInterface<Array, Array> *stream_;
+
+        //! admission of the call
+        AdmissionController::Ticket &ticket_;
+
+        //! server context of the call
+        grpc::ServerContextBase *context_;
+
+        //! whether the inputs exceeded the limit
+        bool exceeded_ = false;
+    };
+
+    /**
+     * @brief Runs the logic of a compute RPC once the call is admitted
+     *
+     * Without a controller, the handler is called with the original stream.
+     *
+     * @param controller admission controller (may be nullptr)
+     * @param context server context of the RPC
+     * @param stream stream of the RPC
+     * @param handler RPC logic, callable with StreamType* and AdmittedArrayStream*
+     * @return grpc::Status status of the handler, or RESOURCE_EXHAUSTED
+     */
+    template <typename StreamType, typename Handler>
+    grpc::Status AdmitCall(AdmissionController *controller, grpc::ServerContextBase *context,
+                           StreamType *stream, Handler &&handler)
+    {
+        if (controller == nullptr or stream == nullptr)
+            return handler(stream);
+
+        AdmissionController::Ticket ticket;
+        grpc::Status status = controller->Admit(context, ticket);
+        if (!status.ok())
+            return status;
+
+        if (!ticket.Start(context))
+            return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled while waiting for admission");
+
+        // the token stops the computation once the inputs exceed the limit
+        CancellationMonitor &monitor = CancellationMonitor::Instance();
+        bool watching = false;
+        if (context)
+        {
+            try
+            {
+                monitor.Watch(context);
+                watching = true;
+            }
+            catch (...)
+            {
+                // the call is still rejected, only after computing
+            }
+        }
+
+        AdmittedArrayStream admitted(stream, ticket, context);
+        try
+        {
+            status = handler(&admitted);
+        }
+        catch (...)
+        {
+            if (watching)
+                monitor.Unwatch(context);
+            throw;
+        }
+        if (watching)
+            monitor.Unwatch(context);
+
+        if (admitted.exceeded())
+            return controller->Reject(context, "buffered input bytes");
+
+        return status;
+    }
+}
@@ -0,0 +1,97 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <vector>
+
+namespace philote
+{
+    //! Alignment of the storage of variables in bytes (a cache line, and the widest SIMD register)
+    constexpr size_t kSimdAlignment = 64;
+
+    /**
+     * @brief Allocator returning storage aligned to kSimdAlignment
+     *
+     * Lets compute kernels use aligned vector loads on the storage of a
+     * std::vector (see AlignedVector).
+     *
+     * @tparam T element type
+     */
+    template <class T>
+    class AlignedAllocator
+    {
+    public:
+        using value_type = T;
+
+        AlignedAllocator() noexcept = default;
+
+        template <class U>
+        AlignedAllocator(const AlignedAllocator<U> &) noexcept {}
+
+        /**
+         * @brief Allocates aligned storage
+         *
+         * @param n number of elements
+         * @return T* storage aligned to kSimdAlignment
+         * @throws std::bad_alloc if the storage cannot be allocated
+         */
+        T *allocate(size_t n)
+        {
+            if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+                throw std::bad_alloc();
+
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(kSimdAlignment)));
+        }
+
+        /**
+         * @brief Frees storage returned by allocate
+         *
+         * @param p storage
+         */
+        void deallocate(T *p, size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(kSimdAlignment));
+        }
+
+        template <class U>
+        bool operator==(const AlignedAllocator<U> &) const noexcept { return true; }
+
+        template <class U>
+        bool operator!=(const AlignedAllocator<U> &) const noexcept { return false; }
+    };
+
+    //! Vector with storage aligned to kSimdAlignment
+    template <class T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+}
@@ -0,0 +1,109 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace philote
+{
+    /**
+     * @brief Non-owning view of contiguous elements (a pointer and a size)
+     *
+     * A C++17 stand-in for std::span. Element access is unchecked, so
+     * loops over a view compile to the same code as loops over a raw
+     * pointer (and can be vectorized).
+     *
+     * @par Example
+     * @code
+     * philote::ArrayView<const double> x = inputs.at("x").values();
+     * double sum = 0.0;
+     * for (double value : x)
+     *     sum += value;
+     * @endcode
+     *
+     * @tparam T element type (const for read-only views)
+     */
+    template <class T>
+    class ArrayView
+    {
+    public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using iterator = T *;
+
+        //! Creates an empty view
+        constexpr ArrayView() noexcept = default;
+
+        /**
+         * @brief Creates a view
+         *
+         * @param data first element
+         * @param size number of elements
+         */
+        constexpr ArrayView(T *data, size_t size) noexcept : data_(data), size_(size) {}
+
+        //! Converts a view of mutable elements to a view of const elements
+        template <class U, class = std::enable_if_t<std::is_same<const U, T>::value>>
+        constexpr ArrayView(const ArrayView<U> &other) noexcept : data_(other.data()), size_(other.size()) {}
+
+        //! Returns the first element (nullptr for an empty view)
+        constexpr T *data() const noexcept { return data_; }
+
+        //! Returns the number of elements
+        constexpr size_t size() const noexcept { return size_; }
+
+        //! Checks whether the view has no elements
+        constexpr bool empty() const noexcept { return size_ == 0; }
+
+        //! Returns an element (unchecked)
+        constexpr T &operator[](size_t i) const noexcept { return data_[i]; }
+
+        constexpr iterator begin() const noexcept { return data_; }
+        constexpr iterator end() const noexcept { return data_ + size_; }
+
+        /**
+         * @brief Returns a view of a range of the elements
+         *
+         * @param offset first element of the range
+         * @param count number of elements of the range
+         * @return ArrayView of the range (unchecked)
+         */
+        constexpr ArrayView subview(size_t offset, size_t count) const noexcept { return ArrayView(data_ + offset, count); }
+
+    private:
+        //! first element
+        T *data_ = nullptr;
+
+        //! number of elements
+        size_t size_ = 0;
+    };
+}
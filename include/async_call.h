@@ -0,0 +1,192 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/client_callback.h>
+
+#include <data.pb.h>
+
+#include <compression.h>
+
+namespace philote
+{
+    /**
+     * @brief Completion callback of an asynchronous client call
+     *
+     * Receives the result of the call, or a default constructed result and
+     * the exception that describes why the call failed.
+     *
+     * @tparam Result result type of the call
+     */
+    template <class Result>
+    using AsyncCallback = std::function<void(Result result, std::exception_ptr error)>;
+
+    /**
+     * @brief Bidirectional Array stream call based on the gRPC callback API
+     *
+     * Writes a list of pre-serialized messages to the server, passes every
+     * message received from the server to a handler, and reports the final
+     * status. The call deletes itself once it is done, so it must be
+     * allocated with new and must not be accessed after Begin was called.
+     *
+     * All handlers run on gRPC library threads. If the message handler
+     * throws, the call is cancelled and the exception is passed to the done
+     * handler.
+     */
+    class AsyncArrayCall : public grpc::ClientBidiReactor<Array, Array>
+    {
+    public:
+        //! Starts the RPC on the stub (e.g., stub->async()->ComputeFunction)
+        using StartFunction = std::function<void(grpc::ClientContext *,
+                                                 grpc::ClientBidiReactor<Array, Array> *)>;
+
+        //! Handles a message received from the server
+        using MessageHandler = std::function<void(const Array &)>;
+
+        //! Handles the completion of the call
+        using DoneHandler = std::function<void(const grpc::Status &, std::exception_ptr)>;
+
+        /**
+         * @brief Constructs the call
+         *
+         * @param messages messages sent to the server (in order)
+         * @param on_message handler for messages received from the server
+         * @param on_done handler invoked once the call is finished
+         */
+        AsyncArrayCall(std::vector<Array> messages,
+                       MessageHandler on_message,
+                       DoneHandler on_done);
+
+        /**
+         * @brief Returns the client context of the call
+         *
+         * May be used to set the deadline or metadata before calling Begin.
+         *
+         * @return grpc::ClientContext&
+         */
+        grpc::ClientContext &context();
+
+        /**
+         * @brief Sets the compression policy of the messages sent to the server
+         *
+         * Must be called before Begin. The compression algorithm itself is
+         * set on the context.
+         *
+         * @param policy compression policy
+         */
+        void SetCompression(const CompressionPolicy &policy);
+
+        /**
+         * @brief Starts the call
+         *
+         * @param start function that starts the RPC on the stub
+         */
+        void Begin(const StartFunction &start);
+
+        void OnWriteDone(bool ok) override;
+
+        void OnReadDone(bool ok) override;
+
+        void OnDone(const grpc::Status &status) override;
+
+    private:
+        //! client context of the call
+        grpc::ClientContext context_;
+
+        //! messages sent to the server
+        std::vector<Array> messages_;
+
+        //! index of the next message to write
+        size_t next_ = 0;
+
+        //! compression policy of the messages sent to the server
+        CompressionPolicy compression_;
+
+        //! message currently being read
+        Array incoming_;
+
+        //! handler for received messages
+        MessageHandler on_message_;
+
+        //! handler for the completion of the call
+        DoneHandler on_done_;
+
+        //! first exception thrown by the message handler
+        std::exception_ptr error_;
+
+        /**
+         * @brief Writes the next message or closes the write side
+         */
+        void WriteNext();
+    };
+
+    /**
+     * @brief Creates the exception describing a failed client call
+     *
+     * Uses the same messages as the blocking client calls.
+     *
+     * @param rpc name of the RPC
+     * @param status final status of the call
+     * @param timeout RPC timeout of the call
+     * @return std::exception_ptr
+     */
+    std::exception_ptr MakeRPCError(const std::string &rpc,
+                                    const grpc::Status &status,
+                                    std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Creates a completion callback that fulfills a promise
+     *
+     * @tparam Result result type of the call
+     * @param promise promise fulfilled by the callback
+     * @return AsyncCallback<Result>
+     */
+    template <class Result>
+    AsyncCallback<Result> PromiseCallback(std::shared_ptr<std::promise<Result>> promise)
+    {
+        return [promise](Result result, std::exception_ptr error)
+        {
+            if (error)
+                promise->set_exception(error);
+            else
+                promise->set_value(std::move(result));
+        };
+    }
+}
@@ -0,0 +1,342 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/server_callback.h>
+#include <grpcpp/support/sync_stream.h>
+
+#include <admission.h>
+#include <data.pb.h>
+#include <thread_pool.h>
+
+namespace philote
+{
+    /**
+     * @brief Server implementation used for the compute RPCs of a discipline
+     */
+    enum class ServerEngine
+    {
+        //! synchronous gRPC service (one gRPC thread per open stream)
+        kSynchronous,
+
+        /**
+         * callback (reactor) gRPC service: the inputs of an evaluation are
+         * read and buffered asynchronously, the evaluation runs on the
+         * compute thread pool once they are complete and a compute slot is
+         * free, and its outputs are buffered and sent asynchronously, so the
+         * pool threads never wait for the client. All inputs and outputs of
+         * an evaluation are held in memory (see AdmissionLimits for bounding
+         * the inputs)
+         */
+        kCallback
+    };
+
+    /**
+     * @brief In-memory Array stream used to run the stream-based server logic
+     * on recorded messages
+     *
+     * Read returns the buffered client messages in order; Write collects the
+     * messages for the server response.
+     */
+    class BufferedArrayStream : public grpc::ServerReaderWriterInterface<Array, Array>
+    {
+    public:
+        using grpc::internal::WriterInterface<Array>::Write;
+
+        /**
+         * @brief Appends a message received from the client
+         *
+         * @param message client message
+         */
+        void Push(Array &&message);
+
+        /**
+         * @brief Checks whether no client message was received
+         *
+         * @return true if Push was not called since the last Clear
+         */
+        bool empty() const noexcept;
+
+        /**
+         * @brief Discards all messages, e.g., before the next evaluation of
+         * an evaluation stream
+         */
+        void Clear() noexcept;
+
+        /**
+         * @brief Returns the messages written by the server logic
+         *
+         * @return std::vector<Array>&
+         */
+        std::vector<Array> &written() noexcept;
+
+        /**
+         * @brief Returns the write options of the written messages
+         *
+         * @return const std::vector<grpc::WriteOptions>& one entry per written message
+         */
+        const std::vector<grpc::WriteOptions> &write_options() const noexcept;
+
+        void SendInitialMetadata() override;
+
+        bool Write(const Array &msg, grpc::WriteOptions options) override;
+
+        bool NextMessageSize(uint32_t *sz) override;
+
+        bool Read(Array *msg) override;
+
+    private:
+        //! messages received from the client
+        std::vector<Array> received_;
+
+        //! index of the next received message to read
+        size_t next_ = 0;
+
+        //! messages written by the server logic
+        std::vector<Array> written_;
+
+        //! write options of the written messages (e.g., disabled compression)
+        std::vector<grpc::WriteOptions> write_options_;
+    };
+
+    /**
+     * @brief Reactor serving a bidirectional Array stream RPC
+     *
+     * Reads and buffers all client messages of an evaluation without
+     * occupying a thread. Once the inputs are complete (the client finished
+     * writing, or sent the end of evaluation message of an evaluation
+     * stream, see evaluation_stream.h), the evaluation takes a compute slot
+     * of the admission control and only then runs the handler on the
+     * compute thread pool. Evaluations waiting for a slot do not occupy a
+     * thread either. The handler reads the buffered inputs, and the messages
+     * it writes are queued without waiting for the client and sent one
+     * after another as the previous ones are written (OnWriteDone), so a
+     * slow client never holds a compute thread. Once the handler returned
+     * and its messages are sent, the RPC finishes or, for evaluation
+     * streams, the next evaluation is read. If the handler fails, the RPC
+     * finishes with its status once the message being sent is written. The
+     * reactor deletes itself when the RPC is done.
+     */
+    class ArrayStreamReactor : public grpc::ServerBidiReactor<Array, Array>
+    {
+    public:
+        //! Server logic operating on the stream of the RPC
+        using Handler = std::function<grpc::Status(grpc::ServerReaderWriterInterface<Array, Array> *)>;
+
+        /**
+         * @brief Starts reading the client messages
+         *
+         * @param executor thread pool the handler runs on
+         * @param handler server logic
+         * @param evaluations whether the client requested an evaluation stream
+         * @param context server context of the RPC, whose cancellation token
+         * is cancelled by OnCancel (see CancellationMonitor)
+         * @param admission admission controller (may be nullptr); each
+         * evaluation is admitted when the reactor starts reading it, so that
+         * rejected calls are not read, and its inputs are counted as they
+         * are read
+         */
+        ArrayStreamReactor(ThreadPool &executor, Handler handler, bool evaluations = false,
+                           grpc::ServerContextBase *context = nullptr,
+                           AdmissionController *admission = nullptr);
+
+        void OnReadDone(bool ok) override;
+
+        void OnWriteDone(bool ok) override;
+
+        void OnCancel() override;
+
+        void OnDone() override;
+
+    private:
+        /**
+         * @brief Stream passed to the handler, reading the buffered inputs
+         * and queueing the messages to send
+         */
+        class Stream : public grpc::ServerReaderWriterInterface<Array, Array>
+        {
+        public:
+            using grpc::internal::WriterInterface<Array>::Write;
+
+            explicit Stream(ArrayStreamReactor &reactor) : reactor_(reactor) {}
+
+            void SendInitialMetadata() override;
+
+            bool Write(const Array &msg, grpc::WriteOptions options) override;
+
+            bool NextMessageSize(uint32_t *sz) override;
+
+            bool Read(Array *msg) override;
+
+        private:
+            ArrayStreamReactor &reactor_;
+        };
+
+        //! thread pool the handler runs on
+        ThreadPool &executor_;
+
+        //! server logic
+        Handler handler_;
+
+        //! whether the stream carries several evaluations
+        bool evaluations_;
+
+        //! server context of the RPC (may be nullptr)
+        grpc::ServerContextBase *context_;
+
+        //! admission controller (may be nullptr)
+        AdmissionController *admission_;
+
+        /**
+         * guards the state below; reactions never run inline, so gRPC
+         * operations are started while holding it
+         */
+        std::mutex mutex_;
+
+        //! admission of the evaluation being read or served
+        AdmissionController::Ticket ticket_;
+
+        //! message currently being read
+        Array incoming_;
+
+        //! client messages of the evaluation not yet read by the handler
+        std::deque<Array> received_;
+
+        //! handler messages not yet sent, with their write options
+        std::deque<std::pair<Array, grpc::WriteOptions>> outgoing_;
+
+        //! message currently being written
+        Array writing_message_;
+
+        //! whether a read is outstanding
+        bool reading_ = false;
+
+        //! whether a write is outstanding
+        bool writing_ = false;
+
+        //! whether the inputs of the evaluation (or of the call) are complete
+        bool inputs_done_ = false;
+
+        //! whether the evaluation waits for a compute slot (see Ticket::TryStart)
+        bool waiting_ = false;
+
+        //! whether the handler is scheduled or running
+        bool running_ = false;
+
+        //! whether the handler returned for the current evaluation
+        bool served_ = false;
+
+        //! whether the end of evaluation message was queued
+        bool ended_ = false;
+
+        //! whether the RPC failed (see error_)
+        bool failed_ = false;
+
+        //! whether Finish was called
+        bool finished_ = false;
+
+        //! final status of a failed RPC
+        grpc::Status error_;
+
+        //! id of the evaluation being served (0: the client closed the stream)
+        uint64_t evaluation_id_ = 0;
+
+        /**
+         * @brief Takes a compute slot for the complete inputs and schedules
+         * the handler, or waits for a slot without blocking (mutex_ must be
+         * held)
+         */
+        void Start();
+
+        /**
+         * @brief Runs the handler on the compute thread pool (mutex_ must be
+         * held)
+         */
+        void Schedule();
+
+        /**
+         * @brief Runs the handler of an evaluation that received a compute
+         * slot while waiting (called on the compute thread pool)
+         */
+        void Resume();
+
+        /**
+         * @brief Runs the handler and records its result
+         */
+        void Run();
+
+        /**
+         * @brief Hands the next buffered client message to the handler
+         *
+         * @param msg receives the message
+         * @return false once all inputs were read or the RPC failed
+         */
+        bool ReadInput(Array *msg);
+
+        /**
+         * @brief Queues a handler message without waiting for it to be sent
+         *
+         * @param msg message to send
+         * @param options write options of the message
+         * @return false if the RPC failed
+         */
+        bool WriteOutput(const Array &msg, grpc::WriteOptions options);
+
+        /**
+         * @brief Records the failure of the RPC (mutex_ must be held)
+         *
+         * @param status final status of the RPC (the first failure is kept)
+         */
+        void Fail(const grpc::Status &status);
+
+        /**
+         * @brief Starts the next write, the next evaluation, or finishes the
+         * RPC, depending on the state (mutex_ must be held)
+         */
+        void Advance();
+    };
+
+    /**
+     * @brief Creates a reactor that immediately fails an Array stream RPC
+     *
+     * @param status final status of the RPC (not OK)
+     * @return grpc::ServerBidiReactor<Array, Array>* self-deleting reactor
+     */
+    grpc::ServerBidiReactor<Array, Array> *RejectArrayStream(const grpc::Status &status);
+}
@@ -0,0 +1,161 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <grpcpp/server_context.h>
+
+namespace philote
+{
+    /**
+     * @brief Cheap, shareable cancellation flag of one RPC
+     *
+     * Copies share the flag. Checking the flag is a single relaxed atomic
+     * load, so long compute loops can poll it on every iteration.
+     */
+    class CancellationToken
+    {
+    public:
+        //! Creates a token that is not cancelled
+        CancellationToken();
+
+        //! Sets the flag of the token and all its copies
+        void Cancel() const noexcept { flag_->store(true, std::memory_order_relaxed); }
+
+        //! Checks whether the token has been cancelled
+        bool IsCancelled() const noexcept { return flag_->load(std::memory_order_relaxed); }
+
+    private:
+        //! flag shared by the copies of the token
+        std::shared_ptr<std::atomic<bool>> flag_;
+    };
+
+    /**
+     * @brief Sets the cancellation tokens of the RPCs being served
+     *
+     * Server contexts are watched while the discipline computes. Callback
+     * RPCs cancel their token from the reactor's OnCancel callback. The
+     * synchronous engine has no cancellation callback, so a single monitor
+     * thread polls the watched contexts instead and the compute threads do
+     * not have to query the contexts themselves.
+     */
+    class CancellationMonitor
+    {
+    public:
+        //! Returns the process-wide monitor
+        static CancellationMonitor &Instance();
+
+        //! Stops the monitor thread
+        ~CancellationMonitor() noexcept;
+
+        CancellationMonitor(const CancellationMonitor &) = delete;
+        CancellationMonitor &operator=(const CancellationMonitor &) = delete;
+
+        /**
+         * @brief Starts watching a server context
+         *
+         * Watching the same context several times returns the same token;
+         * each Watch call must be matched by an Unwatch call.
+         *
+         * @param context server context of the RPC
+         * @return token cancelled once the RPC is cancelled
+         */
+        CancellationToken Watch(const grpc::ServerContextBase *context);
+
+        /**
+         * @brief Stops watching a server context
+         *
+         * @param context server context passed to Watch
+         */
+        void Unwatch(const grpc::ServerContextBase *context) noexcept;
+
+        /**
+         * @brief Cancels the token of a watched context right away
+         *
+         * Does nothing if the context is not watched.
+         *
+         * @param context server context of the cancelled RPC
+         */
+        void Cancel(const grpc::ServerContextBase *context) noexcept;
+
+        /**
+         * @brief Sets the interval at which the watched contexts are polled
+         *
+         * @param interval polling interval (default 5 ms)
+         * @throws std::invalid_argument if the interval is not positive
+         */
+        void SetPollInterval(std::chrono::milliseconds interval);
+
+        //! Number of watched contexts
+        size_t watched() const;
+
+    private:
+        //! a watched server context
+        struct Entry
+        {
+            const grpc::ServerContextBase *context;
+            CancellationToken token;
+            size_t watchers;
+        };
+
+        CancellationMonitor() = default;
+
+        /**
+         * @brief Polls the watched contexts until the monitor is destroyed
+         */
+        void Run();
+
+        mutable std::mutex mutex_;
+
+        //! signals new watches and the shutdown
+        std::condition_variable changed_;
+
+        //! watched contexts
+        std::map<const grpc::ServerContextBase *, Entry> entries_;
+
+        //! polling interval
+        std::chrono::milliseconds interval_{5};
+
+        //! whether the monitor thread is stopping
+        bool stopping_ = false;
+
+        //! monitor thread (started by the first Watch call)
+        std::thread thread_;
+    };
+} // namespace philote
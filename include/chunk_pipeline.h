@@ -0,0 +1,144 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/sync_stream.h>
+
+#include <data.pb.h>
+
+#include <compression.h>
+
+namespace philote
+{
+    /**
+     * @brief Writes stream messages on a background thread
+     *
+     * Lets the caller prepare the next chunk of a variable while the previous
+     * one is serialized and handed to the transport (which blocks under flow
+     * control). At most kDepth messages are queued. Without a background
+     * thread, messages are written directly, so small calls do not pay for a
+     * thread. The stream must not be written to by anyone else until Finish
+     * returns.
+     */
+    class ChunkPipeline
+    {
+    public:
+        //! maximum number of queued messages
+        static constexpr size_t kDepth = 2;
+
+        /**
+         * @brief Constructs a pipeline
+         *
+         * @param stream stream the messages are written to
+         * @param threaded whether to write on a background thread
+         * @param compression compression policy deciding which messages are compressed
+         */
+        ChunkPipeline(grpc::internal::WriterInterface<Array> *stream, bool threaded,
+                      const CompressionPolicy &compression = CompressionPolicy());
+
+        //! Waits for the queued messages and joins the writer thread
+        ~ChunkPipeline() noexcept;
+
+        ChunkPipeline(const ChunkPipeline &) = delete;
+        ChunkPipeline &operator=(const ChunkPipeline &) = delete;
+
+        /**
+         * @brief Returns a message for the next chunk
+         *
+         * Messages that have been written are recycled so their buffers are
+         * reused.
+         *
+         * @return Array an empty (or recycled) message
+         */
+        Array Acquire();
+
+        /**
+         * @brief Queues a message for writing
+         *
+         * Blocks while kDepth messages are queued.
+         *
+         * @param message message to write
+         * @return false if the stream failed (the message is discarded)
+         */
+        bool Write(Array &&message);
+
+        /**
+         * @brief Waits until all queued messages are written
+         *
+         * @return false if a write failed
+         */
+        bool Finish();
+
+    private:
+        //! stream the messages are written to
+        grpc::internal::WriterInterface<Array> *stream_;
+
+        //! compression policy of the messages
+        CompressionPolicy compression_;
+
+        //! messages waiting to be written
+        std::deque<Array> queue_;
+
+        //! written messages available for reuse
+        std::vector<Array> free_;
+
+        //! guards the queues and flags
+        std::mutex mutex_;
+
+        //! signals changes of the queue to the writer and the caller
+        std::condition_variable changed_;
+
+        //! set once a write failed
+        bool failed_ = false;
+
+        //! set while the writer thread is writing a message
+        bool writing_ = false;
+
+        //! set once the pipeline is being destroyed
+        bool stopping_ = false;
+
+        //! background writer (not started for direct writes)
+        std::thread writer_;
+
+        /**
+         * @brief Writes queued messages until the pipeline is destroyed
+         */
+        void Run();
+    };
+}
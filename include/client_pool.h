@@ -0,0 +1,249 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <explicit.h>
+
+namespace philote
+{
+    /**
+     * @brief Load counters of a replica in an ExplicitClientPool
+     */
+    struct ReplicaStats
+    {
+        //! Number of calls in flight (including calls waiting for the replica)
+        size_t outstanding = 0;
+
+        //! Number of successful calls
+        size_t completed = 0;
+
+        //! Number of failed calls
+        size_t failures = 0;
+    };
+
+    /**
+     * @brief Client for a discipline that is served by several replica servers
+     *
+     * The pool holds one ExplicitClient per channel. Initialize discovers
+     * the discipline (GetInfo, GetVariableDefinitions, GetPartialDefinitions)
+     * through the first replica only and copies the result to the others
+     * (see DisciplineClient::CopyDefinitions); only the configuration RPCs
+     * (SendOptions, SetStreamOptions, Setup) are sent to every replica.
+     *
+     * Each compute call is dispatched to the replica with the fewest
+     * outstanding calls. If the call fails on a replica, it is retried on
+     * the remaining replicas, and the failed replica is only chosen again
+     * once its failure backoff has passed (or no other replica is left).
+     * A replica runs one call at a time; to allow several concurrent calls
+     * on one server, pass its channel several times.
+     *
+     * All replicas must serve the same discipline with the same options.
+     *
+     * @code
+     * philote::ExplicitClientPool pool({grpc::CreateChannel("node1:50051", creds),
+     *                                   grpc::CreateChannel("node2:50051", creds)});
+     * pool.Initialize();
+     *
+     * // safe to call from several threads
+     * philote::Variables outputs = pool.ComputeFunction(inputs);
+     * @endcode
+     *
+     * @note Thread Safety: ComputeFunction, ComputeGradient,
+     * ComputeFunctionAndGradient, and GetReplicaStats may be called
+     * concurrently. Connecting, configuring, and initializing the pool (or
+     * its replicas) must not overlap with compute calls.
+     */
+    class ExplicitClientPool
+    {
+    public:
+        //! Constructor
+        ExplicitClientPool() = default;
+
+        /**
+         * @brief Constructs a pool with a replica per channel
+         *
+         * @param channels channels of the replica servers
+         */
+        explicit ExplicitClientPool(const std::vector<std::shared_ptr<grpc::ChannelInterface>> &channels);
+
+        ExplicitClientPool(const ExplicitClientPool &) = delete;
+        ExplicitClientPool &operator=(const ExplicitClientPool &) = delete;
+
+        /**
+         * @brief Replaces the replicas with one client per channel
+         *
+         * @param channels channels of the replica servers
+         * @throws std::invalid_argument if no channels are given
+         */
+        void ConnectChannels(const std::vector<std::shared_ptr<grpc::ChannelInterface>> &channels);
+
+        /**
+         * @brief Returns the number of replicas
+         */
+        size_t size() const noexcept { return replicas_.size(); }
+
+        /**
+         * @brief Returns the client of a replica
+         *
+         * Replica clients may be configured individually (e.g., timeouts,
+         * tracers, compression) before the pool is used. The first replica
+         * holds the discovered meta data.
+         *
+         * @param index replica index
+         * @return ExplicitClient& client of the replica
+         * @throws std::out_of_range if the index is invalid
+         */
+        ExplicitClient &GetReplica(size_t index);
+
+        //! @copydoc GetReplica
+        const ExplicitClient &GetReplica(size_t index) const;
+
+        /**
+         * @brief Sends the discipline options to every replica
+         *
+         * @param options
+         */
+        void SendOptions(const philote::DisciplineOptions &options);
+
+        /**
+         * @brief Discovers the discipline and sets up every replica
+         *
+         * Calls GetInfo, GetVariableDefinitions, and GetPartialDefinitions
+         * on the first replica and Setup on every replica.
+         *
+         * @throws std::runtime_error if the pool has no replicas or an RPC
+         * fails
+         */
+        void Initialize();
+
+        /**
+         * @brief Evaluates the function on the least loaded replica
+         *
+         * @param inputs
+         * @return Variables outputs
+         * @throws std::runtime_error if the call failed on every replica
+         */
+        Variables ComputeFunction(const Variables &inputs);
+
+        /**
+         * @brief Evaluates the gradient on the least loaded replica
+         *
+         * @param inputs
+         * @return Partials
+         * @throws std::runtime_error if the call failed on every replica
+         */
+        Partials ComputeGradient(const Variables &inputs);
+
+        /**
+         * @brief Evaluates the function and gradient on the least loaded replica
+         *
+         * @param inputs
+         * @return std::pair<Variables, Partials> outputs and partials
+         * @throws std::runtime_error if the call failed on every replica
+         */
+        std::pair<Variables, Partials> ComputeFunctionAndGradient(const Variables &inputs);
+
+        /**
+         * @brief Sets how long a failed replica is avoided
+         *
+         * @param backoff time after a failure during which other replicas
+         * are preferred (default: 1 second)
+         */
+        void SetFailureBackoff(std::chrono::milliseconds backoff) { failure_backoff_ = backoff; }
+
+        /**
+         * @brief Returns the load counters of all replicas
+         */
+        std::vector<ReplicaStats> GetReplicaStats() const;
+
+    private:
+        //! Client of a replica server
+        struct Replica
+        {
+            //! client of the replica
+            std::unique_ptr<ExplicitClient> client;
+
+            //! serializes the calls of the client
+            std::mutex call_mutex;
+
+            //! load counters (guarded by the pool mutex)
+            ReplicaStats stats;
+
+            //! time before which the replica is avoided (guarded by the pool mutex)
+            std::chrono::steady_clock::time_point retry_after;
+        };
+
+        /**
+         * @brief Reserves the least loaded replica that was not tried yet
+         *
+         * @param tried replicas that already failed the call
+         * @return size_t index of the replica
+         */
+        size_t Acquire(const std::vector<bool> &tried);
+
+        /**
+         * @brief Releases a replica reserved by Acquire
+         *
+         * @param index index of the replica
+         * @param failed whether the call failed on the replica
+         */
+        void Release(size_t index, bool failed);
+
+        /**
+         * @brief Runs a call on the replicas until it succeeds
+         *
+         * @param call compute call of a replica client
+         * @return Result result of the call
+         */
+        template <class Result>
+        Result Dispatch(const std::function<Result(ExplicitClient &)> &call);
+
+        //! replica clients
+        std::vector<std::unique_ptr<Replica>> replicas_;
+
+        //! guards the load counters and the replica selection
+        mutable std::mutex mutex_;
+
+        //! replica at which the next selection starts (spreads ties)
+        size_t next_ = 0;
+
+        //! time a failed replica is avoided
+        std::chrono::milliseconds failure_backoff_{1000};
+    };
+} // namespace philote
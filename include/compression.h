@@ -0,0 +1,176 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <grpc/compression.h>
+#include <grpcpp/grpcpp.h>
+
+#include <data.pb.h>
+
+namespace philote
+{
+    //! Default number of values from which stream messages are compressed (8 KiB of doubles)
+    constexpr size_t kDefaultMinCompressedValues = 1024;
+
+    /**
+     * @brief Compression of the stream messages of compute calls
+     *
+     * Messages carrying at least min_values values are compressed with the
+     * algorithm; smaller messages (e.g., control messages or the tails of
+     * variables) are sent uncompressed, since compressing them costs more
+     * time than it saves bandwidth.
+     */
+    struct CompressionPolicy
+    {
+        //! gRPC compression algorithm (GRPC_COMPRESS_NONE disables compression)
+        grpc_compression_algorithm algorithm = GRPC_COMPRESS_NONE;
+
+        //! minimum number of values of a compressed message
+        size_t min_values = kDefaultMinCompressedValues;
+
+        /**
+         * @brief Checks whether the policy compresses any messages
+         *
+         * @return true if an algorithm is set
+         */
+        bool Enabled() const noexcept;
+
+        /**
+         * @brief Checks whether a message should be compressed
+         *
+         * @param message stream message
+         * @return true if compression is enabled and the message carries at
+         * least min_values values
+         */
+        bool Compresses(const Array &message) const noexcept;
+
+        /**
+         * @brief Returns the write options of a message
+         *
+         * @param message stream message
+         * @return grpc::WriteOptions options disabling compression for small
+         * messages (default options if the policy is disabled, so a
+         * compression algorithm configured for the channel still applies)
+         */
+        grpc::WriteOptions WriteOptionsFor(const Array &message) const;
+    };
+
+    /**
+     * @brief Encodes a compression policy as a metadata value
+     *
+     * @param policy compression policy
+     * @return std::string "algorithm,min_values", e.g., "gzip,1024"
+     */
+    std::string FormatCompressionPolicy(const CompressionPolicy &policy);
+
+    /**
+     * @brief Decodes a compression policy from a metadata value
+     *
+     * @param text metadata value (see FormatCompressionPolicy)
+     * @param policy decoded policy
+     * @return true if the text names a known algorithm and a valid threshold
+     */
+    bool ParseCompressionPolicy(const std::string &text, CompressionPolicy &policy);
+
+    /**
+     * @brief Server stream that disables compression for small messages
+     *
+     * Forwards all calls to the wrapped stream. The compression algorithm
+     * itself is set on the server context (see CompressCall).
+     */
+    class CompressedArrayStream : public grpc::ServerReaderWriterInterface<Array, Array>
+    {
+    public:
+        using grpc::internal::WriterInterface<Array>::Write;
+
+        /**
+         * @brief Wraps a stream
+         *
+         * @param stream stream of the RPC
+         * @param policy compression policy of the RPC
+         */
+        CompressedArrayStream(grpc::ServerReaderWriterInterface<Array, Array> *stream,
+                              const CompressionPolicy &policy);
+
+        void SendInitialMetadata() override;
+
+        bool Write(const Array &msg, grpc::WriteOptions options) override;
+
+        bool NextMessageSize(uint32_t *sz) override;
+
+        bool Read(Array *msg) override;
+
+    private:
+        //! wrapped stream
+        grpc::ServerReaderWriterInterface<Array, Array> *stream_;
+
+        //! compression policy of the RPC
+        CompressionPolicy policy_;
+    };
+
+    /**
+     * @brief Returns the compression policy a client requested for a call
+     *
+     * @param context server context of the call (may be nullptr)
+     * @return CompressionPolicy the requested policy (disabled if the client
+     * did not request compression)
+     */
+    CompressionPolicy RequestedCompression(const grpc::ServerContextBase *context);
+
+    /**
+     * @brief Runs the logic of a compute RPC with the compression requested by the client
+     *
+     * Without a requested policy, the handler is called with the original
+     * stream.
+     *
+     * @param context server context of the RPC
+     * @param stream stream of the RPC
+     * @param handler RPC logic, callable with StreamType* and CompressedArrayStream*
+     * @return grpc::Status status of the handler
+     */
+    template <typename StreamType, typename Handler>
+    grpc::Status CompressCall(grpc::ServerContextBase *context, StreamType *stream, Handler &&handler)
+    {
+        const CompressionPolicy policy = RequestedCompression(context);
+        if (!policy.Enabled() or stream == nullptr)
+            return handler(stream);
+
+        // evaluation streams served by the callback engine apply the policy
+        // once per evaluation
+        if (context->compression_algorithm() != policy.algorithm)
+            context->set_compression_algorithm(policy.algorithm);
+        CompressedArrayStream compressed(stream, policy);
+        return handler(&compressed);
+    }
+}
@@ -0,0 +1,164 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <data.pb.h>
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @brief Computes the content hash of discipline definitions
+     *
+     * Covers the variable meta data, the partials meta data, the sparsity
+     * patterns, and the discrete variables, so two disciplines with the
+     * same hash send the same definitions.
+     *
+     * @param var_meta variable meta data
+     * @param partials_meta partials meta data
+     * @param sparsity sparsity patterns of the sparse partials
+     * @param discrete names of the discrete variables
+     * @return std::string 128-bit hash as 32 hexadecimal digits
+     */
+    std::string HashDefinitions(const std::vector<VariableMetaData> &var_meta,
+                                const std::vector<PartialsMetaData> &partials_meta,
+                                const PartialsSparsity &sparsity,
+                                const std::set<std::string> &discrete = {});
+
+    /**
+     * @brief Local cache of variable and partial definitions
+     *
+     * Servers with the definitions-hash extension return the hash of their
+     * definitions (see HashDefinitions) from Setup. Clients with a cache
+     * (see DisciplineClient::SetDefinitionCache) then take the definitions
+     * from the cache instead of calling GetVariableDefinitions and
+     * GetPartialDefinitions if an entry with the hash exists, and store the
+     * definitions they receive otherwise.
+     *
+     * Entries are kept in memory and, if a directory is given, in one file
+     * per entry, so that short-lived processes on the same host share them.
+     * Files are replaced atomically and unreadable files are ignored.
+     *
+     * @note Thread Safety: All member functions are thread-safe. Several
+     * processes may use the same directory.
+     */
+    class DefinitionCache
+    {
+    public:
+        /**
+         * @brief Constructs a cache
+         *
+         * @param directory directory of the cache files (empty: memory only);
+         * it is not created by the cache
+         */
+        explicit DefinitionCache(std::string directory = "");
+
+        /**
+         * @brief Looks up the variable definitions of a hash
+         *
+         * @param hash definitions hash returned by Setup
+         * @param meta receives the definitions if found
+         * @param discrete whether the messages were requested with discrete variables
+         * @return true if the definitions were found
+         */
+        bool LoadVariables(const std::string &hash, std::vector<VariableMetaData> &meta,
+                           bool discrete = false);
+
+        /**
+         * @brief Stores the variable definitions of a hash
+         *
+         * @param hash definitions hash returned by Setup
+         * @param meta definitions received from the server (including
+         * discrete markers)
+         * @param discrete whether the messages were requested with discrete variables
+         */
+        void StoreVariables(const std::string &hash, const std::vector<VariableMetaData> &meta,
+                            bool discrete = false);
+
+        /**
+         * @brief Looks up the partial definitions messages of a hash
+         *
+         * @param hash definitions hash returned by Setup
+         * @param sparse whether the messages were requested with sparse partials
+         * @param meta receives the messages if found
+         * @return true if the messages were found
+         */
+        bool LoadPartials(const std::string &hash, bool sparse, std::vector<PartialsMetaData> &meta);
+
+        /**
+         * @brief Stores the partial definitions messages of a hash
+         *
+         * @param hash definitions hash returned by Setup
+         * @param sparse whether the messages were requested with sparse partials
+         * @param meta messages received from the server (including sparsity
+         * pattern messages)
+         */
+        void StorePartials(const std::string &hash, bool sparse, const std::vector<PartialsMetaData> &meta);
+
+        /**
+         * @brief Returns the directory of the cache files (empty if none)
+         */
+        const std::string &directory() const noexcept { return directory_; }
+
+    private:
+        /**
+         * @brief Reads the serialized messages of an entry
+         *
+         * @param name entry name
+         * @param messages receives the serialized messages
+         * @return true if the entry exists and is readable
+         */
+        bool Load(const std::string &name, std::vector<std::string> &messages);
+
+        /**
+         * @brief Writes the serialized messages of an entry
+         *
+         * @param name entry name
+         * @param messages serialized messages
+         */
+        void Store(const std::string &name, std::vector<std::string> messages);
+
+        //! directory of the cache files
+        std::string directory_;
+
+        //! guards the entries
+        std::mutex mutex_;
+
+        //! serialized messages by entry name
+        std::map<std::string, std::vector<std::string>> entries_;
+    };
+} // namespace philote
@@ -32,9 +32,23 @@
 
 #include <google/protobuf/struct.pb.h>
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <admission.h>
+#include <cancellation.h>
+#include <meta_index.h>
+#include <metrics.h>
+#include <protocol_extensions.h>
+#include <thread_placement.h>
+#include <thread_pool.h>
+#include <tracing.h>
 #include <variable.h>
+#include <workspace.h>
 
 #include <data.pb.h>
 #include <disciplines.grpc.pb.h>
@@ -86,12 +100,41 @@ namespace philote
         std::vector<philote::VariableMetaData> &var_meta() { return var_meta_; }
         const std::vector<philote::VariableMetaData> &var_meta() const noexcept { return var_meta_; }
 
+        /**
+         * @brief Finds the meta data of a variable by name
+         *
+         * Uses a name index that AddInput and AddOutput keep up to date.
+         *
+         * @param name variable name
+         * @return const VariableMetaData* meta data (nullptr if not defined)
+         */
+        const philote::VariableMetaData *FindVariableMeta(const std::string &name) const;
+
+        /**
+         * @brief Removes the variable and partials meta data
+         *
+         * Clears the meta data, the sparsity patterns, the discrete
+         * variables, and the variable name index before the discipline is
+         * set up again. Derived classes that
+         * keep further per-partial declarations clear them as well.
+         */
+        virtual void ClearMetaData();
+
         /**
          * @brief Accesses the partials meta data
          */
         std::vector<philote::PartialsMetaData> &partials_meta() { return partials_meta_; }
         const std::vector<philote::PartialsMetaData> &partials_meta() const noexcept { return partials_meta_; }
 
+        /**
+         * @brief Accesses the sparsity patterns of the sparse partials
+         *
+         * The meta data of a sparse partial has the shape {nnz}; its dense
+         * shape is stored in the pattern.
+         */
+        philote::PartialsSparsity &partials_sparsity() { return partials_sparsity_; }
+        const philote::PartialsSparsity &partials_sparsity() const noexcept { return partials_sparsity_; }
+
         /**
          * @brief Gets the discipline properties
          *
@@ -107,6 +150,26 @@ namespace philote
         philote::StreamOptions &stream_opts() { return stream_opts_; }
         const philote::StreamOptions &stream_opts() const noexcept { return stream_opts_; }
 
+        /**
+         * @brief Sets the maximum gRPC message size of the server
+         *
+         * RegisterServices applies the limit to the server builder (send and
+         * receive). The limit is advertised to clients, which derive the
+         * stream chunk size from it (see kFeatureChunkNegotiation).
+         *
+         * @param bytes maximum message size in bytes (must be positive)
+         * @throws std::invalid_argument if bytes is zero
+         */
+        void SetMaxMessageBytes(size_t bytes);
+
+        /**
+         * @brief Returns the maximum gRPC message size of the server
+         *
+         * @return size_t the limit set by SetMaxMessageBytes, or gRPC's
+         * default of kDefaultMaxMessageBytes
+         */
+        size_t max_message_bytes() const noexcept;
+
         /**
          * @brief Declares an input
          *
@@ -125,6 +188,51 @@ namespace philote
                        const std::vector<int64_t> &shape,
                        const std::string &units);
 
+        /**
+         * @brief Declares a discrete (integer) input
+         *
+         * Clients that support discrete variables receive the values of
+         * discrete variables as packed integers (see WirePrecision::kInteger)
+         * and store them in discrete Variables. Other clients see a regular
+         * input. On the server, discrete inputs are held as doubles like all
+         * other inputs. Partials cannot be declared for discrete variables.
+         *
+         * @param name variable name
+         * @param shape shape of the variable
+         * @param units units of the variable
+         */
+        void AddDiscreteInput(const std::string &name,
+                              const std::vector<int64_t> &shape,
+                              const std::string &units = "");
+
+        /**
+         * @brief Declares a discrete (integer) output
+         *
+         * Values are rounded to integers when they are sent to clients that
+         * support discrete variables (see AddDiscreteInput).
+         *
+         * @param name variable name
+         * @param shape shape of the variable
+         * @param units units of the variable
+         */
+        void AddDiscreteOutput(const std::string &name,
+                               const std::vector<int64_t> &shape,
+                               const std::string &units = "");
+
+        /**
+         * @brief Returns whether a variable was declared discrete
+         *
+         * @param name variable name
+         * @return true if the variable was added with AddDiscreteInput or
+         * AddDiscreteOutput
+         */
+        bool IsDiscrete(const std::string &name) const;
+
+        /**
+         * @brief Returns the names of the discrete variables
+         */
+        const std::set<std::string> &discrete_variables() const noexcept { return discrete_variables_; }
+
         /**
          * @brief Declare a (set of) partial(s) for the discipline
          *
@@ -133,13 +241,49 @@ namespace philote
          */
         void DeclarePartials(const std::string &f, const std::string &x);
 
+        /**
+         * @brief Declare a sparse partial for the discipline
+         *
+         * Only the listed non-zeros are stored and transmitted (see
+         * SparsityPattern). Clients that do not support sparse partials
+         * receive the dense partial instead.
+         *
+         * @param f output variable
+         * @param x input variable
+         * @param rows flattened index into f of each non-zero
+         * @param cols flattened index into x of each non-zero
+         * @throws std::invalid_argument if rows and cols differ in length or
+         * contain duplicate entries
+         * @throws std::out_of_range if an index exceeds the variable sizes
+         */
+        void DeclarePartials(const std::string &f, const std::string &x,
+                             const std::vector<int64_t> &rows,
+                             const std::vector<int64_t> &cols);
+
         /**
          * @brief Add an option to the discipline
          *
+         * Options that do not affect the variable or partials definitions
+         * (e.g., solver tolerances) can be declared with affects_shape set to
+         * false. Changing only such options keeps the meta data and the
+         * preallocated workspaces, and clients skip the next Setup and
+         * definition requests. These options must therefore take effect in
+         * SetOptions or Configure, not in Setup.
+         *
          * @param name Option name
          * @param type Option type as string (e.g., "bool", "int", "float", "string")
+         * @param affects_shape whether the option may change the definitions
          */
-        void AddOption(const std::string &name, const std::string &type);
+        void AddOption(const std::string &name, const std::string &type, bool affects_shape = true);
+
+        /**
+         * @brief Whether an option may change the variable or partials definitions
+         *
+         * Unknown options are treated as affecting the definitions.
+         *
+         * @param name Option name
+         */
+        bool OptionAffectsShape(const std::string &name) const;
 
         /**
          * @brief Initialize function that sets up available options
@@ -180,6 +324,142 @@ namespace philote
          */
         virtual void SetupPartials();
 
+        /**
+         * @brief Called by the server as soon as a variable has been received
+         *
+         * Fires during the streaming of a compute RPC, once all chunks of an
+         * input (or, for implicit disciplines, of an output) have arrived,
+         * so that preprocessing can overlap with the transfer of the
+         * remaining variables. Only called if enabled with
+         * EnableInputReadyNotifications. The default does nothing.
+         *
+         * @param name variable name
+         * @param value received variable (valid until the RPC finishes)
+         */
+        virtual void OnInputReady(const std::string &name, const philote::Variable &value);
+
+        /**
+         * @brief Enables or disables calls to OnInputReady
+         *
+         * @param enable whether the server calls OnInputReady (default: false)
+         */
+        void EnableInputReadyNotifications(bool enable = true) noexcept { input_ready_notifications_ = enable; }
+
+        /**
+         * @brief Returns whether the server calls OnInputReady
+         */
+        bool input_ready_notifications() const noexcept { return input_ready_notifications_; }
+
+        /**
+         * @brief Assigns the received messages of the compute RPCs on a worker pool
+         *
+         * The RPC thread keeps reading the stream while the workers copy the
+         * values into the variables (see ParallelAssembly), and the messages
+         * of the partials are serialized by the workers while the previous
+         * partial is written. Pays off for disciplines with many or large
+         * variables. Calls exchanging the values through shared memory are
+         * assembled inline. OnInputReady is called by the workers, one call at
+         * a time.
+         *
+         * @param threads number of worker threads (0 disables the pool, the
+         * default)
+         */
+        void SetAssemblyThreads(size_t threads);
+
+        /**
+         * @brief Returns the assembly worker pool (nullptr if disabled)
+         */
+        ThreadPool *assembly_pool() const noexcept { return assembly_pool_.get(); }
+
+        /**
+         * @brief Stores large outputs of the compute RPCs in memory-mapped files
+         *
+         * The outputs of a call are stored in an anonymous file in the
+         * directory if they hold at least storage.min_size values together.
+         * Compute writes to the file and the values are paged out again once
+         * they are sent, so the resident memory stays bounded for outputs
+         * larger than the available memory.
+         *
+         * @param storage placement of the outputs (an empty directory keeps
+         * them in memory, the default)
+         */
+        void SetFileStorage(const FileStorage &storage);
+
+        /**
+         * @brief Returns the placement of the outputs of the compute RPCs
+         */
+        const FileStorage &file_storage() const noexcept { return file_storage_; }
+
+        /**
+         * @brief Limits the compute RPCs the server accepts at the same time
+         *
+         * Calls beyond the limits are rejected with RESOURCE_EXHAUSTED and a
+         * retry-after hint instead of queuing their inputs in memory (see
+         * AdmissionController). The limits are shared by all instances of an
+         * instance pool.
+         *
+         * @param limits admission limits (all zero disables the checks)
+         * @throws std::invalid_argument if the retry-after hint is not positive
+         */
+        void SetAdmissionLimits(const AdmissionLimits &limits);
+
+        /**
+         * @brief Returns the admission controller (nullptr if disabled)
+         */
+        AdmissionController *admission_controller() const noexcept { return admission_.get(); }
+
+        /**
+         * @brief Runs the compute RPCs served by this instance on a CPU set
+         *
+         * Assigned by the instance pool of a server with a ThreadPlacement.
+         * The server pins the thread of every call to these CPUs while the
+         * call uses the instance, so the workspaces of the instance are
+         * allocated and first touched on its NUMA node. The placement is not
+         * copied by CopyConfiguration.
+         *
+         * @param cpus CPU ids (empty lets the calls run anywhere)
+         */
+        void SetPlacement(std::vector<int> cpus) { placement_ = std::move(cpus); }
+
+        /**
+         * @brief Returns the CPUs the compute RPCs of this instance run on (empty if unplaced)
+         */
+        const std::vector<int> &placement() const noexcept { return placement_; }
+
+        /**
+         * @brief Records the phase timings and message counts of the compute RPCs
+         *
+         * The recorder receives one CallMetrics per compute RPC served for
+         * this discipline (including RPCs served by pooled instances). Without
+         * a recorder (the default), the RPCs are not measured.
+         *
+         * @param recorder thread-safe recorder, e.g., a MetricsRegistry
+         * (nullptr disables the measurements)
+         */
+        void SetMetricsRecorder(std::shared_ptr<MetricsRecorder> recorder) { metrics_recorder_ = std::move(recorder); }
+
+        /**
+         * @brief Returns the metrics recorder (nullptr if disabled)
+         */
+        MetricsRecorder *metrics_recorder() const noexcept { return metrics_recorder_.get(); }
+
+        /**
+         * @brief Emits trace spans for the compute RPCs
+         *
+         * Every compute RPC served for this discipline (including RPCs
+         * served by pooled instances) gets a server span, which continues the
+         * trace propagated by the client, with child spans for receiving the
+         * inputs, computing, and sending the results.
+         *
+         * @param tracer thread-safe tracer (nullptr disables tracing)
+         */
+        void SetTracer(std::shared_ptr<Tracer> tracer) { tracer_ = std::move(tracer); }
+
+        /**
+         * @brief Returns the tracer (nullptr if disabled)
+         */
+        Tracer *tracer() const noexcept { return tracer_.get(); }
+
         /**
          * @brief Set the gRPC server context for cancellation detection
          *
@@ -189,7 +469,7 @@ namespace philote
          *
          * @param context The gRPC server context, or nullptr to clear
          */
-        void SetContext(grpc::ServerContext* context) const noexcept;
+        void SetContext(grpc::ServerContextBase* context) const noexcept;
 
         /**
          * @brief Clear the gRPC server context
@@ -206,6 +486,8 @@ namespace philote
          * User disciplines can call this method during long-running computations
          * to detect if the client has cancelled the request. If true is returned,
          * the discipline should stop computation and return/throw as appropriate.
+         * The check reads the flag set by the CancellationMonitor, so it is
+         * cheap enough to be called from tight loops.
          *
          * @return true if the operation has been cancelled by the client
          * @return false if no cancellation has been requested or no context is set
@@ -225,7 +507,96 @@ namespace philote
          */
         bool IsCancelled() const noexcept;
 
+        /**
+         * @brief Returns the cancellation token of the current operation
+         *
+         * The token can be copied into worker threads of a Compute function.
+         * It stays cancelled after the operation ended. Without a context (or
+         * if the context could not be watched), a token that is never
+         * cancelled is returned.
+         */
+        CancellationToken cancellation_token() const
+        {
+            return current_context_ != nullptr and watching_ ? cancellation_ : CancellationToken();
+        }
+
+        /**
+         * @brief Returns all options applied via SetOptions
+         *
+         * Options from consecutive SetOptions calls are merged, with later
+         * values replacing earlier ones.
+         */
+        const google::protobuf::Struct &applied_options() const noexcept { return applied_options_; }
+
+        /**
+         * @brief Returns a counter that changes whenever the configuration changes
+         *
+         * The counter is advanced by SetOptions, by CopyConfiguration, and by
+         * the server whenever the client changes the stream options or runs
+         * Setup. It is used by instance pools to detect pooled instances with
+         * outdated configurations.
+         */
+        uint64_t configuration_generation() const noexcept { return configuration_generation_.load(); }
+
+        /**
+         * @brief Returns a counter that changes whenever the definitions may change
+         *
+         * Unlike the configuration generation, this counter is not advanced by
+         * SetOptions calls that only change options declared without
+         * affects_shape. It keys the preallocated workspaces.
+         */
+        uint64_t layout_generation() const noexcept { return layout_generation_.load(); }
+
+        /**
+         * @brief Returns the number of SetOptions calls applied so far
+         */
+        uint64_t options_generation() const noexcept { return options_generation_.load(); }
+
+        /**
+         * @brief Advances the configuration and layout generations
+         */
+        void MarkConfigurationChanged() noexcept
+        {
+            configuration_generation_++;
+            layout_generation_++;
+        }
+
+        /**
+         * @brief Configures this discipline like another discipline instance
+         *
+         * Replays the applied options (via SetOptions) and stream options of
+         * the source discipline and, if the source discipline has been set up
+         * and its layout generation changed since the last copy, reruns Setup
+         * and SetupPartials. This is used to bring pooled
+         * discipline instances in line with the discipline registered with the
+         * server.
+         *
+         * @param source discipline whose configuration is copied
+         */
+        void CopyConfiguration(const Discipline &source);
+
+        /**
+         * @brief Obtains preallocated, zeroed variables for a compute RPC
+         *
+         * Workspaces are built from the meta data on first use and reused
+         * until the configuration generation (or the number of variables or
+         * partials) changes. Concurrent RPCs obtain separate workspaces.
+         *
+         * @return WorkspaceCache::Lease
+         */
+        WorkspaceCache::Lease AcquireWorkspace() const;
+
     protected:
+        /**
+         * @brief Applies the maximum message size to a server builder
+         *
+         * Does nothing unless SetMaxMessageBytes was called, so limits set
+         * directly on the builder are kept.
+         *
+         * @param builder server builder the services are registered with
+         */
+        void ApplyMessageLimits(grpc::ServerBuilder &builder) const;
+
         /**
          * @brief Computes the shape for a partial derivative df/dx
          *
@@ -243,23 +614,171 @@ namespace philote
                                                   const std::string &x,
                                                   bool allow_output_as_x);
 
+        /**
+         * @brief Declares a sparse partial derivative df/dx
+         *
+         * @param f Name of the output variable
+         * @param x Name of the input (or output for implicit disciplines) variable
+         * @param rows flattened index into f of each non-zero
+         * @param cols flattened index into x of each non-zero
+         * @param allow_output_as_x If true, allows x to be an output variable (for implicit disciplines)
+         */
+        void DeclareSparsePartials(const std::string &f,
+                                   const std::string &x,
+                                   const std::vector<int64_t> &rows,
+                                   const std::vector<int64_t> &cols,
+                                   bool allow_output_as_x);
+
         //! List of options that can be set by the client
         std::map<std::string, std::string> options_list_;
 
+        //! Options that do not change the definitions
+        std::set<std::string> shapeless_options_;
+
         //! List of variable meta data
         std::vector<philote::VariableMetaData> var_meta_;
 
+        //! Name index of the variable meta data
+        philote::VariableMetaIndex var_index_;
+
+        //! Names of the discrete variables
+        std::set<std::string> discrete_variables_;
+
         //! List of partials meta data
         std::vector<philote::PartialsMetaData> partials_meta_;
 
+        //! Sparsity patterns of the sparse partials
+        philote::PartialsSparsity partials_sparsity_;
+
         //! Discipline properties
         philote::DisciplineProperties properties_;
 
         //! Stream options
         philote::StreamOptions stream_opts_;
 
+        //! Maximum message size in bytes (0: gRPC default)
+        size_t max_message_bytes_ = 0;
+
         //! Current gRPC server context for cancellation detection (mutable for const correctness)
-        mutable grpc::ServerContext* current_context_ = nullptr;
+        mutable grpc::ServerContextBase* current_context_ = nullptr;
+
+        //! Cancellation token of the current context
+        mutable CancellationToken cancellation_;
+
+        //! Whether the current context is watched by the CancellationMonitor
+        mutable bool watching_ = false;
+
+        //! Options applied via SetOptions (merged)
+        google::protobuf::Struct applied_options_;
+
+        //! Configuration generation counter
+        std::atomic<uint64_t> configuration_generation_{0};
+
+        //! Layout generation counter
+        std::atomic<uint64_t> layout_generation_{0};
+
+        //! Number of applied SetOptions calls
+        std::atomic<uint64_t> options_generation_{0};
+
+        //! Layout generation of the source of the last CopyConfiguration
+        uint64_t copied_layout_generation_ = 0;
+
+        //! Preallocated variables for compute RPCs
+        mutable WorkspaceCache workspaces_;
+
+        //! Placement of the outputs of the compute RPCs
+        FileStorage file_storage_;
+
+        //! Whether the server calls OnInputReady
+        bool input_ready_notifications_ = false;
+
+        //! Workers assembling the messages of the compute RPCs
+        std::shared_ptr<ThreadPool> assembly_pool_;
+
+        //! Admission control of the compute RPCs (nullptr if disabled)
+        std::shared_ptr<AdmissionController> admission_;
+
+        //! CPUs the compute RPCs of this instance run on (empty if unplaced)
+        std::vector<int> placement_;
+
+        //! Recorder of the compute RPC measurements
+        std::shared_ptr<MetricsRecorder> metrics_recorder_;
+
+        //! Tracer of the compute RPCs
+        std::shared_ptr<Tracer> tracer_;
+    };
+
+    /**
+     * @brief Sets the server context of a discipline for the lifetime of a scope
+     *
+     * Clears the context (and stops watching it for cancellation) even if a
+     * compute function throws an exception that is not caught by the server.
+     */
+    class ContextScope
+    {
+    public:
+        ContextScope(const Discipline *discipline, grpc::ServerContextBase *context) noexcept
+            : discipline_(discipline)
+        {
+            discipline_->SetContext(context);
+        }
+
+        ~ContextScope() noexcept { discipline_->ClearContext(); }
+
+        ContextScope(const ContextScope &) = delete;
+        ContextScope &operator=(const ContextScope &) = delete;
+
+    private:
+        //! discipline whose context is set
+        const Discipline *discipline_;
+    };
+
+    /**
+     * @brief Calls Discipline::OnInputReady once a variable is complete
+     *
+     * Used by the compute RPCs to count the values received per variable.
+     * Does nothing unless the discipline enabled input ready notifications.
+     */
+    class InputReadyTracker
+    {
+    public:
+        /**
+         * @brief Constructs a tracker for one RPC
+         *
+         * @param discipline discipline instance serving the RPC
+         */
+        explicit InputReadyTracker(Discipline *discipline);
+
+        /**
+         * @brief Records received values of a variable
+         *
+         * @param name variable name
+         * @param value variable the values were assigned to
+         * @param count number of values received
+         * @return grpc::Status INTERNAL if OnInputReady threw
+         */
+        grpc::Status Received(const std::string &name, const Variable &value, size_t count);
+
+        /**
+         * @brief Notifies the variables that did not receive all their values
+         *
+         * Used by calls whose remaining values were restored from a previous
+         * call (see InputSessionCache).
+         *
+         * @param values all input variables of the RPC
+         * @return grpc::Status INTERNAL if OnInputReady threw
+         */
+        grpc::Status Complete(const Variables &values);
+
+    private:
+        //! discipline to notify (nullptr if disabled)
+        Discipline *discipline_;
+
+        //! guards received_ (messages may be assigned by several workers)
+        std::mutex mutex_;
+
+        //! number of values received per variable
+        std::map<std::string, size_t> received_;
     };
 
 }
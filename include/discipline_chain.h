@@ -0,0 +1,160 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <explicit.h>
+#include <implicit.h>
+
+namespace philote
+{
+    /**
+     * @brief Explicit discipline composed of in-process stages
+     *
+     * Chains explicit and implicit disciplines that run in the same process
+     * (e.g., a mesh deformation feeding a flow solver). The stages are
+     * evaluated in the order they were added; implicit stages are solved
+     * with SolveResiduals. Connected inputs are views of the outputs they are
+     * connected to, so intermediate values are neither copied nor
+     * serialized.
+     *
+     * The chain exposes the unconnected inputs and the outputs that are not
+     * connected to a later stage as "stage.variable". Partials of the
+     * exposed outputs are obtained by propagating the partials of the stages
+     * (using SolveLinear for implicit stages).
+     *
+     * @code
+     * auto chain = std::make_shared<philote::DisciplineChain>();
+     * chain->AddStage("mesh", std::make_shared<MeshDeformation>());
+     * chain->AddStage("flow", std::make_shared<FlowSolver>());
+     * chain->Connect("mesh", "nodes", "flow", "nodes");
+     * chain->RegisterServices(builder);
+     * @endcode
+     *
+     * @note The stages are never served themselves; the chain calls Setup,
+     * SetupPartials, SetOptions, and the compute functions of the stages.
+     * Explicit stages are evaluated with Compute and ComputePartials (not
+     * ComputeFlat). Evaluations of the chain are serialized, since the
+     * stages share their buffers between calls.
+     */
+    class DisciplineChain : public ExplicitDiscipline
+    {
+    public:
+        /**
+         * @brief Appends an explicit stage
+         *
+         * @param name stage name (prefix of the exposed variables)
+         * @param discipline stage discipline
+         * @throws std::invalid_argument if the name is already used or contains '.'
+         */
+        void AddStage(const std::string &name, std::shared_ptr<ExplicitDiscipline> discipline);
+
+        /**
+         * @brief Appends an implicit stage, whose outputs are solved for
+         *
+         * @param name stage name (prefix of the exposed variables)
+         * @param discipline stage discipline
+         * @throws std::invalid_argument if the name is already used or contains '.'
+         */
+        void AddStage(const std::string &name, std::shared_ptr<ImplicitDiscipline> discipline);
+
+        /**
+         * @brief Connects an output of a stage to an input of a later stage
+         *
+         * Validated in Setup: both variables must exist, have the same size,
+         * and the output stage must come first.
+         *
+         * @param from_stage stage computing the output
+         * @param output output name
+         * @param to_stage stage receiving the input
+         * @param input input name
+         */
+        void Connect(const std::string &from_stage, const std::string &output,
+                     const std::string &to_stage, const std::string &input);
+
+        //! Initializes every stage and collects their options
+        void Initialize() override;
+
+        //! Forwards the options to every stage
+        void SetOptions(const google::protobuf::Struct &options_struct) override;
+
+        void Setup() override;
+        void SetupPartials() override;
+        void Compute(const philote::Variables &inputs, philote::Variables &outputs) override;
+        void ComputePartials(const philote::Variables &inputs, Partials &partials) override;
+
+    private:
+        struct Stage
+        {
+            std::string name;
+
+            //! the stage discipline (one of the two is set)
+            std::shared_ptr<ExplicitDiscipline> explicit_discipline;
+            std::shared_ptr<ImplicitDiscipline> implicit_discipline;
+
+            //! upstream (stage index, output) of the connected inputs
+            std::map<std::string, std::pair<size_t, std::string>> connections;
+
+            //! input and output buffers; connected inputs view upstream outputs
+            philote::Variables inputs;
+            philote::Variables outputs;
+
+            //! outputs that are not connected to a later stage
+            std::vector<std::string> exposed_outputs;
+
+            //! exposed inputs that the outputs depend on
+            std::vector<std::string> dependencies;
+
+            Discipline &discipline() const;
+        };
+
+        //! Evaluates all stages at the exposed inputs
+        void Evaluate(const philote::Variables &inputs);
+
+        //! Computes the partials of a stage at its current buffers
+        Partials StagePartials(const Stage &stage) const;
+
+        //! Finds a stage by name
+        size_t StageIndex(const std::string &name) const;
+
+        //! stages in evaluation order
+        std::vector<Stage> stages_;
+
+        //! serializes evaluations (they share the stage buffers)
+        std::mutex mutex_;
+    };
+}
@@ -34,14 +34,49 @@
 #include <grpcpp/impl/codegen/status_code_enum.h>
 #include <grpcpp/support/status.h>
 
+#include <chunk_pipeline.h>
+#include <compression.h>
+#include <definition_cache.h>
+#include <input_session.h>
 #include <disciplines.grpc.pb.h>
+#include <meta_index.h>
+#include <protocol_extensions.h>
+#include <result_cache.h>
+#include <shared_memory.h>
+#include <tracing.h>
+#include <variable.h>
 #include <chrono>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace philote
 {
+    /**
+     * @brief Retries of compute calls rejected by an overloaded server
+     *
+     * Servers with admission control (see AdmissionLimits) reject calls
+     * exceeding their limits with RESOURCE_EXHAUSTED and a retry-after hint.
+     * The client waits for the larger of the hint and an exponentially
+     * growing delay (with jitter) before repeating the call.
+     */
+    struct BackoffPolicy
+    {
+        //! maximum number of retries of a call (0 disables retries)
+        size_t max_retries = 5;
+
+        //! delay of the first retry
+        std::chrono::milliseconds initial{50};
+
+        //! maximum delay of a retry
+        std::chrono::milliseconds max{2000};
+
+        //! growth of the delay with every retry
+        double multiplier = 2.0;
+    };
+
     /**
      * @brief Client class for interacting with a discipline server
      *
@@ -70,9 +105,38 @@ namespace philote
         /**
          * @brief Get the discipline info
          *
+         * Also records the protocol extensions advertised by the server (see
+         * ServerSupports). If the server supports chunk negotiation and the
+         * stream options were not set manually, the chunk size is derived
+         * from the smaller of the client and server message size limits and
+         * sent to the server.
          */
         void GetInfo();
 
+        /**
+         * @brief Checks whether the server advertised a protocol extension
+         *
+         * The advertised extensions are obtained by GetInfo. Before GetInfo
+         * has been called (or for servers that do not advertise extensions),
+         * no extensions are supported.
+         *
+         * @param feature extension name (e.g., philote::kFeatureBatch)
+         * @return true if the server supports the extension
+         */
+        bool ServerSupports(const std::string &feature) const noexcept;
+
+        /**
+         * @brief Get the protocol extensions advertised by the server
+         */
+        const std::set<std::string> &GetServerFeatures() const noexcept { return server_features_; }
+
+        /**
+         * @brief Set the protocol extensions supported by the server
+         *
+         * @param features extension names
+         */
+        void SetServerFeatures(const std::set<std::string> &features) { server_features_ = features; }
+
         /**
          * @brief Send the stream options to the server
          *
@@ -82,28 +146,93 @@ namespace philote
         /**
          * @brief Send the discipline options to the server
          *
+         * If the server supports the options-hot-reload extension and the
+         * options leave the definitions unchanged, the server keeps its meta
+         * data and the following Setup, GetVariableDefinitions, and
+         * GetPartialDefinitions calls return without contacting the server.
+         *
          * @param options
          */
         void SendOptions(const philote::DisciplineOptions &options);
 
+        /**
+         * @brief Whether the definitions must be set up after the last SendOptions
+         *
+         * @return false if the server applied the last options in place and
+         * the current meta data remains valid
+         */
+        bool SetupRequired() const noexcept { return !definitions_current_; }
+
+        /**
+         * @brief Returns the options generation reported by the last SendOptions
+         *
+         * The server advances the generation with every applied SetOptions
+         * call. Clients sharing a server can compare it to detect options
+         * changed by other clients. Zero if the server does not report it.
+         */
+        uint64_t OptionsGeneration() const noexcept { return options_generation_; }
+
         /**
          * @brief Setup the discipline
          *
+         * Returns immediately if the last SendOptions was applied in place
+         * (see SetupRequired).
          */
         void Setup();
 
         /**
          * @brief Get the variable definitions from the server
          *
+         * Taken from the definition cache instead if the hash returned by
+         * Setup is cached (see SetDefinitionCache).
          */
         void GetVariableDefinitions();
 
         /**
          * @brief Get the partial definitions from the server
          *
+         * Taken from the definition cache instead if the hash returned by
+         * Setup is cached (see SetDefinitionCache).
          */
         void GetPartialDefinitions();
 
+        /**
+         * @brief Sets the cache of the variable and partial definitions
+         *
+         * Servers with the definitions-hash extension return a hash of their
+         * definitions from Setup. GetVariableDefinitions and
+         * GetPartialDefinitions then skip their RPC if the cache holds the
+         * definitions of the hash, and store the received definitions
+         * otherwise. A cache may be shared by many clients (and, through its
+         * directory, by many processes).
+         *
+         * @param cache definition cache (nullptr disables caching)
+         */
+        void SetDefinitionCache(std::shared_ptr<DefinitionCache> cache) { definition_cache_ = std::move(cache); }
+
+        /**
+         * @brief Returns the definitions hash returned by the last Setup
+         *
+         * @return const std::string& hash (empty if the server did not send one)
+         */
+        const std::string &GetDefinitionsHash() const noexcept { return definitions_hash_; }
+
+        /**
+         * @brief Copies the discovered server information of another client
+         *
+         * Adopts the discipline properties, protocol extensions, stream
+         * options, and the variable and partials meta data (including the
+         * sparsity patterns) of a client that already called GetInfo,
+         * GetVariableDefinitions, and GetPartialDefinitions. This avoids
+         * repeating the discovery for servers of the same discipline (e.g.,
+         * replicas, see philote::ExplicitClientPool). The host id of the
+         * server is not copied, so shared memory is never used with the
+         * copied information.
+         *
+         * @param source client connected to a server of the same discipline
+         */
+        void CopyDefinitions(const DisciplineClient &source);
+
         /**
          * @brief Get the variable names
          *
@@ -146,9 +275,64 @@ namespace philote
         /**
          * @brief Set the stream options
          *
+         * Disables the chunk size negotiation of GetInfo, so the options are
+         * not overwritten.
+         *
          * @param options
          */
-        void SetStreamOptions(const StreamOptions &options) { stream_options_ = options; }
+        void SetStreamOptions(const StreamOptions &options)
+        {
+            stream_options_ = options;
+            negotiate_chunk_size_ = false;
+        }
+
+        /**
+         * @brief Enables or disables the chunk size negotiation of GetInfo
+         *
+         * @param enable whether GetInfo negotiates the chunk size (default: true)
+         */
+        void SetChunkSizeNegotiation(bool enable) noexcept { negotiate_chunk_size_ = enable; }
+
+        /**
+         * @brief Set the maximum message size of the client channel
+         *
+         * Used for the chunk size negotiation. This must match the limits the
+         * channel was created with (see grpc::ChannelArguments::SetMaxReceiveMessageSize
+         * and SetMaxSendMessageSize).
+         *
+         * @param bytes maximum message size in bytes (default: kDefaultMaxMessageBytes)
+         * @throws std::invalid_argument if bytes is zero
+         */
+        void SetMaxMessageBytes(size_t bytes);
+
+        /**
+         * @brief Get the maximum message size of the client channel
+         *
+         * @return size_t maximum message size in bytes
+         */
+        size_t GetMaxMessageBytes() const noexcept { return max_message_bytes_; }
+
+        /**
+         * @brief Set the size from which inputs are streamed through a pipeline
+         *
+         * Calls that send at least this many values prepare the next chunk
+         * while a background thread writes the previous one (see
+         * ChunkPipeline), overlapping serialization with the transfer.
+         *
+         * @param values total number of values sent by a call (default:
+         * kDefaultPipelineThreshold)
+         */
+        void SetPipelineThreshold(size_t values) noexcept { pipeline_threshold_ = values; }
+
+        /**
+         * @brief Get the size from which inputs are streamed through a pipeline
+         *
+         * @return size_t total number of values
+         */
+        size_t GetPipelineThreshold() const noexcept { return pipeline_threshold_; }
+
+        //! Default of SetPipelineThreshold (8 MB of values)
+        static constexpr size_t kDefaultPipelineThreshold = 1 << 20;
 
         /**
          * @brief Get the discipline properties
@@ -171,12 +355,29 @@ namespace philote
          */
         const std::vector<VariableMetaData> &GetVariableMetaAll() const noexcept { return var_meta_; }
 
+        /**
+         * @brief Returns whether the server declared a variable discrete
+         *
+         * Discrete variables are only reported by servers that support the
+         * discrete-variables extension. Their results are returned as
+         * discrete Variables, and their inputs are sent as packed integers.
+         *
+         * @param name variable name
+         * @return true if the variable is discrete
+         */
+        bool IsDiscrete(const std::string &name) const { return discrete_variables_.count(name) > 0; }
+
         /**
          * @brief Set the variable metadata
          *
          * @param meta
          */
-        void SetVariableMeta(const std::vector<VariableMetaData> &meta) { var_meta_ = meta; }
+        void SetVariableMeta(const std::vector<VariableMetaData> &meta)
+        {
+            var_meta_ = meta;
+            var_index_.Clear();
+            var_index_.Update(var_meta_);
+        }
 
         /**
          * @brief Get the partials metadata (const version)
@@ -192,6 +393,18 @@ namespace philote
          */
         void SetPartialsMetaData(const std::vector<PartialsMetaData> &meta) { partials_meta_ = meta; }
 
+        /**
+         * @brief Get the sparsity patterns of the sparse partials
+         *
+         * Populated by GetPartialDefinitions if the server supports sparse
+         * partials (see GetInfo). The partials meta data of a sparse partial
+         * then has the shape {nnz} and gradient calls return only its
+         * non-zeros; use SparsityPattern::Densify to expand them.
+         *
+         * @return const PartialsSparsity&
+         */
+        const PartialsSparsity &GetPartialsSparsity() const noexcept { return partials_sparsity_; }
+
         /**
          * @brief Set the RPC timeout for all client operations
          *
@@ -206,7 +419,410 @@ namespace philote
          */
         std::chrono::milliseconds GetRPCTimeout() const noexcept { return rpc_timeout_; }
 
+        /**
+         * @brief Sets the retries of compute calls rejected by an overloaded server
+         *
+         * Only calls the server rejected with a retry-after hint (see
+         * AdmissionLimits) are repeated; other RESOURCE_EXHAUSTED errors
+         * (e.g., messages exceeding the size limit) fail immediately.
+         *
+         * @param policy backoff policy
+         * @throws std::invalid_argument if the delays are negative or the
+         * multiplier is less than one
+         */
+        void SetBackoff(const BackoffPolicy &policy);
+
+        /**
+         * @brief Returns the retries of rejected compute calls
+         *
+         * @return const BackoffPolicy& policy set by SetBackoff
+         */
+        const BackoffPolicy &GetBackoff() const noexcept { return backoff_; }
+
+        /**
+         * @brief Emits a client span for every RPC of this client
+         *
+         * The span context is sent to the server in the traceparent
+         * metadata, so server spans become its children.
+         *
+         * @param tracer thread-safe tracer (nullptr disables client spans)
+         */
+        void SetTracer(std::shared_ptr<Tracer> tracer) { tracer_ = std::move(tracer); }
+
+        /**
+         * @brief Sets the parent span of subsequent RPCs
+         *
+         * E.g., the span of an optimizer iteration, so that all calls of the
+         * iteration (on all disciplines) form a single trace. Without a
+         * tracer, the parent itself is propagated to the server.
+         *
+         * @param parent parent span (an invalid context removes the parent)
+         */
+        void SetTraceParent(const TraceContext &parent) { trace_parent_ = parent; }
+
+        /**
+         * @brief Exchanges variable values through shared memory with co-located servers
+         *
+         * Takes effect if the server runs on the same host and supports the
+         * shared-memory extension (as reported by GetInfo). Compute calls then
+         * only send control messages over gRPC. Asynchronous and batched calls
+         * always use gRPC.
+         *
+         * @param enable whether to use shared memory
+         */
+        void EnableSharedMemory(bool enable = true) { shared_memory_ = enable; }
+
+        /**
+         * @brief Checks whether compute calls exchange values through shared memory
+         *
+         * @return true if enabled, supported by the server, and the server runs on this host
+         */
+        bool UsesSharedMemory() const;
+
+        /**
+         * @brief Sets the precision of the variable values exchanged with the server
+         *
+         * With WirePrecision::kFloat32, compute calls send their inputs and
+         * request their results as float32 values, halving the bytes on the
+         * wire at the cost of all but about seven significant digits. Takes
+         * effect if the server supports the wire-precision extension (as
+         * reported by GetInfo). Values exchanged through shared memory keep
+         * double precision. Changing the precision invalidates cached results.
+         * Discrete variables are always sent as integers.
+         *
+         * @param precision precision of the values in the stream messages
+         * @throws std::invalid_argument for WirePrecision::kInteger
+         */
+        void SetWirePrecision(WirePrecision precision);
+
+        /**
+         * @brief Returns the configured precision of the variable values
+         *
+         * @return WirePrecision precision set by SetWirePrecision
+         */
+        WirePrecision GetWirePrecision() const noexcept { return wire_precision_; }
+
+        /**
+         * @brief Sets the compression of the stream messages of compute calls
+         *
+         * Messages with at least policy.min_values values are compressed with
+         * policy.algorithm (e.g., GRPC_COMPRESS_GZIP) in both directions:
+         * the client compresses its inputs, and servers supporting the
+         * compression extension (as reported by GetInfo) compress their
+         * results. Smooth or mostly constant fields compress well, which
+         * pays off on slow links; on fast local links, compression usually
+         * costs more time than it saves.
+         *
+         * @param policy compression policy (the default disables compression)
+         */
+        void SetCompression(const CompressionPolicy &policy);
+
+        /**
+         * @brief Returns the compression policy of the compute calls
+         *
+         * @return const CompressionPolicy& policy set by SetCompression
+         */
+        const CompressionPolicy &GetCompression() const noexcept { return compression_; }
+
+        /**
+         * @brief Stores large results of compute calls in memory-mapped files
+         *
+         * Outputs and partials with at least storage.min_size values are
+         * allocated in anonymous files in the directory, and the received
+         * chunks are paged out once they are written, so results larger than
+         * the available memory can be received.
+         *
+         * @param storage placement of the results (an empty directory keeps
+         * them in memory, the default)
+         */
+        void SetFileStorage(const FileStorage &storage) { file_storage_ = storage; }
+
+        /**
+         * @brief Returns the placement of the results of compute calls
+         *
+         * @return const FileStorage& placement set by SetFileStorage
+         */
+        const FileStorage &GetFileStorage() const noexcept { return file_storage_; }
+
+        /**
+         * @brief Enables input sessions for blocking compute calls
+         *
+         * With input sessions, the server keeps the inputs of the previous
+         * call and the client only sends the chunks of the inputs that
+         * changed since then. This pays off for optimizers and solvers that
+         * only update a few variables per iteration. Requires a server
+         * supporting the input-sessions extension (as reported by GetInfo);
+         * calls using shared memory always exchange all values. If the
+         * server no longer holds the previous inputs (e.g., after a restart
+         * or eviction), the call is repeated with all inputs.
+         *
+         * @param enable whether to use input sessions
+         */
+        void EnableInputSession(bool enable = true);
+
+        /**
+         * @brief Checks whether compute calls use input sessions
+         *
+         * @return true if enabled and supported by the server
+         */
+        bool UsesInputSession() const;
+
+        /**
+         * @brief Enables evaluation streams for blocking compute calls (default: disabled)
+         *
+         * With evaluation streams, successive blocking calls of the same RPC
+         * share one gRPC stream instead of opening a stream per call, which
+         * saves the stream setup for short evaluations. Requires a server
+         * supporting the evaluation-streams extension (as reported by
+         * GetInfo); calls using shared memory or input sessions open a
+         * stream per call. An idle stream stays open until the next call or
+         * the destruction of the client, and is replaced once it would
+         * expire within the RPC timeout (streams last twice the timeout).
+         * On synchronous servers, an open stream occupies a server thread,
+         * also while it is idle.
+         *
+         * @param enable whether to use evaluation streams
+         */
+        void EnableEvaluationStreams(bool enable = true) { evaluation_streams_ = enable; }
+
+        /**
+         * @brief Checks whether blocking compute calls use evaluation streams
+         *
+         * @return true if enabled, supported by the server, and not replaced
+         * by shared memory or input sessions
+         */
+        bool UsesEvaluationStreams() const;
+
+        /**
+         * @brief Keeps a server running for the lifetime of the client
+         *
+         * Used for servers in the same process (see
+         * ExplicitDiscipline::ServeInProcess), which shut down once the last
+         * client connected to them is destroyed.
+         *
+         * @param server server the client is connected to
+         */
+        void OwnServer(std::shared_ptr<grpc::Server> server) { server_ = std::move(server); }
+
+    protected:
+        /**
+         * @brief Requests sparse partials for a gradient call
+         *
+         * Adds the client metadata if the partials meta data was obtained in
+         * sparse form, so the server sends matching partials.
+         *
+         * @param context client context of the gradient call
+         */
+        void AddPartialsMetadata(grpc::ClientContext &context) const;
+
+        /**
+         * @brief Returns the precision of the values sent by the compute calls
+         *
+         * The calls request their results in the same precision, so it is
+         * also the precision in which results are accepted.
+         *
+         * @return WirePrecision the configured precision if the server
+         * supports it, WirePrecision::kDouble otherwise
+         */
+        WirePrecision SendPrecision() const noexcept;
+
+        /**
+         * @brief Returns the precision of the values of a variable sent by the compute calls
+         *
+         * @param name variable name
+         * @return WirePrecision WirePrecision::kInteger for discrete variables,
+         * SendPrecision() otherwise
+         */
+        WirePrecision SendPrecision(const std::string &name) const;
+
+        /**
+         * @brief Requests the configured precision for the results of a compute call
+         *
+         * Also requests integer-encoded values of the discrete variables.
+         *
+         * @param context client context of the call (before the call starts)
+         */
+        void AddWirePrecisionMetadata(grpc::ClientContext &context) const;
+
+        /**
+         * @brief Allocates the result variable of a compute call
+         *
+         * @param meta variable meta data
+         * @return Variable discrete variable for discrete variables, otherwise
+         * a variable placed according to GetFileStorage()
+         */
+        Variable AllocateResult(const VariableMetaData &meta) const;
+
+        /**
+         * @brief Applies the compression policy to a compute call
+         *
+         * Sets the compression algorithm of the client messages and requests
+         * compressed results from servers that support it.
+         *
+         * @param context client context of the call (before the call starts)
+         */
+        void ApplyCompression(grpc::ClientContext &context) const;
+
+        /**
+         * @brief Checks whether a call should stream its variables through a pipeline
+         *
+         * @param vars variables sent by the call
+         * @return true if their total size reaches the pipeline threshold
+         */
+        bool PipelineSends(const Variables &vars) const noexcept;
+
+        /**
+         * @brief Returns a counter that changes whenever the remote configuration may change
+         *
+         * Advanced by ConnectChannel, SendOptions, Setup, GetVariableDefinitions,
+         * GetPartialDefinitions, SetWirePrecision, and SetCompression. Used to
+         * key cached results and to replace evaluation streams.
+         */
+        uint64_t ResultGeneration() const noexcept { return result_generation_; }
+
+        /**
+         * @brief Starts the span of an RPC
+         *
+         * @param rpc RPC name
+         * @param context client context of the RPC (before the call starts)
+         * @return ClientCallSpan span to finish with the status of the call
+         */
+        ClientCallSpan TraceCall(const std::string &rpc, grpc::ClientContext &context) const;
+
+        /**
+         * @brief Starts the span of an evaluation of an evaluation stream
+         *
+         * The trace context is not propagated, since the server serves all
+         * evaluations of the stream with the metadata sent when it opened.
+         *
+         * @param rpc RPC name
+         * @return ClientCallSpan span of the evaluation
+         */
+        ClientCallSpan TraceCall(const std::string &rpc) const;
+
+        /**
+         * @brief Prepares the shared memory transfer of a compute call
+         *
+         * Adds the segment name to the client metadata if the call should
+         * exchange its values through shared memory. The segment is sized
+         * for all variables and partials and reused by subsequent calls.
+         *
+         * @param context client context of the call (before the call starts)
+         * @return SharedMemoryTransfer transfer without a segment if the values
+         * travel in the messages
+         */
+        SharedMemoryTransfer AcquireSharedMemory(grpc::ClientContext &context);
+
+        /**
+         * @brief Sends a variable of a compute call
+         *
+         * @param name variable name
+         * @param var variable
+         * @param shared shared memory transfer of the call
+         * @param pipeline pipeline writing the messages
+         */
+        void SendVariable(const std::string &name, const Variable &var, SharedMemoryTransfer &shared,
+                          ChunkPipeline *pipeline, const InputSession *session = nullptr) const;
+
+        /**
+         * @brief Starts the input session of a compute call
+         *
+         * @param context client context of the call (before the call starts)
+         * @param shared shared memory transfer of the call
+         * @return InputSession* session staging the inputs, or nullptr if
+         * the call sends all inputs
+         */
+        InputSession *BeginInputSession(grpc::ClientContext &context, const SharedMemoryTransfer &shared);
+
+        /**
+         * @brief Completes the input session of a compute call
+         *
+         * @param session session returned by BeginInputSession (may be nullptr)
+         * @param status status of the call
+         * @return true if the server no longer held the previous inputs, so
+         * the call has to be repeated (with all inputs)
+         */
+        bool EndInputSession(InputSession *session, const grpc::Status &status);
+
+        /**
+         * @brief Declares the size of the inputs of a compute call
+         *
+         * Lets servers with admission control reserve the buffered input
+         * bytes of the call before reading them.
+         *
+         * @param context client context of the call (before the call starts)
+         * @param vars variables sent by the call
+         */
+        void AddInputBytesMetadata(grpc::ClientContext &context, const Variables &vars) const;
+
+        /**
+         * @brief Counts the retries of a call rejected by an overloaded server
+         *
+         * Every call that may back off holds a scope for its duration. A
+         * call repeated by the call (on the same thread and client)
+         * continues its count, while every new call starts at zero, no
+         * matter how earlier calls ended.
+         */
+        class BackoffScope
+        {
+        public:
+            /**
+             * @brief Starts counting the retries of a call
+             *
+             * @param client client making the call
+             */
+            explicit BackoffScope(const DisciplineClient &client);
+
+            //! Ends the call
+            ~BackoffScope();
+
+            BackoffScope(const BackoffScope &) = delete;
+            BackoffScope &operator=(const BackoffScope &) = delete;
+
+        private:
+            friend class DisciplineClient;
+
+            //! client making the call
+            const DisciplineClient *client_;
+
+            //! scope that was current when this one started
+            BackoffScope *outer_;
+
+            //! scope holding the count (the outermost scope of the call)
+            BackoffScope *counter_;
+
+            //! retries of the call
+            size_t attempts_ = 0;
+
+            //! innermost scope of the calling thread
+            static thread_local BackoffScope *current_;
+        };
+
+        /**
+         * @brief Waits before repeating a call rejected by an overloaded server
+         *
+         * Counts the retries in the current BackoffScope of the client
+         * (calls without a scope are not repeated).
+         *
+         * @param status status of the call
+         * @param retry_after retry-after hint sent with the status (0 if none)
+         * @return true if the call should be repeated
+         */
+        bool BackOff(const grpc::Status &status, std::chrono::milliseconds retry_after);
+
+        /**
+         * @brief Waits before repeating a call rejected by an overloaded server
+         *
+         * @param status status of the call
+         * @param context client context of the finished call
+         * @return true if the call should be repeated
+         */
+        bool BackOff(const grpc::Status &status, const grpc::ClientContext &context);
+
     private:
+        //! Server owned by the client (destroyed after the stubs)
+        std::shared_ptr<grpc::Server> server_;
+
         //! gRPC stub
         std::unique_ptr<philote::DisciplineService::StubInterface> stub_;
 
@@ -219,10 +835,88 @@ namespace philote
         //! Variable meta data
         std::vector<philote::VariableMetaData> var_meta_;
 
+        //! Name index of the variable meta data
+        philote::VariableMetaIndex var_index_;
+
         //! Partials meta data
         std::vector<philote::PartialsMetaData> partials_meta_;
 
+        //! Sparsity patterns of the sparse partials
+        philote::PartialsSparsity partials_sparsity_;
+
+        //! Whether the partials meta data was requested in sparse form
+        bool sparse_partials_ = false;
+
+        //! Names of the discrete variables (if the server supports them)
+        std::set<std::string> discrete_variables_;
+
+        //! Protocol extensions advertised by the server
+        std::set<std::string> server_features_;
+
+        //! Whether GetInfo negotiates the stream chunk size
+        bool negotiate_chunk_size_ = true;
+
+        //! Maximum message size of the channel in bytes
+        size_t max_message_bytes_ = kDefaultMaxMessageBytes;
+
+        //! Total number of values from which calls use a chunk pipeline
+        size_t pipeline_threshold_ = kDefaultPipelineThreshold;
+
+        //! Configuration generation for cached results
+        uint64_t result_generation_ = 0;
+
         //! RPC timeout in milliseconds (default: 60 seconds)
         std::chrono::milliseconds rpc_timeout_{60000};
+
+        //! Tracer of the client RPCs
+        std::shared_ptr<Tracer> tracer_;
+
+        //! Parent span of the client RPCs
+        TraceContext trace_parent_;
+
+        //! Whether compute calls may use shared memory
+        bool shared_memory_ = false;
+
+        //! Host id advertised by the server
+        std::string server_host_id_;
+
+        //! Shared memory segment of the compute calls
+        std::shared_ptr<SharedMemorySegment> shared_segment_;
+
+        //! Precision of the values in the stream messages
+        WirePrecision wire_precision_ = WirePrecision::kDouble;
+
+        //! Compression of the stream messages
+        CompressionPolicy compression_;
+
+        //! Placement of the results of compute calls
+        FileStorage file_storage_;
+
+        //! Input session of the compute calls (nullptr if disabled)
+        std::unique_ptr<InputSession> input_session_;
+
+        //! Configuration generation of the input session
+        uint64_t input_session_generation_ = 0;
+
+        //! Whether blocking compute calls may use evaluation streams
+        bool evaluation_streams_ = false;
+
+        //! Cache of the variable and partial definitions (nullptr if disabled)
+        std::shared_ptr<DefinitionCache> definition_cache_;
+
+        //! Definitions hash returned by Setup
+        std::string definitions_hash_;
+
+        //! Options generation reported by the last SendOptions
+        uint64_t options_generation_ = 0;
+
+        //! Whether the meta data is still valid after the last SendOptions
+        bool definitions_current_ = false;
+
+        //! Whether the partials definitions have been fetched
+        bool partials_defined_ = false;
+
+        //! Retries of calls rejected by an overloaded server
+        BackoffPolicy backoff_;
     };
 } // namespace philote
\ No newline at end of file
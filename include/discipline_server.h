@@ -167,5 +167,11 @@ namespace philote
     private:
         //! Shared pointer to the discipline implementation
         std::shared_ptr<philote::Discipline> discipline_;
+
+        //! Whether Setup has been run since the discipline was linked
+        bool set_up_ = false;
+
+        //! Layout generation of the discipline after the last Setup
+        uint64_t setup_layout_generation_ = 0;
     };
 } // namespace philote
\ No newline at end of file
@@ -0,0 +1,345 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/sync_stream.h>
+
+#include <data.pb.h>
+#include <protocol_extensions.h>
+
+namespace philote
+{
+    /**
+     * @brief Creates the message that ends an evaluation of an evaluation stream
+     *
+     * The message has an empty name, start kEndOfEvaluationMarker, and the
+     * evaluation id as end. It carries no values.
+     *
+     * @param id evaluation id
+     * @return Array end of evaluation message
+     */
+    Array EndOfEvaluation(uint64_t id);
+
+    /**
+     * @brief Checks whether a message ends an evaluation of an evaluation stream
+     *
+     * @param array stream message
+     * @return true if the message was created by EndOfEvaluation
+     */
+    bool IsEndOfEvaluation(const Array &array) noexcept;
+
+    /**
+     * @brief Checks whether the client of a compute RPC requested an evaluation stream
+     *
+     * @param context server context of the RPC (may be nullptr)
+     * @return true if the client metadata requests an evaluation stream
+     */
+    bool RequestsEvaluationStream(const grpc::ServerContextBase *context);
+
+    /**
+     * @brief Server stream of one evaluation of an evaluation stream
+     *
+     * Reads the messages of the wrapped stream until the end of the
+     * evaluation, so the logic of a compute RPC can run once per evaluation.
+     * Writes are forwarded.
+     */
+    class EvaluationFrameStream : public grpc::ServerReaderWriterInterface<Array, Array>
+    {
+    public:
+        using grpc::internal::WriterInterface<Array>::Write;
+
+        /**
+         * @brief Wraps a stream
+         *
+         * @param stream stream of the RPC
+         */
+        explicit EvaluationFrameStream(grpc::ServerReaderWriterInterface<Array, Array> *stream);
+
+        /**
+         * @brief Waits for the first message of the next evaluation
+         *
+         * @return false if the client closed the stream instead
+         */
+        bool Start();
+
+        /**
+         * @brief Reads the remaining messages of the evaluation
+         *
+         * @return true if the evaluation was ended by an end of evaluation
+         * message (false if the client closed the stream)
+         */
+        bool Skip();
+
+        /**
+         * @brief Returns the id of the evaluation
+         *
+         * @return uint64_t id sent with the end of the evaluation (0 before)
+         */
+        uint64_t id() const noexcept { return id_; }
+
+        void SendInitialMetadata() override;
+
+        bool Write(const Array &msg, grpc::WriteOptions options) override;
+
+        bool NextMessageSize(uint32_t *sz) override;
+
+        bool Read(Array *msg) override;
+
+    private:
+        //! wrapped stream
+        grpc::ServerReaderWriterInterface<Array, Array> *stream_;
+
+        //! first message of the evaluation (read by Start)
+        Array first_;
+
+        //! whether first_ has not been returned by Read yet
+        bool has_first_ = false;
+
+        //! whether the end of the evaluation was read
+        bool ended_ = false;
+
+        //! whether the wrapped stream has no more messages
+        bool closed_ = false;
+
+        //! evaluation id
+        uint64_t id_ = 0;
+    };
+
+    /**
+     * @brief Runs the logic of a compute RPC once per evaluation of an evaluation stream
+     *
+     * Without the client metadata requesting an evaluation stream, the
+     * handler is called once with the original stream. Otherwise, the
+     * handler is called with an EvaluationFrameStream for every evaluation
+     * the client sends, and the results of each evaluation are followed by
+     * an end of evaluation message. The first evaluation that fails ends
+     * the RPC with its status.
+     *
+     * @param context server context of the RPC
+     * @param stream stream of the RPC
+     * @param handler RPC logic, callable with StreamType* and EvaluationFrameStream*
+     * @return grpc::Status OK once the client closed the stream, or the
+     * status of the failed evaluation
+     */
+    template <typename StreamType, typename Handler>
+    grpc::Status ServeEvaluations(grpc::ServerContextBase *context, StreamType *stream, Handler &&handler)
+    {
+        if (stream == nullptr or !RequestsEvaluationStream(context))
+            return handler(stream);
+
+        while (true)
+        {
+            EvaluationFrameStream frame(stream);
+            if (!frame.Start())
+                return grpc::Status::OK;
+
+            grpc::Status status = handler(&frame);
+            if (!status.ok() or !frame.Skip())
+                return status;
+
+            if (!stream->Write(EndOfEvaluation(frame.id())))
+                return grpc::Status(grpc::StatusCode::CANCELLED, "Failed to end evaluation " +
+                                                                     std::to_string(frame.id()));
+        }
+    }
+
+    /**
+     * @brief Client side of the stream of a compute RPC
+     *
+     * Either carries a single evaluation (the inputs end with WritesDone)
+     * or, for servers supporting evaluation streams, stays open for
+     * subsequent evaluations (the inputs end with an end of evaluation
+     * message). For example:
+     *
+     * @code
+     *     if (call.Reusable(generation, timeout))
+     *         call.Begin();
+     *     else
+     *         call.Open(std::move(context), stub->ComputeFunction(context.get()), true, generation);
+     *     // write the inputs to call.stream()
+     *     call.EndInputs();
+     *     while (call.Read(&result))
+     *         ...
+     *     grpc::Status status = call.Finish();
+     * @endcode
+     *
+     * @note Thread Safety: This class is NOT thread-safe.
+     */
+    class EvaluationStream
+    {
+    public:
+        //! stream type of the compute RPCs
+        using Stream = grpc::ClientReaderWriterInterface<Array, Array>;
+
+        EvaluationStream() = default;
+
+        //! Closes the stream
+        ~EvaluationStream() noexcept;
+
+        EvaluationStream(const EvaluationStream &) = delete;
+        EvaluationStream &operator=(const EvaluationStream &) = delete;
+
+        /**
+         * @brief Checks whether the open stream can carry another evaluation
+         *
+         * @param generation configuration generation of the client
+         * @param timeout time the evaluation may take
+         * @return true if the stream is persistent, idle, was opened with
+         * the same generation, and does not expire within the timeout
+         */
+        bool Reusable(uint64_t generation, std::chrono::milliseconds timeout) const;
+
+        /**
+         * @brief Starts another evaluation on the open stream
+         */
+        void Begin() noexcept { active_ = true; }
+
+        /**
+         * @brief Opens a stream (closing the previous one)
+         *
+         * @param context client context the stream was started with
+         * @param stream stream of the compute RPC
+         * @param persistent whether the stream carries several evaluations
+         * (requested with kEvaluationStreamMetadataKey)
+         * @param generation configuration generation of the client
+         */
+        void Open(std::unique_ptr<grpc::ClientContext> context, std::unique_ptr<Stream> stream,
+                  bool persistent, uint64_t generation);
+
+        /**
+         * @brief Returns the stream of the current evaluation
+         *
+         * @return Stream* stream (nullptr if not open)
+         */
+        Stream *stream() noexcept { return stream_.get(); }
+
+        /**
+         * @brief Checks whether earlier evaluations used the stream
+         *
+         * @return true if the stream was reused
+         */
+        bool reused() const noexcept { return evaluations_ > 0; }
+
+        /**
+         * @brief Ends the inputs of the current evaluation
+         *
+         * @return false if the stream failed
+         */
+        bool EndInputs();
+
+        /**
+         * @brief Reads a result message of the current evaluation
+         *
+         * @param message received message
+         * @return false at the end of the evaluation
+         */
+        bool Read(Array *message);
+
+        /**
+         * @brief Completes the current evaluation
+         *
+         * Persistent streams stay open if the evaluation succeeded; all other
+         * streams are finished and closed.
+         *
+         * @return grpc::Status status of the evaluation
+         */
+        grpc::Status Finish();
+
+        /**
+         * @brief Finishes a stream whose writes failed and closes it
+         *
+         * Unlike Cancel, the status the server ended the RPC with is
+         * retrieved (e.g., an admission control rejection).
+         *
+         * @return grpc::Status status of the RPC
+         */
+        grpc::Status Fail();
+
+        /**
+         * @brief Returns the retry-after hint of the last finished RPC
+         *
+         * @return std::chrono::milliseconds delay the server asked for when
+         * it rejected the RPC under load (0 if none)
+         */
+        std::chrono::milliseconds retry_after() const noexcept { return retry_after_; }
+
+        /**
+         * @brief Cancels the current evaluation (if any) and closes the stream
+         */
+        void Cancel() noexcept;
+
+        /**
+         * @brief Closes the stream
+         *
+         * The RPC is cancelled, so that closing does not wait for the
+         * server (an abandoned evaluation is cancelled as well).
+         */
+        void Close() noexcept;
+
+    private:
+        //! client context of the stream
+        std::unique_ptr<grpc::ClientContext> context_;
+
+        //! stream of the compute RPC
+        std::unique_ptr<Stream> stream_;
+
+        //! whether the stream carries several evaluations
+        bool persistent_ = false;
+
+        //! configuration generation the stream was opened with
+        uint64_t generation_ = 0;
+
+        //! number of completed evaluations
+        uint64_t evaluations_ = 0;
+
+        //! whether an evaluation is in progress
+        bool active_ = false;
+
+        //! whether the end of the current evaluation was read
+        bool ended_ = false;
+
+        //! retry-after hint of the last finished RPC
+        std::chrono::milliseconds retry_after_{0};
+
+        /**
+         * @brief Finishes the RPC and closes the stream
+         *
+         * @return grpc::Status status of the RPC
+         */
+        grpc::Status FinishRPC();
+    };
+}
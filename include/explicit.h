@@ -30,12 +30,28 @@
 */
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <string>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include <async_call.h>
+#include <callback_server.h>
+#include <compression.h>
 #include <discipline.h>
+#include <evaluation_stream.h>
+#include <finite_difference.h>
+#include <input_session.h>
+#include <instance_pool.h>
+#include <local_transport.h>
+#include <output_writer.h>
+#include <parallel_assembly.h>
+#include <protocol_extensions.h>
+#include <shared_memory.h>
 #include <variable.h>
 #include "discipline_client.h"
 
@@ -46,6 +62,7 @@ namespace philote
 {
     // forward declaration
     class ExplicitDiscipline;
+    class ExplicitClient;
 
     /**
      * @brief Server base class for an explicit discipline.
@@ -82,6 +99,47 @@ namespace philote
          */
         void UnlinkPointers();
 
+        /**
+         * @brief Serves each RPC with its own instance from a pool
+         *
+         * @param pool instance pool (nullptr to use the linked discipline for
+         * all RPCs)
+         */
+        void SetInstancePool(std::shared_ptr<InstancePool<philote::ExplicitDiscipline>> pool);
+
+        /**
+         * @brief Places the pooled instances on cores or NUMA nodes
+         *
+         * @param placement placement of the instances
+         * @throws std::invalid_argument if instances are to be placed but no
+         * instance pool is set
+         */
+        void SetPlacement(const ThreadPlacement &placement);
+
+        /**
+         * @brief Returns the metrics recorder of the linked discipline
+         *
+         * @return MetricsRecorder* nullptr if no discipline is linked or the
+         * discipline has no recorder
+         */
+        MetricsRecorder *metrics_recorder() const noexcept;
+
+        /**
+         * @brief Returns the tracer of the linked discipline
+         *
+         * @return Tracer* nullptr if no discipline is linked or the
+         * discipline has no tracer
+         */
+        Tracer *tracer() const noexcept;
+
+        /**
+         * @brief Returns the admission controller of the linked discipline
+         *
+         * @return AdmissionController* nullptr if no discipline is linked or
+         * the discipline has no admission limits
+         */
+        AdmissionController *admission_controller() const noexcept;
+
         /**
          * @brief RPC that computes initiates function evaluation
          *
@@ -106,10 +164,18 @@ namespace philote
 
         // Test helper methods that accept interface pointers for unit testing with mocks
         template<typename StreamType>
-        grpc::Status ComputeFunctionImpl(grpc::ServerContext *context, StreamType *stream);
+        grpc::Status ComputeFunctionImpl(grpc::ServerContextBase *context, StreamType *stream);
+
+        template<typename StreamType>
+        grpc::Status ComputeGradientImpl(grpc::ServerContextBase *context, StreamType *stream);
+
+        template<typename StreamType>
+        grpc::Status ComputeFunctionBatchImpl(grpc::ServerContextBase *context, StreamType *stream,
+                                              size_t batch_size);
 
         template<typename StreamType>
-        grpc::Status ComputeGradientImpl(grpc::ServerContext *context, StreamType *stream);
+        grpc::Status ComputeJacobianProductImpl(grpc::ServerContextBase *context, StreamType *stream,
+                                                bool reverse);
 
         // Public wrappers for tests
         grpc::Status ComputeFunctionForTesting(grpc::ServerContext *context,
@@ -125,8 +191,111 @@ namespace philote
         }
 
     private:
+        /**
+         * @brief Obtains the discipline instance for an RPC
+         *
+         * Returns a pooled instance if an instance pool is set and the linked
+         * discipline otherwise. Waiting for a pooled instance ends with the
+         * deadline or the cancellation of the call.
+         *
+         * @param context server context of the call (may be nullptr)
+         * @param lease receives the instance
+         * @return grpc::Status DEADLINE_EXCEEDED or CANCELLED if the call
+         * ended while waiting, INTERNAL if the instance could not be created
+         */
+        grpc::Status AcquireInstance(grpc::ServerContextBase *context,
+                                     InstancePool<philote::ExplicitDiscipline>::Lease &lease);
+
+        /**
+         * @brief Sends partials to the client
+         *
+         * Sparse partials are expanded for clients that did not request
+         * sparse partials.
+         */
+        template<typename StreamType>
+        grpc::Status SendPartials(grpc::ServerContextBase *context, StreamType *stream,
+                                  const Discipline *discipline, const Partials &partials,
+                                  SharedMemoryTransfer &shared);
+
+        /**
+         * @brief Sends one partial to the client (see SendPartials)
+         */
+        template<typename StreamType>
+        grpc::Status SendPartial(grpc::ServerContextBase *context, StreamType *stream,
+                                 const Discipline *discipline, const std::string &of,
+                                 const std::string &wrt, const Variable &value,
+                                 SharedMemoryTransfer &shared);
+
         //! Shared pointer to the implementation of the explicit discipline
         std::shared_ptr<philote::ExplicitDiscipline> implementation_;
+
+        //! Optional pool of instances serving concurrent RPCs
+        std::shared_ptr<InstancePool<philote::ExplicitDiscipline>> pool_;
+
+        //! Shared memory segments of co-located clients
+        SharedMemoryCache shared_memory_;
+
+        //! Inputs of the previous call of each input session
+        InputSessionCache input_sessions_;
+    };
+
+    /**
+     * @brief Explicit server based on the gRPC callback API
+     *
+     * Alternative to ExplicitServer for servers with many concurrent
+     * clients. Streams are read and written asynchronously, so slow clients
+     * do not occupy a thread. Once a client has sent all inputs, the
+     * evaluation runs the same logic as ExplicitServer (including batched
+     * evaluations and instance pools) on a fixed-size compute thread pool.
+     */
+    class ExplicitCallbackServer : public ExplicitService::CallbackService
+    {
+    public:
+        //! Constructor
+        ExplicitCallbackServer() = default;
+
+        //! Destructor
+        ~ExplicitCallbackServer() noexcept;
+
+        /**
+         * @brief Links the server logic and starts the compute threads
+         *
+         * @param server explicit server providing the RPC logic (must outlive
+         * this object)
+         * @param threads number of compute threads (0 uses the number of
+         * hardware threads)
+         */
+        void LinkPointers(philote::ExplicitServer *server, size_t threads = 0);
+
+        /**
+         * @brief Unlinks the server logic
+         */
+        void UnlinkPointers();
+
+        /**
+         * @brief RPC that computes initiates function evaluation
+         *
+         * @param context
+         * @return grpc::ServerBidiReactor<::philote::Array, ::philote::Array>*
+         */
+        grpc::ServerBidiReactor<::philote::Array, ::philote::Array> *ComputeFunction(
+            grpc::CallbackServerContext *context) override;
+
+        /**
+         * @brief RPC that computes initiates gradient evaluation
+         *
+         * @param context
+         * @return grpc::ServerBidiReactor<::philote::Array, ::philote::Array>*
+         */
+        grpc::ServerBidiReactor<::philote::Array, ::philote::Array> *ComputeGradient(
+            grpc::CallbackServerContext *context) override;
+
+    private:
+        //! Server providing the RPC logic
+        philote::ExplicitServer *server_ = nullptr;
+
+        //! Threads running the evaluations
+        std::unique_ptr<ThreadPool> executor_;
     };
 
     /**
@@ -279,6 +448,93 @@ namespace philote
          */
         void RegisterServices(grpc::ServerBuilder &builder);
 
+        /**
+         * @brief Registers all services with a gRPC channel
+         *
+         * With ServerEngine::kCallback, the compute RPCs are served by an
+         * ExplicitCallbackServer, so open streams do not occupy threads and
+         * at most compute_threads evaluations run at the same time. Use
+         * EnableInstancePool to give concurrent evaluations their own
+         * discipline instances. The (short) metadata and configuration RPCs
+         * are always served synchronously.
+         *
+         * On multi-socket machines, the placement pins the instances of the
+         * instance pool to cores or NUMA nodes (see ThreadPlacement), so that
+         * every call computes on the node holding the buffers of its
+         * instance.
+         *
+         * @param builder
+         * @param engine server implementation of the compute RPCs
+         * @param compute_threads number of compute threads for the callback
+         * engine (0 uses the number of hardware threads)
+         * @param placement placement of the pooled instances (requires
+         * EnableInstancePool unless the policy is PlacementPolicy::kNone)
+         * @throws std::invalid_argument if instances are to be placed without
+         * an instance pool
+         */
+        void RegisterServices(grpc::ServerBuilder &builder, ServerEngine engine,
+                              size_t compute_threads = 0, const ThreadPlacement &placement = ThreadPlacement());
+
+        /**
+         * @brief Serves concurrent compute RPCs with separate discipline instances
+         *
+         * Without an instance pool, all RPCs share this discipline instance.
+         * With a pool, every ComputeFunction and ComputeGradient call obtains
+         * its own instance (created by the factory on demand), so concurrent
+         * calls do not share state. This instance still handles all
+         * configuration RPCs; pooled instances are configured to match it
+         * (options, stream options, and Setup) before they are used.
+         *
+         * @param factory function creating a new instance of the discipline
+         * @param size maximum number of instances (i.e., concurrent computations)
+         *
+         * @par Example
+         * @code
+         * auto discipline = std::make_shared<Paraboloid>();
+         * discipline->EnableInstancePool([]
+         *     { return std::make_shared<Paraboloid>(); },
+         *     std::thread::hardware_concurrency());
+         * discipline->RegisterServices(builder);
+         * @endcode
+         */
+        void EnableInstancePool(InstancePool<ExplicitDiscipline>::Factory factory, size_t size);
+
+        /**
+         * @brief Serves the discipline on a Unix domain socket
+         *
+         * Clients on the same host connect with
+         * CreateUnixSocketChannel(path), which bypasses the TCP stack.
+         *
+         * @param path file system path of the socket
+         * @param engine server implementation of the compute RPCs
+         * @param compute_threads number of compute threads for the callback
+         * engine (0 uses the number of hardware threads)
+         * @return std::shared_ptr<grpc::Server> running server
+         * @throws std::runtime_error if the server cannot be started
+         */
+        std::shared_ptr<grpc::Server> ServeUnixSocket(const std::string &path,
+                                                      ServerEngine engine = ServerEngine::kSynchronous,
+                                                      size_t compute_threads = 0);
+
+        /**
+         * @brief Serves the discipline within this process and connects a client
+         *
+         * The client uses an in-process channel, so calls bypass the network
+         * stack entirely (e.g., for disciplines embedded in a monolithic
+         * application, tests, and benchmarks). The client is initialized
+         * (GetInfo, Setup, GetVariableDefinitions, and GetPartialDefinitions)
+         * and keeps the server running until it is destroyed. A discipline
+         * can only be served by one server at a time.
+         *
+         * @param engine server implementation of the compute RPCs
+         * @param compute_threads number of compute threads for the callback
+         * engine (0 uses the number of hardware threads)
+         * @return std::unique_ptr<ExplicitClient> ready-to-use client
+         * @throws std::runtime_error if the server cannot be started
+         */
+        std::unique_ptr<ExplicitClient> ServeInProcess(ServerEngine engine = ServerEngine::kSynchronous,
+                                                       size_t compute_threads = 0);
+
         /**
          * @brief Function evaluation for the discipline.
          *
@@ -286,11 +542,60 @@ namespace philote
          * discipline.
          *
          * @param inputs input variables for the discipline (continuous and
-         * discrete)
+         * discrete; discrete inputs are held as doubles)
          * @return philote::Variables
          */
         virtual void Compute(const philote::Variables &inputs, philote::Variables &outputs);
 
+        /**
+         * @brief Function evaluation on contiguously stored variables.
+         *
+         * Called by ComputeStreaming (i.e., by the server for
+         * ComputeFunction). The default implementation calls Compute with
+         * the map views of the variables, so most disciplines only override
+         * Compute. Disciplines that prefer
+         * to work on the contiguous buffers may override this function and
+         * resolve the variable handles once, e.g., in Setup (the layout
+         * follows the order in which the variables were added).
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs preallocated output variables
+         */
+        virtual void ComputeFlat(const philote::FlatVariables &inputs, philote::FlatVariables &outputs);
+
+        /**
+         * @brief Function evaluation that can send outputs before it returns.
+         *
+         * Called by the server for ComputeFunction. The default
+         * implementation calls ComputeFlat. Disciplines that finish some
+         * outputs long before others (e.g., time-marching codes) may override
+         * this function and pass each finished output to
+         * OutputWriter::Finalize, so the client receives it right away.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs preallocated output variables
+         * @param writer sends finalized outputs to the client
+         */
+        virtual void ComputeStreaming(const philote::FlatVariables &inputs,
+                                      philote::FlatVariables &outputs,
+                                      philote::OutputWriter &writer);
+
+        /**
+         * @brief Function evaluation for a batch of design points.
+         *
+         * Called by the server for batched ComputeFunction calls (see
+         * ExplicitClient::ComputeFunctionBatch). The default implementation
+         * calls Compute for every design point. Disciplines that can evaluate
+         * many points at once (e.g., by vectorizing over the points) may
+         * override this function.
+         *
+         * @param inputs input variables for each design point
+         * @param outputs preallocated output variables for each design point
+         * (same length as inputs)
+         */
+        virtual void ComputeBatch(const std::vector<philote::Variables> &inputs,
+                                  std::vector<philote::Variables> &outputs);
+
         /**
          * @brief Gradient evaluation for the discipline.
          *
@@ -299,16 +604,290 @@ namespace philote
          * partials).
          *
          * @param inputs input variables for the discipline (continuous and
-         * discrete)
+         * discrete; discrete inputs are held as doubles)
          */
         virtual void ComputePartials(const philote::Variables &inputs,
                                      Partials &partials);
 
+        /**
+         * @brief Gradient evaluation of a single partial block.
+         *
+         * Called for every analytic partial declared in SetupPartials if
+         * block partials are enabled (see EnableBlockPartials). Blocks are computed
+         * concurrently, so this function must not modify state shared between
+         * blocks. The default implementation throws.
+         *
+         * @param of output (or residual) name
+         * @param wrt input name
+         * @param inputs input variables for the discipline
+         * @param block preallocated partial of of with respect to wrt
+         */
+        virtual void ComputePartial(const std::string &of, const std::string &wrt,
+                                    const philote::Variables &inputs, philote::Variable &block);
+
+        //! Receives every computed partial block (see ComputePartialBlocks)
+        using PartialBlockCallback = std::function<void(const std::string &of, const std::string &wrt,
+                                                        const philote::Variable &block)>;
+
+        /**
+         * @brief Computes the partials block by block on a worker pool
+         *
+         * Instead of ComputePartials, the server then calls ComputePartial
+         * once per partial block on a pool of worker threads and sends every
+         * block to the client as soon as it is finished. Call this in the
+         * constructor, so that pooled instances compute their blocks in
+         * parallel as well.
+         *
+         * @param threads number of worker threads (0 uses the number of
+         * hardware threads)
+         */
+        void EnableBlockPartials(size_t threads = 0);
+
+        /**
+         * @brief Checks whether the partials are computed block by block
+         */
+        bool block_partials() const noexcept { return block_pool_ != nullptr; }
+
+        /**
+         * @brief Computes all partial blocks with ComputePartial
+         *
+         * Called by the server and by the default ComputePartials if block
+         * partials are enabled. The callback runs on the calling thread, once
+         * per block in the order the blocks finish. Partials declared with a
+         * finite difference method are approximated after the other blocks.
+         * After an exception (of
+         * ComputePartial or the callback), the remaining blocks are skipped
+         * and the exception is rethrown once the running blocks finished.
+         *
+         * @param inputs input variables for the discipline
+         * @param partials preallocated partials
+         * @param finished called for every computed block (may be empty)
+         * @throws std::logic_error if block partials are not enabled
+         */
+        void ComputePartialBlocks(const philote::Variables &inputs, Partials &partials,
+                                  const PartialBlockCallback &finished = nullptr);
+
+        using Discipline::DeclarePartials;
+
+        /**
+         * @brief Declares a partial that is approximated by the framework
+         *
+         * Partials declared with a finite difference method are computed by
+         * ComputeApproximatePartials from evaluations of Compute, so the
+         * discipline does not implement them. Every input is perturbed by
+         * step (an absolute step size).
+         *
+         * @param f output variable
+         * @param x input variable
+         * @param method approximation method (kAnalytic declares a regular
+         * partial)
+         * @param step perturbation of the input values
+         * @throws std::invalid_argument if step is not positive
+         */
+        void DeclarePartials(const std::string &f, const std::string &x,
+                             PartialsMethod method, double step = 1e-6);
+
+        /**
+         * @brief Declares a sparse partial that is approximated by the framework
+         *
+         * Columns of x that share no non-zero row (across all approximated
+         * partials with respect to x) are perturbed together, so sparse
+         * Jacobians need far fewer evaluations than they have columns.
+         *
+         * @param f output variable
+         * @param x input variable
+         * @param rows flattened index into f of each non-zero
+         * @param cols flattened index into x of each non-zero
+         * @param method approximation method
+         * @param step perturbation of the input values
+         */
+        void DeclarePartials(const std::string &f, const std::string &x,
+                             const std::vector<int64_t> &rows,
+                             const std::vector<int64_t> &cols,
+                             PartialsMethod method, double step = 1e-6);
+
+        /**
+         * @brief Returns how a declared partial is computed
+         *
+         * @param f output variable
+         * @param x input variable
+         * @return PartialsMethod kAnalytic unless declared otherwise
+         */
+        PartialsMethod partials_method(const std::string &f, const std::string &x) const;
+
+        /**
+         * @brief Evaluates the finite difference perturbations on pooled instances
+         *
+         * Without pooled instances, the perturbations are evaluated one
+         * after another by this instance. With them, up to size instances
+         * (created by the factory and configured like this discipline)
+         * evaluate the perturbations concurrently. Enable this on the
+         * discipline registered with the server rather than in the
+         * constructor, since the factory creates further instances.
+         *
+         * @param factory function creating a new instance of the discipline
+         * @param size maximum number of concurrent evaluations
+         */
+        void EnableParallelFiniteDifferences(InstancePool<ExplicitDiscipline>::Factory factory, size_t size);
+
+        /**
+         * @brief Computes the partials declared with a finite difference method
+         *
+         * Called by the default ComputePartials. Disciplines that override
+         * ComputePartials for their analytic partials call this function from
+         * their override to fill the approximated ones. The values are written
+         * into the preallocated partials; other partials are not modified.
+         *
+         * @param inputs input variables for the discipline
+         * @param partials preallocated partials
+         */
+        void ComputeApproximatePartials(const philote::Variables &inputs, Partials &partials);
+
+        void ClearMetaData() override;
+
+        /**
+         * @brief Function and gradient evaluation in a single pass.
+         *
+         * Called by the server for ComputeFunction calls that also request
+         * the partials (see ExplicitClient::ComputeFunctionAndGradient).
+         * The default implementation calls ComputeFlat and then
+         * ComputePartials. Disciplines whose partials reuse intermediate
+         * results of the function evaluation may override this function to
+         * compute both at once.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs preallocated output variables
+         * @param partials preallocated partials
+         */
+        virtual void ComputeWithPartials(const philote::FlatVariables &inputs,
+                                         philote::FlatVariables &outputs,
+                                         Partials &partials);
+
+        /**
+         * @brief Jacobian-vector product of the discipline.
+         *
+         * Called by the server for ComputeGradient calls that request a
+         * forward product (see ExplicitClient::ComputeJacVec). The default
+         * implementation computes all partials and multiplies them with the
+         * seeds. Matrix-free disciplines (e.g., adjoint or automatic
+         * differentiation codes) may override this function to avoid forming
+         * the Jacobian.
+         *
+         * @param inputs input variables for the discipline
+         * @param seeds direction in the input space (missing inputs are zero)
+         * @param products preallocated products, one per output
+         */
+        virtual void ComputeJacVec(const philote::Variables &inputs,
+                                   const philote::Variables &seeds,
+                                   philote::Variables &products);
+
+        /**
+         * @brief Vector-Jacobian product of the discipline.
+         *
+         * Called by the server for ComputeGradient calls that request a
+         * reverse product (see ExplicitClient::ComputeVecJac). The default
+         * implementation computes all partials and multiplies their transpose
+         * with the seeds.
+         *
+         * @param inputs input variables for the discipline
+         * @param seeds weights of the outputs (missing outputs are zero)
+         * @param products preallocated products, one per input
+         */
+        virtual void ComputeVecJac(const philote::Variables &inputs,
+                                   const philote::Variables &seeds,
+                                   philote::Variables &products);
+
+        /**
+         * @brief Computes the partials along with every function evaluation
+         *
+         * With memoization, every ComputeFunction call also computes the
+         * partials and keeps those of the last evaluation of each discipline
+         * instance. A subsequent ComputeGradient call with bitwise identical
+         * inputs returns these partials without calling ComputePartials.
+         * The outputs are computed and streamed as usual (see
+         * ComputeStreaming), then ComputePartials runs before the call
+         * completes, so each function evaluation costs a gradient evaluation
+         * as well, even if the gradient is never requested. ComputeWithPartials
+         * is only used for fused requests. This suits optimizers that request
+         * the gradient at (nearly) every point at which they evaluate the
+         * function. Enable it on the discipline registered with the server;
+         * it applies to pooled instances as well.
+         *
+         * @param enable whether to memoize partials
+         */
+        void EnablePartialsMemoization(bool enable = true) noexcept { partials_memoization_ = enable; }
+
+        /**
+         * @brief Checks whether partials are memoized (see EnablePartialsMemoization)
+         */
+        bool partials_memoization() const noexcept { return partials_memoization_.load(); }
+
+        /**
+         * @brief Stores the partials of a function evaluation
+         *
+         * Called by the server. Replaces previously stored partials.
+         *
+         * @param inputs inputs of the evaluation
+         * @param partials partials at the inputs
+         */
+        void MemoizePartials(const philote::Variables &inputs, const Partials &partials);
+
+        /**
+         * @brief Retrieves memoized partials
+         *
+         * Called by the server.
+         *
+         * @param inputs inputs of the gradient evaluation
+         * @param partials receives the memoized partials on success
+         * @return true if partials were stored for bitwise identical inputs
+         * and the current configuration
+         */
+        bool RecallPartials(const philote::Variables &inputs, Partials &partials) const;
+
     private:
         //! Explicit discipline server
         philote::ExplicitServer explicit_;
+        //! Explicit discipline server for the callback engine
+        philote::ExplicitCallbackServer explicit_callback_;
         //! Discipline server
         philote::DisciplineServer discipline_server_;
+
+        //! workers computing the partial blocks (nullptr if disabled)
+        std::unique_ptr<ThreadPool> block_pool_;
+
+        //! approximation of the partials declared with a finite difference method
+        struct Approximation
+        {
+            PartialsMethod method;
+            double step;
+        };
+
+        //! partials approximated by finite differences
+        std::map<std::pair<std::string, std::string>, Approximation> approximations_;
+
+        //! instances evaluating the perturbations (nullptr if serial)
+        std::shared_ptr<InstancePool<ExplicitDiscipline>> fd_instances_;
+
+        //! workers driving the pooled instances (nullptr if serial)
+        std::unique_ptr<ThreadPool> fd_pool_;
+
+        //! whether ComputeFunction memoizes the partials
+        std::atomic<bool> partials_memoization_{false};
+
+        //! guards the memoized partials
+        mutable std::mutex memo_mutex_;
+
+        //! whether partials have been memoized
+        bool memo_valid_ = false;
+
+        //! configuration generation of the memoized partials
+        uint64_t memo_generation_ = 0;
+
+        //! inputs of the memoized partials
+        philote::Variables memo_inputs_;
+
+        //! memoized partials
+        Partials memo_partials_;
     };
 
     /**
@@ -441,6 +1020,54 @@ namespace philote
          */
         Variables ComputeFunction(const Variables &inputs);
 
+        /**
+         * @brief Receives the chunks of results as they arrive
+         *
+         * Called once per received chunk with the variable name, subname
+         * (the wrt variable of partials, empty for outputs), the index of
+         * the first value, and the values, which are only valid during the
+         * call.
+         */
+        using ChunkSink = std::function<void(const std::string &name, const std::string &subname,
+                                             size_t start, const double *values, size_t count)>;
+
+        /**
+         * @brief Evaluates the remote function, passing the outputs to a sink
+         *
+         * The outputs are handed to the sink chunk by chunk while they are
+         * received instead of being collected in a Variables map, so reducing
+         * them (e.g., computing norms or writing them to disk) takes memory
+         * in the order of one chunk. The results are not cached.
+         *
+         * @par Example
+         * @code
+         * double sum = 0.0;
+         * client.ComputeFunction(inputs, [&sum](const std::string &name, const std::string &,
+         *                                       size_t, const double *values, size_t count)
+         * {
+         *     sum += std::accumulate(values, values + count, 0.0);
+         * });
+         * @endcode
+         *
+         * @param inputs input variables
+         * @param sink function receiving the chunks (exceptions cancel the call)
+         */
+        void ComputeFunction(const Variables &inputs, const ChunkSink &sink);
+
+        /**
+         * @brief Evaluates the remote function for many design points.
+         *
+         * If the server supports batched evaluations (see
+         * DisciplineClient::ServerSupports and philote::kFeatureBatch), all
+         * design points are sent in a single ComputeFunction RPC (split into
+         * several RPCs of at most philote::kMaxBatchSize points). Otherwise,
+         * ComputeFunction is called once per design point.
+         *
+         * @param inputs input variables for each design point
+         * @return std::vector<Variables> outputs for each design point
+         */
+        std::vector<Variables> ComputeFunctionBatch(const std::vector<Variables> &inputs);
+
         /**
          * @brief Calls the remote analysis server gradient evaluation via gRPC
          *
@@ -450,37 +1077,195 @@ namespace philote
         Partials ComputeGradient(const Variables &inputs);
 
         /**
-         * @brief Set the stub (for testing purposes)
+         * @brief Evaluates the remote gradient, passing the partials to a sink
          *
-         * @param stub
+         * See ComputeFunction(const Variables &, const ChunkSink &). The name
+         * and subname of a chunk are the of and wrt variables of the partial.
+         *
+         * @param inputs input variables
+         * @param sink function receiving the chunks (exceptions cancel the call)
          */
-        void SetStub(std::unique_ptr<ExplicitService::StubInterface> stub)
-        {
-            stub_ = std::move(stub);
-        }
-
-    protected:
-        //! explicit service stub
-        std::unique_ptr<ExplicitService::StubInterface> stub_;
-    };
-}
-// Template implementations must be in header
-#include <algorithm>
+        void ComputeGradient(const Variables &inputs, const ChunkSink &sink);
 
-namespace philote {
+        /**
+         * @brief Evaluates the remote function and its gradient in one call.
+         *
+         * If the server supports it (see philote::kFeatureFusedGradient), the
+         * outputs and partials are returned by a single ComputeFunction RPC
+         * and the discipline may compute both in one pass (see
+         * ExplicitDiscipline::ComputeWithPartials). Otherwise,
+         * ComputeFunction and ComputeGradient are called in turn.
+         *
+         * @param inputs input variables
+         * @return std::pair<Variables, Partials> outputs and partials
+         */
+        std::pair<Variables, Partials> ComputeFunctionAndGradient(const Variables &inputs);
 
-template<typename StreamType>
-grpc::Status ExplicitServer::ComputeFunctionImpl(grpc::ServerContext *context, StreamType *stream)
-{
-    if (!implementation_)
-    {
-        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "Discipline implementation not linked");
-    }
+        /**
+         * @brief Evaluates a Jacobian-vector product of the remote discipline.
+         *
+         * Returns J * seeds, the directional derivative of the outputs. If
+         * the server supports it (see philote::kFeatureJacobianProducts), the
+         * product is computed remotely (see ExplicitDiscipline::ComputeJacVec)
+         * and only the products are transferred. Otherwise, the gradient is
+         * requested and multiplied locally.
+         *
+         * @param inputs input variables
+         * @param seeds direction in the input space (missing inputs are zero)
+         * @return Variables products, one per output
+         */
+        Variables ComputeJacVec(const Variables &inputs, const Variables &seeds);
 
-    if (!stream)
-    {
-        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Stream is null");
-    }
+        /**
+         * @brief Evaluates a vector-Jacobian product of the remote discipline.
+         *
+         * Returns J^T * seeds, e.g., the gradient of a weighted sum of the
+         * outputs. See ComputeJacVec for the fallback.
+         *
+         * @param inputs input variables
+         * @param seeds weights of the outputs (missing outputs are zero)
+         * @return Variables products, one per input
+         */
+        Variables ComputeVecJac(const Variables &inputs, const Variables &seeds);
+
+        /**
+         * @brief Starts a remote function evaluation without blocking.
+         *
+         * The call is made with the gRPC callback API, so many evaluations
+         * (e.g., on different servers) can be in flight without a thread per
+         * call. The callback runs on a gRPC library thread once the call is
+         * finished; failures are reported through its exception argument
+         * with the same messages ComputeFunction throws. The client must
+         * outlive all pending calls.
+         *
+         * @param inputs input variables (copied before the function returns)
+         * @param callback completion callback
+         */
+        void ComputeFunctionAsync(const Variables &inputs, AsyncCallback<Variables> callback);
+
+        /**
+         * @brief Starts a remote function evaluation without blocking.
+         *
+         * @param inputs input variables (copied before the function returns)
+         * @return std::future<Variables> outputs of the evaluation
+         */
+        std::future<Variables> ComputeFunctionAsync(const Variables &inputs);
+
+        /**
+         * @brief Starts a remote gradient evaluation without blocking.
+         *
+         * See ComputeFunctionAsync for the threading and lifetime rules.
+         *
+         * @param inputs input variables (copied before the function returns)
+         * @param callback completion callback
+         */
+        void ComputeGradientAsync(const Variables &inputs, AsyncCallback<Partials> callback);
+
+        /**
+         * @brief Starts a remote gradient evaluation without blocking.
+         *
+         * @param inputs input variables (copied before the function returns)
+         * @return std::future<Partials> partials of the evaluation
+         */
+        std::future<Partials> ComputeGradientAsync(const Variables &inputs);
+
+        /**
+         * @brief Enables caching of function and gradient results
+         *
+         * ComputeFunction and ComputeGradient return results of previous
+         * calls with bitwise identical inputs (and the same remote
+         * configuration) without an RPC. The least recently used results are
+         * evicted once a cache exceeds its memory cap. Batched and
+         * asynchronous calls are not cached.
+         *
+         * @param max_bytes memory cap of the function and of the gradient
+         * cache in bytes (0 disables caching)
+         */
+        void EnableResultCache(size_t max_bytes);
+
+        /**
+         * @brief Returns the combined counters of the result caches
+         */
+        ResultCacheStats GetResultCacheStats() const;
+
+        /**
+         * @brief Set the stub (for testing purposes)
+         *
+         * @param stub
+         */
+        void SetStub(std::unique_ptr<ExplicitService::StubInterface> stub)
+        {
+            CloseStreams();
+            stub_ = std::move(stub);
+        }
+
+    protected:
+        //! explicit service stub
+        std::unique_ptr<ExplicitService::StubInterface> stub_;
+
+        //! cached function results
+        ResultCache<Variables> function_cache_;
+
+        //! cached gradient results
+        ResultCache<Partials> gradient_cache_;
+
+        //! stream of the blocking function evaluations
+        EvaluationStream function_stream_;
+
+        //! stream of the blocking function and gradient evaluations
+        EvaluationStream fused_stream_;
+
+        //! stream of the blocking gradient evaluations
+        EvaluationStream gradient_stream_;
+
+    private:
+        //! Computes a Jacobian product (see ComputeJacVec and ComputeVecJac)
+        Variables ComputeJacobianProduct(const Variables &inputs, const Variables &seeds, bool reverse);
+
+        //! Starts a new stream for a call (see StartCall)
+        using StreamStarter = std::function<std::unique_ptr<EvaluationStream::Stream>(grpc::ClientContext *)>;
+
+        /**
+         * @brief Starts a blocking compute call
+         *
+         * Reuses the evaluation stream of the RPC if it can carry another
+         * evaluation. Otherwise, a new stream is started whose context
+         * carries the deadline, the common metadata, and the metadata added
+         * by prepare.
+         *
+         * @param rpc RPC name
+         * @param call stream of the RPC
+         * @param prepare adds the metadata of the call to a new context
+         * @param start starts the RPC with a new context
+         * @return ClientCallSpan span of the call
+         */
+        ClientCallSpan StartCall(const std::string &rpc, EvaluationStream &call,
+                                 const std::function<void(grpc::ClientContext &)> &prepare,
+                                 const StreamStarter &start);
+
+        /**
+         * @brief Closes the streams of the blocking compute calls
+         */
+        void CloseStreams() noexcept;
+    };
+}
+// Template implementations must be in header
+#include <algorithm>
+
+namespace philote {
+
+template<typename StreamType>
+grpc::Status ExplicitServer::ComputeFunctionImpl(grpc::ServerContextBase *context, StreamType *stream)
+{
+    if (!implementation_)
+    {
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, "Discipline implementation not linked");
+    }
+
+    if (!stream)
+    {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Stream is null");
+    }
 
     // Check for cancellation before starting
     if (context && context->IsCancelled())
@@ -488,56 +1273,111 @@ grpc::Status ExplicitServer::ComputeFunctionImpl(grpc::ServerContext *context, S
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before start");
     }
 
-    philote::Array array;
-
-    // preallocate the inputs based on meta data
-    Variables inputs;
-    const auto *discipline = static_cast<philote::Discipline *>(implementation_.get());
-    if (!discipline)
+    // batched evaluations are requested via client metadata
+    const std::string batch_header = FindClientMetadata(context, kBatchSizeMetadataKey);
+    if (!batch_header.empty())
     {
-        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
+        size_t batch_size = 0;
+        if (!ParseIndex(batch_header, kMaxBatchSize + 1, batch_size) || batch_size == 0)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Invalid batch size: " + batch_header);
+        }
+
+        return ComputeFunctionBatchImpl(context, stream, batch_size);
     }
 
-    for (const auto &var : discipline->var_meta())
+    // obtain an instance of the discipline for this call
+    InstancePool<ExplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
     {
-        std::string name = var.name();
-        if (var.type() == kInput)
-            inputs[name] = Variable(var);
+        return acquired;
     }
 
-    // Build O(1) lookup map for variable metadata
-    std::unordered_map<std::string, const VariableMetaData*> var_lookup;
-    for (const auto &var : discipline->var_meta())
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
+
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
+    if (!discipline)
     {
-        var_lookup[var.name()] = &var;
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
     }
 
+    // preallocated variables, reused by subsequent calls
+    WorkspaceCache::Lease workspace = discipline->AcquireWorkspace();
+    FlatVariables &inputs = workspace->inputs;
+    FlatVariables &outputs = workspace->outputs;
+    philote::Array &array = workspace->message;
+    InputReadyTracker ready(implementation.get());
+
+    // co-located clients exchange the values through shared memory
+    SharedMemoryTransfer shared;
+    grpc::Status shared_status = shared_memory_.Attach(context, shared);
+    if (!shared_status.ok())
+        return shared_status;
+
+    // calls of an input session only carry the inputs that changed
+    InputSessionRequest session;
+    grpc::Status session_status = input_sessions_.Restore(context, session, workspace->inputs);
+    if (!session_status.ok())
+        return session_status;
+
+    // the messages are assigned by the assembly workers while reading the
+    // next ones (shared memory transfers are assigned in stream order)
+    ParallelAssembly assembly(shared ? nullptr : implementation_->assembly_pool());
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
+
     while (stream->Read(&array))
     {
+        // unpack messages that carry several small inputs
+        if (IsPackedArray(array))
+        {
+            try
+            {
+                for (const PackedEntry &entry : DecodePackedIndex(array))
+                {
+                    if (!inputs.Contains(entry.name))
+                    {
+                        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                      "Input not found: " + entry.name);
+                    }
+                    AssignPackedEntry(array, entry, inputs.at(entry.name));
+
+                    grpc::Status ready_status = ready.Received(entry.name, inputs.at(entry.name), entry.size);
+                    if (!ready_status.ok())
+                        return ready_status;
+                }
+            }
+            catch (const std::exception &e)
+            {
+                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "Failed to unpack inputs: " + std::string(e.what()));
+            }
+            continue;
+        }
+
         // get variables from the stream message
         const std::string &name = array.name();
 
         // get the variable corresponding to the current message using O(1) lookup
-        auto var_it = var_lookup.find(name);
-        if (var_it == var_lookup.end())
+        auto var_it = workspace->types.find(name);
+        if (var_it == workspace->types.end())
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
         }
-        const VariableMetaData* var = var_it->second;
+        const VariableType type = var_it->second;
 
         // obtain the inputs and discrete inputs from the stream
-        if (var->type() == VariableType::kInput)
+        if (type == VariableType::kInput)
         {
-            try
-            {
-                // set the variable slice
-                inputs[name].AssignChunk(array);
-            }
-            catch (const std::exception &e)
-            {
-                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                              "Failed to assign chunk for variable " + name + ": " + e.what());
-            }
+            // set the variable slice
+            grpc::Status assign_status = assembly.Submit(name, array,
+                                                         AssignTask(shared, ready, inputs.at(name), "variable", precision));
+            if (!assign_status.ok())
+                return assign_status;
         }
         else
         {
@@ -545,27 +1385,67 @@ grpc::Status ExplicitServer::ComputeFunctionImpl(grpc::ServerContext *context, S
         }
     }
 
-    // preallocate outputs
-    Variables outputs;
-    for (const VariableMetaData &var : discipline->var_meta())
+    grpc::Status assembly_status = assembly.Finish();
+    if (!assembly_status.ok())
+        return assembly_status;
+
+    if (session.IsDelta())
     {
-        if (var.type() == kOutput)
-            outputs[var.name()] = Variable(var);
+        grpc::Status ready_status = ready.Complete(workspace->inputs.map());
+        if (!ready_status.ok())
+            return ready_status;
     }
+    // Set context for discipline to check cancellation during compute
+    ContextScope context_scope(discipline, context);
 
-    // Check for cancellation before expensive computation
-    if (context && context->IsCancelled())
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
     {
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
     }
 
-    // Set context for discipline to check cancellation during compute
-    discipline->SetContext(context);
+    // only complete inputs are kept for the session
+    input_sessions_.Store(session, workspace->inputs);
+
+    // outputs finalized during Compute are sent right away
+    const size_t chunk_size = discipline->stream_opts().num_double();
+
+    // discrete outputs are integer-encoded if the client supports it
+    const WirePrecision discrete_precision = RequestedWirePrecision(context, true);
+    auto output_precision = [discipline, precision, discrete_precision](const std::string &name)
+    { return discipline->IsDiscrete(name) ? discrete_precision : precision; };
+
+    OutputWriter writer(outputs, [stream, chunk_size, context, &output_precision, &shared](const std::string &name,
+                                                                                           const Variable &value)
+                        {
+                            const WirePrecision value_precision = output_precision(name);
+                            if (shared and value_precision != WirePrecision::kInteger)
+                                shared.Send(name, "", value, stream);
+                            else
+                                value.Send(name, "", stream, chunk_size, context, value_precision);
+                        });
+
+    // the partials are computed with the outputs if requested, or after
+    // them if memoized (so that streamed outputs are still sent early)
+    const bool fused = FindClientMetadata(context, kFusedGradientMetadataKey) == "1";
+    const bool memoize = implementation_->partials_memoization();
+    Partials &partials = workspace->partials;
 
     // call the discipline developer-defined Compute function
     try
     {
-        implementation_->Compute(inputs, outputs);
+        if (fused)
+            implementation->ComputeWithPartials(inputs, outputs, partials);
+        else
+            implementation->ComputeStreaming(inputs, outputs, writer);
+
+        if (memoize)
+        {
+            if (!fused)
+                implementation->ComputePartials(inputs.map(), partials);
+            implementation->MemoizePartials(inputs.map(), partials);
+        }
     }
     catch (const std::exception &e)
     {
@@ -583,13 +1463,26 @@ grpc::Status ExplicitServer::ComputeFunctionImpl(grpc::ServerContext *context, S
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
     }
 
-    // iterate through continuous outputs
-    for (const auto &out : outputs)
+    // pack small outputs if the client requested it
+    const bool packed = FindClientMetadata(context, kPackedVariablesMetadataKey) == "1" and chunk_size > 0;
+    ArrayPacker packer(VariableType::kOutput, std::max<size_t>(chunk_size, 1));
+
+    // iterate through continuous outputs (that were not sent during Compute)
+    for (const auto &out : outputs.map())
     {
         const std::string &name = out.first;
+        if (writer.IsFinal(name))
+            continue;
+
         try
         {
-            out.second.Send(name, "", stream, discipline->stream_opts().num_double(), context);
+            const WirePrecision value_precision = output_precision(name);
+            if (value_precision == WirePrecision::kInteger)
+                out.second.Send(name, "", stream, chunk_size, context, value_precision);
+            else if (shared)
+                shared.Send(name, "", out.second, stream);
+            else if (!packed or !packer.Add(name, out.second))
+                out.second.Send(name, "", stream, chunk_size, context, precision);
         }
         catch (const std::exception &e)
         {
@@ -598,11 +1491,23 @@ grpc::Status ExplicitServer::ComputeFunctionImpl(grpc::ServerContext *context, S
         }
     }
 
+    for (const philote::Array &message : packer.Finish())
+    {
+        if (context && context->IsCancelled())
+            return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled while sending results");
+        if (!stream->Write(message))
+            return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to write packed outputs");
+    }
+
+    // the partials follow the outputs
+    if (fused)
+        return SendPartials(context, stream, discipline, partials, shared);
+
     return grpc::Status::OK;
 }
 
 template<typename StreamType>
-grpc::Status ExplicitServer::ComputeGradientImpl(grpc::ServerContext *context, StreamType *stream)
+grpc::Status ExplicitServer::ComputeGradientImpl(grpc::ServerContextBase *context, StreamType *stream)
 {
     if (!implementation_)
     {
@@ -620,93 +1525,458 @@ grpc::Status ExplicitServer::ComputeGradientImpl(grpc::ServerContext *context, S
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before start");
     }
 
-    philote::Array array;
-
-    // preallocate the inputs based on meta data
-    Variables inputs;
-    const auto *discipline = static_cast<philote::Discipline *>(implementation_.get());
-    if (!discipline)
+    // Jacobian products are requested via client metadata
+    const std::string product = FindClientMetadata(context, kJacobianProductMetadataKey);
+    if (!product.empty())
     {
-        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
+        if (product != kJacobianProductForward and product != kJacobianProductReverse)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Invalid Jacobian product mode: " + product);
+        }
+
+        return ComputeJacobianProductImpl(context, stream, product == kJacobianProductReverse);
     }
 
-    for (const auto &var : discipline->var_meta())
+    // obtain an instance of the discipline for this call
+    InstancePool<ExplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
     {
-        std::string name = var.name();
-        if (var.type() == kInput)
-            inputs[name] = Variable(var);
+        return acquired;
     }
 
-    // Build O(1) lookup map for variable metadata
-    std::unordered_map<std::string, const VariableMetaData*> var_lookup;
-    for (const auto &var : discipline->var_meta())
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
+
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
+    if (!discipline)
     {
-        var_lookup[var.name()] = &var;
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
     }
 
+    // preallocated variables, reused by subsequent calls
+    WorkspaceCache::Lease workspace = discipline->AcquireWorkspace();
+    Variables &inputs = workspace->inputs.map();
+    Partials &partials = workspace->partials;
+    philote::Array &array = workspace->message;
+    InputReadyTracker ready(implementation.get());
+
+    // co-located clients exchange the values through shared memory
+    SharedMemoryTransfer shared;
+    grpc::Status shared_status = shared_memory_.Attach(context, shared);
+    if (!shared_status.ok())
+        return shared_status;
+
+    // calls of an input session only carry the inputs that changed
+    InputSessionRequest session;
+    grpc::Status session_status = input_sessions_.Restore(context, session, workspace->inputs);
+    if (!session_status.ok())
+        return session_status;
+
+    // the messages are assigned by the assembly workers while reading the
+    // next ones (shared memory transfers are assigned in stream order)
+    ParallelAssembly assembly(shared ? nullptr : implementation_->assembly_pool());
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
+
     while (stream->Read(&array))
     {
         // get variables from the stream message
         const std::string &name = array.name();
 
         // get the variable corresponding to the current message using O(1) lookup
-        auto var_it = var_lookup.find(name);
-        if (var_it == var_lookup.end())
+        auto var_it = workspace->types.find(name);
+        if (var_it == workspace->types.end())
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
         }
-        const VariableMetaData* var = var_it->second;
+        const VariableType type = var_it->second;
 
         // obtain the inputs and discrete inputs from the stream
-        if (var->type() == VariableType::kInput)
+        if (type == VariableType::kInput)
         {
-            try
-            {
-                // set the variable slice
-                inputs[name].AssignChunk(array);
-            }
-            catch (const std::exception &e)
+            // set the variable slice
+            grpc::Status assign_status = assembly.Submit(name, array,
+                                                         AssignTask(shared, ready, inputs.at(name), "variable", precision));
+            if (!assign_status.ok())
+                return assign_status;
+        }
+        else
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Invalid variable type for input: " + name);
+        }
+    }
+
+    grpc::Status assembly_status = assembly.Finish();
+    if (!assembly_status.ok())
+        return assembly_status;
+
+    if (session.IsDelta())
+    {
+        grpc::Status ready_status = ready.Complete(workspace->inputs.map());
+        if (!ready_status.ok())
+            return ready_status;
+    }
+    // Set context for discipline to check cancellation during compute
+    ContextScope context_scope(discipline, context);
+
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
+    }
+
+    // only complete inputs are kept for the session
+    input_sessions_.Store(session, workspace->inputs);
+
+    // call the discipline developer-defined Compute function (unless the
+    // partials at these inputs were memoized by ComputeFunction)
+    bool sent = false;
+    grpc::Status send_status;
+    try
+    {
+        if (!implementation_->partials_memoization() or
+            !implementation->RecallPartials(inputs, partials))
+        {
+            if (implementation->block_partials())
             {
-                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                              "Failed to assign chunk for variable " + name + ": " + e.what());
+                // every block is sent as soon as it has been computed
+                implementation->ComputePartialBlocks(inputs, partials,
+                    [&](const std::string &of, const std::string &wrt, const Variable &block)
+                    {
+                        send_status = SendPartial(context, stream, discipline, of, wrt, block, shared);
+                        if (!send_status.ok())
+                            throw std::runtime_error(send_status.error_message());
+                    });
+                sent = true;
             }
+            else
+                implementation->ComputePartials(inputs, partials);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        discipline->ClearContext();
+        if (!send_status.ok())
+            return send_status;
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                      "Failed to compute partials: " + std::string(e.what()));
+    }
+
+    // Clear context after computation
+    discipline->ClearContext();
+
+    // Check for cancellation before sending results
+    if (context && context->IsCancelled())
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
+    }
+
+    if (sent)
+        return grpc::Status::OK;
+
+    return SendPartials(context, stream, discipline, partials, shared);
+}
+
+template<typename StreamType>
+grpc::Status ExplicitServer::SendPartials(grpc::ServerContextBase *context, StreamType *stream,
+                                          const Discipline *discipline, const Partials &partials,
+                                          SharedMemoryTransfer &shared)
+{
+    // the workers serialize the next partials while the current one is written
+    ThreadPool *pool = shared ? nullptr : implementation_->assembly_pool();
+    if (pool and partials.size() > 1)
+    {
+        // sparse partials are expanded for clients without sparse partial support
+        const bool sparse = FindClientMetadata(context, kSparsePartialsMetadataKey) == "1";
+        const PartialsSparsity &sparsity = discipline->partials_sparsity();
+        try
+        {
+            SendPartialsInOrder(*pool, partials, sparse ? nullptr : &sparsity,
+                                discipline->stream_opts().num_double(), RequestedWirePrecision(context), context,
+                                [stream](const philote::Array &message)
+                                { return stream->Write(message); });
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL, e.what());
         }
+
+        return grpc::Status::OK;
+    }
+
+    // iterate through continuous outputs
+    for (const auto &par : partials)
+    {
+        grpc::Status status = SendPartial(context, stream, discipline, par.first.first, par.first.second,
+                                          par.second, shared);
+        if (!status.ok())
+            return status;
+    }
+
+    return grpc::Status::OK;
+}
+
+template<typename StreamType>
+grpc::Status ExplicitServer::SendPartial(grpc::ServerContextBase *context, StreamType *stream,
+                                         const Discipline *discipline, const std::string &of,
+                                         const std::string &wrt, const Variable &value,
+                                         SharedMemoryTransfer &shared)
+{
+    // sparse partials are expanded for clients without sparse partial support
+    const bool sparse = FindClientMetadata(context, kSparsePartialsMetadataKey) == "1";
+    const PartialsSparsity &sparsity = discipline->partials_sparsity();
+
+    try
+    {
+        auto pattern = sparse ? sparsity.end() : sparsity.find({of, wrt});
+        Variable dense;
+        if (pattern != sparsity.end())
+            dense = pattern->second.Densify(value);
+        const Variable &values = pattern == sparsity.end() ? value : dense;
+
+        if (shared)
+            shared.Send(of, wrt, values, stream);
         else
+            values.Send(of, wrt, stream, discipline->stream_opts().num_double(), context,
+                        RequestedWirePrecision(context));
+    }
+    catch (const std::exception &e)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                      "Failed to send partial " + of + "/" + wrt + ": " + e.what());
+    }
+
+    return grpc::Status::OK;
+}
+
+template<typename StreamType>
+grpc::Status ExplicitServer::ComputeFunctionBatchImpl(grpc::ServerContextBase *context, StreamType *stream,
+                                                      size_t batch_size)
+{
+    // obtain an instance of the discipline for this call
+    InstancePool<ExplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
+    {
+        return acquired;
+    }
+
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
+
+    philote::Array array;
+
+    // preallocate the inputs of every design point based on meta data
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
+    if (!discipline)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
+    }
+
+    Variables point_inputs;
+    for (const auto &var : discipline->var_meta())
+    {
+        if (var.type() == kInput)
+            point_inputs[var.name()] = Variable(var);
+    }
+    std::vector<Variables> inputs(batch_size, point_inputs);
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
+
+    while (stream->Read(&array))
+    {
+        const std::string &name = array.name();
+
+        const VariableMetaData *var = discipline->FindVariableMeta(name);
+        if (!var)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
+        }
+        if (var->type() != VariableType::kInput)
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Invalid variable type for input: " + name);
         }
+
+        // the subname identifies the design point
+        size_t point = 0;
+        if (!ParseIndex(array.subname(), batch_size, point))
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Invalid design point index '" + array.subname() + "' for variable " + name);
+        }
+
+        try
+        {
+            inputs[point][name].AssignChunk(array, precision);
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Failed to assign chunk for variable " + name + ": " + e.what());
+        }
     }
 
     // preallocate outputs
-    Partials partials;
-    for (const PartialsMetaData &par : discipline->partials_meta())
+    Variables point_outputs;
+    for (const VariableMetaData &var : discipline->var_meta())
     {
-        std::vector<size_t> shape;
-        for (const int64_t &dim : par.shape())
-            shape.push_back(dim);
+        if (var.type() == kOutput)
+            point_outputs[var.name()] = Variable(var);
+    }
+    std::vector<Variables> outputs(batch_size, point_outputs);
+
+    // Set context for discipline to check cancellation during compute
+    ContextScope context_scope(discipline, context);
+
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
+    }
 
-        partials[std::make_pair(par.name(), par.subname())] = Variable(kOutput, shape);
+    // call the discipline developer-defined batch function
+    try
+    {
+        implementation->ComputeBatch(inputs, outputs);
     }
+    catch (const std::exception &e)
+    {
+        discipline->ClearContext();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                      "Failed to compute outputs: " + std::string(e.what()));
+    }
+
+    // Clear context after computation
+    discipline->ClearContext();
 
-    // Check for cancellation before expensive computation
+    if (outputs.size() != batch_size)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                      "ComputeBatch returned " + std::to_string(outputs.size()) +
+                      " output sets for " + std::to_string(batch_size) + " design points");
+    }
+
+    // Check for cancellation before sending results
     if (context && context->IsCancelled())
     {
-        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
+    }
+
+    for (size_t point = 0; point < batch_size; point++)
+    {
+        const std::string subname = std::to_string(point);
+        for (const auto &out : outputs[point])
+        {
+            const std::string &name = out.first;
+            try
+            {
+                out.second.Send(name, subname, stream, discipline->stream_opts().num_double(), context,
+                                precision);
+            }
+            catch (const std::exception &e)
+            {
+                return grpc::Status(grpc::StatusCode::INTERNAL,
+                              "Failed to send output " + name + ": " + e.what());
+            }
+        }
+    }
+
+    return grpc::Status::OK;
+}
+
+template<typename StreamType>
+grpc::Status ExplicitServer::ComputeJacobianProductImpl(grpc::ServerContextBase *context, StreamType *stream,
+                                                        bool reverse)
+{
+    // obtain an instance of the discipline for this call
+    InstancePool<ExplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
+    {
+        return acquired;
+    }
+
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
+
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
+    if (!discipline)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
+    }
+
+    // the seeds live in the input space for forward products and in the
+    // output space for reverse products; the products in the other one
+    const VariableType seed_type = reverse ? VariableType::kOutput : VariableType::kInput;
+    Variables inputs, seeds, products;
+    for (const VariableMetaData &var : discipline->var_meta())
+    {
+        if (var.type() == kInput)
+            inputs[var.name()] = Variable(var);
+        if (var.type() == seed_type)
+            seeds[var.name()] = Variable(var);
+        else if (var.type() == kInput or var.type() == kOutput)
+            products[var.name()] = Variable(var);
+    }
+
+    philote::Array array;
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
+
+    while (stream->Read(&array))
+    {
+        const std::string &name = array.name();
+
+        // seed messages are marked by their subname
+        const bool seed = array.subname() == kJacobianSeedSubname;
+        Variables &target = seed ? seeds : inputs;
+        auto var = target.find(name);
+        if (var == target.end())
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          std::string(seed ? "Seed" : "Input") + " variable not found: " + name);
+        }
+
+        try
+        {
+            var->second.AssignChunk(array, precision);
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Failed to assign chunk for variable " + name + ": " + e.what());
+        }
     }
 
     // Set context for discipline to check cancellation during compute
-    discipline->SetContext(context);
+    ContextScope context_scope(discipline, context);
+
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
+    }
 
-    // call the discipline developer-defined Compute function
     try
     {
-        implementation_->ComputePartials(inputs, partials);
+        if (reverse)
+            implementation->ComputeVecJac(inputs, seeds, products);
+        else
+            implementation->ComputeJacVec(inputs, seeds, products);
     }
     catch (const std::exception &e)
     {
         discipline->ClearContext();
         return grpc::Status(grpc::StatusCode::INTERNAL,
-                      "Failed to compute partials: " + std::string(e.what()));
+                      "Failed to compute Jacobian product: " + std::string(e.what()));
     }
 
     // Clear context after computation
@@ -718,19 +1988,17 @@ grpc::Status ExplicitServer::ComputeGradientImpl(grpc::ServerContext *context, S
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
     }
 
-    // iterate through continuous outputs
-    for (const auto &par : partials)
+    for (const auto &prod : products)
     {
-        const std::string &name = par.first.first;
-        const std::string &subname = par.first.second;
         try
         {
-            par.second.Send(name, subname, stream, discipline->stream_opts().num_double(), context);
+            prod.second.Send(prod.first, "", stream, discipline->stream_opts().num_double(), context,
+                             precision);
         }
         catch (const std::exception &e)
         {
             return grpc::Status(grpc::StatusCode::INTERNAL,
-                          "Failed to send partial " + name + "/" + subname + ": " + e.what());
+                          "Failed to send product " + prod.first + ": " + e.what());
         }
     }
 
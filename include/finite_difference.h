@@ -0,0 +1,68 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace philote
+{
+    /**
+     * @brief How the partials of a declared (of, wrt) pair are obtained
+     */
+    enum class PartialsMethod
+    {
+        //! computed by the discipline (ComputePartials or ComputePartial)
+        kAnalytic,
+
+        //! (f(x + h) - f(x)) / h, one evaluation per perturbation
+        kForwardDifference,
+
+        //! (f(x + h) - f(x - h)) / 2h, two evaluations per perturbation
+        kCentralDifference
+    };
+
+    /**
+     * @brief Groups the columns of a Jacobian that can be perturbed together
+     *
+     * Columns that share no non-zero row do not influence each other's
+     * differences, so a single function evaluation with all of them
+     * perturbed recovers all of their entries. The columns are colored
+     * greedily in order; a dense Jacobian yields one group per column.
+     *
+     * @param column_rows non-zero rows of each column
+     * @param num_rows number of rows of the Jacobian
+     * @return std::vector<std::vector<size_t>> columns of each group
+     * @throws std::out_of_range if a row index is not below num_rows
+     */
+    std::vector<std::vector<size_t>> ColorColumns(const std::vector<std::vector<size_t>> &column_rows,
+                                                  size_t num_rows);
+}
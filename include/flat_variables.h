@@ -0,0 +1,313 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <data.pb.h>
+#include <mapped_file.h>
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @brief Variables stored in a single contiguous buffer
+     *
+     * All variables share one row-major buffer; every variable occupies the
+     * block [offset, offset + size) in the order it was added. Offsets are
+     * padded to multiples of kSimdAlignment bytes, so that the storage of
+     * every variable is aligned. Variables are
+     * addressed by integer handles, which can be resolved once (e.g., after
+     * Setup) and stay valid for as long as the layout is not changed.
+     *
+     * For compatibility with the map-based API, map() exposes the same
+     * variables as a philote::Variables map whose entries are views into the
+     * buffer. Writing to these views writes to the buffer.
+     *
+     * @par Example
+     * @code
+     * philote::FlatVariables inputs;
+     * auto x = inputs.Add("x", philote::kInput, {3});
+     * auto y = inputs.Add("y", philote::kInput, {2});
+     *
+     * inputs(x, 0) = 1.0;                  // handle access
+     * inputs.map().at("y")(1) = 2.0;       // map access, same storage
+     * double *block = inputs.data();       // x at 0, y at 8 (size() == 10)
+     * @endcode
+     *
+     * @note Thread Safety: This class is NOT thread-safe.
+     */
+    class FlatVariables
+    {
+    public:
+        //! Integer handle of a variable (its position in the layout)
+        using Handle = size_t;
+
+        /**
+         * @brief Construct an empty container
+         */
+        FlatVariables() = default;
+
+        /**
+         * @brief Construct the container from variable meta data
+         *
+         * Adds every variable whose type equals the given type, in the order
+         * of the meta data.
+         *
+         * @param meta variable meta data of a discipline
+         * @param type type of the variables that are added
+         */
+        FlatVariables(const std::vector<VariableMetaData> &meta,
+                      const VariableType &type);
+
+        /**
+         * @brief Construct the container from variable meta data, stored in a
+         * memory-mapped file if it is large enough
+         *
+         * The buffer of a file-backed container cannot grow, so Add() throws
+         * once the layout is complete. Copies hold their buffer in memory.
+         *
+         * @param meta variable meta data of a discipline
+         * @param type type of the variables that are added
+         * @param storage placement of the buffer (see FileStorage)
+         */
+        FlatVariables(const std::vector<VariableMetaData> &meta,
+                      const VariableType &type,
+                      const FileStorage &storage);
+
+        /**
+         * @brief Copy constructor (the views of the copy refer to its own buffer)
+         */
+        FlatVariables(const FlatVariables &other);
+
+        /**
+         * @brief Copy assignment (the views refer to the copied buffer)
+         */
+        FlatVariables &operator=(const FlatVariables &other);
+
+        FlatVariables(FlatVariables &&other) noexcept = default;
+        FlatVariables &operator=(FlatVariables &&other) noexcept = default;
+
+        ~FlatVariables() noexcept = default;
+
+        /**
+         * @brief Appends a variable to the layout
+         *
+         * The new variable is zero-initialized. Pointers into the buffer
+         * obtained before the call are invalidated; handles remain valid.
+         *
+         * @param name name of the variable
+         * @param type type of the variable
+         * @param shape shape of the variable
+         * @return Handle handle of the new variable
+         * @throws std::invalid_argument if a variable with the name exists
+         * @throws std::logic_error if the buffer is file-backed and full
+         */
+        Handle Add(const std::string &name,
+                   const VariableType &type,
+                   const std::vector<size_t> &shape);
+
+        /**
+         * @brief Resolves the handle of a variable
+         *
+         * @param name name of the variable
+         * @return Handle
+         * @throws std::out_of_range if the variable does not exist
+         */
+        Handle Find(const std::string &name) const;
+
+        /**
+         * @brief Returns whether a variable exists
+         *
+         * @param name name of the variable
+         * @return true if the variable is part of the layout
+         */
+        bool Contains(const std::string &name) const noexcept;
+
+        /**
+         * @brief Returns the variable (a view into the buffer) of a handle
+         *
+         * @param handle handle of the variable
+         * @return Variable&
+         */
+        Variable &operator[](Handle handle);
+
+        /**
+         * @brief Returns the variable (a view into the buffer) of a handle
+         *
+         * @param handle handle of the variable
+         * @return const Variable&
+         */
+        const Variable &operator[](Handle handle) const;
+
+        /**
+         * @brief Returns the variable with the given name
+         *
+         * @param name name of the variable
+         * @return Variable&
+         * @throws std::out_of_range if the variable does not exist
+         */
+        Variable &at(const std::string &name);
+
+        /**
+         * @brief Returns the variable with the given name
+         *
+         * @param name name of the variable
+         * @return const Variable&
+         * @throws std::out_of_range if the variable does not exist
+         */
+        const Variable &at(const std::string &name) const;
+
+        /**
+         * @brief Element access by handle without a name lookup
+         *
+         * @param handle handle of the variable
+         * @param i flat index within the variable
+         * @return double&
+         */
+        double &operator()(Handle handle, size_t i) noexcept;
+
+        /**
+         * @brief Element access by handle without a name lookup
+         *
+         * @param handle handle of the variable
+         * @param i flat index within the variable
+         * @return double
+         */
+        double operator()(Handle handle, size_t i) const noexcept;
+
+        /**
+         * @brief Returns the name of a variable
+         */
+        const std::string &name(Handle handle) const;
+
+        /**
+         * @brief Returns the offset of a variable within the buffer
+         */
+        size_t offset(Handle handle) const;
+
+        /**
+         * @brief Returns the number of elements of a variable
+         */
+        size_t size(Handle handle) const;
+
+        /**
+         * @brief Returns the number of variables
+         */
+        size_t count() const noexcept;
+
+        /**
+         * @brief Returns the number of elements of the buffer, including the
+         * padding between variables
+         */
+        size_t size() const noexcept;
+
+        /**
+         * @brief Returns whether the buffer is stored in a memory-mapped file
+         */
+        bool IsFileBacked() const noexcept { return file_ != nullptr; }
+
+        /**
+         * @brief Returns the contiguous buffer of all variables
+         */
+        double *data() noexcept;
+
+        /**
+         * @brief Returns the contiguous buffer of all variables
+         */
+        const double *data() const noexcept;
+
+        /**
+         * @brief Returns the variables as a map of views into the buffer
+         *
+         * Map entries that are replaced by the user no longer refer to the
+         * buffer; Fill() restores them. Entries must not be erased.
+         *
+         * @return Variables&
+         */
+        Variables &map() noexcept;
+
+        /**
+         * @brief Returns the variables as a map of views into the buffer
+         *
+         * @return const Variables&
+         */
+        const Variables &map() const noexcept;
+
+        /**
+         * @brief Sets all elements of all variables to a value
+         *
+         * Also reattaches map entries that were replaced by the user.
+         * File-backed buffers are zeroed without paging in their values.
+         *
+         * @param value value assigned to every element
+         */
+        void Fill(double value);
+
+    private:
+        //! layout entry of a variable
+        struct Entry
+        {
+            std::string name;
+            VariableType type;
+            std::vector<size_t> shape;
+            size_t offset;
+            size_t size;
+        };
+
+        /**
+         * @brief Points the map entries and handle views at the buffer
+         */
+        void BindViews();
+
+        //! variable layout in order of the handles
+        std::vector<Entry> entries_;
+
+        //! handle by variable name
+        std::unordered_map<std::string, Handle> handles_;
+
+        //! contiguous, aligned storage of all variables (unused if file-backed)
+        AlignedVector<double> buffer_;
+
+        //! file holding the storage (nullptr if in memory)
+        std::shared_ptr<MappedFile> file_;
+
+        //! map of views for the map-based API
+        Variables views_;
+
+        //! map entry of each handle
+        std::vector<Variable *> by_handle_;
+    };
+}
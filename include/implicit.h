@@ -33,13 +33,24 @@
 #include <disciplines.grpc.pb.h>
 #include "discipline_server.h"
 
+#include <async_call.h>
+#include <callback_server.h>
+#include <compression.h>
 #include <discipline.h>
+#include <evaluation_stream.h>
+#include <instance_pool.h>
+#include <local_transport.h>
+#include <newton_solver.h>
+#include <parallel_assembly.h>
+#include <protocol_extensions.h>
+#include <shared_memory.h>
 #include "discipline_client.h"
 
 namespace philote
 {
     // forward declaration
     class ImplicitDiscipline;
+    class ImplicitClient;
 
     /**
      * @brief Implicit server class
@@ -73,6 +84,47 @@ namespace philote
          */
         void UnlinkPointers();
 
+        /**
+         * @brief Serves each RPC with its own instance from a pool
+         *
+         * @param pool instance pool (nullptr to use the linked discipline for
+         * all RPCs)
+         */
+        void SetInstancePool(std::shared_ptr<InstancePool<philote::ImplicitDiscipline>> pool);
+
+        /**
+         * @brief Places the pooled instances on cores or NUMA nodes
+         *
+         * @param placement placement of the instances
+         * @throws std::invalid_argument if instances are to be placed but no
+         * instance pool is set
+         */
+        void SetPlacement(const ThreadPlacement &placement);
+
+        /**
+         * @brief Returns the metrics recorder of the linked discipline
+         *
+         * @return MetricsRecorder* nullptr if no discipline is linked or the
+         * discipline has no recorder
+         */
+        MetricsRecorder *metrics_recorder() const noexcept;
+
+        /**
+         * @brief Returns the tracer of the linked discipline
+         *
+         * @return Tracer* nullptr if no discipline is linked or the
+         * discipline has no tracer
+         */
+        Tracer *tracer() const noexcept;
+
+        /**
+         * @brief Returns the admission controller of the linked discipline
+         *
+         * @return AdmissionController* nullptr if no discipline is linked or
+         * the discipline has no admission limits
+         */
+        AdmissionController *admission_controller() const noexcept;
+
         /**
          * @brief RPC that computes the residual evaluation
          *
@@ -108,13 +160,20 @@ namespace philote
 
         // Test helper methods that accept interface pointers for unit testing with mocks
         template<typename StreamType>
-        grpc::Status ComputeResidualsImpl(grpc::ServerContext *context, StreamType *stream);
+        grpc::Status ComputeResidualsImpl(grpc::ServerContextBase *context, StreamType *stream);
+
+        template<typename StreamType>
+        grpc::Status SolveResidualsImpl(grpc::ServerContextBase *context, StreamType *stream);
+
+        template<typename StreamType>
+        grpc::Status ComputeResidualGradientsImpl(grpc::ServerContextBase *context, StreamType *stream);
 
         template<typename StreamType>
-        grpc::Status SolveResidualsImpl(grpc::ServerContext *context, StreamType *stream);
+        grpc::Status ComputeJacobianProductImpl(grpc::ServerContextBase *context, StreamType *stream,
+                                                bool reverse);
 
         template<typename StreamType>
-        grpc::Status ComputeResidualGradientsImpl(grpc::ServerContext *context, StreamType *stream);
+        grpc::Status SolveLinearImpl(grpc::ServerContextBase *context, StreamType *stream, bool adjoint);
 
         // Public wrappers for tests
         grpc::Status ComputeResidualsForTesting(grpc::ServerContext *context,
@@ -136,8 +195,97 @@ namespace philote
         }
 
     private:
+        /**
+         * @brief Obtains the discipline instance for an RPC
+         *
+         * Returns a pooled instance if an instance pool is set and the linked
+         * discipline otherwise. Waiting for a pooled instance ends with the
+         * deadline or the cancellation of the call.
+         *
+         * @param context server context of the call (may be nullptr)
+         * @param lease receives the instance
+         * @return grpc::Status DEADLINE_EXCEEDED or CANCELLED if the call
+         * ended while waiting, INTERNAL if the instance could not be created
+         */
+        grpc::Status AcquireInstance(grpc::ServerContextBase *context,
+                                     InstancePool<philote::ImplicitDiscipline>::Lease &lease);
+
         //! Shared pointer to the implementation of the implicit discipline
         std::shared_ptr<philote::ImplicitDiscipline> implementation_;
+
+        //! Optional pool of instances serving concurrent RPCs
+        std::shared_ptr<InstancePool<philote::ImplicitDiscipline>> pool_;
+
+        //! Shared memory segments of co-located clients
+        SharedMemoryCache shared_memory_;
+    };
+
+    /**
+     * @brief Implicit server based on the gRPC callback API
+     *
+     * Alternative to ImplicitServer for servers with many concurrent
+     * clients. Streams are read and written asynchronously, so slow clients
+     * do not occupy a thread. Once a client has sent all variables, the
+     * evaluation runs the same logic as ImplicitServer (including instance
+     * pools) on a fixed-size compute thread pool.
+     */
+    class ImplicitCallbackServer : public ImplicitService::CallbackService
+    {
+    public:
+        //! Constructor
+        ImplicitCallbackServer() = default;
+
+        //! Destructor
+        ~ImplicitCallbackServer() noexcept;
+
+        /**
+         * @brief Links the server logic and starts the compute threads
+         *
+         * @param server implicit server providing the RPC logic (must outlive
+         * this object)
+         * @param threads number of compute threads (0 uses the number of
+         * hardware threads)
+         */
+        void LinkPointers(philote::ImplicitServer *server, size_t threads = 0);
+
+        /**
+         * @brief Unlinks the server logic
+         */
+        void UnlinkPointers();
+
+        /**
+         * @brief RPC that computes the residual evaluation
+         *
+         * @param context
+         * @return grpc::ServerBidiReactor<::philote::Array, ::philote::Array>*
+         */
+        grpc::ServerBidiReactor<::philote::Array, ::philote::Array> *ComputeResiduals(
+            grpc::CallbackServerContext *context) override;
+
+        /**
+         * @brief RPC that solves the residuals
+         *
+         * @param context
+         * @return grpc::ServerBidiReactor<::philote::Array, ::philote::Array>*
+         */
+        grpc::ServerBidiReactor<::philote::Array, ::philote::Array> *SolveResiduals(
+            grpc::CallbackServerContext *context) override;
+
+        /**
+         * @brief RPC that computes the residual gradients
+         *
+         * @param context
+         * @return grpc::ServerBidiReactor<::philote::Array, ::philote::Array>*
+         */
+        grpc::ServerBidiReactor<::philote::Array, ::philote::Array> *ComputeResidualGradients(
+            grpc::CallbackServerContext *context) override;
+
+    private:
+        //! Server providing the RPC logic
+        philote::ImplicitServer *server_ = nullptr;
+
+        //! Threads running the evaluations
+        std::unique_ptr<ThreadPool> executor_;
     };
 
     /**
@@ -309,6 +457,84 @@ namespace philote
          */
         void RegisterServices(grpc::ServerBuilder &builder);
 
+        /**
+         * @brief Registers all services with a gRPC channel
+         *
+         * With ServerEngine::kCallback, the compute RPCs are served by an
+         * ImplicitCallbackServer, so open streams do not occupy threads and
+         * at most compute_threads evaluations run at the same time. Use
+         * EnableInstancePool to give concurrent evaluations their own
+         * discipline instances. The (short) metadata and configuration RPCs
+         * are always served synchronously.
+         *
+         * On multi-socket machines, the placement pins the instances of the
+         * instance pool to cores or NUMA nodes (see ThreadPlacement), so that
+         * every call computes on the node holding the buffers of its
+         * instance.
+         *
+         * @param builder
+         * @param engine server implementation of the compute RPCs
+         * @param compute_threads number of compute threads for the callback
+         * engine (0 uses the number of hardware threads)
+         * @param placement placement of the pooled instances (requires
+         * EnableInstancePool unless the policy is PlacementPolicy::kNone)
+         * @throws std::invalid_argument if instances are to be placed without
+         * an instance pool
+         */
+        void RegisterServices(grpc::ServerBuilder &builder, ServerEngine engine,
+                              size_t compute_threads = 0, const ThreadPlacement &placement = ThreadPlacement());
+
+        /**
+         * @brief Serves concurrent RPCs with separate discipline instances
+         *
+         * Without an instance pool, all RPCs share this discipline instance.
+         * With a pool, every ComputeResiduals, SolveResiduals, and
+         * ComputeResidualGradients call obtains its own instance (created by
+         * the factory on demand), so concurrent calls do not share state. This
+         * instance still handles all configuration RPCs; pooled instances are
+         * configured to match it before they are used.
+         *
+         * @param factory function creating a new instance of the discipline
+         * @param size maximum number of instances (i.e., concurrent computations)
+         */
+        void EnableInstancePool(InstancePool<ImplicitDiscipline>::Factory factory, size_t size);
+
+        /**
+         * @brief Serves the discipline on a Unix domain socket
+         *
+         * Clients on the same host connect with
+         * CreateUnixSocketChannel(path), which bypasses the TCP stack.
+         *
+         * @param path file system path of the socket
+         * @param engine server implementation of the compute RPCs
+         * @param compute_threads number of compute threads for the callback
+         * engine (0 uses the number of hardware threads)
+         * @return std::shared_ptr<grpc::Server> running server
+         * @throws std::runtime_error if the server cannot be started
+         */
+        std::shared_ptr<grpc::Server> ServeUnixSocket(const std::string &path,
+                                                      ServerEngine engine = ServerEngine::kSynchronous,
+                                                      size_t compute_threads = 0);
+
+        /**
+         * @brief Serves the discipline within this process and connects a client
+         *
+         * The client uses an in-process channel, so calls bypass the network
+         * stack entirely (e.g., for disciplines embedded in a monolithic
+         * application, tests, and benchmarks). The client is initialized
+         * (GetInfo, Setup, GetVariableDefinitions, and GetPartialDefinitions)
+         * and keeps the server running until it is destroyed. A discipline
+         * can only be served by one server at a time.
+         *
+         * @param engine server implementation of the compute RPCs
+         * @param compute_threads number of compute threads for the callback
+         * engine (0 uses the number of hardware threads)
+         * @return std::unique_ptr<ImplicitClient> ready-to-use client
+         * @throws std::runtime_error if the server cannot be started
+         */
+        std::unique_ptr<ImplicitClient> ServeInProcess(ServerEngine engine = ServerEngine::kSynchronous,
+                                                       size_t compute_threads = 0);
+
         /**
          * @brief Declare a (set of) partial(s) for the discipline
          *
@@ -317,6 +543,19 @@ namespace philote
          */
         void DeclarePartials(const std::string &f, const std::string &x);
 
+        /**
+         * @brief Declare a sparse partial for the discipline
+         *
+         * @param f residual (output) variable
+         * @param x input or output variable
+         * @param rows flattened index into f of each non-zero
+         * @param cols flattened index into x of each non-zero
+         * @see Discipline::DeclarePartials
+         */
+        void DeclarePartials(const std::string &f, const std::string &x,
+                             const std::vector<int64_t> &rows,
+                             const std::vector<int64_t> &cols);
+
         /**
          * @brief Computes the residual for the discipline.
          *
@@ -324,18 +563,34 @@ namespace philote
          * discipline.
          *
          * @param inputs input variables for the discipline (continuous and
-         * discrete)
+         * discrete; discrete inputs are held as doubles)
          * @return philote::Variables
          */
         virtual void ComputeResiduals(const philote::Variables &inputs,
                                       const philote::Variables &outputs,
                                       philote::Variables &residuals);
 
+        /**
+         * @brief Computes the residuals on contiguously stored variables.
+         *
+         * Called by the server for ComputeResiduals. The default
+         * implementation calls ComputeResiduals with the map views of the
+         * variables (see ExplicitDiscipline::ComputeFlat).
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs output variables for the discipline
+         * @param residuals preallocated residuals
+         */
+        virtual void ComputeResidualsFlat(const philote::FlatVariables &inputs,
+                                          const philote::FlatVariables &outputs,
+                                          philote::FlatVariables &residuals);
+
         /**
          * @brief Solves the residuals to obtain the outputs for the discipline.
          *
-         * This function should be overridden by the developer of the
-         * discipline.
+         * The default implementation calls SolveNewton. Disciplines with a
+         * dedicated solver (or a closed-form solution) override this
+         * function.
          *
          * @param inputs input variables for the discipline
          * @param outputs output variables for the discipline (will be assigned
@@ -343,6 +598,55 @@ namespace philote
          */
         virtual void SolveResiduals(const philote::Variables &inputs, philote::Variables &outputs);
 
+        /**
+         * @brief Solves the residuals with Newton's (or Broyden's) method
+         *
+         * Iterates on the outputs with ComputeResiduals and the partials of
+         * the residuals with respect to the outputs from
+         * ComputeResidualGradients, starting from the values in outputs
+         * (zeros for SolveResiduals calls of the server). The iterations run
+         * entirely on the server, and their buffers are reused. Cancelled
+         * calls stop at the next residual evaluation.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs initial guess, overwritten with the solution
+         * @return size_t number of iterations
+         * @throws std::runtime_error if the iterations do not converge or the
+         * Jacobian is singular
+         * @throws std::logic_error if no partials of the residuals with
+         * respect to the outputs are declared
+         */
+        size_t SolveNewton(const philote::Variables &inputs, philote::Variables &outputs);
+
+        /**
+         * @brief Configures SolveNewton
+         *
+         * Set the options in the constructor of the discipline, so instances
+         * of an instance pool share them. Use NonlinearMethod::kBroyden for
+         * residual gradients that are expensive compared to the residuals and
+         * a SparseLUSolver factory for large, sparse systems.
+         *
+         * @param options solver settings
+         */
+        void SetNewtonOptions(const NewtonOptions &options);
+
+        /**
+         * @brief Returns the settings of SolveNewton
+         */
+        const NewtonOptions &newton_options() const noexcept { return newton_options_; }
+
+        /**
+         * @brief Solves the residuals on contiguously stored variables.
+         *
+         * Called by the server for SolveResiduals. The default implementation
+         * calls SolveResiduals with the map views of the variables.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs output variables for the discipline (will be
+         * assigned during the function call)
+         */
+        virtual void SolveResidualsFlat(const philote::FlatVariables &inputs, philote::FlatVariables &outputs);
+
         /**
          * @brief Computes the gradients of the residuals evaluation for the
          * discipline.
@@ -352,15 +656,106 @@ namespace philote
          * partials).
          *
          * @param inputs input variables for the discipline (continuous and
-         * discrete)
+         * discrete; discrete inputs are held as doubles)
          */
         virtual void ComputeResidualGradients(const philote::Variables &inputs,
                                               const philote::Variables &outputs,
                                               Partials &partials);
 
+        /**
+         * @brief Jacobian-vector product of the residuals.
+         *
+         * Called by the server for ComputeResidualGradients calls that
+         * request a forward product (see ImplicitClient::ComputeJacVec). The
+         * default implementation computes all residual gradients and
+         * multiplies them with the seeds. Matrix-free disciplines may
+         * override this function to avoid forming the Jacobian.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs output variables for the discipline
+         * @param seeds direction in the space of the inputs and outputs
+         * (missing variables are zero)
+         * @param products preallocated products, one per residual
+         */
+        virtual void ComputeJacVec(const philote::Variables &inputs,
+                                   const philote::Variables &outputs,
+                                   const philote::Variables &seeds,
+                                   philote::Variables &products);
+
+        /**
+         * @brief Vector-Jacobian product of the residuals.
+         *
+         * Called by the server for ComputeResidualGradients calls that
+         * request a reverse product (see ImplicitClient::ComputeVecJac), e.g.,
+         * by adjoint solvers. The default implementation computes all
+         * residual gradients and multiplies their transpose with the seeds.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs output variables for the discipline
+         * @param seeds weights of the residuals (missing residuals are zero)
+         * @param products preallocated products, one per input and output
+         */
+        virtual void ComputeVecJac(const philote::Variables &inputs,
+                                   const philote::Variables &outputs,
+                                   const philote::Variables &seeds,
+                                   philote::Variables &products);
+
+        /**
+         * @brief Solves the linear system dR/dy * solution = rhs.
+         *
+         * Called by the server for ComputeResidualGradients calls that
+         * request a forward linear solve (see ImplicitClient::SolveLinear),
+         * e.g., by coupled Newton solvers. The default implementation
+         * assembles dR/dy from ComputeResidualGradients and factorizes it with
+         * the linear solver of the Newton options. Disciplines that keep a
+         * factorization or preconditioner (e.g., from SolveResiduals) override
+         * this function to reuse it.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs output variables for the discipline
+         * @param rhs right-hand side, by residual (missing residuals are zero)
+         * @param solution preallocated solution, by output
+         */
+        virtual void SolveLinear(const philote::Variables &inputs,
+                                 const philote::Variables &outputs,
+                                 const philote::Variables &rhs,
+                                 philote::Variables &solution);
+
+        /**
+         * @brief Solves the adjoint linear system (dR/dy)^T * solution = rhs.
+         *
+         * Called by the server for ComputeResidualGradients calls that
+         * request an adjoint linear solve (see
+         * ImplicitClient::SolveAdjointLinear). See SolveLinear for the default.
+         *
+         * @param inputs input variables for the discipline
+         * @param outputs output variables for the discipline
+         * @param rhs right-hand side, by output (missing outputs are zero)
+         * @param solution preallocated adjoint solution, by residual
+         */
+        virtual void SolveAdjointLinear(const philote::Variables &inputs,
+                                        const philote::Variables &outputs,
+                                        const philote::Variables &rhs,
+                                        philote::Variables &solution);
+
     private:
+        //! Default of SolveLinear and SolveAdjointLinear
+        void SolveLinearSystem(const philote::Variables &inputs, const philote::Variables &outputs,
+                               const philote::Variables &rhs, philote::Variables &solution, bool adjoint);
+
+        //! settings of SolveNewton
+        NewtonOptions newton_options_;
+
+        //! nonlinear solver with buffers reused across solves
+        NewtonSolver newton_;
+
+        //! serializes SolveNewton calls (they share the solver buffers)
+        std::mutex newton_mutex_;
+
         //! Implicit discipline server
         philote::ImplicitServer implicit_;
+        //! Implicit discipline server for the callback engine
+        philote::ImplicitCallbackServer implicit_callback_;
         //! Discipline server
         philote::DisciplineServer discipline_server_;
     };
@@ -540,6 +935,28 @@ namespace philote
          */
         Variables SolveResiduals(const Variables &vars);
 
+        /**
+         * @brief Starts a remote solve without blocking.
+         *
+         * The call is made with the gRPC callback API, so many solves can be
+         * in flight without a thread per call. The callback runs on a gRPC
+         * library thread once the call is finished; failures are reported
+         * through its exception argument with the same messages
+         * SolveResiduals throws. The client must outlive all pending calls.
+         *
+         * @param vars inputs for the discipline (copied before the function returns)
+         * @param callback completion callback
+         */
+        void SolveResidualsAsync(const Variables &vars, AsyncCallback<Variables> callback);
+
+        /**
+         * @brief Starts a remote solve without blocking.
+         *
+         * @param vars inputs for the discipline (copied before the function returns)
+         * @return std::future<Variables> solved outputs
+         */
+        std::future<Variables> SolveResidualsAsync(const Variables &vars);
+
         /**
          * @brief Calls the remote analysis server gradient evaluation via gRPC
          *
@@ -548,6 +965,77 @@ namespace philote
          */
         Partials ComputeResidualGradients(const Variables &vars);
 
+        /**
+         * @brief Evaluates a Jacobian-vector product of the remote residuals.
+         *
+         * Returns dR/d(x, y) * seeds. If the server supports it (see
+         * philote::kFeatureJacobianProducts), the product is computed
+         * remotely (see ImplicitDiscipline::ComputeJacVec) and only the
+         * products are transferred. Otherwise, the residual gradients are
+         * requested and multiplied locally.
+         *
+         * @param vars inputs and outputs for the discipline
+         * @param seeds direction in the space of the inputs and outputs
+         * (missing variables are zero)
+         * @return Variables products, one per residual
+         */
+        Variables ComputeJacVec(const Variables &vars, const Variables &seeds);
+
+        /**
+         * @brief Evaluates a vector-Jacobian product of the remote residuals.
+         *
+         * Returns dR/d(x, y)^T * seeds. See ComputeJacVec for the fallback.
+         *
+         * @param vars inputs and outputs for the discipline
+         * @param seeds weights of the residuals (missing residuals are zero)
+         * @return Variables products, one per input and output
+         */
+        Variables ComputeVecJac(const Variables &vars, const Variables &seeds);
+
+        /**
+         * @brief Solves dR/dy * solution = rhs with the remote discipline.
+         *
+         * If the server supports it (see philote::kFeatureLinearSolves), the
+         * system is solved remotely (see ImplicitDiscipline::SolveLinear), so
+         * only vectors are transferred. Otherwise, the residual gradients are
+         * requested and the system is solved locally.
+         *
+         * @param vars inputs and outputs for the discipline
+         * @param rhs right-hand side, by residual (missing residuals are zero)
+         * @return Variables solution, by output
+         */
+        Variables SolveLinear(const Variables &vars, const Variables &rhs);
+
+        /**
+         * @brief Solves (dR/dy)^T * solution = rhs with the remote discipline.
+         *
+         * See SolveLinear for the fallback.
+         *
+         * @param vars inputs and outputs for the discipline
+         * @param rhs right-hand side, by output (missing outputs are zero)
+         * @return Variables adjoint solution, by residual
+         */
+        Variables SolveAdjointLinear(const Variables &vars, const Variables &rhs);
+
+        /**
+         * @brief Enables caching of residual, solve, and gradient results
+         *
+         * ComputeResiduals, SolveResiduals, and ComputeResidualGradients
+         * return results of previous calls with bitwise identical variables
+         * (and the same remote configuration) without an RPC. The least
+         * recently used results are evicted once a cache exceeds its memory
+         * cap. Asynchronous calls are not cached.
+         *
+         * @param max_bytes memory cap of each of the three caches in bytes
+         * (0 disables caching)
+         */
+        void EnableResultCache(size_t max_bytes);
+
+        /**
+         * @brief Returns the combined counters of the result caches
+         */
+        ResultCacheStats GetResultCacheStats() const;
+
         /**
          * @brief Sets the stub for testing purposes (allows dependency injection)
          *
@@ -559,8 +1047,23 @@ namespace philote
         }
 
     private:
+        //! Computes a Jacobian product (see ComputeJacVec and ComputeVecJac)
+        Variables ComputeJacobianProduct(const Variables &vars, const Variables &seeds, bool reverse);
+
+        //! Solves a linear system (see SolveLinear and SolveAdjointLinear)
+        Variables SolveLinearSystem(const Variables &vars, const Variables &rhs, bool adjoint);
+
         //! implicit service stub
         std::unique_ptr<ImplicitService::StubInterface> stub_;
+
+        //! cached residual results
+        ResultCache<Variables> residual_cache_;
+
+        //! cached solve results
+        ResultCache<Variables> solve_cache_;
+
+        //! cached residual gradient results
+        ResultCache<Partials> gradient_cache_;
     };
 
 // Template implementations must be in header
@@ -568,7 +1071,7 @@ namespace philote
 #include <unordered_map>
 
 template<typename StreamType>
-grpc::Status philote::ImplicitServer::ComputeResidualsImpl(grpc::ServerContext *context, StreamType *stream)
+grpc::Status philote::ImplicitServer::ComputeResidualsImpl(grpc::ServerContextBase *context, StreamType *stream)
 {
     if (!implementation_)
     {
@@ -586,34 +1089,43 @@ grpc::Status philote::ImplicitServer::ComputeResidualsImpl(grpc::ServerContext *
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before start");
     }
 
-    philote::Array array;
+    // obtain an instance of the discipline for this call
+    InstancePool<ImplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
+    {
+        return acquired;
+    }
+
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
 
-    // preallocate the variables based on meta data
-    Variables inputs, outputs, residuals;
-    const auto *discipline = static_cast<philote::Discipline *>(implementation_.get());
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
     if (!discipline)
     {
         return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
     }
 
-    for (const auto &var : discipline->var_meta())
-    {
-        std::string name = var.name();
-        if (var.type() == kInput)
-            inputs[name] = Variable(var);
-        if (var.type() == kOutput)
-        {
-            outputs[var.name()] = Variable(var);
-            residuals[var.name()] = Variable(var);
-        }
-    }
+    // preallocated variables, reused by subsequent calls
+    WorkspaceCache::Lease workspace = discipline->AcquireWorkspace();
+    FlatVariables &inputs = workspace->inputs;
+    FlatVariables &outputs = workspace->outputs;
+    FlatVariables &residuals = workspace->residuals;
+    philote::Array &array = workspace->message;
+    InputReadyTracker ready(implementation.get());
 
-    // Build O(1) lookup map for variable metadata
-    std::unordered_map<std::string, const VariableMetaData*> var_lookup;
-    for (const auto &var : discipline->var_meta())
-    {
-        var_lookup[var.name()] = &var;
-    }
+    // co-located clients exchange the values through shared memory
+    SharedMemoryTransfer shared;
+    grpc::Status shared_status = shared_memory_.Attach(context, shared);
+    if (!shared_status.ok())
+        return shared_status;
+
+    // the messages are assigned by the assembly workers while reading the
+    // next ones (shared memory transfers are assigned in stream order)
+    ParallelAssembly assembly(shared ? nullptr : implementation_->assembly_pool());
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
 
     while (stream->Read(&array))
     {
@@ -621,45 +1133,35 @@ grpc::Status philote::ImplicitServer::ComputeResidualsImpl(grpc::ServerContext *
         const std::string &name = array.name();
 
         // get the variable corresponding to the current message using O(1) lookup
-        auto var_it = var_lookup.find(name);
-        if (var_it == var_lookup.end())
+        auto var_it = workspace->types.find(name);
+        if (var_it == workspace->types.end())
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
         }
-        const VariableMetaData* var = var_it->second;
+        const VariableType type = var_it->second;
 
         // Validate that the message type matches the metadata type
-        if (array.type() != var->type())
+        if (array.type() != type)
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
                          "Type mismatch for variable " + name + ": expected " +
-                         std::to_string(var->type()) + " but received " + std::to_string(array.type()));
+                         std::to_string(type) + " but received " + std::to_string(array.type()));
         }
 
         // obtain the inputs and outputs from the stream
-        if (var->type() == VariableType::kInput)
-        {
-            try
-            {
-                inputs[name].AssignChunk(array);
-            }
-            catch (const std::exception &e)
-            {
-                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                              "Failed to assign chunk for input " + name + ": " + e.what());
-            }
-        }
-        else if (var->type() == VariableType::kOutput)
-        {
-            try
-            {
-                outputs[name].AssignChunk(array);
-            }
-            catch (const std::exception &e)
-            {
-                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                              "Failed to assign chunk for output " + name + ": " + e.what());
-            }
+        if (type == VariableType::kInput)
+        {
+            grpc::Status assign_status = assembly.Submit(name, array,
+                                                         AssignTask(shared, ready, inputs.at(name), "input", precision));
+            if (!assign_status.ok())
+                return assign_status;
+        }
+        else if (type == VariableType::kOutput)
+        {
+            grpc::Status assign_status = assembly.Submit(name, array,
+                                                         AssignTask(shared, ready, outputs.at(name), "output", precision));
+            if (!assign_status.ok())
+                return assign_status;
         }
         else
         {
@@ -668,19 +1170,24 @@ grpc::Status philote::ImplicitServer::ComputeResidualsImpl(grpc::ServerContext *
         }
     }
 
-    // Check for cancellation before expensive computation
-    if (context && context->IsCancelled())
+    grpc::Status assembly_status = assembly.Finish();
+    if (!assembly_status.ok())
+        return assembly_status;
+
+    // Set context for discipline to check cancellation during compute
+    ContextScope context_scope(discipline, context);
+
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
     {
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
     }
 
-    // Set context for discipline to check cancellation during compute
-    discipline->SetContext(context);
-
     // call the discipline developer-defined Compute function
     try
     {
-        implementation_->ComputeResiduals(inputs, outputs, residuals);
+        implementation->ComputeResidualsFlat(inputs, outputs, residuals);
     }
     catch (const std::exception &e)
     {
@@ -699,12 +1206,15 @@ grpc::Status philote::ImplicitServer::ComputeResidualsImpl(grpc::ServerContext *
     }
 
     // iterate through residuals
-    for (const auto &res : residuals)
+    for (const auto &res : residuals.map())
     {
         const std::string &name = res.first;
         try
         {
-            res.second.Send(name, "", stream, discipline->stream_opts().num_double(), context);
+            if (shared)
+                shared.Send(name, "", res.second, stream);
+            else
+                res.second.Send(name, "", stream, discipline->stream_opts().num_double(), context, precision);
         }
         catch (const std::exception &e)
         {
@@ -717,7 +1227,7 @@ grpc::Status philote::ImplicitServer::ComputeResidualsImpl(grpc::ServerContext *
 }
 
 template<typename StreamType>
-grpc::Status philote::ImplicitServer::SolveResidualsImpl(grpc::ServerContext *context, StreamType *stream)
+grpc::Status philote::ImplicitServer::SolveResidualsImpl(grpc::ServerContextBase *context, StreamType *stream)
 {
     if (!implementation_)
     {
@@ -735,29 +1245,42 @@ grpc::Status philote::ImplicitServer::SolveResidualsImpl(grpc::ServerContext *co
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before start");
     }
 
-    philote::Array array;
+    // obtain an instance of the discipline for this call
+    InstancePool<ImplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
+    {
+        return acquired;
+    }
+
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
 
-    // preallocate the inputs based on meta data
-    Variables inputs;
-    const auto *discipline = static_cast<philote::Discipline *>(implementation_.get());
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
     if (!discipline)
     {
         return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
     }
 
-    for (const auto &var : discipline->var_meta())
-    {
-        std::string name = var.name();
-        if (var.type() == kInput)
-            inputs[name] = Variable(var);
-    }
+    // preallocated variables, reused by subsequent calls
+    WorkspaceCache::Lease workspace = discipline->AcquireWorkspace();
+    FlatVariables &inputs = workspace->inputs;
+    FlatVariables &outputs = workspace->outputs;
+    philote::Array &array = workspace->message;
+    InputReadyTracker ready(implementation.get());
 
-    // Build O(1) lookup map for variable metadata
-    std::unordered_map<std::string, const VariableMetaData*> var_lookup;
-    for (const auto &var : discipline->var_meta())
-    {
-        var_lookup[var.name()] = &var;
-    }
+    // co-located clients exchange the values through shared memory
+    SharedMemoryTransfer shared;
+    grpc::Status shared_status = shared_memory_.Attach(context, shared);
+    if (!shared_status.ok())
+        return shared_status;
+
+    // the messages are assigned by the assembly workers while reading the
+    // next ones (shared memory transfers are assigned in stream order)
+    ParallelAssembly assembly(shared ? nullptr : implementation_->assembly_pool());
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
 
     while (stream->Read(&array))
     {
@@ -765,25 +1288,20 @@ grpc::Status philote::ImplicitServer::SolveResidualsImpl(grpc::ServerContext *co
         const std::string &name = array.name();
 
         // get the variable corresponding to the current message using O(1) lookup
-        auto var_it = var_lookup.find(name);
-        if (var_it == var_lookup.end())
+        auto var_it = workspace->types.find(name);
+        if (var_it == workspace->types.end())
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
         }
-        const VariableMetaData* var = var_it->second;
+        const VariableType type = var_it->second;
 
         // obtain the inputs from the stream (only inputs expected for solve)
-        if (var->type() == VariableType::kInput)
-        {
-            try
-            {
-                inputs[name].AssignChunk(array);
-            }
-            catch (const std::exception &e)
-            {
-                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                              "Failed to assign chunk for input " + name + ": " + e.what());
-            }
+        if (type == VariableType::kInput)
+        {
+            grpc::Status assign_status = assembly.Submit(name, array,
+                                                         AssignTask(shared, ready, inputs.at(name), "input", precision));
+            if (!assign_status.ok())
+                return assign_status;
         }
         else
         {
@@ -792,27 +1310,24 @@ grpc::Status philote::ImplicitServer::SolveResidualsImpl(grpc::ServerContext *co
         }
     }
 
-    // preallocate outputs
-    Variables outputs;
-    for (const VariableMetaData &var : discipline->var_meta())
-    {
-        if (var.type() == kOutput)
-            outputs[var.name()] = Variable(var);
-    }
+    grpc::Status assembly_status = assembly.Finish();
+    if (!assembly_status.ok())
+        return assembly_status;
 
-    // Check for cancellation before expensive computation
-    if (context && context->IsCancelled())
+    // Set context for discipline to check cancellation during solve
+    ContextScope context_scope(discipline, context);
+
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
     {
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
     }
 
-    // Set context for discipline to check cancellation during solve
-    discipline->SetContext(context);
-
     // call the discipline developer-defined Solve function
     try
     {
-        implementation_->SolveResiduals(inputs, outputs);
+        implementation->SolveResidualsFlat(inputs, outputs);
     }
     catch (const std::exception &e)
     {
@@ -830,13 +1345,19 @@ grpc::Status philote::ImplicitServer::SolveResidualsImpl(grpc::ServerContext *co
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
     }
 
-    // iterate through continuous outputs
-    for (const auto &var : outputs)
+    // iterate through the outputs (discrete outputs are integer-encoded if the client supports it)
+    const WirePrecision discrete_precision = RequestedWirePrecision(context, true);
+    for (const auto &var : outputs.map())
     {
         const std::string &name = var.first;
+        const WirePrecision value_precision = discipline->IsDiscrete(name) ? discrete_precision : precision;
         try
         {
-            var.second.Send(name, "", stream, discipline->stream_opts().num_double(), context);
+            if (shared and value_precision != WirePrecision::kInteger)
+                shared.Send(name, "", var.second, stream);
+            else
+                var.second.Send(name, "", stream, discipline->stream_opts().num_double(), context,
+                                value_precision);
         }
         catch (const std::exception &e)
         {
@@ -849,7 +1370,7 @@ grpc::Status philote::ImplicitServer::SolveResidualsImpl(grpc::ServerContext *co
 }
 
 template<typename StreamType>
-grpc::Status philote::ImplicitServer::ComputeResidualGradientsImpl(grpc::ServerContext *context, StreamType *stream)
+grpc::Status philote::ImplicitServer::ComputeResidualGradientsImpl(grpc::ServerContextBase *context, StreamType *stream)
 {
     if (!implementation_)
     {
@@ -867,77 +1388,105 @@ grpc::Status philote::ImplicitServer::ComputeResidualGradientsImpl(grpc::ServerC
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before start");
     }
 
-    philote::Array array;
+    // Jacobian products are requested via client metadata
+    const std::string product = FindClientMetadata(context, kJacobianProductMetadataKey);
+    if (!product.empty())
+    {
+        if (product != kJacobianProductForward and product != kJacobianProductReverse)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Invalid Jacobian product mode: " + product);
+        }
 
-    // preallocate the inputs and outputs based on meta data
-    Variables inputs, outputs;
-    const auto *discipline = static_cast<philote::Discipline *>(implementation_.get());
-    if (!discipline)
+        return ComputeJacobianProductImpl(context, stream, product == kJacobianProductReverse);
+    }
+
+    // linear solves are requested via client metadata
+    const std::string solve = FindClientMetadata(context, kLinearSolveMetadataKey);
+    if (!solve.empty())
     {
-        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
+        if (solve != kLinearSolveForward and solve != kLinearSolveAdjoint)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Invalid linear solve mode: " + solve);
+        }
+
+        return SolveLinearImpl(context, stream, solve == kLinearSolveAdjoint);
     }
 
-    for (const auto &var : discipline->var_meta())
+    // obtain an instance of the discipline for this call
+    InstancePool<ImplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
     {
-        const std::string &name = var.name();
-        if (var.type() == kInput)
-            inputs[name] = Variable(var);
-        if (var.type() == kOutput)
-            outputs[name] = Variable(var);
+        return acquired;
     }
 
-    // Build O(1) lookup map for variable metadata
-    std::unordered_map<std::string, const VariableMetaData*> var_lookup;
-    for (const auto &var : discipline->var_meta())
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
+
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
+    if (!discipline)
     {
-        var_lookup[var.name()] = &var;
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
     }
 
+    // preallocated variables, reused by subsequent calls
+    WorkspaceCache::Lease workspace = discipline->AcquireWorkspace();
+    Variables &inputs = workspace->inputs.map();
+    Variables &outputs = workspace->outputs.map();
+    Partials &partials = workspace->partials;
+    philote::Array &array = workspace->message;
+    InputReadyTracker ready(implementation.get());
+
+    // co-located clients exchange the values through shared memory
+    SharedMemoryTransfer shared;
+    grpc::Status shared_status = shared_memory_.Attach(context, shared);
+    if (!shared_status.ok())
+        return shared_status;
+
+    // the messages are assigned by the assembly workers while reading the
+    // next ones (shared memory transfers are assigned in stream order)
+    ParallelAssembly assembly(shared ? nullptr : implementation_->assembly_pool());
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
+
     while (stream->Read(&array))
     {
         // get variables from the stream message
         const std::string &name = array.name();
 
         // get the variable corresponding to the current message using O(1) lookup
-        auto var_it = var_lookup.find(name);
-        if (var_it == var_lookup.end())
+        auto var_it = workspace->types.find(name);
+        if (var_it == workspace->types.end())
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
         }
-        const VariableMetaData* var = var_it->second;
+        const VariableType type = var_it->second;
 
         // Validate that the message type matches the metadata type
-        if (array.type() != var->type())
+        if (array.type() != type)
         {
             return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
                          "Type mismatch for variable " + name + ": expected " +
-                         std::to_string(var->type()) + " but received " + std::to_string(array.type()));
+                         std::to_string(type) + " but received " + std::to_string(array.type()));
         }
 
         // obtain the inputs and outputs from the stream
-        if (var->type() == VariableType::kInput)
-        {
-            try
-            {
-                inputs[name].AssignChunk(array);
-            }
-            catch (const std::exception &e)
-            {
-                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                              "Failed to assign chunk for input " + name + ": " + e.what());
-            }
-        }
-        else if (var->type() == VariableType::kOutput)
-        {
-            try
-            {
-                outputs[name].AssignChunk(array);
-            }
-            catch (const std::exception &e)
-            {
-                return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
-                              "Failed to assign chunk for output " + name + ": " + e.what());
-            }
+        if (type == VariableType::kInput)
+        {
+            grpc::Status assign_status = assembly.Submit(name, array,
+                                                         AssignTask(shared, ready, inputs.at(name), "input", precision));
+            if (!assign_status.ok())
+                return assign_status;
+        }
+        else if (type == VariableType::kOutput)
+        {
+            grpc::Status assign_status = assembly.Submit(name, array,
+                                                         AssignTask(shared, ready, outputs.at(name), "output", precision));
+            if (!assign_status.ok())
+                return assign_status;
         }
         else
         {
@@ -946,30 +1495,24 @@ grpc::Status philote::ImplicitServer::ComputeResidualGradientsImpl(grpc::ServerC
         }
     }
 
-    // preallocate partials
-    Partials partials;
-    for (const PartialsMetaData &par : discipline->partials_meta())
-    {
-        std::vector<size_t> shape;
-        for (const int64_t &dim : par.shape())
-            shape.push_back(dim);
+    grpc::Status assembly_status = assembly.Finish();
+    if (!assembly_status.ok())
+        return assembly_status;
 
-        partials[std::make_pair(par.name(), par.subname())] = Variable(kOutput, shape);
-    }
+    // Set context for discipline to check cancellation during compute
+    ContextScope context_scope(discipline, context);
 
-    // Check for cancellation before expensive computation
-    if (context && context->IsCancelled())
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
     {
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
     }
 
-    // Set context for discipline to check cancellation during compute
-    discipline->SetContext(context);
-
     // call the discipline developer-defined Compute function
     try
     {
-        implementation_->ComputeResidualGradients(inputs, outputs, partials);
+        implementation->ComputeResidualGradients(inputs, outputs, partials);
     }
     catch (const std::exception &e)
     {
@@ -987,6 +1530,29 @@ grpc::Status philote::ImplicitServer::ComputeResidualGradientsImpl(grpc::ServerC
         return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
     }
 
+    // sparse partials are expanded for clients without sparse partial support
+    const bool sparse = FindClientMetadata(context, kSparsePartialsMetadataKey) == "1";
+    const PartialsSparsity &sparsity = discipline->partials_sparsity();
+
+    // the workers serialize the next partials while the current one is written
+    ThreadPool *pool = shared ? nullptr : implementation_->assembly_pool();
+    if (pool and partials.size() > 1)
+    {
+        try
+        {
+            SendPartialsInOrder(*pool, partials, sparse ? nullptr : &sparsity, discipline->stream_opts().num_double(),
+                                precision, context,
+                                [stream](const philote::Array &message)
+                                { return stream->Write(message); });
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL, e.what());
+        }
+
+        return grpc::Status::OK;
+    }
+
     // iterate through partials
     for (const auto &par : partials)
     {
@@ -994,7 +1560,16 @@ grpc::Status philote::ImplicitServer::ComputeResidualGradientsImpl(grpc::ServerC
         const std::string &subname = par.first.second;
         try
         {
-            par.second.Send(name, subname, stream, discipline->stream_opts().num_double(), context);
+            auto pattern = sparse ? sparsity.end() : sparsity.find(par.first);
+            Variable dense;
+            if (pattern != sparsity.end())
+                dense = pattern->second.Densify(par.second);
+            const Variable &values = pattern == sparsity.end() ? par.second : dense;
+
+            if (shared)
+                shared.Send(name, subname, values, stream);
+            else
+                values.Send(name, subname, stream, discipline->stream_opts().num_double(), context, precision);
         }
         catch (const std::exception &e)
         {
@@ -1003,5 +1578,243 @@ grpc::Status philote::ImplicitServer::ComputeResidualGradientsImpl(grpc::ServerC
         }
     }
 
+    return grpc::Status::OK;
+}
+
+template<typename StreamType>
+grpc::Status philote::ImplicitServer::ComputeJacobianProductImpl(grpc::ServerContextBase *context,
+                                                                 StreamType *stream, bool reverse)
+{
+    // obtain an instance of the discipline for this call
+    InstancePool<ImplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
+    {
+        return acquired;
+    }
+
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
+
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
+    if (!discipline)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
+    }
+
+    // forward seeds are in the space of the inputs and outputs and the
+    // products are residuals; reverse mode swaps the two
+    Variables inputs, outputs, residuals, variables;
+    for (const VariableMetaData &var : discipline->var_meta())
+    {
+        if (var.type() == kInput)
+        {
+            inputs[var.name()] = Variable(var);
+            variables[var.name()] = Variable(var);
+        }
+        else if (var.type() == kOutput)
+        {
+            outputs[var.name()] = Variable(var);
+            variables[var.name()] = Variable(var);
+            residuals[var.name()] = Variable(var);
+        }
+    }
+    Variables seeds = reverse ? residuals : variables;
+    Variables products = reverse ? variables : residuals;
+
+    philote::Array array;
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
+
+    while (stream->Read(&array))
+    {
+        const std::string &name = array.name();
+
+        // seed messages are marked by their subname
+        Variables *target = &seeds;
+        if (array.subname() != kJacobianSeedSubname)
+            target = inputs.count(name) > 0 ? &inputs : &outputs;
+
+        auto var = target->find(name);
+        if (var == target->end())
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
+        }
+
+        try
+        {
+            var->second.AssignChunk(array, precision);
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Failed to assign chunk for variable " + name + ": " + e.what());
+        }
+    }
+
+    // Set context for discipline to check cancellation during compute
+    ContextScope context_scope(discipline, context);
+
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
+    }
+
+    try
+    {
+        if (reverse)
+            implementation->ComputeVecJac(inputs, outputs, seeds, products);
+        else
+            implementation->ComputeJacVec(inputs, outputs, seeds, products);
+    }
+    catch (const std::exception &e)
+    {
+        discipline->ClearContext();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                      "Failed to compute Jacobian product: " + std::string(e.what()));
+    }
+
+    // Clear context after computation
+    discipline->ClearContext();
+
+    // Check for cancellation before sending results
+    if (context && context->IsCancelled())
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
+    }
+
+    for (const auto &prod : products)
+    {
+        try
+        {
+            prod.second.Send(prod.first, "", stream, discipline->stream_opts().num_double(), context,
+                             precision);
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL,
+                          "Failed to send product " + prod.first + ": " + e.what());
+        }
+    }
+
+    return grpc::Status::OK;
+}
+
+template<typename StreamType>
+grpc::Status philote::ImplicitServer::SolveLinearImpl(grpc::ServerContextBase *context, StreamType *stream,
+                                                      bool adjoint)
+{
+    // obtain an instance of the discipline for this call
+    InstancePool<ImplicitDiscipline>::Lease implementation;
+    grpc::Status acquired = AcquireInstance(context, implementation);
+    if (!acquired.ok())
+    {
+        return acquired;
+    }
+
+    // the call runs on the CPUs of the instance (see ThreadPlacement)
+    AffinityScope placed(implementation->placement());
+
+    const auto *discipline = static_cast<philote::Discipline *>(implementation.get());
+    if (!discipline)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to cast implementation to Discipline");
+    }
+
+    // right-hand side and solution both have the shapes of the outputs
+    Variables inputs, outputs, rhs;
+    for (const VariableMetaData &var : discipline->var_meta())
+    {
+        if (var.type() == kInput)
+            inputs[var.name()] = Variable(var);
+        else if (var.type() == kOutput)
+        {
+            outputs[var.name()] = Variable(var);
+            rhs[var.name()] = Variable(var);
+        }
+    }
+    Variables solution = rhs;
+
+    philote::Array array;
+
+    // float32 chunks are only accepted if the call negotiated them
+    const WirePrecision precision = RequestedWirePrecision(context);
+
+    while (stream->Read(&array))
+    {
+        const std::string &name = array.name();
+
+        // right-hand side messages are marked by their subname
+        Variables *target = &rhs;
+        if (array.subname() != kLinearRhsSubname)
+            target = inputs.count(name) > 0 ? &inputs : &outputs;
+
+        auto var = target->find(name);
+        if (var == target->end())
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Variable not found: " + name);
+        }
+
+        try
+        {
+            var->second.AssignChunk(array, precision);
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                          "Failed to assign chunk for variable " + name + ": " + e.what());
+        }
+    }
+
+    // Set context for discipline to check cancellation during compute
+    ContextScope context_scope(discipline, context);
+
+    // Check for cancellation before expensive computation (the token is also
+    // cancelled once the inputs exceed the admission limits)
+    if (context && (context->IsCancelled() || discipline->IsCancelled()))
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before computation");
+    }
+
+    try
+    {
+        if (adjoint)
+            implementation->SolveAdjointLinear(inputs, outputs, rhs, solution);
+        else
+            implementation->SolveLinear(inputs, outputs, rhs, solution);
+    }
+    catch (const std::exception &e)
+    {
+        discipline->ClearContext();
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                      "Failed to solve linear system: " + std::string(e.what()));
+    }
+
+    // Clear context after computation
+    discipline->ClearContext();
+
+    // Check for cancellation before sending results
+    if (context && context->IsCancelled())
+    {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Request cancelled before sending results");
+    }
+
+    for (const auto &sol : solution)
+    {
+        try
+        {
+            sol.second.Send(sol.first, "", stream, discipline->stream_opts().num_double(), context,
+                            precision);
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INTERNAL,
+                          "Failed to send solution " + sol.first + ": " + e.what());
+        }
+    }
+
     return grpc::Status::OK;
 }} // namespace philote
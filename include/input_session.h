@@ -0,0 +1,262 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include <flat_variables.h>
+#include <variable.h>
+
+namespace philote
+{
+    // forward declaration
+    class ChunkPipeline;
+
+    /**
+     * @brief Input session of a compute call, as named in the client metadata
+     *
+     * Encoded as "id,base,version". The server stores the inputs of the call
+     * as the given version. A base of zero means the client sends all
+     * inputs; otherwise the client only sends the values that changed since
+     * the (stored) base version.
+     */
+    struct InputSessionRequest
+    {
+        //! session id (empty if the call does not belong to a session)
+        std::string id;
+
+        //! version the sent values are relative to (0: all values are sent)
+        uint64_t base = 0;
+
+        //! version of the inputs of this call
+        uint64_t version = 0;
+
+        /**
+         * @brief Checks whether the call only carries changed values
+         *
+         * @return true if the call belongs to a session and has a base version
+         */
+        bool IsDelta() const noexcept { return !id.empty() and base != 0; }
+    };
+
+    /**
+     * @brief Encodes an input session request as a metadata value
+     *
+     * @param request session request
+     * @return std::string "id,base,version"
+     */
+    std::string FormatInputSession(const InputSessionRequest &request);
+
+    /**
+     * @brief Decodes an input session request from a metadata value
+     *
+     * @param text metadata value (see FormatInputSession)
+     * @param request decoded request
+     * @return true if the value is well formed (non-empty id, version
+     * greater than base)
+     */
+    bool ParseInputSession(const std::string &text, InputSessionRequest &request);
+
+    /**
+     * @brief Client side of an input session
+     *
+     * Remembers the inputs of the last successful call, so subsequent calls
+     * only send the chunks of the variables that changed. For example:
+     *
+     * @code
+     *     context.AddMetadata(kInputSessionMetadataKey, session.Begin());
+     *     for (const auto &var : inputs)
+     *         if (session.Stage(var.first, var.second))
+     *             session.Send(var.first, var.second, &pipeline, chunk_size);
+     *     ...
+     *     if (status.ok())
+     *         session.Commit();
+     *     else
+     *         session.Reset();
+     * @endcode
+     *
+     * @note Thread Safety: This class is NOT thread-safe. Calls of a session
+     * must not overlap.
+     */
+    class InputSession
+    {
+    public:
+        //! Creates a session with a random id
+        InputSession();
+
+        /**
+         * @brief Returns the session id
+         *
+         * @return const std::string& random hexadecimal id
+         */
+        const std::string &id() const noexcept { return id_; }
+
+        /**
+         * @brief Starts a call
+         *
+         * @return std::string client metadata value of the call
+         */
+        std::string Begin();
+
+        /**
+         * @brief Records the value of a variable for the current call
+         *
+         * @param name variable name
+         * @param var value sent with the current call
+         * @return false if the value equals the one of the last successful
+         * call, i.e., the variable does not have to be sent (discrete
+         * variables are always sent)
+         */
+        bool Stage(const std::string &name, const Variable &var);
+
+        /**
+         * @brief Sends the chunks of a variable that changed since the last successful call
+         *
+         * Sends all chunks if the server does not have a previous value.
+         *
+         * @param name variable name
+         * @param var variable
+         * @param pipeline pipeline writing the messages
+         * @param chunk_size maximum number of doubles per message
+         * @param precision precision of the values in the messages
+         */
+        void Send(const std::string &name, const Variable &var, ChunkPipeline *pipeline, size_t chunk_size,
+                  WirePrecision precision = WirePrecision::kDouble) const;
+
+        /**
+         * @brief Checks whether the current call only sends changed values
+         *
+         * @return true if the server holds the inputs of a previous call
+         */
+        bool IsDelta() const noexcept { return base_ != 0; }
+
+        /**
+         * @brief Completes a successful call
+         *
+         * The staged values become the reference of the next call.
+         */
+        void Commit();
+
+        /**
+         * @brief Forgets all values, so the next call sends all inputs
+         */
+        void Reset() noexcept;
+
+    private:
+        //! session id
+        std::string id_;
+
+        //! version held by the server (0: none)
+        uint64_t base_ = 0;
+
+        //! version of the current call
+        uint64_t version_ = 0;
+
+        //! values of the last successful call
+        Variables sent_;
+
+        //! values staged by the current call
+        Variables staged_;
+    };
+
+    /**
+     * @brief Server side of the input sessions
+     *
+     * Keeps the inputs of the most recent call of every session, so calls
+     * that only carry changed values can restore the remaining ones.
+     * Sessions are evicted in least recently used order. Thread-safe.
+     */
+    class InputSessionCache
+    {
+    public:
+        /**
+         * @brief Constructs a cache
+         *
+         * @param capacity maximum number of sessions
+         */
+        explicit InputSessionCache(size_t capacity = 16) : capacity_(capacity) {}
+
+        /**
+         * @brief Prepares the inputs of a server call
+         *
+         * Copies the stored inputs of the base version into inputs for calls
+         * that only carry changed values.
+         *
+         * @param context server context of the call (may be nullptr)
+         * @param request receives the session request of the call (with an
+         * empty id if the call does not belong to a session)
+         * @param inputs input variables of the call
+         * @return grpc::Status INVALID_ARGUMENT for malformed requests,
+         * FAILED_PRECONDITION if the base version is not available (the
+         * client then resends all inputs)
+         */
+        grpc::Status Restore(const grpc::ServerContextBase *context, InputSessionRequest &request,
+                             FlatVariables &inputs);
+
+        /**
+         * @brief Stores the inputs of a call
+         *
+         * @param request session request of the call (ignored without an id)
+         * @param inputs received input variables
+         */
+        void Store(const InputSessionRequest &request, const FlatVariables &inputs);
+
+    private:
+        //! stored inputs of a session
+        struct Session
+        {
+            //! session id
+            std::string id;
+
+            //! version of the inputs
+            uint64_t version = 0;
+
+            //! input values (FlatVariables buffer)
+            std::vector<double> values;
+        };
+
+        //! maximum number of sessions
+        size_t capacity_;
+
+        //! guards the sessions
+        std::mutex mutex_;
+
+        //! sessions, most recently used first
+        std::list<Session> sessions_;
+    };
+}
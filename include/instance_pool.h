@@ -0,0 +1,337 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <cancellation.h>
+#include <thread_placement.h>
+
+namespace philote
+{
+    /**
+     * @brief Pool of discipline instances for serving concurrent RPCs
+     *
+     * By default, every RPC handled by a server calls into the same
+     * discipline instance. Since gRPC dispatches RPCs on a thread pool, two
+     * concurrent ComputeFunction calls would then share the instance (and its
+     * server context). An instance pool instead hands each in-flight RPC its
+     * own instance, created on demand by a user-provided factory, up to a
+     * fixed number of instances. Once all instances are in use, further RPCs
+     * wait until one is returned to the pool, or until they are cancelled or
+     * their deadline passes.
+     *
+     * The discipline that is registered with the server (the primary
+     * instance) still receives all configuration RPCs (SetOptions,
+     * SetStreamOptions, Setup). Whenever the configuration of the primary
+     * instance has changed since a pooled instance was last used, the pooled
+     * instance replays it via Discipline::CopyConfiguration before it is
+     * handed out.
+     *
+     * @tparam DisciplineType ExplicitDiscipline or ImplicitDiscipline
+     *
+     * @note Thread Safety: Acquire and the release of leases are thread-safe.
+     * Configuration RPCs should not be issued while compute RPCs are in
+     * flight, since the primary instance is read while configuring pooled
+     * instances.
+     */
+    template <class DisciplineType>
+    class InstancePool
+    {
+    public:
+        //! Function creating a new, unconfigured discipline instance
+        using Factory = std::function<std::shared_ptr<DisciplineType>()>;
+
+        /**
+         * @brief Exclusive handle to a discipline instance
+         *
+         * The instance is returned to its pool when the lease is destroyed.
+         * A lease may also wrap an instance that does not belong to a pool
+         * (e.g., the primary discipline when no pool is enabled), in which
+         * case releasing it does nothing.
+         */
+        class Lease
+        {
+        public:
+            //! Creates an empty lease
+            Lease() = default;
+
+            //! Wraps an instance that is not owned by any pool
+            explicit Lease(std::shared_ptr<DisciplineType> instance)
+                : instance_(std::move(instance)) {}
+
+            Lease(const Lease &) = delete;
+            Lease &operator=(const Lease &) = delete;
+
+            Lease(Lease &&other) noexcept
+                : pool_(other.pool_), instance_(std::move(other.instance_)), generation_(other.generation_)
+            {
+                other.pool_ = nullptr;
+            }
+
+            Lease &operator=(Lease &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    Release();
+                    pool_ = other.pool_;
+                    instance_ = std::move(other.instance_);
+                    generation_ = other.generation_;
+                    other.pool_ = nullptr;
+                }
+                return *this;
+            }
+
+            ~Lease() noexcept { Release(); }
+
+            //! Returns the leased instance (nullptr for an empty lease)
+            DisciplineType *get() const noexcept { return instance_.get(); }
+            DisciplineType *operator->() const noexcept { return instance_.get(); }
+            DisciplineType &operator*() const noexcept { return *instance_; }
+            explicit operator bool() const noexcept { return static_cast<bool>(instance_); }
+
+        private:
+            friend class InstancePool;
+
+            Lease(InstancePool *pool, std::shared_ptr<DisciplineType> instance, uint64_t generation)
+                : pool_(pool), instance_(std::move(instance)), generation_(generation) {}
+
+            void Release() noexcept
+            {
+                if (pool_ && instance_)
+                    pool_->Return(std::move(instance_), generation_);
+                pool_ = nullptr;
+                instance_.reset();
+            }
+
+            //! pool the instance is returned to (nullptr if not pooled)
+            InstancePool *pool_ = nullptr;
+
+            //! leased instance
+            std::shared_ptr<DisciplineType> instance_;
+
+            //! configuration generation the instance was configured with
+            uint64_t generation_ = 0;
+        };
+
+        /**
+         * @brief Construct a new instance pool
+         *
+         * @param factory function creating new discipline instances
+         * @param size maximum number of instances (and concurrent leases)
+         * @throws std::invalid_argument if the factory is empty or size is zero
+         */
+        InstancePool(Factory factory, size_t size)
+            : factory_(std::move(factory)), capacity_(size)
+        {
+            if (!factory_)
+                throw std::invalid_argument("Instance pool requires a discipline factory");
+            if (capacity_ == 0)
+                throw std::invalid_argument("Instance pool size must be greater than zero");
+
+            // returning an instance must not allocate
+            idle_.reserve(capacity_);
+        }
+
+        /**
+         * @brief Acquires an instance configured like the primary discipline
+         *
+         * Blocks until an instance is available. New instances are created
+         * lazily until the pool size is reached.
+         *
+         * @param primary discipline whose configuration is replayed
+         * @return Lease exclusive handle to the instance
+         * @throws std::runtime_error if the factory returns a null instance;
+         * exceptions from the factory or from configuring the instance are
+         * propagated
+         */
+        Lease Acquire(const DisciplineType &primary)
+        {
+            return Acquire(primary, std::chrono::system_clock::time_point::max(), CancellationToken());
+        }
+
+        /**
+         * @brief Acquires an instance unless the call ends first
+         *
+         * Waits until an instance is available, the deadline has passed, or
+         * the token is cancelled. The token is polled while waiting.
+         *
+         * @param primary discipline whose configuration is replayed
+         * @param deadline time at which to give up waiting
+         * @param cancellation token of the call the instance is acquired for
+         * @return Lease exclusive handle to the instance (empty if the wait
+         * was given up)
+         * @throws std::runtime_error if the factory returns a null instance;
+         * exceptions from the factory or from configuring the instance are
+         * propagated
+         */
+        Lease Acquire(const DisciplineType &primary, std::chrono::system_clock::time_point deadline,
+                      const CancellationToken &cancellation)
+        {
+            std::shared_ptr<DisciplineType> instance;
+            uint64_t generation = 0;
+            bool configured = false;
+            std::vector<int> cpus;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                while (idle_.empty() && created_ >= capacity_)
+                {
+                    const auto now = std::chrono::system_clock::now();
+                    if (cancellation.IsCancelled() || now >= deadline)
+                        return Lease();
+
+                    // cancellations are not signalled, so the wait is sliced
+                    available_.wait_until(lock, std::min(deadline, now + kWaitSlice));
+                }
+
+                if (!idle_.empty())
+                {
+                    instance = std::move(idle_.back().instance);
+                    generation = idle_.back().generation;
+                    configured = true;
+                    idle_.pop_back();
+                }
+                else
+                {
+                    // reserve the slot, the instance itself is created below
+                    // without holding the lock
+                    if (!placement_.empty())
+                        cpus = placement_[created_ % placement_.size()];
+                    created_++;
+                }
+            }
+
+            try
+            {
+                if (!instance)
+                {
+                    // the instance allocates its state on its own CPUs
+                    AffinityScope placed(cpus);
+                    instance = factory_();
+                    if (!instance)
+                        throw std::runtime_error("Instance pool factory returned a null discipline");
+                    instance->SetPlacement(cpus);
+                }
+
+                const uint64_t current = primary.configuration_generation();
+                if (!configured || generation != current)
+                {
+                    AffinityScope placed(instance->placement());
+                    instance->CopyConfiguration(primary);
+                    generation = current;
+                }
+            }
+            catch (...)
+            {
+                // give the slot back so that a later call can retry
+                std::lock_guard<std::mutex> lock(mutex_);
+                created_--;
+                available_.notify_one();
+                throw;
+            }
+
+            return Lease(this, std::move(instance), generation);
+        }
+
+        /**
+         * @brief Places the instances on CPU sets
+         *
+         * Instances are assigned to the sets round-robin in the order they
+         * are created (see PlacementSlots). Instances created before the
+         * call keep their placement.
+         *
+         * @param slots CPU sets (empty leaves new instances unplaced)
+         */
+        void SetPlacement(std::vector<std::vector<int>> slots)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            placement_ = std::move(slots);
+        }
+
+        //! Maximum number of instances in the pool
+        size_t size() const noexcept { return capacity_; }
+
+        //! Number of instances created so far
+        size_t created() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return created_;
+        }
+
+    private:
+        //! longest wait before the cancellation token is checked again
+        static constexpr std::chrono::milliseconds kWaitSlice{5};
+
+        //! an instance that is currently not leased
+        struct IdleInstance
+        {
+            std::shared_ptr<DisciplineType> instance;
+            uint64_t generation;
+        };
+
+        void Return(std::shared_ptr<DisciplineType> instance, uint64_t generation) noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            idle_.push_back({std::move(instance), generation});
+            available_.notify_one();
+        }
+
+        //! function creating new instances
+        Factory factory_;
+
+        //! maximum number of instances
+        size_t capacity_;
+
+        //! number of instances created (leased or idle)
+        size_t created_ = 0;
+
+        //! CPU sets the instances are placed on
+        std::vector<std::vector<int>> placement_;
+
+        //! instances that are ready to be leased
+        std::vector<IdleInstance> idle_;
+
+        //! protects created_, idle_, and placement_
+        mutable std::mutex mutex_;
+
+        //! signalled whenever an instance is returned
+        std::condition_variable available_;
+    };
+}
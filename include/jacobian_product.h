@@ -0,0 +1,109 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <vector>
+
+#include <newton_solver.h>
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @brief Multiplies partials with a vector (Jacobian-vector product)
+     *
+     * Computes products[f] = sum over x of df/dx * seeds[x] for all partials
+     * (f, x). Sparse partials hold their non-zeros (see SparsityPattern).
+     * Variables without seed values contribute nothing.
+     *
+     * @param partials partials of the functions with respect to the variables
+     * @param sparsity sparsity patterns of the sparse partials
+     * @param seeds vector to multiply, by variable
+     * @param products preallocated products, by function (overwritten)
+     * @throws std::out_of_range if a function of the partials has no product
+     * @throws std::length_error if a partial does not match the variable sizes
+     */
+    void MultiplyJacobian(const Partials &partials, const PartialsSparsity &sparsity,
+                          const Variables &seeds, Variables &products);
+
+    /**
+     * @brief Multiplies a vector with partials (vector-Jacobian product)
+     *
+     * Computes products[x] = sum over f of seeds[f]^T * df/dx for all partials
+     * (f, x), i.e., the transposed Jacobian applied to the seeds.
+     *
+     * @param partials partials of the functions with respect to the variables
+     * @param sparsity sparsity patterns of the sparse partials
+     * @param seeds vector to multiply, by function
+     * @param products preallocated products, by variable (overwritten)
+     * @throws std::out_of_range if a variable of the partials has no product
+     * @throws std::length_error if a partial does not match the variable sizes
+     */
+    void MultiplyJacobianTranspose(const Partials &partials, const PartialsSparsity &sparsity,
+                                   const Variables &seeds, Variables &products);
+
+    /**
+     * @brief Copies variables into a vector
+     *
+     * The variables are laid out one after the other in name order (the
+     * layout of AssembleJacobian).
+     *
+     * @param vars variables to copy
+     * @param values receives the values (resized to the total size)
+     */
+    void Flatten(const Variables &vars, std::vector<double> &values);
+
+    /**
+     * @brief Copies a vector laid out by Flatten into variables
+     *
+     * @param values values of all variables
+     * @param vars preallocated variables (overwritten)
+     * @throws std::length_error if the sizes do not match
+     */
+    void Unflatten(const std::vector<double> &values, Variables &vars);
+
+    /**
+     * @brief Assembles the partials among a set of variables into a matrix
+     *
+     * Rows and columns follow the layout of Flatten(unknowns); partials of or
+     * with respect to other variables are skipped (e.g., dR/dy of an
+     * implicit discipline with the outputs as unknowns).
+     *
+     * @param partials partials (non-zeros for sparse partials)
+     * @param sparsity sparsity patterns of the sparse partials
+     * @param unknowns variables that define the layout
+     * @param matrix receives the matrix (cleared first)
+     * @param transpose whether to assemble the transposed matrix
+     * @return size_t number of assembled partials
+     */
+    size_t AssembleJacobian(const Partials &partials, const PartialsSparsity &sparsity,
+                            const Variables &unknowns, CoordinateMatrix &matrix, bool transpose = false);
+}
@@ -0,0 +1,97 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include <protocol_extensions.h>
+
+namespace philote
+{
+    class Discipline;
+
+    /**
+     * @name Local transports
+     *
+     * Helpers for clients and servers on the same host. Unix domain sockets
+     * and in-process channels bypass the TCP stack; in-process channels also
+     * skip the socket layer entirely.
+     * @{
+     */
+
+    /**
+     * @brief Returns the gRPC address of a Unix domain socket
+     *
+     * @param path file system path of the socket
+     * @return std::string address for ServerBuilder::AddListeningPort and grpc::CreateChannel
+     */
+    std::string UnixSocketAddress(const std::string &path);
+
+    /**
+     * @brief Creates a channel to a server listening on a Unix domain socket
+     *
+     * @param path file system path of the socket
+     * @param max_message_bytes maximum message size of the channel
+     * @return std::shared_ptr<grpc::Channel> channel for ConnectChannel
+     */
+    std::shared_ptr<grpc::Channel> CreateUnixSocketChannel(const std::string &path,
+                                                           size_t max_message_bytes = kDefaultMaxMessageBytes);
+
+    /**
+     * @brief Starts a server whose services are registered with a builder
+     *
+     * The returned server keeps the discipline owning the services alive
+     * and shuts down when the last reference is released.
+     *
+     * @param builder builder with the registered services (and listening ports, if any)
+     * @param discipline discipline that registered its services
+     * @return std::shared_ptr<grpc::Server> running server
+     * @throws std::runtime_error if the server cannot be started
+     */
+    std::shared_ptr<grpc::Server> StartDisciplineServer(grpc::ServerBuilder &builder,
+                                                        std::shared_ptr<Discipline> discipline);
+
+    /**
+     * @brief Creates a channel to a server in the same process
+     *
+     * @param server running server
+     * @param max_message_bytes maximum message size of the channel
+     * @return std::shared_ptr<grpc::Channel> channel for ConnectChannel
+     */
+    std::shared_ptr<grpc::Channel> CreateInProcessChannel(grpc::Server &server,
+                                                          size_t max_message_bytes = kDefaultMaxMessageBytes);
+
+    /** @} */
+}
@@ -0,0 +1,148 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace philote
+{
+    /**
+     * @brief File mapped into memory as an array of doubles
+     *
+     * Backs variables that are too large to be held in memory (e.g., full
+     * field snapshots). The operating system pages the values in when they
+     * are accessed and writes them back to the file, so only the pages in use
+     * count towards the resident memory. Release() drops pages that are not
+     * needed anymore (Variable::Send and Variable::AssignChunk release every
+     * chunk they process).
+     *
+     * @par Example
+     * @code
+     * auto file = philote::MappedFile::Create("/scratch/snapshot.bin", n);
+     * philote::Variable snapshot(philote::kOutput, {n}, file);
+     * @endcode
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * @brief Creates (or resizes) a file and maps it
+         *
+         * Existing values are kept; new values are zero.
+         *
+         * @param path file path
+         * @param size number of doubles
+         * @return std::shared_ptr<MappedFile> mapped file, kept on destruction
+         * @throws std::runtime_error if the file cannot be created or mapped
+         */
+        static std::shared_ptr<MappedFile> Create(const std::string &path, size_t size);
+
+        /**
+         * @brief Creates an anonymous file in a directory and maps it
+         *
+         * The file is removed right away, so its storage is reclaimed once
+         * the mapping is destroyed (even if the process terminates).
+         *
+         * @param directory directory on the file system holding the values
+         * @param size number of doubles (all zero)
+         * @return std::shared_ptr<MappedFile> mapped file
+         * @throws std::runtime_error if the file cannot be created or mapped
+         */
+        static std::shared_ptr<MappedFile> CreateTemporary(const std::string &directory, size_t size);
+
+        //! Unmaps and closes the file
+        ~MappedFile() noexcept;
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        //! Returns the number of doubles in the file
+        size_t size() const noexcept { return size_; }
+
+        //! Returns the mapped storage
+        double *data() noexcept { return data_; }
+
+        //! Returns the mapped storage
+        const double *data() const noexcept { return data_; }
+
+        /**
+         * @brief Drops the pages of a range of values from memory
+         *
+         * The values are kept in the file and paged in again when accessed.
+         * Only pages that lie entirely within the range are dropped.
+         *
+         * @param start first value of the range
+         * @param end last value of the range (inclusive)
+         */
+        void Release(size_t start, size_t end) const noexcept;
+
+        /**
+         * @brief Sets all values to zero without touching the pages
+         *
+         * @throws std::runtime_error if the file cannot be truncated
+         */
+        void Zero();
+
+    private:
+        MappedFile(int fd, double *data, size_t size) : fd_(fd), data_(data), size_(size) {}
+
+        //! file descriptor (kept open to zero the file)
+        int fd_;
+
+        //! mapped storage
+        double *data_;
+
+        //! number of doubles
+        size_t size_;
+    };
+
+    /**
+     * @brief Placement of large variables in memory-mapped files
+     *
+     * Variables with at least min_size values are stored in anonymous files
+     * in the directory (see MappedFile::CreateTemporary). An empty directory
+     * keeps all variables in memory.
+     */
+    struct FileStorage
+    {
+        //! directory of the files (empty: in memory)
+        std::string directory;
+
+        //! smallest number of values stored in a file
+        size_t min_size = 0;
+
+        //! Returns whether a variable of the given size is stored in a file
+        bool Applies(size_t size) const noexcept { return !directory.empty() and size > 0 and size >= min_size; }
+    };
+}
@@ -0,0 +1,89 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <data.pb.h>
+
+namespace philote
+{
+    /**
+     * @brief Name index of a list of variable meta data
+     *
+     * Maps each variable name to the position of its first entry, so that
+     * lookups do not scan the list. The index is kept next to the list it
+     * describes and is extended with Update after entries were appended.
+     * Lists whose size differs from the index (e.g., entries appended
+     * without an Update) are searched linearly. Other modifications of the
+     * list require Clear and Update.
+     *
+     * @note Thread Safety: Find may be called concurrently; Update and Clear
+     * must not overlap with any other call.
+     */
+    class VariableMetaIndex
+    {
+    public:
+        /**
+         * @brief Indexes the entries appended since the previous update
+         *
+         * Rebuilds the index if the list shrank.
+         *
+         * @param meta indexed list
+         */
+        void Update(const std::vector<VariableMetaData> &meta);
+
+        /**
+         * @brief Removes all entries from the index
+         */
+        void Clear() noexcept;
+
+        /**
+         * @brief Finds the meta data of a variable
+         *
+         * @param meta indexed list
+         * @param name variable name
+         * @return const VariableMetaData* first entry with the name (nullptr
+         * if there is none)
+         */
+        const VariableMetaData *Find(const std::vector<VariableMetaData> &meta, const std::string &name) const;
+
+    private:
+        //! position of the first entry of each name
+        std::unordered_map<std::string, size_t> positions_;
+
+        //! number of list entries covered by the index
+        size_t indexed_ = 0;
+    };
+} // namespace philote
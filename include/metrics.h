@@ -0,0 +1,247 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/support/sync_stream.h>
+
+#include <data.pb.h>
+
+namespace philote
+{
+    /**
+     * @brief Measurements of one compute RPC on the server
+     *
+     * The phases are delimited by the stream: the receive phase ends when
+     * the client has finished sending, the compute phase ends with the first
+     * response message (or with the RPC if nothing was sent), and the send
+     * phase covers the remaining time. With the callback server engine, the
+     * client messages are buffered before the evaluation starts, so the
+     * receive phase only covers reading the buffer.
+     */
+    struct CallMetrics
+    {
+        //! RPC name (e.g., "ComputeFunction")
+        std::string rpc;
+
+        //! time spent receiving and assembling the inputs
+        std::chrono::nanoseconds receive{0};
+
+        //! time from the last input to the first response message
+        std::chrono::nanoseconds compute{0};
+
+        //! time from the first response message to the end of the RPC
+        std::chrono::nanoseconds send{0};
+
+        //! number of messages received from the client
+        uint64_t messages_received = 0;
+
+        //! serialized size of the messages received from the client
+        uint64_t bytes_received = 0;
+
+        //! number of messages sent to the client
+        uint64_t messages_sent = 0;
+
+        //! serialized size of the messages sent to the client
+        uint64_t bytes_sent = 0;
+
+        //! status code the RPC finished with
+        grpc::StatusCode status = grpc::StatusCode::OK;
+    };
+
+    /**
+     * @brief Receives the measurements of the compute RPCs
+     *
+     * Set on a discipline with Discipline::SetMetricsRecorder. Record is
+     * called once per RPC after it has finished, possibly from several
+     * threads at the same time.
+     */
+    class MetricsRecorder
+    {
+    public:
+        //! Destructor
+        virtual ~MetricsRecorder() = default;
+
+        /**
+         * @brief Records the measurements of a finished RPC
+         *
+         * @param call measurements of the RPC
+         */
+        virtual void Record(const CallMetrics &call) = 0;
+    };
+
+    /**
+     * @brief Accumulated measurements of all calls of one RPC
+     */
+    struct RpcMetrics
+    {
+        //! number of calls
+        uint64_t calls = 0;
+
+        //! number of calls that failed (other than by cancellation)
+        uint64_t errors = 0;
+
+        //! number of cancelled calls
+        uint64_t cancellations = 0;
+
+        //! total receive time
+        std::chrono::nanoseconds receive{0};
+
+        //! total compute time
+        std::chrono::nanoseconds compute{0};
+
+        //! total send time
+        std::chrono::nanoseconds send{0};
+
+        //! total number of messages received
+        uint64_t messages_received = 0;
+
+        //! total number of bytes received
+        uint64_t bytes_received = 0;
+
+        //! total number of messages sent
+        uint64_t messages_sent = 0;
+
+        //! total number of bytes sent
+        uint64_t bytes_sent = 0;
+    };
+
+    /**
+     * @brief Thread-safe recorder that accumulates the measurements per RPC
+     *
+     * @par Example
+     * @code
+     * auto metrics = std::make_shared<philote::MetricsRegistry>();
+     * discipline->SetMetricsRecorder(metrics);
+     * discipline->RegisterServices(builder);
+     * ...
+     * std::cout << metrics->ToPrometheusText();
+     * @endcode
+     */
+    class MetricsRegistry : public MetricsRecorder
+    {
+    public:
+        void Record(const CallMetrics &call) override;
+
+        /**
+         * @brief Returns the accumulated measurements keyed by RPC name
+         */
+        std::map<std::string, RpcMetrics> Snapshot() const;
+
+        /**
+         * @brief Formats the accumulated measurements as Prometheus text
+         *
+         * Uses the Prometheus text exposition format (counters with rpc,
+         * phase, and direction labels), so the result can be served
+         * unchanged by an HTTP metrics endpoint.
+         *
+         * @return std::string
+         */
+        std::string ToPrometheusText() const;
+
+        /**
+         * @brief Discards all measurements
+         */
+        void Reset();
+
+    private:
+        //! guards rpcs_
+        mutable std::mutex mutex_;
+
+        //! accumulated measurements per RPC
+        std::map<std::string, RpcMetrics> rpcs_;
+    };
+
+    /**
+     * @brief Server stream that measures the messages and phases of an RPC
+     *
+     * Forwards all calls to the wrapped stream.
+     */
+    class MeteredArrayStream : public grpc::ServerReaderWriterInterface<Array, Array>
+    {
+    public:
+        using grpc::internal::WriterInterface<Array>::Write;
+
+        /**
+         * @brief Starts measuring an RPC
+         *
+         * @param stream stream of the RPC
+         */
+        explicit MeteredArrayStream(grpc::ServerReaderWriterInterface<Array, Array> *stream);
+
+        /**
+         * @brief Ends the measurement
+         *
+         * @param rpc RPC name
+         * @param status status the RPC finished with
+         * @return CallMetrics
+         */
+        CallMetrics Finish(const std::string &rpc, const grpc::Status &status);
+
+        void SendInitialMetadata() override;
+
+        bool Write(const Array &msg, grpc::WriteOptions options) override;
+
+        bool NextMessageSize(uint32_t *sz) override;
+
+        bool Read(Array *msg) override;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        //! wrapped stream
+        grpc::ServerReaderWriterInterface<Array, Array> *stream_;
+
+        //! measurements so far
+        CallMetrics metrics_;
+
+        //! start of the RPC
+        Clock::time_point start_;
+
+        //! end of the receive phase
+        Clock::time_point received_;
+
+        //! first response message
+        Clock::time_point first_write_;
+
+        //! whether the client has finished sending
+        bool inputs_done_ = false;
+
+        //! whether a response message was sent
+        bool writing_ = false;
+    };
+}
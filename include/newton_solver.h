@@ -0,0 +1,240 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace philote
+{
+    /**
+     * @brief Square matrix in coordinate form
+     *
+     * Entries with the same row and column are summed. Clearing keeps the
+     * storage, so a matrix assembled repeatedly does not reallocate.
+     */
+    struct CoordinateMatrix
+    {
+        //! number of rows and columns
+        size_t size = 0;
+
+        //! row of each entry
+        std::vector<size_t> rows;
+
+        //! column of each entry
+        std::vector<size_t> cols;
+
+        //! value of each entry
+        std::vector<double> values;
+
+        /**
+         * @brief Removes all entries and sets the size
+         */
+        void Clear(size_t n);
+
+        /**
+         * @brief Adds an entry
+         *
+         * @throws std::out_of_range if row or col is not below size
+         */
+        void Add(size_t row, size_t col, double value);
+    };
+
+    /**
+     * @brief Solves linear systems with a factorized matrix
+     *
+     * Used by NewtonSolver for the Newton steps. Custom solvers (e.g., of an
+     * external library) derive from this class.
+     */
+    class LinearSolver
+    {
+    public:
+        virtual ~LinearSolver() = default;
+
+        /**
+         * @brief Factorizes a matrix for subsequent solves
+         *
+         * @throws std::runtime_error if the matrix is singular
+         */
+        virtual void Factorize(const CoordinateMatrix &matrix) = 0;
+
+        /**
+         * @brief Solves A x = b with the factorized matrix A
+         *
+         * @param rhs right-hand side b, overwritten with the solution x
+         */
+        virtual void Solve(std::vector<double> &rhs) const = 0;
+    };
+
+    /**
+     * @brief LU factorization with partial pivoting of the dense matrix
+     */
+    class DenseLUSolver : public LinearSolver
+    {
+    public:
+        void Factorize(const CoordinateMatrix &matrix) override;
+        void Solve(std::vector<double> &rhs) const override;
+
+    private:
+        //! number of rows and columns
+        size_t size_ = 0;
+
+        //! row-major L (unit diagonal, below) and U (on and above the diagonal)
+        std::vector<double> lu_;
+
+        //! row swapped with each row during the factorization
+        std::vector<size_t> pivots_;
+    };
+
+    /**
+     * @brief LU factorization with partial pivoting that stores only non-zeros
+     *
+     * Suited for large residual Jacobians with few non-zeros per row (e.g.,
+     * declared as sparse partials). Fill-in is stored as it is created.
+     */
+    class SparseLUSolver : public LinearSolver
+    {
+    public:
+        void Factorize(const CoordinateMatrix &matrix) override;
+        void Solve(std::vector<double> &rhs) const override;
+
+    private:
+        //! non-zeros of a row as (column, value), sorted by column
+        using SparseRow = std::vector<std::pair<size_t, double>>;
+
+        //! upper triangular factor (diagonal first in every row)
+        std::vector<SparseRow> upper_;
+
+        //! original row used as pivot in each step of the factorization
+        std::vector<size_t> order_;
+
+        //! elimination steps as (original row, multiplier) per pivot
+        std::vector<std::vector<std::pair<size_t, double>>> steps_;
+
+        //! right-hand side during a solve
+        mutable std::vector<double> work_;
+    };
+
+    /**
+     * @brief Iteration of the nonlinear solver
+     */
+    enum class NonlinearMethod
+    {
+        //! recomputes and factorizes the Jacobian in every iteration
+        kNewton,
+
+        //! factorizes the Jacobian once and applies rank-one updates
+        kBroyden
+    };
+
+    /**
+     * @brief Settings of NewtonSolver
+     */
+    struct NewtonOptions
+    {
+        NonlinearMethod method = NonlinearMethod::kNewton;
+
+        //! maximum number of iterations
+        size_t max_iterations = 50;
+
+        //! converged once the residual norm is at most this value
+        double absolute_tolerance = 1e-10;
+
+        //! converged once the residual norm decreased by this factor
+        double relative_tolerance = 1e-10;
+
+        //! Broyden updates before the Jacobian is recomputed
+        size_t broyden_restart = 20;
+
+        //! creates the linear solver (nullptr uses DenseLUSolver)
+        std::function<std::unique_ptr<LinearSolver>()> linear_solver;
+    };
+
+    /**
+     * @brief Creates the linear solver configured in the options
+     *
+     * @throws std::invalid_argument if the factory returns no solver
+     */
+    std::unique_ptr<LinearSolver> CreateLinearSolver(const NewtonOptions &options);
+
+    /**
+     * @brief Newton (or Broyden) solver of R(y) = 0
+     *
+     * The residuals and the Jacobian are provided through callbacks. The
+     * vectors, the assembled Jacobian, and the linear solver are kept between
+     * iterations and solves.
+     */
+    class NewtonSolver
+    {
+    public:
+        //! Computes the residuals r at y
+        using ResidualFunction = std::function<void(const std::vector<double> &y, std::vector<double> &r)>;
+
+        //! Assembles the Jacobian dR/dy at y into a cleared matrix
+        using JacobianFunction = std::function<void(const std::vector<double> &y, CoordinateMatrix &jacobian)>;
+
+        /**
+         * @brief Solves the system in place
+         *
+         * @param options solver settings
+         * @param y initial guess, overwritten with the solution
+         * @param residual residual callback
+         * @param jacobian Jacobian callback
+         * @return size_t number of iterations
+         * @throws std::runtime_error if the iterations do not converge or the
+         * Jacobian is singular
+         */
+        size_t Solve(const NewtonOptions &options, std::vector<double> &y,
+                     const ResidualFunction &residual, const JacobianFunction &jacobian);
+
+    private:
+        //! Applies the (updated) inverse Jacobian to v in place
+        void ApplyInverse(std::vector<double> &v) const;
+
+        //! linear solver of the current solve
+        std::unique_ptr<LinearSolver> solver_;
+
+        //! assembled Jacobian
+        CoordinateMatrix jacobian_;
+
+        //! residuals at the current and previous iterate
+        std::vector<double> residuals_, previous_;
+
+        //! Newton step
+        std::vector<double> step_;
+
+        //! Broyden updates H += u s^T H as (u, s)
+        std::vector<std::pair<std::vector<double>, std::vector<double>>> updates_;
+    };
+}
@@ -0,0 +1,107 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <functional>
+#include <set>
+#include <string>
+
+#include <flat_variables.h>
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @brief Sends outputs to the client while Compute is still running
+     *
+     * Passed to ExplicitDiscipline::ComputeStreaming. Once the discipline
+     * has finished an output, Finalize sends it right away instead of after
+     * Compute returns. Outputs that were not finalized are sent when Compute
+     * returns. Values written to an output after it was finalized are not
+     * sent.
+     *
+     * @par Example
+     * @code
+     * void ComputeStreaming(const philote::FlatVariables &inputs,
+     *                       philote::FlatVariables &outputs,
+     *                       philote::OutputWriter &writer) override
+     * {
+     *     outputs.at("a")(0) = ...;
+     *     writer.Finalize("a");  // the client receives a now
+     *
+     *     outputs.at("b")(0) = ...;  // sent after ComputeStreaming returns
+     * }
+     * @endcode
+     */
+    class OutputWriter
+    {
+    public:
+        //! Sends an output (name, value) to the client
+        using SendFunction = std::function<void(const std::string &, const Variable &)>;
+
+        /**
+         * @brief Constructs a writer
+         *
+         * @param outputs outputs of the call
+         * @param send function sending an output to the client
+         */
+        OutputWriter(FlatVariables &outputs, SendFunction send);
+
+        /**
+         * @brief Marks an output as final and sends it
+         *
+         * Finalizing an output more than once has no effect.
+         *
+         * @param name output name
+         * @throws std::out_of_range if the output does not exist
+         * @throws std::runtime_error if the output could not be sent
+         */
+        void Finalize(const std::string &name);
+
+        /**
+         * @brief Returns whether an output has been finalized
+         *
+         * @param name output name
+         * @return true if the output was sent by Finalize
+         */
+        bool IsFinal(const std::string &name) const noexcept;
+
+    private:
+        //! outputs of the call
+        FlatVariables &outputs_;
+
+        //! function sending an output
+        SendFunction send_;
+
+        //! finalized outputs
+        std::set<std::string> final_;
+    };
+}
@@ -0,0 +1,170 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grpcpp/server_context.h>
+#include <grpcpp/support/status.h>
+
+#include <thread_pool.h>
+#include <variable.h>
+
+#include <data.pb.h>
+
+namespace philote
+{
+    class InputReadyTracker;
+    class SharedMemoryTransfer;
+
+    /**
+     * @brief Assigns the messages of a compute RPC on a worker pool
+     *
+     * The RPC thread keeps reading the stream while the workers copy the
+     * values of the previous messages into their variables. Messages of the
+     * same variable are assigned in the order they were received, messages of
+     * different variables concurrently. The number of messages waiting for a
+     * worker is bounded, so a fast client cannot make the server buffer the
+     * whole request.
+     *
+     * Without a pool the tasks are executed right away on the calling thread.
+     * The objects referenced by the tasks must outlive the assembly, i.e., the
+     * assembly must be declared after them.
+     */
+    class ParallelAssembly
+    {
+    public:
+        //! Assigns one message (executed on a worker)
+        using Task = std::function<grpc::Status(const Array &message)>;
+
+        /**
+         * @brief Constructs the assembly of one RPC
+         *
+         * @param pool worker pool (nullptr assigns the messages inline)
+         */
+        explicit ParallelAssembly(ThreadPool *pool);
+
+        //! Waits for the queued tasks
+        ~ParallelAssembly() noexcept;
+
+        ParallelAssembly(const ParallelAssembly &) = delete;
+        ParallelAssembly &operator=(const ParallelAssembly &) = delete;
+
+        /**
+         * @brief Queues the assignment of a message
+         *
+         * The contents of the message are moved to the queue and the message
+         * is replaced by a cleared one, so the caller can read the next
+         * message into it. Blocks while too many messages are queued.
+         *
+         * @param variable variable the message belongs to
+         * @param message received message
+         * @param task assignment of the message
+         * @return grpc::Status the first error of any task so far
+         */
+        grpc::Status Submit(std::string variable, Array &message, Task task);
+
+        /**
+         * @brief Waits until all queued messages are assigned
+         *
+         * @return grpc::Status the first error of any task
+         */
+        grpc::Status Finish();
+
+    private:
+        struct State;
+
+        //! pool executing the tasks (nullptr if inline)
+        ThreadPool *pool_;
+
+        //! queues shared with the workers
+        std::shared_ptr<State> state_;
+    };
+
+    /**
+     * @brief Creates the task assigning a message of a compute RPC to a variable
+     *
+     * The task assigns the chunk (or the values announced through shared
+     * memory) and records the received values with the tracker.
+     *
+     * @param shared shared memory transfer of the RPC
+     * @param ready input ready tracker of the RPC
+     * @param value variable the message belongs to
+     * @param kind kind of the variable used in error messages (e.g., "input")
+     * @param precision precision negotiated by the RPC
+     * @return ParallelAssembly::Task
+     */
+    ParallelAssembly::Task AssignTask(SharedMemoryTransfer &shared, InputReadyTracker &ready,
+                                      Variable &value, const std::string &kind,
+                                      WirePrecision precision = WirePrecision::kDouble);
+
+    /**
+     * @brief Serializes variables on a worker pool and writes them in order
+     *
+     * The workers build the messages of up to lookahead variables ahead of
+     * the one being written, so the serialization overlaps with the writes of
+     * the calling thread. Exceptions of serialize are rethrown on the calling
+     * thread when their variable is due; all tasks have finished when the
+     * function returns.
+     *
+     * @param pool worker pool
+     * @param count number of variables
+     * @param serialize appends the messages of variable i (executed on a worker)
+     * @param write writes the messages of variable i (executed in order)
+     */
+    void SerializeInOrder(ThreadPool &pool, size_t count,
+                          const std::function<void(size_t, std::vector<Array> &)> &serialize,
+                          const std::function<void(size_t, std::vector<Array> &)> &write);
+
+    /**
+     * @brief Sends partials while the workers serialize the next ones
+     *
+     * Produces the same messages as sending the partials one after another
+     * with Variable::Send (see SerializeInOrder).
+     *
+     * @param pool worker pool
+     * @param partials partials to send
+     * @param sparsity sparsity patterns of partials to expand to dense
+     * values (nullptr sends the values as they are)
+     * @param chunk_size number of values per message
+     * @param precision precision of the values in the messages
+     * @param context server context checked for cancellation (may be nullptr)
+     * @param write writes a message, returns false if the stream is closed
+     * @throws std::runtime_error naming the partial that could not be sent
+     */
+    void SendPartialsInOrder(ThreadPool &pool, const Partials &partials, const PartialsSparsity *sparsity,
+                             size_t chunk_size, WirePrecision precision, grpc::ServerContextBase *context,
+                             const std::function<bool(const Array &)> &write);
+}
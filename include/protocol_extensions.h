@@ -0,0 +1,455 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @name Protocol extensions
+     *
+     * Philote-Cpp supports a number of optional extensions on top of the
+     * Philote MDO protocol (e.g., batched function evaluations). Extensions do
+     * not change the protobuf messages. Instead, servers advertise the
+     * extensions they support in the trailing metadata of the GetInfo RPC,
+     * and clients opt into an extension for an individual call via client
+     * metadata. Clients only use an extension if the server advertised it,
+     * so Philote-Cpp clients and servers remain compatible with any other
+     * Philote implementation.
+     * @{
+     */
+
+    //! GetInfo trailing metadata key listing the supported extensions (comma-separated)
+    constexpr char kFeaturesMetadataKey[] = "philote-features";
+
+    //! Extension: multiple design points per ComputeFunction call
+    constexpr char kFeatureBatch[] = "batch";
+
+    //! Client metadata key carrying the number of design points of a batched call
+    constexpr char kBatchSizeMetadataKey[] = "philote-batch-size";
+
+    //! Maximum number of design points in a single batched call
+    constexpr size_t kMaxBatchSize = 65536;
+
+    //! Extension: partials that only carry their declared non-zeros
+    constexpr char kFeatureSparsePartials[] = "sparse-partials";
+
+    //! Client metadata key requesting sparse partials ("1") for GetPartialDefinitions and gradient calls
+    constexpr char kSparsePartialsMetadataKey[] = "philote-sparse-partials";
+
+    /**
+     * @brief First shape entry of a sparsity pattern message
+     *
+     * With sparse partials, GetPartialDefinitions sends the dense meta data
+     * of a sparse partial followed by one or more messages with the same
+     * name and subname and the shape {kSparsePatternMarker, num_cols, start,
+     * rows..., cols...}, where start is the index of the first non-zero in
+     * the message. The negative marker cannot occur in a regular shape.
+     */
+    constexpr int64_t kSparsePatternMarker = -1;
+
+    //! Extension: stream chunk size derived from the message size limits of both sides
+    constexpr char kFeatureChunkNegotiation[] = "chunk-negotiation";
+
+    //! GetInfo trailing metadata key carrying the server's maximum message size in bytes
+    constexpr char kMaxMessageBytesMetadataKey[] = "philote-max-message-bytes";
+
+    //! gRPC's default maximum receive message size (4 MiB)
+    constexpr size_t kDefaultMaxMessageBytes = 4 * 1024 * 1024;
+
+    /**
+     * @brief Returns the largest chunk size that fits into a message size limit
+     *
+     * Part of the limit is reserved for the non-data fields of an Array
+     * message (names, indices, type and field tags).
+     *
+     * @param max_message_bytes maximum message size in bytes
+     * @return size_t number of doubles per message (at least 1)
+     */
+    size_t ChunkSizeForMessageBytes(size_t max_message_bytes) noexcept;
+
+    //! Extension: several small variables per stream message
+    constexpr char kFeaturePackedVariables[] = "packed-variables";
+
+    //! Client metadata key requesting packed messages ("1") for the results of a call
+    constexpr char kPackedVariablesMetadataKey[] = "philote-packed-variables";
+
+    //! Extension: partials returned by ComputeFunction, after the outputs
+    constexpr char kFeatureFusedGradient[] = "fused-gradient";
+
+    //! Client metadata key requesting the partials ("1") with the outputs of a ComputeFunction call
+    constexpr char kFusedGradientMetadataKey[] = "philote-fused-gradient";
+
+    //! Extension: variable values exchanged through POSIX shared memory (see shared_memory.h)
+    constexpr char kFeatureSharedMemory[] = "shared-memory";
+
+    //! GetInfo trailing metadata key identifying the server host (see SharedMemoryHostId())
+    constexpr char kHostIdMetadataKey[] = "philote-host-id";
+
+    //! Client metadata key naming the shared memory segment of a compute call
+    constexpr char kSharedMemoryMetadataKey[] = "philote-shared-memory";
+
+    //! Extension: float32-encoded values in stream messages (see WirePrecision)
+    constexpr char kFeatureWirePrecision[] = "wire-precision";
+
+    //! Client metadata key requesting the precision of the values sent by the server
+    constexpr char kWirePrecisionMetadataKey[] = "philote-wire-precision";
+
+    //! Metadata value of kWirePrecisionMetadataKey requesting float32 values
+    constexpr char kWirePrecisionFloat32[] = "float32";
+
+    //! Extension: compressed responses of compute calls (see compression.h)
+    constexpr char kFeatureCompression[] = "compression";
+
+    //! Client metadata key carrying the compression policy of the server responses
+    constexpr char kCompressionMetadataKey[] = "philote-compression";
+
+    //! Extension: compute calls that only carry changed inputs (see input_session.h)
+    constexpr char kFeatureInputSessions[] = "input-sessions";
+
+    //! Client metadata key carrying the input session of a compute call
+    constexpr char kInputSessionMetadataKey[] = "philote-input-session";
+
+    //! Extension: compute RPCs carrying several evaluations (see evaluation_stream.h)
+    constexpr char kFeatureEvaluationStreams[] = "evaluation-streams";
+
+    //! Client metadata key requesting an evaluation stream
+    constexpr char kEvaluationStreamMetadataKey[] = "philote-evaluation-stream";
+
+    //! Start index marking the message that ends an evaluation of an evaluation stream
+    constexpr int64_t kEndOfEvaluationMarker = -1;
+
+    //! Extension: Setup returns a content hash of the definitions (see HashDefinitions)
+    constexpr char kFeatureDefinitionsHash[] = "definitions-hash";
+
+    //! Setup trailing metadata key carrying the definitions hash
+    constexpr char kDefinitionsHashMetadataKey[] = "philote-definitions-hash";
+
+    //! Extension: ComputeGradient calls returning Jacobian-vector products (see jacobian_product.h)
+    constexpr char kFeatureJacobianProducts[] = "jacobian-products";
+
+    //! Client metadata key requesting a Jacobian-vector product instead of the partials
+    constexpr char kJacobianProductMetadataKey[] = "philote-jacobian-product";
+
+    //! Metadata value of kJacobianProductMetadataKey requesting J * v
+    constexpr char kJacobianProductForward[] = "forward";
+
+    //! Metadata value of kJacobianProductMetadataKey requesting v^T * J
+    constexpr char kJacobianProductReverse[] = "reverse";
+
+    //! Subname of the messages carrying the seed vector of a Jacobian-vector product
+    constexpr char kJacobianSeedSubname[] = "philote-seed";
+
+    //! Extension: ComputeResidualGradients calls solving linear systems with dR/dy
+    constexpr char kFeatureLinearSolves[] = "linear-solves";
+
+    //! Client metadata key requesting a linear solve instead of the partials
+    constexpr char kLinearSolveMetadataKey[] = "philote-linear-solve";
+
+    //! Metadata value of kLinearSolveMetadataKey solving dR/dy * x = b
+    constexpr char kLinearSolveForward[] = "forward";
+
+    //! Metadata value of kLinearSolveMetadataKey solving (dR/dy)^T * x = b
+    constexpr char kLinearSolveAdjoint[] = "adjoint";
+
+    //! Subname of the messages carrying the right-hand side of a linear solve
+    constexpr char kLinearRhsSubname[] = "philote-rhs";
+
+    //! Extension: discrete variables with integer-encoded values (see WirePrecision::kInteger)
+    constexpr char kFeatureDiscreteVariables[] = "discrete-variables";
+
+    //! Client metadata key requesting discrete markers ("1") for GetVariableDefinitions and integer-encoded values for compute calls
+    constexpr char kDiscreteVariablesMetadataKey[] = "philote-discrete-variables";
+
+    /**
+     * @brief Shape of the marker of a discrete variable
+     *
+     * With discrete variables, GetVariableDefinitions sends the meta data of
+     * a discrete variable followed by a message with the same name and type
+     * and the shape {kDiscreteMarker}. The negative marker cannot occur in a
+     * regular shape.
+     */
+    constexpr int64_t kDiscreteMarker = -2;
+
+    //! Extension: options that leave the definitions unchanged are applied without a new Setup
+    constexpr char kFeatureOptionsHotReload[] = "options-hot-reload";
+
+    //! Server trailing metadata key of SetOptions holding the options generation of the discipline
+    constexpr char kOptionsGenerationMetadataKey[] = "philote-options-generation";
+
+    //! Server trailing metadata key of SetOptions holding "1" if Setup must be called again, "0" otherwise
+    constexpr char kSetupRequiredMetadataKey[] = "philote-setup-required";
+
+    //! Extension: compute calls may be rejected by the admission control of the server (see AdmissionController)
+    constexpr char kFeatureAdmissionControl[] = "admission-control";
+
+    //! Server trailing metadata key of a rejected call holding the milliseconds to wait before retrying
+    constexpr char kRetryAfterMetadataKey[] = "philote-retry-after-ms";
+
+    //! Client metadata key declaring the number of input bytes of a compute call
+    constexpr char kInputBytesMetadataKey[] = "philote-input-bytes";
+
+    /**
+     * @brief Location of one variable within a packed message
+     *
+     * A packed message is an Array with an empty name. Its data holds the
+     * values of several variables back to back and its subname holds the
+     * index: one "offset,name_length,name" entry per variable, in order of
+     * increasing offset. A variable extends to the offset of the next entry
+     * (or to the end of the data).
+     */
+    struct PackedEntry
+    {
+        //! variable name
+        std::string name;
+
+        //! index of the first value in the message data
+        size_t offset = 0;
+
+        //! number of values
+        size_t size = 0;
+    };
+
+    /**
+     * @brief Packs small variables into shared stream messages
+     *
+     * Variables with fewer values than the chunk size are collected into
+     * messages of at most chunk_size values. Larger variables are rejected
+     * by Add and should be sent with Variable::Send. For example:
+     *
+     * @code
+     *     ArrayPacker packer(kInput, chunk_size);
+     *     for (const auto &var : inputs)
+     *         if (!packer.Add(var.first, var.second))
+     *             var.second.Send(var.first, "", stream, chunk_size);
+     *     for (const Array &message : packer.Finish())
+     *         stream->Write(message);
+     * @endcode
+     */
+    class ArrayPacker
+    {
+    public:
+        /**
+         * @brief Constructs a packer
+         *
+         * @param type variable type of the packed messages
+         * @param chunk_size maximum number of values per message
+         * @throws std::invalid_argument if chunk_size is zero
+         */
+        ArrayPacker(VariableType type, size_t chunk_size);
+
+        /**
+         * @brief Adds a variable to the current message
+         *
+         * @param name variable name
+         * @param var variable
+         * @return false if the variable is too large to be packed or discrete
+         */
+        bool Add(const std::string &name, const Variable &var);
+
+        /**
+         * @brief Completes the current message
+         *
+         * @return const std::vector<Array>& all packed messages
+         */
+        const std::vector<Array> &Finish();
+
+    private:
+        //! variable type of the messages
+        VariableType type_;
+
+        //! maximum number of values per message
+        size_t chunk_size_;
+
+        //! completed messages
+        std::vector<Array> messages_;
+
+        //! message being filled
+        Array current_;
+    };
+
+    /**
+     * @brief Returns whether a stream message is a packed message
+     *
+     * @param array stream message
+     * @return true if the name is empty
+     */
+    bool IsPackedArray(const Array &array) noexcept;
+
+    /**
+     * @brief Decodes the index of a packed message
+     *
+     * @param array packed message
+     * @return std::vector<PackedEntry> the packed variables
+     * @throws std::invalid_argument if the index is malformed or does not
+     * match the data
+     */
+    std::vector<PackedEntry> DecodePackedIndex(const Array &array);
+
+    /**
+     * @brief Copies the values of a packed variable into a variable
+     *
+     * @param array packed message
+     * @param entry entry of the variable (from DecodePackedIndex)
+     * @param var variable receiving the values
+     * @throws std::length_error if the sizes do not match
+     */
+    void AssignPackedEntry(const Array &array, const PackedEntry &entry, Variable &var);
+
+    /**
+     * @brief Creates the marker of a discrete variable
+     *
+     * @param meta meta data of the discrete variable
+     * @return VariableMetaData marker message (see kDiscreteMarker)
+     */
+    VariableMetaData DiscreteMarker(const VariableMetaData &meta);
+
+    /**
+     * @brief Returns whether a variable meta data message marks a discrete variable
+     *
+     * @param meta variable meta data message
+     * @return true if the shape is {kDiscreteMarker}
+     */
+    bool IsDiscreteMarker(const VariableMetaData &meta) noexcept;
+
+    /**
+     * @brief Returns the precision of a variable a client requested for a call
+     *
+     * @param context server context of the call (may be nullptr)
+     * @param discrete whether the variable is discrete
+     * @return WirePrecision WirePrecision::kInteger for discrete variables if
+     * the client requested integer-encoded values, RequestedWirePrecision()
+     * otherwise
+     */
+    WirePrecision RequestedWirePrecision(const grpc::ServerContextBase *context, bool discrete);
+
+    /**
+     * @brief Returns the extensions supported by this implementation
+     *
+     * @return std::string comma-separated list of extension names
+     */
+    std::string SupportedFeatures();
+
+    /**
+     * @brief Splits a comma-separated list of extension names
+     *
+     * @param features comma-separated list (as advertised by a server)
+     * @return std::set<std::string> extension names
+     */
+    std::set<std::string> ParseFeatures(const std::string &features);
+
+    /**
+     * @brief Looks up a metadata value
+     *
+     * @param metadata client or server metadata of a call
+     * @param key metadata key
+     * @return std::string the (first) value for the key, or an empty string
+     * if the key is not present
+     */
+    std::string FindMetadata(const std::multimap<grpc::string_ref, grpc::string_ref> &metadata,
+                             const std::string &key);
+
+    /**
+     * @brief Looks up a client metadata value of a server call
+     *
+     * @param context server context of the call (may be nullptr)
+     * @param key metadata key
+     * @return std::string the value, or an empty string if the key (or the
+     * context) is not present
+     */
+    std::string FindClientMetadata(const grpc::ServerContextBase *context, const std::string &key);
+
+    /**
+     * @brief Returns the precision a client requested for the values of a call
+     *
+     * @param context server context of the call (may be nullptr)
+     * @return WirePrecision WirePrecision::kFloat32 if the client requested
+     * float32 values, WirePrecision::kDouble otherwise
+     */
+    WirePrecision RequestedWirePrecision(const grpc::ServerContextBase *context);
+
+    /**
+     * @brief Parses a design point index or count
+     *
+     * Accepts decimal integers in [0, limit).
+     *
+     * @param text text to parse
+     * @param limit exclusive upper bound
+     * @param value parsed value
+     * @return true if the text is a valid index
+     */
+    bool ParseIndex(const std::string &text, size_t limit, size_t &value);
+
+    /**
+     * @brief Encodes a sparsity pattern as partials meta data messages
+     *
+     * @param f function name of the partial
+     * @param x variable name of the partial
+     * @param pattern sparsity pattern
+     * @param chunk_size maximum number of non-zeros per message
+     * @return std::vector<PartialsMetaData> at least one message
+     * @throws std::invalid_argument if chunk_size is zero
+     */
+    std::vector<PartialsMetaData> EncodeSparsityPattern(const std::string &f,
+                                                        const std::string &x,
+                                                        const SparsityPattern &pattern,
+                                                        size_t chunk_size);
+
+    /**
+     * @brief Returns whether a partials meta data message carries a sparsity pattern
+     *
+     * @param meta partials meta data message
+     * @return true if the shape starts with kSparsePatternMarker
+     */
+    bool IsSparsityPatternMessage(const PartialsMetaData &meta) noexcept;
+
+    /**
+     * @brief Appends the non-zeros of a sparsity pattern message to a pattern
+     *
+     * Messages must be decoded in the order they were sent.
+     *
+     * @param meta sparsity pattern message
+     * @param pattern pattern the non-zeros are appended to
+     * @throws std::invalid_argument if the message is malformed or out of order
+     */
+    void DecodeSparsityPattern(const PartialsMetaData &meta, SparsityPattern &pattern);
+
+    /** @} */
+}
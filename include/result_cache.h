@@ -0,0 +1,266 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @brief Hashes the names, shapes, and values of a set of variables
+     *
+     * @param vars variables to hash
+     * @param seed initial value (e.g., a configuration generation)
+     * @return uint64_t hash value
+     */
+    uint64_t HashVariables(const Variables &vars, uint64_t seed = 0) noexcept;
+
+    /**
+     * @brief Checks whether two sets of variables hold bitwise identical values
+     *
+     * @return true if the names, shapes, and values are identical
+     */
+    bool IdenticalVariables(const Variables &a, const Variables &b) noexcept;
+
+    /**
+     * @brief Returns the number of bytes of values stored in variables
+     */
+    size_t StorageBytes(const Variables &vars) noexcept;
+
+    /**
+     * @brief Returns the number of bytes of values stored in partials
+     */
+    size_t StorageBytes(const Partials &partials) noexcept;
+
+    /**
+     * @brief Usage counters of a result cache
+     */
+    struct ResultCacheStats
+    {
+        //! lookups answered from the cache
+        uint64_t hits = 0;
+
+        //! lookups that required an RPC
+        uint64_t misses = 0;
+
+        //! cached results
+        size_t entries = 0;
+
+        //! bytes of values held by the cache (inputs and results)
+        size_t bytes = 0;
+
+        ResultCacheStats &operator+=(const ResultCacheStats &other) noexcept
+        {
+            hits += other.hits;
+            misses += other.misses;
+            entries += other.entries;
+            bytes += other.bytes;
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Least recently used cache of remote evaluation results
+     *
+     * Results are keyed by a hash of the inputs and a configuration
+     * generation (so that results obtained with other options are not
+     * reused). The inputs are stored with each result and compared on a
+     * hit, so hash collisions cannot return wrong results. Once the stored
+     * values exceed the memory cap, the least recently used results are
+     * evicted. A cap of zero disables the cache.
+     *
+     * @tparam Value result type (Variables or Partials)
+     *
+     * @note Thread Safety: All member functions are thread-safe.
+     */
+    template <class Value>
+    class ResultCache
+    {
+    public:
+        /**
+         * @brief Constructs a cache
+         *
+         * @param max_bytes memory cap in bytes (0 disables the cache)
+         */
+        explicit ResultCache(size_t max_bytes = 0) : max_bytes_(max_bytes) {}
+
+        /**
+         * @brief Sets the memory cap, evicting results if necessary
+         *
+         * @param max_bytes memory cap in bytes (0 disables and clears the cache)
+         */
+        void SetMaxBytes(size_t max_bytes)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            max_bytes_ = max_bytes;
+            Evict();
+        }
+
+        /**
+         * @brief Checks whether the cache is enabled
+         */
+        bool enabled() const noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return max_bytes_ > 0;
+        }
+
+        /**
+         * @brief Looks up the result for a set of inputs
+         *
+         * Counts a hit or miss if the cache is enabled.
+         *
+         * @param inputs inputs of the evaluation
+         * @param generation configuration generation of the evaluation
+         * @param value receives the cached result on a hit
+         * @return true on a hit
+         */
+        bool Find(const Variables &inputs, uint64_t generation, Value &value)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (max_bytes_ == 0)
+                return false;
+
+            auto it = index_.find(HashVariables(inputs, generation));
+            if (it == index_.end() or it->second->generation != generation or
+                !IdenticalVariables(it->second->inputs, inputs))
+            {
+                stats_.misses++;
+                return false;
+            }
+
+            // move the entry to the front of the recency list
+            entries_.splice(entries_.begin(), entries_, it->second);
+            value = it->second->value;
+            stats_.hits++;
+            return true;
+        }
+
+        /**
+         * @brief Stores the result of an evaluation
+         *
+         * Results larger than the memory cap are not stored.
+         *
+         * @param inputs inputs of the evaluation
+         * @param generation configuration generation of the evaluation
+         * @param value result of the evaluation
+         */
+        void Insert(const Variables &inputs, uint64_t generation, const Value &value)
+        {
+            const size_t bytes = StorageBytes(inputs) + StorageBytes(value);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (bytes > max_bytes_)
+                return;
+
+            // replace a previous result with the same hash
+            const uint64_t hash = HashVariables(inputs, generation);
+            auto it = index_.find(hash);
+            if (it != index_.end())
+            {
+                stats_.bytes -= it->second->bytes;
+                entries_.erase(it->second);
+                index_.erase(it);
+            }
+
+            entries_.push_front(Entry{hash, generation, inputs, value, bytes});
+            index_[hash] = entries_.begin();
+            stats_.bytes += bytes;
+            Evict();
+        }
+
+        /**
+         * @brief Removes all results (the counters are kept)
+         */
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            entries_.clear();
+            index_.clear();
+            stats_.bytes = 0;
+        }
+
+        /**
+         * @brief Returns the usage counters
+         */
+        ResultCacheStats stats() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ResultCacheStats stats = stats_;
+            stats.entries = entries_.size();
+            return stats;
+        }
+
+    private:
+        //! cached result
+        struct Entry
+        {
+            uint64_t hash;
+            uint64_t generation;
+            Variables inputs;
+            Value value;
+            size_t bytes;
+        };
+
+        //! memory cap in bytes
+        size_t max_bytes_;
+
+        //! results, most recently used first
+        std::list<Entry> entries_;
+
+        //! results by input hash
+        std::unordered_map<uint64_t, typename std::list<Entry>::iterator> index_;
+
+        //! usage counters (entries is computed on demand)
+        ResultCacheStats stats_;
+
+        //! guards all members
+        mutable std::mutex mutex_;
+
+        //! Evicts the least recently used results until the cap is met
+        void Evict()
+        {
+            while (!entries_.empty() and stats_.bytes > max_bytes_)
+            {
+                stats_.bytes -= entries_.back().bytes;
+                index_.erase(entries_.back().hash);
+                entries_.pop_back();
+            }
+        }
+    };
+}
@@ -0,0 +1,290 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <grpcpp/grpcpp.h>
+
+#include <data.pb.h>
+
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @brief POSIX shared memory segment of doubles
+     *
+     * Used by co-located clients and servers to exchange variable values
+     * without serializing them into stream messages. The client creates
+     * (and eventually unlinks) the segment, the server opens it by name.
+     */
+    class SharedMemorySegment
+    {
+    public:
+        /**
+         * @brief Creates a new segment with a unique name
+         *
+         * @param size number of doubles
+         * @return std::shared_ptr<SharedMemorySegment> mapped segment, unlinked on destruction
+         * @throws std::runtime_error if the segment cannot be created
+         */
+        static std::shared_ptr<SharedMemorySegment> Create(size_t size);
+
+        /**
+         * @brief Opens a segment created by another process
+         *
+         * @param name segment name (as returned by name())
+         * @return std::shared_ptr<SharedMemorySegment> mapped segment
+         * @throws std::invalid_argument if the name was not created by Create
+         * @throws std::runtime_error if the segment cannot be opened
+         */
+        static std::shared_ptr<SharedMemorySegment> Open(const std::string &name);
+
+        //! Unmaps the segment (and unlinks it if it was created by this process)
+        ~SharedMemorySegment() noexcept;
+
+        SharedMemorySegment(const SharedMemorySegment &) = delete;
+        SharedMemorySegment &operator=(const SharedMemorySegment &) = delete;
+
+        //! Returns the name of the segment
+        const std::string &name() const noexcept { return name_; }
+
+        //! Returns the number of doubles in the segment
+        size_t size() const noexcept { return size_; }
+
+        //! Returns the mapped storage
+        double *data() noexcept { return data_; }
+
+        /**
+         * @brief Checks whether the name still refers to the mapped segment
+         *
+         * A segment unlinked by its creator may be replaced by a new segment
+         * with the same name, e.g., by a later process with the same id.
+         *
+         * @return false if the segment was unlinked or replaced
+         */
+        bool IsCurrent() const noexcept;
+
+    private:
+        SharedMemorySegment(std::string name, double *data, size_t size, bool owner,
+                            uint64_t device, uint64_t inode)
+            : name_(std::move(name)), data_(data), size_(size), owner_(owner), device_(device), inode_(inode) {}
+
+        //! segment name
+        std::string name_;
+
+        //! mapped storage
+        double *data_;
+
+        //! number of doubles
+        size_t size_;
+
+        //! whether the segment is unlinked on destruction
+        bool owner_;
+
+        //! device and inode of the segment, which identify it beyond its name
+        uint64_t device_;
+        uint64_t inode_;
+    };
+
+    /**
+     * @brief Moves the values of one call through a shared memory segment
+     *
+     * Both sides process the stream messages in order: the client writes
+     * its inputs back to back from the start of the segment and the server
+     * writes its results right after the inputs. Each variable is announced
+     * by a stream message with the usual name, subname, and indices but
+     * without data, so the values are neither serialized nor copied
+     * through the network stack.
+     */
+    class SharedMemoryTransfer
+    {
+    public:
+        //! Constructs a transfer without a segment (values travel in the messages)
+        SharedMemoryTransfer() = default;
+
+        /**
+         * @brief Constructs a transfer through a segment
+         *
+         * @param segment mapped segment
+         */
+        explicit SharedMemoryTransfer(std::shared_ptr<SharedMemorySegment> segment)
+            : segment_(std::move(segment)) {}
+
+        //! Returns whether values travel through a segment
+        explicit operator bool() const noexcept { return segment_ != nullptr; }
+
+        /**
+         * @brief Copies a variable into the segment and announces it
+         *
+         * @param name variable name
+         * @param subname variable subname (for partials)
+         * @param var variable
+         * @param stream stream (or pipeline) the message is written to
+         * @throws std::length_error if the segment is too small
+         * @throws std::runtime_error if the message cannot be written
+         */
+        template <typename StreamType>
+        void Send(const std::string &name, const std::string &subname, const Variable &var, StreamType *stream)
+        {
+            const size_t n = var.Size();
+            if (n == 0)
+                return;
+
+            std::copy(var.data(), var.data() + n, Reserve(n));
+
+            Array message;
+            message.set_name(name);
+            message.set_subname(subname);
+            message.set_start(0);
+            message.set_end(static_cast<int64_t>(n - 1));
+            message.set_type(var.Type());
+            if (!stream->Write(std::move(message)))
+                throw std::runtime_error("Failed to write variable '" + name + "' to stream");
+        }
+
+        /**
+         * @brief Assigns the values announced by a message to a variable
+         *
+         * The values are taken from the segment if the message carries no
+         * data and from the message otherwise.
+         *
+         * @param message stream message
+         * @param var variable receiving the values
+         * @param precision precision negotiated by the call
+         * @return size_t number of values assigned
+         * @throws std::invalid_argument, std::out_of_range, std::length_error
+         * for invalid indices (see Variable::AssignChunk)
+         */
+        size_t Assign(const Array &message, Variable &var, WirePrecision precision = WirePrecision::kDouble);
+
+        /**
+         * @brief Returns the values announced by a message without copying
+         * them into a variable
+         *
+         * @param message stream message
+         * @param buffer storage for values that have to be unpacked (see DecodeChunk)
+         * @param precision precision negotiated by the call
+         * @return const double* the message.end() - message.start() + 1 values
+         * @throws std::invalid_argument, std::length_error for invalid
+         * messages or if the segment is too small
+         */
+        const double *Receive(const Array &message, std::vector<double> &buffer,
+                              WirePrecision precision = WirePrecision::kDouble);
+
+        //! Returns the position of the next value in the segment
+        size_t offset() const noexcept { return offset_; }
+
+    private:
+        /**
+         * @brief Reserves the next values of the segment
+         *
+         * @param count number of values
+         * @return double* storage of the values
+         * @throws std::length_error if the segment is too small
+         */
+        double *Reserve(size_t count);
+
+        //! segment (nullptr if values travel in the messages)
+        std::shared_ptr<SharedMemorySegment> segment_;
+
+        //! position of the next value in the segment
+        size_t offset_ = 0;
+    };
+
+    /**
+     * @brief Segments opened by a server, reused across calls
+     *
+     * Keeps the most recently used segments mapped, so repeated calls of a
+     * client do not map (and page-fault) their segment again. Thread-safe.
+     */
+    class SharedMemoryCache
+    {
+    public:
+        /**
+         * @brief Constructs a cache
+         *
+         * @param capacity maximum number of mapped segments
+         */
+        explicit SharedMemoryCache(size_t capacity = 16) : capacity_(capacity) {}
+
+        /**
+         * @brief Returns a mapped segment
+         *
+         * Cached mappings of segments that were replaced under the same
+         * name are mapped again.
+         *
+         * @param name segment name
+         * @return std::shared_ptr<SharedMemorySegment> mapped segment
+         * @throws std::invalid_argument, std::runtime_error (see SharedMemorySegment::Open)
+         */
+        std::shared_ptr<SharedMemorySegment> Open(const std::string &name);
+
+        /**
+         * @brief Prepares the shared memory transfer of a server call
+         *
+         * @param context server context of the call (may be nullptr)
+         * @param transfer receives a transfer through the segment named in
+         * the client metadata (or without a segment if none is named)
+         * @return grpc::Status FAILED_PRECONDITION if the segment cannot be opened
+         */
+        grpc::Status Attach(const grpc::ServerContextBase *context, SharedMemoryTransfer &transfer);
+
+    private:
+        //! maximum number of mapped segments
+        size_t capacity_;
+
+        //! guards the segments
+        std::mutex mutex_;
+
+        //! mapped segments, most recently used first
+        std::list<std::shared_ptr<SharedMemorySegment>> segments_;
+    };
+
+    /**
+     * @brief Identifies the host (and boot) of this process
+     *
+     * Processes with the same id can share memory segments.
+     *
+     * @return std::string host name and boot id
+     */
+    std::string SharedMemoryHostId();
+}
@@ -0,0 +1,140 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace philote
+{
+    /**
+     * @brief Granularity of the placement of pooled discipline instances
+     */
+    enum class PlacementPolicy
+    {
+        //! threads migrate freely (default)
+        kNone,
+
+        //! every instance runs on one core
+        kCores,
+
+        //! every instance runs on the cores of one NUMA node
+        kNumaNodes
+    };
+
+    /**
+     * @brief Placement of the pooled discipline instances of a server
+     *
+     * Instances are assigned to the cores (or NUMA nodes) round-robin in the
+     * order they are created. A call served by an instance runs on the CPUs
+     * of the instance, so the buffers the instance allocates (and touches
+     * first) are placed on its node by the kernel.
+     */
+    struct ThreadPlacement
+    {
+        //! granularity of the placement
+        PlacementPolicy policy = PlacementPolicy::kNone;
+
+        //! CPUs to place the instances on (empty uses the CPUs the process may run on)
+        std::vector<int> cpus;
+    };
+
+    /**
+     * @brief Returns the CPUs the process may run on
+     *
+     * @return std::vector<int> ascending CPU ids
+     */
+    std::vector<int> AvailableCpus();
+
+    /**
+     * @brief Returns the CPUs of every NUMA node
+     *
+     * Nodes without any of the given CPUs are omitted. Systems without NUMA
+     * information are reported as a single node.
+     *
+     * @param cpus CPUs to consider
+     * @return std::vector<std::vector<int>> CPUs by node
+     */
+    std::vector<std::vector<int>> NumaNodeCpus(const std::vector<int> &cpus);
+
+    /**
+     * @brief Parses a Linux CPU list (e.g., "0-3,8,10-11")
+     *
+     * @param text CPU list
+     * @return std::vector<int> CPU ids in the order of the list
+     * @throws std::invalid_argument if the list is malformed
+     */
+    std::vector<int> ParseCpuList(const std::string &text);
+
+    /**
+     * @brief Returns the CPU sets instances are placed on
+     *
+     * @param placement placement of the instances
+     * @return std::vector<std::vector<int>> one CPU set per core or node
+     * (empty for PlacementPolicy::kNone)
+     */
+    std::vector<std::vector<int>> PlacementSlots(const ThreadPlacement &placement);
+
+    /**
+     * @brief Pins the calling thread to a CPU set for the lifetime of the scope
+     *
+     * The previous affinity of the thread is restored on destruction.
+     * Placement is best effort: if the affinity cannot be changed (e.g.,
+     * CPUs that are offline), the thread keeps running where it is.
+     */
+    class AffinityScope
+    {
+    public:
+        /**
+         * @brief Pins the calling thread
+         *
+         * @param cpus CPUs the thread may run on (empty leaves the thread unpinned)
+         */
+        explicit AffinityScope(const std::vector<int> &cpus) noexcept;
+
+        //! Restores the previous affinity
+        ~AffinityScope() noexcept;
+
+        AffinityScope(const AffinityScope &) = delete;
+        AffinityScope &operator=(const AffinityScope &) = delete;
+
+        //! Checks whether the thread was pinned
+        bool pinned() const noexcept { return pinned_; }
+
+    private:
+        //! affinity of the thread before the scope (as CPU ids)
+        std::vector<int> previous_;
+
+        //! whether the affinity was changed
+        bool pinned_ = false;
+    };
+}
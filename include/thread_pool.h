@@ -0,0 +1,104 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace philote
+{
+    /**
+     * @brief Fixed-size pool of worker threads executing queued tasks
+     *
+     * Tasks are executed in submission order by the first available worker.
+     * Destroying the pool finishes all queued tasks before the workers are
+     * joined.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief Starts the worker threads
+         *
+         * @param threads number of worker threads (0 uses the number of
+         * hardware threads)
+         */
+        explicit ThreadPool(size_t threads = 0);
+
+        //! Finishes all queued tasks and joins the workers
+        ~ThreadPool() noexcept;
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /**
+         * @brief Queues a task for execution
+         *
+         * Exceptions thrown by the task are discarded.
+         *
+         * @param task task to execute
+         */
+        void Submit(std::function<void()> task);
+
+        /**
+         * @brief Returns the number of worker threads
+         *
+         * @return size_t
+         */
+        size_t size() const noexcept;
+
+    private:
+        //! worker threads
+        std::vector<std::thread> workers_;
+
+        //! tasks waiting for a worker
+        std::deque<std::function<void()>> tasks_;
+
+        //! guards tasks_ and stopping_
+        std::mutex mutex_;
+
+        //! signals new tasks (or shutdown) to the workers
+        std::condition_variable available_;
+
+        //! set once the pool is being destroyed
+        bool stopping_ = false;
+
+        /**
+         * @brief Executes tasks until the pool is destroyed
+         */
+        void Work();
+    };
+}
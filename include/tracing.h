@@ -0,0 +1,272 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <grpcpp/grpcpp.h>
+
+#include <metrics.h>
+#include <protocol_extensions.h>
+
+namespace philote
+{
+    //! Client metadata key carrying the W3C trace context of a call
+    constexpr char kTraceparentMetadataKey[] = "traceparent";
+
+    /**
+     * @brief Identifies a span within a distributed trace (W3C trace context)
+     */
+    struct TraceContext
+    {
+        //! trace id (32 lowercase hex digits)
+        std::string trace_id;
+
+        //! span id (16 lowercase hex digits)
+        std::string span_id;
+
+        //! whether the trace is sampled
+        bool sampled = true;
+
+        /**
+         * @brief Checks whether the ids are well-formed and not all zeros
+         */
+        bool valid() const noexcept;
+    };
+
+    /**
+     * @brief Formats a trace context as a traceparent header value
+     *
+     * @param context valid trace context
+     * @return std::string e.g., "00-<trace id>-<span id>-01"
+     */
+    std::string FormatTraceparent(const TraceContext &context);
+
+    /**
+     * @brief Parses a traceparent header value
+     *
+     * @param header header value
+     * @param context receives the trace context on success
+     * @return true if the header is a valid version 00 traceparent
+     */
+    bool ParseTraceparent(const std::string &header, TraceContext &context);
+
+    /**
+     * @brief Role of a span within an RPC
+     */
+    enum class SpanKind
+    {
+        //! client side of an RPC
+        kClient,
+
+        //! server side of an RPC
+        kServer,
+
+        //! phase within an RPC
+        kInternal
+    };
+
+    /**
+     * @brief Span started by a Tracer
+     */
+    class Span
+    {
+    public:
+        //! Destructor
+        virtual ~Span() = default;
+
+        /**
+         * @brief Returns the trace context identifying this span
+         */
+        virtual TraceContext context() const = 0;
+
+        /**
+         * @brief Ends the span
+         *
+         * Called exactly once.
+         *
+         * @param status outcome of the traced operation
+         * @param end end time
+         */
+        virtual void End(const grpc::Status &status, std::chrono::system_clock::time_point end) = 0;
+    };
+
+    /**
+     * @brief Creates the spans of traced calls
+     *
+     * Adapts Philote to a tracing library, e.g., by wrapping an OpenTelemetry
+     * tracer that starts spans with the given parent and start time. Set on
+     * a client with DisciplineClient::SetTracer and on a discipline with
+     * Discipline::SetTracer. Must be thread-safe.
+     */
+    class Tracer
+    {
+    public:
+        //! Destructor
+        virtual ~Tracer() = default;
+
+        /**
+         * @brief Starts a span
+         *
+         * @param name span name (the RPC name, or "<RPC>/<phase>" for phases)
+         * @param kind role of the span
+         * @param parent parent span (invalid for root spans)
+         * @param start start time
+         * @return std::unique_ptr<Span> started span (nullptr if not recorded)
+         */
+        virtual std::unique_ptr<Span> StartSpan(const std::string &name, SpanKind kind,
+                                                const TraceContext &parent,
+                                                std::chrono::system_clock::time_point start) = 0;
+    };
+
+    /**
+     * @brief Client span of one RPC
+     *
+     * Starts a client span (if a tracer is given) and propagates it, or
+     * else the parent, to the server through the call metadata. Ends the
+     * span with Finish, or with an error status if the call is abandoned
+     * (e.g., by an exception).
+     */
+    class ClientCallSpan
+    {
+    public:
+        //! Constructs an inactive span
+        ClientCallSpan() = default;
+
+        /**
+         * @brief Starts the span of a call
+         *
+         * @param tracer tracer (may be nullptr)
+         * @param parent parent span (may be invalid)
+         * @param rpc RPC name
+         * @param context client context of the call (before the call starts)
+         */
+        ClientCallSpan(Tracer *tracer, const TraceContext &parent, const std::string &rpc,
+                       grpc::ClientContext &context);
+
+        /**
+         * @brief Starts the span of a call without propagating it to the server
+         *
+         * @param tracer tracer (may be nullptr)
+         * @param parent parent span (may be invalid)
+         * @param rpc RPC name
+         */
+        ClientCallSpan(Tracer *tracer, const TraceContext &parent, const std::string &rpc);
+
+        ClientCallSpan(ClientCallSpan &&other) noexcept = default;
+        ClientCallSpan &operator=(ClientCallSpan &&other) noexcept;
+
+        //! Ends the span if the call did not finish
+        ~ClientCallSpan();
+
+        /**
+         * @brief Ends the span
+         *
+         * @param status status of the call
+         */
+        void Finish(const grpc::Status &status);
+
+    private:
+        //! span of the call (nullptr if not traced)
+        std::unique_ptr<Span> span_;
+    };
+
+    /**
+     * @brief Server span of one compute RPC with child spans per phase
+     */
+    class ServerCallSpan
+    {
+    public:
+        /**
+         * @brief Starts the span of an RPC
+         *
+         * The parent is read from the traceparent client metadata.
+         *
+         * @param tracer tracer (may be nullptr)
+         * @param context server context of the RPC
+         * @param rpc RPC name
+         */
+        ServerCallSpan(Tracer *tracer, const grpc::ServerContextBase *context, const std::string &rpc);
+
+        /**
+         * @brief Records the phases of the RPC and ends its span
+         *
+         * @param metrics measurements of the RPC
+         */
+        void Finish(const CallMetrics &metrics);
+
+    private:
+        //! tracer creating the phase spans
+        Tracer *tracer_;
+
+        //! start of the RPC
+        std::chrono::system_clock::time_point start_;
+
+        //! span of the RPC (nullptr if not traced)
+        std::unique_ptr<Span> span_;
+    };
+
+    /**
+     * @brief Runs the logic of a compute RPC and records its measurements and spans
+     *
+     * Without a recorder and a tracer, the handler is called with the
+     * original stream, so disabled instrumentation does not cost more than
+     * two pointer checks.
+     *
+     * @param recorder metrics recorder (may be nullptr)
+     * @param tracer tracer (may be nullptr)
+     * @param context server context of the RPC
+     * @param rpc RPC name
+     * @param stream stream of the RPC
+     * @param handler RPC logic, callable with StreamType* and MeteredArrayStream*
+     * @return grpc::Status status of the handler
+     */
+    template <typename StreamType, typename Handler>
+    grpc::Status ObserveCall(MetricsRecorder *recorder, Tracer *tracer, const grpc::ServerContextBase *context,
+                             const char *rpc, StreamType *stream, Handler &&handler)
+    {
+        if ((recorder == nullptr and tracer == nullptr) or stream == nullptr)
+            return handler(stream);
+
+        ServerCallSpan span(tracer, context, rpc);
+        MeteredArrayStream metered(stream);
+        grpc::Status status = handler(&metered);
+
+        const CallMetrics metrics = metered.Finish(rpc, status);
+        span.Finish(metrics);
+        if (recorder != nullptr)
+            recorder->Record(metrics);
+
+        return status;
+    }
+}
@@ -30,6 +30,8 @@
 */
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <map>
 #include <vector>
@@ -37,8 +39,57 @@
 #include <data.pb.h>
 #include <disciplines.grpc.pb.h>
 
+#include <aligned_allocator.h>
+#include <mapped_file.h>
+#include <array_view.h>
+
 namespace philote
 {
+    // forward declaration
+    class ChunkPipeline;
+
+    /**
+     * @brief Precision of the variable values in stream messages
+     *
+     * Variables always store doubles. With reduced precision, the values of
+     * a chunk are rounded to float32 and packed pairwise into the doubles of
+     * the message, halving the size of the payload. Both sides of a call
+     * know the precision from the call's metadata (kWirePrecisionMetadataKey),
+     * and only calls that negotiated float32 accept float32 chunks (see
+     * Variable::AssignChunk). Reduced-precision messages hold twice as many values as the chunk size,
+     * so their size stays within the negotiated message size. Chunks with a
+     * single value are always sent in double precision.
+     *
+     * Integer-encoded chunks carry the values of discrete variables as
+     * zigzag varints: every value takes one to ten bytes, and the bytes are
+     * packed eight per double of the message (zero-padded). They are
+     * recognized by their subname (kDiscreteChunkSubname) and hold at most
+     * 4/5 of the chunk size values, so even ten-byte values stay within the
+     * negotiated message size.
+     */
+    enum class WirePrecision
+    {
+        //! values are sent as doubles
+        kDouble,
+
+        //! values are rounded to float32, two values per double of the message
+        kFloat32,
+
+        //! values are rounded to integers and sent as packed zigzag varints
+        kInteger
+    };
+
+    //! Subname of the stream messages holding integer-encoded values
+    constexpr char kDiscreteChunkSubname[] = "philote-discrete";
+
+    //! Tag selecting integer storage in the Variable constructor
+    struct DiscreteTag
+    {
+    };
+
+    //! Constructor tag of discrete variables, e.g., Variable(kInput, {3}, kDiscrete)
+    constexpr DiscreteTag kDiscrete{};
+
     /**
      * @brief A class for storing continuous and discrete variables
      *
@@ -113,6 +164,80 @@ namespace philote
          */
         explicit Variable(const philote::PartialsMetaData &meta);
 
+        /**
+         * @brief Construct a variable that views external storage
+         *
+         * The variable does not own the storage, which must hold at least as
+         * many elements as the shape describes and must outlive the variable
+         * (see FlatVariables). Copies of a view own a copy of the data; moving
+         * a view keeps it a view.
+         *
+         * @param type variable type
+         * @param shape shape of the array
+         * @param data first element of the external storage
+         */
+        Variable(const philote::VariableType &type,
+                 const std::vector<size_t> &shape,
+                 double *data);
+
+        /**
+         * @brief Construct a variable stored in a memory-mapped file
+         *
+         * The variable views the file and keeps it mapped. Copies hold their
+         * values in memory; moving keeps the file storage.
+         *
+         * @param type variable type
+         * @param shape shape of the array
+         * @param file mapped file holding the values
+         * @param offset index of the first value of the variable in the file
+         * @throws std::invalid_argument if the file is null or too small
+         */
+        Variable(const philote::VariableType &type,
+                 const std::vector<size_t> &shape,
+                 std::shared_ptr<MappedFile> file,
+                 size_t offset = 0);
+
+        /**
+         * @brief Construct a discrete variable
+         *
+         * Discrete variables hold integers (e.g., selections or masks) in
+         * 64-bit integer storage, which is accessed with Discrete() and
+         * discrete_data(). data() returns nullptr for them. Stream messages
+         * of discrete variables are integer-encoded where the peer supports
+         * it (see WirePrecision::kInteger).
+         *
+         * Servers do not use this storage: discrete inputs and outputs are
+         * held as doubles in the workspace (see
+         * Discipline::AddDiscreteInput), so Compute reads them with
+         * operator() or values().
+         *
+         * @param type variable type
+         * @param shape shape of the array
+         */
+        Variable(const philote::VariableType &type,
+                 const std::vector<size_t> &shape,
+                 DiscreteTag);
+
+        /**
+         * @brief Copy constructor (the copy always owns its data)
+         */
+        Variable(const Variable &other);
+
+        /**
+         * @brief Move constructor
+         */
+        Variable(Variable &&other) noexcept;
+
+        /**
+         * @brief Copy assignment (the variable owns its data afterwards)
+         */
+        Variable &operator=(const Variable &other);
+
+        /**
+         * @brief Move assignment
+         */
+        Variable &operator=(Variable &&other) noexcept;
+
         /**
          * @brief Destroy the Variables object
          *
@@ -163,11 +288,164 @@ namespace philote
          */
         size_t Size() const noexcept;
 
+        /**
+         * @brief Returns the type of the variable
+         *
+         * @return philote::VariableType type from the meta data (default: kInput)
+         */
+        philote::VariableType Type() const noexcept;
+
+        /**
+         * @brief Sets all elements of the array to a value
+         *
+         * Discrete variables are set to the value rounded to an integer.
+         *
+         * @param value value assigned to every element
+         */
+        void Fill(double value) noexcept;
+
+        /**
+         * @brief Returns a pointer to the first element of the array
+         *
+         * Storage owned by the variable is aligned to kSimdAlignment. Views
+         * share the alignment of the storage they view (the variables of a
+         * FlatVariables buffer and file-backed storage are aligned).
+         *
+         * @return double* contiguous, row major storage of Size() elements
+         * (nullptr for discrete variables)
+         */
+        double *data() noexcept;
+
+        /**
+         * @brief Returns a pointer to the first element of the array
+         *
+         * @return const double* contiguous, row major storage of Size() elements
+         * (nullptr for discrete variables)
+         */
+        const double *data() const noexcept;
+
+        /**
+         * @brief Returns a view of the values of the array
+         *
+         * Gives compute kernels direct access to the storage (without the
+         * checks of operator() or the copies of Segment()), e.g.:
+         *
+         * @code
+         * philote::ArrayView<const double> x = inputs.at("x").values();
+         * philote::ArrayView<double> y = outputs.at("y").values();
+         * for (size_t i = 0; i < x.size(); i++)
+         *     y[i] = 2.0 * x[i];
+         * @endcode
+         *
+         * The view is invalidated when the variable is resized, reassigned,
+         * or destroyed.
+         *
+         * @return ArrayView<double> Size() values (empty for discrete variables)
+         */
+        ArrayView<double> values() noexcept;
+
+        /**
+         * @brief Returns a read-only view of the values of the array
+         *
+         * @return ArrayView<const double> Size() values (empty for discrete variables)
+         */
+        ArrayView<const double> values() const noexcept;
+
+        /**
+         * @brief Returns whether the variable holds integers
+         *
+         * @return true if the variable was constructed with kDiscrete
+         */
+        bool IsDiscrete() const noexcept;
+
+        /**
+         * @brief Returns a pointer to the first integer of a discrete variable
+         *
+         * @return int64_t* contiguous, row major storage of Size() integers
+         * (nullptr for continuous variables)
+         */
+        int64_t *discrete_data() noexcept;
+
+        /**
+         * @brief Returns a pointer to the first integer of a discrete variable
+         *
+         * @return const int64_t* contiguous, row major storage of Size()
+         * integers (nullptr for continuous variables)
+         */
+        const int64_t *discrete_data() const noexcept;
+
+        /**
+         * @brief Returns a view of the integers of a discrete variable
+         *
+         * Only variables constructed with kDiscrete hold integers; the
+         * workspace variables passed to Compute are always continuous.
+         *
+         * @return ArrayView<int64_t> Size() integers (empty for continuous variables)
+         */
+        ArrayView<int64_t> discrete_values() noexcept;
+
+        /**
+         * @brief Returns a read-only view of the integers of a discrete variable
+         *
+         * @return ArrayView<const int64_t> Size() integers (empty for continuous variables)
+         */
+        ArrayView<const int64_t> discrete_values() const noexcept;
+
+        /**
+         * @brief Returns the integer of a discrete variable at a given index
+         *
+         * @param i flat index
+         * @return int64_t value at the index
+         * @throws std::logic_error if the variable is continuous
+         * @throws std::out_of_range if the index is out of range
+         */
+        int64_t Discrete(const size_t &i) const;
+
+        /**
+         * @brief Returns the integer of a discrete variable at a given index
+         *
+         * Only variables constructed with kDiscrete hold integers (see
+         * discrete_values()).
+         *
+         * @param i flat index
+         * @return int64_t& value at the index
+         * @throws std::logic_error if the variable is continuous
+         * @throws std::out_of_range if the index is out of range
+         */
+        int64_t &Discrete(const size_t &i);
+
+        /**
+         * @brief Returns whether the variable views external storage
+         *
+         * @return true if the data is not owned by the variable
+         */
+        bool IsView() const noexcept;
+
+        /**
+         * @brief Returns whether the variable is stored in a memory-mapped file
+         *
+         * File-backed variables are also views (see IsView).
+         *
+         * @return true if the values live in a MappedFile
+         */
+        bool IsFileBacked() const noexcept;
+
+        /**
+         * @brief Drops the pages of a range of a file-backed variable from memory
+         *
+         * Does nothing for variables held in memory.
+         *
+         * @param start first element of the range
+         * @param end last element of the range (inclusive)
+         */
+        void ReleasePages(size_t start, size_t end) const noexcept;
+
         /**
          * @brief Returns the value of the array at a given index
          *
          * @param indices indices at which the array should be accessed
          * @return double value of the array at the given indices
+         * @throws std::logic_error if the variable is discrete (see Discrete())
          */
         double operator()(const size_t &i) const;
 
@@ -176,6 +454,7 @@ namespace philote
          *
          * @param indices indices at which the array should be accessed
          * @return double value of the array at the given indices
+         * @throws std::logic_error if the variable is discrete (see Discrete())
          */
         double &operator()(const size_t &i);
 
@@ -188,6 +467,26 @@ namespace philote
          */
         philote::Array CreateChunk(const size_t &start, const size_t &end) const;
 
+        /**
+         * @brief Fills an existing Array message with a chunk of the variable
+         *
+         * The data is copied directly from the variable storage into the
+         * message. Any data already held by the message is replaced, but its
+         * capacity is kept, so a single message can be reused for many chunks
+         * without reallocating. Integer-encoded chunks are marked by their
+         * subname (see kDiscreteChunkSubname), so they cannot carry the
+         * subname of a partial.
+         *
+         * @param start starting index of the chunk
+         * @param end ending index of the chunk (inclusive)
+         * @param chunk message to fill
+         * @param precision precision of the values in the message
+         * @throws std::invalid_argument if the precision is
+         * WirePrecision::kInteger and the message already has another subname
+         */
+        void CreateChunk(const size_t &start, const size_t &end, philote::Array &chunk,
+                         WirePrecision precision = WirePrecision::kDouble) const;
+
         /**
          * @brief Sends the variable from the client to the server
          *
@@ -196,7 +495,8 @@ namespace philote
         void Send(std::string name,
                   std::string subname,
                   grpc::ClientReaderWriter<::philote::Array, ::philote::Array> *stream,
-                  const size_t &chunk_size) const;
+                  const size_t &chunk_size,
+                  WirePrecision precision = WirePrecision::kDouble) const;
 
         /**
          * @brief Sends the variable from the server to the client using the interface
@@ -206,12 +506,14 @@ namespace philote
          * @param stream The gRPC stream to write to
          * @param chunk_size Number of elements per chunk
          * @param context Optional server context for cancellation detection
+         * @param precision Precision of the values in the messages
          */
         void Send(std::string name,
                   std::string subname,
                   grpc::ServerReaderWriterInterface<::philote::Array, ::philote::Array> *stream,
                   const size_t &chunk_size,
-                  grpc::ServerContext* context = nullptr) const;
+                  grpc::ServerContextBase* context = nullptr,
+                  WirePrecision precision = WirePrecision::kDouble) const;
 
         /**
          * @brief Sends the variable from the client to the server using the interface
@@ -221,28 +523,89 @@ namespace philote
         void Send(std::string name,
                   std::string subname,
                   grpc::ClientReaderWriterInterface<::philote::Array, ::philote::Array> *stream,
-                  const size_t &chunk_size) const;
+                  const size_t &chunk_size,
+                  WirePrecision precision = WirePrecision::kDouble) const;
+
+        /**
+         * @brief Appends the chunked messages of the variable to a list
+         *
+         * Produces the same messages as the streaming overloads without
+         * writing them to a stream, e.g., for calls that send their messages
+         * asynchronously.
+         *
+         * @param name Variable name
+         * @param subname Variable subname (for partials)
+         * @param messages list the messages are appended to
+         * @param chunk_size Number of elements per chunk
+         * @param precision Precision of the values in the messages
+         */
+        void Send(std::string name,
+                  std::string subname,
+                  std::vector<::philote::Array> *messages,
+                  const size_t &chunk_size,
+                  WirePrecision precision = WirePrecision::kDouble) const;
+
+        /**
+         * @brief Sends the variable through a chunk pipeline
+         *
+         * The next chunk is prepared while the pipeline writes the previous
+         * one.
+         *
+         * @param name Variable name
+         * @param subname Variable subname (for partials)
+         * @param pipeline pipeline writing the messages
+         * @param chunk_size Number of elements per chunk
+         * @param precision Precision of the values in the messages
+         */
+        void Send(std::string name,
+                  std::string subname,
+                  ChunkPipeline *pipeline,
+                  const size_t &chunk_size,
+                  WirePrecision precision = WirePrecision::kDouble) const;
 
         /**
          * @brief Assigns a chunk to the variable
          *
-         * @param stream
-         * @param chunk_size
+         * A chunk with the subname kDiscreteChunkSubname is integer-encoded.
+         * Other chunks hold n doubles, or, if the call negotiated float32
+         * values, (n + 1) / 2 doubles of float32-encoded values for n > 1.
+         * Values are converted between doubles and integers as needed.
+         *
+         * @param data chunk message
+         * @param precision precision negotiated by the call
+         * (WirePrecision::kFloat32 also accepts double chunks)
+         * @throws std::length_error if the data size matches no accepted
+         * encoding
          */
-        void AssignChunk(const Array &data);
+        void AssignChunk(const Array &data, WirePrecision precision = WirePrecision::kDouble);
 
     private:
         //! variable type
-        philote::VariableType type_;
+        philote::VariableType type_ = kInput;
 
         //! array shape
         std::vector<size_t> shape_;
 
-        //! raw data (serialized, row major)
-        std::vector<double> data_;
+        //! raw data (serialized, row major, aligned), unused for views
+        AlignedVector<double> data_;
+
+        //! external storage viewed by the variable (nullptr if owned)
+        double *view_ = nullptr;
+
+        //! number of elements of the viewed storage
+        size_t view_size_ = 0;
 
-        //! raw discrete data (serialized, row major)
-        std::vector<int64_t> discrete_data_;
+        //! mapped file viewed by the variable (nullptr if not file-backed)
+        std::shared_ptr<MappedFile> file_;
+
+        //! index of the first value in the mapped file
+        size_t file_offset_ = 0;
+
+        //! whether the variable holds integers
+        bool discrete_ = false;
+
+        //! raw discrete data (serialized, row major, aligned)
+        AlignedVector<int64_t> discrete_data_;
     };
 
     /**
@@ -401,7 +764,103 @@ namespace philote
         std::map<std::pair<std::string, std::string>, T> data_;
     };
 
+    /**
+     * @brief Decodes the values of a stream message
+     *
+     * Accepts the encodings of Variable::AssignChunk. Values sent in double
+     * precision are not copied; integers are converted to doubles.
+     *
+     * @param message stream message of a variable chunk
+     * @param buffer storage for values that have to be unpacked
+     * @param precision precision negotiated by the call
+     * @return const double* the message.end() - message.start() + 1 values
+     * (in the message or in the buffer)
+     * @throws std::invalid_argument if the indices are invalid
+     * @throws std::length_error if the data size matches no accepted
+     * encoding
+     */
+    const double *DecodeChunk(const Array &message, std::vector<double> &buffer,
+                              WirePrecision precision = WirePrecision::kDouble);
+
+    /**
+     * @brief Returns whether a stream message holds integer-encoded values
+     *
+     * The subname of such messages is not the subname of the variable, which
+     * is always empty for discrete variables.
+     *
+     * @param message stream message of a variable chunk
+     * @return true if the subname is kDiscreteChunkSubname
+     */
+    bool IsDiscreteChunk(const Array &message) noexcept;
+
+    /**
+     * @brief Allocates a variable in memory or in a memory-mapped file
+     *
+     * @param meta variable meta data
+     * @param storage placement of large variables
+     * @return Variable zero-initialized variable
+     */
+    Variable AllocateVariable(const philote::VariableMetaData &meta, const FileStorage &storage);
+
+    /**
+     * @brief Allocates a partial in memory or in a memory-mapped file
+     *
+     * @param meta partials meta data
+     * @param storage placement of large variables
+     * @return Variable zero-initialized partial
+     */
+    Variable AllocateVariable(const philote::PartialsMetaData &meta, const FileStorage &storage);
+
     typedef std::map<std::string, philote::Variable> Variables;
     typedef std::map<std::pair<std::string, std::string>, philote::Variable> Partials;
     typedef PairDict<philote::Variable> PartialsPairDict;
+
+    /**
+     * @brief Sparsity pattern of a partial derivative (coordinate format)
+     *
+     * A sparse partial stores only the declared non-zeros: element k of the
+     * partial's values is the derivative of element rows[k] of the
+     * (flattened) function with respect to element cols[k] of the (flattened)
+     * variable.
+     *
+     * @par Example
+     * @code
+     * // diagonal Jacobian of f (size 3) with respect to x (size 3)
+     * DeclarePartials("f", "x", {0, 1, 2}, {0, 1, 2});
+     *
+     * // ComputePartials fills the three non-zeros
+     * partials[{"f", "x"}](1) = 2.0;  // df[1]/dx[1]
+     * @endcode
+     */
+    struct SparsityPattern
+    {
+        //! row (flattened function index) of each non-zero
+        std::vector<int64_t> rows;
+
+        //! column (flattened variable index) of each non-zero
+        std::vector<int64_t> cols;
+
+        //! number of elements of the variable (columns of the dense partial)
+        int64_t num_cols = 0;
+
+        //! shape of the dense partial
+        std::vector<int64_t> dense_shape;
+
+        /**
+         * @brief Returns the number of non-zeros
+         */
+        size_t nnz() const noexcept { return rows.size(); }
+
+        /**
+         * @brief Expands sparse values into the dense partial
+         *
+         * @param values values of the non-zeros (size nnz())
+         * @return Variable dense partial of shape dense_shape
+         * @throws std::length_error if the number of values does not match
+         */
+        Variable Densify(const Variable &values) const;
+    };
+
+    //! Sparsity patterns of the sparse partials (dense partials have no entry)
+    typedef std::map<std::pair<std::string, std::string>, SparsityPattern> PartialsSparsity;
 }
\ No newline at end of file
@@ -0,0 +1,215 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <data.pb.h>
+#include <flat_variables.h>
+#include <variable.h>
+
+namespace philote
+{
+    /**
+     * @brief Preallocated variables used by the server to handle a compute RPC
+     *
+     * A workspace is built from the variable and partials meta data of a
+     * discipline and is reused by subsequent RPCs until the configuration of
+     * the discipline changes. This avoids rebuilding the variable maps (and
+     * their storage) on every call. Inputs, outputs, and residuals are each
+     * stored contiguously (see FlatVariables).
+     */
+    struct Workspace
+    {
+        //! configuration generation of the discipline the workspace was built for
+        uint64_t generation = 0;
+
+        //! number of variables the workspace was built for
+        size_t num_variables = 0;
+
+        //! number of partials the workspace was built for
+        size_t num_partials = 0;
+
+        //! input variables
+        FlatVariables inputs;
+
+        //! output variables
+        FlatVariables outputs;
+
+        //! residuals (implicit disciplines)
+        FlatVariables residuals;
+
+        //! partials of the discipline
+        Partials partials;
+
+        //! variable type by name
+        std::unordered_map<std::string, VariableType> types;
+
+        //! message buffer for reading the client stream
+        Array message;
+
+        /**
+         * @brief Builds the workspace from discipline meta data
+         *
+         * @param var_meta variable meta data
+         * @param partials_meta partials meta data
+         * @param generation configuration generation of the discipline
+         * @param storage placement of the outputs (see FileStorage)
+         */
+        Workspace(const std::vector<VariableMetaData> &var_meta,
+                  const std::vector<PartialsMetaData> &partials_meta,
+                  uint64_t generation,
+                  const FileStorage &storage = FileStorage());
+
+        /**
+         * @brief Sets all variables and partials to zero
+         */
+        void Zero();
+    };
+
+    /**
+     * @brief Thread-safe cache of workspaces of one discipline instance
+     *
+     * Every concurrent RPC obtains its own workspace. A discipline served by
+     * one RPC at a time (e.g., a pooled instance) therefore builds a single
+     * workspace per configuration.
+     */
+    class WorkspaceCache
+    {
+    public:
+        /**
+         * @brief Exclusive handle to a workspace
+         *
+         * The workspace is returned to its cache when the lease is destroyed.
+         */
+        class Lease
+        {
+        public:
+            Lease() = default;
+
+            Lease(const Lease &) = delete;
+            Lease &operator=(const Lease &) = delete;
+
+            Lease(Lease &&other) noexcept
+                : cache_(other.cache_), workspace_(std::move(other.workspace_))
+            {
+                other.cache_ = nullptr;
+            }
+
+            Lease &operator=(Lease &&other) noexcept
+            {
+                if (this != &other)
+                {
+                    Release();
+                    cache_ = other.cache_;
+                    workspace_ = std::move(other.workspace_);
+                    other.cache_ = nullptr;
+                }
+                return *this;
+            }
+
+            ~Lease() noexcept { Release(); }
+
+            //! Returns the leased workspace (nullptr for an empty lease)
+            Workspace *get() const noexcept { return workspace_.get(); }
+            Workspace *operator->() const noexcept { return workspace_.get(); }
+            Workspace &operator*() const noexcept { return *workspace_; }
+            explicit operator bool() const noexcept { return static_cast<bool>(workspace_); }
+
+        private:
+            friend class WorkspaceCache;
+
+            Lease(WorkspaceCache *cache, std::unique_ptr<Workspace> workspace)
+                : cache_(cache), workspace_(std::move(workspace)) {}
+
+            void Release() noexcept
+            {
+                if (cache_ && workspace_)
+                    cache_->Return(std::move(workspace_));
+                cache_ = nullptr;
+                workspace_.reset();
+            }
+
+            //! cache the workspace is returned to
+            WorkspaceCache *cache_ = nullptr;
+
+            //! leased workspace
+            std::unique_ptr<Workspace> workspace_;
+        };
+
+        /**
+         * @brief Obtains a zeroed workspace matching the meta data
+         *
+         * Reuses an idle workspace built for the same configuration
+         * generation, or builds a new one. Idle workspaces of older
+         * generations are discarded.
+         *
+         * @param var_meta variable meta data of the discipline
+         * @param partials_meta partials meta data of the discipline
+         * @param generation configuration generation of the discipline
+         * @param storage placement of the outputs of new workspaces
+         * @return Lease
+         */
+        Lease Acquire(const std::vector<VariableMetaData> &var_meta,
+                      const std::vector<PartialsMetaData> &partials_meta,
+                      uint64_t generation,
+                      const FileStorage &storage = FileStorage());
+
+        /**
+         * @brief Discards all idle workspaces
+         */
+        void Clear();
+
+        /**
+         * @brief Returns the number of idle workspaces
+         *
+         * @return size_t
+         */
+        size_t idle() const;
+
+    private:
+        /**
+         * @brief Returns a workspace to the cache
+         */
+        void Return(std::unique_ptr<Workspace> workspace) noexcept;
+
+        //! guards idle_
+        mutable std::mutex mutex_;
+
+        //! workspaces not in use
+        std::vector<std::unique_ptr<Workspace>> idle_;
+    };
+}
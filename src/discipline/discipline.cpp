@@ -28,6 +28,12 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include <google/protobuf/util/message_differencer.h>
+
 #include "discipline.h"
 
 using std::string;
@@ -38,6 +44,7 @@ using google::protobuf::Struct;
 using philote::Discipline;
 using philote::DisciplineProperties;
 using philote::StreamOptions;
+using philote::VariableMetaData;
 
 Discipline::Discipline()
 {
@@ -45,6 +52,33 @@ Discipline::Discipline()
     stream_opts_.set_num_double(1000);
 }
 
+void Discipline::OnInputReady(const std::string &name, const philote::Variable &value)
+{
+    // This method is intended to be overridden by derived classes
+}
+
+void Discipline::SetMaxMessageBytes(size_t bytes)
+{
+    if (bytes == 0 || bytes > static_cast<size_t>(std::numeric_limits<int>::max()))
+        throw std::invalid_argument("Maximum message size must be in [1, INT_MAX] bytes.");
+
+    max_message_bytes_ = bytes;
+}
+
+size_t Discipline::max_message_bytes() const noexcept
+{
+    return max_message_bytes_ > 0 ? max_message_bytes_ : philote::kDefaultMaxMessageBytes;
+}
+
+void Discipline::ApplyMessageLimits(grpc::ServerBuilder &builder) const
+{
+    if (max_message_bytes_ == 0)
+        return;
+
+    builder.SetMaxReceiveMessageSize(static_cast<int>(max_message_bytes_));
+    builder.SetMaxSendMessageSize(static_cast<int>(max_message_bytes_));
+}
+
 std::map<std::string, std::string> &Discipline::options_list()
 {
     return options_list_;
@@ -67,6 +101,7 @@ void Discipline::AddInput(const string &name,
     var.set_type(philote::kInput);
 
     var_meta().push_back(var);
+    var_index_.Update(var_meta_);
 }
 
 void Discipline::AddOutput(const string &name,
@@ -81,50 +116,69 @@ void Discipline::AddOutput(const string &name,
     var.set_type(philote::kOutput);
 
     var_meta().push_back(var);
+    var_index_.Update(var_meta_);
+}
+
+void Discipline::AddDiscreteInput(const string &name,
+                                  const vector<int64_t> &shape,
+                                  const string &units)
+{
+    AddInput(name, shape, units);
+    discrete_variables_.insert(name);
+}
+
+void Discipline::AddDiscreteOutput(const string &name,
+                                   const vector<int64_t> &shape,
+                                   const string &units)
+{
+    AddOutput(name, shape, units);
+    discrete_variables_.insert(name);
+}
+
+bool Discipline::IsDiscrete(const string &name) const
+{
+    return discrete_variables_.count(name) > 0;
+}
+
+const VariableMetaData *Discipline::FindVariableMeta(const string &name) const
+{
+    return var_index_.Find(var_meta_, name);
+}
+
+void Discipline::ClearMetaData()
+{
+    var_meta_.clear();
+    partials_meta_.clear();
+    partials_sparsity_.clear();
+    discrete_variables_.clear();
+    var_index_.Clear();
 }
 
 vector<int64_t> Discipline::ComputePartialShape(const string &f,
                                                  const string &x,
                                                  bool allow_output_as_x)
 {
+    if (IsDiscrete(f) or IsDiscrete(x))
+        throw std::invalid_argument("Partials (" + f + ", " + x + ") of a discrete variable cannot be declared");
+
     // determine and assign the shape of the partials array
     vector<int64_t> shape_f, shape_x;
     bool found_f = false, found_x = false;
 
     // First find the output variable shape
-    for (const auto &var : var_meta_)
+    const VariableMetaData *var_f = FindVariableMeta(f);
+    if (var_f and var_f->type() == kOutput)
     {
-        if (var.name() == f and var.type() == kOutput)
-        {
-            for (const auto &dim : var.shape())
-                shape_f.push_back(dim);
-            found_f = true;
-        }
+        shape_f.assign(var_f->shape().begin(), var_f->shape().end());
+        found_f = true;
     }
 
     // Then find the input (or output for implicit) variable shape
-    for (const auto &var : var_meta_)
+    const VariableMetaData *var_x = FindVariableMeta(x);
+    if (var_x and (var_x->type() == kInput or (allow_output_as_x and var_x->type() == kOutput)))
     {
-        if (allow_output_as_x)
-        {
-            // For implicit disciplines, x can be either input or output
-            if (var.name() == x and (var.type() == kInput or var.type() == kOutput))
-            {
-                for (const auto &dim : var.shape())
-                    shape_x.push_back(dim);
-                found_x = true;
-            }
-        }
-        else
-        {
-            // For explicit disciplines, x must be an input
-            if (var.name() == x and var.type() == kInput)
-            {
-                for (const auto &dim : var.shape())
-                    shape_x.push_back(dim);
-                found_x = true;
-            }
-        }
+        shape_x.assign(var_x->shape().begin(), var_x->shape().end());
+        found_x = true;
     }
 
     if (!found_f || !found_x)
@@ -178,9 +232,75 @@ void Discipline::DeclarePartials(const string &f, const string &x)
     partials_meta().push_back(meta);
 }
 
-void Discipline::AddOption(const string &name, const string &type)
+void Discipline::DeclarePartials(const string &f, const string &x,
+                                 const vector<int64_t> &rows,
+                                 const vector<int64_t> &cols)
+{
+    DeclareSparsePartials(f, x, rows, cols, false);
+}
+
+void Discipline::DeclareSparsePartials(const string &f,
+                                       const string &x,
+                                       const vector<int64_t> &rows,
+                                       const vector<int64_t> &cols,
+                                       bool allow_output_as_x)
+{
+    vector<int64_t> shape = ComputePartialShape(f, x, allow_output_as_x);
+
+    if (rows.size() != cols.size())
+        throw std::invalid_argument("Sparse partials (" + f + ", " + x +
+                                    ") need the same number of rows and cols");
+
+    // number of elements of the function and the variable
+    // (both variables were found by ComputePartialShape)
+    int64_t num_rows = 1, num_cols = 1;
+    for (const auto &dim : FindVariableMeta(f)->shape())
+        num_rows *= dim;
+    for (const auto &dim : FindVariableMeta(x)->shape())
+        num_cols *= dim;
+
+    vector<int64_t> indices(rows.size());
+    for (size_t k = 0; k < rows.size(); k++)
+    {
+        if (rows[k] < 0 or rows[k] >= num_rows or cols[k] < 0 or cols[k] >= num_cols)
+            throw std::out_of_range("Sparse partials (" + f + ", " + x + ") entry " +
+                                    std::to_string(k) + " out of range");
+        indices[k] = rows[k] * num_cols + cols[k];
+    }
+
+    std::sort(indices.begin(), indices.end());
+    if (std::adjacent_find(indices.begin(), indices.end()) != indices.end())
+        throw std::invalid_argument("Sparse partials (" + f + ", " + x + ") contain duplicate entries");
+
+    SparsityPattern pattern;
+    pattern.rows = rows;
+    pattern.cols = cols;
+    pattern.num_cols = num_cols;
+    pattern.dense_shape = shape;
+    partials_sparsity_[std::make_pair(f, x)] = std::move(pattern);
+
+    // only the non-zeros are stored
+    PartialsMetaData meta;
+    meta.set_name(f);
+    meta.set_subname(x);
+    meta.add_shape(static_cast<int64_t>(rows.size()));
+
+    partials_meta_.push_back(meta);
+}
+
+void Discipline::AddOption(const string &name, const string &type, bool affects_shape)
 {
     options_list_[name] = type;
+
+    if (affects_shape)
+        shapeless_options_.erase(name);
+    else
+        shapeless_options_.insert(name);
+}
+
+bool Discipline::OptionAffectsShape(const std::string &name) const
+{
+    return shapeless_options_.count(name) == 0;
 }
 
 void Discipline::Initialize()
@@ -215,6 +335,27 @@ void Discipline::SetOptions(const google::protobuf::Struct &options_struct)
     //
     // Call configure after options are set
     Configure();
+
+    // remember the options so that the configuration can be replayed onto
+    // other instances of the discipline
+    bool affects_shape = false;
+    for (const auto &field : options_struct.fields())
+    {
+        auto &applied = *applied_options_.mutable_fields();
+        auto previous = applied.find(field.first);
+        if (OptionAffectsShape(field.first) and
+            (previous == applied.end() or
+             !google::protobuf::util::MessageDifferencer::Equals(previous->second, field.second)))
+            affects_shape = true;
+
+        applied[field.first] = field.second;
+    }
+
+    // options that leave the definitions unchanged keep the workspaces
+    configuration_generation_++;
+    options_generation_++;
+    if (affects_shape)
+        layout_generation_++;
 }
 
 void Discipline::Setup()
@@ -225,19 +366,169 @@ void Discipline::SetupPartials()
 {
 }
 
-void Discipline::SetContext(grpc::ServerContext* context) const noexcept
+void Discipline::SetContext(grpc::ServerContextBase* context) const noexcept
 {
+    ClearContext();
     current_context_ = context;
+    if (context == nullptr)
+        return;
+
+    // the monitor sets the token, so that polling it stays cheap
+    try
+    {
+        cancellation_ = philote::CancellationMonitor::Instance().Watch(context);
+        watching_ = true;
+    }
+    catch (...)
+    {
+        // IsCancelled falls back to querying the context
+        watching_ = false;
+    }
 }
 
 void Discipline::ClearContext() const noexcept
 {
+    if (watching_)
+        philote::CancellationMonitor::Instance().Unwatch(current_context_);
+    watching_ = false;
     current_context_ = nullptr;
 }
 
 bool Discipline::IsCancelled() const noexcept
 {
-    return current_context_ != nullptr && current_context_->IsCancelled();
+    if (current_context_ == nullptr)
+        return false;
+
+    return watching_ ? cancellation_.IsCancelled() : current_context_->IsCancelled();
+}
+
+void Discipline::CopyConfiguration(const Discipline &source)
+{
+    stream_opts_ = source.stream_opts();
+    max_message_bytes_ = source.max_message_bytes_;
+    input_ready_notifications_ = source.input_ready_notifications_;
+    file_storage_ = source.file_storage_;
+
+    if (source.applied_options().fields_size() > 0)
+    {
+        // copy first, since SetOptions may be overridden to modify the struct
+        Struct options = source.applied_options();
+        SetOptions(options);
+    }
+
+    // the definitions only need to be rebuilt if the layout of the source
+    // changed since the last copy
+    const bool set_up = !source.var_meta().empty() or !source.partials_meta().empty();
+    const bool current = !var_meta_.empty() or !partials_meta_.empty();
+    if (set_up != current or copied_layout_generation_ != source.layout_generation())
+    {
+        ClearMetaData();
+        if (set_up)
+        {
+            Setup();
+            SetupPartials();
+        }
+
+        copied_layout_generation_ = source.layout_generation();
+        MarkConfigurationChanged();
+    }
+    else
+    {
+        configuration_generation_++;
+    }
+}
+
+void Discipline::SetAssemblyThreads(size_t threads)
+{
+    if (threads == 0)
+        assembly_pool_.reset();
+    else
+        assembly_pool_ = std::make_shared<philote::ThreadPool>(threads);
+}
+
+void Discipline::SetAdmissionLimits(const philote::AdmissionLimits &limits)
+{
+    // admitted calls refer to the controller, so it is kept once created
+    // and zero limits only disable its checks
+    const bool limited = limits.max_concurrent > 0 or limits.max_queued > 0 or limits.max_buffered_bytes > 0;
+    if (!admission_ and !limited)
+        return;
+
+    if (!admission_)
+        admission_ = std::make_shared<philote::AdmissionController>();
+    admission_->SetLimits(limits);
 }
 
-philote::Discipline::~Discipline() noexcept = default;
\ No newline at end of file
+void Discipline::SetFileStorage(const philote::FileStorage &storage)
+{
+    file_storage_ = storage;
+
+    // workspaces of the previous placement are discarded
+    MarkConfigurationChanged();
+}
+
+philote::WorkspaceCache::Lease Discipline::AcquireWorkspace() const
+{
+    return workspaces_.Acquire(var_meta_, partials_meta_, layout_generation(), file_storage_);
+}
+
+philote::Discipline::~Discipline() noexcept
+{
+    ClearContext();
+}
+
+philote::InputReadyTracker::InputReadyTracker(Discipline *discipline)
+    : discipline_(discipline && discipline->input_ready_notifications() ? discipline : nullptr)
+{
+}
+
+grpc::Status philote::InputReadyTracker::Received(const std::string &name,
+                                                  const Variable &value,
+                                                  size_t count)
+{
+    if (discipline_ == nullptr)
+        return grpc::Status::OK;
+
+    // OnInputReady is called under the lock, so it is never called concurrently
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t &received = received_[name];
+    const bool was_complete = received >= value.Size();
+    received += count;
+    if (was_complete or received < value.Size())
+        return grpc::Status::OK;
+
+    try
+    {
+        discipline_->OnInputReady(name, value);
+    }
+    catch (const std::exception &e)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                            "OnInputReady failed for variable " + name + ": " + e.what());
+    }
+
+    return grpc::Status::OK;
+}
+
+grpc::Status philote::InputReadyTracker::Complete(const Variables &values)
+{
+    if (discipline_ == nullptr)
+        return grpc::Status::OK;
+
+    for (const auto &entry : values)
+    {
+        size_t received = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            received = received_[entry.first];
+        }
+        if (received >= entry.second.Size())
+            continue;
+
+        grpc::Status status = Received(entry.first, entry.second, entry.second.Size() - received);
+        if (!status.ok())
+            return status;
+    }
+
+    return grpc::Status::OK;
+}
@@ -28,7 +28,16 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "definition_cache.h"
 #include "discipline_client.h"
+#include "protocol_extensions.h"
 
 using google::protobuf::Empty;
 using grpc::ChannelInterface;
@@ -51,6 +60,10 @@ DisciplineClient::DisciplineClient()
 void DisciplineClient::ConnectChannel(const std::shared_ptr<grpc::ChannelInterface> &channel)
 {
     stub_ = DisciplineService::NewStub(channel);
+    result_generation_++;
+    definitions_hash_.clear();
+    definitions_current_ = false;
+    partials_defined_ = false;
 }
 
 void DisciplineClient::GetInfo()
@@ -59,7 +72,9 @@ void DisciplineClient::GetInfo()
     context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
     Empty request;
 
+    ClientCallSpan span = TraceCall("GetInfo", context);
     auto status = stub_->GetInfo(&context, request, &properties_);
+    span.Finish(status);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -73,6 +88,36 @@ void DisciplineClient::GetInfo()
                                status.error_message();
         throw std::runtime_error(error_msg);
     }
+
+    // record the protocol extensions supported by the server
+    server_features_ = ParseFeatures(FindMetadata(context.GetServerTrailingMetadata(),
+                                                  kFeaturesMetadataKey));
+    server_host_id_ = FindMetadata(context.GetServerTrailingMetadata(), kHostIdMetadataKey);
+
+    // derive the chunk size from the message size limits of both sides
+    size_t server_max = 0;
+    if (negotiate_chunk_size_ and ServerSupports(kFeatureChunkNegotiation) and
+        ParseIndex(FindMetadata(context.GetServerTrailingMetadata(), kMaxMessageBytesMetadataKey),
+                   static_cast<size_t>(std::numeric_limits<int>::max()) + 1, server_max) and
+        server_max > 0)
+    {
+        const size_t limit = std::min(max_message_bytes_, server_max);
+        stream_options_.set_num_double(static_cast<int64_t>(ChunkSizeForMessageBytes(limit)));
+        SendStreamOptions();
+    }
+}
+
+void DisciplineClient::SetMaxMessageBytes(size_t bytes)
+{
+    if (bytes == 0)
+        throw std::invalid_argument("Maximum message size must be positive.");
+
+    max_message_bytes_ = bytes;
+}
+
+bool DisciplineClient::ServerSupports(const std::string &feature) const noexcept
+{
+    return server_features_.count(feature) > 0;
 }
 
 void DisciplineClient::SendStreamOptions()
@@ -81,7 +126,9 @@ void DisciplineClient::SendStreamOptions()
     context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
     ::google::protobuf::Empty response;
 
+    ClientCallSpan span = TraceCall("SetStreamOptions", context);
     auto status = stub_->SetStreamOptions(&context, stream_options_, &response);
+    span.Finish(status);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -96,11 +143,16 @@ void DisciplineClient::SendStreamOptions()
 
 void DisciplineClient::SendOptions(const DisciplineOptions &options)
 {
+    // cached results may depend on the previous configuration
+    result_generation_++;
+
     ClientContext context;
     context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
     ::google::protobuf::Empty response;
 
+    ClientCallSpan span = TraceCall("SetOptions", context);
     auto status = stub_->SetOptions(&context, options, &response);
+    span.Finish(status);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -111,15 +163,35 @@ void DisciplineClient::SendOptions(const DisciplineOptions &options)
         }
         throw std::runtime_error("Failed to set options: " + status.error_message());
     }
+
+    // the meta data stays valid if the server applied the options in place
+    const auto &trailing = context.GetServerTrailingMetadata();
+    size_t generation = 0;
+    options_generation_ = ParseIndex(FindMetadata(trailing, kOptionsGenerationMetadataKey),
+                                     std::numeric_limits<size_t>::max(), generation)
+                              ? generation
+                              : 0;
+    definitions_current_ = ServerSupports(kFeatureOptionsHotReload) and !var_meta_.empty() and
+                           FindMetadata(trailing, kSetupRequiredMetadataKey) == "0";
 }
 
 void DisciplineClient::Setup()
 {
+    // the server applied the last options without changing the definitions
+    if (definitions_current_)
+        return;
+
+    // cached results may depend on the previous configuration
+    result_generation_++;
+    definitions_hash_.clear();
+
     ClientContext context;
     context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
     ::google::protobuf::Empty request, response;
 
+    ClientCallSpan span = TraceCall("Setup", context);
     auto status = stub_->Setup(&context, request, &response);
+    span.Finish(status);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -130,70 +202,473 @@ void DisciplineClient::Setup()
         }
         throw std::runtime_error("Failed to setup discipline: " + status.error_message());
     }
+
+    // identifies the definitions in a definition cache
+    definitions_hash_ = FindMetadata(context.GetServerTrailingMetadata(), kDefinitionsHashMetadataKey);
 }
 
 void DisciplineClient::GetVariableDefinitions()
 {
-    ClientContext context;
-    context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
-    Empty request;
-    std::unique_ptr<grpc::ClientReaderInterface<philote::VariableMetaData>> reactor;
+    if (definitions_current_ and !var_meta_.empty())
+        return;
+
+    // cached results may depend on the previous configuration
+    result_generation_++;
 
     if (!var_meta_.empty())
     {
         // clear any existing meta data
         var_meta_.clear();
     }
-    // get the meta data
-    reactor = stub_->GetVariableDefinitions(&context, request);
+    var_index_.Clear();
+    discrete_variables_.clear();
 
-    VariableMetaData meta;
-    while (reactor->Read(&meta))
-        var_meta_.push_back(meta);
+    // request the discrete markers if the server can send them
+    const bool discrete = ServerSupports(kFeatureDiscreteVariables);
 
-    auto status = reactor->Finish();
-    if (!status.ok())
+    std::vector<VariableMetaData> messages;
+    if (!definition_cache_ or !definition_cache_->LoadVariables(definitions_hash_, messages, discrete))
     {
-        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+        ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
+        Empty request;
+        std::unique_ptr<grpc::ClientReaderInterface<philote::VariableMetaData>> reactor;
+
+        if (discrete)
+            context.AddMetadata(kDiscreteVariablesMetadataKey, "1");
+
+        ClientCallSpan span = TraceCall("GetVariableDefinitions", context);
+
+        // get the meta data
+        reactor = stub_->GetVariableDefinitions(&context, request);
+
+        VariableMetaData meta;
+        while (reactor->Read(&meta))
+            messages.push_back(meta);
+
+        auto status = reactor->Finish();
+        span.Finish(status);
+        if (!status.ok())
         {
-            throw std::runtime_error("RPC timeout after " +
-                                   std::to_string(rpc_timeout_.count()) +
-                                   "ms: " + status.error_message());
+            if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+            {
+                throw std::runtime_error("RPC timeout after " +
+                                       std::to_string(rpc_timeout_.count()) +
+                                       "ms: " + status.error_message());
+            }
+            throw std::runtime_error("Failed to get variable definitions: " + status.error_message());
         }
-        throw std::runtime_error("Failed to get variable definitions: " + status.error_message());
+
+        if (definition_cache_)
+            definition_cache_->StoreVariables(definitions_hash_, messages, discrete);
     }
+
+    // discrete markers follow the meta data of their variable
+    for (VariableMetaData &meta : messages)
+    {
+        if (IsDiscreteMarker(meta))
+            discrete_variables_.insert(meta.name());
+        else
+            var_meta_.push_back(std::move(meta));
+    }
+    var_index_.Update(var_meta_);
 }
 
 void DisciplineClient::GetPartialDefinitions()
 {
-    ClientContext context;
-    context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
-    Empty request;
-    std::unique_ptr<grpc::ClientReaderInterface<philote::PartialsMetaData>> reactor;
+    if (definitions_current_ and partials_defined_)
+        return;
+
+    // cached results may depend on the previous configuration
+    result_generation_++;
 
     if (!partials_meta_.empty())
     {
         // clear any existing meta data
         partials_meta_.clear();
     }
-    // get the meta data
-    reactor = stub_->GetPartialDefinitions(&context, request);
+    partials_sparsity_.clear();
 
-    PartialsMetaData meta;
-    while (reactor->Read(&meta))
-        partials_meta_.push_back(meta);
+    // request the sparsity patterns if the server can send them
+    sparse_partials_ = ServerSupports(kFeatureSparsePartials);
 
-    auto status = reactor->Finish();
-    if (!status.ok())
+    std::vector<PartialsMetaData> messages;
+    if (!definition_cache_ or !definition_cache_->LoadPartials(definitions_hash_, sparse_partials_, messages))
     {
-        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+        ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + rpc_timeout_);
+        Empty request;
+        std::unique_ptr<grpc::ClientReaderInterface<philote::PartialsMetaData>> reactor;
+
+        if (sparse_partials_)
+            context.AddMetadata(kSparsePartialsMetadataKey, "1");
+
+        ClientCallSpan span = TraceCall("GetPartialDefinitions", context);
+
+        // get the meta data
+        reactor = stub_->GetPartialDefinitions(&context, request);
+
+        PartialsMetaData meta;
+        while (reactor->Read(&meta))
+            messages.push_back(meta);
+
+        auto status = reactor->Finish();
+        span.Finish(status);
+        if (!status.ok())
         {
-            throw std::runtime_error("RPC timeout after " +
-                                   std::to_string(rpc_timeout_.count()) +
-                                   "ms: " + status.error_message());
+            if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+            {
+                throw std::runtime_error("RPC timeout after " +
+                                       std::to_string(rpc_timeout_.count()) +
+                                       "ms: " + status.error_message());
+            }
+            throw std::runtime_error("Failed to get partial definitions: " + status.error_message());
         }
-        throw std::runtime_error("Failed to get partial definitions: " + status.error_message());
+
+        if (definition_cache_)
+            definition_cache_->StorePartials(definitions_hash_, sparse_partials_, messages);
     }
+
+    for (const PartialsMetaData &meta : messages)
+    {
+        if (!IsSparsityPatternMessage(meta))
+        {
+            partials_meta_.push_back(meta);
+            continue;
+        }
+
+        // a pattern follows the (dense) meta data of its partial
+        if (partials_meta_.empty() or partials_meta_.back().name() != meta.name() or
+            partials_meta_.back().subname() != meta.subname())
+        {
+            throw std::runtime_error("Failed to get partial definitions: unexpected sparsity pattern for (" +
+                                     meta.name() + ", " + meta.subname() + ")");
+        }
+
+        SparsityPattern &pattern = partials_sparsity_[std::make_pair(meta.name(), meta.subname())];
+        if (pattern.dense_shape.empty())
+            pattern.dense_shape.assign(partials_meta_.back().shape().begin(),
+                                       partials_meta_.back().shape().end());
+        try
+        {
+            DecodeSparsityPattern(meta, pattern);
+        }
+        catch (const std::exception &e)
+        {
+            throw std::runtime_error(std::string("Failed to get partial definitions: ") + e.what());
+        }
+    }
+
+    // sparse partials only carry their non-zeros
+    for (PartialsMetaData &partial : partials_meta_)
+    {
+        auto pattern = partials_sparsity_.find(std::make_pair(partial.name(), partial.subname()));
+        if (pattern == partials_sparsity_.end())
+            continue;
+
+        partial.clear_shape();
+        partial.add_shape(static_cast<int64_t>(pattern->second.nnz()));
+    }
+
+    partials_defined_ = true;
+}
+
+void DisciplineClient::CopyDefinitions(const DisciplineClient &source)
+{
+    // cached results may depend on the previous configuration
+    result_generation_++;
+
+    properties_ = source.properties_;
+    server_features_ = source.server_features_;
+    stream_options_ = source.stream_options_;
+    var_meta_ = source.var_meta_;
+    var_index_.Clear();
+    var_index_.Update(var_meta_);
+    partials_meta_ = source.partials_meta_;
+    partials_sparsity_ = source.partials_sparsity_;
+    sparse_partials_ = source.sparse_partials_;
+    server_host_id_.clear();
+}
+
+void DisciplineClient::AddPartialsMetadata(grpc::ClientContext &context) const
+{
+    if (sparse_partials_)
+        context.AddMetadata(kSparsePartialsMetadataKey, "1");
+}
+
+void DisciplineClient::SetWirePrecision(WirePrecision precision)
+{
+    if (precision == WirePrecision::kInteger)
+        throw std::invalid_argument("Integer encoding is reserved for discrete variables in SetWirePrecision");
+
+    wire_precision_ = precision;
+
+    // results cached at the previous precision must not be returned
+    result_generation_++;
+}
+
+philote::WirePrecision DisciplineClient::SendPrecision() const noexcept
+{
+    if (ServerSupports(kFeatureWirePrecision))
+        return wire_precision_;
+
+    return WirePrecision::kDouble;
+}
+
+philote::WirePrecision DisciplineClient::SendPrecision(const std::string &name) const
+{
+    if (IsDiscrete(name))
+        return WirePrecision::kInteger;
+
+    return SendPrecision();
+}
+
+void DisciplineClient::AddWirePrecisionMetadata(grpc::ClientContext &context) const
+{
+    if (SendPrecision() == WirePrecision::kFloat32)
+        context.AddMetadata(kWirePrecisionMetadataKey, kWirePrecisionFloat32);
+
+    // the discrete variables are only known if the server supports them
+    if (!discrete_variables_.empty())
+        context.AddMetadata(kDiscreteVariablesMetadataKey, "1");
+}
+
+philote::Variable DisciplineClient::AllocateResult(const VariableMetaData &meta) const
+{
+    if (IsDiscrete(meta.name()))
+        return Variable(meta.type(), vector<size_t>(meta.shape().begin(), meta.shape().end()), kDiscrete);
+
+    return AllocateVariable(meta, file_storage_);
+}
+
+void DisciplineClient::SetCompression(const CompressionPolicy &policy)
+{
+    compression_ = policy;
+
+    // open evaluation streams were started with the previous policy
+    result_generation_++;
+}
+
+void DisciplineClient::ApplyCompression(grpc::ClientContext &context) const
+{
+    if (!compression_.Enabled())
+        return;
+
+    // any gRPC server decompresses the client messages, but only servers
+    // with the extension compress their results on request
+    context.set_compression_algorithm(compression_.algorithm);
+    if (ServerSupports(kFeatureCompression))
+        context.AddMetadata(kCompressionMetadataKey, FormatCompressionPolicy(compression_));
+}
+
+ClientCallSpan DisciplineClient::TraceCall(const std::string &rpc, grpc::ClientContext &context) const
+{
+    return ClientCallSpan(tracer_.get(), trace_parent_, rpc, context);
+}
+
+ClientCallSpan DisciplineClient::TraceCall(const std::string &rpc) const
+{
+    return ClientCallSpan(tracer_.get(), trace_parent_, rpc);
+}
+
+bool DisciplineClient::UsesSharedMemory() const
+{
+    return shared_memory_ and ServerSupports(kFeatureSharedMemory) and !server_host_id_.empty() and
+           server_host_id_ == SharedMemoryHostId();
+}
+
+philote::SharedMemoryTransfer DisciplineClient::AcquireSharedMemory(grpc::ClientContext &context)
+{
+    if (!UsesSharedMemory())
+        return SharedMemoryTransfer();
+
+    // room for the largest possible call: all variables and all partials
+    size_t size = 0;
+    for (const auto &var : var_meta_)
+    {
+        size_t n = 1;
+        for (const int64_t dim : var.shape())
+            n *= static_cast<size_t>(dim);
+        size += n;
+    }
+    for (const auto &par : partials_meta_)
+    {
+        size_t n = 1;
+        for (const int64_t dim : par.shape())
+            n *= static_cast<size_t>(dim);
+        size += n;
+    }
+
+    if (!shared_segment_ or shared_segment_->size() < size)
+    {
+        try
+        {
+            shared_segment_.reset();
+            shared_segment_ = SharedMemorySegment::Create(size);
+        }
+        catch (const std::exception &)
+        {
+            // fall back to sending the values over gRPC
+            return SharedMemoryTransfer();
+        }
+    }
+
+    context.AddMetadata(kSharedMemoryMetadataKey, shared_segment_->name());
+    return SharedMemoryTransfer(shared_segment_);
+}
+
+void DisciplineClient::SendVariable(const std::string &name, const Variable &var, SharedMemoryTransfer &shared,
+                                    ChunkPipeline *pipeline, const InputSession *session) const
+{
+    // discrete values are sent as packed integers (or as doubles to servers without them)
+    if (var.IsDiscrete() or IsDiscrete(name))
+        var.Send(name, "", pipeline, stream_options_.num_double(), SendPrecision(name));
+    else if (shared)
+        shared.Send(name, "", var, pipeline);
+    else if (session)
+        session->Send(name, var, pipeline, stream_options_.num_double(), SendPrecision());
+    else
+        var.Send(name, "", pipeline, stream_options_.num_double(), SendPrecision());
+}
+
+void DisciplineClient::EnableInputSession(bool enable)
+{
+    if (!enable)
+        input_session_.reset();
+    else if (!input_session_)
+        input_session_ = std::make_unique<InputSession>();
+}
+
+bool DisciplineClient::UsesInputSession() const
+{
+    return input_session_ and ServerSupports(kFeatureInputSessions);
+}
+
+bool DisciplineClient::UsesEvaluationStreams() const
+{
+    return evaluation_streams_ and ServerSupports(kFeatureEvaluationStreams) and !UsesSharedMemory() and
+           !UsesInputSession();
+}
+
+philote::InputSession *DisciplineClient::BeginInputSession(grpc::ClientContext &context,
+                                                           const SharedMemoryTransfer &shared)
+{
+    if (shared or !UsesInputSession())
+        return nullptr;
+
+    // the server layout may have changed since the previous call
+    if (input_session_generation_ != result_generation_)
+    {
+        input_session_->Reset();
+        input_session_generation_ = result_generation_;
+    }
+
+    context.AddMetadata(kInputSessionMetadataKey, input_session_->Begin());
+    return input_session_.get();
+}
+
+bool DisciplineClient::EndInputSession(InputSession *session, const grpc::Status &status)
+{
+    if (!session)
+        return false;
+
+    if (status.ok())
+    {
+        session->Commit();
+        return false;
+    }
+
+    const bool retry = session->IsDelta() and status.error_code() == grpc::StatusCode::FAILED_PRECONDITION;
+    session->Reset();
+    return retry;
+}
+
+bool DisciplineClient::PipelineSends(const Variables &vars) const noexcept
+{
+    size_t total = 0;
+    for (const auto &var : vars)
+        total += var.second.Size();
+
+    return total >= pipeline_threshold_;
+}
+
+void DisciplineClient::SetBackoff(const BackoffPolicy &policy)
+{
+    if (policy.initial.count() < 0 or policy.max.count() < 0)
+        throw std::invalid_argument("The backoff delays must not be negative.");
+    if (!(policy.multiplier >= 1.0))
+        throw std::invalid_argument("The backoff multiplier must be at least one.");
+
+    backoff_ = policy;
+}
+
+void DisciplineClient::AddInputBytesMetadata(grpc::ClientContext &context, const Variables &vars) const
+{
+    if (!ServerSupports(kFeatureAdmissionControl))
+        return;
+
+    // an upper bound of the message bytes (values are sent as doubles at most)
+    size_t bytes = 0;
+    for (const auto &var : vars)
+        bytes += var.second.Size() * sizeof(double);
+
+    context.AddMetadata(kInputBytesMetadataKey, std::to_string(bytes));
+}
+
+thread_local DisciplineClient::BackoffScope *DisciplineClient::BackoffScope::current_ = nullptr;
+
+DisciplineClient::BackoffScope::BackoffScope(const DisciplineClient &client)
+    : client_(&client), outer_(current_), counter_(this)
+{
+    // a repeated call continues the count of the call repeating it
+    if (outer_ and outer_->client_ == client_)
+        counter_ = outer_->counter_;
+
+    current_ = this;
+}
+
+DisciplineClient::BackoffScope::~BackoffScope()
+{
+    current_ = outer_;
+}
+
+bool DisciplineClient::BackOff(const grpc::Status &status, std::chrono::milliseconds retry_after)
+{
+    BackoffScope *scope = BackoffScope::current_;
+    if (!scope or scope->client_ != this)
+        return false;
+    size_t &attempts = scope->counter_->attempts_;
+
+    // only admission control rejections carry a retry-after hint
+    if (status.error_code() != grpc::StatusCode::RESOURCE_EXHAUSTED or retry_after.count() <= 0 or
+        attempts >= backoff_.max_retries)
+        return false;
+
+    // jitter keeps rejected clients from retrying in lockstep
+    thread_local std::mt19937 engine(std::random_device{}());
+    std::uniform_real_distribution<double> jitter(1.0, 1.5);
+    double delay = static_cast<double>(backoff_.initial.count()) *
+                   std::pow(backoff_.multiplier, static_cast<double>(attempts)) * jitter(engine);
+    delay = std::min(delay, static_cast<double>(backoff_.max.count()));
+
+    // the server knows best when capacity frees up
+    delay = std::max(delay, static_cast<double>(retry_after.count()));
+
+    attempts++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int64_t>(delay)));
+
+    return true;
+}
+
+bool DisciplineClient::BackOff(const grpc::Status &status, const grpc::ClientContext &context)
+{
+    size_t hint = 0;
+    if (status.error_code() != grpc::StatusCode::RESOURCE_EXHAUSTED or
+        !ParseIndex(FindMetadata(context.GetServerTrailingMetadata(), kRetryAfterMetadataKey),
+                    std::numeric_limits<size_t>::max(), hint))
+        hint = 0;
+
+    return BackOff(status, std::chrono::milliseconds(hint));
 }
 
 vector<string> DisciplineClient::GetVariableNames()
@@ -210,13 +685,9 @@ vector<string> DisciplineClient::GetVariableNames()
 
 VariableMetaData DisciplineClient::GetVariableMeta(const string &name)
 {
-    for (const auto &var : var_meta_)
-    {
-        if (var.name() == name)
-        {
-            return var;
-        }
-    }
+    const VariableMetaData *var = var_index_.Find(var_meta_, name);
+    if (var)
+        return *var;
 
     throw std::runtime_error("Variable not found: " + name);
 }
@@ -28,8 +28,13 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <algorithm>
+
+#include "definition_cache.h"
 #include "discipline_server.h"
 #include "discipline.h"
+#include "protocol_extensions.h"
+#include "shared_memory.h"
 
 using std::string;
 using std::vector;
@@ -62,6 +67,7 @@ bool DisciplineServer::DisciplinePointerNull() noexcept
 void DisciplineServer::LinkPointers(std::shared_ptr<philote::Discipline> discipline)
 {
     discipline_ = discipline;
+    set_up_ = false;
 }
 
 void DisciplineServer::UnlinkPointers()
@@ -81,6 +87,15 @@ grpc::Status DisciplineServer::GetInfo(ServerContext *context,
 
     *response = discipline_->properties();
 
+    // advertise the supported protocol extensions
+    if (context)
+    {
+        context->AddTrailingMetadata(kFeaturesMetadataKey, SupportedFeatures());
+        context->AddTrailingMetadata(kMaxMessageBytesMetadataKey,
+                                     std::to_string(discipline_->max_message_bytes()));
+        context->AddTrailingMetadata(kHostIdMetadataKey, SharedMemoryHostId());
+    }
+
     return Status::OK;
 }
 
@@ -96,6 +111,13 @@ Status DisciplineServer::SetStreamOptions(ServerContext *context,
 
     discipline_->stream_opts() = *request;
 
+    // keep the chunks sent by the server within its message size limit
+    const int64_t max_chunk = static_cast<int64_t>(ChunkSizeForMessageBytes(discipline_->max_message_bytes()));
+    if (discipline_->stream_opts().num_double() > max_chunk)
+        discipline_->stream_opts().set_num_double(max_chunk);
+
+    discipline_->MarkConfigurationChanged();
+
     return Status::OK;
 }
 
@@ -113,6 +135,16 @@ grpc::Status DisciplineServer::SetOptions(ServerContext *context,
 
     discipline_->SetOptions(options);
 
+    // options that leave the definitions unchanged do not require a new
+    // Setup, so that clients can keep their meta data
+    if (context)
+    {
+        const bool setup_required = !set_up_ or discipline_->layout_generation() != setup_layout_generation_;
+        context->AddTrailingMetadata(kOptionsGenerationMetadataKey,
+                                     std::to_string(discipline_->options_generation()));
+        context->AddTrailingMetadata(kSetupRequiredMetadataKey, setup_required ? "1" : "0");
+    }
+
     return Status::OK;
 }
 
@@ -128,9 +160,15 @@ Status DisciplineServer::GetVariableDefinitions(ServerContext *context,
 
     if (!writer)
         return Status::OK;
+
+    // discrete variables are marked if the client requests it, otherwise
+    // they are described (and later sent) as continuous variables
+    const bool discrete = FindClientMetadata(context, kDiscreteVariablesMetadataKey) == "1";
+
     for (const VariableMetaData &var : discipline_->var_meta())
     {
-        if (!writer->Write(var))
+        if (!writer->Write(var) or
+            (discrete and discipline_->IsDiscrete(var.name()) and !writer->Write(DiscreteMarker(var))))
         {
             return grpc::Status(grpc::StatusCode::INTERNAL,
                               "Failed to write variable metadata for '" + var.name() + "'");
@@ -152,13 +190,45 @@ Status DisciplineServer::GetPartialDefinitions(ServerContext *context,
 
     if (!writer)
         return Status::OK;
+    // sparse partials are sent with their pattern if the client requests it,
+    // otherwise they are described (and later sent) as dense partials
+    const bool sparse = FindClientMetadata(context, kSparsePartialsMetadataKey) == "1";
+    const PartialsSparsity &sparsity = discipline_->partials_sparsity();
+
     for (const PartialsMetaData &partial : discipline_->partials_meta())
     {
-        if (!writer->Write(partial))
+        auto pattern = sparsity.find(std::make_pair(partial.name(), partial.subname()));
+
+        std::vector<PartialsMetaData> messages;
+        if (pattern == sparsity.end())
         {
-            return grpc::Status(grpc::StatusCode::INTERNAL,
-                              "Failed to write partial metadata for ('" +
-                              partial.name() + "', '" + partial.subname() + "')");
+            messages.push_back(partial);
+        }
+        else
+        {
+            PartialsMetaData dense = partial;
+            dense.clear_shape();
+            for (const int64_t dim : pattern->second.dense_shape)
+                dense.add_shape(dim);
+            messages.push_back(std::move(dense));
+
+            if (sparse)
+            {
+                const size_t chunk_size = std::max<int64_t>(discipline_->stream_opts().num_double(), 1);
+                for (PartialsMetaData &chunk : EncodeSparsityPattern(partial.name(), partial.subname(),
+                                                                     pattern->second, chunk_size))
+                    messages.push_back(std::move(chunk));
+            }
+        }
+
+        for (const PartialsMetaData &message : messages)
+        {
+            if (!writer->Write(message))
+            {
+                return grpc::Status(grpc::StatusCode::INTERNAL,
+                                  "Failed to write partial metadata for ('" +
+                                  partial.name() + "', '" + partial.subname() + "')");
+            }
         }
     }
 
@@ -175,12 +245,8 @@ grpc::Status DisciplineServer::Setup(grpc::ServerContext *context,
                           "Discipline not linked to server");
     }
 
-    if (!discipline_->var_meta().empty() or !discipline_->partials_meta().empty())
-    {
-        // clear any existing meta data
-        discipline_->var_meta().clear();
-        discipline_->partials_meta().clear();
-    }
+    // clear any existing meta data
+    discipline_->ClearMetaData();
 
     // run the developer-defined setup functions
     try
@@ -209,6 +275,19 @@ grpc::Status DisciplineServer::Setup(grpc::ServerContext *context,
         return Status(grpc::INTERNAL, "Internal server error during SetupPartials call.");
     }
 
+    discipline_->MarkConfigurationChanged();
+    set_up_ = true;
+    setup_layout_generation_ = discipline_->layout_generation();
+
+    // lets clients with a definition cache skip fetching the definitions
+    if (context)
+    {
+        context->AddTrailingMetadata(kDefinitionsHashMetadataKey,
+                                     HashDefinitions(discipline_->var_meta(), discipline_->partials_meta(),
+                                                     discipline_->partials_sparsity(),
+                                                     discipline_->discrete_variables()));
+    }
+
     return Status::OK;
 }
 
@@ -0,0 +1,230 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "client_pool.h"
+
+using grpc::ChannelInterface;
+
+using philote::ExplicitClient;
+using philote::ExplicitClientPool;
+using philote::Partials;
+using philote::ReplicaStats;
+using philote::Variables;
+
+using std::string;
+using std::vector;
+
+ExplicitClientPool::ExplicitClientPool(const vector<std::shared_ptr<ChannelInterface>> &channels)
+{
+    ConnectChannels(channels);
+}
+
+void ExplicitClientPool::ConnectChannels(const vector<std::shared_ptr<ChannelInterface>> &channels)
+{
+    if (channels.empty())
+        throw std::invalid_argument("Client pool requires at least one channel");
+
+    vector<std::unique_ptr<Replica>> replicas;
+    replicas.reserve(channels.size());
+    for (const auto &channel : channels)
+    {
+        auto replica = std::make_unique<Replica>();
+        replica->client = std::make_unique<ExplicitClient>();
+        replica->client->ConnectChannel(channel);
+        replicas.push_back(std::move(replica));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    replicas_ = std::move(replicas);
+    next_ = 0;
+}
+
+ExplicitClient &ExplicitClientPool::GetReplica(size_t index)
+{
+    return *replicas_.at(index)->client;
+}
+
+const ExplicitClient &ExplicitClientPool::GetReplica(size_t index) const
+{
+    return *replicas_.at(index)->client;
+}
+
+void ExplicitClientPool::SendOptions(const philote::DisciplineOptions &options)
+{
+    for (auto &replica : replicas_)
+        replica->client->SendOptions(options);
+}
+
+void ExplicitClientPool::Initialize()
+{
+    if (replicas_.empty())
+        throw std::runtime_error("Client pool has no replicas");
+
+    ExplicitClient &primary = *replicas_.front()->client;
+    primary.GetInfo();
+
+    // the replicas use the extensions and chunk size of the primary server
+    for (size_t i = 1; i < replicas_.size(); i++)
+    {
+        ExplicitClient &replica = *replicas_[i]->client;
+        replica.SetServerFeatures(primary.GetServerFeatures());
+        replica.SetStreamOptions(primary.GetStreamOptions());
+        replica.SendStreamOptions();
+    }
+
+    for (auto &replica : replicas_)
+        replica->client->Setup();
+
+    primary.GetVariableDefinitions();
+    primary.GetPartialDefinitions();
+    for (size_t i = 1; i < replicas_.size(); i++)
+        replicas_[i]->client->CopyDefinitions(primary);
+}
+
+Variables ExplicitClientPool::ComputeFunction(const Variables &inputs)
+{
+    return Dispatch<Variables>([&inputs](ExplicitClient &client)
+                               { return client.ComputeFunction(inputs); });
+}
+
+Partials ExplicitClientPool::ComputeGradient(const Variables &inputs)
+{
+    return Dispatch<Partials>([&inputs](ExplicitClient &client)
+                              { return client.ComputeGradient(inputs); });
+}
+
+std::pair<Variables, Partials> ExplicitClientPool::ComputeFunctionAndGradient(const Variables &inputs)
+{
+    return Dispatch<std::pair<Variables, Partials>>([&inputs](ExplicitClient &client)
+                                                    { return client.ComputeFunctionAndGradient(inputs); });
+}
+
+vector<ReplicaStats> ExplicitClientPool::GetReplicaStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    vector<ReplicaStats> stats;
+    stats.reserve(replicas_.size());
+    for (const auto &replica : replicas_)
+        stats.push_back(replica->stats);
+
+    return stats;
+}
+
+size_t ExplicitClientPool::Acquire(const vector<bool> &tried)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = std::chrono::steady_clock::now();
+
+    // prefer replicas without a recent failure, then the fewest outstanding calls
+    size_t best = std::numeric_limits<size_t>::max();
+    bool best_ready = false;
+    for (size_t k = 0; k < replicas_.size(); k++)
+    {
+        const size_t i = (next_ + k) % replicas_.size();
+        if (tried[i])
+            continue;
+
+        const bool ready = now >= replicas_[i]->retry_after;
+        if (best == std::numeric_limits<size_t>::max() or (ready and !best_ready) or
+            (ready == best_ready and replicas_[i]->stats.outstanding < replicas_[best]->stats.outstanding))
+        {
+            best = i;
+            best_ready = ready;
+        }
+    }
+
+    next_ = (best + 1) % replicas_.size();
+    replicas_[best]->stats.outstanding++;
+    return best;
+}
+
+void ExplicitClientPool::Release(size_t index, bool failed)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Replica &replica = *replicas_[index];
+
+    replica.stats.outstanding--;
+    if (failed)
+    {
+        replica.stats.failures++;
+        replica.retry_after = std::chrono::steady_clock::now() + failure_backoff_;
+    }
+    else
+    {
+        replica.stats.completed++;
+        replica.retry_after = std::chrono::steady_clock::time_point();
+    }
+}
+
+template <class Result>
+Result ExplicitClientPool::Dispatch(const std::function<Result(ExplicitClient &)> &call)
+{
+    if (replicas_.empty())
+        throw std::runtime_error("Client pool has no replicas");
+
+    vector<bool> tried(replicas_.size(), false);
+    string error;
+    for (size_t attempt = 0; attempt < replicas_.size(); attempt++)
+    {
+        const size_t index = Acquire(tried);
+        tried[index] = true;
+
+        Replica &replica = *replicas_[index];
+        try
+        {
+            std::unique_lock<std::mutex> lock(replica.call_mutex);
+            Result result = call(*replica.client);
+            lock.unlock();
+
+            Release(index, false);
+            return result;
+        }
+        catch (const std::runtime_error &e)
+        {
+            // RPC failures are retried on the remaining replicas
+            Release(index, true);
+            error = e.what();
+        }
+        catch (...)
+        {
+            // invalid inputs fail on every replica
+            Release(index, false);
+            throw;
+        }
+    }
+
+    throw std::runtime_error("Call failed on all " + std::to_string(replicas_.size()) +
+                             " replicas, last error: " + error);
+}
@@ -0,0 +1,365 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+#include "discipline_chain.h"
+#include "jacobian_product.h"
+
+using std::string;
+using std::vector;
+
+using philote::Discipline;
+using philote::DisciplineChain;
+using philote::ExplicitDiscipline;
+using philote::ImplicitDiscipline;
+using philote::Partials;
+using philote::Variable;
+using philote::Variables;
+
+namespace
+{
+    Partials AllocatePartials(const std::vector<philote::PartialsMetaData> &partials_meta)
+    {
+        Partials partials;
+        for (const philote::PartialsMetaData &par : partials_meta)
+        {
+            std::vector<size_t> shape(par.shape().begin(), par.shape().end());
+            partials[std::make_pair(par.name(), par.subname())] = philote::Variable(philote::kOutput, shape);
+        }
+        return partials;
+    }
+
+    void CheckStageName(const string &name)
+    {
+        if (name.empty() or name.find('.') != string::npos)
+            throw std::invalid_argument("Invalid stage name '" + name + "'");
+    }
+}
+
+Discipline &DisciplineChain::Stage::discipline() const
+{
+    if (explicit_discipline)
+        return *explicit_discipline;
+    return *implicit_discipline;
+}
+
+void DisciplineChain::AddStage(const string &name, std::shared_ptr<ExplicitDiscipline> discipline)
+{
+    CheckStageName(name);
+    for (const Stage &stage : stages_)
+        if (stage.name == name)
+            throw std::invalid_argument("Stage '" + name + "' already exists");
+
+    Stage stage;
+    stage.name = name;
+    stage.explicit_discipline = std::move(discipline);
+    stages_.push_back(std::move(stage));
+}
+
+void DisciplineChain::AddStage(const string &name, std::shared_ptr<ImplicitDiscipline> discipline)
+{
+    CheckStageName(name);
+    for (const Stage &stage : stages_)
+        if (stage.name == name)
+            throw std::invalid_argument("Stage '" + name + "' already exists");
+
+    Stage stage;
+    stage.name = name;
+    stage.implicit_discipline = std::move(discipline);
+    stages_.push_back(std::move(stage));
+}
+
+size_t DisciplineChain::StageIndex(const string &name) const
+{
+    for (size_t i = 0; i < stages_.size(); i++)
+        if (stages_[i].name == name)
+            return i;
+    throw std::invalid_argument("Unknown stage '" + name + "'");
+}
+
+void DisciplineChain::Connect(const string &from_stage, const string &output,
+                              const string &to_stage, const string &input)
+{
+    const size_t from = StageIndex(from_stage);
+    const size_t to = StageIndex(to_stage);
+    if (from >= to)
+        throw std::invalid_argument("Stage '" + from_stage + "' must come before stage '" + to_stage + "'");
+
+    stages_[to].connections[input] = std::make_pair(from, output);
+}
+
+void DisciplineChain::Initialize()
+{
+    for (Stage &stage : stages_)
+    {
+        stage.discipline().Initialize();
+        for (const auto &option : stage.discipline().options_list())
+        {
+            // an option shared by several stages affects the definitions if
+            // it does so in any of them
+            const bool shared = options_list().count(option.first) > 0;
+            AddOption(option.first, option.second,
+                      stage.discipline().OptionAffectsShape(option.first) or
+                          (shared and OptionAffectsShape(option.first)));
+        }
+    }
+}
+
+void DisciplineChain::SetOptions(const google::protobuf::Struct &options_struct)
+{
+    for (Stage &stage : stages_)
+        stage.discipline().SetOptions(options_struct);
+
+    ExplicitDiscipline::SetOptions(options_struct);
+}
+
+void DisciplineChain::Setup()
+{
+    // set up the stages first, since the connections refer to their variables
+    for (Stage &stage : stages_)
+    {
+        Discipline &discipline = stage.discipline();
+        discipline.ClearMetaData();
+        discipline.Setup();
+        discipline.SetupPartials();
+    }
+
+    // outputs consumed by a later stage are not exposed
+    std::set<std::pair<size_t, string>> connected;
+    for (const Stage &stage : stages_)
+        for (const auto &connection : stage.connections)
+            connected.insert(connection.second);
+
+    for (size_t i = 0; i < stages_.size(); i++)
+    {
+        Stage &stage = stages_[i];
+        stage.inputs.clear();
+        stage.outputs.clear();
+        stage.exposed_outputs.clear();
+
+        std::set<string> dependencies;
+        for (const philote::VariableMetaData &var : stage.discipline().var_meta())
+        {
+            vector<size_t> shape(var.shape().begin(), var.shape().end());
+            const string exposed_name = stage.name + "." + var.name();
+
+            if (var.type() == philote::kOutput)
+            {
+                stage.outputs.emplace(var.name(), Variable(var));
+                if (connected.count(std::make_pair(i, var.name())) == 0)
+                {
+                    stage.exposed_outputs.push_back(var.name());
+                    vector<int64_t> dims(var.shape().begin(), var.shape().end());
+                    AddOutput(exposed_name, dims, var.units());
+                }
+                continue;
+            }
+
+            auto connection = stage.connections.find(var.name());
+            if (connection == stage.connections.end())
+            {
+                stage.inputs.emplace(var.name(), Variable(var));
+                dependencies.insert(exposed_name);
+                vector<int64_t> dims(var.shape().begin(), var.shape().end());
+                AddInput(exposed_name, dims, var.units());
+                continue;
+            }
+
+            // connected inputs view the upstream output (stages set up in order)
+            Stage &upstream = stages_[connection->second.first];
+            auto output = upstream.outputs.find(connection->second.second);
+            if (output == upstream.outputs.end())
+                throw std::invalid_argument("Stage '" + upstream.name + "' has no output '" +
+                                            connection->second.second + "'");
+
+            Variable view(philote::kInput, shape, output->second.data());
+            if (view.Size() != output->second.Size())
+                throw std::invalid_argument("Connection " + upstream.name + "." + connection->second.second +
+                                            " -> " + exposed_name + " joins variables of different sizes");
+            stage.inputs.emplace(var.name(), std::move(view));
+            dependencies.insert(upstream.dependencies.begin(), upstream.dependencies.end());
+        }
+
+        for (const auto &connection : stage.connections)
+            if (stage.inputs.count(connection.first) == 0)
+                throw std::invalid_argument("Stage '" + stage.name + "' has no input '" + connection.first + "'");
+
+        stage.dependencies.assign(dependencies.begin(), dependencies.end());
+    }
+}
+
+void DisciplineChain::SetupPartials()
+{
+    // only outputs that depend on an input (through the connections) have
+    // non-zero partials
+    for (const Stage &stage : stages_)
+        for (const string &output : stage.exposed_outputs)
+            for (const string &input : stage.dependencies)
+                DeclarePartials(stage.name + "." + output, input);
+}
+
+void DisciplineChain::Evaluate(const Variables &inputs)
+{
+    for (Stage &stage : stages_)
+    {
+        for (auto &var : stage.inputs)
+        {
+            auto connection = stage.connections.find(var.first);
+            if (connection == stage.connections.end())
+            {
+                const Variable &value = inputs.at(stage.name + "." + var.first);
+                if (value.Size() != var.second.Size())
+                    throw std::length_error("Input " + stage.name + "." + var.first +
+                                            " does not match the size of the variable");
+                std::copy_n(value.data(), value.Size(), var.second.data());
+                continue;
+            }
+
+            // refresh the view in case the stage replaced the output storage
+            Variable &output = stages_[connection->second.first].outputs.at(connection->second.second);
+            var.second = Variable(philote::kInput, var.second.Shape(), output.data());
+        }
+
+        if (stage.explicit_discipline)
+            stage.explicit_discipline->Compute(stage.inputs, stage.outputs);
+        else
+            stage.implicit_discipline->SolveResiduals(stage.inputs, stage.outputs);
+    }
+}
+
+Partials DisciplineChain::StagePartials(const Stage &stage) const
+{
+    Partials partials = AllocatePartials(stage.discipline().partials_meta());
+    if (stage.explicit_discipline)
+        stage.explicit_discipline->ComputePartials(stage.inputs, partials);
+    else
+        stage.implicit_discipline->ComputeResidualGradients(stage.inputs, stage.outputs, partials);
+    return partials;
+}
+
+void DisciplineChain::Compute(const Variables &inputs, Variables &outputs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Evaluate(inputs);
+
+    for (const Stage &stage : stages_)
+        for (const string &name : stage.exposed_outputs)
+        {
+            const Variable &value = stage.outputs.at(name);
+            std::copy_n(value.data(), value.Size(), outputs.at(stage.name + "." + name).data());
+        }
+}
+
+void DisciplineChain::ComputePartials(const Variables &inputs, Partials &partials)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Evaluate(inputs);
+
+    vector<Partials> stage_partials;
+    stage_partials.reserve(stages_.size());
+    for (const Stage &stage : stages_)
+        stage_partials.push_back(StagePartials(stage));
+
+    // tangents of the stage outputs (forward mode, one input entry at a time)
+    vector<Variables> tangents(stages_.size());
+    for (size_t i = 0; i < stages_.size(); i++)
+        tangents[i] = stages_[i].outputs;
+
+    for (const auto &input : inputs)
+    {
+        const string &wrt = input.first;
+        const size_t num_cols = input.second.Size();
+
+        for (size_t j = 0; j < num_cols; j++)
+        {
+            for (size_t i = 0; i < stages_.size(); i++)
+            {
+                const Stage &stage = stages_[i];
+                if (!std::binary_search(stage.dependencies.begin(), stage.dependencies.end(), wrt))
+                {
+                    for (auto &var : tangents[i])
+                        var.second.Fill(0.0);
+                    continue;
+                }
+
+                // seeds of the stage inputs: the unit vector or upstream tangents
+                Variables seeds;
+                for (const auto &var : stage.inputs)
+                {
+                    auto connection = stage.connections.find(var.first);
+                    if (connection != stage.connections.end())
+                    {
+                        Variable &upstream = tangents[connection->second.first].at(connection->second.second);
+                        seeds.emplace(var.first, Variable(philote::kInput, var.second.Shape(), upstream.data()));
+                    }
+                    else if (stage.name + "." + var.first == wrt)
+                    {
+                        Variable seed(philote::kInput, var.second.Shape());
+                        seed.data()[j] = 1.0;
+                        seeds.emplace(var.first, std::move(seed));
+                    }
+                }
+
+                const philote::PartialsSparsity &sparsity = stage.discipline().partials_sparsity();
+                if (stage.explicit_discipline)
+                {
+                    philote::MultiplyJacobian(stage_partials[i], sparsity, seeds, tangents[i]);
+                    continue;
+                }
+
+                // implicit stages: dR/dy * dy = -dR/dx * dx
+                Variables rhs = stage.outputs;
+                philote::MultiplyJacobian(stage_partials[i], sparsity, seeds, rhs);
+                for (auto &var : rhs)
+                    for (size_t k = 0; k < var.second.Size(); k++)
+                        var.second.data()[k] = -var.second.data()[k];
+                stage.implicit_discipline->SolveLinear(stage.inputs, stage.outputs, rhs, tangents[i]);
+            }
+
+            for (size_t i = 0; i < stages_.size(); i++)
+            {
+                const Stage &stage = stages_[i];
+                for (const string &name : stage.exposed_outputs)
+                {
+                    auto partial = partials.find(std::make_pair(stage.name + "." + name, wrt));
+                    if (partial == partials.end())
+                        continue;
+
+                    const Variable &tangent = tangents[i].at(name);
+                    for (size_t r = 0; r < tangent.Size(); r++)
+                        partial->second.data()[r * num_cols + j] = tangent.data()[r];
+                }
+            }
+        }
+    }
+}
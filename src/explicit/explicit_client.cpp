@@ -28,7 +28,12 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
 #include "explicit.h"
+#include "jacobian_product.h"
 
 #include <data.pb.h>
 #include <disciplines.pb.h>
@@ -37,6 +42,8 @@
 using grpc::ChannelInterface;
 
 using philote::Array;
+using philote::AsyncArrayCall;
+using philote::AsyncCallback;
 using philote::ExplicitClient;
 using philote::VariableMetaData;
 
@@ -46,48 +53,387 @@ using std::pair;
 using std::string;
 using std::vector;
 
+namespace
+{
+    // copies received values into a preallocated variable
+    void AssignValues(const string &name, size_t start, const double *values, size_t count,
+                      philote::Variable &var)
+    {
+        if (start + count > var.Size())
+            throw std::out_of_range("Received values of " + name + " out of range");
+
+        if (var.IsDiscrete())
+        {
+            int64_t *integers = var.discrete_data() + start;
+            for (size_t i = 0; i < count; i++)
+                integers[i] = std::llround(values[i]);
+            return;
+        }
+
+        std::copy_n(values, count, var.data() + start);
+        var.ReleasePages(start, start + count - 1);
+    }
+}
+
 void ExplicitClient::ConnectChannel(std::shared_ptr<ChannelInterface> channel)
 {
+    CloseStreams();
     DisciplineClient::ConnectChannel(channel);
     stub_ = ExplicitService::NewStub(channel);
 }
 
-philote::Variables ExplicitClient::ComputeFunction(const Variables &inputs)
+philote::ClientCallSpan ExplicitClient::StartCall(const std::string &rpc, EvaluationStream &call,
+                                                  const std::function<void(grpc::ClientContext &)> &prepare,
+                                                  const StreamStarter &start)
 {
-    grpc::ClientContext context;
-    context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
-    std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
-        stream(stub_->ComputeFunction(&context));
+    const bool persistent = UsesEvaluationStreams();
+    if (persistent and call.Reusable(ResultGeneration(), GetRPCTimeout()))
+    {
+        call.Begin();
+        return TraceCall(rpc);
+    }
+
+    // evaluation streams outlive one timeout, so each evaluation has at least the full timeout
+    auto context = std::make_unique<grpc::ClientContext>();
+    context->set_deadline(std::chrono::system_clock::now() + (persistent ? 2 : 1) * GetRPCTimeout());
+    AddWirePrecisionMetadata(*context);
+    ApplyCompression(*context);
+    prepare(*context);
+    if (persistent)
+        context->AddMetadata(kEvaluationStreamMetadataKey, "1");
+
+    ClientCallSpan span = persistent ? TraceCall(rpc) : TraceCall(rpc, *context);
+    std::unique_ptr<EvaluationStream::Stream> stream = start(context.get());
+    call.Open(std::move(context), std::move(stream), persistent, ResultGeneration());
 
-    // send/assign inputs and preallocate outputs
+    return span;
+}
+
+void ExplicitClient::CloseStreams() noexcept
+{
+    function_stream_.Close();
+    fused_stream_.Close();
+    gradient_stream_.Close();
+}
+
+philote::Variables ExplicitClient::ComputeFunction(const Variables &inputs)
+{
     Variables outputs;
+    if (function_cache_.Find(inputs, ResultGeneration(), outputs))
+        return outputs;
+
+    // preallocate outputs
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        if (var.type() == kOutput)
+            outputs[var.name()] = AllocateResult(var);
+    }
+
+    ComputeFunction(inputs, [&outputs](const string &name, const string &, size_t start,
+                                       const double *values, size_t count)
+                    { AssignValues(name, start, values, count, outputs.at(name)); });
+
+    if (function_cache_.enabled())
+        function_cache_.Insert(inputs, ResultGeneration(), outputs);
+
+    return outputs;
+}
+
+void ExplicitClient::ComputeFunction(const Variables &inputs, const ChunkSink &sink)
+{
+    BackoffScope backoff(*this);
+    SharedMemoryTransfer shared;
+    InputSession *session = nullptr;
+    ClientCallSpan span = StartCall(
+        "ComputeFunction", function_stream_,
+        [this, &inputs, &shared, &session](grpc::ClientContext &context)
+        {
+            AddInputBytesMetadata(context, inputs);
+
+            // co-located servers exchange the values through shared memory
+            shared = AcquireSharedMemory(context);
+
+            // small variables are packed into shared messages if the server supports it
+            if (!shared and ServerSupports(kFeaturePackedVariables))
+                context.AddMetadata(kPackedVariablesMetadataKey, "1");
+
+            // only the inputs that changed since the previous call are sent
+            session = BeginInputSession(context, shared);
+        },
+        [this](grpc::ClientContext *context)
+        { return stub_->ComputeFunction(context); });
+
+    EvaluationStream &call = function_stream_;
+    const bool reused = call.reused();
+    const bool packed = !shared and ServerSupports(kFeaturePackedVariables);
+
+    // send/assign inputs
+    const size_t chunk_size = GetStreamOptions().num_double();
+    ArrayPacker packer(kInput, std::max<size_t>(chunk_size, 1));
+    ChunkPipeline pipeline(call.stream(), !shared and PipelineSends(inputs), GetCompression());
 
     for (const VariableMetaData &var : GetVariableMetaAll())
     {
         const string &name = var.name();
 
-        if (var.type() == kInput)
+        // Only send if the input was actually provided
+        if (var.type() == kInput and inputs.count(name) > 0 and
+            (!session or session->Stage(name, inputs.at(name))) and
+            (!packed or !packer.Add(name, inputs.at(name))))
+            SendVariable(name, inputs.at(name), shared, &pipeline, session);
+    }
+
+    for (const Array &message : packer.Finish())
+        pipeline.Write(Array(message));
+
+    // finish streaming data to the server
+    if (!pipeline.Finish())
+    {
+        // a reused stream may have been closed by the server (e.g., a restart)
+        if (reused)
         {
-            // Only send if the input was actually provided
-            if (inputs.count(name) > 0)
-                inputs.at(name).Send(name, "", stream.get(), GetStreamOptions().num_double());
+            call.Cancel();
+            return ComputeFunction(inputs, sink);
+        }
+
+        // the server may have rejected the call under load
+        grpc::Status status = call.Fail();
+        span.Finish(status);
+        if (BackOff(status, call.retry_after()))
+            return ComputeFunction(inputs, sink);
+        throw std::runtime_error("ComputeFunction: failed to write inputs to stream");
+    }
+    call.EndInputs();
+
+    Array result;
+    vector<double> buffer;
+    bool received = false;
+    while (call.Read(&result))
+    {
+        received = true;
+        if (IsPackedArray(result))
+        {
+            try
+            {
+                for (const PackedEntry &entry : DecodePackedIndex(result))
+                {
+                    if (entry.offset + entry.size > static_cast<size_t>(result.data_size()))
+                        throw std::length_error("Packed variable " + entry.name + " exceeds the message");
+                    sink(entry.name, "", 0, result.data().data() + entry.offset, entry.size);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                call.Cancel();
+                throw std::runtime_error("ComputeFunction: invalid packed outputs: " + string(e.what()));
+            }
+            continue;
+        }
+
+        try
+        {
+            // integer-encoded outputs have no subname
+            const double *values = shared.Receive(result, buffer, SendPrecision());
+            sink(result.name(), IsDiscreteChunk(result) ? string() : result.subname(),
+                 static_cast<size_t>(result.start()), values,
+                 static_cast<size_t>(result.end() - result.start()) + 1);
+        }
+        catch (...)
+        {
+            // the stream cannot be reused with unread results
+            call.Cancel();
+            throw;
+        }
+    }
+
+    grpc::Status status = call.Finish();
+    span.Finish(status);
+
+    // calls are only repeated if the sink has not received any values
+    if (EndInputSession(session, status) and !received)
+        return ComputeFunction(inputs, sink);
+    if (!received and BackOff(status, call.retry_after()))
+        return ComputeFunction(inputs, sink);
+    if (reused and !received and (status.error_code() == grpc::StatusCode::UNAVAILABLE or
+                                  status.error_code() == grpc::StatusCode::CANCELLED))
+        return ComputeFunction(inputs, sink);
+    if (!status.ok())
+    {
+        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+        {
+            throw std::runtime_error("RPC timeout after " +
+                                   std::to_string(GetRPCTimeout().count()) +
+                                   "ms: " + status.error_message());
         }
+        throw std::runtime_error("ComputeFunction RPC failed: [" +
+                                 std::to_string(status.error_code()) + "] " +
+                                 status.error_message());
+    }
+}
 
+std::vector<philote::Variables> ExplicitClient::ComputeFunctionBatch(const std::vector<Variables> &inputs)
+{
+    vector<Variables> outputs;
+    outputs.reserve(inputs.size());
+
+    // fall back to individual calls if the server cannot evaluate batches
+    if (!ServerSupports(kFeatureBatch))
+    {
+        for (const Variables &point : inputs)
+            outputs.push_back(ComputeFunction(point));
+        return outputs;
+    }
+
+    // preallocate the outputs of a single design point
+    Variables point_outputs;
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
         if (var.type() == kOutput)
-            outputs[var.name()] = Variable(var);
+            point_outputs[var.name()] = Variable(var);
+    }
+
+    for (size_t offset = 0; offset < inputs.size(); offset += kMaxBatchSize)
+    {
+        const size_t batch_size = std::min(kMaxBatchSize, inputs.size() - offset);
+
+        grpc::ClientContext context;
+        context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
+        AddWirePrecisionMetadata(context);
+        ApplyCompression(context);
+        context.AddMetadata(kBatchSizeMetadataKey, std::to_string(batch_size));
+        ClientCallSpan span = TraceCall("ComputeFunction", context);
+        std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
+            stream(stub_->ComputeFunction(&context));
+
+        // send the inputs of every design point, tagged with the point index
+        ChunkPipeline pipeline(stream.get(), false, GetCompression());
+        for (size_t point = 0; point < batch_size; point++)
+        {
+            const Variables &point_inputs = inputs[offset + point];
+            const string subname = std::to_string(point);
+
+            for (const VariableMetaData &var : GetVariableMetaAll())
+            {
+                const string &name = var.name();
+
+                // Only send if the input was actually provided
+                if (var.type() == kInput and point_inputs.count(name) > 0)
+                    point_inputs.at(name).Send(name, subname, &pipeline, GetStreamOptions().num_double(),
+                                               SendPrecision());
+            }
+        }
+
+        // finish streaming data to the server
+        stream->WritesDone();
+
+        const size_t first = outputs.size();
+        outputs.resize(first + batch_size, point_outputs);
+
+        Array result;
+        string error;
+        while (stream->Read(&result))
+        {
+            size_t point = 0;
+            if (!ParseIndex(result.subname(), batch_size, point))
+            {
+                error = "invalid design point index '" + result.subname() + "'";
+                continue;
+            }
+            outputs[first + point][result.name()].AssignChunk(result, SendPrecision());
+        }
+
+        grpc::Status status = stream->Finish();
+        span.Finish(status);
+        if (!status.ok())
+        {
+            if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+            {
+                throw std::runtime_error("RPC timeout after " +
+                                       std::to_string(GetRPCTimeout().count()) +
+                                       "ms: " + status.error_message());
+            }
+            throw std::runtime_error("ComputeFunction RPC failed: [" +
+                                     std::to_string(status.error_code()) + "] " +
+                                     status.error_message());
+        }
+        if (!error.empty())
+            throw std::runtime_error("ComputeFunction RPC failed: " + error);
+    }
+
+    return outputs;
+}
+
+philote::Variables ExplicitClient::ComputeJacVec(const Variables &inputs, const Variables &seeds)
+{
+    return ComputeJacobianProduct(inputs, seeds, false);
+}
+
+philote::Variables ExplicitClient::ComputeVecJac(const Variables &inputs, const Variables &seeds)
+{
+    return ComputeJacobianProduct(inputs, seeds, true);
+}
+
+philote::Variables ExplicitClient::ComputeJacobianProduct(const Variables &inputs, const Variables &seeds,
+                                                          bool reverse)
+{
+    // products of forward mode are outputs, those of reverse mode inputs
+    Variables products;
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        if (var.type() == (reverse ? kInput : kOutput))
+            products[var.name()] = Variable(var);
     }
 
+    // fall back to multiplying the gradient locally
+    if (!ServerSupports(kFeatureJacobianProducts))
+    {
+        const Partials partials = ComputeGradient(inputs);
+        if (reverse)
+            MultiplyJacobianTranspose(partials, GetPartialsSparsity(), seeds, products);
+        else
+            MultiplyJacobian(partials, GetPartialsSparsity(), seeds, products);
+        return products;
+    }
+
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
+    AddWirePrecisionMetadata(context);
+    ApplyCompression(context);
+    context.AddMetadata(kJacobianProductMetadataKey, reverse ? kJacobianProductReverse : kJacobianProductForward);
+    ClientCallSpan span = TraceCall("ComputeGradient", context);
+    std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
+        stream(stub_->ComputeGradient(&context));
+
+    // send the inputs followed by the seeds (marked by their subname)
+    ChunkPipeline pipeline(stream.get(), false, GetCompression());
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        const string &name = var.name();
+        if (var.type() == kInput and inputs.count(name) > 0)
+            inputs.at(name).Send(name, "", &pipeline, GetStreamOptions().num_double(), SendPrecision(name));
+    }
+    for (const auto &seed : seeds)
+        seed.second.Send(seed.first, kJacobianSeedSubname, &pipeline, GetStreamOptions().num_double(),
+                         SendPrecision());
+
     // finish streaming data to the server
     stream->WritesDone();
 
     Array result;
+    string error;
     while (stream->Read(&result))
     {
-        const string &name = result.name();
-        outputs[name].AssignChunk(result);
+        auto product = products.find(result.name());
+        if (product == products.end())
+        {
+            error = "unexpected product '" + result.name() + "'";
+            continue;
+        }
+        product->second.AssignChunk(result, SendPrecision());
     }
 
     grpc::Status status = stream->Finish();
+    span.Finish(status);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -96,22 +442,60 @@ philote::Variables ExplicitClient::ComputeFunction(const Variables &inputs)
                                    std::to_string(GetRPCTimeout().count()) +
                                    "ms: " + status.error_message());
         }
-        throw std::runtime_error("ComputeFunction RPC failed: [" +
+        throw std::runtime_error("ComputeGradient RPC failed: [" +
                                  std::to_string(status.error_code()) + "] " +
                                  status.error_message());
     }
+    if (!error.empty())
+        throw std::runtime_error("ComputeGradient RPC failed: " + error);
 
-    return outputs;
+    return products;
 }
 
 philote::Partials ExplicitClient::ComputeGradient(const Variables &inputs)
 {
-    grpc::ClientContext context;
-    context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
-    std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
-        stream(stub_->ComputeGradient(&context));
+    Partials partials;
+    if (gradient_cache_.Find(inputs, ResultGeneration(), partials))
+        return partials;
+
+    // preallocate partials
+    for (const auto &par : GetPartialsMetaConst())
+    {
+        partials[make_pair(par.name(), par.subname())] = AllocateVariable(par, GetFileStorage());
+    }
+
+    ComputeGradient(inputs, [&partials](const string &name, const string &subname, size_t start,
+                                        const double *values, size_t count)
+                    { AssignValues(name, start, values, count, partials.at(make_pair(name, subname))); });
+
+    if (gradient_cache_.enabled())
+        gradient_cache_.Insert(inputs, ResultGeneration(), partials);
+
+    return partials;
+}
+
+void ExplicitClient::ComputeGradient(const Variables &inputs, const ChunkSink &sink)
+{
+    BackoffScope backoff(*this);
+    SharedMemoryTransfer shared;
+    InputSession *session = nullptr;
+    ClientCallSpan span = StartCall(
+        "ComputeGradient", gradient_stream_,
+        [this, &inputs, &shared, &session](grpc::ClientContext &context)
+        {
+            AddPartialsMetadata(context);
+            AddInputBytesMetadata(context, inputs);
+            shared = AcquireSharedMemory(context);
+            session = BeginInputSession(context, shared);
+        },
+        [this](grpc::ClientContext *context)
+        { return stub_->ComputeGradient(context); });
+
+    EvaluationStream &call = gradient_stream_;
+    const bool reused = call.reused();
 
     // send/assign inputs
+    ChunkPipeline pipeline(call.stream(), !shared and PipelineSends(inputs), GetCompression());
     for (const VariableMetaData &var : GetVariableMetaAll())
     {
         const string name = var.name();
@@ -119,32 +503,200 @@ philote::Partials ExplicitClient::ComputeGradient(const Variables &inputs)
         if (var.type() == kInput)
         {
             // Only send if the input was actually provided
-            if (inputs.count(name) > 0)
-                inputs.at(name).Send(name, "", stream.get(), GetStreamOptions().num_double());
+            if (inputs.count(name) > 0 and (!session or session->Stage(name, inputs.at(name))))
+                SendVariable(name, inputs.at(name), shared, &pipeline, session);
         }
     }
 
     // finish streaming data to the server
-    stream->WritesDone();
+    if (!pipeline.Finish())
+    {
+        // a reused stream may have been closed by the server (e.g., a restart)
+        if (reused)
+        {
+            call.Cancel();
+            return ComputeGradient(inputs, sink);
+        }
 
-    // preallocate partials
+        // the server may have rejected the call under load
+        grpc::Status status = call.Fail();
+        span.Finish(status);
+        if (BackOff(status, call.retry_after()))
+            return ComputeGradient(inputs, sink);
+        throw std::runtime_error("ComputeGradient: failed to write inputs to stream");
+    }
+    call.EndInputs();
+
+    // process messages from server
+    Array result;
+    vector<double> buffer;
+    bool received = false;
+    while (call.Read(&result))
+    {
+        received = true;
+        try
+        {
+            const double *values = shared.Receive(result, buffer, SendPrecision());
+            sink(result.name(), result.subname(), static_cast<size_t>(result.start()), values,
+                 static_cast<size_t>(result.end() - result.start()) + 1);
+        }
+        catch (...)
+        {
+            // the stream cannot be reused with unread results
+            call.Cancel();
+            throw;
+        }
+    }
+
+    grpc::Status status = call.Finish();
+    span.Finish(status);
+
+    // calls are only repeated if the sink has not received any values
+    if (EndInputSession(session, status) and !received)
+        return ComputeGradient(inputs, sink);
+    if (!received and BackOff(status, call.retry_after()))
+        return ComputeGradient(inputs, sink);
+    if (reused and !received and (status.error_code() == grpc::StatusCode::UNAVAILABLE or
+                                  status.error_code() == grpc::StatusCode::CANCELLED))
+        return ComputeGradient(inputs, sink);
+    if (!status.ok())
+    {
+        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+        {
+            throw std::runtime_error("RPC timeout after " +
+                                   std::to_string(GetRPCTimeout().count()) +
+                                   "ms: " + status.error_message());
+        }
+        throw std::runtime_error("ComputeGradient RPC failed: [" +
+                                 std::to_string(status.error_code()) + "] " +
+                                 status.error_message());
+    }
+}
+
+std::pair<philote::Variables, philote::Partials> ExplicitClient::ComputeFunctionAndGradient(const Variables &inputs)
+{
+    // fall back to separate calls if the server cannot return both at once
+    if (!ServerSupports(kFeatureFusedGradient))
+        return make_pair(ComputeFunction(inputs), ComputeGradient(inputs));
+
+    BackoffScope backoff(*this);
+
+    Variables outputs;
     Partials partials;
-    for (const auto &par : GetPartialsMetaConst())
+    if (function_cache_.Find(inputs, ResultGeneration(), outputs) and
+        gradient_cache_.Find(inputs, ResultGeneration(), partials))
+        return make_pair(std::move(outputs), std::move(partials));
+
+    SharedMemoryTransfer shared;
+    InputSession *session = nullptr;
+    ClientCallSpan span = StartCall(
+        "ComputeFunction", fused_stream_,
+        [this, &inputs, &shared, &session](grpc::ClientContext &context)
+        {
+            context.AddMetadata(kFusedGradientMetadataKey, "1");
+            AddPartialsMetadata(context);
+            AddInputBytesMetadata(context, inputs);
+
+            // co-located servers exchange the values through shared memory
+            shared = AcquireSharedMemory(context);
+
+            // small variables are packed into shared messages if the server supports it
+            if (!shared and ServerSupports(kFeaturePackedVariables))
+                context.AddMetadata(kPackedVariablesMetadataKey, "1");
+
+            // only the inputs that changed since the previous call are sent
+            session = BeginInputSession(context, shared);
+        },
+        [this](grpc::ClientContext *context)
+        { return stub_->ComputeFunction(context); });
+
+    EvaluationStream &call = fused_stream_;
+    const bool reused = call.reused();
+    const bool packed = !shared and ServerSupports(kFeaturePackedVariables);
+
+    // send/assign inputs and preallocate outputs and partials
+    const size_t chunk_size = GetStreamOptions().num_double();
+    ArrayPacker packer(kInput, std::max<size_t>(chunk_size, 1));
+    ChunkPipeline pipeline(call.stream(), !shared and PipelineSends(inputs), GetCompression());
+
+    outputs.clear();
+    for (const VariableMetaData &var : GetVariableMetaAll())
     {
-        partials[make_pair(par.name(), par.subname())] = Variable(par);
+        const string &name = var.name();
+
+        if (var.type() == kInput)
+        {
+            // Only send if the input was actually provided
+            if (inputs.count(name) > 0 and (!session or session->Stage(name, inputs.at(name))) and
+                (!packed or !packer.Add(name, inputs.at(name))))
+                SendVariable(name, inputs.at(name), shared, &pipeline, session);
+        }
+
+        if (var.type() == kOutput)
+            outputs[var.name()] = AllocateResult(var);
     }
 
-    // process messages from server
+    for (const Array &message : packer.Finish())
+        pipeline.Write(Array(message));
+
+    // finish streaming data to the server
+    if (!pipeline.Finish())
+    {
+        // a reused stream may have been closed by the server (e.g., a restart)
+        if (reused)
+        {
+            call.Cancel();
+            return ComputeFunctionAndGradient(inputs);
+        }
+
+        // the server may have rejected the call under load
+        grpc::Status status = call.Fail();
+        span.Finish(status);
+        if (BackOff(status, call.retry_after()))
+            return ComputeFunctionAndGradient(inputs);
+        throw std::runtime_error("ComputeFunctionAndGradient: failed to write inputs to stream");
+    }
+    call.EndInputs();
+
+    partials = Partials();
+    for (const auto &par : GetPartialsMetaConst())
+        partials[make_pair(par.name(), par.subname())] = AllocateVariable(par, GetFileStorage());
+
+    // outputs have no subname, partials carry the input name
     Array result;
-    while (stream->Read(&result))
+    while (call.Read(&result))
     {
-        const string name = result.name();
-        const string subname = result.subname();
+        if (IsPackedArray(result))
+        {
+            try
+            {
+                for (const PackedEntry &entry : DecodePackedIndex(result))
+                    AssignPackedEntry(result, entry, outputs.at(entry.name));
+            }
+            catch (const std::exception &e)
+            {
+                call.Cancel();
+                throw std::runtime_error("ComputeFunctionAndGradient: invalid packed outputs: " +
+                                         string(e.what()));
+            }
+            continue;
+        }
 
-        partials[make_pair(name, subname)].AssignChunk(result);
+        if (result.subname().empty() or IsDiscreteChunk(result))
+            shared.Assign(result, outputs[result.name()], SendPrecision());
+        else
+            shared.Assign(result, partials[make_pair(result.name(), result.subname())], SendPrecision());
     }
 
-    grpc::Status status = stream->Finish();
+    grpc::Status status = call.Finish();
+    span.Finish(status);
+    if (EndInputSession(session, status))
+        return ComputeFunctionAndGradient(inputs);
+    if (BackOff(status, call.retry_after()))
+        return ComputeFunctionAndGradient(inputs);
+    if (reused and (status.error_code() == grpc::StatusCode::UNAVAILABLE or
+                    status.error_code() == grpc::StatusCode::CANCELLED))
+        return ComputeFunctionAndGradient(inputs);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -153,10 +705,169 @@ philote::Partials ExplicitClient::ComputeGradient(const Variables &inputs)
                                    std::to_string(GetRPCTimeout().count()) +
                                    "ms: " + status.error_message());
         }
-        throw std::runtime_error("ComputeGradient RPC failed: [" +
+        throw std::runtime_error("ComputeFunction RPC failed: [" +
                                  std::to_string(status.error_code()) + "] " +
                                  status.error_message());
     }
 
-    return partials;
-}
\ No newline at end of file
+    if (function_cache_.enabled())
+        function_cache_.Insert(inputs, ResultGeneration(), outputs);
+    if (gradient_cache_.enabled())
+        gradient_cache_.Insert(inputs, ResultGeneration(), partials);
+
+    return make_pair(std::move(outputs), std::move(partials));
+}
+
+void ExplicitClient::EnableResultCache(size_t max_bytes)
+{
+    function_cache_.SetMaxBytes(max_bytes);
+    gradient_cache_.SetMaxBytes(max_bytes);
+}
+
+philote::ResultCacheStats ExplicitClient::GetResultCacheStats() const
+{
+    ResultCacheStats stats = function_cache_.stats();
+    stats += gradient_cache_.stats();
+    return stats;
+}
+
+void ExplicitClient::ComputeFunctionAsync(const Variables &inputs, AsyncCallback<Variables> callback)
+{
+    auto *service = stub_->async();
+    if (service == nullptr)
+        throw std::runtime_error("ComputeFunctionAsync: the stub does not support the callback API");
+
+    // serialize inputs and preallocate outputs
+    vector<Array> messages;
+    auto outputs = std::make_shared<Variables>();
+    const bool packed = ServerSupports(kFeaturePackedVariables);
+    const size_t chunk_size = GetStreamOptions().num_double();
+    ArrayPacker packer(kInput, std::max<size_t>(chunk_size, 1));
+
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        const string &name = var.name();
+
+        if (var.type() == kInput)
+        {
+            // Only send if the input was actually provided
+            if (inputs.count(name) > 0 and (!packed or !packer.Add(name, inputs.at(name))))
+                inputs.at(name).Send(name, "", &messages, chunk_size, SendPrecision(name));
+        }
+
+        if (var.type() == kOutput)
+            (*outputs)[var.name()] = AllocateResult(var);
+    }
+
+    const vector<Array> &packed_messages = packer.Finish();
+    messages.insert(messages.end(), packed_messages.begin(), packed_messages.end());
+
+    const auto timeout = GetRPCTimeout();
+    const WirePrecision precision = SendPrecision();
+    auto span = std::make_shared<ClientCallSpan>();
+    auto *call = new AsyncArrayCall(
+        std::move(messages),
+        [outputs, precision](const Array &result)
+        {
+            if (IsPackedArray(result))
+            {
+                for (const PackedEntry &entry : DecodePackedIndex(result))
+                    AssignPackedEntry(result, entry, outputs->at(entry.name));
+                return;
+            }
+
+            outputs->at(result.name()).AssignChunk(result, precision);
+        },
+        [outputs, callback, timeout, span](const grpc::Status &status, std::exception_ptr error)
+        {
+            span->Finish(status);
+            if (!error && !status.ok())
+                error = MakeRPCError("ComputeFunction", status, timeout);
+
+            if (error)
+                callback(Variables(), error);
+            else
+                callback(std::move(*outputs), nullptr);
+        });
+
+    call->context().set_deadline(std::chrono::system_clock::now() + timeout);
+    AddWirePrecisionMetadata(call->context());
+    ApplyCompression(call->context());
+    call->SetCompression(GetCompression());
+    if (packed)
+        call->context().AddMetadata(kPackedVariablesMetadataKey, "1");
+    *span = TraceCall("ComputeFunction", call->context());
+    call->Begin([service](grpc::ClientContext *context,
+                          grpc::ClientBidiReactor<Array, Array> *reactor)
+                { service->ComputeFunction(context, reactor); });
+}
+
+std::future<philote::Variables> ExplicitClient::ComputeFunctionAsync(const Variables &inputs)
+{
+    auto promise = std::make_shared<std::promise<Variables>>();
+    auto future = promise->get_future();
+    ComputeFunctionAsync(inputs, PromiseCallback(promise));
+    return future;
+}
+
+void ExplicitClient::ComputeGradientAsync(const Variables &inputs, AsyncCallback<Partials> callback)
+{
+    auto *service = stub_->async();
+    if (service == nullptr)
+        throw std::runtime_error("ComputeGradientAsync: the stub does not support the callback API");
+
+    // serialize inputs
+    vector<Array> messages;
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        const string &name = var.name();
+
+        // Only send if the input was actually provided
+        if (var.type() == kInput and inputs.count(name) > 0)
+            inputs.at(name).Send(name, "", &messages, GetStreamOptions().num_double(), SendPrecision(name));
+    }
+
+    // preallocate partials
+    auto partials = std::make_shared<Partials>();
+    for (const auto &par : GetPartialsMetaConst())
+        (*partials)[make_pair(par.name(), par.subname())] = AllocateVariable(par, GetFileStorage());
+
+    const auto timeout = GetRPCTimeout();
+    const WirePrecision precision = SendPrecision();
+    auto span = std::make_shared<ClientCallSpan>();
+    auto *call = new AsyncArrayCall(
+        std::move(messages),
+        [partials, precision](const Array &result)
+        {
+            partials->at(make_pair(result.name(), result.subname())).AssignChunk(result, precision);
+        },
+        [partials, callback, timeout, span](const grpc::Status &status, std::exception_ptr error)
+        {
+            span->Finish(status);
+            if (!error && !status.ok())
+                error = MakeRPCError("ComputeGradient", status, timeout);
+
+            if (error)
+                callback(Partials(), error);
+            else
+                callback(std::move(*partials), nullptr);
+        });
+
+    call->context().set_deadline(std::chrono::system_clock::now() + timeout);
+    AddWirePrecisionMetadata(call->context());
+    ApplyCompression(call->context());
+    call->SetCompression(GetCompression());
+    AddPartialsMetadata(call->context());
+    *span = TraceCall("ComputeGradient", call->context());
+    call->Begin([service](grpc::ClientContext *context,
+                          grpc::ClientBidiReactor<Array, Array> *reactor)
+                { service->ComputeGradient(context, reactor); });
+}
+
+std::future<philote::Partials> ExplicitClient::ComputeGradientAsync(const Variables &inputs)
+{
+    auto promise = std::make_shared<std::promise<Partials>>();
+    auto future = promise->get_future();
+    ComputeGradientAsync(inputs, PromiseCallback(promise));
+    return future;
+}
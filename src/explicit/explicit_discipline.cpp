@@ -28,9 +28,18 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
 #include <grpcpp/grpcpp.h>
 
 #include "explicit.h"
+#include "jacobian_product.h"
 
 using grpc::Server;
 using grpc::ServerBuilder;
@@ -49,6 +58,7 @@ ExplicitDiscipline::ExplicitDiscipline()
 
 ExplicitDiscipline::~ExplicitDiscipline() noexcept
 {
+    explicit_callback_.UnlinkPointers();
     explicit_.UnlinkPointers();
     discipline_server_.UnlinkPointers();
 }
@@ -61,10 +71,71 @@ void ExplicitDiscipline::RegisterServices(ServerBuilder &builder)
     discipline_server_.LinkPointers(shared_from_this());
     explicit_.LinkPointers(self);
 
+    ApplyMessageLimits(builder);
     builder.RegisterService(&discipline_server_);
     builder.RegisterService(&explicit_);
 }
 
+void ExplicitDiscipline::RegisterServices(ServerBuilder &builder, philote::ServerEngine engine,
+                                          size_t compute_threads, const philote::ThreadPlacement &placement)
+{
+    explicit_.SetPlacement(placement);
+
+    if (engine == philote::ServerEngine::kSynchronous)
+    {
+        RegisterServices(builder);
+        return;
+    }
+
+    // Link servers to this discipline instance using shared_from_this()
+    auto self = std::dynamic_pointer_cast<ExplicitDiscipline>(shared_from_this());
+    discipline_server_.LinkPointers(shared_from_this());
+    explicit_.LinkPointers(self);
+    explicit_callback_.LinkPointers(&explicit_, compute_threads);
+
+    // the callback server runs the compute RPCs with the logic of explicit_
+    ApplyMessageLimits(builder);
+    builder.RegisterService(&discipline_server_);
+    builder.RegisterService(&explicit_callback_);
+}
+
+void ExplicitDiscipline::EnableInstancePool(philote::InstancePool<ExplicitDiscipline>::Factory factory,
+                                            size_t size)
+{
+    explicit_.SetInstancePool(
+        std::make_shared<philote::InstancePool<ExplicitDiscipline>>(std::move(factory), size));
+}
+
+std::shared_ptr<Server> ExplicitDiscipline::ServeUnixSocket(const std::string &path, philote::ServerEngine engine,
+                                                          size_t compute_threads)
+{
+    ServerBuilder builder;
+    builder.AddListeningPort(philote::UnixSocketAddress(path), grpc::InsecureServerCredentials());
+    RegisterServices(builder, engine, compute_threads);
+
+    return philote::StartDisciplineServer(builder, shared_from_this());
+}
+
+std::unique_ptr<philote::ExplicitClient> ExplicitDiscipline::ServeInProcess(philote::ServerEngine engine,
+                                                                       size_t compute_threads)
+{
+    ServerBuilder builder;
+    RegisterServices(builder, engine, compute_threads);
+    std::shared_ptr<Server> server = philote::StartDisciplineServer(builder, shared_from_this());
+
+    auto client = std::make_unique<philote::ExplicitClient>();
+    client->SetMaxMessageBytes(max_message_bytes());
+    client->ConnectChannel(philote::CreateInProcessChannel(*server, max_message_bytes()));
+    client->OwnServer(server);
+
+    client->GetInfo();
+    client->Setup();
+    client->GetVariableDefinitions();
+    client->GetPartialDefinitions();
+
+    return client;
+}
+
 void ExplicitDiscipline::Compute(const Variables &inputs,
                                  philote::Variables &outputs)
 {
@@ -72,9 +143,531 @@ void ExplicitDiscipline::Compute(const Variables &inputs,
     // No default implementation provided
 }
 
+void ExplicitDiscipline::ComputeFlat(const philote::FlatVariables &inputs,
+                                     philote::FlatVariables &outputs)
+{
+    Compute(inputs.map(), outputs.map());
+}
+
+void ExplicitDiscipline::ComputeStreaming(const philote::FlatVariables &inputs,
+                                          philote::FlatVariables &outputs,
+                                          philote::OutputWriter &writer)
+{
+    ComputeFlat(inputs, outputs);
+}
+
+void ExplicitDiscipline::ComputeBatch(const std::vector<Variables> &inputs,
+                                      std::vector<Variables> &outputs)
+{
+    // evaluate the design points one at a time
+    for (size_t i = 0; i < inputs.size(); i++)
+        Compute(inputs[i], outputs.at(i));
+}
+
 void ExplicitDiscipline::ComputePartials(const Variables &inputs,
                                          Partials &partials)
 {
-    // This method is intended to be overridden by derived classes
-    // No default implementation provided
-}
\ No newline at end of file
+    // This method is intended to be overridden by derived classes, unless the
+    // partials are computed block by block or approximated
+    if (block_partials())
+        ComputePartialBlocks(inputs, partials);
+    else
+        ComputeApproximatePartials(inputs, partials);
+}
+
+void ExplicitDiscipline::ComputePartial(const std::string &of, const std::string &wrt,
+                                        const Variables &inputs, philote::Variable &block)
+{
+    throw std::logic_error("ComputePartial is not implemented for partial " + of + "/" + wrt);
+}
+
+void ExplicitDiscipline::EnableBlockPartials(size_t threads)
+{
+    block_pool_ = std::make_unique<philote::ThreadPool>(threads);
+}
+
+void ExplicitDiscipline::ComputePartialBlocks(const Variables &inputs, Partials &partials,
+                                              const PartialBlockCallback &finished)
+{
+    if (!block_pool_)
+        throw std::logic_error("ComputePartialBlocks requires EnableBlockPartials");
+
+    struct Progress
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<Partials::value_type *> done;
+        std::exception_ptr error;
+        size_t running = 0;
+    };
+    auto progress = std::make_shared<Progress>();
+
+    // the blocks reference the inputs and partials, so they must finish
+    // before returning (also if the callback throws)
+    struct WaitForBlocks
+    {
+        Progress &progress;
+
+        ~WaitForBlocks()
+        {
+            std::unique_lock<std::mutex> lock(progress.mutex);
+            progress.changed.wait(lock, [this]
+                                  { return progress.running == 0; });
+        }
+    } wait{*progress};
+
+    // approximated partials are computed once the blocks finished
+    size_t submitted = 0;
+    for (auto &block : partials)
+    {
+        if (approximations_.count(block.first) > 0)
+            continue;
+
+        {
+            std::lock_guard<std::mutex> lock(progress->mutex);
+            progress->running++;
+        }
+        submitted++;
+
+        block_pool_->Submit([this, progress, &inputs, &block]
+                            {
+                                // the remaining blocks are skipped after an error
+                                std::exception_ptr error;
+                                {
+                                    std::lock_guard<std::mutex> lock(progress->mutex);
+                                    error = progress->error;
+                                }
+
+                                if (!error)
+                                {
+                                    try
+                                    {
+                                        ComputePartial(block.first.first, block.first.second, inputs, block.second);
+                                    }
+                                    catch (...)
+                                    {
+                                        error = std::current_exception();
+                                    }
+                                }
+
+                                std::lock_guard<std::mutex> lock(progress->mutex);
+                                if (!error)
+                                    progress->done.push_back(&block);
+                                else if (!progress->error)
+                                    progress->error = error;
+                                progress->running--;
+                                progress->changed.notify_all();
+                            });
+    }
+
+    // hand the blocks to the callback as they finish
+    size_t delivered = 0;
+    while (delivered < submitted)
+    {
+        Partials::value_type *block = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(progress->mutex);
+            progress->changed.wait(lock, [&progress]
+                                   { return progress->error or !progress->done.empty() or progress->running == 0; });
+            if (progress->error or progress->done.empty())
+                break;
+
+            block = progress->done.front();
+            progress->done.pop_front();
+        }
+
+        delivered++;
+        if (finished)
+        {
+            try
+            {
+                finished(block->first.first, block->first.second, block->second);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(progress->mutex);
+                if (!progress->error)
+                    progress->error = std::current_exception();
+                break;
+            }
+        }
+    }
+
+    // rethrow the first error once the running blocks finished
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(progress->mutex);
+        progress->changed.wait(lock, [&progress]
+                               { return progress->running == 0; });
+        error = progress->error;
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    ComputeApproximatePartials(inputs, partials);
+    if (finished)
+    {
+        for (const auto &approximation : approximations_)
+        {
+            auto block = partials.find(approximation.first);
+            if (block != partials.end())
+                finished(block->first.first, block->first.second, block->second);
+        }
+    }
+}
+
+void ExplicitDiscipline::DeclarePartials(const std::string &f, const std::string &x,
+                                         philote::PartialsMethod method, double step)
+{
+    if (!(step > 0.0))
+        throw std::invalid_argument("Finite difference step of partials (" + f + ", " + x + ") must be positive");
+
+    Discipline::DeclarePartials(f, x);
+    if (method == philote::PartialsMethod::kAnalytic)
+        approximations_.erase({f, x});
+    else
+        approximations_[{f, x}] = Approximation{method, step};
+}
+
+void ExplicitDiscipline::DeclarePartials(const std::string &f, const std::string &x,
+                                         const std::vector<int64_t> &rows,
+                                         const std::vector<int64_t> &cols,
+                                         philote::PartialsMethod method, double step)
+{
+    if (!(step > 0.0))
+        throw std::invalid_argument("Finite difference step of partials (" + f + ", " + x + ") must be positive");
+
+    Discipline::DeclarePartials(f, x, rows, cols);
+    if (method == philote::PartialsMethod::kAnalytic)
+        approximations_.erase({f, x});
+    else
+        approximations_[{f, x}] = Approximation{method, step};
+}
+
+philote::PartialsMethod ExplicitDiscipline::partials_method(const std::string &f, const std::string &x) const
+{
+    auto it = approximations_.find({f, x});
+    return it == approximations_.end() ? philote::PartialsMethod::kAnalytic : it->second.method;
+}
+
+void ExplicitDiscipline::EnableParallelFiniteDifferences(philote::InstancePool<ExplicitDiscipline>::Factory factory,
+                                                         size_t size)
+{
+    fd_instances_ = std::make_shared<philote::InstancePool<ExplicitDiscipline>>(std::move(factory), size);
+    fd_pool_ = std::make_unique<philote::ThreadPool>(size);
+}
+
+void ExplicitDiscipline::ClearMetaData()
+{
+    Discipline::ClearMetaData();
+    approximations_.clear();
+}
+
+namespace
+{
+    //! approximated partial of one output with respect to the perturbed input
+    struct ApproximatedBlock
+    {
+        //! output variable
+        std::string of;
+
+        //! preallocated values of the partial
+        philote::Variable *values = nullptr;
+
+        //! whether values holds the non-zeros of a sparsity pattern
+        bool sparse = false;
+
+        //! number of elements of the output
+        size_t num_rows = 0;
+
+        //! non-zeros of each column as (row, index into values), if sparse
+        std::vector<std::vector<std::pair<size_t, size_t>>> columns;
+    };
+
+    //! perturbations of one input (with a common method and step)
+    struct PerturbationPlan
+    {
+        std::string wrt;
+        philote::PartialsMethod method;
+        double step;
+        std::vector<ApproximatedBlock> blocks;
+
+        //! columns perturbed together (see ColorColumns)
+        std::vector<std::vector<size_t>> groups;
+    };
+}
+
+void ExplicitDiscipline::ComputeApproximatePartials(const Variables &inputs, Partials &partials)
+{
+    if (approximations_.empty())
+        return;
+
+    // collect the approximated partials by perturbed input
+    std::vector<PerturbationPlan> plans;
+    for (const auto &approximation : approximations_)
+    {
+        auto partial = partials.find(approximation.first);
+        if (partial == partials.end())
+            continue;
+
+        const std::string &of = approximation.first.first;
+        const std::string &wrt = approximation.first.second;
+        const Approximation &method = approximation.second;
+
+        auto plan = std::find_if(plans.begin(), plans.end(), [&](const PerturbationPlan &candidate)
+                                 { return candidate.wrt == wrt and candidate.method == method.method and
+                                          candidate.step == method.step; });
+        if (plan == plans.end())
+        {
+            plans.push_back(PerturbationPlan{wrt, method.method, method.step, {}, {}});
+            plan = plans.end() - 1;
+        }
+
+        const philote::VariableMetaData *output = FindVariableMeta(of);
+        if (!output)
+            throw std::runtime_error("Output " + of + " of approximated partials not found");
+
+        ApproximatedBlock block;
+        block.of = of;
+        block.values = &partial->second;
+        block.num_rows = 1;
+        for (const auto &dim : output->shape())
+            block.num_rows *= static_cast<size_t>(dim);
+
+        auto pattern = partials_sparsity().find(approximation.first);
+        if (pattern != partials_sparsity().end())
+        {
+            block.sparse = true;
+            block.columns.resize(inputs.at(wrt).Size());
+            for (size_t k = 0; k < pattern->second.nnz(); k++)
+                block.columns.at(static_cast<size_t>(pattern->second.cols[k]))
+                    .emplace_back(static_cast<size_t>(pattern->second.rows[k]), k);
+        }
+
+        plan->blocks.push_back(std::move(block));
+    }
+
+    // color the columns of the stacked partials of each input
+    std::vector<std::pair<size_t, size_t>> jobs;
+    for (size_t p = 0; p < plans.size(); p++)
+    {
+        PerturbationPlan &plan = plans[p];
+        const size_t num_cols = inputs.at(plan.wrt).Size();
+
+        std::vector<std::vector<size_t>> column_rows(num_cols);
+        size_t offset = 0;
+        for (const ApproximatedBlock &block : plan.blocks)
+        {
+            for (size_t col = 0; col < num_cols; col++)
+            {
+                if (block.sparse)
+                {
+                    for (const auto &entry : block.columns[col])
+                        column_rows[col].push_back(offset + entry.first);
+                }
+                else
+                {
+                    for (size_t row = 0; row < block.num_rows; row++)
+                        column_rows[col].push_back(offset + row);
+                }
+            }
+            offset += block.num_rows;
+        }
+
+        plan.groups = philote::ColorColumns(column_rows, offset);
+        for (size_t g = 0; g < plan.groups.size(); g++)
+            jobs.emplace_back(p, g);
+    }
+
+    // preallocated outputs, copied once per evaluating instance
+    Variables outputs;
+    for (const auto &var : var_meta())
+    {
+        if (var.type() == philote::kOutput)
+            outputs[var.name()] = philote::Variable(var);
+    }
+
+    // forward differences share the unperturbed evaluation
+    Variables base;
+    const bool forward = std::any_of(plans.begin(), plans.end(), [](const PerturbationPlan &plan)
+                                     { return plan.method == philote::PartialsMethod::kForwardDifference; });
+    if (forward)
+    {
+        base = outputs;
+        Compute(inputs, base);
+    }
+
+    // evaluates every stride-th perturbation, starting at first
+    auto evaluate = [&](ExplicitDiscipline &evaluator, size_t first, size_t stride)
+    {
+        Variables perturbed = inputs;
+        Variables upper = outputs;
+        Variables lower = outputs;
+
+        for (size_t j = first; j < jobs.size(); j += stride)
+        {
+            const PerturbationPlan &plan = plans[jobs[j].first];
+            const std::vector<size_t> &group = plan.groups[jobs[j].second];
+            const philote::Variable &x = inputs.at(plan.wrt);
+            philote::Variable &shifted = perturbed.at(plan.wrt);
+            const bool central = plan.method == philote::PartialsMethod::kCentralDifference;
+
+            for (size_t col : group)
+                shifted(col) = x(col) + plan.step;
+            evaluator.Compute(perturbed, upper);
+
+            if (central)
+            {
+                for (size_t col : group)
+                    shifted(col) = x(col) - plan.step;
+                evaluator.Compute(perturbed, lower);
+            }
+
+            // restore the exact input values
+            for (size_t col : group)
+                shifted(col) = x(col);
+
+            const Variables &reference = central ? lower : base;
+            const double width = central ? 2.0 * plan.step : plan.step;
+            for (const ApproximatedBlock &block : plan.blocks)
+            {
+                const philote::Variable &high = upper.at(block.of);
+                const philote::Variable &low = reference.at(block.of);
+                const size_t num_cols = x.Size();
+
+                for (size_t col : group)
+                {
+                    if (block.sparse)
+                    {
+                        for (const auto &entry : block.columns[col])
+                            (*block.values)(entry.second) = (high(entry.first) - low(entry.first)) / width;
+                    }
+                    else
+                    {
+                        for (size_t row = 0; row < block.num_rows; row++)
+                            (*block.values)(row * num_cols + col) = (high(row) - low(row)) / width;
+                    }
+                }
+            }
+        }
+    };
+
+    if (!fd_instances_ or jobs.size() < 2)
+    {
+        evaluate(*this, 0, 1);
+        return;
+    }
+
+    // every worker evaluates its share of the perturbations on a pooled instance
+    struct Progress
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::exception_ptr error;
+        size_t running = 0;
+    };
+    auto progress = std::make_shared<Progress>();
+
+    const size_t workers = std::min(fd_pool_->size(), jobs.size());
+    for (size_t w = 0; w < workers; w++)
+    {
+        {
+            std::lock_guard<std::mutex> lock(progress->mutex);
+            progress->running++;
+        }
+
+        fd_pool_->Submit([this, progress, &evaluate, w, workers]
+                         {
+                             std::exception_ptr error;
+                             try
+                             {
+                                 auto instance = fd_instances_->Acquire(*this);
+                                 evaluate(*instance, w, workers);
+                             }
+                             catch (...)
+                             {
+                                 error = std::current_exception();
+                             }
+
+                             std::lock_guard<std::mutex> lock(progress->mutex);
+                             if (error and !progress->error)
+                                 progress->error = error;
+                             progress->running--;
+                             progress->changed.notify_all();
+                         });
+    }
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(progress->mutex);
+        progress->changed.wait(lock, [&progress]
+                               { return progress->running == 0; });
+        error = progress->error;
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ExplicitDiscipline::ComputeWithPartials(const philote::FlatVariables &inputs,
+                                             philote::FlatVariables &outputs,
+                                             Partials &partials)
+{
+    ComputeFlat(inputs, outputs);
+    ComputePartials(inputs.map(), partials);
+}
+
+namespace
+{
+    //! Allocates the partials declared by a discipline
+    Partials AllocatePartials(const std::vector<philote::PartialsMetaData> &partials_meta)
+    {
+        Partials partials;
+        for (const philote::PartialsMetaData &par : partials_meta)
+        {
+            std::vector<size_t> shape(par.shape().begin(), par.shape().end());
+            partials[std::make_pair(par.name(), par.subname())] = philote::Variable(philote::kOutput, shape);
+        }
+        return partials;
+    }
+}
+
+void ExplicitDiscipline::ComputeJacVec(const Variables &inputs,
+                                       const Variables &seeds,
+                                       Variables &products)
+{
+    Partials partials = AllocatePartials(partials_meta());
+    ComputePartials(inputs, partials);
+    philote::MultiplyJacobian(partials, partials_sparsity(), seeds, products);
+}
+
+void ExplicitDiscipline::ComputeVecJac(const Variables &inputs,
+                                       const Variables &seeds,
+                                       Variables &products)
+{
+    Partials partials = AllocatePartials(partials_meta());
+    ComputePartials(inputs, partials);
+    philote::MultiplyJacobianTranspose(partials, partials_sparsity(), seeds, products);
+}
+
+void ExplicitDiscipline::MemoizePartials(const Variables &inputs, const Partials &partials)
+{
+    std::lock_guard<std::mutex> lock(memo_mutex_);
+    memo_inputs_ = inputs;
+    memo_partials_ = partials;
+    memo_generation_ = configuration_generation();
+    memo_valid_ = true;
+}
+
+bool ExplicitDiscipline::RecallPartials(const Variables &inputs, Partials &partials) const
+{
+    std::lock_guard<std::mutex> lock(memo_mutex_);
+    if (!memo_valid_ or memo_generation_ != configuration_generation() or
+        !philote::IdenticalVariables(memo_inputs_, inputs))
+        return false;
+
+    // assign element-wise to keep the preallocated storage
+    for (const auto &par : memo_partials_)
+        partials[par.first] = par.second;
+
+    return true;
+}
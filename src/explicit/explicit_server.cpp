@@ -28,6 +28,7 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <stdexcept>
 #include <vector>
 #include "explicit.h"
 
@@ -43,6 +44,8 @@ using grpc::ServerReaderWriterInterface;
 using grpc::ServerWriter;
 using grpc::Status;
 
+using philote::Array;
+using philote::ExplicitCallbackServer;
 using philote::ExplicitServer;
 using philote::Partials;
 using philote::Variables;
@@ -62,16 +65,180 @@ void ExplicitServer::UnlinkPointers()
     implementation_.reset();
 }
 
+void ExplicitServer::SetInstancePool(std::shared_ptr<philote::InstancePool<philote::ExplicitDiscipline>> pool)
+{
+    pool_ = pool;
+}
+
+void ExplicitServer::SetPlacement(const philote::ThreadPlacement &placement)
+{
+    if (!pool_)
+    {
+        if (placement.policy != philote::PlacementPolicy::kNone)
+            throw std::invalid_argument("Placing discipline instances requires an instance pool");
+        return;
+    }
+
+    pool_->SetPlacement(philote::PlacementSlots(placement));
+}
+
+philote::MetricsRecorder *ExplicitServer::metrics_recorder() const noexcept
+{
+    return implementation_ ? implementation_->metrics_recorder() : nullptr;
+}
+
+philote::Tracer *ExplicitServer::tracer() const noexcept
+{
+    return implementation_ ? implementation_->tracer() : nullptr;
+}
+
+philote::AdmissionController *ExplicitServer::admission_controller() const noexcept
+{
+    return implementation_ ? implementation_->admission_controller() : nullptr;
+}
+
+Status ExplicitServer::AcquireInstance(grpc::ServerContextBase *context,
+                                      philote::InstancePool<philote::ExplicitDiscipline>::Lease &lease)
+{
+    if (!pool_)
+    {
+        lease = philote::InstancePool<philote::ExplicitDiscipline>::Lease(implementation_);
+        return Status::OK;
+    }
+
+    try
+    {
+        if (!context)
+        {
+            lease = pool_->Acquire(*implementation_);
+            return Status::OK;
+        }
+
+        // a call must not wait for an instance after it has ended
+        philote::CancellationMonitor &monitor = philote::CancellationMonitor::Instance();
+        philote::CancellationToken cancellation = monitor.Watch(context);
+        try
+        {
+            lease = pool_->Acquire(*implementation_, context->deadline(), cancellation);
+        }
+        catch (...)
+        {
+            monitor.Unwatch(context);
+            throw;
+        }
+        monitor.Unwatch(context);
+
+        if (!lease)
+        {
+            if (cancellation.IsCancelled())
+                return Status(grpc::StatusCode::CANCELLED,
+                              "Request cancelled while waiting for a discipline instance");
+            return Status(grpc::StatusCode::DEADLINE_EXCEEDED,
+                          "Deadline exceeded while waiting for a discipline instance");
+        }
+    }
+    catch (const std::exception &e)
+    {
+        return Status(grpc::StatusCode::INTERNAL,
+                      "Failed to acquire discipline instance: " + std::string(e.what()));
+    }
+
+    return Status::OK;
+}
+
 Status ExplicitServer::ComputeFunction(ServerContext *context,
                                        grpc::ServerReaderWriter<::philote::Array,
                                                                ::philote::Array> *stream)
 {
-    return ComputeFunctionImpl(context, stream);
+    return philote::CompressCall(context, stream, [this, context](auto *compressed)
+    {
+        return philote::ServeEvaluations(context, compressed, [this, context](auto *evaluation)
+        {
+            return philote::AdmitCall(admission_controller(), context, evaluation, [this, context](auto *admitted)
+            {
+                return philote::ObserveCall(metrics_recorder(), tracer(), context, "ComputeFunction", admitted,
+                                            [this, context](auto *metered)
+                                            { return ComputeFunctionImpl(context, metered); });
+            });
+        });
+    });
 }
 
 Status ExplicitServer::ComputeGradient(ServerContext *context,
                                        grpc::ServerReaderWriter<::philote::Array,
                                                                ::philote::Array> *stream)
 {
-    return ComputeGradientImpl(context, stream);
+    return philote::CompressCall(context, stream, [this, context](auto *compressed)
+    {
+        return philote::ServeEvaluations(context, compressed, [this, context](auto *evaluation)
+        {
+            return philote::AdmitCall(admission_controller(), context, evaluation, [this, context](auto *admitted)
+            {
+                return philote::ObserveCall(metrics_recorder(), tracer(), context, "ComputeGradient", admitted,
+                                            [this, context](auto *metered)
+                                            { return ComputeGradientImpl(context, metered); });
+            });
+        });
+    });
+}
+
+ExplicitCallbackServer::~ExplicitCallbackServer() noexcept
+{
+    UnlinkPointers();
+}
+
+void ExplicitCallbackServer::LinkPointers(philote::ExplicitServer *server, size_t threads)
+{
+    server_ = server;
+    if (!executor_)
+        executor_ = std::make_unique<philote::ThreadPool>(threads);
+}
+
+void ExplicitCallbackServer::UnlinkPointers()
+{
+    server_ = nullptr;
+}
+
+grpc::ServerBidiReactor<Array, Array> *ExplicitCallbackServer::ComputeFunction(grpc::CallbackServerContext *context)
+{
+    if (!server_ or !executor_)
+        return philote::RejectArrayStream(Status(grpc::StatusCode::FAILED_PRECONDITION,
+                                                 "Explicit server not linked"));
+
+    ExplicitServer *server = server_;
+    return new philote::ArrayStreamReactor(
+        *executor_,
+        [server, context](ServerReaderWriterInterface<Array, Array> *stream)
+        {
+            return philote::CompressCall(context, stream, [server, context](auto *compressed)
+            {
+                return philote::ObserveCall(server->metrics_recorder(), server->tracer(), context,
+                                            "ComputeFunction", compressed,
+                                            [server, context](ServerReaderWriterInterface<Array, Array> *metered)
+                                            { return server->ComputeFunctionImpl(context, metered); });
+            });
+        },
+        philote::RequestsEvaluationStream(context), context, server->admission_controller());
+}
+
+grpc::ServerBidiReactor<Array, Array> *ExplicitCallbackServer::ComputeGradient(grpc::CallbackServerContext *context)
+{
+    if (!server_ or !executor_)
+        return philote::RejectArrayStream(Status(grpc::StatusCode::FAILED_PRECONDITION,
+                                                 "Explicit server not linked"));
+
+    ExplicitServer *server = server_;
+    return new philote::ArrayStreamReactor(
+        *executor_,
+        [server, context](ServerReaderWriterInterface<Array, Array> *stream)
+        {
+            return philote::CompressCall(context, stream, [server, context](auto *compressed)
+            {
+                return philote::ObserveCall(server->metrics_recorder(), server->tracer(), context,
+                                            "ComputeGradient", compressed,
+                                            [server, context](ServerReaderWriterInterface<Array, Array> *metered)
+                                            { return server->ComputeGradientImpl(context, metered); });
+            });
+        },
+        philote::RequestsEvaluationStream(context), context, server->admission_controller());
 }
@@ -29,6 +29,7 @@
     control over the information you may find at these locations.
 */
 #include "implicit.h"
+#include "jacobian_product.h"
 
 using std::shared_ptr;
 using std::string;
@@ -37,6 +38,8 @@ using grpc::ChannelInterface;
 using grpc::ClientContext;
 using grpc::ClientReaderWriter;
 
+using philote::AsyncArrayCall;
+using philote::AsyncCallback;
 using philote::ImplicitClient;
 using philote::Partials;
 using philote::Variables;
@@ -49,38 +52,60 @@ void ImplicitClient::ConnectChannel(shared_ptr<ChannelInterface> channel)
 
 Variables ImplicitClient::ComputeResiduals(const Variables &vars)
 {
+    BackoffScope backoff(*this);
+    Variables res;
+    if (residual_cache_.Find(vars, ResultGeneration(), res))
+        return res;
+
     ClientContext context;
     context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
+    AddWirePrecisionMetadata(context);
+    ApplyCompression(context);
+    AddInputBytesMetadata(context, vars);
+    SharedMemoryTransfer shared = AcquireSharedMemory(context);
+    ClientCallSpan span = TraceCall("ComputeResiduals", context);
     std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
         stream(stub_->ComputeResiduals(&context));
 
     // send/assign inputs and outputs, preallocate residuals
-    Variables res;
+    ChunkPipeline pipeline(stream.get(), !shared and PipelineSends(vars), GetCompression());
     for (const VariableMetaData &var : GetVariableMetaAll())
     {
         const string &name = var.name();
 
         if (var.type() == kInput)
-            vars.at(name).Send(name, "", stream.get(), GetStreamOptions().num_double());
+            SendVariable(name, vars.at(name), shared, &pipeline);
 
         if (var.type() == kOutput)
         {
-            vars.at(name).Send(name, "", stream.get(), GetStreamOptions().num_double());
-            res[name] = Variable(var);
+            SendVariable(name, vars.at(name), shared, &pipeline);
+            res[name] = AllocateVariable(var, GetFileStorage());
         }
     }
 
     // finish streaming data to the server
+    if (!pipeline.Finish())
+    {
+        // the server may have rejected the call under load
+        grpc::Status status = stream->Finish();
+        span.Finish(status);
+        if (BackOff(status, context))
+            return ComputeResiduals(vars);
+        throw std::runtime_error("ComputeResiduals: failed to write variables to stream");
+    }
     stream->WritesDone();
 
     Array result;
     while (stream->Read(&result))
     {
         const string &name = result.name();
-        res[name].AssignChunk(result);
+        shared.Assign(result, res[name], SendPrecision());
     }
 
     grpc::Status status = stream->Finish();
+    span.Finish(status);
+    if (BackOff(status, context))
+        return ComputeResiduals(vars);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -94,18 +119,31 @@ Variables ImplicitClient::ComputeResiduals(const Variables &vars)
                                  status.error_message());
     }
 
+    if (residual_cache_.enabled())
+        residual_cache_.Insert(vars, ResultGeneration(), res);
+
     return res;
 }
 
 Variables ImplicitClient::SolveResiduals(const Variables &vars)
 {
+    BackoffScope backoff(*this);
+    Variables out;
+    if (solve_cache_.Find(vars, ResultGeneration(), out))
+        return out;
+
     ClientContext context;
     context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
+    AddWirePrecisionMetadata(context);
+    ApplyCompression(context);
+    AddInputBytesMetadata(context, vars);
+    SharedMemoryTransfer shared = AcquireSharedMemory(context);
+    ClientCallSpan span = TraceCall("SolveResiduals", context);
     std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
         stream(stub_->SolveResiduals(&context));
 
     // send inputs only (outputs are solved by the server)
-    Variables out;
+    ChunkPipeline pipeline(stream.get(), !shared and PipelineSends(vars), GetCompression());
     for (const VariableMetaData &var : GetVariableMetaAll())
     {
         const string &name = var.name();
@@ -114,27 +152,39 @@ Variables ImplicitClient::SolveResiduals(const Variables &vars)
         {
             // Only send if the input was actually provided
             if (vars.count(name) > 0)
-                vars.at(name).Send(name, "", stream.get(), GetStreamOptions().num_double());
+                SendVariable(name, vars.at(name), shared, &pipeline);
         }
 
         if (var.type() == kOutput)
         {
             // Preallocate output (do not send)
-            out[name] = Variable(var);
+            out[name] = AllocateResult(var);
         }
     }
 
     // finish streaming data to the server
+    if (!pipeline.Finish())
+    {
+        // the server may have rejected the call under load
+        grpc::Status status = stream->Finish();
+        span.Finish(status);
+        if (BackOff(status, context))
+            return SolveResiduals(vars);
+        throw std::runtime_error("SolveResiduals: failed to write variables to stream");
+    }
     stream->WritesDone();
 
     Array result;
     while (stream->Read(&result))
     {
         const string &name = result.name();
-        out[name].AssignChunk(result);
+        shared.Assign(result, out[name], SendPrecision());
     }
 
     grpc::Status status = stream->Finish();
+    span.Finish(status);
+    if (BackOff(status, context))
+        return SolveResiduals(vars);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -148,40 +198,124 @@ Variables ImplicitClient::SolveResiduals(const Variables &vars)
                                  status.error_message());
     }
 
+    if (solve_cache_.enabled())
+        solve_cache_.Insert(vars, ResultGeneration(), out);
+
     return out;
 }
 
+void ImplicitClient::SolveResidualsAsync(const Variables &vars, AsyncCallback<Variables> callback)
+{
+    auto *service = stub_->async();
+    if (service == nullptr)
+        throw std::runtime_error("SolveResidualsAsync: the stub does not support the callback API");
+
+    // serialize inputs only (outputs are solved by the server)
+    std::vector<Array> messages;
+    auto out = std::make_shared<Variables>();
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        const string &name = var.name();
+
+        // Only send if the input was actually provided
+        if (var.type() == kInput and vars.count(name) > 0)
+            vars.at(name).Send(name, "", &messages, GetStreamOptions().num_double(), SendPrecision(name));
+
+        // Preallocate output (do not send)
+        if (var.type() == kOutput)
+            (*out)[name] = AllocateResult(var);
+    }
+
+    const auto timeout = GetRPCTimeout();
+    const WirePrecision precision = SendPrecision();
+    auto span = std::make_shared<ClientCallSpan>();
+    auto *call = new AsyncArrayCall(
+        std::move(messages),
+        [out, precision](const Array &result)
+        {
+            out->at(result.name()).AssignChunk(result, precision);
+        },
+        [out, callback, timeout, span](const grpc::Status &status, std::exception_ptr error)
+        {
+            span->Finish(status);
+            if (!error && !status.ok())
+                error = MakeRPCError("SolveResiduals", status, timeout);
+
+            if (error)
+                callback(Variables(), error);
+            else
+                callback(std::move(*out), nullptr);
+        });
+
+    call->context().set_deadline(std::chrono::system_clock::now() + timeout);
+    AddWirePrecisionMetadata(call->context());
+    ApplyCompression(call->context());
+    call->SetCompression(GetCompression());
+    *span = TraceCall("SolveResiduals", call->context());
+    call->Begin([service](ClientContext *context,
+                          grpc::ClientBidiReactor<Array, Array> *reactor)
+                { service->SolveResiduals(context, reactor); });
+}
+
+std::future<Variables> ImplicitClient::SolveResidualsAsync(const Variables &vars)
+{
+    auto promise = std::make_shared<std::promise<Variables>>();
+    auto future = promise->get_future();
+    SolveResidualsAsync(vars, PromiseCallback(promise));
+    return future;
+}
+
 Partials ImplicitClient::ComputeResidualGradients(const Variables &vars)
 {
+    BackoffScope backoff(*this);
+    Partials partials;
+    if (gradient_cache_.Find(vars, ResultGeneration(), partials))
+        return partials;
+
     ClientContext context;
     context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
+    AddWirePrecisionMetadata(context);
+    ApplyCompression(context);
+    AddPartialsMetadata(context);
+    AddInputBytesMetadata(context, vars);
+    SharedMemoryTransfer shared = AcquireSharedMemory(context);
+    ClientCallSpan span = TraceCall("ComputeResidualGradients", context);
     std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
         stream(stub_->ComputeResidualGradients(&context));
 
     // send/assign inputs and outputs, preallocate residuals
     Variables out;
+    ChunkPipeline pipeline(stream.get(), !shared and PipelineSends(vars), GetCompression());
     for (const VariableMetaData &var : GetVariableMetaAll())
     {
         const string &name = var.name();
 
         if (var.type() == kInput)
-            vars.at(name).Send(name, "", stream.get(), GetStreamOptions().num_double());
+            SendVariable(name, vars.at(name), shared, &pipeline);
 
         if (var.type() == kOutput)
         {
-            vars.at(name).Send(name, "", stream.get(), GetStreamOptions().num_double());
+            SendVariable(name, vars.at(name), shared, &pipeline);
             out[name] = Variable(var);
         }
     }
 
     // finish streaming data to the server
+    if (!pipeline.Finish())
+    {
+        // the server may have rejected the call under load
+        grpc::Status status = stream->Finish();
+        span.Finish(status);
+        if (BackOff(status, context))
+            return ComputeResidualGradients(vars);
+        throw std::runtime_error("ComputeResidualGradients: failed to write variables to stream");
+    }
     stream->WritesDone();
 
     // preallocate partials
-    Partials partials;
     for (const auto &par : GetPartialsMetaConst())
     {
-        partials[make_pair(par.name(), par.subname())] = Variable(par);
+        partials[make_pair(par.name(), par.subname())] = AllocateVariable(par, GetFileStorage());
     }
 
     // process messages from server
@@ -191,10 +325,13 @@ Partials ImplicitClient::ComputeResidualGradients(const Variables &vars)
         const string name = result.name();
         const string subname = result.subname();
 
-        partials[make_pair(name, subname)].AssignChunk(result);
+        shared.Assign(result, partials[make_pair(name, subname)], SendPrecision());
     }
 
     grpc::Status status = stream->Finish();
+    span.Finish(status);
+    if (BackOff(status, context))
+        return ComputeResidualGradients(vars);
     if (!status.ok())
     {
         if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
@@ -208,5 +345,219 @@ Partials ImplicitClient::ComputeResidualGradients(const Variables &vars)
                                  status.error_message());
     }
 
+    if (gradient_cache_.enabled())
+        gradient_cache_.Insert(vars, ResultGeneration(), partials);
+
     return partials;
 }
+
+Variables ImplicitClient::ComputeJacVec(const Variables &vars, const Variables &seeds)
+{
+    return ComputeJacobianProduct(vars, seeds, false);
+}
+
+Variables ImplicitClient::ComputeVecJac(const Variables &vars, const Variables &seeds)
+{
+    return ComputeJacobianProduct(vars, seeds, true);
+}
+
+Variables ImplicitClient::ComputeJacobianProduct(const Variables &vars, const Variables &seeds, bool reverse)
+{
+    // products of forward mode are residuals, those of reverse mode inputs
+    // and outputs
+    Variables products;
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        if (var.type() == kOutput or (reverse and var.type() == kInput))
+            products[var.name()] = Variable(var);
+    }
+
+    // fall back to multiplying the residual gradients locally
+    if (!ServerSupports(kFeatureJacobianProducts))
+    {
+        const Partials partials = ComputeResidualGradients(vars);
+        if (reverse)
+            MultiplyJacobianTranspose(partials, GetPartialsSparsity(), seeds, products);
+        else
+            MultiplyJacobian(partials, GetPartialsSparsity(), seeds, products);
+        return products;
+    }
+
+    ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
+    AddWirePrecisionMetadata(context);
+    ApplyCompression(context);
+    context.AddMetadata(kJacobianProductMetadataKey, reverse ? kJacobianProductReverse : kJacobianProductForward);
+    ClientCallSpan span = TraceCall("ComputeResidualGradients", context);
+    std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
+        stream(stub_->ComputeResidualGradients(&context));
+
+    // send the inputs and outputs followed by the seeds (marked by their subname)
+    ChunkPipeline pipeline(stream.get(), false, GetCompression());
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        const string &name = var.name();
+        if (var.type() == kInput or var.type() == kOutput)
+            vars.at(name).Send(name, "", &pipeline, GetStreamOptions().num_double(), SendPrecision(name));
+    }
+    for (const auto &seed : seeds)
+        seed.second.Send(seed.first, kJacobianSeedSubname, &pipeline, GetStreamOptions().num_double(),
+                         SendPrecision());
+
+    // finish streaming data to the server
+    stream->WritesDone();
+
+    Array result;
+    string error;
+    while (stream->Read(&result))
+    {
+        auto product = products.find(result.name());
+        if (product == products.end())
+        {
+            error = "unexpected product '" + result.name() + "'";
+            continue;
+        }
+        product->second.AssignChunk(result, SendPrecision());
+    }
+
+    grpc::Status status = stream->Finish();
+    span.Finish(status);
+    if (!status.ok())
+    {
+        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+        {
+            throw std::runtime_error("RPC timeout after " +
+                                   std::to_string(GetRPCTimeout().count()) +
+                                   "ms: " + status.error_message());
+        }
+        throw std::runtime_error("ComputeResidualGradients RPC failed: [" +
+                                 std::to_string(status.error_code()) + "] " +
+                                 status.error_message());
+    }
+    if (!error.empty())
+        throw std::runtime_error("ComputeResidualGradients RPC failed: " + error);
+
+    return products;
+}
+
+Variables ImplicitClient::SolveLinear(const Variables &vars, const Variables &rhs)
+{
+    return SolveLinearSystem(vars, rhs, false);
+}
+
+Variables ImplicitClient::SolveAdjointLinear(const Variables &vars, const Variables &rhs)
+{
+    return SolveLinearSystem(vars, rhs, true);
+}
+
+Variables ImplicitClient::SolveLinearSystem(const Variables &vars, const Variables &rhs, bool adjoint)
+{
+    // the solution has the shapes of the outputs
+    Variables solution;
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        if (var.type() == kOutput)
+            solution[var.name()] = Variable(var);
+    }
+
+    // fall back to factorizing the residual gradients locally
+    if (!ServerSupports(kFeatureLinearSolves))
+    {
+        const Partials partials = ComputeResidualGradients(vars);
+        Variables outputs;
+        for (const auto &sol : solution)
+            outputs[sol.first] = vars.at(sol.first);
+
+        CoordinateMatrix matrix;
+        AssembleJacobian(partials, GetPartialsSparsity(), outputs, matrix, adjoint);
+
+        // missing right-hand sides are zero
+        for (auto &sol : solution)
+        {
+            if (rhs.count(sol.first) > 0)
+                sol.second = rhs.at(sol.first);
+        }
+        std::vector<double> values;
+        Flatten(solution, values);
+
+        std::unique_ptr<LinearSolver> solver;
+        if (GetPartialsSparsity().empty())
+            solver = std::make_unique<DenseLUSolver>();
+        else
+            solver = std::make_unique<SparseLUSolver>();
+        solver->Factorize(matrix);
+        solver->Solve(values);
+        Unflatten(values, solution);
+        return solution;
+    }
+
+    ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + GetRPCTimeout());
+    AddWirePrecisionMetadata(context);
+    ApplyCompression(context);
+    context.AddMetadata(kLinearSolveMetadataKey, adjoint ? kLinearSolveAdjoint : kLinearSolveForward);
+    ClientCallSpan span = TraceCall("ComputeResidualGradients", context);
+    std::unique_ptr<grpc::ClientReaderWriterInterface<Array, Array>>
+        stream(stub_->ComputeResidualGradients(&context));
+
+    // send the inputs and outputs followed by the right-hand side (marked by its subname)
+    ChunkPipeline pipeline(stream.get(), false, GetCompression());
+    for (const VariableMetaData &var : GetVariableMetaAll())
+    {
+        const string &name = var.name();
+        if (var.type() == kInput or var.type() == kOutput)
+            vars.at(name).Send(name, "", &pipeline, GetStreamOptions().num_double(), SendPrecision(name));
+    }
+    for (const auto &b : rhs)
+        b.second.Send(b.first, kLinearRhsSubname, &pipeline, GetStreamOptions().num_double(), SendPrecision());
+
+    // finish streaming data to the server
+    stream->WritesDone();
+
+    Array result;
+    string error;
+    while (stream->Read(&result))
+    {
+        auto sol = solution.find(result.name());
+        if (sol == solution.end())
+        {
+            error = "unexpected solution '" + result.name() + "'";
+            continue;
+        }
+        sol->second.AssignChunk(result, SendPrecision());
+    }
+
+    grpc::Status status = stream->Finish();
+    span.Finish(status);
+    if (!status.ok())
+    {
+        if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+        {
+            throw std::runtime_error("RPC timeout after " +
+                                   std::to_string(GetRPCTimeout().count()) +
+                                   "ms: " + status.error_message());
+        }
+        throw std::runtime_error("ComputeResidualGradients RPC failed: [" +
+                                 std::to_string(status.error_code()) + "] " +
+                                 status.error_message());
+    }
+    if (!error.empty())
+        throw std::runtime_error("ComputeResidualGradients RPC failed: " + error);
+
+    return solution;
+}
+
+void ImplicitClient::EnableResultCache(size_t max_bytes)
+{
+    residual_cache_.SetMaxBytes(max_bytes);
+    solve_cache_.SetMaxBytes(max_bytes);
+    gradient_cache_.SetMaxBytes(max_bytes);
+}
+
+philote::ResultCacheStats ImplicitClient::GetResultCacheStats() const
+{
+    ResultCacheStats stats = residual_cache_.stats();
+    stats += solve_cache_.stats();
+    stats += gradient_cache_.stats();
+    return stats;
+}
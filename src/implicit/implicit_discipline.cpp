@@ -28,9 +28,14 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
 #include <grpcpp/grpcpp.h>
 
 #include "implicit.h"
+#include "jacobian_product.h"
 
 using std::string;
 using std::vector;
@@ -52,6 +57,7 @@ ImplicitDiscipline::ImplicitDiscipline()
 
 ImplicitDiscipline::~ImplicitDiscipline() noexcept
 {
+    implicit_callback_.UnlinkPointers();
     implicit_.UnlinkPointers();
     discipline_server_.UnlinkPointers();
 }
@@ -64,10 +70,71 @@ void ImplicitDiscipline::RegisterServices(ServerBuilder &builder)
     discipline_server_.LinkPointers(shared_from_this());
     implicit_.LinkPointers(self);
 
+    ApplyMessageLimits(builder);
     builder.RegisterService(&discipline_server_);
     builder.RegisterService(&implicit_);
 }
 
+void ImplicitDiscipline::RegisterServices(ServerBuilder &builder, philote::ServerEngine engine,
+                                          size_t compute_threads, const philote::ThreadPlacement &placement)
+{
+    implicit_.SetPlacement(placement);
+
+    if (engine == philote::ServerEngine::kSynchronous)
+    {
+        RegisterServices(builder);
+        return;
+    }
+
+    // Link servers to this discipline instance using shared_from_this()
+    auto self = std::dynamic_pointer_cast<ImplicitDiscipline>(shared_from_this());
+    discipline_server_.LinkPointers(shared_from_this());
+    implicit_.LinkPointers(self);
+    implicit_callback_.LinkPointers(&implicit_, compute_threads);
+
+    // the callback server runs the compute RPCs with the logic of implicit_
+    ApplyMessageLimits(builder);
+    builder.RegisterService(&discipline_server_);
+    builder.RegisterService(&implicit_callback_);
+}
+
+void ImplicitDiscipline::EnableInstancePool(philote::InstancePool<ImplicitDiscipline>::Factory factory,
+                                            size_t size)
+{
+    implicit_.SetInstancePool(
+        std::make_shared<philote::InstancePool<ImplicitDiscipline>>(std::move(factory), size));
+}
+
+std::shared_ptr<Server> ImplicitDiscipline::ServeUnixSocket(const std::string &path, philote::ServerEngine engine,
+                                                          size_t compute_threads)
+{
+    ServerBuilder builder;
+    builder.AddListeningPort(philote::UnixSocketAddress(path), grpc::InsecureServerCredentials());
+    RegisterServices(builder, engine, compute_threads);
+
+    return philote::StartDisciplineServer(builder, shared_from_this());
+}
+
+std::unique_ptr<philote::ImplicitClient> ImplicitDiscipline::ServeInProcess(philote::ServerEngine engine,
+                                                                       size_t compute_threads)
+{
+    ServerBuilder builder;
+    RegisterServices(builder, engine, compute_threads);
+    std::shared_ptr<Server> server = philote::StartDisciplineServer(builder, shared_from_this());
+
+    auto client = std::make_unique<philote::ImplicitClient>();
+    client->SetMaxMessageBytes(max_message_bytes());
+    client->ConnectChannel(philote::CreateInProcessChannel(*server, max_message_bytes()));
+    client->OwnServer(server);
+
+    client->GetInfo();
+    client->Setup();
+    client->GetVariableDefinitions();
+    client->GetPartialDefinitions();
+
+    return client;
+}
+
 void ImplicitDiscipline::DeclarePartials(const string &f, const string &x)
 {
     // Compute the shape using the base class helper method
@@ -84,19 +151,177 @@ void ImplicitDiscipline::DeclarePartials(const string &f, const string &x)
     partials_meta_.push_back(meta);
 }
 
+void ImplicitDiscipline::DeclarePartials(const string &f, const string &x,
+                                         const vector<int64_t> &rows,
+                                         const vector<int64_t> &cols)
+{
+    // x may be an input or an output for implicit disciplines
+    DeclareSparsePartials(f, x, rows, cols, true);
+}
+
+namespace
+{
+    //! Allocates the partials declared by a discipline
+    Partials AllocatePartials(const vector<philote::PartialsMetaData> &partials_meta)
+    {
+        Partials partials;
+        for (const philote::PartialsMetaData &par : partials_meta)
+        {
+            vector<size_t> shape(par.shape().begin(), par.shape().end());
+            partials[std::make_pair(par.name(), par.subname())] = philote::Variable(philote::kOutput, shape);
+        }
+        return partials;
+    }
+}
+
 void ImplicitDiscipline::ComputeResiduals(const Variables &inputs,
                                           const philote::Variables &outputs,
                                           philote::Variables &residuals)
 {
 }
 
+void ImplicitDiscipline::ComputeResidualsFlat(const philote::FlatVariables &inputs,
+                                              const philote::FlatVariables &outputs,
+                                              philote::FlatVariables &residuals)
+{
+    ComputeResiduals(inputs.map(), outputs.map(), residuals.map());
+}
+
 void ImplicitDiscipline::SolveResiduals(const Variables &inputs,
                                         philote::Variables &outputs)
 {
+    SolveNewton(inputs, outputs);
+}
+
+size_t ImplicitDiscipline::SolveNewton(const Variables &inputs, Variables &outputs)
+{
+    std::lock_guard<std::mutex> lock(newton_mutex_);
+
+    // preallocated once per solve and reused by every iteration
+    Variables residuals = outputs;
+    for (auto &res : residuals)
+        res.second.Fill(0.0);
+    Partials partials = AllocatePartials(partials_meta());
+    if (!outputs.empty() and
+        std::none_of(partials.begin(), partials.end(), [&outputs](const auto &par)
+                     { return outputs.count(par.first.first) > 0 and outputs.count(par.first.second) > 0; }))
+        throw std::logic_error("SolveResiduals is not implemented and no partials of the residuals "
+                               "with respect to the outputs are declared");
+
+    // the unknowns (and residuals) are the outputs in the layout of Flatten
+    auto residual = [&](const vector<double> &y, vector<double> &r)
+    {
+        if (IsCancelled())
+            throw std::runtime_error("Solve cancelled");
+
+        philote::Unflatten(y, outputs);
+        ComputeResiduals(inputs, outputs, residuals);
+        philote::Flatten(residuals, r);
+    };
+
+    // only the partials with respect to the outputs enter the Newton step
+    auto jacobian = [&](const vector<double> &y, philote::CoordinateMatrix &matrix)
+    {
+        philote::Unflatten(y, outputs);
+        ComputeResidualGradients(inputs, outputs, partials);
+        philote::AssembleJacobian(partials, partials_sparsity(), outputs, matrix);
+    };
+
+    vector<double> y;
+    philote::Flatten(outputs, y);
+    const size_t iterations = newton_.Solve(newton_options_, y, residual, jacobian);
+    philote::Unflatten(y, outputs);
+
+    return iterations;
+}
+
+void ImplicitDiscipline::SolveLinear(const Variables &inputs,
+                                     const Variables &outputs,
+                                     const Variables &rhs,
+                                     Variables &solution)
+{
+    SolveLinearSystem(inputs, outputs, rhs, solution, false);
+}
+
+void ImplicitDiscipline::SolveAdjointLinear(const Variables &inputs,
+                                            const Variables &outputs,
+                                            const Variables &rhs,
+                                            Variables &solution)
+{
+    SolveLinearSystem(inputs, outputs, rhs, solution, true);
+}
+
+void ImplicitDiscipline::SolveLinearSystem(const Variables &inputs, const Variables &outputs,
+                                           const Variables &rhs, Variables &solution, bool adjoint)
+{
+    Partials partials = AllocatePartials(partials_meta());
+    ComputeResidualGradients(inputs, outputs, partials);
+
+    philote::CoordinateMatrix matrix;
+    if (philote::AssembleJacobian(partials, partials_sparsity(), outputs, matrix, adjoint) == 0 and !outputs.empty())
+        throw std::logic_error("No partials of the residuals with respect to the outputs are declared");
+
+    // missing right-hand sides are zero
+    for (auto &var : solution)
+    {
+        auto b = rhs.find(var.first);
+        if (b == rhs.end())
+        {
+            var.second.Fill(0.0);
+            continue;
+        }
+        if (b->second.Size() != var.second.Size())
+            throw std::length_error("Right-hand side " + var.first + " does not match the size of the variable");
+        std::copy_n(b->second.data(), b->second.Size(), var.second.data());
+    }
+
+    vector<double> values;
+    philote::Flatten(solution, values);
+
+    std::unique_ptr<philote::LinearSolver> solver;
+    {
+        std::lock_guard<std::mutex> lock(newton_mutex_);
+        solver = philote::CreateLinearSolver(newton_options_);
+    }
+    solver->Factorize(matrix);
+    solver->Solve(values);
+    philote::Unflatten(values, solution);
+}
+
+void ImplicitDiscipline::SetNewtonOptions(const philote::NewtonOptions &options)
+{
+    std::lock_guard<std::mutex> lock(newton_mutex_);
+    newton_options_ = options;
+}
+
+void ImplicitDiscipline::SolveResidualsFlat(const philote::FlatVariables &inputs,
+                                            philote::FlatVariables &outputs)
+{
+    SolveResiduals(inputs.map(), outputs.map());
 }
 
 void ImplicitDiscipline::ComputeResidualGradients(const Variables &inputs,
                                                   const philote::Variables &outputs,
                                                   Partials &partials)
 {
-}
\ No newline at end of file
+}
+
+void ImplicitDiscipline::ComputeJacVec(const Variables &inputs,
+                                       const Variables &outputs,
+                                       const Variables &seeds,
+                                       Variables &products)
+{
+    Partials partials = AllocatePartials(partials_meta());
+    ComputeResidualGradients(inputs, outputs, partials);
+    philote::MultiplyJacobian(partials, partials_sparsity(), seeds, products);
+}
+
+void ImplicitDiscipline::ComputeVecJac(const Variables &inputs,
+                                       const Variables &outputs,
+                                       const Variables &seeds,
+                                       Variables &products)
+{
+    Partials partials = AllocatePartials(partials_meta());
+    ComputeResidualGradients(inputs, outputs, partials);
+    philote::MultiplyJacobianTranspose(partials, partials_sparsity(), seeds, products);
+}
@@ -28,6 +28,8 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <stdexcept>
+
 #include "implicit.h"
 
 using std::string;
@@ -39,9 +41,12 @@ using grpc::Server;
 using grpc::ServerBuilder;
 using grpc::ServerContext;
 using grpc::ServerReaderWriter;
+using grpc::ServerReaderWriterInterface;
 using grpc::ServerWriter;
 using grpc::Status;
 
+using philote::Array;
+using philote::ImplicitCallbackServer;
 using philote::ImplicitServer;
 using philote::Partials;
 using philote::Variables;
@@ -61,23 +66,219 @@ void ImplicitServer::UnlinkPointers()
     implementation_.reset();
 }
 
+void ImplicitServer::SetInstancePool(std::shared_ptr<philote::InstancePool<philote::ImplicitDiscipline>> pool)
+{
+    pool_ = pool;
+}
+
+void ImplicitServer::SetPlacement(const philote::ThreadPlacement &placement)
+{
+    if (!pool_)
+    {
+        if (placement.policy != philote::PlacementPolicy::kNone)
+            throw std::invalid_argument("Placing discipline instances requires an instance pool");
+        return;
+    }
+
+    pool_->SetPlacement(philote::PlacementSlots(placement));
+}
+
+philote::MetricsRecorder *ImplicitServer::metrics_recorder() const noexcept
+{
+    return implementation_ ? implementation_->metrics_recorder() : nullptr;
+}
+
+philote::Tracer *ImplicitServer::tracer() const noexcept
+{
+    return implementation_ ? implementation_->tracer() : nullptr;
+}
+
+philote::AdmissionController *ImplicitServer::admission_controller() const noexcept
+{
+    return implementation_ ? implementation_->admission_controller() : nullptr;
+}
+
+grpc::Status ImplicitServer::AcquireInstance(grpc::ServerContextBase *context,
+                                        philote::InstancePool<philote::ImplicitDiscipline>::Lease &lease)
+{
+    if (!pool_)
+    {
+        lease = philote::InstancePool<philote::ImplicitDiscipline>::Lease(implementation_);
+        return grpc::Status::OK;
+    }
+
+    try
+    {
+        if (!context)
+        {
+            lease = pool_->Acquire(*implementation_);
+            return grpc::Status::OK;
+        }
+
+        // a call must not wait for an instance after it has ended
+        philote::CancellationMonitor &monitor = philote::CancellationMonitor::Instance();
+        philote::CancellationToken cancellation = monitor.Watch(context);
+        try
+        {
+            lease = pool_->Acquire(*implementation_, context->deadline(), cancellation);
+        }
+        catch (...)
+        {
+            monitor.Unwatch(context);
+            throw;
+        }
+        monitor.Unwatch(context);
+
+        if (!lease)
+        {
+            if (cancellation.IsCancelled())
+                return grpc::Status(grpc::StatusCode::CANCELLED,
+                                    "Request cancelled while waiting for a discipline instance");
+            return grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED,
+                                "Deadline exceeded while waiting for a discipline instance");
+        }
+    }
+    catch (const std::exception &e)
+    {
+        return grpc::Status(grpc::StatusCode::INTERNAL,
+                            "Failed to acquire discipline instance: " + std::string(e.what()));
+    }
+
+    return grpc::Status::OK;
+}
+
 grpc::Status ImplicitServer::ComputeResiduals(grpc::ServerContext *context,
                                               grpc::ServerReaderWriter<::philote::Array,
                                                                        ::philote::Array> *stream)
 {
-    return ComputeResidualsImpl(context, stream);
+    return philote::CompressCall(context, stream, [this, context](auto *compressed)
+    {
+        return philote::ServeEvaluations(context, compressed, [this, context](auto *evaluation)
+        {
+            return philote::AdmitCall(admission_controller(), context, evaluation, [this, context](auto *admitted)
+            {
+                return philote::ObserveCall(metrics_recorder(), tracer(), context, "ComputeResiduals", admitted,
+                                            [this, context](auto *metered)
+                                            { return ComputeResidualsImpl(context, metered); });
+            });
+        });
+    });
 }
 
 grpc::Status ImplicitServer::SolveResiduals(grpc::ServerContext *context,
                                             grpc::ServerReaderWriter<::philote::Array,
                                                                      ::philote::Array> *stream)
 {
-    return SolveResidualsImpl(context, stream);
+    return philote::CompressCall(context, stream, [this, context](auto *compressed)
+    {
+        return philote::ServeEvaluations(context, compressed, [this, context](auto *evaluation)
+        {
+            return philote::AdmitCall(admission_controller(), context, evaluation, [this, context](auto *admitted)
+            {
+                return philote::ObserveCall(metrics_recorder(), tracer(), context, "SolveResiduals", admitted,
+                                            [this, context](auto *metered)
+                                            { return SolveResidualsImpl(context, metered); });
+            });
+        });
+    });
 }
 
 grpc::Status ImplicitServer::ComputeResidualGradients(grpc::ServerContext *context,
                                                       grpc::ServerReaderWriter<::philote::Array,
                                                                                ::philote::Array> *stream)
 {
-    return ComputeResidualGradientsImpl(context, stream);
-}
\ No newline at end of file
+    return philote::CompressCall(context, stream, [this, context](auto *compressed)
+    {
+        return philote::ServeEvaluations(context, compressed, [this, context](auto *evaluation)
+        {
+            return philote::AdmitCall(admission_controller(), context, evaluation, [this, context](auto *admitted)
+            {
+                return philote::ObserveCall(metrics_recorder(), tracer(), context, "ComputeResidualGradients", admitted,
+                                            [this, context](auto *metered)
+                                            { return ComputeResidualGradientsImpl(context, metered); });
+            });
+        });
+    });
+}
+ImplicitCallbackServer::~ImplicitCallbackServer() noexcept
+{
+    UnlinkPointers();
+}
+
+void ImplicitCallbackServer::LinkPointers(philote::ImplicitServer *server, size_t threads)
+{
+    server_ = server;
+    if (!executor_)
+        executor_ = std::make_unique<philote::ThreadPool>(threads);
+}
+
+void ImplicitCallbackServer::UnlinkPointers()
+{
+    server_ = nullptr;
+}
+
+grpc::ServerBidiReactor<Array, Array> *ImplicitCallbackServer::ComputeResiduals(grpc::CallbackServerContext *context)
+{
+    if (!server_ or !executor_)
+        return philote::RejectArrayStream(Status(grpc::StatusCode::FAILED_PRECONDITION,
+                                                 "Implicit server not linked"));
+
+    ImplicitServer *server = server_;
+    return new philote::ArrayStreamReactor(
+        *executor_,
+        [server, context](ServerReaderWriterInterface<Array, Array> *stream)
+        {
+            return philote::CompressCall(context, stream, [server, context](auto *compressed)
+            {
+                return philote::ObserveCall(server->metrics_recorder(), server->tracer(), context,
+                                            "ComputeResiduals", compressed,
+                                            [server, context](ServerReaderWriterInterface<Array, Array> *metered)
+                                            { return server->ComputeResidualsImpl(context, metered); });
+            });
+        },
+        philote::RequestsEvaluationStream(context), context, server->admission_controller());
+}
+
+grpc::ServerBidiReactor<Array, Array> *ImplicitCallbackServer::SolveResiduals(grpc::CallbackServerContext *context)
+{
+    if (!server_ or !executor_)
+        return philote::RejectArrayStream(Status(grpc::StatusCode::FAILED_PRECONDITION,
+                                                 "Implicit server not linked"));
+
+    ImplicitServer *server = server_;
+    return new philote::ArrayStreamReactor(
+        *executor_,
+        [server, context](ServerReaderWriterInterface<Array, Array> *stream)
+        {
+            return philote::CompressCall(context, stream, [server, context](auto *compressed)
+            {
+                return philote::ObserveCall(server->metrics_recorder(), server->tracer(), context,
+                                            "SolveResiduals", compressed,
+                                            [server, context](ServerReaderWriterInterface<Array, Array> *metered)
+                                            { return server->SolveResidualsImpl(context, metered); });
+            });
+        },
+        philote::RequestsEvaluationStream(context), context, server->admission_controller());
+}
+
+grpc::ServerBidiReactor<Array, Array> *ImplicitCallbackServer::ComputeResidualGradients(grpc::CallbackServerContext *context)
+{
+    if (!server_ or !executor_)
+        return philote::RejectArrayStream(Status(grpc::StatusCode::FAILED_PRECONDITION,
+                                                 "Implicit server not linked"));
+
+    ImplicitServer *server = server_;
+    return new philote::ArrayStreamReactor(
+        *executor_,
+        [server, context](ServerReaderWriterInterface<Array, Array> *stream)
+        {
+            return philote::CompressCall(context, stream, [server, context](auto *compressed)
+            {
+                return philote::ObserveCall(server->metrics_recorder(), server->tracer(), context,
+                                            "ComputeResidualGradients", compressed,
+                                            [server, context](ServerReaderWriterInterface<Array, Array> *metered)
+                                            { return server->ComputeResidualGradientsImpl(context, metered); });
+            });
+        },
+        philote::RequestsEvaluationStream(context), context, server->admission_controller());
+}
@@ -0,0 +1,372 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "admission.h"
+#include "protocol_extensions.h"
+
+using grpc::Status;
+
+using philote::AdmissionController;
+using philote::AdmissionLimits;
+using philote::AdmittedArrayStream;
+using philote::Array;
+
+AdmissionController::Ticket::Ticket(Ticket &&other) noexcept
+{
+    MoveFrom(other);
+}
+
+AdmissionController::Ticket &AdmissionController::Ticket::operator=(Ticket &&other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        MoveFrom(other);
+    }
+
+    return *this;
+}
+
+void AdmissionController::Ticket::MoveFrom(Ticket &other) noexcept
+{
+    controller_ = other.controller_;
+    bytes_ = other.bytes_;
+    received_ = other.received_;
+    running_ = false;
+    waiting_ = false;
+
+    if (controller_ != nullptr)
+    {
+        // the queue of waiting tickets refers to the ticket by its address
+        std::lock_guard<std::mutex> lock(controller_->mutex_);
+        running_ = other.running_;
+        waiting_ = other.waiting_;
+        for (auto &entry : controller_->waiting_)
+        {
+            if (entry.first == &other)
+                entry.first = this;
+        }
+    }
+
+    other.controller_ = nullptr;
+    other.waiting_ = false;
+}
+
+bool AdmissionController::Ticket::Start(const grpc::ServerContextBase *context)
+{
+    if (controller_ == nullptr or running_)
+        return true;
+
+    std::unique_lock<std::mutex> lock(controller_->mutex_);
+    while (controller_->limits_.max_concurrent > 0 and
+           controller_->running_ >= controller_->limits_.max_concurrent)
+    {
+        // abandoned calls leave the queue
+        if (context and context->IsCancelled())
+            return false;
+        controller_->released_.wait_for(lock, std::chrono::milliseconds(10));
+    }
+
+    controller_->queued_--;
+    controller_->running_++;
+    running_ = true;
+
+    return true;
+}
+
+bool AdmissionController::Ticket::TryStart(std::function<void()> ready)
+{
+    if (controller_ == nullptr)
+        return true;
+
+    std::lock_guard<std::mutex> lock(controller_->mutex_);
+    if (running_)
+        return true;
+
+    // calls waiting already are served first
+    const size_t limit = controller_->limits_.max_concurrent;
+    if ((limit == 0 or controller_->running_ < limit) and controller_->waiting_.empty())
+    {
+        controller_->queued_--;
+        controller_->running_++;
+        running_ = true;
+        return true;
+    }
+
+    if (!waiting_)
+    {
+        controller_->waiting_.emplace_back(this, std::move(ready));
+        waiting_ = true;
+    }
+
+    return false;
+}
+
+bool AdmissionController::Ticket::CancelStart() noexcept
+{
+    if (controller_ == nullptr)
+        return false;
+
+    std::lock_guard<std::mutex> lock(controller_->mutex_);
+    if (!waiting_)
+        return false;
+
+    auto &waiting = controller_->waiting_;
+    waiting.erase(std::find_if(waiting.begin(), waiting.end(), [this](const auto &entry)
+                               { return entry.first == this; }));
+    waiting_ = false;
+
+    return true;
+}
+
+bool AdmissionController::Ticket::Reserve(size_t bytes) noexcept
+{
+    if (controller_ == nullptr)
+        return true;
+
+    // the declared input size is counted already, but not trusted beyond
+    received_ += bytes;
+    if (received_ <= bytes_)
+        return true;
+    const size_t extra = received_ - bytes_;
+
+    std::lock_guard<std::mutex> lock(controller_->mutex_);
+    const size_t limit = controller_->limits_.max_buffered_bytes;
+    const bool others = controller_->bytes_ > bytes_;
+    if (limit > 0 and others and controller_->bytes_ + extra > limit)
+    {
+        // rejected messages are not counted
+        received_ -= bytes;
+        return false;
+    }
+
+    controller_->bytes_ += extra;
+    bytes_ += extra;
+
+    return true;
+}
+
+void AdmissionController::Ticket::Release() noexcept
+{
+    if (controller_ == nullptr)
+        return;
+
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(controller_->mutex_);
+        if (waiting_)
+        {
+            auto &waiting = controller_->waiting_;
+            waiting.erase(std::find_if(waiting.begin(), waiting.end(), [this](const auto &entry)
+                                       { return entry.first == this; }));
+            waiting_ = false;
+        }
+
+        if (running_)
+        {
+            controller_->running_--;
+            ready = controller_->HandOver();
+        }
+        else
+            controller_->queued_--;
+        controller_->bytes_ -= bytes_;
+    }
+    controller_->released_.notify_all();
+
+    controller_ = nullptr;
+    bytes_ = 0;
+    running_ = false;
+    received_ = 0;
+
+    for (auto &callback : ready)
+        callback();
+}
+
+void AdmissionController::SetLimits(const AdmissionLimits &limits)
+{
+    if (limits.retry_after.count() <= 0)
+        throw std::invalid_argument("The retry-after hint must be positive.");
+
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        limits_ = limits;
+        ready = HandOver();
+    }
+    released_.notify_all();
+
+    for (auto &callback : ready)
+        callback();
+}
+
+AdmissionLimits AdmissionController::limits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limits_;
+}
+
+grpc::Status AdmissionController::Admit(grpc::ServerContextBase *context, Ticket &ticket)
+{
+    ticket.Release();
+
+    // the declared input size is reserved up front
+    size_t declared = 0;
+    if (!ParseIndex(FindClientMetadata(context, kInputBytesMetadataKey),
+                    std::numeric_limits<size_t>::max(), declared))
+        declared = 0;
+
+    std::string reason;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t capacity = limits_.max_concurrent + limits_.max_queued;
+        if (limits_.max_concurrent > 0 and running_ + queued_ >= capacity)
+            reason = "concurrent evaluations";
+        else if (limits_.max_buffered_bytes > 0 and bytes_ > 0 and bytes_ + declared > limits_.max_buffered_bytes)
+            reason = "buffered input bytes";
+        else
+        {
+            queued_++;
+            bytes_ += declared;
+
+            ticket.controller_ = this;
+            ticket.bytes_ = declared;
+            return Status::OK;
+        }
+    }
+
+    return Reject(context, reason);
+}
+
+grpc::Status AdmissionController::Reject(grpc::ServerContextBase *context, const std::string &reason)
+{
+    std::chrono::milliseconds retry_after;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rejected_++;
+        retry_after = limits_.retry_after;
+    }
+
+    const std::string hint = std::to_string(retry_after.count());
+    if (context)
+        context->AddTrailingMetadata(kRetryAfterMetadataKey, hint);
+
+    return Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                  "Server overloaded (" + reason + "); retry after " + hint + " ms");
+}
+
+std::vector<std::function<void()>> AdmissionController::HandOver()
+{
+    std::vector<std::function<void()>> ready;
+    while (!waiting_.empty() and (limits_.max_concurrent == 0 or running_ < limits_.max_concurrent))
+    {
+        Ticket *ticket = waiting_.front().first;
+        ready.push_back(std::move(waiting_.front().second));
+        waiting_.pop_front();
+
+        ticket->waiting_ = false;
+        ticket->running_ = true;
+        queued_--;
+        running_++;
+    }
+
+    return ready;
+}
+
+size_t AdmissionController::running() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+size_t AdmissionController::queued() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_;
+}
+
+size_t AdmissionController::buffered_bytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+uint64_t AdmissionController::rejected() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rejected_;
+}
+
+AdmittedArrayStream::AdmittedArrayStream(grpc::ServerReaderWriterInterface<Array, Array> *stream,
+                                         AdmissionController::Ticket &ticket, grpc::ServerContextBase *context)
+    : stream_(stream), ticket_(ticket), context_(context)
+{
+}
+
+void AdmittedArrayStream::SendInitialMetadata()
+{
+    stream_->SendInitialMetadata();
+}
+
+bool AdmittedArrayStream::Write(const Array &msg, grpc::WriteOptions options)
+{
+    // results computed from incomplete inputs are not sent
+    if (exceeded_)
+        return false;
+
+    return stream_->Write(msg, options);
+}
+
+bool AdmittedArrayStream::NextMessageSize(uint32_t *sz)
+{
+    return stream_->NextMessageSize(sz);
+}
+
+bool AdmittedArrayStream::Read(Array *msg)
+{
+    if (exceeded_ or !stream_->Read(msg))
+        return false;
+
+    if (!ticket_.Reserve(msg->ByteSizeLong()))
+    {
+        // the call must not compute with incomplete inputs; the RPC itself
+        // is not cancelled, so that the client receives the rejection
+        exceeded_ = true;
+        if (context_)
+            CancellationMonitor::Instance().Cancel(context_);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,146 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <stdexcept>
+
+#include "async_call.h"
+
+using grpc::Status;
+
+using philote::Array;
+using philote::AsyncArrayCall;
+
+using std::vector;
+
+AsyncArrayCall::AsyncArrayCall(vector<Array> messages,
+                               MessageHandler on_message,
+                               DoneHandler on_done)
+    : messages_(std::move(messages)),
+      on_message_(std::move(on_message)),
+      on_done_(std::move(on_done))
+{
+}
+
+grpc::ClientContext &AsyncArrayCall::context()
+{
+    return context_;
+}
+
+void AsyncArrayCall::SetCompression(const CompressionPolicy &policy)
+{
+    compression_ = policy;
+}
+
+void AsyncArrayCall::Begin(const StartFunction &start)
+{
+    start(&context_, this);
+
+    // queue the first read and write before the call is started
+    StartRead(&incoming_);
+    WriteNext();
+    StartCall();
+}
+
+void AsyncArrayCall::WriteNext()
+{
+    if (next_ < messages_.size())
+    {
+        const Array &message = messages_[next_++];
+        StartWrite(&message, compression_.WriteOptionsFor(message));
+    }
+    else
+        StartWritesDone();
+}
+
+void AsyncArrayCall::OnWriteDone(bool ok)
+{
+    // the stream is broken; OnDone will report the status
+    if (!ok)
+        return;
+
+    WriteNext();
+}
+
+void AsyncArrayCall::OnReadDone(bool ok)
+{
+    if (!ok)
+        return;
+
+    if (!error_)
+    {
+        try
+        {
+            on_message_(incoming_);
+        }
+        catch (...)
+        {
+            error_ = std::current_exception();
+            context_.TryCancel();
+        }
+    }
+
+    StartRead(&incoming_);
+}
+
+void AsyncArrayCall::OnDone(const Status &status)
+{
+    // release the call before reporting its completion, so the caller may
+    // destroy the client as soon as the handler has run
+    DoneHandler on_done = std::move(on_done_);
+    std::exception_ptr error = error_;
+    const Status final_status = status;
+    delete this;
+
+    try
+    {
+        on_done(final_status, error);
+    }
+    catch (...)
+    {
+        // exceptions cannot be propagated from a gRPC library thread
+    }
+}
+
+std::exception_ptr philote::MakeRPCError(const std::string &rpc,
+                                         const grpc::Status &status,
+                                         std::chrono::milliseconds timeout)
+{
+    if (status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED)
+    {
+        return std::make_exception_ptr(
+            std::runtime_error("RPC timeout after " +
+                               std::to_string(timeout.count()) +
+                               "ms: " + status.error_message()));
+    }
+    return std::make_exception_ptr(
+        std::runtime_error(rpc + " RPC failed: [" +
+                           std::to_string(status.error_code()) + "] " +
+                           status.error_message()));
+}
@@ -0,0 +1,455 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <limits>
+
+#include "callback_server.h"
+#include "cancellation.h"
+#include "evaluation_stream.h"
+
+using grpc::Status;
+
+using philote::Array;
+using philote::ArrayStreamReactor;
+using philote::BufferedArrayStream;
+
+void BufferedArrayStream::Push(Array &&message)
+{
+    received_.push_back(std::move(message));
+}
+
+bool BufferedArrayStream::empty() const noexcept
+{
+    return received_.empty();
+}
+
+void BufferedArrayStream::Clear() noexcept
+{
+    received_.clear();
+    next_ = 0;
+    written_.clear();
+    write_options_.clear();
+}
+
+std::vector<Array> &BufferedArrayStream::written() noexcept
+{
+    return written_;
+}
+
+const std::vector<grpc::WriteOptions> &BufferedArrayStream::write_options() const noexcept
+{
+    return write_options_;
+}
+
+void BufferedArrayStream::SendInitialMetadata()
+{
+    // initial metadata is sent by the reactor
+}
+
+bool BufferedArrayStream::Write(const Array &msg, grpc::WriteOptions options)
+{
+    written_.push_back(msg);
+    write_options_.push_back(options);
+    return true;
+}
+
+bool BufferedArrayStream::NextMessageSize(uint32_t *sz)
+{
+    if (next_ >= received_.size())
+        return false;
+
+    *sz = static_cast<uint32_t>(received_[next_].ByteSizeLong());
+    return true;
+}
+
+bool BufferedArrayStream::Read(Array *msg)
+{
+    if (next_ >= received_.size())
+        return false;
+
+    msg->Swap(&received_[next_++]);
+    return true;
+}
+
+ArrayStreamReactor::ArrayStreamReactor(ThreadPool &executor, Handler handler, bool evaluations,
+                                       grpc::ServerContextBase *context, AdmissionController *admission)
+    : executor_(executor), handler_(std::move(handler)), evaluations_(evaluations), context_(context),
+      admission_(admission)
+{
+    if (admission_ != nullptr)
+    {
+        Status status = admission_->Admit(context_, ticket_);
+        if (!status.ok())
+        {
+            finished_ = true;
+            Finish(status);
+            return;
+        }
+    }
+
+    reading_ = true;
+    StartRead(&incoming_);
+}
+
+void ArrayStreamReactor::OnReadDone(bool ok)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    reading_ = false;
+
+    if (failed_)
+    {
+        Advance();
+        return;
+    }
+
+    if (!ok)
+    {
+        // the client finished writing (or the RPC was cancelled, which
+        // OnCancel handles). Calls without inputs still run the handler,
+        // while an evaluation stream closed between evaluations is finished
+        // by Advance.
+        inputs_done_ = true;
+        evaluation_id_ = 0;
+        if (!evaluations_ or !received_.empty())
+            Start();
+
+        Advance();
+        return;
+    }
+
+    // the next evaluation of an evaluation stream is admitted with its
+    // first message
+    if (admission_ != nullptr and !ticket_)
+    {
+        Status status = admission_->Admit(context_, ticket_);
+        if (!status.ok())
+        {
+            Fail(status);
+            Advance();
+            return;
+        }
+    }
+
+    // the handler has not started, so there is nothing to cancel
+    if (!ticket_.Reserve(incoming_.ByteSizeLong()))
+    {
+        Fail(admission_->Reject(context_, "buffered input bytes"));
+        Advance();
+        return;
+    }
+
+    if (evaluations_ and IsEndOfEvaluation(incoming_))
+    {
+        // the inputs of the evaluation are complete; the next evaluation is
+        // read once the results are written
+        evaluation_id_ = static_cast<uint64_t>(incoming_.end());
+        inputs_done_ = true;
+        incoming_.Clear();
+        Start();
+        Advance();
+        return;
+    }
+
+    received_.push_back(std::move(incoming_));
+    incoming_.Clear();
+
+    reading_ = true;
+    StartRead(&incoming_);
+}
+
+void ArrayStreamReactor::Start()
+{
+    // called on the thread releasing a slot, so it only queues Resume
+    auto resume = [this]
+    {
+        try
+        {
+            executor_.Submit([this]
+                             { Resume(); });
+        }
+        catch (...)
+        {
+            // the pool only stops once the server and its calls are gone
+        }
+    };
+
+    // without a free slot, the evaluation waits without occupying a thread
+    if (!ticket_.TryStart(resume))
+    {
+        waiting_ = true;
+        return;
+    }
+
+    Schedule();
+}
+
+void ArrayStreamReactor::Schedule()
+{
+    running_ = true;
+
+    try
+    {
+        executor_.Submit([this]
+                         { Run(); });
+    }
+    catch (const std::exception &e)
+    {
+        running_ = false;
+        Fail(Status(grpc::StatusCode::UNAVAILABLE,
+                    "Failed to schedule the evaluation: " + std::string(e.what())));
+    }
+}
+
+void ArrayStreamReactor::Resume()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        waiting_ = false;
+
+        if (failed_)
+        {
+            Advance();
+            return;
+        }
+
+        running_ = true;
+    }
+
+    // already on the compute thread pool
+    Run();
+}
+
+void ArrayStreamReactor::Run()
+{
+    Status status;
+    try
+    {
+        Stream stream(*this);
+        status = handler_(&stream);
+    }
+    catch (const std::exception &e)
+    {
+        status = Status(grpc::StatusCode::INTERNAL,
+                        "Unhandled exception: " + std::string(e.what()));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // the compute slot and the inputs are no longer needed
+    ticket_.Release();
+    received_.clear();
+    running_ = false;
+    served_ = true;
+
+    if (!status.ok())
+        Fail(status);
+
+    Advance();
+}
+
+bool ArrayStreamReactor::ReadInput(Array *msg)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failed_ or received_.empty())
+        return false;
+
+    msg->Swap(&received_.front());
+    received_.pop_front();
+
+    return true;
+}
+
+bool ArrayStreamReactor::WriteOutput(const Array &msg, grpc::WriteOptions options)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failed_)
+        return false;
+
+    outgoing_.emplace_back(msg, options);
+    Advance();
+
+    return true;
+}
+
+void ArrayStreamReactor::Fail(const Status &status)
+{
+    if (!failed_)
+    {
+        failed_ = true;
+        error_ = status;
+    }
+
+    outgoing_.clear();
+}
+
+void ArrayStreamReactor::Advance()
+{
+    if (finished_)
+        return;
+
+    // a failed evaluation no longer waits for a compute slot, unless one
+    // was handed to it already (then Resume finishes the RPC)
+    if (failed_ and waiting_ and ticket_.CancelStart())
+        waiting_ = false;
+
+    if (!failed_ and served_ and evaluation_id_ != 0 and !ended_)
+    {
+        outgoing_.emplace_back(EndOfEvaluation(evaluation_id_), grpc::WriteOptions());
+        ended_ = true;
+    }
+
+    if (!failed_ and !writing_ and !outgoing_.empty())
+    {
+        writing_message_ = std::move(outgoing_.front().first);
+        const grpc::WriteOptions options = outgoing_.front().second;
+        outgoing_.pop_front();
+
+        writing_ = true;
+        StartWrite(&writing_message_, options);
+        return;
+    }
+
+    // the handler and the slot callback must be done before the RPC (and
+    // the reactor) ends
+    if (writing_ or running_ or waiting_)
+        return;
+
+    if (failed_)
+    {
+        ticket_.Release();
+        finished_ = true;
+        Finish(error_);
+        return;
+    }
+
+    if (!served_)
+    {
+        // the client closed an evaluation stream between evaluations
+        if (inputs_done_)
+        {
+            finished_ = true;
+            Finish(Status::OK);
+        }
+        return;
+    }
+
+    if (evaluation_id_ != 0)
+    {
+        // read the next evaluation
+        inputs_done_ = false;
+        served_ = false;
+        ended_ = false;
+        evaluation_id_ = 0;
+
+        reading_ = true;
+        StartRead(&incoming_);
+        return;
+    }
+
+    finished_ = true;
+    Finish(Status::OK);
+}
+
+void ArrayStreamReactor::OnWriteDone(bool ok)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    writing_ = false;
+
+    if (!ok)
+        Fail(Status(grpc::StatusCode::CANCELLED, "Failed to write the response"));
+
+    Advance();
+}
+
+void ArrayStreamReactor::OnCancel()
+{
+    // stops a running evaluation without waiting for the monitor thread
+    if (context_)
+        philote::CancellationMonitor::Instance().Cancel(context_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Fail(Status(grpc::StatusCode::CANCELLED, "Request cancelled"));
+    Advance();
+}
+
+void ArrayStreamReactor::OnDone()
+{
+    // the thread that called Finish may still hold the lock
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+
+    delete this;
+}
+
+void ArrayStreamReactor::Stream::SendInitialMetadata()
+{
+    // initial metadata is sent by the reactor
+}
+
+bool ArrayStreamReactor::Stream::Write(const Array &msg, grpc::WriteOptions options)
+{
+    return reactor_.WriteOutput(msg, options);
+}
+
+bool ArrayStreamReactor::Stream::NextMessageSize(uint32_t *sz)
+{
+    // messages are limited by the server's maximum receive size
+    *sz = std::numeric_limits<uint32_t>::max();
+    return true;
+}
+
+bool ArrayStreamReactor::Stream::Read(Array *msg)
+{
+    return reactor_.ReadInput(msg);
+}
+
+namespace
+{
+    //! Reactor finishing the RPC without reading or writing any messages
+    class RejectedArrayStream : public grpc::ServerBidiReactor<Array, Array>
+    {
+    public:
+        explicit RejectedArrayStream(const Status &status)
+        {
+            Finish(status);
+        }
+
+        void OnDone() override
+        {
+            delete this;
+        }
+    };
+}
+
+grpc::ServerBidiReactor<Array, Array> *philote::RejectArrayStream(const grpc::Status &status)
+{
+    return new RejectedArrayStream(status);
+}
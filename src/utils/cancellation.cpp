@@ -0,0 +1,135 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <stdexcept>
+
+#include "cancellation.h"
+
+using philote::CancellationMonitor;
+using philote::CancellationToken;
+
+CancellationToken::CancellationToken()
+    : flag_(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+CancellationMonitor &CancellationMonitor::Instance()
+{
+    static CancellationMonitor monitor;
+    return monitor;
+}
+
+CancellationMonitor::~CancellationMonitor() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+CancellationToken CancellationMonitor::Watch(const grpc::ServerContextBase *context)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto entry = entries_.find(context);
+    if (entry == entries_.end())
+        entry = entries_.emplace(context, Entry{context, CancellationToken(), 0}).first;
+    entry->second.watchers++;
+
+    // contexts cancelled before the watch are reported right away
+    if (context->IsCancelled())
+        entry->second.token.Cancel();
+
+    if (!thread_.joinable())
+        thread_ = std::thread([this]
+                              { Run(); });
+    changed_.notify_all();
+
+    return entry->second.token;
+}
+
+void CancellationMonitor::Unwatch(const grpc::ServerContextBase *context) noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto entry = entries_.find(context);
+    if (entry != entries_.end() and --entry->second.watchers == 0)
+        entries_.erase(entry);
+}
+
+void CancellationMonitor::Cancel(const grpc::ServerContextBase *context) noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto entry = entries_.find(context);
+    if (entry != entries_.end())
+        entry->second.token.Cancel();
+}
+
+void CancellationMonitor::SetPollInterval(std::chrono::milliseconds interval)
+{
+    if (interval.count() <= 0)
+        throw std::invalid_argument("The cancellation polling interval must be positive.");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    interval_ = interval;
+}
+
+size_t CancellationMonitor::watched() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void CancellationMonitor::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_)
+    {
+        // sleep without polling while no context is watched
+        if (entries_.empty())
+            changed_.wait(lock, [this]
+                          { return stopping_ or !entries_.empty(); });
+        else
+            changed_.wait_for(lock, interval_);
+
+        // the contexts stay alive while they are watched, since Unwatch
+        // takes the lock before the RPC returns
+        for (auto &entry : entries_)
+        {
+            if (!entry.second.token.IsCancelled() and entry.second.context->IsCancelled())
+                entry.second.token.Cancel();
+        }
+    }
+}
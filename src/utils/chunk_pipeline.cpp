@@ -0,0 +1,131 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include "chunk_pipeline.h"
+
+using philote::Array;
+using philote::ChunkPipeline;
+
+ChunkPipeline::ChunkPipeline(grpc::internal::WriterInterface<Array> *stream, bool threaded,
+                             const CompressionPolicy &compression)
+    : stream_(stream), compression_(compression)
+{
+    if (threaded)
+        writer_ = std::thread(&ChunkPipeline::Run, this);
+}
+
+ChunkPipeline::~ChunkPipeline() noexcept
+{
+    if (!writer_.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    changed_.notify_all();
+    writer_.join();
+}
+
+Array ChunkPipeline::Acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.empty())
+        return Array();
+
+    Array message = std::move(free_.back());
+    free_.pop_back();
+    return message;
+}
+
+bool ChunkPipeline::Write(Array &&message)
+{
+    if (!writer_.joinable())
+    {
+        if (failed_ or !stream_->Write(message, compression_.WriteOptionsFor(message)))
+            failed_ = true;
+
+        free_.push_back(std::move(message));
+        return !failed_;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this]
+                  { return failed_ or queue_.size() < kDepth; });
+    if (failed_)
+        return false;
+
+    queue_.push_back(std::move(message));
+    lock.unlock();
+    changed_.notify_all();
+
+    return true;
+}
+
+bool ChunkPipeline::Finish()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [this]
+                  { return failed_ or (queue_.empty() and !writing_); });
+
+    return !failed_;
+}
+
+void ChunkPipeline::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        changed_.wait(lock, [this]
+                      { return stopping_ or !queue_.empty(); });
+
+        // queued messages are dropped after a failure or on destruction
+        if (stopping_)
+            return;
+
+        Array message = std::move(queue_.front());
+        queue_.pop_front();
+        writing_ = true;
+
+        // write without holding the lock, so the next chunk can be queued
+        lock.unlock();
+        const bool ok = stream_->Write(message, compression_.WriteOptionsFor(message));
+        lock.lock();
+
+        writing_ = false;
+        if (!ok)
+        {
+            failed_ = true;
+            queue_.clear();
+        }
+        free_.push_back(std::move(message));
+        changed_.notify_all();
+    }
+}
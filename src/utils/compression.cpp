@@ -0,0 +1,132 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <limits>
+
+#include "compression.h"
+#include "protocol_extensions.h"
+
+using std::string;
+
+using philote::CompressedArrayStream;
+using philote::CompressionPolicy;
+
+bool CompressionPolicy::Enabled() const noexcept
+{
+    return algorithm != GRPC_COMPRESS_NONE;
+}
+
+bool CompressionPolicy::Compresses(const Array &message) const noexcept
+{
+    return Enabled() and static_cast<size_t>(message.data_size()) >= min_values;
+}
+
+grpc::WriteOptions CompressionPolicy::WriteOptionsFor(const Array &message) const
+{
+    grpc::WriteOptions options;
+    if (Enabled() and !Compresses(message))
+        options.set_no_compression();
+
+    return options;
+}
+
+std::string philote::FormatCompressionPolicy(const CompressionPolicy &policy)
+{
+    const char *name = nullptr;
+    if (!grpc_compression_algorithm_name(policy.algorithm, &name))
+        name = "identity";
+
+    return string(name) + "," + std::to_string(policy.min_values);
+}
+
+bool philote::ParseCompressionPolicy(const std::string &text, CompressionPolicy &policy)
+{
+    const size_t comma = text.find(',');
+    if (comma == string::npos)
+        return false;
+
+    const string name = text.substr(0, comma);
+    size_t min_values = 0;
+    if (!ParseIndex(text.substr(comma + 1), std::numeric_limits<size_t>::max(), min_values))
+        return false;
+
+    // the names are defined by gRPC (identity, deflate, gzip)
+    for (int i = 0; i < GRPC_COMPRESS_ALGORITHMS_COUNT; i++)
+    {
+        const auto algorithm = static_cast<grpc_compression_algorithm>(i);
+        const char *known = nullptr;
+        if (grpc_compression_algorithm_name(algorithm, &known) and name == known)
+        {
+            policy.algorithm = algorithm;
+            policy.min_values = min_values;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+CompressedArrayStream::CompressedArrayStream(grpc::ServerReaderWriterInterface<Array, Array> *stream,
+                                             const CompressionPolicy &policy)
+    : stream_(stream), policy_(policy)
+{
+}
+
+void CompressedArrayStream::SendInitialMetadata()
+{
+    stream_->SendInitialMetadata();
+}
+
+bool CompressedArrayStream::Write(const Array &msg, grpc::WriteOptions options)
+{
+    if (!policy_.Compresses(msg))
+        options.set_no_compression();
+
+    return stream_->Write(msg, options);
+}
+
+bool CompressedArrayStream::NextMessageSize(uint32_t *sz)
+{
+    return stream_->NextMessageSize(sz);
+}
+
+bool CompressedArrayStream::Read(Array *msg)
+{
+    return stream_->Read(msg);
+}
+
+CompressionPolicy philote::RequestedCompression(const grpc::ServerContextBase *context)
+{
+    CompressionPolicy policy;
+    if (!ParseCompressionPolicy(FindClientMetadata(context, kCompressionMetadataKey), policy))
+        return CompressionPolicy();
+
+    return policy;
+}
@@ -0,0 +1,286 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "definition_cache.h"
+
+using philote::DefinitionCache;
+using philote::PartialsMetaData;
+using philote::PartialsSparsity;
+using philote::VariableMetaData;
+
+using std::string;
+using std::vector;
+
+namespace
+{
+    constexpr uint64_t kPrime = 0x100000001b3ULL;
+
+    //! first line of a cache file
+    constexpr char kFileMagic[] = "philote-definitions 1\n";
+
+    //! largest message accepted from a cache file
+    constexpr uint64_t kMaxMessageSize = uint64_t(1) << 30;
+
+    //! FNV-1a hash with two independent lanes
+    class DefinitionHasher
+    {
+    public:
+        void Add(uint64_t word) noexcept
+        {
+            low_ = (low_ ^ word) * kPrime;
+            high_ = (high_ ^ (word + 0x9e3779b97f4a7c15ULL)) * kPrime;
+        }
+
+        void Add(const string &bytes) noexcept
+        {
+            Add(bytes.size());
+            for (const char c : bytes)
+                Add(static_cast<unsigned char>(c));
+        }
+
+        string Hex() const
+        {
+            char text[33];
+            std::snprintf(text, sizeof(text), "%016llx%016llx", static_cast<unsigned long long>(high_),
+                          static_cast<unsigned long long>(low_));
+            return text;
+        }
+
+    private:
+        uint64_t low_ = 0xcbf29ce484222325ULL;
+        uint64_t high_ = 0x84222325cbf29ce4ULL;
+    };
+
+    //! Cache keys become file names, so only accept hexadecimal hashes
+    bool ValidHash(const string &hash) noexcept
+    {
+        if (hash.empty() or hash.size() > 64)
+            return false;
+
+        for (const char c : hash)
+        {
+            if (!((c >= '0' and c <= '9') or (c >= 'a' and c <= 'f')))
+                return false;
+        }
+        return true;
+    }
+
+    string VariablesEntry(const string &hash, bool discrete)
+    {
+        return hash + (discrete ? ".discrete-variables" : ".variables");
+    }
+
+    string PartialsEntry(const string &hash, bool sparse)
+    {
+        return hash + (sparse ? ".sparse-partials" : ".partials");
+    }
+
+    template <class Message>
+    vector<string> Serialize(const vector<Message> &meta)
+    {
+        vector<string> messages;
+        messages.reserve(meta.size());
+        for (const Message &message : meta)
+            messages.push_back(message.SerializeAsString());
+        return messages;
+    }
+
+    template <class Message>
+    bool Parse(const vector<string> &messages, vector<Message> &meta)
+    {
+        vector<Message> parsed(messages.size());
+        for (size_t i = 0; i < messages.size(); i++)
+        {
+            if (!parsed[i].ParseFromString(messages[i]))
+                return false;
+        }
+
+        meta = std::move(parsed);
+        return true;
+    }
+}
+
+string philote::HashDefinitions(const vector<VariableMetaData> &var_meta,
+                                const vector<PartialsMetaData> &partials_meta,
+                                const PartialsSparsity &sparsity,
+                                const std::set<string> &discrete)
+{
+    DefinitionHasher hasher;
+
+    hasher.Add(var_meta.size());
+    for (const VariableMetaData &var : var_meta)
+        hasher.Add(var.SerializeAsString());
+
+    hasher.Add(partials_meta.size());
+    for (const PartialsMetaData &partial : partials_meta)
+        hasher.Add(partial.SerializeAsString());
+
+    hasher.Add(sparsity.size());
+    for (const auto &entry : sparsity)
+    {
+        hasher.Add(entry.first.first);
+        hasher.Add(entry.first.second);
+
+        const SparsityPattern &pattern = entry.second;
+        hasher.Add(pattern.rows.size());
+        for (size_t k = 0; k < pattern.rows.size(); k++)
+        {
+            hasher.Add(static_cast<uint64_t>(pattern.rows[k]));
+            hasher.Add(static_cast<uint64_t>(pattern.cols[k]));
+        }
+        hasher.Add(static_cast<uint64_t>(pattern.num_cols));
+        hasher.Add(pattern.dense_shape.size());
+        for (const int64_t dim : pattern.dense_shape)
+            hasher.Add(static_cast<uint64_t>(dim));
+    }
+
+    // definitions without discrete variables keep their previous hash
+    if (!discrete.empty())
+    {
+        hasher.Add(discrete.size());
+        for (const string &name : discrete)
+            hasher.Add(name);
+    }
+
+    return hasher.Hex();
+}
+
+DefinitionCache::DefinitionCache(string directory)
+    : directory_(std::move(directory))
+{
+    if (!directory_.empty() and directory_.back() != '/')
+        directory_ += '/';
+}
+
+bool DefinitionCache::LoadVariables(const string &hash, vector<VariableMetaData> &meta, bool discrete)
+{
+    vector<string> messages;
+    return ValidHash(hash) and Load(VariablesEntry(hash, discrete), messages) and Parse(messages, meta);
+}
+
+void DefinitionCache::StoreVariables(const string &hash, const vector<VariableMetaData> &meta, bool discrete)
+{
+    if (ValidHash(hash))
+        Store(VariablesEntry(hash, discrete), Serialize(meta));
+}
+
+bool DefinitionCache::LoadPartials(const string &hash, bool sparse, vector<PartialsMetaData> &meta)
+{
+    vector<string> messages;
+    return ValidHash(hash) and Load(PartialsEntry(hash, sparse), messages) and Parse(messages, meta);
+}
+
+void DefinitionCache::StorePartials(const string &hash, bool sparse, const vector<PartialsMetaData> &meta)
+{
+    if (ValidHash(hash))
+        Store(PartialsEntry(hash, sparse), Serialize(meta));
+}
+
+bool DefinitionCache::Load(const string &name, vector<string> &messages)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto entry = entries_.find(name);
+        if (entry != entries_.end())
+        {
+            messages = entry->second;
+            return true;
+        }
+    }
+
+    if (directory_.empty())
+        return false;
+
+    std::ifstream file(directory_ + name, std::ios::binary);
+    if (!file)
+        return false;
+
+    string magic(sizeof(kFileMagic) - 1, '\0');
+    if (!file.read(&magic[0], magic.size()) or magic != kFileMagic)
+        return false;
+
+    vector<string> read;
+    uint64_t size = 0;
+    while (file.read(reinterpret_cast<char *>(&size), sizeof(size)))
+    {
+        if (size > kMaxMessageSize)
+            return false;
+
+        string message(size, '\0');
+        if (size > 0 and !file.read(&message[0], static_cast<std::streamsize>(size)))
+            return false;
+        read.push_back(std::move(message));
+    }
+    if (!file.eof() or file.gcount() != 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages = read;
+    entries_[name] = std::move(read);
+    return true;
+}
+
+void DefinitionCache::Store(const string &name, vector<string> messages)
+{
+    if (!directory_.empty())
+    {
+        // write to a unique temporary file that replaces the entry at once
+        std::random_device device;
+        std::ostringstream temporary;
+        temporary << directory_ << name << ".tmp" << std::hex << device() << device();
+
+        std::ofstream file(temporary.str(), std::ios::binary | std::ios::trunc);
+        if (file)
+        {
+            file.write(kFileMagic, sizeof(kFileMagic) - 1);
+            for (const string &message : messages)
+            {
+                const uint64_t size = message.size();
+                file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+                file.write(message.data(), static_cast<std::streamsize>(message.size()));
+            }
+            file.close();
+
+            // a cache that cannot be written only costs the next process a fetch
+            if (!file or std::rename(temporary.str().c_str(), (directory_ + name).c_str()) != 0)
+                std::remove(temporary.str().c_str());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[name] = std::move(messages);
+}
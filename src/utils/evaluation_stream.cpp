@@ -0,0 +1,253 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <limits>
+
+#include "evaluation_stream.h"
+
+using philote::Array;
+using philote::EvaluationFrameStream;
+using philote::EvaluationStream;
+
+Array philote::EndOfEvaluation(uint64_t id)
+{
+    Array array;
+    array.set_start(kEndOfEvaluationMarker);
+    array.set_end(static_cast<int64_t>(id));
+    return array;
+}
+
+bool philote::IsEndOfEvaluation(const Array &array) noexcept
+{
+    return array.name().empty() and array.start() == kEndOfEvaluationMarker;
+}
+
+bool philote::RequestsEvaluationStream(const grpc::ServerContextBase *context)
+{
+    return FindClientMetadata(context, kEvaluationStreamMetadataKey) == "1";
+}
+
+EvaluationFrameStream::EvaluationFrameStream(grpc::ServerReaderWriterInterface<Array, Array> *stream)
+    : stream_(stream)
+{
+}
+
+bool EvaluationFrameStream::Start()
+{
+    if (!stream_->Read(&first_))
+    {
+        closed_ = true;
+        return false;
+    }
+
+    if (IsEndOfEvaluation(first_))
+    {
+        // evaluation without inputs
+        ended_ = true;
+        id_ = static_cast<uint64_t>(first_.end());
+    }
+    else
+        has_first_ = true;
+
+    return true;
+}
+
+bool EvaluationFrameStream::Skip()
+{
+    Array message;
+    while (Read(&message))
+    {
+    }
+
+    return ended_;
+}
+
+void EvaluationFrameStream::SendInitialMetadata()
+{
+    stream_->SendInitialMetadata();
+}
+
+bool EvaluationFrameStream::Write(const Array &msg, grpc::WriteOptions options)
+{
+    return stream_->Write(msg, options);
+}
+
+bool EvaluationFrameStream::NextMessageSize(uint32_t *sz)
+{
+    if (has_first_)
+    {
+        *sz = static_cast<uint32_t>(first_.ByteSizeLong());
+        return true;
+    }
+
+    if (ended_ or closed_)
+        return false;
+
+    return stream_->NextMessageSize(sz);
+}
+
+bool EvaluationFrameStream::Read(Array *msg)
+{
+    if (has_first_)
+    {
+        has_first_ = false;
+        msg->Swap(&first_);
+        return true;
+    }
+
+    if (ended_ or closed_)
+        return false;
+
+    if (!stream_->Read(msg))
+    {
+        closed_ = true;
+        return false;
+    }
+
+    if (IsEndOfEvaluation(*msg))
+    {
+        ended_ = true;
+        id_ = static_cast<uint64_t>(msg->end());
+        return false;
+    }
+
+    return true;
+}
+
+EvaluationStream::~EvaluationStream() noexcept
+{
+    Close();
+}
+
+bool EvaluationStream::Reusable(uint64_t generation, std::chrono::milliseconds timeout) const
+{
+    return persistent_ and stream_ and !active_ and generation_ == generation and
+           context_->deadline() - std::chrono::system_clock::now() >= timeout;
+}
+
+void EvaluationStream::Open(std::unique_ptr<grpc::ClientContext> context, std::unique_ptr<Stream> stream,
+                            bool persistent, uint64_t generation)
+{
+    Close();
+
+    context_ = std::move(context);
+    stream_ = std::move(stream);
+    persistent_ = persistent;
+    generation_ = generation;
+    evaluations_ = 0;
+    active_ = true;
+    ended_ = false;
+}
+
+bool EvaluationStream::EndInputs()
+{
+    if (persistent_)
+        return stream_->Write(EndOfEvaluation(evaluations_ + 1));
+
+    return stream_->WritesDone();
+}
+
+bool EvaluationStream::Read(Array *message)
+{
+    if (ended_ or !stream_->Read(message))
+        return false;
+
+    if (persistent_ and IsEndOfEvaluation(*message))
+    {
+        ended_ = true;
+        return false;
+    }
+
+    return true;
+}
+
+grpc::Status EvaluationStream::Finish()
+{
+    // the stream stays open for the next evaluation
+    if (ended_)
+    {
+        ended_ = false;
+        active_ = false;
+        evaluations_++;
+        return grpc::Status::OK;
+    }
+
+    return FinishRPC();
+}
+
+grpc::Status EvaluationStream::Fail()
+{
+    if (!stream_)
+        return grpc::Status(grpc::StatusCode::UNAVAILABLE, "The stream is not open");
+
+    ended_ = false;
+    return FinishRPC();
+}
+
+grpc::Status EvaluationStream::FinishRPC()
+{
+    grpc::Status status = stream_->Finish();
+
+    // servers rejecting the RPC under load suggest when to retry
+    retry_after_ = std::chrono::milliseconds(0);
+    size_t hint = 0;
+    if (status.error_code() == grpc::StatusCode::RESOURCE_EXHAUSTED and
+        ParseIndex(FindMetadata(context_->GetServerTrailingMetadata(), kRetryAfterMetadataKey),
+                   std::numeric_limits<size_t>::max(), hint))
+        retry_after_ = std::chrono::milliseconds(hint);
+
+    stream_.reset();
+    context_.reset();
+    evaluations_ = 0;
+    active_ = false;
+
+    return status;
+}
+
+void EvaluationStream::Cancel() noexcept
+{
+    if (!stream_)
+        return;
+
+    context_->TryCancel();
+    stream_->Finish();
+    stream_.reset();
+    context_.reset();
+    evaluations_ = 0;
+    active_ = false;
+    ended_ = false;
+}
+
+void EvaluationStream::Close() noexcept
+{
+    // idle streams carry no evaluation that could be lost, and cancelling
+    // does not wait for an unresponsive server
+    Cancel();
+}
@@ -0,0 +1,82 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <stdexcept>
+
+#include "finite_difference.h"
+
+using std::vector;
+
+vector<vector<size_t>> philote::ColorColumns(const vector<vector<size_t>> &column_rows, size_t num_rows)
+{
+    vector<vector<size_t>> groups;
+
+    // rows already covered by each group
+    vector<vector<bool>> covered;
+
+    for (size_t col = 0; col < column_rows.size(); col++)
+    {
+        const vector<size_t> &rows = column_rows[col];
+        for (size_t row : rows)
+        {
+            if (row >= num_rows)
+                throw std::out_of_range("Row index out of range in ColorColumns");
+        }
+
+        // first group none of whose columns shares a row with this column
+        size_t group = 0;
+        for (; group < groups.size(); group++)
+        {
+            bool disjoint = true;
+            for (size_t row : rows)
+            {
+                if (covered[group][row])
+                {
+                    disjoint = false;
+                    break;
+                }
+            }
+            if (disjoint)
+                break;
+        }
+
+        if (group == groups.size())
+        {
+            groups.emplace_back();
+            covered.emplace_back(num_rows, false);
+        }
+
+        groups[group].push_back(col);
+        for (size_t row : rows)
+            covered[group][row] = true;
+    }
+
+    return groups;
+}
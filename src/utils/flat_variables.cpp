@@ -0,0 +1,261 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <stdexcept>
+
+#include "flat_variables.h"
+
+using std::string;
+using std::vector;
+
+using philote::FlatVariables;
+using philote::Variable;
+using philote::Variables;
+
+namespace
+{
+    //! Rounds an offset up to the next kSimdAlignment boundary of the buffer
+    size_t AlignOffset(size_t offset) noexcept
+    {
+        constexpr size_t kAlignedDoubles = philote::kSimdAlignment / sizeof(double);
+        return (offset + kAlignedDoubles - 1) / kAlignedDoubles * kAlignedDoubles;
+    }
+}
+
+FlatVariables::FlatVariables(const vector<VariableMetaData> &meta,
+                             const VariableType &type)
+{
+    for (const VariableMetaData &var : meta)
+    {
+        if (var.type() != type)
+            continue;
+
+        vector<size_t> shape(var.shape().begin(), var.shape().end());
+        Add(var.name(), var.type(), shape);
+    }
+}
+
+FlatVariables::FlatVariables(const vector<VariableMetaData> &meta,
+                             const VariableType &type,
+                             const FileStorage &storage)
+{
+    size_t total = 0;
+    for (const VariableMetaData &var : meta)
+    {
+        if (var.type() != type)
+            continue;
+
+        size_t size = 1;
+        for (int64_t dim : var.shape())
+            size *= static_cast<size_t>(dim);
+        total = AlignOffset(total) + size;
+    }
+
+    // the file is sized for the whole layout up front
+    if (storage.Applies(total))
+        file_ = MappedFile::CreateTemporary(storage.directory, total);
+
+    for (const VariableMetaData &var : meta)
+    {
+        if (var.type() != type)
+            continue;
+
+        vector<size_t> shape(var.shape().begin(), var.shape().end());
+        Add(var.name(), var.type(), shape);
+    }
+}
+
+FlatVariables::FlatVariables(const FlatVariables &other)
+    : entries_(other.entries_),
+      handles_(other.handles_),
+      buffer_(other.data(), other.data() + other.size())
+{
+    BindViews();
+}
+
+FlatVariables &FlatVariables::operator=(const FlatVariables &other)
+{
+    if (this != &other)
+    {
+        entries_ = other.entries_;
+        handles_ = other.handles_;
+        buffer_.assign(other.data(), other.data() + other.size());
+        file_.reset();
+        views_.clear();
+        by_handle_.clear();
+        BindViews();
+    }
+    return *this;
+}
+
+FlatVariables::Handle FlatVariables::Add(const string &name,
+                                         const VariableType &type,
+                                         const vector<size_t> &shape)
+{
+    if (handles_.count(name) > 0)
+        throw std::invalid_argument("Variable " + name + " already exists in FlatVariables");
+
+    size_t size = 1;
+    for (size_t dim : shape)
+        size *= dim;
+
+    // every variable starts on an aligned boundary, so that its view is
+    // as aligned as the buffer
+    const size_t offset = entries_.empty() ? 0 : AlignOffset(entries_.back().offset + entries_.back().size);
+    if (file_ and offset + size > file_->size())
+        throw std::logic_error("Cannot add " + name + " to file-backed FlatVariables");
+
+    const Handle handle = entries_.size();
+    entries_.push_back({name, type, shape, offset, size});
+    handles_[name] = handle;
+
+    // growing the buffer may move it, so all views are rebound
+    if (!file_)
+        buffer_.resize(offset + size, 0.0);
+    BindViews();
+
+    return handle;
+}
+
+FlatVariables::Handle FlatVariables::Find(const string &name) const
+{
+    auto it = handles_.find(name);
+    if (it == handles_.end())
+        throw std::out_of_range("Variable " + name + " not found in FlatVariables");
+    return it->second;
+}
+
+bool FlatVariables::Contains(const string &name) const noexcept
+{
+    return handles_.find(name) != handles_.end();
+}
+
+Variable &FlatVariables::operator[](Handle handle)
+{
+    return *by_handle_.at(handle);
+}
+
+const Variable &FlatVariables::operator[](Handle handle) const
+{
+    return *by_handle_.at(handle);
+}
+
+Variable &FlatVariables::at(const string &name)
+{
+    return *by_handle_[Find(name)];
+}
+
+const Variable &FlatVariables::at(const string &name) const
+{
+    return *by_handle_[Find(name)];
+}
+
+double &FlatVariables::operator()(Handle handle, size_t i) noexcept
+{
+    return data()[entries_[handle].offset + i];
+}
+
+double FlatVariables::operator()(Handle handle, size_t i) const noexcept
+{
+    return data()[entries_[handle].offset + i];
+}
+
+const string &FlatVariables::name(Handle handle) const
+{
+    return entries_.at(handle).name;
+}
+
+size_t FlatVariables::offset(Handle handle) const
+{
+    return entries_.at(handle).offset;
+}
+
+size_t FlatVariables::size(Handle handle) const
+{
+    return entries_.at(handle).size;
+}
+
+size_t FlatVariables::count() const noexcept
+{
+    return entries_.size();
+}
+
+size_t FlatVariables::size() const noexcept
+{
+    return file_ ? file_->size() : buffer_.size();
+}
+
+double *FlatVariables::data() noexcept
+{
+    return file_ ? file_->data() : buffer_.data();
+}
+
+const double *FlatVariables::data() const noexcept
+{
+    return file_ ? file_->data() : buffer_.data();
+}
+
+Variables &FlatVariables::map() noexcept
+{
+    return views_;
+}
+
+const Variables &FlatVariables::map() const noexcept
+{
+    return views_;
+}
+
+void FlatVariables::Fill(double value)
+{
+    if (file_ and value == 0.0)
+        file_->Zero();
+    else
+        std::fill(data(), data() + size(), value);
+    BindViews();
+}
+
+void FlatVariables::BindViews()
+{
+    by_handle_.resize(entries_.size());
+    for (size_t handle = 0; handle < entries_.size(); ++handle)
+    {
+        const Entry &entry = entries_[handle];
+        double *first = data() + entry.offset;
+
+        // views of a file-backed buffer release their pages when sent
+        Variable &view = views_[entry.name];
+        if (view.data() != first or view.Size() != entry.size or !view.IsView())
+            view = file_ ? Variable(entry.type, entry.shape, file_, entry.offset)
+                         : Variable(entry.type, entry.shape, first);
+
+        by_handle_[handle] = &view;
+    }
+}
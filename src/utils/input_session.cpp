@@ -0,0 +1,240 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#include "chunk_pipeline.h"
+#include "input_session.h"
+#include "protocol_extensions.h"
+
+using std::string;
+
+using philote::InputSession;
+using philote::InputSessionCache;
+using philote::InputSessionRequest;
+
+namespace
+{
+    //! exclusive upper bound of the session versions
+    constexpr size_t kVersionLimit = 1000000000000000000ULL;
+
+    //! Creates a random hexadecimal session id
+    string RandomSessionId()
+    {
+        std::random_device device;
+        std::mt19937_64 engine((static_cast<uint64_t>(device()) << 32) ^ device());
+
+        static const char digits[] = "0123456789abcdef";
+        string id;
+        for (int word = 0; word < 2; word++)
+        {
+            uint64_t bits = engine();
+            for (int i = 0; i < 16; i++, bits >>= 4)
+                id += digits[bits & 0xf];
+        }
+
+        return id;
+    }
+
+    //! Checks whether two variables hold the same values
+    bool SameValues(const philote::Variable &a, const philote::Variable &b, size_t start, size_t count)
+    {
+        return std::memcmp(a.data() + start, b.data() + start, count * sizeof(double)) == 0;
+    }
+}
+
+std::string philote::FormatInputSession(const InputSessionRequest &request)
+{
+    return request.id + "," + std::to_string(request.base) + "," + std::to_string(request.version);
+}
+
+bool philote::ParseInputSession(const std::string &text, InputSessionRequest &request)
+{
+    const size_t first = text.find(',');
+    if (first == string::npos or first == 0)
+        return false;
+    const size_t second = text.find(',', first + 1);
+    if (second == string::npos)
+        return false;
+
+    size_t base = 0;
+    size_t version = 0;
+    if (!ParseIndex(text.substr(first + 1, second - first - 1), kVersionLimit, base) or
+        !ParseIndex(text.substr(second + 1), kVersionLimit, version) or version <= base)
+        return false;
+
+    request.id = text.substr(0, first);
+    request.base = base;
+    request.version = version;
+    return true;
+}
+
+InputSession::InputSession() : id_(RandomSessionId()) {}
+
+std::string InputSession::Begin()
+{
+    staged_.clear();
+    version_ = base_ + 1;
+
+    InputSessionRequest request;
+    request.id = id_;
+    request.base = base_;
+    request.version = version_;
+
+    return FormatInputSession(request);
+}
+
+bool InputSession::Stage(const std::string &name, const Variable &var)
+{
+    // discrete variables are small once integer-encoded and always sent
+    if (IsDelta() and !var.IsDiscrete())
+    {
+        auto previous = sent_.find(name);
+        if (previous != sent_.end() and previous->second.Size() == var.Size() and
+            SameValues(previous->second, var, 0, var.Size()))
+            return false;
+    }
+
+    staged_[name] = var;
+    return true;
+}
+
+void InputSession::Send(const std::string &name, const Variable &var, ChunkPipeline *pipeline,
+                        size_t chunk_size, WirePrecision precision) const
+{
+    auto previous = sent_.find(name);
+    if (!IsDelta() or previous == sent_.end() or previous->second.Size() != var.Size())
+    {
+        var.Send(name, "", pipeline, chunk_size, precision);
+        return;
+    }
+
+    if (chunk_size == 0)
+        throw std::invalid_argument("Chunk size must be greater than zero in InputSession::Send");
+
+    // float32 values take half a double each
+    const size_t values_per_chunk = precision == WirePrecision::kFloat32 ? 2 * chunk_size : chunk_size;
+
+    // the server restores the unchanged chunks from the base version
+    const size_t n = var.Size();
+    for (size_t start = 0; start < n; start += values_per_chunk)
+    {
+        const size_t count = std::min(values_per_chunk, n - start);
+        if (SameValues(previous->second, var, start, count))
+            continue;
+
+        Array array = pipeline->Acquire();
+        array.set_name(name);
+        array.set_subname("");
+        var.CreateChunk(start, start + count - 1, array, precision);
+
+        if (!pipeline->Write(std::move(array)))
+            throw std::runtime_error("Failed to write variable '" + name + "' to stream");
+    }
+}
+
+void InputSession::Commit()
+{
+    for (auto &entry : staged_)
+        sent_[entry.first] = std::move(entry.second);
+    staged_.clear();
+
+    base_ = version_;
+}
+
+void InputSession::Reset() noexcept
+{
+    sent_.clear();
+    staged_.clear();
+    base_ = 0;
+}
+
+grpc::Status InputSessionCache::Restore(const grpc::ServerContextBase *context, InputSessionRequest &request,
+                                        FlatVariables &inputs)
+{
+    request = InputSessionRequest();
+
+    const string value = FindClientMetadata(context, kInputSessionMetadataKey);
+    if (value.empty())
+        return grpc::Status::OK;
+
+    if (!ParseInputSession(value, request))
+    {
+        request = InputSessionRequest();
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Malformed input session '" + value + "'");
+    }
+
+    if (!request.IsDelta())
+        return grpc::Status::OK;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto session = std::find_if(sessions_.begin(), sessions_.end(),
+                                [&request](const Session &s)
+                                { return s.id == request.id; });
+    if (session == sessions_.end() or session->version != request.base or
+        session->values.size() != inputs.size())
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                            "Inputs of session '" + request.id + "' version " +
+                                std::to_string(request.base) + " are not available");
+
+    std::copy(session->values.begin(), session->values.end(), inputs.data());
+    sessions_.splice(sessions_.begin(), sessions_, session);
+
+    return grpc::Status::OK;
+}
+
+void InputSessionCache::Store(const InputSessionRequest &request, const FlatVariables &inputs)
+{
+    if (request.id.empty() or capacity_ == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto session = std::find_if(sessions_.begin(), sessions_.end(),
+                                [&request](const Session &s)
+                                { return s.id == request.id; });
+    if (session == sessions_.end())
+    {
+        // reuse the buffer of the least recently used session once full
+        if (sessions_.size() >= capacity_)
+            session = std::prev(sessions_.end());
+        else
+            session = sessions_.emplace(sessions_.end());
+        session->id = request.id;
+    }
+
+    session->version = request.version;
+    session->values.assign(inputs.data(), inputs.data() + inputs.size());
+    sessions_.splice(sessions_.begin(), sessions_, session);
+}
@@ -0,0 +1,251 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "jacobian_product.h"
+
+using philote::CoordinateMatrix;
+using philote::Partials;
+using philote::PartialsSparsity;
+using philote::Variable;
+using philote::Variables;
+using std::string;
+
+namespace
+{
+    //! Zeroes all products
+    void Clear(Variables &products)
+    {
+        for (auto &product : products)
+            std::fill(product.second.data(), product.second.data() + product.second.Size(), 0.0);
+    }
+
+    //! Number of columns of a dense partial with rows rows
+    size_t DenseColumns(const Variable &partial, size_t rows, const string &f, const string &x)
+    {
+        if (rows == 0 or partial.Size() % rows != 0)
+            throw std::length_error("Partials (" + f + ", " + x + ") do not match the size of " + f);
+
+        return partial.Size() / rows;
+    }
+}
+
+void philote::MultiplyJacobian(const Partials &partials, const PartialsSparsity &sparsity,
+                               const Variables &seeds, Variables &products)
+{
+    Clear(products);
+
+    for (const auto &par : partials)
+    {
+        const string &f = par.first.first;
+        const string &x = par.first.second;
+        auto seed = seeds.find(x);
+        if (seed == seeds.end())
+            continue;
+
+        Variable &product = products.at(f);
+        const double *v = seed->second.data();
+        double *out = product.data();
+        const double *values = par.second.data();
+
+        auto pattern = sparsity.find(par.first);
+        if (pattern != sparsity.end())
+        {
+            if (par.second.Size() != pattern->second.nnz())
+                throw std::length_error("Sparse partials (" + f + ", " + x + ") do not match their pattern");
+
+            for (size_t k = 0; k < pattern->second.nnz(); k++)
+            {
+                const size_t row = static_cast<size_t>(pattern->second.rows[k]);
+                const size_t col = static_cast<size_t>(pattern->second.cols[k]);
+                if (row >= product.Size() or col >= seed->second.Size())
+                    throw std::length_error("Sparse partials (" + f + ", " + x + ") exceed the variable sizes");
+                out[row] += values[k] * v[col];
+            }
+            continue;
+        }
+
+        const size_t rows = product.Size();
+        const size_t cols = DenseColumns(par.second, rows, f, x);
+        if (cols != seed->second.Size())
+            throw std::length_error("Partials (" + f + ", " + x + ") do not match the size of " + x);
+
+        for (size_t row = 0; row < rows; row++)
+        {
+            double sum = 0.0;
+            const double *jacobian_row = values + row * cols;
+            for (size_t col = 0; col < cols; col++)
+                sum += jacobian_row[col] * v[col];
+            out[row] += sum;
+        }
+    }
+}
+
+void philote::MultiplyJacobianTranspose(const Partials &partials, const PartialsSparsity &sparsity,
+                                        const Variables &seeds, Variables &products)
+{
+    Clear(products);
+
+    for (const auto &par : partials)
+    {
+        const string &f = par.first.first;
+        const string &x = par.first.second;
+        auto seed = seeds.find(f);
+        if (seed == seeds.end())
+            continue;
+
+        Variable &product = products.at(x);
+        const double *v = seed->second.data();
+        double *out = product.data();
+        const double *values = par.second.data();
+
+        auto pattern = sparsity.find(par.first);
+        if (pattern != sparsity.end())
+        {
+            if (par.second.Size() != pattern->second.nnz())
+                throw std::length_error("Sparse partials (" + f + ", " + x + ") do not match their pattern");
+
+            for (size_t k = 0; k < pattern->second.nnz(); k++)
+            {
+                const size_t row = static_cast<size_t>(pattern->second.rows[k]);
+                const size_t col = static_cast<size_t>(pattern->second.cols[k]);
+                if (row >= seed->second.Size() or col >= product.Size())
+                    throw std::length_error("Sparse partials (" + f + ", " + x + ") exceed the variable sizes");
+                out[col] += values[k] * v[row];
+            }
+            continue;
+        }
+
+        const size_t rows = seed->second.Size();
+        const size_t cols = DenseColumns(par.second, rows, f, x);
+        if (cols != product.Size())
+            throw std::length_error("Partials (" + f + ", " + x + ") do not match the size of " + x);
+
+        for (size_t row = 0; row < rows; row++)
+        {
+            const double *jacobian_row = values + row * cols;
+            for (size_t col = 0; col < cols; col++)
+                out[col] += jacobian_row[col] * v[row];
+        }
+    }
+}
+
+void philote::Flatten(const Variables &vars, std::vector<double> &values)
+{
+    size_t size = 0;
+    for (const auto &var : vars)
+        size += var.second.Size();
+    values.resize(size);
+
+    size_t offset = 0;
+    for (const auto &var : vars)
+    {
+        std::copy_n(var.second.data(), var.second.Size(), values.data() + offset);
+        offset += var.second.Size();
+    }
+}
+
+void philote::Unflatten(const std::vector<double> &values, Variables &vars)
+{
+    size_t offset = 0;
+    for (auto &var : vars)
+    {
+        if (offset + var.second.Size() > values.size())
+            throw std::length_error("Too few values for variable " + var.first);
+        std::copy_n(values.data() + offset, var.second.Size(), var.second.data());
+        offset += var.second.Size();
+    }
+    if (offset != values.size())
+        throw std::length_error("Too many values for the variables");
+}
+
+size_t philote::AssembleJacobian(const Partials &partials, const PartialsSparsity &sparsity,
+                                 const Variables &unknowns, CoordinateMatrix &matrix, bool transpose)
+{
+    std::map<string, size_t> offsets;
+    size_t size = 0;
+    for (const auto &var : unknowns)
+    {
+        offsets[var.first] = size;
+        size += var.second.Size();
+    }
+    matrix.Clear(size);
+
+    size_t assembled = 0;
+    for (const auto &par : partials)
+    {
+        auto f = offsets.find(par.first.first);
+        auto x = offsets.find(par.first.second);
+        if (f == offsets.end() or x == offsets.end())
+            continue;
+        assembled++;
+
+        auto add = [&](size_t row, size_t col, double value)
+        {
+            if (transpose)
+                matrix.Add(x->second + col, f->second + row, value);
+            else
+                matrix.Add(f->second + row, x->second + col, value);
+        };
+
+        const double *values = par.second.data();
+        auto pattern = sparsity.find(par.first);
+        if (pattern != sparsity.end())
+        {
+            if (par.second.Size() != pattern->second.nnz())
+                throw std::length_error("Sparse partials (" + f->first + ", " + x->first +
+                                        ") do not match their pattern");
+            for (size_t k = 0; k < pattern->second.nnz(); k++)
+                add(static_cast<size_t>(pattern->second.rows[k]), static_cast<size_t>(pattern->second.cols[k]),
+                    values[k]);
+            continue;
+        }
+
+        // explicit zeros of dense partials are skipped
+        const size_t rows = unknowns.at(f->first).Size();
+        const size_t cols = unknowns.at(x->first).Size();
+        if (par.second.Size() != rows * cols)
+            throw std::length_error("Partials (" + f->first + ", " + x->first + ") do not match the variable sizes");
+        for (size_t row = 0; row < rows; row++)
+        {
+            for (size_t col = 0; col < cols; col++)
+            {
+                if (values[row * cols + col] != 0.0)
+                    add(row, col, values[row * cols + col]);
+            }
+        }
+    }
+
+    return assembled;
+}
@@ -0,0 +1,85 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "discipline.h"
+#include "local_transport.h"
+
+using std::shared_ptr;
+using std::string;
+
+namespace
+{
+    grpc::ChannelArguments ChannelArguments(size_t max_message_bytes)
+    {
+        const int limit = static_cast<int>(
+            std::min<size_t>(max_message_bytes, static_cast<size_t>(std::numeric_limits<int>::max())));
+
+        grpc::ChannelArguments args;
+        args.SetMaxReceiveMessageSize(limit);
+        args.SetMaxSendMessageSize(limit);
+        return args;
+    }
+}
+
+std::string philote::UnixSocketAddress(const std::string &path)
+{
+    if (path.empty())
+        throw std::invalid_argument("Unix domain socket path must not be empty");
+
+    return "unix:" + path;
+}
+
+std::shared_ptr<grpc::Channel> philote::CreateUnixSocketChannel(const std::string &path, size_t max_message_bytes)
+{
+    return grpc::CreateCustomChannel(UnixSocketAddress(path), grpc::InsecureChannelCredentials(),
+                                     ChannelArguments(max_message_bytes));
+}
+
+std::shared_ptr<grpc::Server> philote::StartDisciplineServer(grpc::ServerBuilder &builder,
+                                                             std::shared_ptr<Discipline> discipline)
+{
+    std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+    if (!server)
+        throw std::runtime_error("Failed to start the discipline server");
+
+    // the services are members of the discipline, which must outlive the server
+    return shared_ptr<grpc::Server>(server.release(), [discipline](grpc::Server *server)
+                                    { delete server; });
+}
+
+std::shared_ptr<grpc::Channel> philote::CreateInProcessChannel(grpc::Server &server, size_t max_message_bytes)
+{
+    return server.InProcessChannel(ChannelArguments(max_message_bytes));
+}
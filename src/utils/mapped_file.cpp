@@ -0,0 +1,140 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_file.h"
+
+using std::shared_ptr;
+using std::string;
+
+using philote::MappedFile;
+
+namespace
+{
+    string SystemError(const string &what)
+    {
+        return what + ": " + std::strerror(errno);
+    }
+
+    // sizes and maps an open file (closing it on failure)
+    double *Map(int fd, size_t bytes, const string &path)
+    {
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            const string error = SystemError("Failed to size file " + path);
+            close(fd);
+            throw std::runtime_error(error);
+        }
+
+        void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            const string error = SystemError("Failed to map file " + path);
+            close(fd);
+            throw std::runtime_error(error);
+        }
+
+        return static_cast<double *>(data);
+    }
+}
+
+shared_ptr<MappedFile> MappedFile::Create(const string &path, size_t size)
+{
+    const int fd = open(path.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+        throw std::runtime_error(SystemError("Failed to create file " + path));
+
+    // mapping an empty file is not possible
+    double *data = Map(fd, std::max<size_t>(size, 1) * sizeof(double), path);
+    return shared_ptr<MappedFile>(new MappedFile(fd, data, size));
+}
+
+shared_ptr<MappedFile> MappedFile::CreateTemporary(const string &directory, size_t size)
+{
+    string path = directory + "/philote-XXXXXX";
+    std::vector<char> name(path.begin(), path.end());
+    name.push_back('\0');
+
+    const int fd = mkstemp(name.data());
+    if (fd < 0)
+        throw std::runtime_error(SystemError("Failed to create a file in " + directory));
+
+    // the storage is reclaimed when the last descriptor and mapping are gone
+    path = name.data();
+    unlink(path.c_str());
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    double *data = Map(fd, std::max<size_t>(size, 1) * sizeof(double), path);
+    return shared_ptr<MappedFile>(new MappedFile(fd, data, size));
+}
+
+MappedFile::~MappedFile() noexcept
+{
+    munmap(data_, std::max<size_t>(size_, 1) * sizeof(double));
+    close(fd_);
+}
+
+void MappedFile::Release(size_t start, size_t end) const noexcept
+{
+    if (start > end or end >= size_)
+        return;
+
+    // only whole pages inside the range are dropped
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t first = reinterpret_cast<uintptr_t>(data_ + start);
+    const uintptr_t last = reinterpret_cast<uintptr_t>(data_ + end + 1);
+    const uintptr_t begin = (first + page - 1) / page * page;
+    const uintptr_t finish = last / page * page;
+    if (finish <= begin)
+        return;
+
+    // pages of a shared file mapping are written back, not discarded
+    madvise(reinterpret_cast<void *>(begin), finish - begin, MADV_DONTNEED);
+}
+
+void MappedFile::Zero()
+{
+    // truncating discards the values; the mapping stays valid once the file
+    // has its size again
+    const off_t bytes = static_cast<off_t>(std::max<size_t>(size_, 1) * sizeof(double));
+    if (ftruncate(fd_, 0) != 0 or ftruncate(fd_, bytes) != 0)
+        throw std::runtime_error(SystemError("Failed to zero mapped file"));
+}
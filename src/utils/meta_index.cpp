@@ -0,0 +1,74 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include "meta_index.h"
+
+using philote::VariableMetaData;
+using philote::VariableMetaIndex;
+
+using std::string;
+using std::vector;
+
+void VariableMetaIndex::Update(const vector<VariableMetaData> &meta)
+{
+    if (meta.size() < indexed_)
+        Clear();
+
+    for (size_t i = indexed_; i < meta.size(); i++)
+        positions_.emplace(meta[i].name(), i);
+    indexed_ = meta.size();
+}
+
+void VariableMetaIndex::Clear() noexcept
+{
+    positions_.clear();
+    indexed_ = 0;
+}
+
+const VariableMetaData *VariableMetaIndex::Find(const vector<VariableMetaData> &meta, const string &name) const
+{
+    if (indexed_ == meta.size())
+    {
+        auto it = positions_.find(name);
+        if (it == positions_.end())
+            return nullptr;
+        if (meta[it->second].name() == name)
+            return &meta[it->second];
+    }
+
+    // the list was modified without updating the index (or the entry was renamed)
+    for (const VariableMetaData &var : meta)
+    {
+        if (var.name() == name)
+            return &var;
+    }
+
+    return nullptr;
+}
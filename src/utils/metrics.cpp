@@ -0,0 +1,199 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <sstream>
+
+#include "metrics.h"
+
+using std::string;
+using std::chrono::duration;
+using std::chrono::nanoseconds;
+
+using philote::Array;
+using philote::CallMetrics;
+using philote::MeteredArrayStream;
+using philote::MetricsRegistry;
+using philote::RpcMetrics;
+
+void MetricsRegistry::Record(const CallMetrics &call)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RpcMetrics &rpc = rpcs_[call.rpc];
+
+    rpc.calls++;
+    if (call.status == grpc::StatusCode::CANCELLED)
+        rpc.cancellations++;
+    else if (call.status != grpc::StatusCode::OK)
+        rpc.errors++;
+
+    rpc.receive += call.receive;
+    rpc.compute += call.compute;
+    rpc.send += call.send;
+    rpc.messages_received += call.messages_received;
+    rpc.bytes_received += call.bytes_received;
+    rpc.messages_sent += call.messages_sent;
+    rpc.bytes_sent += call.bytes_sent;
+}
+
+std::map<string, RpcMetrics> MetricsRegistry::Snapshot() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rpcs_;
+}
+
+string MetricsRegistry::ToPrometheusText() const
+{
+    const std::map<string, RpcMetrics> rpcs = Snapshot();
+    std::ostringstream text;
+
+    auto seconds = [](nanoseconds time)
+    { return duration<double>(time).count(); };
+
+    text << "# HELP philote_rpc_calls_total Compute RPCs served.\n"
+         << "# TYPE philote_rpc_calls_total counter\n";
+    for (const auto &rpc : rpcs)
+        text << "philote_rpc_calls_total{rpc=\"" << rpc.first << "\"} " << rpc.second.calls << "\n";
+
+    text << "# HELP philote_rpc_errors_total Compute RPCs that failed.\n"
+         << "# TYPE philote_rpc_errors_total counter\n";
+    for (const auto &rpc : rpcs)
+        text << "philote_rpc_errors_total{rpc=\"" << rpc.first << "\"} " << rpc.second.errors << "\n";
+
+    text << "# HELP philote_rpc_cancellations_total Compute RPCs cancelled by the client.\n"
+         << "# TYPE philote_rpc_cancellations_total counter\n";
+    for (const auto &rpc : rpcs)
+        text << "philote_rpc_cancellations_total{rpc=\"" << rpc.first << "\"} " << rpc.second.cancellations
+             << "\n";
+
+    text << "# HELP philote_rpc_phase_seconds_total Time spent per phase of the compute RPCs.\n"
+         << "# TYPE philote_rpc_phase_seconds_total counter\n";
+    for (const auto &rpc : rpcs)
+    {
+        const string labels = "{rpc=\"" + rpc.first + "\",phase=\"";
+        text << "philote_rpc_phase_seconds_total" << labels << "receive\"} " << seconds(rpc.second.receive) << "\n"
+             << "philote_rpc_phase_seconds_total" << labels << "compute\"} " << seconds(rpc.second.compute) << "\n"
+             << "philote_rpc_phase_seconds_total" << labels << "send\"} " << seconds(rpc.second.send) << "\n";
+    }
+
+    text << "# HELP philote_rpc_messages_total Stream messages of the compute RPCs.\n"
+         << "# TYPE philote_rpc_messages_total counter\n";
+    for (const auto &rpc : rpcs)
+    {
+        const string labels = "{rpc=\"" + rpc.first + "\",direction=\"";
+        text << "philote_rpc_messages_total" << labels << "received\"} " << rpc.second.messages_received << "\n"
+             << "philote_rpc_messages_total" << labels << "sent\"} " << rpc.second.messages_sent << "\n";
+    }
+
+    text << "# HELP philote_rpc_bytes_total Serialized size of the stream messages of the compute RPCs.\n"
+         << "# TYPE philote_rpc_bytes_total counter\n";
+    for (const auto &rpc : rpcs)
+    {
+        const string labels = "{rpc=\"" + rpc.first + "\",direction=\"";
+        text << "philote_rpc_bytes_total" << labels << "received\"} " << rpc.second.bytes_received << "\n"
+             << "philote_rpc_bytes_total" << labels << "sent\"} " << rpc.second.bytes_sent << "\n";
+    }
+
+    return text.str();
+}
+
+void MetricsRegistry::Reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    rpcs_.clear();
+}
+
+MeteredArrayStream::MeteredArrayStream(grpc::ServerReaderWriterInterface<Array, Array> *stream)
+    : stream_(stream), start_(Clock::now())
+{
+}
+
+CallMetrics MeteredArrayStream::Finish(const string &rpc, const grpc::Status &status)
+{
+    const Clock::time_point end = Clock::now();
+    if (!inputs_done_)
+        received_ = end;
+    if (!writing_)
+        first_write_ = end;
+
+    metrics_.rpc = rpc;
+    metrics_.receive = received_ - start_;
+    metrics_.compute = first_write_ - received_;
+    metrics_.send = end - first_write_;
+    metrics_.status = status.error_code();
+
+    return metrics_;
+}
+
+void MeteredArrayStream::SendInitialMetadata()
+{
+    stream_->SendInitialMetadata();
+}
+
+bool MeteredArrayStream::Write(const Array &msg, grpc::WriteOptions options)
+{
+    if (!writing_)
+    {
+        first_write_ = Clock::now();
+        if (!inputs_done_)
+        {
+            received_ = first_write_;
+            inputs_done_ = true;
+        }
+        writing_ = true;
+    }
+
+    metrics_.messages_sent++;
+    metrics_.bytes_sent += msg.ByteSizeLong();
+
+    return stream_->Write(msg, options);
+}
+
+bool MeteredArrayStream::NextMessageSize(uint32_t *sz)
+{
+    return stream_->NextMessageSize(sz);
+}
+
+bool MeteredArrayStream::Read(Array *msg)
+{
+    if (!stream_->Read(msg))
+    {
+        if (!inputs_done_)
+        {
+            received_ = Clock::now();
+            inputs_done_ = true;
+        }
+        return false;
+    }
+
+    metrics_.messages_received++;
+    metrics_.bytes_received += msg->ByteSizeLong();
+
+    return true;
+}
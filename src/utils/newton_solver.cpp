@@ -0,0 +1,359 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "newton_solver.h"
+
+using philote::CoordinateMatrix;
+using philote::DenseLUSolver;
+using philote::NewtonOptions;
+using philote::NewtonSolver;
+using philote::NonlinearMethod;
+using philote::SparseLUSolver;
+using std::vector;
+
+namespace
+{
+    //! Whether a pivot can be divided by
+    bool Usable(double pivot) noexcept
+    {
+        return std::isfinite(pivot) and pivot != 0.0;
+    }
+
+    double Dot(const vector<double> &a, const vector<double> &b) noexcept
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < a.size(); i++)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+    double Norm(const vector<double> &v) noexcept
+    {
+        return std::sqrt(Dot(v, v));
+    }
+}
+
+void CoordinateMatrix::Clear(size_t n)
+{
+    size = n;
+    rows.clear();
+    cols.clear();
+    values.clear();
+}
+
+void CoordinateMatrix::Add(size_t row, size_t col, double value)
+{
+    if (row >= size or col >= size)
+        throw std::out_of_range("Matrix entry (" + std::to_string(row) + ", " + std::to_string(col) +
+                                ") outside of a matrix of size " + std::to_string(size));
+
+    rows.push_back(row);
+    cols.push_back(col);
+    values.push_back(value);
+}
+
+void DenseLUSolver::Factorize(const CoordinateMatrix &matrix)
+{
+    const size_t n = matrix.size;
+    size_ = n;
+    lu_.assign(n * n, 0.0);
+    pivots_.resize(n);
+    for (size_t k = 0; k < matrix.values.size(); k++)
+        lu_[matrix.rows[k] * n + matrix.cols[k]] += matrix.values[k];
+
+    for (size_t k = 0; k < n; k++)
+    {
+        // largest remaining entry of the column
+        size_t pivot = k;
+        for (size_t i = k + 1; i < n; i++)
+        {
+            if (std::abs(lu_[i * n + k]) > std::abs(lu_[pivot * n + k]))
+                pivot = i;
+        }
+        if (!Usable(lu_[pivot * n + k]))
+            throw std::runtime_error("Singular matrix (column " + std::to_string(k) + ")");
+
+        pivots_[k] = pivot;
+        if (pivot != k)
+            std::swap_ranges(lu_.begin() + k * n, lu_.begin() + (k + 1) * n, lu_.begin() + pivot * n);
+
+        const double diagonal = lu_[k * n + k];
+        for (size_t i = k + 1; i < n; i++)
+        {
+            double &multiplier = lu_[i * n + k];
+            if (multiplier == 0.0)
+                continue;
+            multiplier /= diagonal;
+            for (size_t j = k + 1; j < n; j++)
+                lu_[i * n + j] -= multiplier * lu_[k * n + j];
+        }
+    }
+}
+
+void DenseLUSolver::Solve(vector<double> &rhs) const
+{
+    const size_t n = size_;
+    if (rhs.size() != n)
+        throw std::length_error("Right-hand side does not match the matrix size");
+
+    for (size_t k = 0; k < n; k++)
+    {
+        std::swap(rhs[k], rhs[pivots_[k]]);
+        for (size_t i = k + 1; i < n; i++)
+            rhs[i] -= lu_[i * n + k] * rhs[k];
+    }
+
+    for (size_t k = n; k-- > 0;)
+    {
+        double sum = rhs[k];
+        for (size_t j = k + 1; j < n; j++)
+            sum -= lu_[k * n + j] * rhs[j];
+        rhs[k] = sum / lu_[k * n + k];
+    }
+}
+
+void SparseLUSolver::Factorize(const CoordinateMatrix &matrix)
+{
+    const size_t n = matrix.size;
+
+    // rows sorted by column with summed duplicates
+    vector<SparseRow> rows(n);
+    for (size_t k = 0; k < matrix.values.size(); k++)
+        rows[matrix.rows[k]].emplace_back(matrix.cols[k], matrix.values[k]);
+    for (SparseRow &row : rows)
+    {
+        std::sort(row.begin(), row.end(), [](const auto &a, const auto &b)
+                  { return a.first < b.first; });
+        SparseRow merged;
+        for (const auto &entry : row)
+        {
+            if (!merged.empty() and merged.back().first == entry.first)
+                merged.back().second += entry.second;
+            else
+                merged.push_back(entry);
+        }
+        merged.erase(std::remove_if(merged.begin(), merged.end(), [](const auto &entry)
+                                    { return entry.second == 0.0; }),
+                     merged.end());
+        row.swap(merged);
+    }
+
+    // rows by the column of their first non-zero; columns before the current
+    // pivot column have been eliminated from all remaining rows
+    vector<vector<size_t>> leading(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!rows[i].empty())
+            leading[rows[i].front().first].push_back(i);
+    }
+
+    upper_.assign(n, SparseRow());
+    order_.assign(n, 0);
+    steps_.assign(n, {});
+    SparseRow updated;
+    for (size_t k = 0; k < n; k++)
+    {
+        vector<size_t> &candidates = leading[k];
+        if (candidates.empty())
+            throw std::runtime_error("Singular matrix (column " + std::to_string(k) + ")");
+
+        // partial pivoting among the rows starting in this column
+        size_t best = 0;
+        for (size_t c = 1; c < candidates.size(); c++)
+        {
+            if (std::abs(rows[candidates[c]].front().second) > std::abs(rows[candidates[best]].front().second))
+                best = c;
+        }
+        const size_t pivot = candidates[best];
+        const SparseRow &pivot_row = rows[pivot];
+        const double diagonal = pivot_row.front().second;
+        if (!Usable(diagonal))
+            throw std::runtime_error("Singular matrix (column " + std::to_string(k) + ")");
+        order_[k] = pivot;
+
+        for (size_t target : candidates)
+        {
+            if (target == pivot)
+                continue;
+
+            // eliminate column k from the target row (merging the sorted rows)
+            const SparseRow &row = rows[target];
+            const double multiplier = row.front().second / diagonal;
+            steps_[k].emplace_back(target, multiplier);
+
+            updated.clear();
+            size_t a = 1, b = 1;
+            while (a < row.size() or b < pivot_row.size())
+            {
+                if (b == pivot_row.size() or (a < row.size() and row[a].first < pivot_row[b].first))
+                    updated.push_back(row[a++]);
+                else if (a == row.size() or pivot_row[b].first < row[a].first)
+                {
+                    updated.emplace_back(pivot_row[b].first, -multiplier * pivot_row[b].second);
+                    b++;
+                }
+                else
+                {
+                    const double value = row[a].second - multiplier * pivot_row[b].second;
+                    if (value != 0.0)
+                        updated.emplace_back(row[a].first, value);
+                    a++;
+                    b++;
+                }
+            }
+            rows[target].swap(updated);
+
+            // rows without non-zeros make the matrix singular at a later column
+            if (!rows[target].empty())
+                leading[rows[target].front().first].push_back(target);
+        }
+
+        upper_[k].swap(rows[pivot]);
+        candidates.clear();
+    }
+}
+
+void SparseLUSolver::Solve(vector<double> &rhs) const
+{
+    const size_t n = order_.size();
+    if (rhs.size() != n)
+        throw std::length_error("Right-hand side does not match the matrix size");
+
+    // forward elimination in the order of the factorization
+    work_ = rhs;
+    for (size_t k = 0; k < n; k++)
+    {
+        for (const auto &step : steps_[k])
+            work_[step.first] -= step.second * work_[order_[k]];
+    }
+
+    // back substitution; pivot step k solves for column k
+    for (size_t k = n; k-- > 0;)
+    {
+        const SparseRow &row = upper_[k];
+        double sum = work_[order_[k]];
+        for (size_t e = 1; e < row.size(); e++)
+            sum -= row[e].second * rhs[row[e].first];
+        rhs[k] = sum / row.front().second;
+    }
+}
+
+std::unique_ptr<philote::LinearSolver> philote::CreateLinearSolver(const NewtonOptions &options)
+{
+    std::unique_ptr<LinearSolver> solver =
+        options.linear_solver ? options.linear_solver() : std::make_unique<DenseLUSolver>();
+    if (!solver)
+        throw std::invalid_argument("The linear solver factory returned no solver");
+
+    return solver;
+}
+
+size_t NewtonSolver::Solve(const NewtonOptions &options, vector<double> &y,
+                           const ResidualFunction &residual, const JacobianFunction &jacobian)
+{
+    const size_t n = y.size();
+    residuals_.resize(n);
+    step_.resize(n);
+    updates_.clear();
+    solver_ = CreateLinearSolver(options);
+
+    residual(y, residuals_);
+    const double initial_norm = Norm(residuals_);
+    double norm = initial_norm;
+    bool factorized = false;
+
+    for (size_t iteration = 0;; iteration++)
+    {
+        if (norm <= options.absolute_tolerance or norm <= options.relative_tolerance * initial_norm)
+            return iteration;
+        if (iteration == options.max_iterations)
+            throw std::runtime_error("Nonlinear solver did not converge in " + std::to_string(iteration) +
+                                     " iterations (residual norm " + std::to_string(norm) + ")");
+
+        // Broyden iterations only refactorize after a restart
+        if (options.method == NonlinearMethod::kNewton or !factorized or
+            updates_.size() >= options.broyden_restart)
+        {
+            jacobian_.Clear(n);
+            jacobian(y, jacobian_);
+            solver_->Factorize(jacobian_);
+            updates_.clear();
+            factorized = true;
+        }
+
+        // step = -J^-1 r
+        step_ = residuals_;
+        ApplyInverse(step_);
+        for (size_t i = 0; i < n; i++)
+        {
+            step_[i] = -step_[i];
+            y[i] += step_[i];
+        }
+
+        previous_.swap(residuals_);
+        residuals_.resize(n);
+        residual(y, residuals_);
+        norm = Norm(residuals_);
+
+        if (options.method == NonlinearMethod::kBroyden)
+        {
+            // good Broyden update of the inverse: u = (s - H dr) / (s^T H dr)
+            vector<double> u(n);
+            for (size_t i = 0; i < n; i++)
+                u[i] = residuals_[i] - previous_[i];
+            ApplyInverse(u);
+            const double denominator = Dot(step_, u);
+            if (Usable(denominator))
+            {
+                for (size_t i = 0; i < n; i++)
+                    u[i] = (step_[i] - u[i]) / denominator;
+                updates_.emplace_back(std::move(u), step_);
+            }
+            else
+                factorized = false;
+        }
+    }
+}
+
+void NewtonSolver::ApplyInverse(vector<double> &v) const
+{
+    solver_->Solve(v);
+    for (const auto &update : updates_)
+    {
+        const double scale = Dot(update.second, v);
+        for (size_t i = 0; i < v.size(); i++)
+            v[i] += update.first[i] * scale;
+    }
+}
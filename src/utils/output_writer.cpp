@@ -0,0 +1,58 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <stdexcept>
+
+#include "output_writer.h"
+
+using philote::FlatVariables;
+using philote::OutputWriter;
+
+OutputWriter::OutputWriter(FlatVariables &outputs, SendFunction send)
+    : outputs_(outputs), send_(std::move(send))
+{
+}
+
+void OutputWriter::Finalize(const std::string &name)
+{
+    if (final_.count(name) > 0)
+        return;
+
+    if (!outputs_.Contains(name))
+        throw std::out_of_range("OutputWriter::Finalize: unknown output " + name);
+
+    send_(name, outputs_.at(name));
+    final_.insert(name);
+}
+
+bool OutputWriter::IsFinal(const std::string &name) const noexcept
+{
+    return final_.count(name) > 0;
+}
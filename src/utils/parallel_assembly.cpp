@@ -0,0 +1,351 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "discipline.h"
+#include "parallel_assembly.h"
+#include "shared_memory.h"
+
+using philote::Array;
+using philote::ParallelAssembly;
+using std::string;
+using std::vector;
+
+struct ParallelAssembly::State
+{
+    //! messages of one variable, assigned by one worker at a time
+    struct Strand
+    {
+        std::deque<std::pair<Array, Task>> tasks;
+        bool running = false;
+    };
+
+    //! Assigns the queued messages of a variable (executed on a worker)
+    void Drain(const string &variable)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        Strand &strand = strands[variable];
+        while (!strand.tasks.empty())
+        {
+            std::pair<Array, Task> item = std::move(strand.tasks.front());
+            strand.tasks.pop_front();
+
+            // the remaining messages are dropped after the first error
+            const bool skip = !status.ok();
+            lock.unlock();
+
+            grpc::Status result;
+            if (!skip)
+            {
+                try
+                {
+                    result = item.second(item.first);
+                }
+                catch (const std::exception &e)
+                {
+                    result = grpc::Status(grpc::StatusCode::INTERNAL,
+                                          "Failed to assign message of variable " + variable + ": " + e.what());
+                }
+            }
+
+            lock.lock();
+            if (!result.ok() and status.ok())
+                status = result;
+
+            item.first.Clear();
+            recycled.push_back(std::move(item.first));
+            pending--;
+            changed.notify_all();
+        }
+        strand.running = false;
+    }
+
+    //! guards all members
+    std::mutex mutex;
+
+    //! signals assigned messages
+    std::condition_variable changed;
+
+    //! queued messages per variable
+    std::map<string, Strand> strands;
+
+    //! cleared messages whose capacity is reused
+    vector<Array> recycled;
+
+    //! number of queued or running messages
+    size_t pending = 0;
+
+    //! maximum number of queued messages
+    size_t limit = 1;
+
+    //! first error of any task
+    grpc::Status status;
+};
+
+ParallelAssembly::ParallelAssembly(ThreadPool *pool)
+    : pool_(pool), state_(std::make_shared<State>())
+{
+    if (pool_)
+        state_->limit = 4 * std::max<size_t>(pool_->size(), 1);
+}
+
+ParallelAssembly::~ParallelAssembly() noexcept
+{
+    Finish();
+}
+
+grpc::Status ParallelAssembly::Submit(string variable, Array &message, Task task)
+{
+    if (!pool_)
+        return task(message);
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->changed.wait(lock, [this]
+                         { return state_->pending < state_->limit; });
+    if (!state_->status.ok())
+        return state_->status;
+
+    // hand the message to the queue and give the caller a recycled one
+    Array queued;
+    if (!state_->recycled.empty())
+    {
+        queued = std::move(state_->recycled.back());
+        state_->recycled.pop_back();
+    }
+    queued.Swap(&message);
+
+    State::Strand &strand = state_->strands[variable];
+    strand.tasks.emplace_back(std::move(queued), std::move(task));
+    state_->pending++;
+
+    if (!strand.running)
+    {
+        strand.running = true;
+        std::shared_ptr<State> state = state_;
+        try
+        {
+            pool_->Submit([state, variable]
+                          { state->Drain(variable); });
+        }
+        catch (const std::exception &e)
+        {
+            strand.tasks.pop_back();
+            strand.running = false;
+            state_->pending--;
+            return grpc::Status(grpc::StatusCode::INTERNAL,
+                                "Failed to queue message of variable " + variable + ": " + e.what());
+        }
+    }
+
+    return grpc::Status::OK;
+}
+
+grpc::Status ParallelAssembly::Finish()
+{
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->changed.wait(lock, [this]
+                         { return state_->pending == 0; });
+
+    return state_->status;
+}
+
+ParallelAssembly::Task philote::AssignTask(SharedMemoryTransfer &shared, InputReadyTracker &ready,
+                                          Variable &value, const string &kind, WirePrecision precision)
+{
+    return [&shared, &ready, &value, kind, precision](const Array &message)
+    {
+        size_t count = 0;
+        try
+        {
+            // set the variable slice
+            count = shared.Assign(message, value, precision);
+        }
+        catch (const std::exception &e)
+        {
+            return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
+                                "Failed to assign chunk for " + kind + " " + message.name() + ": " + e.what());
+        }
+
+        return ready.Received(message.name(), value, count);
+    };
+}
+
+void philote::SerializeInOrder(ThreadPool &pool, size_t count,
+                               const std::function<void(size_t, vector<Array> &)> &serialize,
+                               const std::function<void(size_t, vector<Array> &)> &write)
+{
+    struct Slot
+    {
+        vector<Array> messages;
+        std::exception_ptr error;
+        bool done = false;
+    };
+
+    struct Shared
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        vector<Slot> slots;
+        size_t running = 0;
+    };
+
+    auto shared = std::make_shared<Shared>();
+    shared->slots.resize(count);
+
+    // the tasks reference serialize, so they must finish before returning
+    struct WaitForTasks
+    {
+        Shared &shared;
+
+        ~WaitForTasks()
+        {
+            std::unique_lock<std::mutex> lock(shared.mutex);
+            shared.changed.wait(lock, [this]
+                                { return shared.running == 0; });
+        }
+    } wait{*shared};
+
+    const size_t lookahead = 2 * std::max<size_t>(pool.size(), 1);
+    size_t submitted = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        for (; submitted < count and submitted < i + lookahead; submitted++)
+        {
+            {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->running++;
+            }
+
+            const size_t index = submitted;
+            try
+            {
+                pool.Submit([shared, index, &serialize]
+                            {
+                                vector<Array> messages;
+                                std::exception_ptr error;
+                                try
+                                {
+                                    serialize(index, messages);
+                                }
+                                catch (...)
+                                {
+                                    error = std::current_exception();
+                                }
+    
+                                std::lock_guard<std::mutex> lock(shared->mutex);
+                                Slot &slot = shared->slots[index];
+                                slot.messages = std::move(messages);
+                                slot.error = error;
+                                slot.done = true;
+                                shared->running--;
+                                shared->changed.notify_all();
+                            });
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                shared->running--;
+                throw;
+            }
+        }
+
+        vector<Array> messages;
+        {
+            std::unique_lock<std::mutex> lock(shared->mutex);
+            Slot &slot = shared->slots[i];
+            shared->changed.wait(lock, [&slot]
+                                 { return slot.done; });
+            if (slot.error)
+                std::rethrow_exception(slot.error);
+            messages = std::move(slot.messages);
+        }
+
+        write(i, messages);
+    }
+}
+
+void philote::SendPartialsInOrder(ThreadPool &pool, const Partials &partials, const PartialsSparsity *sparsity,
+                                  size_t chunk_size, WirePrecision precision, grpc::ServerContextBase *context,
+                                  const std::function<bool(const Array &)> &write)
+{
+    vector<const Partials::value_type *> entries;
+    entries.reserve(partials.size());
+    for (const auto &par : partials)
+        entries.push_back(&par);
+
+    SerializeInOrder(pool, entries.size(),
+        [&](size_t i, vector<Array> &messages)
+        {
+            const string &name = entries[i]->first.first;
+            const string &subname = entries[i]->first.second;
+            try
+            {
+                const SparsityPattern *pattern = nullptr;
+                if (sparsity)
+                {
+                    auto it = sparsity->find(entries[i]->first);
+                    if (it != sparsity->end())
+                        pattern = &it->second;
+                }
+
+                if (pattern)
+                    pattern->Densify(entries[i]->second).Send(name, subname, &messages, chunk_size, precision);
+                else
+                    entries[i]->second.Send(name, subname, &messages, chunk_size, precision);
+            }
+            catch (const std::exception &e)
+            {
+                throw std::runtime_error("Failed to send partial " + name + "/" + subname + ": " + e.what());
+            }
+        },
+        [&](size_t i, vector<Array> &messages)
+        {
+            const string &name = entries[i]->first.first;
+            const string &subname = entries[i]->first.second;
+            for (const Array &message : messages)
+            {
+                if (context != nullptr and context->IsCancelled())
+                    throw std::runtime_error("Failed to send partial " + name + "/" + subname +
+                                             ": operation cancelled");
+                if (!write(message))
+                    throw std::runtime_error("Failed to send partial " + name + "/" + subname +
+                                             ": failed to write to stream");
+            }
+        });
+}
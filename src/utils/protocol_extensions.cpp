@@ -0,0 +1,325 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "protocol_extensions.h"
+
+using std::multimap;
+using std::set;
+using std::string;
+using std::vector;
+
+std::string philote::SupportedFeatures()
+{
+    return string(kFeatureBatch) + "," + kFeatureSparsePartials + "," + kFeatureChunkNegotiation + "," +
+           kFeaturePackedVariables + "," + kFeatureFusedGradient + "," + kFeatureSharedMemory + "," +
+           kFeatureWirePrecision + "," + kFeatureCompression + "," + kFeatureInputSessions + "," +
+           kFeatureEvaluationStreams + "," + kFeatureDefinitionsHash + "," + kFeatureJacobianProducts + "," +
+           kFeatureLinearSolves + "," + kFeatureDiscreteVariables + "," + kFeatureOptionsHotReload + "," +
+           kFeatureAdmissionControl;
+}
+
+size_t philote::ChunkSizeForMessageBytes(size_t max_message_bytes) noexcept
+{
+    // reserve room for the names and the remaining fields of the message
+    const size_t reserve = std::min<size_t>(max_message_bytes / 2, 64 * 1024);
+    const size_t chunk = (max_message_bytes - reserve) / sizeof(double);
+
+    return std::max<size_t>(chunk, 1);
+}
+
+std::set<std::string> philote::ParseFeatures(const std::string &features)
+{
+    set<string> result;
+
+    size_t start = 0;
+    while (start <= features.size())
+    {
+        size_t end = features.find(',', start);
+        if (end == string::npos)
+            end = features.size();
+
+        // trim surrounding whitespace
+        size_t first = start, last = end;
+        while (first < last && features[first] == ' ')
+            first++;
+        while (last > first && features[last - 1] == ' ')
+            last--;
+
+        if (last > first)
+            result.insert(features.substr(first, last - first));
+
+        start = end + 1;
+    }
+
+    return result;
+}
+
+std::string philote::FindMetadata(const multimap<grpc::string_ref, grpc::string_ref> &metadata,
+                                  const std::string &key)
+{
+    auto it = metadata.find(grpc::string_ref(key));
+    if (it == metadata.end())
+        return string();
+
+    return string(it->second.data(), it->second.length());
+}
+
+std::string philote::FindClientMetadata(const grpc::ServerContextBase *context, const std::string &key)
+{
+    if (context == nullptr)
+        return string();
+
+    return FindMetadata(context->client_metadata(), key);
+}
+
+philote::WirePrecision philote::RequestedWirePrecision(const grpc::ServerContextBase *context)
+{
+    if (FindClientMetadata(context, kWirePrecisionMetadataKey) == kWirePrecisionFloat32)
+        return WirePrecision::kFloat32;
+
+    return WirePrecision::kDouble;
+}
+
+philote::WirePrecision philote::RequestedWirePrecision(const grpc::ServerContextBase *context, bool discrete)
+{
+    if (discrete and FindClientMetadata(context, kDiscreteVariablesMetadataKey) == "1")
+        return WirePrecision::kInteger;
+
+    return RequestedWirePrecision(context);
+}
+
+philote::VariableMetaData philote::DiscreteMarker(const VariableMetaData &meta)
+{
+    VariableMetaData marker;
+    marker.set_name(meta.name());
+    marker.set_type(meta.type());
+    marker.add_shape(kDiscreteMarker);
+    return marker;
+}
+
+bool philote::IsDiscreteMarker(const VariableMetaData &meta) noexcept
+{
+    return meta.shape_size() == 1 && meta.shape(0) == kDiscreteMarker;
+}
+
+bool philote::ParseIndex(const std::string &text, size_t limit, size_t &value)
+{
+    if (text.empty() || text.size() > 20)
+        return false;
+
+    size_t result = 0;
+    for (const char c : text)
+    {
+        if (c < '0' || c > '9')
+            return false;
+        result = result * 10 + static_cast<size_t>(c - '0');
+        if (result >= limit)
+            return false;
+    }
+
+    value = result;
+    return true;
+}
+
+std::vector<philote::PartialsMetaData> philote::EncodeSparsityPattern(const std::string &f,
+                                                                     const std::string &x,
+                                                                     const SparsityPattern &pattern,
+                                                                     size_t chunk_size)
+{
+    if (chunk_size == 0)
+        throw std::invalid_argument("Chunk size must be positive in EncodeSparsityPattern");
+
+    vector<PartialsMetaData> messages;
+    size_t start = 0;
+    do
+    {
+        const size_t end = std::min(start + chunk_size, pattern.nnz());
+
+        PartialsMetaData meta;
+        meta.set_name(f);
+        meta.set_subname(x);
+        meta.mutable_shape()->Reserve(static_cast<int>(3 + 2 * (end - start)));
+        meta.add_shape(kSparsePatternMarker);
+        meta.add_shape(pattern.num_cols);
+        meta.add_shape(static_cast<int64_t>(start));
+        for (size_t k = start; k < end; k++)
+            meta.add_shape(pattern.rows[k]);
+        for (size_t k = start; k < end; k++)
+            meta.add_shape(pattern.cols[k]);
+
+        messages.push_back(std::move(meta));
+        start = end;
+    } while (start < pattern.nnz());
+
+    return messages;
+}
+
+bool philote::IsSparsityPatternMessage(const PartialsMetaData &meta) noexcept
+{
+    return meta.shape_size() > 0 && meta.shape(0) == kSparsePatternMarker;
+}
+
+void philote::DecodeSparsityPattern(const PartialsMetaData &meta, SparsityPattern &pattern)
+{
+    const int size = meta.shape_size();
+    if (size < 3 || meta.shape(0) != kSparsePatternMarker || (size - 3) % 2 != 0)
+        throw std::invalid_argument("Malformed sparsity pattern for partial (" +
+                                    meta.name() + ", " + meta.subname() + ")");
+
+    if (meta.shape(1) < 0 || meta.shape(2) != static_cast<int64_t>(pattern.nnz()))
+        throw std::invalid_argument("Unexpected sparsity pattern chunk for partial (" +
+                                    meta.name() + ", " + meta.subname() + ")");
+
+    pattern.num_cols = meta.shape(1);
+
+    const int count = (size - 3) / 2;
+    pattern.rows.reserve(pattern.rows.size() + count);
+    pattern.cols.reserve(pattern.cols.size() + count);
+    for (int k = 0; k < count; k++)
+    {
+        pattern.rows.push_back(meta.shape(3 + k));
+        pattern.cols.push_back(meta.shape(3 + count + k));
+    }
+}
+
+philote::ArrayPacker::ArrayPacker(VariableType type, size_t chunk_size)
+    : type_(type), chunk_size_(chunk_size)
+{
+    if (chunk_size == 0)
+        throw std::invalid_argument("Chunk size must be positive in ArrayPacker");
+}
+
+bool philote::ArrayPacker::Add(const std::string &name, const Variable &var)
+{
+    // discrete variables are sent integer-encoded
+    const size_t n = var.Size();
+    if (n >= chunk_size_ or var.IsDiscrete())
+        return false;
+
+    // start a new message if the variable does not fit
+    if (static_cast<size_t>(current_.data_size()) + n > chunk_size_)
+    {
+        messages_.push_back(std::move(current_));
+        current_.Clear();
+    }
+
+    std::string &index = *current_.mutable_subname();
+    index += std::to_string(current_.data_size()) + "," + std::to_string(name.size()) + "," + name;
+
+    const double *values = var.data();
+    current_.mutable_data()->Add(values, values + n);
+
+    return true;
+}
+
+const std::vector<philote::Array> &philote::ArrayPacker::Finish()
+{
+    if (!current_.subname().empty())
+    {
+        messages_.push_back(std::move(current_));
+        current_.Clear();
+    }
+
+    for (Array &message : messages_)
+    {
+        message.set_type(type_);
+        message.set_start(0);
+        message.set_end(message.data_size() > 0 ? message.data_size() - 1 : 0);
+    }
+
+    return messages_;
+}
+
+bool philote::IsPackedArray(const Array &array) noexcept
+{
+    return array.name().empty();
+}
+
+namespace
+{
+    // reads a decimal number terminated by a comma
+    size_t ReadIndexNumber(const std::string &index, size_t &pos)
+    {
+        const size_t comma = index.find(',', pos);
+        size_t value = 0;
+        if (comma == string::npos ||
+            !philote::ParseIndex(index.substr(pos, comma - pos), static_cast<size_t>(std::numeric_limits<int>::max()), value))
+            throw std::invalid_argument("Malformed packed message index");
+
+        pos = comma + 1;
+        return value;
+    }
+}
+
+std::vector<philote::PackedEntry> philote::DecodePackedIndex(const Array &array)
+{
+    const std::string &index = array.subname();
+    const size_t total = static_cast<size_t>(array.data_size());
+
+    vector<PackedEntry> entries;
+    size_t pos = 0;
+    while (pos < index.size())
+    {
+        PackedEntry entry;
+        entry.offset = ReadIndexNumber(index, pos);
+        const size_t length = ReadIndexNumber(index, pos);
+        if (length == 0 || length > index.size() - pos)
+            throw std::invalid_argument("Malformed packed message index");
+
+        entry.name = index.substr(pos, length);
+        pos += length;
+
+        if (entry.offset > total || (!entries.empty() && entry.offset < entries.back().offset))
+            throw std::invalid_argument("Packed message offsets out of order or out of range");
+
+        entries.push_back(std::move(entry));
+    }
+
+    // each variable extends to the next offset
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const size_t end = i + 1 < entries.size() ? entries[i + 1].offset : total;
+        entries[i].size = end - entries[i].offset;
+    }
+
+    return entries;
+}
+
+void philote::AssignPackedEntry(const Array &array, const PackedEntry &entry, Variable &var)
+{
+    if (entry.size != var.Size() || entry.offset + entry.size > static_cast<size_t>(array.data_size()))
+        throw std::length_error("Packed variable " + entry.name + " does not match the variable size");
+
+    std::copy_n(array.data().data() + entry.offset, entry.size, var.data());
+}
@@ -0,0 +1,122 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <cstring>
+
+#include "result_cache.h"
+
+namespace
+{
+    constexpr uint64_t kPrime = 0x100000001b3ULL;
+
+    inline uint64_t Mix(uint64_t hash, uint64_t word) noexcept
+    {
+        return (hash ^ word) * kPrime;
+    }
+
+    // final avalanche step (splitmix64), so nearby inputs spread over the buckets
+    inline uint64_t Finalize(uint64_t hash) noexcept
+    {
+        hash ^= hash >> 30;
+        hash *= 0xbf58476d1ce4e5b9ULL;
+        hash ^= hash >> 27;
+        hash *= 0x94d049bb133111ebULL;
+        return hash ^ (hash >> 31);
+    }
+
+    // values of continuous and discrete variables are both 8-byte words
+    inline const char *RawValues(const philote::Variable &var) noexcept
+    {
+        if (var.IsDiscrete())
+            return reinterpret_cast<const char *>(var.discrete_data());
+        return reinterpret_cast<const char *>(var.data());
+    }
+}
+
+uint64_t philote::HashVariables(const Variables &vars, uint64_t seed) noexcept
+{
+    uint64_t hash = Mix(0xcbf29ce484222325ULL, seed);
+
+    for (const auto &var : vars)
+    {
+        for (const char c : var.first)
+            hash = Mix(hash, static_cast<unsigned char>(c));
+
+        for (const size_t extent : var.second.Shape())
+            hash = Mix(hash, extent);
+
+        // hash the values word by word
+        const char *data = RawValues(var.second);
+        for (size_t i = 0; i < var.second.Size(); i++)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i * sizeof(word), sizeof(word));
+            hash = Mix(hash, word);
+        }
+        hash = Mix(hash, var.second.IsDiscrete() ? 1 : 0);
+    }
+
+    return Finalize(hash);
+}
+
+bool philote::IdenticalVariables(const Variables &a, const Variables &b) noexcept
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib)
+    {
+        if (ia->first != ib->first or ia->second.Shape() != ib->second.Shape() or
+            ia->second.IsDiscrete() != ib->second.IsDiscrete())
+            return false;
+
+        const size_t n = ia->second.Size();
+        if (n > 0 and std::memcmp(RawValues(ia->second), RawValues(ib->second), n * sizeof(double)) != 0)
+            return false;
+    }
+
+    return true;
+}
+
+size_t philote::StorageBytes(const Variables &vars) noexcept
+{
+    size_t bytes = 0;
+    for (const auto &var : vars)
+        bytes += var.second.Size() * sizeof(double);
+    return bytes;
+}
+
+size_t philote::StorageBytes(const Partials &partials) noexcept
+{
+    size_t bytes = 0;
+    for (const auto &par : partials)
+        bytes += par.second.Size() * sizeof(double);
+    return bytes;
+}
@@ -0,0 +1,293 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "protocol_extensions.h"
+#include "shared_memory.h"
+
+using std::shared_ptr;
+using std::string;
+
+using philote::SharedMemoryCache;
+using philote::SharedMemorySegment;
+using philote::SharedMemoryTransfer;
+
+namespace
+{
+    //! prefix of all segment names
+    constexpr char kSegmentPrefix[] = "/philote-";
+
+    string SystemError(const string &what)
+    {
+        return what + ": " + std::strerror(errno);
+    }
+
+    //! Random part of the segment names of this process
+    const string &NameNonce()
+    {
+        static const string nonce = []
+        {
+            std::random_device device;
+            std::ostringstream out;
+            out << std::hex << device() << device();
+            return out.str();
+        }();
+        return nonce;
+    }
+
+    // maps an open segment and closes its descriptor
+    double *Map(int fd, size_t bytes)
+    {
+        void *data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        const int error = errno;
+        close(fd);
+
+        errno = error;
+        return data == MAP_FAILED ? nullptr : static_cast<double *>(data);
+    }
+}
+
+shared_ptr<SharedMemorySegment> SharedMemorySegment::Create(size_t size)
+{
+    static std::atomic<unsigned long> counter{0};
+
+    // mapping an empty segment is not possible
+    const size_t bytes = std::max<size_t>(size, 1) * sizeof(double);
+
+    for (int attempt = 0; attempt < 16; attempt++)
+    {
+        // the nonce tells apart processes that reuse the id of an exited one
+        const string name = kSegmentPrefix + std::to_string(getpid()) + "-" + NameNonce() + "-" +
+                            std::to_string(counter++);
+
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd < 0 and errno == EEXIST)
+            continue; // left behind by a process with the same id
+        if (fd < 0)
+            throw std::runtime_error(SystemError("Failed to create shared memory segment " + name));
+
+        struct stat info;
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0 or fstat(fd, &info) != 0)
+        {
+            const string error = SystemError("Failed to size shared memory segment " + name);
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error(error);
+        }
+
+        double *data = Map(fd, bytes);
+        if (data == nullptr)
+        {
+            const string error = SystemError("Failed to map shared memory segment " + name);
+            shm_unlink(name.c_str());
+            throw std::runtime_error(error);
+        }
+
+        return shared_ptr<SharedMemorySegment>(new SharedMemorySegment(name, data, bytes / sizeof(double), true,
+                                                                       info.st_dev, info.st_ino));
+    }
+
+    throw std::runtime_error("Failed to find an unused shared memory segment name");
+}
+
+shared_ptr<SharedMemorySegment> SharedMemorySegment::Open(const string &name)
+{
+    // only segments created by Create may be opened
+    const size_t prefix = std::strlen(kSegmentPrefix);
+    if (name.size() <= prefix or name.size() > 250 or name.compare(0, prefix, kSegmentPrefix) != 0 or
+        name.find('/', 1) != string::npos)
+        throw std::invalid_argument("Invalid shared memory segment name: " + name);
+
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        throw std::runtime_error(SystemError("Failed to open shared memory segment " + name));
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 or info.st_size < static_cast<off_t>(sizeof(double)))
+    {
+        close(fd);
+        throw std::runtime_error("Invalid shared memory segment " + name);
+    }
+
+    const size_t bytes = static_cast<size_t>(info.st_size);
+    double *data = Map(fd, bytes);
+    if (data == nullptr)
+        throw std::runtime_error(SystemError("Failed to map shared memory segment " + name));
+
+    return shared_ptr<SharedMemorySegment>(new SharedMemorySegment(name, data, bytes / sizeof(double), false,
+                                                                   info.st_dev, info.st_ino));
+}
+
+SharedMemorySegment::~SharedMemorySegment() noexcept
+{
+    munmap(data_, size_ * sizeof(double));
+    if (owner_)
+        shm_unlink(name_.c_str());
+}
+
+bool SharedMemorySegment::IsCurrent() const noexcept
+{
+    const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    const bool same = fstat(fd, &info) == 0 and static_cast<uint64_t>(info.st_dev) == device_ and
+                      static_cast<uint64_t>(info.st_ino) == inode_;
+    close(fd);
+
+    return same;
+}
+
+shared_ptr<SharedMemorySegment> SharedMemoryCache::Open(const string &name)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = segments_.begin(); it != segments_.end(); ++it)
+    {
+        if ((*it)->name() != name)
+            continue;
+
+        // a stale mapping would exchange values with an unlinked segment
+        if (!(*it)->IsCurrent())
+        {
+            segments_.erase(it);
+            break;
+        }
+
+        segments_.splice(segments_.begin(), segments_, it);
+        return segments_.front();
+    }
+
+    segments_.push_front(SharedMemorySegment::Open(name));
+    if (segments_.size() > capacity_)
+        segments_.pop_back();
+
+    return segments_.front();
+}
+
+grpc::Status SharedMemoryCache::Attach(const grpc::ServerContextBase *context, SharedMemoryTransfer &transfer)
+{
+    const string name = FindClientMetadata(context, kSharedMemoryMetadataKey);
+    if (name.empty())
+    {
+        transfer = SharedMemoryTransfer();
+        return grpc::Status::OK;
+    }
+
+    try
+    {
+        transfer = SharedMemoryTransfer(Open(name));
+    }
+    catch (const std::exception &e)
+    {
+        return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                            "Failed to attach shared memory: " + string(e.what()));
+    }
+
+    return grpc::Status::OK;
+}
+
+size_t SharedMemoryTransfer::Assign(const Array &message, Variable &var, WirePrecision precision)
+{
+    if (!segment_ or message.data_size() > 0)
+    {
+        // AssignChunk validated the indices (the data may be float32-encoded,
+        // so its size is not the number of values)
+        var.AssignChunk(message, precision);
+        return static_cast<size_t>(message.end() - message.start()) + 1;
+    }
+
+    if (message.start() < 0 or message.end() < message.start())
+        throw std::invalid_argument("Invalid indices in SharedMemoryTransfer::Assign");
+    const size_t start = static_cast<size_t>(message.start());
+    const size_t count = static_cast<size_t>(message.end()) - start + 1;
+    if (start + count > var.Size())
+        throw std::out_of_range("End index out of range in SharedMemoryTransfer::Assign");
+
+    const double *values = Reserve(count);
+    std::copy(values, values + count, var.data() + start);
+
+    return count;
+}
+
+const double *SharedMemoryTransfer::Receive(const Array &message, std::vector<double> &buffer,
+                                            WirePrecision precision)
+{
+    if (!segment_ or message.data_size() > 0)
+        return DecodeChunk(message, buffer, precision);
+
+    if (message.start() < 0 or message.end() < message.start())
+        throw std::invalid_argument("Invalid indices in SharedMemoryTransfer::Receive");
+
+    return Reserve(static_cast<size_t>(message.end() - message.start()) + 1);
+}
+
+double *SharedMemoryTransfer::Reserve(size_t count)
+{
+    if (count > segment_->size() - offset_)
+        throw std::length_error("Shared memory segment " + segment_->name() + " is too small (" +
+                                std::to_string(segment_->size()) + " values)");
+
+    double *values = segment_->data() + offset_;
+    offset_ += count;
+
+    return values;
+}
+
+std::string philote::SharedMemoryHostId()
+{
+    static const string id = []
+    {
+        char host[256] = {};
+        gethostname(host, sizeof(host) - 1);
+
+        // the boot id distinguishes hosts with the same name (e.g., default container names)
+        string boot_id;
+        std::ifstream file("/proc/sys/kernel/random/boot_id");
+        std::getline(file, boot_id);
+
+        return string(host) + "/" + boot_id;
+    }();
+
+    return id;
+}
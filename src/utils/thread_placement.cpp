@@ -0,0 +1,217 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "thread_placement.h"
+
+using std::string;
+using std::vector;
+
+using philote::AffinityScope;
+using philote::PlacementPolicy;
+using philote::ThreadPlacement;
+
+namespace
+{
+    //! directory of the NUMA nodes in sysfs
+    constexpr char kNodeDirectory[] = "/sys/devices/system/node/";
+
+    // reads the first line of a sysfs file (empty if it does not exist)
+    string ReadLine(const string &path)
+    {
+        std::ifstream file(path);
+        string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    vector<int> ToCpus(const cpu_set_t &set)
+    {
+        vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    // false if a CPU id exceeds the set
+    bool ToSet(const vector<int> &cpus, cpu_set_t &set)
+    {
+        CPU_ZERO(&set);
+        for (int cpu : cpus)
+        {
+            if (cpu < 0 or cpu >= CPU_SETSIZE)
+                return false;
+            CPU_SET(cpu, &set);
+        }
+        return true;
+    }
+}
+
+vector<int> philote::AvailableCpus()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+        return {};
+
+    return ToCpus(set);
+}
+
+vector<int> philote::ParseCpuList(const string &text)
+{
+    vector<int> cpus;
+    std::istringstream list(text);
+    string range;
+    while (std::getline(list, range, ','))
+    {
+        if (range.empty())
+            continue;
+
+        size_t first_end = 0, last_end = 0;
+        int first = 0, last = 0;
+        try
+        {
+            const size_t dash = range.find('-');
+            first = std::stoi(range.substr(0, dash), &first_end);
+            last = first;
+            if (dash != string::npos)
+            {
+                last = std::stoi(range.substr(dash + 1), &last_end);
+                if (last_end != range.size() - dash - 1)
+                    throw std::invalid_argument(range);
+            }
+            else if (first_end != range.size())
+                throw std::invalid_argument(range);
+        }
+        catch (const std::exception &)
+        {
+            throw std::invalid_argument("Invalid CPU list '" + text + "'");
+        }
+
+        if (first < 0 or last < first)
+            throw std::invalid_argument("Invalid CPU list '" + text + "'");
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+vector<vector<int>> philote::NumaNodeCpus(const vector<int> &cpus)
+{
+    const std::set<int> allowed(cpus.begin(), cpus.end());
+
+    vector<vector<int>> nodes;
+    try
+    {
+        for (int node : ParseCpuList(ReadLine(string(kNodeDirectory) + "online")))
+        {
+            vector<int> node_cpus;
+            for (int cpu : ParseCpuList(ReadLine(string(kNodeDirectory) + "node" + std::to_string(node) + "/cpulist")))
+            {
+                if (allowed.count(cpu) > 0)
+                    node_cpus.push_back(cpu);
+            }
+
+            if (!node_cpus.empty())
+                nodes.push_back(std::move(node_cpus));
+        }
+    }
+    catch (const std::invalid_argument &)
+    {
+        nodes.clear();
+    }
+
+    // without NUMA information, all CPUs form one node
+    if (nodes.empty() and !cpus.empty())
+        nodes.push_back(cpus);
+
+    return nodes;
+}
+
+vector<vector<int>> philote::PlacementSlots(const ThreadPlacement &placement)
+{
+    if (placement.policy == PlacementPolicy::kNone)
+        return {};
+
+    const vector<int> cpus = placement.cpus.empty() ? AvailableCpus() : placement.cpus;
+    if (cpus.empty())
+        throw std::invalid_argument("No CPUs to place the discipline instances on");
+
+    if (placement.policy == PlacementPolicy::kNumaNodes)
+        return NumaNodeCpus(cpus);
+
+    vector<vector<int>> slots;
+    for (int cpu : cpus)
+        slots.push_back({cpu});
+    return slots;
+}
+
+AffinityScope::AffinityScope(const vector<int> &cpus) noexcept
+{
+    if (cpus.empty())
+        return;
+
+    try
+    {
+        cpu_set_t previous, set;
+        if (!ToSet(cpus, set) or pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) != 0)
+            return;
+
+        previous_ = ToCpus(previous);
+        pinned_ = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+    catch (const std::exception &)
+    {
+        // placement is an optimization, so the thread stays where it is
+        pinned_ = false;
+    }
+}
+
+AffinityScope::~AffinityScope() noexcept
+{
+    if (!pinned_)
+        return;
+
+    cpu_set_t set;
+    if (ToSet(previous_, set))
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
@@ -0,0 +1,106 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <stdexcept>
+
+#include "thread_pool.h"
+
+using philote::ThreadPool;
+
+ThreadPool::ThreadPool(size_t threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; i++)
+        workers_.emplace_back(&ThreadPool::Work, this);
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    available_.notify_all();
+
+    for (std::thread &worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    if (!task)
+        throw std::invalid_argument("ThreadPool::Submit requires a task");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_)
+            throw std::runtime_error("ThreadPool::Submit called on a stopped pool");
+        tasks_.push_back(std::move(task));
+    }
+    available_.notify_one();
+}
+
+size_t ThreadPool::size() const noexcept
+{
+    return workers_.size();
+}
+
+void ThreadPool::Work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this]
+                            { return stopping_ or !tasks_.empty(); });
+
+            // finish the queued tasks before stopping
+            if (tasks_.empty())
+                return;
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            // tasks report their own errors
+        }
+    }
+}
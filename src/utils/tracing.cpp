@@ -0,0 +1,174 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <algorithm>
+#include <utility>
+
+#include "tracing.h"
+
+using std::string;
+using std::chrono::duration_cast;
+using std::chrono::system_clock;
+
+using philote::CallMetrics;
+using philote::ClientCallSpan;
+using philote::ServerCallSpan;
+using philote::TraceContext;
+
+namespace
+{
+    // checks for lowercase hex digits that are not all zero
+    bool IsTraceId(const string &id, size_t length)
+    {
+        if (id.size() != length)
+            return false;
+
+        bool nonzero = false;
+        for (const char c : id)
+        {
+            if (!((c >= '0' and c <= '9') or (c >= 'a' and c <= 'f')))
+                return false;
+            nonzero = nonzero or c != '0';
+        }
+
+        return nonzero;
+    }
+}
+
+bool TraceContext::valid() const noexcept
+{
+    return IsTraceId(trace_id, 32) and IsTraceId(span_id, 16);
+}
+
+string philote::FormatTraceparent(const TraceContext &context)
+{
+    return "00-" + context.trace_id + "-" + context.span_id + (context.sampled ? "-01" : "-00");
+}
+
+bool philote::ParseTraceparent(const string &header, TraceContext &context)
+{
+    // version-traceid-spanid-flags
+    if (header.size() != 55 or header.compare(0, 3, "00-") != 0 or header[35] != '-' or header[52] != '-')
+        return false;
+
+    TraceContext parsed;
+    parsed.trace_id = header.substr(3, 32);
+    parsed.span_id = header.substr(36, 16);
+
+    const string flags = header.substr(53, 2);
+    if (!parsed.valid() or !std::all_of(flags.begin(), flags.end(), [](char c)
+                                        { return (c >= '0' and c <= '9') or (c >= 'a' and c <= 'f'); }))
+        return false;
+    parsed.sampled = (std::stoi(flags, nullptr, 16) & 0x01) != 0;
+
+    context = parsed;
+    return true;
+}
+
+ClientCallSpan::ClientCallSpan(Tracer *tracer, const TraceContext &parent, const string &rpc,
+                               grpc::ClientContext &context)
+{
+    if (tracer != nullptr)
+        span_ = tracer->StartSpan(rpc, SpanKind::kClient, parent, system_clock::now());
+
+    // the server continues the trace of the call, or else of the parent
+    const TraceContext propagated = span_ ? span_->context() : parent;
+    if (propagated.valid())
+        context.AddMetadata(kTraceparentMetadataKey, FormatTraceparent(propagated));
+}
+
+ClientCallSpan::ClientCallSpan(Tracer *tracer, const TraceContext &parent, const string &rpc)
+{
+    if (tracer != nullptr)
+        span_ = tracer->StartSpan(rpc, SpanKind::kClient, parent, system_clock::now());
+}
+
+ClientCallSpan &ClientCallSpan::operator=(ClientCallSpan &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (span_)
+            span_->End(grpc::Status(grpc::StatusCode::ABORTED, "Call abandoned"), system_clock::now());
+        span_ = std::move(other.span_);
+    }
+    return *this;
+}
+
+ClientCallSpan::~ClientCallSpan()
+{
+    if (span_)
+        span_->End(grpc::Status(grpc::StatusCode::ABORTED, "Call abandoned"), system_clock::now());
+}
+
+void ClientCallSpan::Finish(const grpc::Status &status)
+{
+    if (!span_)
+        return;
+
+    span_->End(status, system_clock::now());
+    span_.reset();
+}
+
+ServerCallSpan::ServerCallSpan(Tracer *tracer, const grpc::ServerContextBase *context, const string &rpc)
+    : tracer_(tracer), start_(system_clock::now())
+{
+    if (tracer_ == nullptr)
+        return;
+
+    TraceContext parent;
+    ParseTraceparent(FindClientMetadata(context, kTraceparentMetadataKey), parent);
+    span_ = tracer_->StartSpan(rpc, SpanKind::kServer, parent, start_);
+}
+
+void ServerCallSpan::Finish(const CallMetrics &metrics)
+{
+    if (!span_)
+        return;
+
+    const grpc::Status ok = grpc::Status::OK;
+    const TraceContext parent = span_->context();
+    system_clock::time_point begin = start_;
+
+    // consecutive child spans for the phases of the call
+    const std::pair<const char *, std::chrono::nanoseconds> phases[] = {
+        {"receive", metrics.receive}, {"compute", metrics.compute}, {"send", metrics.send}};
+    for (const auto &phase : phases)
+    {
+        const system_clock::time_point end = begin + duration_cast<system_clock::duration>(phase.second);
+        std::unique_ptr<Span> child = tracer_->StartSpan(metrics.rpc + "/" + phase.first,
+                                                         SpanKind::kInternal, parent, begin);
+        if (child)
+            child->End(ok, end);
+        begin = end;
+    }
+
+    span_->End(grpc::Status(metrics.status, ""), begin);
+    span_.reset();
+}
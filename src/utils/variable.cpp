@@ -28,6 +28,12 @@
     therein. The DoD does not exercise any editorial, security, or other
     control over the information you may find at these locations.
 */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "chunk_pipeline.h"
 #include "variable.h"
 
 using grpc::ClientReaderWriter;
@@ -88,12 +94,132 @@ Variable::Variable(const philote::PartialsMetaData &meta)
     data_.resize(size);
 }
 
+Variable::Variable(const philote::VariableType &type,
+                   const std::vector<size_t> &shape,
+                   double *data)
+{
+    type_ = type;
+    shape_ = shape;
+
+    size_t size = 1;
+    for (unsigned long i : shape_)
+        size *= i;
+
+    if (!data && size > 0)
+        throw std::invalid_argument("Null storage for a variable view");
+
+    view_ = data;
+    view_size_ = size;
+}
+
+Variable::Variable(const philote::VariableType &type,
+                   const std::vector<size_t> &shape,
+                   std::shared_ptr<MappedFile> file,
+                   size_t offset)
+{
+    type_ = type;
+    shape_ = shape;
+
+    size_t size = 1;
+    for (unsigned long i : shape_)
+        size *= i;
+
+    if (!file)
+        throw std::invalid_argument("Null file for a file-backed variable");
+    if (offset > file->size() or file->size() - offset < size)
+        throw std::invalid_argument("Mapped file too small for the variable");
+
+    view_ = file->data() + offset;
+    view_size_ = size;
+    file_ = std::move(file);
+    file_offset_ = offset;
+}
+
+Variable::Variable(const philote::VariableType &type,
+                   const std::vector<size_t> &shape,
+                   DiscreteTag)
+{
+    type_ = type;
+    shape_ = shape;
+    discrete_ = true;
+
+    size_t size = 1;
+    for (unsigned long i : shape_)
+        size *= i;
+
+    discrete_data_.resize(size);
+}
+
+Variable::Variable(const Variable &other)
+    : type_(other.type_),
+      shape_(other.shape_),
+      discrete_(other.discrete_),
+      discrete_data_(other.discrete_data_)
+{
+    if (!discrete_)
+        data_.assign(other.data(), other.data() + other.Size());
+}
+
+Variable::Variable(Variable &&other) noexcept
+    : type_(other.type_),
+      shape_(std::move(other.shape_)),
+      data_(std::move(other.data_)),
+      view_(other.view_),
+      view_size_(other.view_size_),
+      file_(std::move(other.file_)),
+      file_offset_(other.file_offset_),
+      discrete_(other.discrete_),
+      discrete_data_(std::move(other.discrete_data_))
+{
+    other.view_ = nullptr;
+    other.view_size_ = 0;
+}
+
+Variable &Variable::operator=(const Variable &other)
+{
+    if (this != &other)
+    {
+        type_ = other.type_;
+        shape_ = other.shape_;
+        if (other.discrete_)
+            data_.clear();
+        else
+            data_.assign(other.data(), other.data() + other.Size());
+        discrete_ = other.discrete_;
+        discrete_data_ = other.discrete_data_;
+        view_ = nullptr;
+        view_size_ = 0;
+        file_.reset();
+        file_offset_ = 0;
+    }
+    return *this;
+}
+
+Variable &Variable::operator=(Variable &&other) noexcept
+{
+    if (this != &other)
+    {
+        type_ = other.type_;
+        shape_ = std::move(other.shape_);
+        data_ = std::move(other.data_);
+        discrete_ = other.discrete_;
+        discrete_data_ = std::move(other.discrete_data_);
+        view_ = other.view_;
+        view_size_ = other.view_size_;
+        file_ = std::move(other.file_);
+        file_offset_ = other.file_offset_;
+        other.view_ = nullptr;
+        other.view_size_ = 0;
+    }
+    return *this;
+}
+
 void Variable::Segment(const size_t &start, const size_t &end,
                        const std::vector<double> &data)
 {
     if (start > end)
         throw std::invalid_argument("Start index greater than end index in Variable::Segment");
-    if (end >= data_.size())
+    if (end >= Size())
         throw std::out_of_range("End index out of range in Variable::Segment");
     if (data.size() == 0 && start > end)
         return; // allow empty segment for start > end as a no-op
@@ -104,19 +230,31 @@ void Variable::Segment(const size_t &start, const size_t &end,
         throw std::length_error("Vector data has incompatable length. Should be " +
                                 expected + ", but received " + actual + ".");
     }
+    if (discrete_)
+    {
+        for (size_t i = 0; i < (end - start) + 1; i++)
+            discrete_data_[start + i] = std::llround(data[i]);
+        return;
+    }
     for (size_t i = 0; i < (end - start) + 1; i++)
-        data_.at(start + i) = data[i];
+        this->data()[start + i] = data[i];
 }
 
 std::vector<double> Variable::Segment(const size_t &start, const size_t &end) const
 {
     if (start > end)
         throw std::invalid_argument("Start index greater than end index in Variable::Segment getter");
-    if (end >= data_.size())
+    if (end >= Size())
         throw std::out_of_range("End index out of range in Variable::Segment getter");
     std::vector<double> data(end - start + 1);
+    if (discrete_)
+    {
+        for (size_t i = 0; i < (end - start) + 1; i++)
+            data[i] = static_cast<double>(discrete_data_[start + i]);
+        return data;
+    }
     for (size_t i = 0; i < (end - start) + 1; i++)
-        data[i] = data_.at(start + i);
+        data[i] = this->data()[start + i];
     return data;
 }
 
@@ -127,135 +265,547 @@ std::vector<size_t> Variable::Shape() const noexcept
 
 size_t Variable::Size() const noexcept
 {
-    return data_.size();
+    if (discrete_)
+        return discrete_data_.size();
+    return view_ ? view_size_ : data_.size();
+}
+
+void Variable::Fill(double value) noexcept
+{
+    if (discrete_)
+        std::fill(discrete_data_.begin(), discrete_data_.end(), std::llround(value));
+    else
+        std::fill(data(), data() + Size(), value);
+}
+
+double *Variable::data() noexcept
+{
+    if (discrete_)
+        return nullptr;
+    return view_ ? view_ : data_.data();
+}
+
+const double *Variable::data() const noexcept
+{
+    if (discrete_)
+        return nullptr;
+    return view_ ? view_ : data_.data();
+}
+
+philote::ArrayView<double> Variable::values() noexcept
+{
+    return discrete_ ? ArrayView<double>() : ArrayView<double>(data(), Size());
+}
+
+philote::ArrayView<const double> Variable::values() const noexcept
+{
+    return discrete_ ? ArrayView<const double>() : ArrayView<const double>(data(), Size());
+}
+
+bool Variable::IsDiscrete() const noexcept
+{
+    return discrete_;
+}
+
+int64_t *Variable::discrete_data() noexcept
+{
+    return discrete_ ? discrete_data_.data() : nullptr;
+}
+
+const int64_t *Variable::discrete_data() const noexcept
+{
+    return discrete_ ? discrete_data_.data() : nullptr;
+}
+
+philote::ArrayView<int64_t> Variable::discrete_values() noexcept
+{
+    return discrete_ ? ArrayView<int64_t>(discrete_data_.data(), discrete_data_.size()) : ArrayView<int64_t>();
+}
+
+philote::ArrayView<const int64_t> Variable::discrete_values() const noexcept
+{
+    return discrete_ ? ArrayView<const int64_t>(discrete_data_.data(), discrete_data_.size()) : ArrayView<const int64_t>();
+}
+
+int64_t Variable::Discrete(const size_t &i) const
+{
+    if (!discrete_)
+        throw std::logic_error("Variable is not discrete in Variable::Discrete() const");
+    if (i >= Size())
+        throw std::out_of_range("Index out of range in Variable::Discrete() const");
+    return discrete_data_[i];
+}
+
+int64_t &Variable::Discrete(const size_t &i)
+{
+    if (!discrete_)
+        throw std::logic_error("Variable is not discrete in Variable::Discrete() non-const");
+    if (i >= Size())
+        throw std::out_of_range("Index out of range in Variable::Discrete() non-const");
+    return discrete_data_[i];
+}
+
+philote::VariableType Variable::Type() const noexcept
+{
+    return type_;
+}
+
+bool Variable::IsView() const noexcept
+{
+    return view_ != nullptr;
+}
+
+bool Variable::IsFileBacked() const noexcept
+{
+    return file_ != nullptr;
+}
+
+void Variable::ReleasePages(size_t start, size_t end) const noexcept
+{
+    if (file_)
+        file_->Release(file_offset_ + start, file_offset_ + end);
 }
 
 double Variable::operator()(const size_t &i) const
 {
-    if (i >= data_.size())
+    if (discrete_)
+        throw std::logic_error("Variable is discrete in Variable::operator() const; use Discrete()");
+    if (i >= Size())
         throw std::out_of_range("Index out of range in Variable::operator() const");
-    return data_.at(i);
+    return data()[i];
 }
 
 double &Variable::operator()(const size_t &i)
 {
-    if (i >= data_.size())
+    if (discrete_)
+        throw std::logic_error("Variable is discrete in Variable::operator() non-const; use Discrete()");
+    if (i >= Size())
         throw std::out_of_range("Index out of range in Variable::operator() non-const");
-    return data_.at(i);
+    return data()[i];
 }
 
 Array Variable::CreateChunk(const size_t &start, const size_t &end) const
 {
     philote::Array out;
+    CreateChunk(start, end, out);
+    return out;
+}
 
-    out.set_start(start);
-    out.set_end(end);
-    out.set_type(type_);  // Set the variable type
+namespace
+{
+    //! Returns the bits of a value rounded to float32
+    inline uint32_t Float32Bits(double value) noexcept
+    {
+        const float rounded = static_cast<float>(value);
+        uint32_t bits;
+        std::memcpy(&bits, &rounded, sizeof(bits));
+        return bits;
+    }
 
-    // set the data
-    const vector<double> segment = Segment(start, end);
-    for (const double value : segment)
-        out.add_data(value);
+    //! Returns the value of float32 bits
+    inline double Float32Value(uint32_t bits) noexcept
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
 
-    return out;
+    //! Number of message doubles holding n float32-encoded values
+    inline size_t Float32WireSize(size_t n) noexcept
+    {
+        return (n + 1) / 2;
+    }
+
+    /**
+     * @brief Packs values as float32 pairs into doubles
+     *
+     * Value 2i is stored in the low and value 2i + 1 in the high half of the
+     * bits of out[i]. The pairs are combined as integers, so the layout does
+     * not depend on the byte order of the host. The loops are free of
+     * branches and vectorize.
+     */
+    void PackFloat32(const double *values, size_t n, double *out) noexcept
+    {
+        const size_t pairs = n / 2;
+        for (size_t i = 0; i < pairs; i++)
+        {
+            const uint64_t word = static_cast<uint64_t>(Float32Bits(values[2 * i])) |
+                                  static_cast<uint64_t>(Float32Bits(values[2 * i + 1])) << 32;
+            std::memcpy(out + i, &word, sizeof(word));
+        }
+
+        if (n % 2 == 1)
+        {
+            const uint64_t word = Float32Bits(values[n - 1]);
+            std::memcpy(out + pairs, &word, sizeof(word));
+        }
+    }
+
+    //! Unpacks values packed by PackFloat32
+    void UnpackFloat32(const double *packed, size_t n, double *values) noexcept
+    {
+        const size_t pairs = n / 2;
+        for (size_t i = 0; i < pairs; i++)
+        {
+            uint64_t word;
+            std::memcpy(&word, packed + i, sizeof(word));
+            values[2 * i] = Float32Value(static_cast<uint32_t>(word));
+            values[2 * i + 1] = Float32Value(static_cast<uint32_t>(word >> 32));
+        }
+
+        if (n % 2 == 1)
+        {
+            uint64_t word;
+            std::memcpy(&word, packed + pairs, sizeof(word));
+            values[n - 1] = Float32Value(static_cast<uint32_t>(word));
+        }
+    }
+
+    //! Maps signed integers to unsigned ones, so that small magnitudes have short varints
+    inline uint64_t ZigZag(int64_t value) noexcept
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    //! Inverts ZigZag
+    inline int64_t UnZigZag(uint64_t bits) noexcept
+    {
+        return static_cast<int64_t>(bits >> 1) ^ -static_cast<int64_t>(bits & 1);
+    }
+
+    /**
+     * @brief Packs integers as zigzag varints into doubles
+     *
+     * Byte k of the varint stream is stored in bits [8 (k % 8), 8 (k % 8) + 8)
+     * of out[k / 8], so the layout does not depend on the byte order of the
+     * host. The last double is zero-padded.
+     *
+     * @param value returns the integer at an index
+     * @param n number of integers
+     * @param out message data (replaced)
+     */
+    template <class Value>
+    void PackVarints(Value value, size_t n, google::protobuf::RepeatedField<double> *out)
+    {
+        out->Clear();
+        out->Reserve(static_cast<int>((n + 7) / 8));
+
+        uint64_t word = 0;
+        unsigned shift = 0;
+        auto put = [&word, &shift, out](uint64_t byte)
+        {
+            word |= byte << shift;
+            shift += 8;
+            if (shift == 64)
+            {
+                double packed;
+                std::memcpy(&packed, &word, sizeof(packed));
+                out->Add(packed);
+                word = 0;
+                shift = 0;
+            }
+        };
+
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t bits = ZigZag(value(i));
+            while (bits >= 0x80)
+            {
+                put((bits & 0x7f) | 0x80);
+                bits >>= 7;
+            }
+            put(bits);
+        }
+
+        if (shift > 0)
+        {
+            double packed;
+            std::memcpy(&packed, &word, sizeof(packed));
+            out->Add(packed);
+        }
+    }
+
+    /**
+     * @brief Unpacks integers packed by PackVarints
+     *
+     * @param data message data
+     * @param n number of integers
+     * @param store receives the index and the value of every integer
+     * @return false if the data does not hold exactly n integers
+     */
+    template <class Store>
+    bool UnpackVarints(const google::protobuf::RepeatedField<double> &data, size_t n, Store store)
+    {
+        const size_t bytes = static_cast<size_t>(data.size()) * sizeof(double);
+        auto byte_at = [&data](size_t k)
+        {
+            uint64_t word;
+            std::memcpy(&word, data.data() + k / 8, sizeof(word));
+            return (word >> (8 * (k % 8))) & 0xff;
+        };
+
+        size_t k = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t bits = 0;
+            for (unsigned shift = 0;; shift += 7)
+            {
+                // a varint has at most ten bytes
+                if (k == bytes or shift > 63)
+                    return false;
+
+                const uint64_t byte = byte_at(k++);
+                bits |= (byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                    break;
+            }
+            store(i, UnZigZag(bits));
+        }
+
+        // only the zero padding of the last double may follow
+        if ((k + 7) / 8 != static_cast<size_t>(data.size()))
+            return false;
+        for (; k < bytes; k++)
+        {
+            if (byte_at(k) != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    //! Number of values per message of a chunk size (see WirePrecision)
+    inline size_t ValuesPerChunk(size_t chunk_size, WirePrecision precision) noexcept
+    {
+        // float32 values take half a double each, varints up to ten bytes
+        if (precision == WirePrecision::kFloat32)
+            return 2 * chunk_size;
+        if (precision == WirePrecision::kInteger)
+            return std::max<size_t>(chunk_size * 4 / 5, 1);
+        return chunk_size;
+    }
 }
 
-void Variable::Send(string name,
-                    string subname,
-                    ClientReaderWriter<Array, Array> *stream,
-                    const size_t &chunk_size) const
+void Variable::CreateChunk(const size_t &start, const size_t &end, Array &chunk,
+                           WirePrecision precision) const
 {
-    Array array;
+    if (start > end)
+        throw std::invalid_argument("Start index greater than end index in Variable::CreateChunk");
+    if (end >= Size())
+        throw std::out_of_range("End index out of range in Variable::CreateChunk");
+
+    chunk.set_start(start);
+    chunk.set_end(end);
+    chunk.set_type(type_);  // Set the variable type
 
-    size_t start, end;
-    size_t n = Size();
+    google::protobuf::RepeatedField<double> *values = chunk.mutable_data();
+    const size_t n = end - start + 1;
+    if (precision == WirePrecision::kInteger)
+    {
+        // the subname marks the encoding, so it cannot hold another one
+        if (!chunk.subname().empty() and !IsDiscreteChunk(chunk))
+            throw std::invalid_argument("Integer-encoded chunks cannot carry the subname '" +
+                                        chunk.subname() + "' in Variable::CreateChunk");
+        chunk.set_subname(kDiscreteChunkSubname);
+        if (discrete_)
+        {
+            const int64_t *integers = discrete_data_.data() + start;
+            PackVarints([integers](size_t i) { return integers[i]; }, n, values);
+        }
+        else
+        {
+            const double *first = data() + start;
+            PackVarints([first](size_t i) { return static_cast<int64_t>(std::llround(first[i])); }, n, values);
+        }
+        return;
+    }
 
-    // find the chunk indices and create the chunk
-    size_t num_chunks = n / chunk_size;
-    if (num_chunks == 0)
-        num_chunks = 1;
+    // reused messages may still carry the subname of an integer-encoded chunk
+    if (IsDiscreteChunk(chunk))
+        chunk.clear_subname();
 
-    for (size_t i = 0; i < num_chunks; i++)
+    if (discrete_)
     {
-        start = i * chunk_size;
-        end = start + chunk_size - 1;  // end is inclusive
-        if (end >= n)
-            end = n - 1;
+        // peers without integer encoding receive the values as doubles
+        values->Resize(static_cast<int>(n), 0.0);
+        std::copy_n(discrete_data_.data() + start, n, values->mutable_data());
+        return;
+    }
+
+    // copy the segment straight from the variable storage into the message.
+    // Clear() keeps the capacity of the repeated field, so reusing the same
+    // chunk message for consecutive chunks does not reallocate.
+    const double *first = data() + start;
+    const double *last = data() + end + 1;
+    values->Clear();
 
-        array = CreateChunk(start, end);
+    if (precision == WirePrecision::kFloat32 and n > 1)
+    {
+        values->Resize(static_cast<int>(Float32WireSize(n)), 0.0);
+        PackFloat32(first, n, values->mutable_data());
+        return;
+    }
+
+    values->Reserve(static_cast<int>(last - first));
+    values->Add(first, last);
+}
+
+namespace
+{
+    /**
+     * @brief Writes a variable to a stream in chunks of at most chunk_size
+     * elements, reusing a single Array message for all chunks.
+     *
+     * @param var variable to send
+     * @param name variable name
+     * @param subname variable subname (for partials)
+     * @param stream stream to write to
+     * @param chunk_size maximum number of doubles per message
+     * @param context optional server context used to detect cancellation
+     * @param precision precision of the values in the messages
+     */
+    template <class StreamType>
+    void SendChunks(const Variable &var,
+                    const string &name,
+                    const string &subname,
+                    StreamType *stream,
+                    size_t chunk_size,
+                    grpc::ServerContextBase *context,
+                    WirePrecision precision)
+    {
+        if (chunk_size == 0)
+            throw std::invalid_argument("Chunk size must be greater than zero in Variable::Send");
+
+        chunk_size = ValuesPerChunk(chunk_size, precision);
+
+        const size_t n = var.Size();
+
+        // round up so that the tail of the variable is sent as a short chunk
+        size_t num_chunks = (n + chunk_size - 1) / chunk_size;
+        if (num_chunks == 0)
+            num_chunks = 1;
+
+        // the name and subname are the same for every chunk, so they are only
+        // set once on the reused message
+        Array array;
         array.set_name(name);
         array.set_subname(subname);
-        if (!stream->Write(array))
+
+        for (size_t i = 0; i < num_chunks; i++)
         {
-            throw std::runtime_error(
-                "Failed to write variable '" + name +
-                "' to stream (chunk " + std::to_string(i + 1) +
-                " of " + std::to_string(num_chunks) + ")");
+            // Check for cancellation before processing each chunk
+            if (context != nullptr && context->IsCancelled())
+            {
+                throw std::runtime_error(
+                    "Operation cancelled while sending variable '" + name +
+                    "' (chunk " + std::to_string(i + 1) +
+                    " of " + std::to_string(num_chunks) + ")");
+            }
+
+            const size_t start = i * chunk_size;
+            size_t end = start + chunk_size - 1; // end is inclusive
+            if (end >= n)
+                end = n - 1;
+
+            var.CreateChunk(start, end, array, precision);
+            var.ReleasePages(start, end);
+            if (!stream->Write(array))
+            {
+                throw std::runtime_error(
+                    "Failed to write variable '" + name +
+                    "' to stream (chunk " + std::to_string(i + 1) +
+                    " of " + std::to_string(num_chunks) + ")");
+            }
         }
     }
 }
 
+void Variable::Send(string name,
+                    string subname,
+                    ClientReaderWriter<Array, Array> *stream,
+                    const size_t &chunk_size,
+                    WirePrecision precision) const
+{
+    SendChunks(*this, name, subname, stream, chunk_size, nullptr, precision);
+}
+
 void philote::Variable::Send(std::string name,
                              std::string subname,
                              grpc::ServerReaderWriterInterface<::philote::Array, ::philote::Array> *stream,
                              const size_t &chunk_size,
-                             grpc::ServerContext* context) const
-{
-    Array array;
-    size_t start = 0, end;
-    size_t n = Size();
-    size_t num_chunks = n / chunk_size;
-    if (num_chunks == 0)
-        num_chunks = 1;
-    for (size_t i = 0; i < num_chunks; i++)
+                             grpc::ServerContextBase* context,
+                             WirePrecision precision) const
+{
+    SendChunks(*this, name, subname, stream, chunk_size, context, precision);
+}
+
+void philote::Variable::Send(std::string name,
+                             std::string subname,
+                             grpc::ClientReaderWriterInterface<::philote::Array, ::philote::Array> *stream,
+                             const size_t &chunk_size,
+                             WirePrecision precision) const
+{
+    SendChunks(*this, name, subname, stream, chunk_size, nullptr, precision);
+}
+
+namespace
+{
+    //! Adapter that collects the chunks written by SendChunks
+    class MessageList
     {
-        // Check for cancellation before processing each chunk
-        if (context != nullptr && context->IsCancelled())
-        {
-            throw std::runtime_error(
-                "Operation cancelled while sending variable '" + name +
-                "' (chunk " + std::to_string(i + 1) +
-                " of " + std::to_string(num_chunks) + ")");
-        }
+    public:
+        explicit MessageList(vector<Array> *messages) : messages_(messages) {}
 
-        start = i * chunk_size;
-        end = start + chunk_size - 1;  // end is inclusive
-        if (end >= n)
-            end = n - 1;
-        array = CreateChunk(start, end);
-        array.set_name(name);
-        array.set_subname(subname);
-        if (!stream->Write(array))
+        bool Write(const Array &array)
         {
-            throw std::runtime_error(
-                "Failed to write variable '" + name +
-                "' to stream (chunk " + std::to_string(i + 1) +
-                " of " + std::to_string(num_chunks) + ")");
+            messages_->push_back(array);
+            return true;
         }
-    }
+
+    private:
+        vector<Array> *messages_;
+    };
 }
 
 void philote::Variable::Send(std::string name,
                              std::string subname,
-                             grpc::ClientReaderWriterInterface<::philote::Array, ::philote::Array> *stream,
-                             const size_t &chunk_size) const
-{
-    Array array;
-    size_t start = 0, end;
-    size_t n = Size();
-    size_t num_chunks = n / chunk_size;
-    if (num_chunks == 0)
-        num_chunks = 1;
+                             std::vector<::philote::Array> *messages,
+                             const size_t &chunk_size,
+                             WirePrecision precision) const
+{
+    MessageList list(messages);
+    SendChunks(*this, name, subname, &list, chunk_size, nullptr, precision);
+}
+
+void philote::Variable::Send(std::string name,
+                             std::string subname,
+                             ChunkPipeline *pipeline,
+                             const size_t &chunk_size,
+                             WirePrecision precision) const
+{
+    if (chunk_size == 0)
+        throw std::invalid_argument("Chunk size must be greater than zero in Variable::Send");
+
+    const size_t values_per_chunk = ValuesPerChunk(chunk_size, precision);
+
+    const size_t n = Size();
+    const size_t num_chunks = std::max<size_t>((n + values_per_chunk - 1) / values_per_chunk, 1);
+
     for (size_t i = 0; i < num_chunks; i++)
     {
-        start = i * chunk_size;
-        end = start + chunk_size - 1;  // end is inclusive
+        const size_t start = i * values_per_chunk;
+        size_t end = start + values_per_chunk - 1; // end is inclusive
         if (end >= n)
             end = n - 1;
-        array = CreateChunk(start, end);
+
+        // recycled messages keep their buffers, so only the payload is copied
+        Array array = pipeline->Acquire();
         array.set_name(name);
         array.set_subname(subname);
-        if (!stream->Write(array))
+        CreateChunk(start, end, array, precision);
+        ReleasePages(start, end);
+
+        if (!pipeline->Write(std::move(array)))
         {
             throw std::runtime_error(
                 "Failed to write variable '" + name +
@@ -265,7 +815,7 @@ void philote::Variable::Send(std::string name,
     }
 }
 
-void Variable::AssignChunk(const Array &data)
+void Variable::AssignChunk(const Array &data, WirePrecision precision)
 {
     // Validate indices are non-negative before casting to size_t
     // This prevents integer overflow attacks where negative values wrap to SIZE_MAX
@@ -279,11 +829,136 @@ void Variable::AssignChunk(const Array &data)
 
     if (start > end)
         throw std::invalid_argument("Start index greater than end index in Variable::AssignChunk");
-    if (end >= data_.size())
+    if (end >= Size())
         throw std::out_of_range("End index out of range in Variable::AssignChunk");
-    if (data.data_size() != static_cast<int>((end - start + 1)))
+
+    const size_t n = end - start + 1;
+    const size_t size = static_cast<size_t>(data.data_size());
+    if (IsDiscreteChunk(data))
+    {
+        bool valid;
+        if (discrete_)
+        {
+            int64_t *integers = discrete_data_.data() + start;
+            valid = UnpackVarints(data.data(), n, [integers](size_t i, int64_t value) { integers[i] = value; });
+        }
+        else
+        {
+            double *values = this->data() + start;
+            valid = UnpackVarints(data.data(), n, [values](size_t i, int64_t value)
+                                  { values[i] = static_cast<double>(value); });
+        }
+        if (!valid)
+            throw std::length_error("Malformed integer chunk in Variable::AssignChunk");
+    }
+    else if (discrete_)
+    {
+        // values of peers without integer encoding are rounded
+        vector<double> buffer;
+        const double *values = DecodeChunk(data, buffer, precision);
+        for (size_t i = 0; i < n; i++)
+            discrete_data_[start + i] = std::llround(values[i]);
+    }
+    else if (size == n)
+    {
+        // the chunk payload is contiguous, so copy it in one block
+        std::memcpy(this->data() + start, data.data().data(), n * sizeof(double));
+    }
+    else if (precision == WirePrecision::kFloat32 and n > 1 and size == Float32WireSize(n))
+    {
+        UnpackFloat32(data.data().data(), n, this->data() + start);
+    }
+    else
+    {
         throw std::length_error("Chunk data size does not match the specified range in Variable::AssignChunk");
+    }
+
+    // written values of file-backed variables go to the file
+    ReleasePages(start, end);
+}
+
+const double *philote::DecodeChunk(const Array &message, std::vector<double> &buffer,
+                                   WirePrecision precision)
+{
+    if (message.start() < 0 or message.end() < message.start())
+        throw std::invalid_argument("Invalid indices in DecodeChunk");
+
+    const size_t n = static_cast<size_t>(message.end() - message.start()) + 1;
+    const size_t size = static_cast<size_t>(message.data_size());
+    if (IsDiscreteChunk(message))
+    {
+        buffer.resize(n);
+        double *values = buffer.data();
+        if (!UnpackVarints(message.data(), n, [values](size_t i, int64_t value)
+                           { values[i] = static_cast<double>(value); }))
+            throw std::length_error("Malformed integer chunk in DecodeChunk");
+        return values;
+    }
+
+    if (size == n)
+        return message.data().data();
+
+    // a truncated double chunk must not pass for float32 values
+    if (precision == WirePrecision::kFloat32 and n > 1 and size == Float32WireSize(n))
+    {
+        buffer.resize(n);
+        UnpackFloat32(message.data().data(), n, buffer.data());
+        return buffer.data();
+    }
+
+    throw std::length_error("Chunk data size does not match the specified range in DecodeChunk");
+}
 
-    for (size_t i = 0; i < end - start + 1; i++)
-        data_[start + i] = data.data(i);
-}
\ No newline at end of file
+bool philote::IsDiscreteChunk(const Array &message) noexcept
+{
+    return message.subname() == kDiscreteChunkSubname;
+}
+
+Variable philote::AllocateVariable(const VariableMetaData &meta, const FileStorage &storage)
+{
+    vector<size_t> shape(meta.shape().begin(), meta.shape().end());
+    size_t size = 1;
+    for (size_t dim : shape)
+        size *= dim;
+
+    if (!storage.Applies(size))
+        return Variable(meta);
+    return Variable(meta.type(), shape, MappedFile::CreateTemporary(storage.directory, size));
+}
+
+Variable philote::AllocateVariable(const PartialsMetaData &meta, const FileStorage &storage)
+{
+    vector<size_t> shape(meta.shape().begin(), meta.shape().end());
+    size_t size = 1;
+    for (size_t dim : shape)
+        size *= dim;
+
+    if (!storage.Applies(size))
+        return Variable(meta);
+    return Variable(kPartial, shape, MappedFile::CreateTemporary(storage.directory, size));
+}
+Variable SparsityPattern::Densify(const Variable &values) const
+{
+    if (values.Size() != nnz())
+        throw std::length_error("Number of sparse partial values (" + std::to_string(values.Size()) +
+                                ") does not match the number of non-zeros (" +
+                                std::to_string(nnz()) + ").");
+    if (cols.size() != rows.size())
+        throw std::length_error("Sparsity pattern rows and cols differ in length.");
+
+    vector<size_t> shape(dense_shape.begin(), dense_shape.end());
+    Variable dense(kPartial, shape);
+
+    const double *first = values.data();
+    double *out = dense.data();
+    for (size_t k = 0; k < nnz(); k++)
+    {
+        const int64_t index = rows[k] * num_cols + cols[k];
+        if (rows[k] < 0 or cols[k] < 0 or cols[k] >= num_cols or
+            static_cast<size_t>(index) >= dense.Size())
+            throw std::out_of_range("Sparsity pattern entry out of range in SparsityPattern::Densify");
+        out[index] = first[k];
+    }
+
+    return dense;
+}
@@ -0,0 +1,124 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include "workspace.h"
+
+using std::make_pair;
+using std::unique_ptr;
+using std::vector;
+
+using philote::Workspace;
+using philote::WorkspaceCache;
+
+Workspace::Workspace(const vector<VariableMetaData> &var_meta,
+                     const vector<PartialsMetaData> &partials_meta,
+                     uint64_t generation,
+                     const FileStorage &storage)
+    : generation(generation),
+      num_variables(var_meta.size()),
+      num_partials(partials_meta.size()),
+      inputs(var_meta, kInput),
+      outputs(var_meta, kOutput, storage),
+      residuals(var_meta, kOutput)
+{
+    types.reserve(var_meta.size());
+    for (const VariableMetaData &var : var_meta)
+        types[var.name()] = var.type();
+
+    // partials are streamed as outputs
+    for (const PartialsMetaData &par : partials_meta)
+    {
+        vector<size_t> shape(par.shape().begin(), par.shape().end());
+        partials[make_pair(par.name(), par.subname())] = Variable(kOutput, shape);
+    }
+}
+
+void Workspace::Zero()
+{
+    inputs.Fill(0.0);
+    outputs.Fill(0.0);
+    residuals.Fill(0.0);
+    for (auto &par : partials)
+        par.second.Fill(0.0);
+}
+
+WorkspaceCache::Lease WorkspaceCache::Acquire(const vector<VariableMetaData> &var_meta,
+                                              const vector<PartialsMetaData> &partials_meta,
+                                              uint64_t generation,
+                                              const FileStorage &storage)
+{
+    unique_ptr<Workspace> workspace;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!idle_.empty() and !workspace)
+        {
+            unique_ptr<Workspace> candidate = std::move(idle_.back());
+            idle_.pop_back();
+
+            // workspaces of an outdated configuration are discarded
+            if (candidate->generation == generation and
+                candidate->num_variables == var_meta.size() and
+                candidate->num_partials == partials_meta.size())
+                workspace = std::move(candidate);
+        }
+    }
+
+    if (workspace)
+        workspace->Zero();
+    else
+        workspace = std::make_unique<Workspace>(var_meta, partials_meta, generation, storage);
+
+    return Lease(this, std::move(workspace));
+}
+
+void WorkspaceCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+}
+
+size_t WorkspaceCache::idle() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+void WorkspaceCache::Return(unique_ptr<Workspace> workspace) noexcept
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(std::move(workspace));
+    }
+    catch (...)
+    {
+        // the workspace is rebuilt on the next call
+    }
+}
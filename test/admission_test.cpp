@@ -0,0 +1,239 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <grpcpp/test/server_context_test_spouse.h>
+
+#include "admission.h"
+#include "protocol_extensions.h"
+
+using namespace philote;
+
+namespace
+{
+    AdmissionLimits Limits(size_t concurrent, size_t queued, size_t bytes = 0)
+    {
+        AdmissionLimits limits;
+        limits.max_concurrent = concurrent;
+        limits.max_queued = queued;
+        limits.max_buffered_bytes = bytes;
+        limits.retry_after = std::chrono::milliseconds(25);
+        return limits;
+    }
+}
+
+TEST(AdmissionControllerTest, UnlimitedByDefault) {
+    AdmissionController controller;
+    grpc::ServerContext context;
+
+    std::vector<AdmissionController::Ticket> tickets(16);
+    for (auto &ticket : tickets) {
+        ASSERT_TRUE(controller.Admit(&context, ticket).ok());
+        EXPECT_TRUE(ticket.Start(&context));
+        EXPECT_TRUE(ticket.Reserve(1 << 20));
+    }
+
+    EXPECT_EQ(controller.running(), 16u);
+    EXPECT_EQ(controller.rejected(), 0u);
+
+    tickets.clear();
+    EXPECT_EQ(controller.running(), 0u);
+    EXPECT_EQ(controller.buffered_bytes(), 0u);
+}
+
+TEST(AdmissionControllerTest, RejectsBeyondTheQueue) {
+    AdmissionController controller;
+    controller.SetLimits(Limits(1, 1));
+    grpc::ServerContext context;
+
+    AdmissionController::Ticket running, queued, rejected;
+    ASSERT_TRUE(controller.Admit(&context, running).ok());
+    ASSERT_TRUE(running.Start(&context));
+    ASSERT_TRUE(controller.Admit(&context, queued).ok());
+    EXPECT_EQ(controller.queued(), 1u);
+
+    grpc::ServerContext overloaded;
+    grpc::Status status = controller.Admit(&overloaded, rejected);
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+    EXPECT_NE(status.error_message().find("retry after 25 ms"), std::string::npos);
+    EXPECT_FALSE(rejected);
+    EXPECT_EQ(controller.rejected(), 1u);
+
+    // a released slot makes room again
+    running.Release();
+    EXPECT_TRUE(queued.Start(&context));
+    EXPECT_TRUE(controller.Admit(&context, rejected).ok());
+}
+
+TEST(AdmissionControllerTest, QueuedCallsWaitForASlot) {
+    AdmissionController controller;
+    controller.SetLimits(Limits(1, 1));
+    grpc::ServerContext context;
+
+    AdmissionController::Ticket first, second;
+    ASSERT_TRUE(controller.Admit(&context, first).ok());
+    ASSERT_TRUE(first.Start(&context));
+    ASSERT_TRUE(controller.Admit(&context, second).ok());
+
+    std::atomic<bool> started{false};
+    std::thread waiter([&] {
+        started = second.Start(&context);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(started.load());
+
+    first.Release();
+    waiter.join();
+    EXPECT_TRUE(started.load());
+    EXPECT_EQ(controller.running(), 1u);
+    EXPECT_EQ(controller.queued(), 0u);
+}
+
+TEST(AdmissionControllerTest, ReleasedSlotsAreHandedToWaitingTickets) {
+    AdmissionController controller;
+    controller.SetLimits(Limits(1, 2));
+    grpc::ServerContext context;
+
+    AdmissionController::Ticket first, second, third;
+    ASSERT_TRUE(controller.Admit(&context, first).ok());
+    EXPECT_TRUE(first.TryStart([] { ADD_FAILURE() << "the ticket started right away"; }));
+    ASSERT_TRUE(controller.Admit(&context, second).ok());
+    ASSERT_TRUE(controller.Admit(&context, third).ok());
+
+    int second_ready = 0;
+    int third_ready = 0;
+    EXPECT_FALSE(second.TryStart([&] { second_ready++; }));
+    EXPECT_FALSE(third.TryStart([&] { third_ready++; }));
+
+    // a moved ticket keeps its place in the queue
+    AdmissionController::Ticket moved(std::move(second));
+    EXPECT_FALSE(second.CancelStart());
+
+    // the released slot goes to the first waiting ticket, without waiting threads
+    first.Release();
+    EXPECT_EQ(second_ready, 1);
+    EXPECT_EQ(third_ready, 0);
+    EXPECT_EQ(controller.running(), 1u);
+    EXPECT_FALSE(moved.CancelStart());
+
+    // a ticket leaving the queue is not handed a slot
+    EXPECT_TRUE(third.CancelStart());
+    moved.Release();
+    EXPECT_EQ(third_ready, 0);
+    EXPECT_EQ(controller.running(), 0u);
+    EXPECT_EQ(controller.queued(), 1u);
+
+    EXPECT_TRUE(third.TryStart([] {}));
+    third.Release();
+    EXPECT_EQ(controller.queued(), 0u);
+}
+
+TEST(AdmissionControllerTest, LimitsBufferedBytes) {
+    AdmissionController controller;
+    controller.SetLimits(Limits(0, 0, 1000));
+    grpc::ServerContext context;
+
+    // a single call may exceed the limit, so that large inputs are not starved
+    AdmissionController::Ticket large;
+    ASSERT_TRUE(controller.Admit(&context, large).ok());
+    EXPECT_TRUE(large.Reserve(800));
+    EXPECT_TRUE(large.Reserve(800));
+    EXPECT_EQ(controller.buffered_bytes(), 1600u);
+
+    // further calls are rejected while the bytes are buffered
+    AdmissionController::Ticket other;
+    EXPECT_EQ(controller.Admit(&context, other).error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+
+    large.Release();
+    ASSERT_TRUE(controller.Admit(&context, other).ok());
+    EXPECT_TRUE(other.Reserve(600));
+
+    AdmissionController::Ticket third;
+    ASSERT_TRUE(controller.Admit(&context, third).ok());
+    EXPECT_FALSE(third.Reserve(600));
+    EXPECT_TRUE(third.Reserve(400));
+}
+
+TEST(AdmissionControllerTest, DeclaredSizeDoesNotBypassTheLimit) {
+    AdmissionController controller;
+    controller.SetLimits(Limits(0, 0, 1000));
+    grpc::ServerContext context;
+
+    AdmissionController::Ticket other;
+    ASSERT_TRUE(controller.Admit(&context, other).ok());
+    EXPECT_TRUE(other.Reserve(500));
+
+    // bytes within the declared size are counted up front
+    grpc::ServerContext declared;
+    grpc::testing::ServerContextTestSpouse spouse(&declared);
+    spouse.AddClientMetadata(kInputBytesMetadataKey, "100");
+    AdmissionController::Ticket ticket;
+    ASSERT_TRUE(controller.Admit(&declared, ticket).ok());
+    EXPECT_EQ(controller.buffered_bytes(), 600u);
+    EXPECT_TRUE(ticket.Reserve(60));
+    EXPECT_TRUE(ticket.Reserve(40));
+    EXPECT_EQ(controller.buffered_bytes(), 600u);
+
+    // the bytes beyond it are checked against the limit
+    EXPECT_TRUE(ticket.Reserve(300));
+    EXPECT_EQ(controller.buffered_bytes(), 900u);
+    EXPECT_FALSE(ticket.Reserve(200));
+}
+
+TEST(AdmissionControllerTest, RejectionCarriesTheRetryHint) {
+    AdmissionController controller;
+    controller.SetLimits(Limits(1, 0));
+    grpc::ServerContext context;
+
+    grpc::Status status = controller.Reject(&context, "test");
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::RESOURCE_EXHAUSTED);
+    EXPECT_NE(status.error_message().find("test"), std::string::npos);
+    EXPECT_EQ(controller.rejected(), 1u);
+}
+
+TEST(AdmissionControllerTest, RejectsNonPositiveRetryHint) {
+    AdmissionController controller;
+    AdmissionLimits limits;
+    limits.retry_after = std::chrono::milliseconds(0);
+    EXPECT_THROW(controller.SetLimits(limits), std::invalid_argument);
+}
+
+TEST(AdmissionControllerTest, MovedTicketsReleaseOnce) {
+    AdmissionController controller;
+    controller.SetLimits(Limits(2, 0));
+    grpc::ServerContext context;
+
+    AdmissionController::Ticket ticket;
+    ASSERT_TRUE(controller.Admit(&context, ticket).ok());
+    ASSERT_TRUE(ticket.Start(&context));
+
+    AdmissionController::Ticket moved(std::move(ticket));
+    EXPECT_FALSE(ticket);
+    EXPECT_TRUE(moved);
+    ticket.Release();
+    EXPECT_EQ(controller.running(), 1u);
+
+    moved.Release();
+    EXPECT_EQ(controller.running(), 0u);
+}
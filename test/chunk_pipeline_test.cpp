@@ -0,0 +1,157 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <chunk_pipeline.h>
+#include <variable.h>
+
+using philote::Array;
+using philote::ChunkPipeline;
+using philote::Variable;
+
+namespace
+{
+    // records the written messages, optionally failing after a number of writes
+    class RecordingWriter : public grpc::internal::WriterInterface<Array>
+    {
+    public:
+        explicit RecordingWriter(size_t fail_after = SIZE_MAX, int delay_ms = 0)
+            : fail_after_(fail_after), delay_ms_(delay_ms) {}
+
+        bool Write(const Array &msg, grpc::WriteOptions options) override
+        {
+            if (delay_ms_ > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (written_.size() >= fail_after_)
+                return false;
+            written_.push_back(msg);
+            return true;
+        }
+
+        std::vector<Array> written_;
+
+    private:
+        size_t fail_after_;
+        int delay_ms_;
+        std::mutex mutex_;
+    };
+
+    Variable MakeSequence(size_t n)
+    {
+        Variable var(philote::kInput, {n});
+        for (size_t i = 0; i < n; i++)
+            var(i) = static_cast<double>(i);
+        return var;
+    }
+}
+
+TEST(ChunkPipelineTests, DirectWritesPreserveOrder)
+{
+    RecordingWriter writer;
+    ChunkPipeline pipeline(&writer, false);
+
+    MakeSequence(10).Send("x", "", &pipeline, 4);
+    EXPECT_TRUE(pipeline.Finish());
+
+    ASSERT_EQ(writer.written_.size(), 3u);
+    EXPECT_EQ(writer.written_[0].name(), "x");
+    EXPECT_EQ(writer.written_[2].start(), 8);
+    EXPECT_EQ(writer.written_[2].end(), 9);
+}
+
+TEST(ChunkPipelineTests, ThreadedWritesPreserveOrder)
+{
+    RecordingWriter writer(SIZE_MAX, 1);
+    {
+        ChunkPipeline pipeline(&writer, true);
+
+        MakeSequence(100).Send("x", "", &pipeline, 7);
+        MakeSequence(5).Send("y", "", &pipeline, 7);
+        EXPECT_TRUE(pipeline.Finish());
+    }
+
+    // 15 chunks of x followed by y
+    ASSERT_EQ(writer.written_.size(), 16u);
+    Variable x(philote::kInput, {100});
+    for (size_t i = 0; i < 15; i++)
+    {
+        EXPECT_EQ(writer.written_[i].name(), "x");
+        x.AssignChunk(writer.written_[i]);
+    }
+    for (size_t i = 0; i < 100; i++)
+        EXPECT_DOUBLE_EQ(x(i), static_cast<double>(i));
+    EXPECT_EQ(writer.written_[15].name(), "y");
+}
+
+TEST(ChunkPipelineTests, WriteFailureIsReported)
+{
+    for (bool threaded : {false, true})
+    {
+        RecordingWriter writer(2);
+        ChunkPipeline pipeline(&writer, threaded);
+
+        // the failure surfaces either while sending or when finishing
+        bool sent = true;
+        try
+        {
+            MakeSequence(100).Send("x", "", &pipeline, 10);
+        }
+        catch (const std::runtime_error &)
+        {
+            sent = false;
+        }
+        EXPECT_FALSE(pipeline.Finish());
+        EXPECT_TRUE(!sent || threaded);
+        EXPECT_EQ(writer.written_.size(), 2u);
+    }
+}
+
+TEST(ChunkPipelineTests, RecyclesMessages)
+{
+    RecordingWriter writer;
+    ChunkPipeline pipeline(&writer, false);
+
+    Array message = pipeline.Acquire();
+    message.set_name("x");
+    message.add_data(1.0);
+    EXPECT_TRUE(pipeline.Write(std::move(message)));
+
+    // the written message is handed out again
+    Array recycled = pipeline.Acquire();
+    EXPECT_EQ(recycled.name(), "x");
+}
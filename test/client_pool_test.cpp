@@ -0,0 +1,202 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <client_pool.h>
+#include "test_helpers.h"
+
+using namespace philote;
+using namespace philote::test;
+
+// ============================================================================
+// Test Discipline
+// ============================================================================
+
+/**
+ * Paraboloid that counts its function evaluations
+ */
+class CountingParaboloid : public ParaboloidDiscipline {
+public:
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        calls_++;
+        ParaboloidDiscipline::Compute(inputs, outputs);
+    }
+
+    std::atomic<int> calls_{0};
+};
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class ClientPoolTest : public ::testing::Test {
+protected:
+    void StartReplicas(size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            auto discipline = std::make_shared<CountingParaboloid>();
+            auto manager = std::make_unique<TestServerManager>();
+            channels_.push_back(CreateTestChannel(manager->StartServer(discipline)));
+            disciplines_.push_back(discipline);
+            managers_.push_back(std::move(manager));
+        }
+    }
+
+    void TearDown() override {
+        for (auto &manager : managers_) {
+            if (manager->IsRunning())
+                manager->StopServer();
+        }
+    }
+
+    static Variables Inputs(double x, double y) {
+        Variables inputs;
+        inputs["x"] = CreateScalarVariable(x);
+        inputs["y"] = CreateScalarVariable(y);
+        return inputs;
+    }
+
+    std::vector<std::shared_ptr<CountingParaboloid>> disciplines_;
+    std::vector<std::unique_ptr<TestServerManager>> managers_;
+    std::vector<std::shared_ptr<grpc::ChannelInterface>> channels_;
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+TEST_F(ClientPoolTest, RequiresChannels) {
+    ExplicitClientPool pool;
+    EXPECT_THROW(pool.ConnectChannels({}), std::invalid_argument);
+    EXPECT_THROW(pool.Initialize(), std::runtime_error);
+    EXPECT_THROW(pool.ComputeFunction(Inputs(1.0, 2.0)), std::runtime_error);
+}
+
+TEST_F(ClientPoolTest, DiscoversOnce) {
+    StartReplicas(3);
+    ExplicitClientPool pool(channels_);
+
+    std::vector<std::shared_ptr<RecordingTracer>> tracers;
+    for (size_t i = 0; i < pool.size(); i++) {
+        tracers.push_back(std::make_shared<RecordingTracer>());
+        pool.GetReplica(i).SetTracer(tracers.back());
+    }
+
+    pool.Initialize();
+
+    for (size_t i = 0; i < pool.size(); i++) {
+        int discovery = 0;
+        int setup = 0;
+        for (const RecordedSpan &span : tracers[i]->spans()) {
+            if (span.name == "GetInfo" or span.name == "GetVariableDefinitions" or
+                span.name == "GetPartialDefinitions")
+                discovery++;
+            if (span.name == "Setup")
+                setup++;
+        }
+        EXPECT_EQ(discovery, i == 0 ? 3 : 0) << "replica " << i;
+        EXPECT_EQ(setup, 1) << "replica " << i;
+
+        // every replica knows the discipline
+        EXPECT_EQ(pool.GetReplica(i).GetVariableMetaAll().size(), 3u);
+        EXPECT_EQ(pool.GetReplica(i).GetPartialsMetaConst().size(), 2u);
+        EXPECT_EQ(pool.GetReplica(i).GetServerFeatures(), pool.GetReplica(0).GetServerFeatures());
+    }
+}
+
+TEST_F(ClientPoolTest, BalancesConcurrentCalls) {
+    StartReplicas(3);
+    ExplicitClientPool pool(channels_);
+    pool.Initialize();
+
+    std::vector<std::future<double>> results;
+    for (int i = 0; i < 30; i++) {
+        results.push_back(std::async(std::launch::async, [&pool, i]() {
+            return pool.ComputeFunction(Inputs(static_cast<double>(i), 1.0))["f"](0);
+        }));
+    }
+    for (int i = 0; i < 30; i++)
+        EXPECT_DOUBLE_EQ(results[i].get(), i * i + 1.0);
+
+    // sequential calls rotate over the idle replicas
+    for (int i = 0; i < 6; i++) {
+        Partials partials = pool.ComputeGradient(Inputs(static_cast<double>(i), 2.0));
+        EXPECT_DOUBLE_EQ((partials[{"f", "x"}](0)), 2.0 * i);
+    }
+
+    int total = 0;
+    for (const auto &discipline : disciplines_) {
+        EXPECT_GT(discipline->calls_.load(), 0);
+        total += discipline->calls_.load();
+    }
+    EXPECT_EQ(total, 30);
+
+    std::vector<ReplicaStats> stats = pool.GetReplicaStats();
+    ASSERT_EQ(stats.size(), 3u);
+    size_t completed = 0;
+    for (const ReplicaStats &replica : stats) {
+        EXPECT_EQ(replica.outstanding, 0u);
+        EXPECT_EQ(replica.failures, 0u);
+        EXPECT_GE(replica.completed, 2u);
+        completed += replica.completed;
+    }
+    EXPECT_EQ(completed, 36u);
+}
+
+TEST_F(ClientPoolTest, RetriesOnOtherReplicas) {
+    StartReplicas(2);
+    ExplicitClientPool pool(channels_);
+    pool.Initialize();
+
+    // the first replica goes down after the setup
+    managers_[0]->StopServer();
+
+    for (int i = 0; i < 4; i++) {
+        auto both = pool.ComputeFunctionAndGradient(Inputs(3.0, static_cast<double>(i)));
+        EXPECT_DOUBLE_EQ(both.first["f"](0), 9.0 + i * i);
+        EXPECT_DOUBLE_EQ((both.second[{"f", "y"}](0)), 2.0 * i);
+    }
+
+    // the failed replica was avoided after its first failure
+    std::vector<ReplicaStats> stats = pool.GetReplicaStats();
+    EXPECT_EQ(stats[0].failures, 1u);
+    EXPECT_EQ(stats[0].completed, 0u);
+    EXPECT_EQ(stats[1].completed, 4u);
+
+    // a call fails once no replica is left
+    managers_[1]->StopServer();
+    EXPECT_THROW(pool.ComputeFunction(Inputs(1.0, 1.0)), std::runtime_error);
+}
@@ -0,0 +1,141 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/test/server_context_test_spouse.h>
+
+#include <callback_server.h>
+#include <compression.h>
+#include <protocol_extensions.h>
+
+using namespace philote;
+
+namespace
+{
+    Array MakeMessage(size_t values)
+    {
+        Array message;
+        message.set_name("x");
+        for (size_t i = 0; i < values; i++)
+            message.add_data(0.0);
+        return message;
+    }
+}
+
+TEST(CompressionTests, PolicyRoundTrip)
+{
+    CompressionPolicy policy;
+    policy.algorithm = GRPC_COMPRESS_GZIP;
+    policy.min_values = 512;
+    EXPECT_EQ(FormatCompressionPolicy(policy), "gzip,512");
+
+    CompressionPolicy parsed;
+    ASSERT_TRUE(ParseCompressionPolicy(FormatCompressionPolicy(policy), parsed));
+    EXPECT_EQ(parsed.algorithm, GRPC_COMPRESS_GZIP);
+    EXPECT_EQ(parsed.min_values, 512u);
+
+    ASSERT_TRUE(ParseCompressionPolicy("deflate,0", parsed));
+    EXPECT_EQ(parsed.algorithm, GRPC_COMPRESS_DEFLATE);
+    EXPECT_EQ(parsed.min_values, 0u);
+}
+
+TEST(CompressionTests, ParseRejectsInvalidPolicies)
+{
+    CompressionPolicy policy;
+    EXPECT_FALSE(ParseCompressionPolicy("", policy));
+    EXPECT_FALSE(ParseCompressionPolicy("gzip", policy));
+    EXPECT_FALSE(ParseCompressionPolicy("zstd,1024", policy));
+    EXPECT_FALSE(ParseCompressionPolicy("gzip,-1", policy));
+    EXPECT_FALSE(ParseCompressionPolicy("gzip,", policy));
+
+    // failed parses leave the policy unchanged
+    EXPECT_FALSE(policy.Enabled());
+}
+
+TEST(CompressionTests, SmallMessagesAreNotCompressed)
+{
+    CompressionPolicy policy;
+    EXPECT_FALSE(policy.Enabled());
+    EXPECT_FALSE(policy.WriteOptionsFor(MakeMessage(0)).get_no_compression());
+
+    policy.algorithm = GRPC_COMPRESS_GZIP;
+    policy.min_values = 4;
+    EXPECT_TRUE(policy.WriteOptionsFor(MakeMessage(3)).get_no_compression());
+    EXPECT_FALSE(policy.WriteOptionsFor(MakeMessage(4)).get_no_compression());
+
+    BufferedArrayStream buffer;
+    CompressedArrayStream stream(&buffer, policy);
+    stream.Write(MakeMessage(2));
+    stream.Write(MakeMessage(8));
+
+    ASSERT_EQ(buffer.write_options().size(), 2u);
+    EXPECT_TRUE(buffer.write_options()[0].get_no_compression());
+    EXPECT_FALSE(buffer.write_options()[1].get_no_compression());
+}
+
+TEST(CompressionTests, CompressCallWithoutPolicyPassesStream)
+{
+    grpc::ServerContext context;
+    BufferedArrayStream buffer;
+
+    grpc::Status status = CompressCall(&context, &buffer,
+                                       [&buffer](auto *stream)
+                                       {
+                                           EXPECT_EQ(static_cast<void *>(stream), static_cast<void *>(&buffer));
+                                           return grpc::Status::OK;
+                                       });
+    EXPECT_TRUE(status.ok());
+}
+
+TEST(CompressionTests, CompressCallAppliesRequestedPolicy)
+{
+    grpc::ServerContext context;
+    grpc::testing::ServerContextTestSpouse spouse(&context);
+    spouse.AddClientMetadata(kCompressionMetadataKey, "gzip,4");
+
+    BufferedArrayStream buffer;
+    grpc::Status status = CompressCall(&context, &buffer,
+                                       [](auto *stream)
+                                       {
+                                           stream->Write(MakeMessage(1));
+                                           stream->Write(MakeMessage(16));
+                                           return grpc::Status::OK;
+                                       });
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(context.compression_algorithm(), GRPC_COMPRESS_GZIP);
+
+    ASSERT_EQ(buffer.write_options().size(), 2u);
+    EXPECT_TRUE(buffer.write_options()[0].get_no_compression());
+    EXPECT_FALSE(buffer.write_options()[1].get_no_compression());
+}
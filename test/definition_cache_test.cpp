@@ -0,0 +1,179 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <definition_cache.h>
+#include <protocol_extensions.h>
+
+using namespace philote;
+
+namespace
+{
+    std::vector<VariableMetaData> VariableDefinitions(int64_t size)
+    {
+        VariableMetaData x;
+        x.set_name("x");
+        x.set_type(kInput);
+        x.add_shape(size);
+
+        VariableMetaData f;
+        f.set_name("f");
+        f.set_type(kOutput);
+        f.add_shape(size);
+
+        return {x, f};
+    }
+
+    std::vector<PartialsMetaData> PartialDefinitions()
+    {
+        PartialsMetaData partial;
+        partial.set_name("f");
+        partial.set_subname("x");
+        partial.add_shape(3);
+        return {partial};
+    }
+
+    PartialsSparsity Diagonal()
+    {
+        SparsityPattern pattern;
+        pattern.rows = {0, 1, 2};
+        pattern.cols = {0, 1, 2};
+        pattern.num_cols = 3;
+        pattern.dense_shape = {3, 3};
+
+        PartialsSparsity sparsity;
+        sparsity[{"f", "x"}] = pattern;
+        return sparsity;
+    }
+
+    //! unique directory for the cache files of a test
+    std::string CacheDirectory(const std::string &test)
+    {
+        std::string directory = ::testing::TempDir() + "philote_definitions_" + test + "_" +
+                                std::to_string(getpid()) + "/";
+        EXPECT_EQ(system(("mkdir -p " + directory).c_str()), 0);
+        return directory;
+    }
+}
+
+TEST(DefinitionCacheTest, HashCoversDefinitions)
+{
+    const std::string hash = HashDefinitions(VariableDefinitions(3), PartialDefinitions(), Diagonal());
+    EXPECT_EQ(hash.size(), 32u);
+    EXPECT_EQ(hash, HashDefinitions(VariableDefinitions(3), PartialDefinitions(), Diagonal()));
+
+    EXPECT_NE(hash, HashDefinitions(VariableDefinitions(4), PartialDefinitions(), Diagonal()));
+    EXPECT_NE(hash, HashDefinitions(VariableDefinitions(3), {}, Diagonal()));
+    EXPECT_NE(hash, HashDefinitions(VariableDefinitions(3), PartialDefinitions(), {}));
+
+    PartialsSparsity shifted = Diagonal();
+    shifted[{"f", "x"}].cols = {1, 2, 0};
+    EXPECT_NE(hash, HashDefinitions(VariableDefinitions(3), PartialDefinitions(), shifted));
+
+    // discrete variables change the definitions
+    EXPECT_NE(hash, HashDefinitions(VariableDefinitions(3), PartialDefinitions(), Diagonal(), {"x"}));
+}
+
+TEST(DefinitionCacheTest, StoresInMemory)
+{
+    DefinitionCache cache;
+    const std::string hash = HashDefinitions(VariableDefinitions(3), PartialDefinitions(), Diagonal());
+
+    std::vector<VariableMetaData> variables;
+    std::vector<PartialsMetaData> partials;
+    EXPECT_FALSE(cache.LoadVariables(hash, variables));
+    EXPECT_FALSE(cache.LoadPartials(hash, true, partials));
+
+    cache.StoreVariables(hash, VariableDefinitions(3));
+    cache.StorePartials(hash, true, PartialDefinitions());
+
+    ASSERT_TRUE(cache.LoadVariables(hash, variables));
+    ASSERT_EQ(variables.size(), 2u);
+    EXPECT_EQ(variables[1].name(), "f");
+    EXPECT_EQ(variables[1].shape(0), 3);
+
+    // definitions requested with discrete markers are a separate entry
+    EXPECT_FALSE(cache.LoadVariables(hash, variables, true));
+
+    ASSERT_TRUE(cache.LoadPartials(hash, true, partials));
+    ASSERT_EQ(partials.size(), 1u);
+    EXPECT_EQ(partials[0].subname(), "x");
+
+    // dense and sparse definitions are separate entries
+    EXPECT_FALSE(cache.LoadPartials(hash, false, partials));
+}
+
+TEST(DefinitionCacheTest, SharesEntriesThroughDirectory)
+{
+    const std::string directory = CacheDirectory("shared");
+    const std::string hash = HashDefinitions(VariableDefinitions(5), PartialDefinitions(), {});
+
+    DefinitionCache writer(directory);
+    writer.StoreVariables(hash, VariableDefinitions(5));
+    writer.StorePartials(hash, false, PartialDefinitions());
+
+    DefinitionCache reader(directory);
+    std::vector<VariableMetaData> variables;
+    std::vector<PartialsMetaData> partials;
+    ASSERT_TRUE(reader.LoadVariables(hash, variables));
+    ASSERT_EQ(variables.size(), 2u);
+    EXPECT_EQ(variables[0].shape(0), 5);
+    ASSERT_TRUE(reader.LoadPartials(hash, false, partials));
+    EXPECT_EQ(partials.size(), 1u);
+}
+
+TEST(DefinitionCacheTest, IgnoresInvalidEntries)
+{
+    const std::string directory = CacheDirectory("invalid");
+    DefinitionCache cache(directory);
+    std::vector<VariableMetaData> variables;
+
+    // hashes become file names
+    cache.StoreVariables("../escape", VariableDefinitions(1));
+    EXPECT_FALSE(cache.LoadVariables("../escape", variables));
+    EXPECT_FALSE(cache.LoadVariables("", variables));
+
+    // truncated files are not used
+    const std::string hash = "0123456789abcdef0123456789abcdef";
+    std::ofstream(directory + hash + ".variables", std::ios::binary) << "philote-definitions 1\n\x05";
+    EXPECT_FALSE(cache.LoadVariables(hash, variables));
+
+    std::ofstream(directory + hash + ".variables", std::ios::binary) << "something else";
+    EXPECT_FALSE(cache.LoadVariables(hash, variables));
+}
@@ -17,6 +17,11 @@
 */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "cancellation.h"
 #include "explicit.h"
 #include "test_helpers.h"
 
@@ -52,6 +57,9 @@ TEST_F(DisciplineCancellationTest, SetContextStoresPointer) {
     // Context is now set, IsCancelled queries the real context
     // Real contexts are not cancelled unless the client actually cancels
     EXPECT_FALSE(discipline_->IsCancelled());
+
+    // the context must not outlive the watch
+    discipline_->ClearContext();
 }
 
 TEST_F(DisciplineCancellationTest, ClearContextRemovesPointer) {
@@ -111,3 +119,108 @@ TEST_F(DisciplineCancellationTest, ContextPropagationInSlowDiscipline) {
     EXPECT_FALSE(slow_discipline->WasCancelled());
     EXPECT_DOUBLE_EQ(outputs["y"](0), 2.0);
 }
+
+// ============================================================================
+// Cancellation Token Tests
+// ============================================================================
+
+TEST(CancellationTokenTest, CopiesShareTheFlag) {
+    CancellationToken token;
+    CancellationToken copy = token;
+    EXPECT_FALSE(copy.IsCancelled());
+
+    token.Cancel();
+    EXPECT_TRUE(copy.IsCancelled());
+    EXPECT_FALSE(CancellationToken().IsCancelled());
+}
+
+TEST(CancellationTokenTest, MonitorCancelsWatchedContexts) {
+    CancellationMonitor &monitor = CancellationMonitor::Instance();
+    grpc::ServerContext context;
+    const size_t watched = monitor.watched();
+
+    // repeated watches share one token
+    CancellationToken token = monitor.Watch(&context);
+    CancellationToken again = monitor.Watch(&context);
+    EXPECT_EQ(monitor.watched(), watched + 1);
+    EXPECT_FALSE(token.IsCancelled());
+
+    monitor.Cancel(&context);
+    EXPECT_TRUE(token.IsCancelled());
+    EXPECT_TRUE(again.IsCancelled());
+
+    monitor.Unwatch(&context);
+    EXPECT_EQ(monitor.watched(), watched + 1);
+    monitor.Unwatch(&context);
+    EXPECT_EQ(monitor.watched(), watched);
+
+    EXPECT_THROW(monitor.SetPollInterval(std::chrono::milliseconds(0)), std::invalid_argument);
+}
+
+TEST_F(DisciplineCancellationTest, DisciplineReadsTheToken) {
+    grpc::ServerContext context;
+    {
+        ContextScope scope(discipline_.get(), &context);
+        CancellationToken token = discipline_->cancellation_token();
+        EXPECT_FALSE(discipline_->IsCancelled());
+
+        CancellationMonitor::Instance().Cancel(&context);
+        EXPECT_TRUE(discipline_->IsCancelled());
+        EXPECT_TRUE(token.IsCancelled());
+    }
+
+    // the scope cleared the context
+    EXPECT_FALSE(discipline_->IsCancelled());
+    EXPECT_FALSE(discipline_->cancellation_token().IsCancelled());
+}
+
+// Busy loop that only stops once its token is cancelled
+class TokenPollingDiscipline : public ExplicitDiscipline {
+public:
+    void Setup() override {
+        AddInput("x", {1}, "");
+        AddOutput("y", {1}, "");
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        const CancellationToken token = cancellation_token();
+        const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (!token.IsCancelled()) {
+            if (std::chrono::steady_clock::now() > give_up)
+                throw std::runtime_error("Cancellation was not detected");
+        }
+
+        stopped = true;
+        throw std::runtime_error("Computation cancelled by client");
+    }
+
+    std::atomic<bool> stopped{false};
+};
+
+TEST(CancellationIntegrationTest, AbandonedComputeStopsPollingLoop) {
+    for (const ServerEngine engine : {ServerEngine::kSynchronous, ServerEngine::kCallback}) {
+        auto discipline = std::make_shared<TokenPollingDiscipline>();
+        TestServerManager server_manager;
+        std::string address = server_manager.StartServer(discipline, engine);
+        ASSERT_FALSE(address.empty());
+
+        ExplicitClient client;
+        client.ConnectChannel(CreateTestChannel(address));
+        client.GetInfo();
+        client.Setup();
+        client.GetVariableDefinitions();
+        client.SetRPCTimeout(std::chrono::milliseconds(200));
+
+        Variables inputs;
+        inputs["x"] = CreateScalarVariable(1.0);
+        EXPECT_THROW(client.ComputeFunction(inputs), std::runtime_error);
+
+        // the deadline cancels the evaluation on the server
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!discipline->stopped and std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        EXPECT_TRUE(discipline->stopped);
+
+        server_manager.StopServer();
+    }
+}
@@ -0,0 +1,131 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <memory>
+#include <stdexcept>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <discipline_chain.h>
+
+#include "test_helpers.h"
+
+using philote::DisciplineChain;
+using philote::ExplicitClient;
+using philote::Partials;
+using philote::Variables;
+using philote::test::CreateScalarVariable;
+using philote::test::ParaboloidDiscipline;
+using philote::test::SimpleImplicitDiscipline;
+
+namespace
+{
+    // mesh: f = x^2 + y^2, solver: R = f^2 - y (so solver.y = (x^2 + y^2)^2)
+    std::shared_ptr<DisciplineChain> CreateChain()
+    {
+        auto chain = std::make_shared<DisciplineChain>();
+        chain->AddStage("mesh", std::make_shared<ParaboloidDiscipline>());
+        chain->AddStage("solver", std::make_shared<SimpleImplicitDiscipline>());
+        chain->Connect("mesh", "f", "solver", "x");
+        return chain;
+    }
+
+    Variables ChainInputs(double x, double y)
+    {
+        Variables inputs;
+        inputs["mesh.x"] = CreateScalarVariable(x);
+        inputs["mesh.y"] = CreateScalarVariable(y);
+        return inputs;
+    }
+}
+
+TEST(DisciplineChainTests, ExposesUnconnectedVariables)
+{
+    auto chain = CreateChain();
+    chain->Setup();
+    chain->SetupPartials();
+
+    std::vector<std::string> names;
+    for (const auto &var : chain->var_meta())
+        names.push_back(var.name());
+    EXPECT_THAT(names, testing::UnorderedElementsAre("mesh.x", "mesh.y", "solver.y"));
+
+    EXPECT_EQ(chain->partials_meta().size(), 2u);
+}
+
+TEST(DisciplineChainTests, ComputesChainedOutputsAndPartials)
+{
+    auto chain = CreateChain();
+    chain->Setup();
+    chain->SetupPartials();
+
+    Variables inputs = ChainInputs(1.0, 2.0);
+    Variables outputs;
+    outputs["solver.y"] = CreateScalarVariable(0.0);
+    chain->Compute(inputs, outputs);
+    EXPECT_DOUBLE_EQ(outputs["solver.y"](0), 25.0);
+
+    // d(solver.y)/d(mesh.x) = 2 f * 2 x
+    Partials partials;
+    partials[{"solver.y", "mesh.x"}] = CreateScalarVariable(0.0);
+    partials[{"solver.y", "mesh.y"}] = CreateScalarVariable(0.0);
+    chain->ComputePartials(inputs, partials);
+    EXPECT_DOUBLE_EQ((partials[{"solver.y", "mesh.x"}](0)), 20.0);
+    EXPECT_DOUBLE_EQ((partials[{"solver.y", "mesh.y"}](0)), 40.0);
+}
+
+TEST(DisciplineChainTests, RejectsInvalidConnections)
+{
+    auto chain = std::make_shared<DisciplineChain>();
+    chain->AddStage("mesh", std::make_shared<ParaboloidDiscipline>());
+    chain->AddStage("solver", std::make_shared<SimpleImplicitDiscipline>());
+
+    EXPECT_THROW(chain->AddStage("mesh", std::make_shared<ParaboloidDiscipline>()), std::invalid_argument);
+    EXPECT_THROW(chain->AddStage("a.b", std::make_shared<ParaboloidDiscipline>()), std::invalid_argument);
+    EXPECT_THROW(chain->Connect("solver", "y", "mesh", "x"), std::invalid_argument);
+    EXPECT_THROW(chain->Connect("mesh", "f", "flow", "x"), std::invalid_argument);
+
+    chain->Connect("mesh", "g", "solver", "x");
+    EXPECT_THROW(chain->Setup(), std::invalid_argument);
+}
+
+TEST(DisciplineChainTests, ServesTheChain)
+{
+    auto chain = CreateChain();
+    std::unique_ptr<ExplicitClient> client = chain->ServeInProcess();
+
+    Variables inputs = ChainInputs(1.0, 2.0);
+    Variables outputs = client->ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs["solver.y"](0), 25.0);
+
+    Partials partials = client->ComputeGradient(inputs);
+    EXPECT_DOUBLE_EQ((partials[{"solver.y", "mesh.x"}](0)), 20.0);
+}
@@ -111,6 +111,23 @@ TEST_F(DisciplineServerTest, SetStreamOptions)
     EXPECT_EQ(mock_discipline->stream_opts().num_double(), 10);
 }
 
+// Test that SetStreamOptions keeps the chunks within the message size limit
+TEST_F(DisciplineServerTest, SetStreamOptionsClampsChunkSize)
+{
+    grpc::ServerContext context;
+    StreamOptions request;
+    google::protobuf::Empty response;
+
+    mock_discipline->SetMaxMessageBytes(1024);
+    request.set_num_double(1000000);
+
+    grpc::Status status = server->SetStreamOptions(&context, &request, &response);
+
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(mock_discipline->stream_opts().num_double(),
+              static_cast<int64_t>(ChunkSizeForMessageBytes(1024)));
+}
+
 // Test SetOptions RPC
 TEST_F(DisciplineServerTest, SetOptions)
 {
@@ -32,6 +32,17 @@ TEST_F(DisciplineTest, ConstructorInitialization)
     EXPECT_TRUE(discipline->partials_meta().empty());
 }
 
+// Test the maximum message size accessors
+TEST_F(DisciplineTest, MaxMessageBytes)
+{
+    EXPECT_EQ(discipline->max_message_bytes(), kDefaultMaxMessageBytes);
+
+    discipline->SetMaxMessageBytes(1024);
+    EXPECT_EQ(discipline->max_message_bytes(), 1024u);
+
+    EXPECT_THROW(discipline->SetMaxMessageBytes(0), std::invalid_argument);
+}
+
 // Test AddInput method
 TEST_F(DisciplineTest, AddInput)
 {
@@ -181,6 +192,46 @@ TEST_F(DisciplineTest, AddOptionMethod)
     EXPECT_EQ(options["max_iterations"], "int");
 }
 
+// Test sparse DeclarePartials
+TEST_F(DisciplineTest, DeclarePartialsSparse)
+{
+    discipline->AddInput("x", {3}, "m");
+    discipline->AddOutput("f", {2}, "N");
+
+    discipline->DeclarePartials("f", "x", {0, 1, 1}, {2, 0, 1});
+
+    // only the non-zeros are stored
+    ASSERT_EQ(discipline->partials_meta().size(), 1);
+    const auto &partial = discipline->partials_meta()[0];
+    ASSERT_EQ(partial.shape_size(), 1);
+    EXPECT_EQ(partial.shape(0), 3);
+
+    const auto &sparsity = discipline->partials_sparsity();
+    ASSERT_EQ(sparsity.count({"f", "x"}), 1u);
+    const SparsityPattern &pattern = sparsity.at({"f", "x"});
+    EXPECT_EQ(pattern.rows, (std::vector<int64_t>{0, 1, 1}));
+    EXPECT_EQ(pattern.cols, (std::vector<int64_t>{2, 0, 1}));
+    EXPECT_EQ(pattern.num_cols, 3);
+    EXPECT_EQ(pattern.dense_shape, (std::vector<int64_t>{2, 3}));
+}
+
+// Test sparse DeclarePartials error conditions
+TEST_F(DisciplineTest, DeclarePartialsSparseErrorConditions)
+{
+    discipline->AddInput("x", {3}, "m");
+    discipline->AddOutput("f", {2}, "N");
+
+    EXPECT_THROW(discipline->DeclarePartials("f", "x", {0, 1}, {0}), std::invalid_argument);
+    EXPECT_THROW(discipline->DeclarePartials("f", "x", {2}, {0}), std::out_of_range);
+    EXPECT_THROW(discipline->DeclarePartials("f", "x", {0}, {3}), std::out_of_range);
+    EXPECT_THROW(discipline->DeclarePartials("f", "x", {-1}, {0}), std::out_of_range);
+    EXPECT_THROW(discipline->DeclarePartials("f", "x", {1, 1}, {2, 2}), std::invalid_argument);
+    EXPECT_THROW(discipline->DeclarePartials("f", "y", {0}, {0}), std::runtime_error);
+
+    EXPECT_TRUE(discipline->partials_meta().empty());
+    EXPECT_TRUE(discipline->partials_sparsity().empty());
+}
+
 // Test DeclarePartials error conditions (uncovered error paths)
 TEST_F(DisciplineTest, DeclarePartialsErrorConditions)
 {
@@ -225,6 +276,91 @@ TEST_F(DisciplineTest, DeclarePartialsShapeCombinations)
     EXPECT_EQ(discipline->partials_meta().size(), 4);
 }
 
+// Test the variable lookup by name
+TEST_F(DisciplineTest, FindVariableMeta)
+{
+    discipline->AddInput("x", {2}, "m");
+    discipline->AddOutput("f", {3}, "N");
+
+    const VariableMetaData *x = discipline->FindVariableMeta("x");
+    ASSERT_NE(x, nullptr);
+    EXPECT_EQ(x->type(), kInput);
+    EXPECT_EQ(x->shape(0), 2);
+    ASSERT_NE(discipline->FindVariableMeta("f"), nullptr);
+    EXPECT_EQ(discipline->FindVariableMeta("f")->units(), "N");
+    EXPECT_EQ(discipline->FindVariableMeta("y"), nullptr);
+
+    // a new setup may define other variables
+    discipline->ClearMetaData();
+    EXPECT_TRUE(discipline->var_meta().empty());
+    EXPECT_EQ(discipline->FindVariableMeta("x"), nullptr);
+
+    discipline->AddOutput("x", {4}, "m");
+    ASSERT_NE(discipline->FindVariableMeta("x"), nullptr);
+    EXPECT_EQ(discipline->FindVariableMeta("x")->type(), kOutput);
+    EXPECT_EQ(discipline->FindVariableMeta("f"), nullptr);
+}
+
+// Test the declaration of discrete variables
+TEST_F(DisciplineTest, AddDiscreteVariables)
+{
+    discipline->AddInput("x", {2}, "m");
+    discipline->AddDiscreteInput("mask", {2});
+    discipline->AddDiscreteOutput("count", {1});
+    discipline->AddOutput("f", {1}, "m");
+
+    ASSERT_EQ(discipline->var_meta().size(), 4u);
+    EXPECT_EQ(discipline->FindVariableMeta("mask")->type(), kInput);
+    EXPECT_EQ(discipline->FindVariableMeta("count")->type(), kOutput);
+    EXPECT_TRUE(discipline->IsDiscrete("mask"));
+    EXPECT_TRUE(discipline->IsDiscrete("count"));
+    EXPECT_FALSE(discipline->IsDiscrete("x"));
+    EXPECT_EQ(discipline->discrete_variables().size(), 2u);
+
+    // integers have no derivatives
+    EXPECT_THROW(discipline->DeclarePartials("f", "mask"), std::invalid_argument);
+    EXPECT_THROW(discipline->DeclarePartials("count", "x"), std::invalid_argument);
+    EXPECT_NO_THROW(discipline->DeclarePartials("f", "x"));
+
+    discipline->ClearMetaData();
+    EXPECT_FALSE(discipline->IsDiscrete("mask"));
+}
+
+// Test that options leaving the definitions unchanged keep the layout
+TEST_F(DisciplineTest, ShapelessOptionsKeepTheLayout)
+{
+    discipline->AddOption("n", "int");
+    discipline->AddOption("tolerance", "float", false);
+    EXPECT_TRUE(discipline->OptionAffectsShape("n"));
+    EXPECT_FALSE(discipline->OptionAffectsShape("tolerance"));
+    EXPECT_TRUE(discipline->OptionAffectsShape("unknown"));
+
+    google::protobuf::Struct options;
+    (*options.mutable_fields())["n"].set_number_value(3);
+    const uint64_t layout = discipline->layout_generation();
+    discipline->SetOptions(options);
+    EXPECT_NE(discipline->layout_generation(), layout);
+
+    // only the configuration changes with the tolerance
+    const uint64_t configuration = discipline->configuration_generation();
+    const uint64_t applied = discipline->options_generation();
+    options.mutable_fields()->clear();
+    (*options.mutable_fields())["tolerance"].set_number_value(1e-8);
+    discipline->SetOptions(options);
+    EXPECT_NE(discipline->configuration_generation(), configuration);
+    EXPECT_EQ(discipline->options_generation(), applied + 1);
+
+    // resending an unchanged shape option keeps the layout as well
+    const uint64_t unchanged = discipline->layout_generation();
+    (*options.mutable_fields())["n"].set_number_value(3);
+    discipline->SetOptions(options);
+    EXPECT_EQ(discipline->layout_generation(), unchanged);
+
+    (*options.mutable_fields())["n"].set_number_value(4);
+    discipline->SetOptions(options);
+    EXPECT_NE(discipline->layout_generation(), unchanged);
+}
+
 // Test Initialize and Configure method behavior
 TEST_F(DisciplineTest, InitializeConfigureBehavior)
 {
@@ -434,4 +570,44 @@ TEST_F(ConfigurableDisciplineTest, SetOptionsEmptyStruct)
     EXPECT_FALSE(discipline->enable_feature_);
     EXPECT_EQ(discipline->mode_, "default");
     EXPECT_TRUE(discipline->configure_called_);
-}
\ No newline at end of file
+}
+// Discipline recording the variables reported by OnInputReady
+class ReadyDiscipline : public Discipline
+{
+public:
+    void OnInputReady(const std::string &name, const Variable &value) override
+    {
+        if (name == "bad")
+            throw std::runtime_error("preprocessing failed");
+        ready_.push_back(name);
+    }
+
+    std::vector<std::string> ready_;
+};
+
+// Test that OnInputReady fires once all chunks of a variable arrived
+TEST(InputReadyTrackerTest, FiresOnceWhenComplete)
+{
+    ReadyDiscipline discipline;
+    Variable x(kInput, {5});
+
+    // disabled by default
+    InputReadyTracker disabled(&discipline);
+    EXPECT_TRUE(disabled.Received("x", x, 5).ok());
+    EXPECT_TRUE(discipline.ready_.empty());
+
+    discipline.EnableInputReadyNotifications();
+    InputReadyTracker tracker(&discipline);
+    EXPECT_TRUE(tracker.Received("x", x, 3).ok());
+    EXPECT_TRUE(discipline.ready_.empty());
+    EXPECT_TRUE(tracker.Received("x", x, 2).ok());
+    EXPECT_EQ(discipline.ready_, std::vector<std::string>{"x"});
+
+    // resent chunks do not fire again
+    EXPECT_TRUE(tracker.Received("x", x, 2).ok());
+    EXPECT_EQ(discipline.ready_.size(), 1u);
+
+    grpc::Status status = tracker.Received("bad", x, 5);
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INTERNAL);
+    EXPECT_THAT(status.error_message(), HasSubstr("preprocessing failed"));
+}
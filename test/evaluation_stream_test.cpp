@@ -0,0 +1,172 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/test/server_context_test_spouse.h>
+
+#include <callback_server.h>
+#include <evaluation_stream.h>
+#include <protocol_extensions.h>
+
+using namespace philote;
+
+namespace
+{
+    Array MakeMessage(const std::string &name, double value)
+    {
+        Array message;
+        message.set_name(name);
+        message.add_data(value);
+        return message;
+    }
+
+    //! Handler echoing the sum of the values of an evaluation
+    grpc::Status SumHandler(grpc::ServerReaderWriterInterface<Array, Array> *stream)
+    {
+        double sum = 0.0;
+        Array message;
+        while (stream->Read(&message))
+            sum += message.data(0);
+
+        stream->Write(MakeMessage("sum", sum));
+        return grpc::Status::OK;
+    }
+}
+
+TEST(EvaluationStreamTests, EndOfEvaluationMessage)
+{
+    Array marker = EndOfEvaluation(7);
+    EXPECT_TRUE(IsEndOfEvaluation(marker));
+    EXPECT_EQ(marker.end(), 7);
+    EXPECT_EQ(marker.data_size(), 0);
+
+    EXPECT_FALSE(IsEndOfEvaluation(MakeMessage("x", 1.0)));
+
+    // packed messages also have an empty name
+    Array packed;
+    packed.set_subname("0,1,x,");
+    EXPECT_FALSE(IsEndOfEvaluation(packed));
+}
+
+TEST(EvaluationStreamTests, FrameStreamSplitsEvaluations)
+{
+    BufferedArrayStream buffer;
+    buffer.Push(MakeMessage("x", 1.0));
+    buffer.Push(MakeMessage("y", 2.0));
+    buffer.Push(EndOfEvaluation(1));
+    buffer.Push(EndOfEvaluation(2));
+
+    EvaluationFrameStream first(&buffer);
+    ASSERT_TRUE(first.Start());
+    Array message;
+    EXPECT_TRUE(first.Read(&message));
+    EXPECT_EQ(message.name(), "x");
+    EXPECT_TRUE(first.Read(&message));
+    EXPECT_EQ(message.name(), "y");
+    EXPECT_FALSE(first.Read(&message));
+    EXPECT_TRUE(first.Skip());
+    EXPECT_EQ(first.id(), 1u);
+
+    // evaluations without inputs end right away
+    EvaluationFrameStream second(&buffer);
+    ASSERT_TRUE(second.Start());
+    EXPECT_FALSE(second.Read(&message));
+    EXPECT_EQ(second.id(), 2u);
+
+    EvaluationFrameStream closed(&buffer);
+    EXPECT_FALSE(closed.Start());
+}
+
+TEST(EvaluationStreamTests, ServeEvaluationsWithoutRequestCallsHandlerOnce)
+{
+    BufferedArrayStream buffer;
+    buffer.Push(MakeMessage("x", 1.0));
+    buffer.Push(MakeMessage("y", 2.0));
+
+    grpc::ServerContext context;
+    EXPECT_TRUE(ServeEvaluations(&context, &buffer, SumHandler).ok());
+
+    ASSERT_EQ(buffer.written().size(), 1u);
+    EXPECT_DOUBLE_EQ(buffer.written()[0].data(0), 3.0);
+}
+
+TEST(EvaluationStreamTests, ServeEvaluationsEndsEveryEvaluation)
+{
+    grpc::ServerContext context;
+    grpc::testing::ServerContextTestSpouse spouse(&context);
+    spouse.AddClientMetadata(kEvaluationStreamMetadataKey, "1");
+    EXPECT_TRUE(RequestsEvaluationStream(&context));
+
+    BufferedArrayStream buffer;
+    buffer.Push(MakeMessage("x", 1.0));
+    buffer.Push(MakeMessage("y", 2.0));
+    buffer.Push(EndOfEvaluation(1));
+    buffer.Push(MakeMessage("x", 5.0));
+    buffer.Push(EndOfEvaluation(2));
+
+    EXPECT_TRUE(ServeEvaluations(&context, &buffer, SumHandler).ok());
+
+    const std::vector<Array> &written = buffer.written();
+    ASSERT_EQ(written.size(), 4u);
+    EXPECT_DOUBLE_EQ(written[0].data(0), 3.0);
+    EXPECT_TRUE(IsEndOfEvaluation(written[1]));
+    EXPECT_EQ(written[1].end(), 1);
+    EXPECT_DOUBLE_EQ(written[2].data(0), 5.0);
+    EXPECT_TRUE(IsEndOfEvaluation(written[3]));
+    EXPECT_EQ(written[3].end(), 2);
+}
+
+TEST(EvaluationStreamTests, ServeEvaluationsStopsAtFailedEvaluation)
+{
+    grpc::ServerContext context;
+    grpc::testing::ServerContextTestSpouse spouse(&context);
+    spouse.AddClientMetadata(kEvaluationStreamMetadataKey, "1");
+
+    BufferedArrayStream buffer;
+    buffer.Push(MakeMessage("x", 1.0));
+    buffer.Push(EndOfEvaluation(1));
+    buffer.Push(MakeMessage("x", 2.0));
+    buffer.Push(EndOfEvaluation(2));
+
+    size_t calls = 0;
+    grpc::Status status = ServeEvaluations(&context, &buffer,
+                                           [&calls](grpc::ServerReaderWriterInterface<Array, Array> *)
+                                           {
+                                               calls++;
+                                               return grpc::Status(grpc::StatusCode::INTERNAL, "failed");
+                                           });
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INTERNAL);
+    EXPECT_EQ(calls, 1u);
+    EXPECT_TRUE(buffer.written().empty());
+}
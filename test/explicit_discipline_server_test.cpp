@@ -20,6 +20,7 @@
 #include <gmock/gmock.h>
 #include <memory>
 #include <grpcpp/grpcpp.h>
+#include <grpcpp/test/server_context_test_spouse.h>
 
 #include "explicit.h"
 #include "test_helpers.h"
@@ -590,6 +591,372 @@ TEST_F(ExplicitServerTest, ComputeGradientComputePartialsThrows) {
     EXPECT_THAT(status.error_message(), HasSubstr("partials"));
 }
 
+// ============================================================================
+// ComputeFunction - Batched Evaluation Tests
+// ============================================================================
+
+TEST_F(ExplicitServerTest, ComputeFunctionBatch) {
+    auto discipline = CreateSimpleDiscipline();
+    server_->LinkPointers(discipline);
+
+    grpc::testing::ServerContextTestSpouse spouse(context_.get());
+    spouse.AddClientMetadata(kBatchSizeMetadataKey, "2");
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+
+    // inputs of point 0 (x=1, y=2) and point 1 (x=3, y=4)
+    std::vector<philote::Array> messages = {
+        CreateInputArray("x", {1.0}), CreateInputArray("y", {2.0}),
+        CreateInputArray("x", {3.0}), CreateInputArray("y", {4.0})};
+    messages[0].set_subname("0");
+    messages[1].set_subname("0");
+    messages[2].set_subname("1");
+    messages[3].set_subname("1");
+
+    size_t next = 0;
+    EXPECT_CALL(*stream, Read(_))
+        .WillRepeatedly(Invoke([&](philote::Array* array) {
+            if (next == messages.size())
+                return false;
+            *array = messages[next++];
+            return true;
+        }));
+
+    std::map<std::string, double> written;
+    EXPECT_CALL(*stream, Write(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](const philote::Array& array, grpc::WriteOptions) {
+            EXPECT_EQ(array.name(), "f");
+            written[array.subname()] = array.data(0);
+            return true;
+        }));
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    EXPECT_TRUE(status.ok()) << status.error_message();
+    EXPECT_DOUBLE_EQ(written["0"], 5.0);
+    EXPECT_DOUBLE_EQ(written["1"], 25.0);
+}
+
+TEST_F(ExplicitServerTest, ComputeFunctionBatchInvalidSize) {
+    auto discipline = CreateSimpleDiscipline();
+    server_->LinkPointers(discipline);
+
+    grpc::testing::ServerContextTestSpouse spouse(context_.get());
+    spouse.AddClientMetadata(kBatchSizeMetadataKey, "zero");
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+    EXPECT_CALL(*stream, Read(_)).Times(0);
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_THAT(status.error_message(), HasSubstr("batch size"));
+}
+
+TEST_F(ExplicitServerTest, ComputeFunctionBatchInvalidPointIndex) {
+    auto discipline = CreateSimpleDiscipline();
+    server_->LinkPointers(discipline);
+
+    grpc::testing::ServerContextTestSpouse spouse(context_.get());
+    spouse.AddClientMetadata(kBatchSizeMetadataKey, "2");
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(Invoke([this](philote::Array* array) {
+            *array = CreateInputArray("x", {1.0});
+            array->set_subname("2");
+            return true;
+        }));
+    EXPECT_CALL(*stream, Write(_, _)).Times(0);
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_THAT(status.error_message(), HasSubstr("design point"));
+}
+
+// ============================================================================
+// ComputeFunction - Packed Variable Tests
+// ============================================================================
+
+TEST_F(ExplicitServerTest, ComputeFunctionPacked) {
+    auto discipline = CreateSimpleDiscipline();
+    server_->LinkPointers(discipline);
+
+    grpc::testing::ServerContextTestSpouse spouse(context_.get());
+    spouse.AddClientMetadata(kPackedVariablesMetadataKey, "1");
+
+    // both inputs (x=3, y=4) in one message
+    Variable x(kInput, {1}), y(kInput, {1});
+    x(0) = 3.0;
+    y(0) = 4.0;
+    ArrayPacker packer(kInput, 10);
+    packer.Add("x", x);
+    packer.Add("y", y);
+    std::vector<philote::Array> messages = packer.Finish();
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+    size_t next = 0;
+    EXPECT_CALL(*stream, Read(_))
+        .WillRepeatedly(Invoke([&](philote::Array* array) {
+            if (next == messages.size())
+                return false;
+            *array = messages[next++];
+            return true;
+        }));
+
+    philote::Array written;
+    EXPECT_CALL(*stream, Write(_, _))
+        .WillOnce(Invoke([&](const philote::Array& array, grpc::WriteOptions) {
+            written = array;
+            return true;
+        }));
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    EXPECT_TRUE(status.ok()) << status.error_message();
+    ASSERT_TRUE(IsPackedArray(written));
+    std::vector<PackedEntry> entries = DecodePackedIndex(written);
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].name, "f");
+    EXPECT_DOUBLE_EQ(written.data(0), 25.0);
+}
+
+TEST_F(ExplicitServerTest, ComputeFunctionPackedUnknownInput) {
+    auto discipline = CreateSimpleDiscipline();
+    server_->LinkPointers(discipline);
+
+    Variable z(kInput, {1});
+    ArrayPacker packer(kInput, 10);
+    packer.Add("z", z);
+    philote::Array message = packer.Finish()[0];
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(Invoke([&](philote::Array* array) {
+            *array = message;
+            return true;
+        }));
+    EXPECT_CALL(*stream, Write(_, _)).Times(0);
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_THAT(status.error_message(), HasSubstr("z"));
+}
+
+// ============================================================================
+// ComputeFunction - Streaming Output Tests
+// ============================================================================
+
+// finalizes a before computing b and records what was written meanwhile
+class StreamingDiscipline : public ExplicitDiscipline {
+public:
+    void Setup() override {
+        AddInput("x", {1}, "m");
+        AddOutput("a", {1}, "m");
+        AddOutput("b", {1}, "m");
+    }
+
+    void ComputeStreaming(const FlatVariables &inputs, FlatVariables &outputs,
+                          OutputWriter &writer) override {
+        outputs.at("a")(0) = 2.0 * inputs.at("x")(0);
+        writer.Finalize("a");
+        written_before_b_ = *written_;
+        outputs.at("b")(0) = 3.0 * inputs.at("x")(0);
+    }
+
+    std::vector<std::string> *written_ = nullptr;
+    std::vector<std::string> written_before_b_;
+};
+
+TEST_F(ExplicitServerTest, ComputeFunctionStreamsFinalizedOutputs) {
+    auto discipline = std::make_shared<StreamingDiscipline>();
+    discipline->Setup();
+    server_->LinkPointers(discipline);
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(Invoke([this](philote::Array* array) {
+            *array = CreateInputArray("x", {1.0});
+            return true;
+        }))
+        .WillOnce(Return(false));
+
+    std::vector<std::string> written;
+    std::map<std::string, double> values;
+    discipline->written_ = &written;
+    EXPECT_CALL(*stream, Write(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](const philote::Array& array, grpc::WriteOptions) {
+            written.push_back(array.name());
+            values[array.name()] = array.data(0);
+            return true;
+        }));
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    EXPECT_TRUE(status.ok()) << status.error_message();
+    EXPECT_EQ(discipline->written_before_b_, std::vector<std::string>{"a"});
+    EXPECT_EQ(written, (std::vector<std::string>{"a", "b"}));
+    EXPECT_DOUBLE_EQ(values["a"], 2.0);
+    EXPECT_DOUBLE_EQ(values["b"], 3.0);
+}
+
+// records what was written before the memoized partials were computed
+class MemoizedStreamingDiscipline : public StreamingDiscipline {
+public:
+    void ComputePartials(const Variables &inputs, Partials &partials) override {
+        written_before_partials_ = *written_;
+    }
+
+    std::vector<std::string> written_before_partials_;
+};
+
+TEST_F(ExplicitServerTest, PartialsMemoizationKeepsStreamingOutputs) {
+    auto discipline = std::make_shared<MemoizedStreamingDiscipline>();
+    discipline->Setup();
+    discipline->EnablePartialsMemoization();
+    server_->LinkPointers(discipline);
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(Invoke([this](philote::Array* array) {
+            *array = CreateInputArray("x", {1.0});
+            return true;
+        }))
+        .WillOnce(Return(false));
+
+    std::vector<std::string> written;
+    discipline->written_ = &written;
+    EXPECT_CALL(*stream, Write(_, _))
+        .Times(2)
+        .WillRepeatedly(Invoke([&](const philote::Array& array, grpc::WriteOptions) {
+            written.push_back(array.name());
+            return true;
+        }));
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    // the partials are computed after the outputs, not instead of streaming
+    EXPECT_TRUE(status.ok()) << status.error_message();
+    EXPECT_EQ(discipline->written_before_b_, std::vector<std::string>{"a"});
+    EXPECT_EQ(discipline->written_before_partials_, std::vector<std::string>{"a"});
+    EXPECT_EQ(written, (std::vector<std::string>{"a", "b"}));
+}
+
+// ============================================================================
+// ComputeFunction - Fused Gradient and Memoization Tests
+// ============================================================================
+
+TEST_F(ExplicitServerTest, ComputeFunctionFusedGradient) {
+    auto discipline = CreateSimpleDiscipline();
+    server_->LinkPointers(discipline);
+
+    grpc::testing::ServerContextTestSpouse spouse(context_.get());
+    spouse.AddClientMetadata(kFusedGradientMetadataKey, "1");
+
+    auto stream = std::make_unique<MockServerReaderWriter>();
+    EXPECT_CALL(*stream, Read(_))
+        .WillOnce(Invoke([this](philote::Array* array) {
+            *array = CreateInputArray("x", {3.0});
+            return true;
+        }))
+        .WillOnce(Invoke([this](philote::Array* array) {
+            *array = CreateInputArray("y", {4.0});
+            return true;
+        }))
+        .WillOnce(Return(false));
+
+    // the output is followed by both partials
+    std::vector<philote::Array> written;
+    EXPECT_CALL(*stream, Write(_, _))
+        .Times(3)
+        .WillRepeatedly(Invoke([&](const philote::Array& array, grpc::WriteOptions) {
+            written.push_back(array);
+            return true;
+        }));
+
+    grpc::Status status = server_->ComputeFunctionForTesting(context_.get(), stream.get());
+
+    EXPECT_TRUE(status.ok()) << status.error_message();
+    ASSERT_EQ(written.size(), 3u);
+    EXPECT_EQ(written[0].name(), "f");
+    EXPECT_TRUE(written[0].subname().empty());
+    EXPECT_DOUBLE_EQ(written[0].data(0), 25.0);
+
+    std::map<std::string, double> partials;
+    for (size_t i = 1; i < written.size(); i++)
+    {
+        EXPECT_EQ(written[i].name(), "f");
+        partials[written[i].subname()] = written[i].data(0);
+    }
+    EXPECT_DOUBLE_EQ(partials["x"], 6.0);
+    EXPECT_DOUBLE_EQ(partials["y"], 8.0);
+}
+
+// counts the calls of the partials function
+class MemoizedParaboloid : public ParaboloidDiscipline {
+public:
+    void ComputePartials(const Variables &inputs, Partials &partials) override {
+        partials_calls_++;
+        ParaboloidDiscipline::ComputePartials(inputs, partials);
+    }
+
+    int partials_calls_ = 0;
+};
+
+TEST_F(ExplicitServerTest, ComputeGradientRecallsMemoizedPartials) {
+    auto discipline = std::make_shared<MemoizedParaboloid>();
+    discipline->Initialize();
+    discipline->Setup();
+    discipline->SetupPartials();
+    discipline->EnablePartialsMemoization();
+    server_->LinkPointers(discipline);
+
+    auto evaluate = [this](bool gradient, double y) {
+        auto stream = std::make_unique<MockServerReaderWriter>();
+        EXPECT_CALL(*stream, Read(_))
+            .WillOnce(Invoke([this](philote::Array* array) {
+                *array = CreateInputArray("x", {3.0});
+                return true;
+            }))
+            .WillOnce(Invoke([this, y](philote::Array* array) {
+                *array = CreateInputArray("y", {y});
+                return true;
+            }))
+            .WillOnce(Return(false));
+
+        std::map<std::string, double> values;
+        EXPECT_CALL(*stream, Write(_, _))
+            .WillRepeatedly(Invoke([&](const philote::Array& array, grpc::WriteOptions) {
+                values[array.subname()] = array.data(0);
+                return true;
+            }));
+
+        grpc::ServerContext context;
+        grpc::Status status = gradient ? server_->ComputeGradientForTesting(&context, stream.get())
+                                       : server_->ComputeFunctionForTesting(&context, stream.get());
+        EXPECT_TRUE(status.ok()) << status.error_message();
+        return values;
+    };
+
+    // the function evaluation computes the partials once
+    EXPECT_DOUBLE_EQ(evaluate(false, 4.0)[""], 25.0);
+    EXPECT_EQ(discipline->partials_calls_, 1);
+
+    std::map<std::string, double> partials = evaluate(true, 4.0);
+    EXPECT_EQ(discipline->partials_calls_, 1);
+    EXPECT_DOUBLE_EQ(partials["x"], 6.0);
+    EXPECT_DOUBLE_EQ(partials["y"], 8.0);
+
+    // other inputs are not served from the memo
+    partials = evaluate(true, 5.0);
+    EXPECT_EQ(discipline->partials_calls_, 2);
+    EXPECT_DOUBLE_EQ(partials["y"], 10.0);
+}
+
 // ============================================================================
 // Destructor Test
 // ============================================================================
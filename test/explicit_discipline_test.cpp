@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <atomic>
 #include <set>
 #include <memory>
 #include <stdexcept>
@@ -404,4 +405,215 @@ TEST_F(ExplicitDisciplineTest, RegisterServicesRegistersServers)
             server->Shutdown();
         }
     });
-}
\ No newline at end of file
+}
+// ============================================================================
+// Block Partials Tests
+// ============================================================================
+
+// computes every partial block separately
+class BlockExplicitDiscipline : public ExplicitDiscipline
+{
+public:
+    BlockExplicitDiscipline() { EnableBlockPartials(3); }
+
+    void Setup() override
+    {
+        AddInput("x1", {2}, "m");
+        AddInput("x2", {3}, "kg");
+        AddOutput("y1", {2}, "m");
+        AddOutput("y2", {3}, "kg");
+    }
+
+    void SetupPartials() override
+    {
+        DeclarePartials("y1", "x1");
+        DeclarePartials("y1", "x2");
+        DeclarePartials("y2", "x1");
+        DeclarePartials("y2", "x2");
+    }
+
+    void ComputePartial(const std::string &of, const std::string &wrt,
+                        const Variables &inputs, Variable &block) override
+    {
+        if (of + wrt == failing_)
+            throw std::runtime_error("block failed");
+
+        // every entry holds the first value of wrt
+        for (size_t i = 0; i < block.Size(); ++i)
+            block(i) = inputs.at(wrt)(0);
+    }
+
+    std::string failing_;
+};
+
+TEST_F(ExplicitDisciplineTest, BlockPartialsComputeEveryBlock)
+{
+    BlockExplicitDiscipline blocks;
+    EXPECT_TRUE(blocks.block_partials());
+    EXPECT_FALSE(discipline->block_partials());
+
+    Variables inputs;
+    inputs["x1"] = Variable(kInput, {2});
+    inputs["x2"] = Variable(kInput, {3});
+    inputs.at("x1")(0) = 1.5;
+    inputs.at("x2")(0) = 2.5;
+
+    Partials partials;
+    partials[std::make_pair("y1", "x1")] = Variable(kPartial, {2, 2});
+    partials[std::make_pair("y1", "x2")] = Variable(kPartial, {2, 3});
+    partials[std::make_pair("y2", "x1")] = Variable(kPartial, {3, 2});
+    partials[std::make_pair("y2", "x2")] = Variable(kPartial, {3, 3});
+
+    // the callback sees every block once
+    std::set<std::pair<std::string, std::string>> finished;
+    blocks.ComputePartialBlocks(inputs, partials,
+                                [&finished](const std::string &of, const std::string &wrt, const Variable &block)
+                                {
+                                    EXPECT_TRUE(finished.insert({of, wrt}).second);
+                                    EXPECT_GT(block.Size(), 0u);
+                                });
+    EXPECT_EQ(finished.size(), 4u);
+
+    EXPECT_DOUBLE_EQ(partials[std::make_pair("y1", "x1")](3), 1.5);
+    EXPECT_DOUBLE_EQ(partials[std::make_pair("y2", "x2")](8), 2.5);
+
+    // the default ComputePartials computes the blocks as well
+    partials[std::make_pair("y2", "x1")](0) = 0.0;
+    blocks.ComputePartials(inputs, partials);
+    EXPECT_DOUBLE_EQ(partials[std::make_pair("y2", "x1")](0), 1.5);
+}
+
+TEST_F(ExplicitDisciplineTest, BlockPartialsRethrowErrors)
+{
+    BlockExplicitDiscipline blocks;
+    blocks.failing_ = "y2x1";
+
+    Variables inputs;
+    inputs["x1"] = Variable(kInput, {2});
+    inputs["x2"] = Variable(kInput, {3});
+
+    Partials partials;
+    partials[std::make_pair("y1", "x1")] = Variable(kPartial, {2, 2});
+    partials[std::make_pair("y2", "x1")] = Variable(kPartial, {3, 2});
+
+    EXPECT_THROW(blocks.ComputePartialBlocks(inputs, partials), std::runtime_error);
+
+    // errors of the callback are rethrown as well
+    blocks.failing_.clear();
+    EXPECT_THROW(blocks.ComputePartialBlocks(inputs, partials,
+                                             [](const std::string &, const std::string &, const Variable &)
+                                             { throw std::runtime_error("send failed"); }),
+                 std::runtime_error);
+
+    // disciplines without block partials cannot compute blocks
+    EXPECT_THROW(discipline->ComputePartialBlocks(inputs, partials), std::logic_error);
+}
+
+// ============================================================================
+// Finite Difference Partials Tests
+// ============================================================================
+
+// squares (diagonal Jacobian) and weighted sum (dense Jacobian) of x
+class FiniteDifferenceDiscipline : public ExplicitDiscipline
+{
+public:
+    void Setup() override
+    {
+        AddInput("x", {4}, "m");
+        AddOutput("squares", {4}, "m**2");
+        AddOutput("sum", {1}, "m");
+    }
+
+    void SetupPartials() override
+    {
+        DeclarePartials("squares", "x", {0, 1, 2, 3}, {0, 1, 2, 3}, PartialsMethod::kCentralDifference);
+        DeclarePartials("sum", "x", PartialsMethod::kForwardDifference);
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override
+    {
+        evaluations++;
+        outputs.at("sum")(0) = 0.0;
+        for (size_t i = 0; i < 4; ++i)
+        {
+            outputs.at("squares")(i) = inputs.at("x")(i) * inputs.at("x")(i);
+            outputs.at("sum")(0) += static_cast<double>(i + 1) * inputs.at("x")(i);
+        }
+    }
+
+    std::atomic<int> evaluations{0};
+};
+
+class FiniteDifferenceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        discipline = std::make_shared<FiniteDifferenceDiscipline>();
+        discipline->Setup();
+        discipline->SetupPartials();
+
+        inputs["x"] = Variable(kInput, {4});
+        for (size_t i = 0; i < 4; ++i)
+            inputs.at("x")(i) = 1.0 + static_cast<double>(i);
+
+        for (const auto &meta : discipline->partials_meta())
+            partials[std::make_pair(meta.name(), meta.subname())] = Variable(meta);
+    }
+
+    void ExpectPartials()
+    {
+        for (size_t i = 0; i < 4; ++i)
+        {
+            EXPECT_NEAR(partials[std::make_pair("squares", "x")](i), 2.0 * inputs.at("x")(i), 1e-6);
+            EXPECT_NEAR(partials[std::make_pair("sum", "x")](i), static_cast<double>(i + 1), 1e-6);
+        }
+    }
+
+    std::shared_ptr<FiniteDifferenceDiscipline> discipline;
+    Variables inputs;
+    Partials partials;
+};
+
+TEST_F(FiniteDifferenceTest, DeclaresApproximatedPartials)
+{
+    EXPECT_EQ(discipline->partials_method("squares", "x"), PartialsMethod::kCentralDifference);
+    EXPECT_EQ(discipline->partials_method("sum", "x"), PartialsMethod::kForwardDifference);
+    EXPECT_EQ(discipline->partials_method("sum", "y"), PartialsMethod::kAnalytic);
+    EXPECT_EQ(discipline->partials_sparsity().count({"squares", "x"}), 1u);
+
+    EXPECT_THROW(discipline->DeclarePartials("sum", "x", PartialsMethod::kForwardDifference, 0.0),
+                 std::invalid_argument);
+
+    // the declarations are removed with the meta data
+    discipline->ClearMetaData();
+    EXPECT_EQ(discipline->partials_method("sum", "x"), PartialsMethod::kAnalytic);
+}
+
+TEST_F(FiniteDifferenceTest, ComputesPartialsSerially)
+{
+    discipline->ComputePartials(inputs, partials);
+    ExpectPartials();
+
+    // the base point, one evaluation per column of sum, and the whole diagonal
+    // of squares in both directions
+    EXPECT_EQ(discipline->evaluations.load(), 1 + 4 + 2);
+}
+
+TEST_F(FiniteDifferenceTest, ComputesPartialsOnPooledInstances)
+{
+    std::atomic<int> created{0};
+    discipline->EnableParallelFiniteDifferences([&created]
+                                                {
+                                                    created++;
+                                                    return std::make_shared<FiniteDifferenceDiscipline>(); },
+                                                3);
+
+    discipline->ComputePartials(inputs, partials);
+    ExpectPartials();
+
+    // only the base point was evaluated by the primary instance
+    EXPECT_EQ(discipline->evaluations.load(), 1);
+    EXPECT_GE(created.load(), 1);
+    EXPECT_LE(created.load(), 3);
+}
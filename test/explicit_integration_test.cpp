@@ -17,9 +17,17 @@
 */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <unistd.h>
 
 #include "explicit.h"
 #include "test_helpers.h"
@@ -525,3 +533,1671 @@ TEST_F(ExplicitIntegrationTest, NoFalsePositiveCancellation) {
     EXPECT_DOUBLE_EQ(outputs["y"](0), 6.0);  // y = 2*x = 2*3 = 6
     EXPECT_FALSE(discipline->WasCancelled());
 }
+
+// ============================================================================
+// Batched Evaluation Tests
+// ============================================================================
+
+/**
+ * Paraboloid that records how it was called for batched evaluations
+ */
+class BatchCountingParaboloid : public ParaboloidDiscipline {
+public:
+    void ComputeBatch(const std::vector<Variables> &inputs,
+                      std::vector<Variables> &outputs) override {
+        batch_calls_++;
+        last_batch_size_ = inputs.size();
+        ExplicitDiscipline::ComputeBatch(inputs, outputs);
+    }
+
+    int batch_calls_ = 0;
+    size_t last_batch_size_ = 0;
+};
+
+TEST_F(ExplicitIntegrationTest, BatchedFunctionComputation) {
+    auto discipline = std::make_shared<BatchCountingParaboloid>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+
+    EXPECT_TRUE(client.ServerSupports(kFeatureBatch));
+
+    std::vector<Variables> points(10);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        points[i]["x"] = CreateScalarVariable(static_cast<double>(i));
+        points[i]["y"] = CreateScalarVariable(1.0);
+    }
+
+    std::vector<Variables> outputs = client.ComputeFunctionBatch(points);
+
+    ASSERT_EQ(outputs.size(), points.size());
+    for (size_t i = 0; i < outputs.size(); i++)
+        EXPECT_DOUBLE_EQ(outputs[i].at("f")(0), static_cast<double>(i * i) + 1.0);
+
+    // all points were evaluated in a single call
+    EXPECT_EQ(discipline->batch_calls_, 1);
+    EXPECT_EQ(discipline->last_batch_size_, points.size());
+}
+
+TEST_F(ExplicitIntegrationTest, BatchedFunctionComputationFallback) {
+    auto discipline = std::make_shared<BatchCountingParaboloid>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.Setup();
+    client.GetVariableDefinitions();
+
+    // without GetInfo, the client does not know about the batch extension
+    EXPECT_FALSE(client.ServerSupports(kFeatureBatch));
+
+    std::vector<Variables> points(3);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        points[i]["x"] = CreateScalarVariable(2.0);
+        points[i]["y"] = CreateScalarVariable(static_cast<double>(i));
+    }
+
+    std::vector<Variables> outputs = client.ComputeFunctionBatch(points);
+
+    ASSERT_EQ(outputs.size(), points.size());
+    for (size_t i = 0; i < outputs.size(); i++)
+        EXPECT_DOUBLE_EQ(outputs[i].at("f")(0), 4.0 + static_cast<double>(i * i));
+
+    EXPECT_EQ(discipline->batch_calls_, 0);
+}
+
+TEST_F(ExplicitIntegrationTest, BatchedFunctionComputationEmpty) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    EXPECT_TRUE(client.ComputeFunctionBatch({}).empty());
+}
+
+TEST_F(ExplicitIntegrationTest, AsyncFunctionComputation) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    // start many evaluations before waiting for any of them
+    std::vector<std::future<Variables>> futures;
+    for (int i = 0; i < 32; i++)
+    {
+        Variables inputs;
+        inputs["x"] = CreateScalarVariable(static_cast<double>(i));
+        inputs["y"] = CreateScalarVariable(1.0);
+        futures.push_back(client.ComputeFunctionAsync(inputs));
+    }
+
+    for (int i = 0; i < 32; i++)
+    {
+        Variables outputs = futures[i].get();
+        EXPECT_DOUBLE_EQ(outputs.at("f")(0), static_cast<double>(i * i) + 1.0);
+    }
+}
+
+TEST_F(ExplicitIntegrationTest, AsyncFunctionComputationCallback) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    std::mutex mutex;
+    std::condition_variable done;
+    bool finished = false;
+    double f = 0.0;
+    std::exception_ptr error;
+
+    client.ComputeFunctionAsync(inputs, [&](Variables outputs, std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!e)
+            f = outputs.at("f")(0);
+        error = e;
+        finished = true;
+        done.notify_one();
+    });
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, std::chrono::seconds(10), [&] { return finished; }));
+    EXPECT_FALSE(error);
+    EXPECT_DOUBLE_EQ(f, 25.0);
+}
+
+TEST_F(ExplicitIntegrationTest, AsyncGradientComputation) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    // overlap a function and a gradient evaluation
+    auto function = client.ComputeFunctionAsync(inputs);
+    auto gradient = client.ComputeGradientAsync(inputs);
+
+    Partials partials = gradient.get();
+    EXPECT_DOUBLE_EQ((partials.at({"f", "x"})(0)), 6.0);
+    EXPECT_DOUBLE_EQ((partials.at({"f", "y"})(0)), 8.0);
+    EXPECT_DOUBLE_EQ(function.get().at("f")(0), 25.0);
+}
+
+TEST_F(ExplicitIntegrationTest, AsyncFunctionComputationError) {
+    auto discipline = std::make_shared<ErrorDiscipline>(ErrorDiscipline::ErrorMode::THROW_ON_COMPUTE);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(1.0);
+
+    auto future = client.ComputeFunctionAsync(inputs);
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST_F(ExplicitIntegrationTest, CallbackEngineFunctionAndGradient) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    Variables outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs.at("f")(0), 25.0);
+
+    Partials partials = client.ComputeGradient(inputs);
+    EXPECT_DOUBLE_EQ((partials.at({"f", "x"})(0)), 6.0);
+    EXPECT_DOUBLE_EQ((partials.at({"f", "y"})(0)), 8.0);
+}
+
+TEST_F(ExplicitIntegrationTest, CallbackEngineConcurrentCalls) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+    discipline->EnableInstancePool([]
+        { return std::make_shared<ParaboloidDiscipline>(); }, 4);
+
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    std::vector<std::future<Variables>> futures;
+    for (int i = 0; i < 64; i++)
+    {
+        Variables inputs;
+        inputs["x"] = CreateScalarVariable(static_cast<double>(i));
+        inputs["y"] = CreateScalarVariable(2.0);
+        futures.push_back(client.ComputeFunctionAsync(inputs));
+    }
+
+    for (int i = 0; i < 64; i++)
+        EXPECT_DOUBLE_EQ(futures[i].get().at("f")(0), static_cast<double>(i * i) + 4.0);
+}
+
+TEST_F(ExplicitIntegrationTest, CallbackEngineBatchedFunctionComputation) {
+    auto discipline = std::make_shared<BatchCountingParaboloid>();
+
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    std::vector<Variables> points(10);
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        points[i]["x"] = CreateScalarVariable(static_cast<double>(i));
+        points[i]["y"] = CreateScalarVariable(1.0);
+    }
+
+    std::vector<Variables> outputs = client.ComputeFunctionBatch(points);
+
+    ASSERT_EQ(outputs.size(), points.size());
+    for (size_t i = 0; i < outputs.size(); i++)
+        EXPECT_DOUBLE_EQ(outputs[i].at("f")(0), static_cast<double>(i * i) + 1.0);
+    EXPECT_EQ(discipline->batch_calls_, 1);
+}
+
+TEST_F(ExplicitIntegrationTest, CallbackEngineError) {
+    auto discipline = std::make_shared<ErrorDiscipline>(ErrorDiscipline::ErrorMode::THROW_ON_COMPUTE);
+
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(1.0);
+
+    EXPECT_THROW(client.ComputeFunction(inputs), std::runtime_error);
+}
+
+TEST_F(ExplicitIntegrationTest, CallbackEngineCancellationViaTimeout) {
+    auto discipline = std::make_shared<SlowDiscipline>(500);
+
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+    client.SetRPCTimeout(std::chrono::milliseconds(100));
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(1.0);
+
+    EXPECT_THROW(client.ComputeFunction(inputs), std::runtime_error);
+}
+
+/**
+ * Paraboloid that evaluates on the contiguous variable buffers
+ */
+class FlatParaboloid : public ParaboloidDiscipline {
+public:
+    void ComputeFlat(const FlatVariables &inputs, FlatVariables &outputs) override {
+        flat_calls_++;
+        const FlatVariables::Handle x = inputs.Find("x");
+        const FlatVariables::Handle y = inputs.Find("y");
+        outputs(outputs.Find("f"), 0) = inputs(x, 0) * inputs(x, 0) + inputs(y, 0) * inputs(y, 0);
+    }
+
+    int flat_calls_ = 0;
+};
+
+TEST_F(ExplicitIntegrationTest, FlatFunctionComputation) {
+    auto discipline = std::make_shared<FlatParaboloid>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.Setup();
+    client.GetVariableDefinitions();
+
+    for (int i = 0; i < 3; i++)
+    {
+        Variables inputs;
+        inputs["x"] = CreateScalarVariable(static_cast<double>(i));
+        inputs["y"] = CreateScalarVariable(2.0);
+
+        Variables outputs = client.ComputeFunction(inputs);
+        EXPECT_DOUBLE_EQ(outputs.at("f")(0), static_cast<double>(i * i) + 4.0);
+    }
+
+    EXPECT_EQ(discipline->flat_calls_, 3);
+}
+
+/**
+ * Elementwise square f_i = x_i^2 with a diagonal (sparse) Jacobian
+ */
+class SparseSquareDiscipline : public ExplicitDiscipline {
+public:
+    void Setup() override {
+        AddInput("x", {4}, "m");
+        AddOutput("f", {4}, "m**2");
+    }
+
+    void SetupPartials() override {
+        DeclarePartials("f", "x", {0, 1, 2, 3}, {0, 1, 2, 3});
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        for (size_t i = 0; i < 4; i++)
+            outputs.at("f")(i) = inputs.at("x")(i) * inputs.at("x")(i);
+    }
+
+    void ComputePartials(const Variables &inputs, Partials &partials) override {
+        // only the four non-zeros are stored
+        for (size_t i = 0; i < 4; i++)
+            partials[{"f", "x"}](i) = 2.0 * inputs.at("x")(i);
+    }
+};
+
+TEST_F(ExplicitIntegrationTest, SparseGradientComputation) {
+    auto discipline = std::make_shared<SparseSquareDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    EXPECT_TRUE(client.ServerSupports(kFeatureSparsePartials));
+    ASSERT_EQ(client.GetPartialsSparsity().count({"f", "x"}), 1u);
+    const SparsityPattern &pattern = client.GetPartialsSparsity().at({"f", "x"});
+    EXPECT_EQ(pattern.rows, (std::vector<int64_t>{0, 1, 2, 3}));
+    EXPECT_EQ(pattern.cols, (std::vector<int64_t>{0, 1, 2, 3}));
+    EXPECT_EQ(pattern.dense_shape, (std::vector<int64_t>{4, 4}));
+
+    Variables inputs;
+    inputs["x"] = Variable(kInput, {4});
+    for (size_t i = 0; i < 4; i++)
+        inputs["x"](i) = static_cast<double>(i + 1);
+
+    Partials partials = client.ComputeGradient(inputs);
+    ASSERT_EQ((partials[{"f", "x"}].Size()), 4u);
+    for (size_t i = 0; i < 4; i++)
+        EXPECT_DOUBLE_EQ((partials[{"f", "x"}](i)), 2.0 * (i + 1));
+
+    Variable dense = pattern.Densify(partials[{"f", "x"}]);
+    EXPECT_DOUBLE_EQ(dense(2 * 4 + 2), 6.0);
+    EXPECT_DOUBLE_EQ(dense(2 * 4 + 1), 0.0);
+
+    // the asynchronous call also returns the sparse form
+    Partials async_partials = client.ComputeGradientAsync(inputs).get();
+    EXPECT_EQ((async_partials[{"f", "x"}].Size()), 4u);
+    EXPECT_DOUBLE_EQ((async_partials[{"f", "x"}](3)), 8.0);
+}
+
+TEST_F(ExplicitIntegrationTest, SparseGradientDenseFallback) {
+    auto discipline = std::make_shared<SparseSquareDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    // without GetInfo, the client does not know about sparse partials
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    EXPECT_TRUE(client.GetPartialsSparsity().empty());
+    ASSERT_EQ(client.GetPartialsMetaConst().size(), 1u);
+    EXPECT_EQ(client.GetPartialsMetaConst()[0].shape_size(), 2);
+
+    Variables inputs;
+    inputs["x"] = Variable(kInput, {4});
+    for (size_t i = 0; i < 4; i++)
+        inputs["x"](i) = static_cast<double>(i + 1);
+
+    Partials partials = client.ComputeGradient(inputs);
+    ASSERT_EQ((partials[{"f", "x"}].Size()), 16u);
+    for (size_t i = 0; i < 4; i++)
+    {
+        for (size_t j = 0; j < 4; j++)
+            EXPECT_DOUBLE_EQ((partials[{"f", "x"}](i * 4 + j)), i == j ? 2.0 * (i + 1) : 0.0);
+    }
+}
+
+// ============================================================================
+// Chunk Negotiation Tests
+// ============================================================================
+
+TEST_F(ExplicitIntegrationTest, NegotiatedChunkSize) {
+    // A alone (200 x 100 doubles) exceeds the server's message size limit
+    const size_t n = 200;
+    const size_t m = 100;
+
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    discipline->SetMaxMessageBytes(64 * 1024);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+
+    EXPECT_TRUE(client.ServerSupports(kFeatureChunkNegotiation));
+    EXPECT_EQ(client.GetStreamOptions().num_double(),
+              static_cast<int64_t>(ChunkSizeForMessageBytes(64 * 1024)));
+    EXPECT_EQ(discipline->stream_opts().num_double(), client.GetStreamOptions().num_double());
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 1.0);
+    inputs["x"] = CreateVectorVariable(std::vector<double>(m, 2.0));
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 3.0));
+
+    Variables outputs = client.ComputeFunction(inputs);
+
+    ASSERT_EQ(outputs["z"].Size(), n);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(outputs["z"](i), 2.0 * m + 3.0);
+}
+
+TEST_F(ExplicitIntegrationTest, ManualStreamOptionsAreKept) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+
+    StreamOptions options;
+    options.set_num_double(10);
+    client.SetStreamOptions(options);
+    client.GetInfo();
+
+    EXPECT_EQ(client.GetStreamOptions().num_double(), 10);
+    EXPECT_EQ(discipline->stream_opts().num_double(), 1000);
+}
+
+// ============================================================================
+// Packed Variable Tests
+// ============================================================================
+
+// sum and weighted sum of many scalar inputs
+class ScalarSumDiscipline : public ExplicitDiscipline {
+public:
+    explicit ScalarSumDiscipline(int n) : n_(n) {}
+
+    void Setup() override {
+        for (int i = 0; i < n_; i++)
+            AddInput("x" + std::to_string(i), {1}, "m");
+        AddOutput("sum", {1}, "m");
+        AddOutput("weighted", {1}, "m");
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        double sum = 0.0, weighted = 0.0;
+        for (int i = 0; i < n_; i++)
+        {
+            const double x = inputs.at("x" + std::to_string(i))(0);
+            sum += x;
+            weighted += i * x;
+        }
+        outputs.at("sum")(0) = sum;
+        outputs.at("weighted")(0) = weighted;
+    }
+
+private:
+    int n_;
+};
+
+TEST_F(ExplicitIntegrationTest, PackedScalarInputs) {
+    const int n = 200;
+    auto discipline = std::make_shared<ScalarSumDiscipline>(n);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+
+    EXPECT_TRUE(client.ServerSupports(kFeaturePackedVariables));
+
+    Variables inputs;
+    for (int i = 0; i < n; i++)
+        inputs["x" + std::to_string(i)] = CreateScalarVariable(1.0);
+
+    Variables outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs.at("sum")(0), n);
+    EXPECT_DOUBLE_EQ(outputs.at("weighted")(0), n * (n - 1) / 2.0);
+
+    outputs = client.ComputeFunctionAsync(inputs).get();
+    EXPECT_DOUBLE_EQ(outputs.at("sum")(0), n);
+    EXPECT_DOUBLE_EQ(outputs.at("weighted")(0), n * (n - 1) / 2.0);
+
+    // without the extension, every variable is sent on its own
+    client.SetServerFeatures({});
+    outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs.at("sum")(0), n);
+}
+
+// ============================================================================
+// Pipelined Streaming Tests
+// ============================================================================
+
+// records the inputs reported by OnInputReady before Compute runs
+class ReadyRecordingDiscipline : public VectorizedDiscipline {
+public:
+    ReadyRecordingDiscipline(size_t n, size_t m) : VectorizedDiscipline(n, m) {
+        EnableInputReadyNotifications();
+    }
+
+    void OnInputReady(const std::string &name, const Variable &value) override {
+        ready_.push_back(name);
+        sizes_.push_back(value.Size());
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        ready_at_compute_ = ready_.size();
+        VectorizedDiscipline::Compute(inputs, outputs);
+    }
+
+    std::vector<std::string> ready_;
+    std::vector<size_t> sizes_;
+    size_t ready_at_compute_ = 0;
+};
+
+TEST_F(ExplicitIntegrationTest, PipelinedInputsAndInputReady) {
+    const size_t n = 300;
+    const size_t m = 200;
+
+    auto discipline = std::make_shared<ReadyRecordingDiscipline>(n, m);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+
+    // small chunks and a pipeline for every call
+    StreamOptions options;
+    options.set_num_double(1000);
+    client.SetStreamOptions(options);
+    client.SendStreamOptions();
+    client.SetPipelineThreshold(0);
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 1.0);
+    inputs["x"] = CreateVectorVariable(std::vector<double>(m, 2.0));
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 3.0));
+
+    Variables outputs = client.ComputeFunction(inputs);
+
+    ASSERT_EQ(outputs["z"].Size(), n);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(outputs["z"](i), 2.0 * m + 3.0);
+
+    // every input was reported exactly once, before Compute
+    std::vector<std::string> ready = discipline->ready_;
+    std::sort(ready.begin(), ready.end());
+    EXPECT_EQ(ready, (std::vector<std::string>{"A", "b", "x"}));
+    EXPECT_EQ(discipline->ready_at_compute_, 3u);
+    for (size_t i = 0; i < discipline->ready_.size(); i++)
+        EXPECT_EQ(discipline->sizes_[i], inputs.at(discipline->ready_[i]).Size());
+}
+
+class CountingParaboloid : public ParaboloidDiscipline {
+public:
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        compute_calls_++;
+        ParaboloidDiscipline::Compute(inputs, outputs);
+    }
+
+    void ComputePartials(const Variables &inputs, Partials &partials) override {
+        partials_calls_++;
+        ParaboloidDiscipline::ComputePartials(inputs, partials);
+    }
+
+    int compute_calls_ = 0;
+    int partials_calls_ = 0;
+};
+
+TEST_F(ExplicitIntegrationTest, ResultCacheSkipsRepeatedCalls) {
+    auto discipline = std::make_shared<CountingParaboloid>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    client.EnableResultCache(1 << 20);
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    Variables first = client.ComputeFunction(inputs);
+    Variables second = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(first.at("f")(0), 25.0);
+    EXPECT_DOUBLE_EQ(second.at("f")(0), 25.0);
+    EXPECT_EQ(discipline->compute_calls_, 1);
+
+    client.ComputeGradient(inputs);
+    Partials partials = client.ComputeGradient(inputs);
+    EXPECT_DOUBLE_EQ((partials[{"f", "x"}](0)), 6.0);
+    EXPECT_EQ(discipline->partials_calls_, 1);
+
+    // changed inputs are evaluated remotely
+    inputs["y"](0) = 5.0;
+    EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs).at("f")(0), 34.0);
+    EXPECT_EQ(discipline->compute_calls_, 2);
+
+    ResultCacheStats stats = client.GetResultCacheStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.entries, 3u);
+
+    // reconfiguring the server invalidates the cached results
+    client.Setup();
+    client.ComputeFunction(inputs);
+    EXPECT_EQ(discipline->compute_calls_, 3);
+}
+
+TEST_F(ExplicitIntegrationTest, ComputeFunctionAndGradientSingleCall) {
+    auto discipline = std::make_shared<CountingParaboloid>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    ASSERT_TRUE(client.ServerSupports(kFeatureFusedGradient));
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    auto result = client.ComputeFunctionAndGradient(inputs);
+    EXPECT_DOUBLE_EQ(result.first.at("f")(0), 25.0);
+    EXPECT_DOUBLE_EQ((result.second[{"f", "x"}](0)), 6.0);
+    EXPECT_DOUBLE_EQ((result.second[{"f", "y"}](0)), 8.0);
+    EXPECT_EQ(discipline->compute_calls_, 1);
+    EXPECT_EQ(discipline->partials_calls_, 1);
+}
+
+TEST_F(ExplicitIntegrationTest, PartialsMemoizationSkipsComputePartials) {
+    auto discipline = std::make_shared<CountingParaboloid>();
+    discipline->EnablePartialsMemoization();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs).at("f")(0), 25.0);
+    Partials partials = client.ComputeGradient(inputs);
+    EXPECT_DOUBLE_EQ((partials[{"f", "x"}](0)), 6.0);
+    EXPECT_DOUBLE_EQ((partials[{"f", "y"}](0)), 8.0);
+    EXPECT_EQ(discipline->partials_calls_, 1);
+
+    // reconfiguring the server discards the memoized partials
+    client.Setup();
+    client.ComputeGradient(inputs);
+    EXPECT_EQ(discipline->partials_calls_, 2);
+}
+
+TEST_F(ExplicitIntegrationTest, MetricsRecordComputeCalls) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+    auto metrics = std::make_shared<MetricsRegistry>();
+    discipline->SetMetricsRecorder(metrics);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    client.ComputeFunction(inputs);
+    client.ComputeFunction(inputs);
+    client.ComputeGradient(inputs);
+
+    std::map<std::string, RpcMetrics> rpcs = metrics->Snapshot();
+    ASSERT_EQ(rpcs.count("ComputeFunction"), 1u);
+    ASSERT_EQ(rpcs.count("ComputeGradient"), 1u);
+    EXPECT_EQ(rpcs["ComputeFunction"].calls, 2u);
+    EXPECT_EQ(rpcs["ComputeFunction"].errors, 0u);
+    EXPECT_GT(rpcs["ComputeFunction"].bytes_received, 0u);
+    EXPECT_GT(rpcs["ComputeFunction"].messages_sent, 0u);
+    EXPECT_EQ(rpcs["ComputeGradient"].calls, 1u);
+    EXPECT_EQ(rpcs["ComputeGradient"].messages_sent, 2u);
+}
+
+TEST_F(ExplicitIntegrationTest, TracingPropagatesClientSpans) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+    auto server_tracer = std::make_shared<RecordingTracer>();
+    discipline->SetTracer(server_tracer);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    auto client_tracer = std::make_shared<RecordingTracer>();
+    TraceContext parent;
+    ASSERT_TRUE(ParseTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01", parent));
+
+    ExplicitClient client;
+    client.SetTracer(client_tracer);
+    client.SetTraceParent(parent);
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    Variables outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs["f"](0), 25.0);
+
+    RecordedSpan client_span = client_tracer->Find("ComputeFunction");
+    EXPECT_EQ(client_span.kind, SpanKind::kClient);
+    EXPECT_EQ(client_span.parent.span_id, parent.span_id);
+    EXPECT_EQ(client_span.status, grpc::StatusCode::OK);
+    EXPECT_TRUE(client_span.ended);
+    EXPECT_TRUE(client_tracer->Find("GetInfo").ended);
+
+    RecordedSpan server_span = server_tracer->Find("ComputeFunction");
+    EXPECT_EQ(server_span.kind, SpanKind::kServer);
+    EXPECT_EQ(server_span.parent.trace_id, parent.trace_id);
+    EXPECT_EQ(server_span.parent.span_id, client_span.context.span_id);
+    EXPECT_EQ(server_tracer->Find("ComputeFunction/compute").parent.span_id, server_span.context.span_id);
+}
+
+TEST_F(ExplicitIntegrationTest, SharedMemoryTransport) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    // opt-in only
+    EXPECT_FALSE(client.UsesSharedMemory());
+    client.EnableSharedMemory();
+    ASSERT_TRUE(client.UsesSharedMemory());
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    Variables outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs["f"](0), 25.0);
+
+    Partials partials = client.ComputeGradient(inputs);
+    EXPECT_DOUBLE_EQ((partials[{"f", "x"}](0)), 6.0);
+    EXPECT_DOUBLE_EQ((partials[{"f", "y"}](0)), 8.0);
+
+    inputs["x"](0) = 1.0;
+    auto both = client.ComputeFunctionAndGradient(inputs);
+    EXPECT_DOUBLE_EQ(both.first["f"](0), 17.0);
+    EXPECT_DOUBLE_EQ((both.second[{"f", "x"}](0)), 2.0);
+    EXPECT_DOUBLE_EQ((both.second[{"f", "y"}](0)), 8.0);
+}
+
+TEST_F(ExplicitIntegrationTest, Float32WirePrecision) {
+    const size_t n = 4;
+    const size_t m = 3;
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    client.SetWirePrecision(WirePrecision::kFloat32);
+    EXPECT_EQ(client.GetWirePrecision(), WirePrecision::kFloat32);
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 1.0 / 3.0);
+    inputs["x"] = CreateVectorVariable({0.1, 0.2, 0.3});
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 1.0 / 7.0));
+
+    // the server computes with the rounded inputs and rounds the outputs
+    auto rounded = [](double value) { return static_cast<double>(static_cast<float>(value)); };
+    Variables outputs = client.ComputeFunction(inputs);
+    for (size_t i = 0; i < n; ++i) {
+        double expected = rounded(1.0 / 7.0);
+        for (size_t j = 0; j < m; ++j)
+            expected += rounded(1.0 / 3.0) * rounded(inputs["x"](j));
+        EXPECT_EQ(outputs["z"](i), rounded(expected));
+    }
+
+    Partials partials = client.ComputeGradient(inputs);
+    for (size_t k = 0; k < n * m; ++k)
+        EXPECT_EQ((partials[{"z", "x"}](k)), rounded(1.0 / 3.0));
+}
+
+TEST_F(ExplicitIntegrationTest, CompressedTransfer) {
+    const size_t n = 100;
+    const size_t m = 50;
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    ASSERT_TRUE(client.ServerSupports(kFeatureCompression));
+
+    CompressionPolicy policy;
+    policy.algorithm = GRPC_COMPRESS_GZIP;
+    policy.min_values = 16;
+    client.SetCompression(policy);
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 1.0);
+    inputs["x"] = CreateVectorVariable(std::vector<double>(m, 2.0));
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 3.0));
+
+    // compression is lossless
+    Variables outputs = client.ComputeFunction(inputs);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(outputs["z"](i), 2.0 * m + 3.0);
+
+    Partials partials = client.ComputeGradient(inputs);
+    for (size_t k = 0; k < n * m; ++k)
+        EXPECT_DOUBLE_EQ((partials[{"z", "A"}](k)), 2.0);
+}
+
+TEST_F(ExplicitIntegrationTest, InputSessionSendsChanges) {
+    const size_t n = 20;
+    const size_t m = 10;
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    ASSERT_TRUE(client.ServerSupports(kFeatureInputSessions));
+
+    client.EnableInputSession();
+    EXPECT_TRUE(client.UsesInputSession());
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 1.0);
+    inputs["x"] = CreateVectorVariable(std::vector<double>(m, 2.0));
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 3.0));
+
+    Variables outputs = client.ComputeFunction(inputs);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(outputs["z"](i), 2.0 * m + 3.0);
+
+    // only x is sent, A and b are restored by the server
+    inputs["x"](0) = 12.0;
+    outputs = client.ComputeFunction(inputs);
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(outputs["z"](i), 2.0 * m + 13.0);
+
+    inputs["b"](1) = 0.0;
+    Partials partials = client.ComputeGradient(inputs);
+    EXPECT_DOUBLE_EQ((partials[{"z", "A"}](0)), 12.0);
+    EXPECT_DOUBLE_EQ((partials[{"z", "A"}](1)), 2.0);
+
+    outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs["z"](0), 2.0 * m + 13.0);
+    EXPECT_DOUBLE_EQ(outputs["z"](1), 2.0 * m + 10.0);
+}
+
+TEST_F(ExplicitIntegrationTest, EvaluationStreamsCarryRepeatedCalls) {
+    for (ServerEngine engine : {ServerEngine::kSynchronous, ServerEngine::kCallback}) {
+        auto discipline = std::make_shared<ParaboloidDiscipline>();
+        std::string address = server_manager_->StartServer(discipline, engine);
+        ASSERT_FALSE(address.empty());
+
+        {
+            ExplicitClient client;
+            client.ConnectChannel(CreateTestChannel(address));
+            client.GetInfo();
+            client.Setup();
+            client.GetVariableDefinitions();
+            client.GetPartialDefinitions();
+            EXPECT_FALSE(client.UsesEvaluationStreams());
+            client.EnableEvaluationStreams();
+            EXPECT_TRUE(client.UsesEvaluationStreams());
+
+            // interleaved calls use one stream per RPC
+            for (int i = 0; i < 5; ++i) {
+                Variables inputs;
+                inputs["x"] = CreateScalarVariable(static_cast<double>(i));
+                inputs["y"] = CreateScalarVariable(2.0);
+
+                Variables outputs = client.ComputeFunction(inputs);
+                EXPECT_DOUBLE_EQ(outputs["f"](0), i * i + 4.0);
+
+                Partials partials = client.ComputeGradient(inputs);
+                EXPECT_DOUBLE_EQ((partials[{"f", "x"}](0)), 2.0 * i);
+
+                auto both = client.ComputeFunctionAndGradient(inputs);
+                EXPECT_DOUBLE_EQ(both.first["f"](0), i * i + 4.0);
+                EXPECT_DOUBLE_EQ((both.second[{"f", "y"}](0)), 4.0);
+            }
+
+            // a configuration change replaces the streams
+            client.SetWirePrecision(WirePrecision::kFloat32);
+            Variables inputs;
+            inputs["x"] = CreateScalarVariable(1.0);
+            inputs["y"] = CreateScalarVariable(1.0);
+            EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs)["f"](0), 2.0);
+        }
+
+        server_manager_->StopServer();
+    }
+}
+
+TEST_F(ExplicitIntegrationTest, ServeInProcess) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+    std::unique_ptr<ExplicitClient> client = discipline->ServeInProcess();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    Variables outputs = client->ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs["f"](0), 25.0);
+
+    Partials partials = client->ComputeGradient(inputs);
+    EXPECT_DOUBLE_EQ((partials[{"f", "x"}](0)), 6.0);
+    EXPECT_DOUBLE_EQ((partials[{"f", "y"}](0)), 8.0);
+}
+
+TEST_F(ExplicitIntegrationTest, ServeUnixSocket) {
+    const std::string path = ::testing::TempDir() + "philote_explicit_" + std::to_string(getpid()) + ".sock";
+
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+    std::shared_ptr<grpc::Server> server = discipline->ServeUnixSocket(path, ServerEngine::kCallback, 2);
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateUnixSocketChannel(path));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(1.0);
+    inputs["y"] = CreateScalarVariable(2.0);
+
+    Variables outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs["f"](0), 5.0);
+
+    server->Shutdown();
+}
+
+TEST_F(ExplicitIntegrationTest, DefinitionCacheSkipsDefinitionRPCs) {
+    auto discipline = std::make_shared<SparseSquareDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    const std::string directory = ::testing::TempDir();
+
+    // the first client fetches and stores the definitions
+    ExplicitClient first;
+    first.SetDefinitionCache(std::make_shared<DefinitionCache>(directory));
+    first.ConnectChannel(CreateTestChannel(address));
+    first.GetInfo();
+    first.Setup();
+    first.GetVariableDefinitions();
+    first.GetPartialDefinitions();
+
+    EXPECT_TRUE(first.ServerSupports(kFeatureDefinitionsHash));
+    ASSERT_EQ(first.GetDefinitionsHash().size(), 32u);
+
+    // a client of another process finds them in the cache directory
+    auto tracer = std::make_shared<RecordingTracer>();
+    ExplicitClient second;
+    second.SetTracer(tracer);
+    second.SetDefinitionCache(std::make_shared<DefinitionCache>(directory));
+    second.ConnectChannel(CreateTestChannel(address));
+    second.GetInfo();
+    second.Setup();
+    second.GetVariableDefinitions();
+    second.GetPartialDefinitions();
+
+    for (const RecordedSpan &span : tracer->spans()) {
+        EXPECT_NE(span.name, "GetVariableDefinitions");
+        EXPECT_NE(span.name, "GetPartialDefinitions");
+    }
+
+    EXPECT_EQ(second.GetDefinitionsHash(), first.GetDefinitionsHash());
+    EXPECT_EQ(second.GetVariableNames(), first.GetVariableNames());
+    ASSERT_EQ(second.GetPartialsMetaConst().size(), 1u);
+    EXPECT_EQ(second.GetPartialsMetaConst()[0].shape(0), 4);
+    ASSERT_EQ(second.GetPartialsSparsity().count({"f", "x"}), 1u);
+    EXPECT_EQ(second.GetPartialsSparsity().at({"f", "x"}).dense_shape, (std::vector<int64_t>{4, 4}));
+
+    Variables inputs;
+    inputs["x"] = Variable(kInput, {4});
+    for (size_t i = 0; i < 4; i++)
+        inputs["x"](i) = static_cast<double>(i + 1);
+
+    Partials partials = second.ComputeGradient(inputs);
+    ASSERT_EQ((partials[{"f", "x"}].Size()), 4u);
+    EXPECT_DOUBLE_EQ((partials[{"f", "x"}](3)), 8.0);
+}
+
+TEST_F(ExplicitIntegrationTest, ParallelAssemblyMatchesSerialAssembly) {
+    const size_t n = 40;
+    const size_t m = 30;
+
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    discipline->SetAssemblyThreads(4);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    // small chunks, so every input arrives in many messages
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    StreamOptions options;
+    options.set_num_double(7);
+    client.SetStreamOptions(options);
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 0.0);
+    for (size_t i = 0; i < n * m; ++i)
+        inputs["A"](i) = static_cast<double>(i % 11);
+    inputs["x"] = CreateVectorVariable(std::vector<double>(m, 2.0));
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 3.0));
+
+    Variables outputs = client.ComputeFunction(inputs);
+    for (size_t i = 0; i < n; ++i) {
+        double expected = 3.0;
+        for (size_t j = 0; j < m; ++j)
+            expected += inputs["A"](i * m + j) * 2.0;
+        EXPECT_DOUBLE_EQ(outputs["z"](i), expected) << "Mismatch at index " << i;
+    }
+
+    // the partials are serialized by the workers and written in order
+    Partials partials = client.ComputeGradient(inputs);
+    ASSERT_EQ(partials.size(), 3u);
+    for (size_t i = 0; i < n * m; ++i) {
+        EXPECT_DOUBLE_EQ((partials[{"z", "x"}](i)), inputs["A"](i));
+        EXPECT_DOUBLE_EQ((partials[{"z", "A"}](i)), 2.0);
+    }
+    EXPECT_DOUBLE_EQ((partials[{"z", "b"}](0)), 1.0);
+    EXPECT_DOUBLE_EQ((partials[{"z", "b"}](1)), 0.0);
+}
+
+TEST_F(ExplicitIntegrationTest, ChunkSinkReceivesResultsInFlight) {
+    const size_t n = 40;
+    const size_t m = 30;
+
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    StreamOptions options;
+    options.set_num_double(7);
+    client.SetStreamOptions(options);
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 0.0);
+    for (size_t i = 0; i < n * m; ++i)
+        inputs["A"](i) = static_cast<double>(i % 11);
+    inputs["x"] = CreateVectorVariable(std::vector<double>(m, 2.0));
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 3.0));
+
+    // the outputs are reduced without collecting them
+    double sum = 0.0;
+    size_t values = 0;
+    client.ComputeFunction(inputs, [&](const std::string &name, const std::string &subname,
+                                       size_t start, const double *data, size_t count) {
+        EXPECT_EQ(name, "z");
+        EXPECT_TRUE(subname.empty());
+        EXPECT_LE(start + count, n);
+        sum += std::accumulate(data, data + count, 0.0);
+        values += count;
+    });
+    EXPECT_EQ(values, n);
+
+    Variables outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(sum, std::accumulate(outputs["z"].data(), outputs["z"].data() + n, 0.0));
+
+    std::map<std::pair<std::string, std::string>, std::vector<double>> received;
+    client.ComputeGradient(inputs, [&](const std::string &name, const std::string &subname,
+                                       size_t start, const double *data, size_t count) {
+        std::vector<double> &values = received[{name, subname}];
+        if (values.size() < start + count)
+            values.resize(start + count);
+        std::copy_n(data, count, values.begin() + start);
+    });
+
+    Partials partials = client.ComputeGradient(inputs);
+    ASSERT_EQ(received.size(), partials.size());
+    for (const auto &par : partials)
+        EXPECT_EQ(received[par.first],
+                  std::vector<double>(par.second.data(), par.second.data() + par.second.Size()));
+}
+
+TEST_F(ExplicitIntegrationTest, CallbackEngineStreamsManyChunks) {
+    const size_t n = 40;
+    const size_t m = 30;
+
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    StreamOptions options;
+    options.set_num_double(3);
+    client.SetStreamOptions(options);
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 0.0);
+    for (size_t i = 0; i < n * m; ++i)
+        inputs["A"](i) = static_cast<double>(i % 7);
+    inputs["x"] = CreateVectorVariable(std::vector<double>(m, 1.0));
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 2.0));
+
+    // every input and output is split into many chunks, all of which the
+    // reactor buffers
+    std::vector<double> received(n, 0.0);
+    size_t chunks = 0;
+    client.ComputeFunction(inputs, [&](const std::string &, const std::string &,
+                                       size_t start, const double *data, size_t count) {
+        std::copy_n(data, count, received.begin() + start);
+        chunks++;
+    });
+    EXPECT_GE(chunks, n / 3);
+
+    for (size_t i = 0; i < n; ++i) {
+        double expected = 2.0;
+        for (size_t j = 0; j < m; ++j)
+            expected += inputs["A"](i * m + j);
+        EXPECT_DOUBLE_EQ(received[i], expected) << "Mismatch at index " << i;
+    }
+
+    Partials partials = client.ComputeGradient(inputs);
+    ASSERT_EQ(partials.size(), 3u);
+    for (size_t i = 0; i < n * m; ++i)
+        EXPECT_DOUBLE_EQ((partials[{"z", "x"}](i)), inputs["A"](i));
+}
+
+TEST_F(ExplicitIntegrationTest, ChunkSinkExceptionsCancelTheCall) {
+    auto discipline = std::make_shared<ParaboloidDiscipline>();
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    EXPECT_THROW(client.ComputeFunction(inputs, [](const std::string &, const std::string &,
+                                                   size_t, const double *, size_t) {
+        throw std::runtime_error("disk full");
+    }), std::runtime_error);
+
+    // the next call opens a new stream
+    EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs)["f"](0), 25.0);
+}
+
+// paraboloid whose partials are computed block by block
+class BlockParaboloidDiscipline : public ParaboloidDiscipline {
+public:
+    BlockParaboloidDiscipline() { EnableBlockPartials(2); }
+
+    void ComputePartial(const std::string &of, const std::string &wrt,
+                        const Variables &inputs, Variable &block) override {
+        block(0) = 2.0 * inputs.at(wrt)(0);
+    }
+};
+
+TEST_F(ExplicitIntegrationTest, BlockPartialsAreSentAsTheyFinish) {
+    auto discipline = std::make_shared<BlockParaboloidDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+    inputs["y"] = CreateScalarVariable(4.0);
+
+    Partials partials = client.ComputeGradient(inputs);
+    ASSERT_EQ(partials.size(), 2u);
+    EXPECT_DOUBLE_EQ((partials[{"f", "x"}](0)), 6.0);
+    EXPECT_DOUBLE_EQ((partials[{"f", "y"}](0)), 8.0);
+
+    // subsequent calls reuse the block workers
+    partials = client.ComputeGradient(inputs);
+    ASSERT_EQ(partials.size(), 2u);
+    EXPECT_DOUBLE_EQ((partials[{"f", "y"}](0)), 8.0);
+}
+
+TEST_F(ExplicitIntegrationTest, JacobianProductsMatchTheGradient) {
+    const size_t n = 4;
+    const size_t m = 3;
+
+    auto discipline = std::make_shared<VectorizedDiscipline>(n, m);
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    ASSERT_TRUE(client.ServerSupports(philote::kFeatureJacobianProducts));
+
+    Variables inputs;
+    inputs["A"] = CreateMatrixVariable(n, m, 0.0);
+    for (size_t i = 0; i < n * m; ++i)
+        inputs["A"](i) = static_cast<double>(i + 1);
+    inputs["x"] = CreateVectorVariable({1.0, -1.0, 0.5});
+    inputs["b"] = CreateVectorVariable(std::vector<double>(n, 3.0));
+
+    // forward: dz = A * dx + db
+    Variables seeds;
+    seeds["x"] = CreateVectorVariable({2.0, 0.0, -1.0});
+    seeds["b"] = CreateVectorVariable({1.0, 2.0, 3.0, 4.0});
+    Variables jac_vec = client.ComputeJacVec(inputs, seeds);
+    ASSERT_EQ(jac_vec.size(), 1u);
+    for (size_t i = 0; i < n; ++i) {
+        double expected = seeds["b"](i);
+        for (size_t j = 0; j < m; ++j)
+            expected += inputs["A"](i * m + j) * seeds["x"](j);
+        EXPECT_DOUBLE_EQ(jac_vec["z"](i), expected) << "Mismatch at index " << i;
+    }
+
+    // reverse: dx = A^T * dz, db = dz
+    Variables weights;
+    weights["z"] = CreateVectorVariable({1.0, 0.0, -2.0, 0.5});
+    Variables vec_jac = client.ComputeVecJac(inputs, weights);
+    ASSERT_EQ(vec_jac.size(), 3u);
+    for (size_t j = 0; j < m; ++j) {
+        double expected = 0.0;
+        for (size_t i = 0; i < n; ++i)
+            expected += inputs["A"](i * m + j) * weights["z"](i);
+        EXPECT_DOUBLE_EQ(vec_jac["x"](j), expected) << "Mismatch at index " << j;
+    }
+    for (size_t i = 0; i < n; ++i)
+        EXPECT_DOUBLE_EQ(vec_jac["b"](i), weights["z"](i));
+}
+
+// sums the selected entries of x and counts them
+class MaskedSumDiscipline : public ExplicitDiscipline {
+public:
+    explicit MaskedSumDiscipline(int64_t n) : n_(n) {}
+
+    void Setup() override {
+        AddInput("x", {n_}, "m");
+        AddDiscreteInput("mask", {n_});
+        AddOutput("sum", {1}, "m");
+        AddDiscreteOutput("count", {1});
+        AddDiscreteOutput("selected", {n_});
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        double sum = 0.0;
+        int64_t count = 0;
+        for (int64_t i = 0; i < n_; i++)
+        {
+            const double mask = inputs.at("mask")(i);
+            sum += mask * inputs.at("x")(i);
+            if (mask != 0.0)
+                outputs.at("selected")(count++) = static_cast<double>(i - 1000);
+        }
+        outputs.at("sum")(0) = sum;
+        outputs.at("count")(0) = static_cast<double>(count);
+    }
+
+private:
+    int64_t n_;
+};
+
+TEST_F(ExplicitIntegrationTest, DiscreteVariablesAreIntegerEncoded) {
+    const int64_t n = 5000;
+    auto discipline = std::make_shared<MaskedSumDiscipline>(n);
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    ASSERT_TRUE(client.ServerSupports(kFeatureDiscreteVariables));
+    EXPECT_TRUE(client.IsDiscrete("mask"));
+    EXPECT_TRUE(client.IsDiscrete("count"));
+    EXPECT_FALSE(client.IsDiscrete("x"));
+    EXPECT_EQ(client.GetVariableMetaAll().size(), 5u);
+
+    Variables inputs;
+    inputs["x"] = CreateVectorVariable(std::vector<double>(n, 2.0));
+    inputs["mask"] = Variable(kInput, {static_cast<size_t>(n)}, kDiscrete);
+    for (int64_t i = 0; i < n; i += 2)
+        inputs["mask"].Discrete(i) = 1;
+
+    Variables outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs.at("sum")(0), n);
+    ASSERT_TRUE(outputs.at("count").IsDiscrete());
+    EXPECT_EQ(outputs.at("count").Discrete(0), n / 2);
+    ASSERT_TRUE(outputs.at("selected").IsDiscrete());
+    for (int64_t k = 0; k < n / 2; k++)
+        EXPECT_EQ(outputs.at("selected").Discrete(k), 2 * k - 1000);
+
+    // continuous values of a discrete input are rounded on the wire
+    inputs["mask"] = CreateVectorVariable(std::vector<double>(n, 0.9));
+    outputs = client.ComputeFunction(inputs);
+    EXPECT_DOUBLE_EQ(outputs.at("sum")(0), 2.0 * n);
+    EXPECT_EQ(outputs.at("count").Discrete(0), n);
+
+    // without the extension, discrete variables are exchanged as doubles
+    client.SetServerFeatures({});
+    client.GetVariableDefinitions();
+    EXPECT_FALSE(client.IsDiscrete("count"));
+    inputs["mask"] = Variable(kInput, {static_cast<size_t>(n)}, kDiscrete);
+    inputs["mask"].Fill(1.0);
+    outputs = client.ComputeFunction(inputs);
+    EXPECT_FALSE(outputs.at("count").IsDiscrete());
+    EXPECT_DOUBLE_EQ(outputs.at("count")(0), n);
+}
+
+// ============================================================================
+// Options Hot-Reload Tests
+// ============================================================================
+
+// y = scale * x, with the size of x as a shape option and scale as an option
+// that leaves the definitions unchanged
+class ScaledVectorDiscipline : public ExplicitDiscipline {
+public:
+    ScaledVectorDiscipline() {
+        AddOption("n", "int");
+        AddOption("scale", "float", false);
+    }
+
+    void SetOptions(const google::protobuf::Struct &options_struct) override {
+        auto n = options_struct.fields().find("n");
+        if (n != options_struct.fields().end())
+            n_ = static_cast<size_t>(n->second.number_value());
+        auto scale = options_struct.fields().find("scale");
+        if (scale != options_struct.fields().end())
+            scale_ = scale->second.number_value();
+
+        ExplicitDiscipline::SetOptions(options_struct);
+    }
+
+    void Setup() override {
+        setup_calls++;
+        AddInput("x", {n_}, "m");
+        AddOutput("y", {n_}, "m");
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        for (size_t i = 0; i < n_; i++)
+            outputs.at("y")(i) = scale_ * inputs.at("x")(i);
+    }
+
+    std::atomic<int> setup_calls{0};
+
+private:
+    size_t n_ = 1;
+    double scale_ = 1.0;
+};
+
+TEST_F(ExplicitIntegrationTest, ShapelessOptionsSkipTheSetup) {
+    auto discipline = std::make_shared<ScaledVectorDiscipline>();
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ExplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    ASSERT_TRUE(client.ServerSupports(kFeatureOptionsHotReload));
+
+    DisciplineOptions options;
+    (*options.mutable_options()->mutable_fields())["n"].set_number_value(3);
+    (*options.mutable_options()->mutable_fields())["scale"].set_number_value(2.0);
+    client.SendOptions(options);
+    EXPECT_TRUE(client.SetupRequired());
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    EXPECT_EQ(discipline->setup_calls.load(), 1);
+
+    Variables inputs;
+    inputs["x"] = CreateVectorVariable({1.0, 2.0, 3.0});
+    EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs).at("y")(2), 6.0);
+
+    // the scale is applied in place
+    const uint64_t generation = client.OptionsGeneration();
+    options.mutable_options()->mutable_fields()->clear();
+    (*options.mutable_options()->mutable_fields())["scale"].set_number_value(3.0);
+    client.SendOptions(options);
+    EXPECT_FALSE(client.SetupRequired());
+    EXPECT_EQ(client.OptionsGeneration(), generation + 1);
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    EXPECT_EQ(discipline->setup_calls.load(), 1);
+    EXPECT_EQ(client.GetVariableMetaAll().size(), 2u);
+    EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs).at("y")(2), 9.0);
+
+    // a new size requires a new setup
+    (*options.mutable_options()->mutable_fields())["n"].set_number_value(4);
+    client.SendOptions(options);
+    EXPECT_TRUE(client.SetupRequired());
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    EXPECT_EQ(discipline->setup_calls.load(), 2);
+    inputs["x"] = CreateVectorVariable({1.0, 2.0, 3.0, 4.0});
+    EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs).at("y")(3), 12.0);
+}
+
+TEST_F(ExplicitIntegrationTest, OverloadedServerRejectsAndClientsBackOff) {
+    for (ServerEngine engine : {ServerEngine::kSynchronous, ServerEngine::kCallback}) {
+        auto discipline = std::make_shared<SlowDiscipline>(200);
+        AdmissionLimits limits;
+        limits.max_concurrent = 1;
+        limits.max_queued = 0;
+        limits.retry_after = std::chrono::milliseconds(20);
+        discipline->SetAdmissionLimits(limits);
+
+        std::string address = server_manager_->StartServer(discipline, engine);
+        ASSERT_FALSE(address.empty());
+
+        {
+            auto connect = [&address](ExplicitClient &client) {
+                client.ConnectChannel(CreateTestChannel(address));
+                client.GetInfo();
+                client.Setup();
+                client.GetVariableDefinitions();
+            };
+
+            ExplicitClient busy;
+            connect(busy);
+            ASSERT_TRUE(busy.ServerSupports(kFeatureAdmissionControl));
+
+            Variables inputs;
+            inputs["x"] = CreateScalarVariable(3.0);
+            auto first = std::async(std::launch::async, [&busy, &inputs] {
+                return busy.ComputeFunction(inputs);
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            // without retries, the second call fails fast
+            ExplicitClient impatient;
+            connect(impatient);
+            BackoffPolicy none;
+            none.max_retries = 0;
+            impatient.SetBackoff(none);
+            const auto start = std::chrono::steady_clock::now();
+            EXPECT_THROW(impatient.ComputeFunction(inputs), std::runtime_error);
+            EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(150));
+            EXPECT_GT(discipline->admission_controller()->rejected(), 0u);
+
+            // with retries, it backs off until the first call completes
+            ExplicitClient patient;
+            connect(patient);
+            EXPECT_DOUBLE_EQ(patient.ComputeFunction(inputs).at("y")(0),
+                             first.get().at("y")(0));
+        }
+
+        server_manager_->StopServer();
+    }
+}
+
+TEST_F(ExplicitIntegrationTest, BackoffRestartsWithEveryCall) {
+    auto discipline = std::make_shared<SlowDiscipline>(200);
+    AdmissionLimits limits;
+    limits.max_concurrent = 1;
+    limits.max_queued = 0;
+    limits.retry_after = std::chrono::milliseconds(20);
+    discipline->SetAdmissionLimits(limits);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    {
+        auto connect = [&address](ExplicitClient &client) {
+            client.ConnectChannel(CreateTestChannel(address));
+            client.GetInfo();
+            client.Setup();
+            client.GetVariableDefinitions();
+        };
+
+        ExplicitClient busy;
+        connect(busy);
+
+        // one retry outlasts the busy call, a second would take seconds
+        ExplicitClient client;
+        connect(client);
+        BackoffPolicy policy;
+        policy.max_retries = 1;
+        policy.initial = std::chrono::milliseconds(300);
+        policy.multiplier = 10.0;
+        policy.max = std::chrono::milliseconds(10000);
+        client.SetBackoff(policy);
+
+        Variables inputs;
+        inputs["x"] = CreateScalarVariable(3.0);
+
+        // reject -> succeed, twice: each call starts with a fresh budget
+        // and the initial delay
+        for (int round = 0; round < 2; round++) {
+            const size_t rejected = discipline->admission_controller()->rejected();
+            auto first = std::async(std::launch::async, [&busy, &inputs] {
+                return busy.ComputeFunction(inputs);
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            const auto start = std::chrono::steady_clock::now();
+            EXPECT_DOUBLE_EQ(client.ComputeFunction(inputs).at("y")(0), first.get().at("y")(0));
+            EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1500));
+            EXPECT_GT(discipline->admission_controller()->rejected(), rejected);
+        }
+    }
+
+    server_manager_->StopServer();
+}
@@ -0,0 +1,79 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <finite_difference.h>
+
+using philote::ColorColumns;
+
+TEST(FiniteDifferenceTests, DenseColumnsAreNotGrouped)
+{
+    std::vector<std::vector<size_t>> rows(3, std::vector<size_t>{0, 1});
+    auto groups = ColorColumns(rows, 2);
+
+    ASSERT_EQ(groups.size(), 3u);
+    for (size_t i = 0; i < groups.size(); i++)
+        EXPECT_EQ(groups[i], std::vector<size_t>{i});
+}
+
+TEST(FiniteDifferenceTests, DiagonalNeedsOneGroup)
+{
+    std::vector<std::vector<size_t>> rows = {{0}, {1}, {2}, {3}};
+    auto groups = ColorColumns(rows, 4);
+
+    ASSERT_EQ(groups.size(), 1u);
+    EXPECT_EQ(groups[0], (std::vector<size_t>{0, 1, 2, 3}));
+}
+
+TEST(FiniteDifferenceTests, TridiagonalNeedsThreeGroups)
+{
+    const size_t n = 9;
+    std::vector<std::vector<size_t>> rows(n);
+    for (size_t col = 0; col < n; col++)
+    {
+        for (size_t row = col == 0 ? 0 : col - 1; row <= col + 1 and row < n; row++)
+            rows[col].push_back(row);
+    }
+
+    auto groups = ColorColumns(rows, n);
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[0], (std::vector<size_t>{0, 3, 6}));
+    EXPECT_EQ(groups[1], (std::vector<size_t>{1, 4, 7}));
+    EXPECT_EQ(groups[2], (std::vector<size_t>{2, 5, 8}));
+}
+
+TEST(FiniteDifferenceTests, RejectsRowsOutOfRange)
+{
+    EXPECT_THROW(ColorColumns({{0}, {2}}, 2), std::out_of_range);
+}
@@ -0,0 +1,178 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <gtest/gtest.h>
+#include <cstdint>
+
+#include <flat_variables.h>
+
+using philote::FlatVariables;
+using philote::kInput;
+using philote::kOutput;
+using philote::VariableMetaData;
+
+namespace
+{
+    VariableMetaData Meta(const std::string &name, philote::VariableType type,
+                          const std::vector<int64_t> &shape)
+    {
+        VariableMetaData meta;
+        meta.set_name(name);
+        meta.set_type(type);
+        for (int64_t dim : shape)
+            meta.add_shape(dim);
+        return meta;
+    }
+}
+
+TEST(FlatVariablesTests, LayoutIsContiguous)
+{
+    FlatVariables vars;
+    FlatVariables::Handle x = vars.Add("x", kInput, {2, 2});
+    FlatVariables::Handle y = vars.Add("y", kInput, {3});
+
+    // offsets are padded to the alignment (8 doubles)
+    EXPECT_EQ(vars.count(), 2u);
+    EXPECT_EQ(vars.size(), 11u);
+    EXPECT_EQ(vars.offset(x), 0u);
+    EXPECT_EQ(vars.offset(y), 8u);
+    EXPECT_EQ(vars.size(y), 3u);
+    EXPECT_EQ(vars.name(y), "y");
+    EXPECT_EQ(vars.Find("y"), y);
+    EXPECT_EQ(vars[y].data(), vars.data() + 8);
+    EXPECT_EQ(vars[x].Shape(), (std::vector<size_t>{2, 2}));
+}
+
+TEST(FlatVariablesTests, BufferIsAligned)
+{
+    FlatVariables vars;
+    vars.Add("x", kInput, {3});
+    vars.Add("y", kInput, {5});
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(vars.data()) % philote::kSimdAlignment, 0u);
+    EXPECT_EQ(vars.at("x").values().data(), vars.data());
+    EXPECT_EQ(vars.at("y").values().data(), vars.data() + 8);
+    EXPECT_EQ(vars.at("y").values().size(), 5u);
+
+    // every variable starts on an aligned boundary
+    for (int i = 0; i < 5; ++i)
+        vars.Add("v" + std::to_string(i), kInput, {static_cast<size_t>(i + 1)});
+    for (FlatVariables::Handle h = 0; h < vars.count(); ++h)
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(vars[h].data()) % philote::kSimdAlignment, 0u);
+}
+
+TEST(FlatVariablesTests, MapViewsShareStorage)
+{
+    FlatVariables vars;
+    FlatVariables::Handle x = vars.Add("x", kInput, {2});
+    vars.Add("y", kInput, {2});
+
+    vars.map().at("y")(1) = 4.0;
+    EXPECT_EQ(vars.data()[vars.offset(vars.Find("y")) + 1], 4.0);
+
+    vars(x, 0) = 1.5;
+    EXPECT_EQ(vars.map().at("x")(0), 1.5);
+    EXPECT_EQ(vars.at("x")(0), 1.5);
+    EXPECT_TRUE(vars.map().at("x").IsView());
+}
+
+TEST(FlatVariablesTests, ViewsSurviveGrowth)
+{
+    FlatVariables vars;
+    FlatVariables::Handle x = vars.Add("x", kInput, {1});
+    vars(x, 0) = 2.0;
+
+    for (int i = 0; i < 64; ++i)
+        vars.Add("v" + std::to_string(i), kInput, {16});
+
+    EXPECT_EQ(vars.map().at("x")(0), 2.0);
+    EXPECT_EQ(vars[x].data(), vars.data());
+}
+
+TEST(FlatVariablesTests, ConstructFromMetaData)
+{
+    std::vector<VariableMetaData> meta = {Meta("x", kInput, {3}),
+                                          Meta("f", kOutput, {2}),
+                                          Meta("y", kInput, {1})};
+
+    FlatVariables inputs(meta, kInput);
+    FlatVariables outputs(meta, kOutput);
+
+    EXPECT_EQ(inputs.count(), 2u);
+    EXPECT_EQ(inputs.size(), 9u);
+    EXPECT_EQ(inputs.Find("x"), 0u);
+    EXPECT_EQ(inputs.Find("y"), 1u);
+    EXPECT_FALSE(inputs.Contains("f"));
+    EXPECT_EQ(outputs.count(), 1u);
+    EXPECT_EQ(outputs.at("f").Size(), 2u);
+}
+
+TEST(FlatVariablesTests, FillReattachesReplacedEntries)
+{
+    FlatVariables vars;
+    vars.Add("x", kOutput, {2});
+
+    // replacing a map entry detaches it from the buffer
+    vars.map()["x"] = philote::Variable(kOutput, {2});
+    EXPECT_FALSE(vars.map().at("x").IsView());
+
+    vars.Fill(3.0);
+    EXPECT_TRUE(vars.map().at("x").IsView());
+    EXPECT_EQ(vars.map().at("x")(1), 3.0);
+    EXPECT_EQ(vars.data()[1], 3.0);
+}
+
+TEST(FlatVariablesTests, CopyHasIndependentStorage)
+{
+    FlatVariables vars;
+    FlatVariables::Handle x = vars.Add("x", kInput, {2});
+    vars(x, 1) = 1.0;
+
+    FlatVariables copy(vars);
+    copy(x, 1) = 5.0;
+
+    EXPECT_EQ(vars(x, 1), 1.0);
+    EXPECT_EQ(copy.map().at("x")(1), 5.0);
+    EXPECT_EQ(copy[x].data(), copy.data());
+
+    FlatVariables moved(std::move(copy));
+    EXPECT_EQ(moved.map().at("x")(1), 5.0);
+}
+
+TEST(FlatVariablesTests, Errors)
+{
+    FlatVariables vars;
+    vars.Add("x", kInput, {1});
+
+    EXPECT_THROW(vars.Add("x", kInput, {2}), std::invalid_argument);
+    EXPECT_THROW(vars.Find("z"), std::out_of_range);
+    EXPECT_THROW(vars.at("z"), std::out_of_range);
+    EXPECT_THROW(vars[3], std::out_of_range);
+}
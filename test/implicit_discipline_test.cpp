@@ -502,6 +502,168 @@ TEST_F(SimpleImplicitTest, ErrorHandlingMissingPartials)
         } }, std::out_of_range);
 }
 
+// Discipline without SolveResiduals: u^3 + u = x and v = u_0 + u_1
+class CubicImplicitDisciplineTest : public ImplicitDiscipline
+{
+public:
+    explicit CubicImplicitDisciplineTest(bool sparse = false) : sparse_(sparse) {}
+
+    void Setup() override
+    {
+        AddInput("x", {2}, "");
+        AddOutput("u", {2}, "");
+        AddOutput("v", {1}, "");
+    }
+
+    void SetupPartials() override
+    {
+        if (sparse_)
+            DeclarePartials("u", "u", {0, 1}, {0, 1});
+        else
+            DeclarePartials("u", "u");
+        DeclarePartials("u", "x");
+        DeclarePartials("v", "u");
+        DeclarePartials("v", "v");
+    }
+
+    void ComputeResiduals(const Variables &inputs, const Variables &outputs, Variables &residuals) override
+    {
+        residual_evaluations++;
+        const Variable &u = outputs.at("u");
+        for (size_t i = 0; i < 2; i++)
+            residuals.at("u")(i) = u(i) * u(i) * u(i) + u(i) - inputs.at("x")(i);
+        residuals.at("v")(0) = outputs.at("v")(0) - u(0) - u(1);
+    }
+
+    void ComputeResidualGradients(const Variables &inputs, const Variables &outputs, Partials &partials) override
+    {
+        gradient_evaluations++;
+        const Variable &u = outputs.at("u");
+        for (size_t i = 0; i < 2; i++)
+        {
+            const double derivative = 3.0 * u(i) * u(i) + 1.0;
+            if (sparse_)
+                partials[{"u", "u"}](i) = derivative;
+            else
+                partials[{"u", "u"}](i * 2 + i) = derivative;
+            partials[{"u", "x"}](i * 2 + i) = -1.0;
+            partials[{"v", "u"}](i) = -1.0;
+        }
+        partials[{"v", "v"}](0) = 1.0;
+    }
+
+    size_t residual_evaluations = 0;
+    size_t gradient_evaluations = 0;
+
+private:
+    bool sparse_;
+};
+
+namespace
+{
+    Variables CubicInputs()
+    {
+        Variables inputs;
+        inputs["x"] = Variable(kInput, {2});
+        inputs.at("x")(0) = 2.0;   // u = 1
+        inputs.at("x")(1) = 10.0;  // u = 2
+        return inputs;
+    }
+
+    Variables CubicOutputs()
+    {
+        Variables outputs;
+        outputs["u"] = Variable(kOutput, {2});
+        outputs["v"] = Variable(kOutput, {1});
+        return outputs;
+    }
+}
+
+// Test the default SolveResiduals (Newton's method with dense LU)
+TEST(ImplicitNewtonTest, DefaultSolveResidualsUsesNewton)
+{
+    auto discipline = std::make_shared<CubicImplicitDisciplineTest>();
+    discipline->Setup();
+    discipline->SetupPartials();
+
+    Variables outputs = CubicOutputs();
+    discipline->SolveResiduals(CubicInputs(), outputs);
+
+    EXPECT_NEAR(outputs.at("u")(0), 1.0, 1e-10);
+    EXPECT_NEAR(outputs.at("u")(1), 2.0, 1e-10);
+    EXPECT_NEAR(outputs.at("v")(0), 3.0, 1e-10);
+    EXPECT_EQ(discipline->gradient_evaluations + 1, discipline->residual_evaluations);
+}
+
+// Test Broyden's method with sparse partials and the sparse LU solver
+TEST(ImplicitNewtonTest, BroydenWithSparseLU)
+{
+    auto discipline = std::make_shared<CubicImplicitDisciplineTest>(true);
+    discipline->Setup();
+    discipline->SetupPartials();
+
+    NewtonOptions options;
+    options.method = NonlinearMethod::kBroyden;
+    options.max_iterations = 100;
+    options.linear_solver = []
+    { return std::make_unique<SparseLUSolver>(); };
+    discipline->SetNewtonOptions(options);
+
+    // start close to the solution, where Broyden converges reliably
+    Variables outputs = CubicOutputs();
+    outputs.at("u")(0) = 1.2;
+    outputs.at("u")(1) = 1.8;
+    const size_t iterations = discipline->SolveNewton(CubicInputs(), outputs);
+
+    EXPECT_NEAR(outputs.at("u")(0), 1.0, 1e-8);
+    EXPECT_NEAR(outputs.at("u")(1), 2.0, 1e-8);
+    EXPECT_NEAR(outputs.at("v")(0), 3.0, 1e-8);
+    EXPECT_LT(discipline->gradient_evaluations, iterations);
+}
+
+// Test that SolveNewton requires partials with respect to the outputs
+TEST(ImplicitNewtonTest, SolveNewtonRequiresOutputPartials)
+{
+    auto discipline = std::make_shared<CubicImplicitDisciplineTest>();
+    discipline->Setup();
+
+    Variables outputs = CubicOutputs();
+    EXPECT_THROW(discipline->SolveResiduals(CubicInputs(), outputs), std::logic_error);
+}
+
+// Test the default linear solves with dR/dy and its transpose
+TEST(ImplicitNewtonTest, DefaultLinearSolves)
+{
+    auto discipline = std::make_shared<CubicImplicitDisciplineTest>();
+    discipline->Setup();
+    discipline->SetupPartials();
+
+    // dR/dy = [[4, 0, 0], [0, 13, 0], [-1, -1, 1]] at u = (1, 2), v = 3
+    Variables outputs = CubicOutputs();
+    outputs.at("u")(0) = 1.0;
+    outputs.at("u")(1) = 2.0;
+    outputs.at("v")(0) = 3.0;
+
+    Variables rhs;
+    rhs["u"] = Variable(kOutput, {2});
+    rhs.at("u")(0) = 4.0;
+    rhs.at("u")(1) = 13.0;
+    Variables solution = CubicOutputs();
+    discipline->SolveLinear(CubicInputs(), outputs, rhs, solution);
+    EXPECT_NEAR(solution.at("u")(0), 1.0, 1e-12);
+    EXPECT_NEAR(solution.at("u")(1), 1.0, 1e-12);
+    EXPECT_NEAR(solution.at("v")(0), 2.0, 1e-12);
+
+    rhs = CubicOutputs();
+    rhs.at("u")(0) = 3.0;
+    rhs.at("u")(1) = 12.0;
+    rhs.at("v")(0) = 1.0;
+    discipline->SolveAdjointLinear(CubicInputs(), outputs, rhs, solution);
+    EXPECT_NEAR(solution.at("u")(0), 1.0, 1e-12);
+    EXPECT_NEAR(solution.at("u")(1), 1.0, 1e-12);
+    EXPECT_NEAR(solution.at("v")(0), 1.0, 1e-12);
+}
+
 // ============================================================================
 // RegisterServices Tests
 // ============================================================================
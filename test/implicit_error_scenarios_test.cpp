@@ -20,6 +20,7 @@
 #include <memory>
 #include <stdexcept>
 #include <cmath>
+#include <future>
 #include <limits>
 
 #include "implicit.h"
@@ -627,3 +628,231 @@ TEST_F(ImplicitErrorScenariosTest, WrongOutputGuessProducesNonZeroResidual) {
     // Residual should be near zero
     EXPECT_NEAR(residuals_correct["y"](0), 0.0, 1e-10);
 }
+
+// ============================================================================
+// Asynchronous Client Tests
+// ============================================================================
+
+TEST_F(ImplicitErrorScenariosTest, SolveResidualsAsync) {
+    auto discipline = std::make_shared<SimpleImplicitDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    std::vector<std::future<Variables>> futures;
+    for (int i = 0; i < 8; i++)
+    {
+        Variables inputs;
+        inputs["x"] = CreateScalarVariable(static_cast<double>(i));
+        futures.push_back(client.SolveResidualsAsync(inputs));
+    }
+
+    for (int i = 0; i < 8; i++)
+        EXPECT_DOUBLE_EQ(futures[i].get().at("y")(0), static_cast<double>(i * i));
+}
+
+TEST_F(ImplicitErrorScenariosTest, DisciplineThrowsOnSolveResidualsAsync) {
+    auto discipline = std::make_shared<ImplicitErrorDiscipline>(
+        ImplicitErrorDiscipline::ErrorMode::THROW_ON_SOLVE_RESIDUALS);
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(1.0);
+
+    auto future = client.SolveResidualsAsync(inputs);
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+// ============================================================================
+// Callback Engine Tests
+// ============================================================================
+
+TEST_F(ImplicitErrorScenariosTest, CallbackEngineRoundTrip) {
+    auto discipline = std::make_shared<SimpleImplicitDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+
+    Variables outputs = client.SolveResiduals(inputs);
+    EXPECT_DOUBLE_EQ(outputs.at("y")(0), 9.0);
+
+    Variables vars;
+    vars["x"] = CreateScalarVariable(3.0);
+    vars["y"] = outputs.at("y");
+    vars.at("y")(0) = 8.0;
+
+    Variables residuals = client.ComputeResiduals(vars);
+    EXPECT_DOUBLE_EQ(residuals.at("y")(0), 1.0);
+
+    Partials partials = client.ComputeResidualGradients(vars);
+    EXPECT_DOUBLE_EQ((partials.at({"y", "x"})(0)), 6.0);
+    EXPECT_DOUBLE_EQ((partials.at({"y", "y"})(0)), -1.0);
+}
+
+TEST_F(ImplicitErrorScenariosTest, CallbackEngineDisciplineThrowsOnSolveResiduals) {
+    auto discipline = std::make_shared<ImplicitErrorDiscipline>(
+        ImplicitErrorDiscipline::ErrorMode::THROW_ON_SOLVE_RESIDUALS);
+
+    std::string address = server_manager_->StartServer(discipline, ServerEngine::kCallback);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.GetVariableDefinitions();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(1.0);
+
+    EXPECT_THROW(client.SolveResiduals(inputs), std::runtime_error);
+}
+
+/**
+ * Elementwise residuals R_i = a_i * y_i - b_i with diagonal (sparse) Jacobians
+ */
+class SparseDiagonalImplicitDiscipline : public ImplicitDiscipline {
+public:
+    void Setup() override {
+        AddInput("a", {3}, "");
+        AddInput("b", {3}, "");
+        AddOutput("y", {3}, "");
+    }
+
+    void SetupPartials() override {
+        DeclarePartials("y", "a", {0, 1, 2}, {0, 1, 2});
+        DeclarePartials("y", "y", {0, 1, 2}, {0, 1, 2});
+    }
+
+    void ComputeResiduals(const Variables &inputs, const Variables &outputs,
+                          Variables &residuals) override {
+        for (size_t i = 0; i < 3; i++)
+            residuals.at("y")(i) = inputs.at("a")(i) * outputs.at("y")(i) - inputs.at("b")(i);
+    }
+
+    void ComputeResidualGradients(const Variables &inputs, const Variables &outputs,
+                                  Partials &partials) override {
+        for (size_t i = 0; i < 3; i++)
+        {
+            partials[{"y", "a"}](i) = outputs.at("y")(i);
+            partials[{"y", "y"}](i) = inputs.at("a")(i);
+        }
+    }
+};
+
+TEST_F(ImplicitErrorScenariosTest, SparseResidualGradients) {
+    auto discipline = std::make_shared<SparseDiagonalImplicitDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    ASSERT_EQ(client.GetPartialsSparsity().size(), 2u);
+
+    Variables vars;
+    vars["a"] = Variable(client.GetVariableMeta("a"));
+    vars["b"] = Variable(client.GetVariableMeta("b"));
+    vars["y"] = Variable(client.GetVariableMeta("y"));
+    for (size_t i = 0; i < 3; i++)
+    {
+        vars["a"](i) = static_cast<double>(i + 2);
+        vars["y"](i) = static_cast<double>(10 * i);
+    }
+
+    Partials partials = client.ComputeResidualGradients(vars);
+    ASSERT_EQ((partials[{"y", "y"}].Size()), 3u);
+    for (size_t i = 0; i < 3; i++)
+    {
+        EXPECT_DOUBLE_EQ((partials[{"y", "a"}](i)), 10.0 * i);
+        EXPECT_DOUBLE_EQ((partials[{"y", "y"}](i)), i + 2.0);
+    }
+
+    // a client without sparse partial support receives the dense Jacobians
+    ImplicitClient dense_client;
+    dense_client.ConnectChannel(CreateTestChannel(address));
+    dense_client.GetVariableDefinitions();
+    dense_client.GetPartialDefinitions();
+
+    Partials dense = dense_client.ComputeResidualGradients(vars);
+    ASSERT_EQ((dense[{"y", "y"}].Size()), 9u);
+    EXPECT_DOUBLE_EQ((dense[{"y", "y"}](4)), 3.0);
+    EXPECT_DOUBLE_EQ((dense[{"y", "y"}](1)), 0.0);
+}
+
+class CountingImplicitDiscipline : public SimpleImplicitDiscipline {
+public:
+    void SolveResiduals(const Variables &inputs, Variables &outputs) override {
+        solve_calls_++;
+        SimpleImplicitDiscipline::SolveResiduals(inputs, outputs);
+    }
+
+    void ComputeResiduals(const Variables &inputs, const Variables &outputs,
+                          Variables &residuals) override {
+        residual_calls_++;
+        SimpleImplicitDiscipline::ComputeResiduals(inputs, outputs, residuals);
+    }
+
+    int solve_calls_ = 0;
+    int residual_calls_ = 0;
+};
+
+TEST_F(ImplicitErrorScenariosTest, ResultCacheSkipsRepeatedCalls) {
+    auto discipline = std::make_shared<CountingImplicitDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.EnableResultCache(1 << 20);
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(3.0);
+
+    EXPECT_DOUBLE_EQ(client.SolveResiduals(inputs).at("y")(0), 9.0);
+    EXPECT_DOUBLE_EQ(client.SolveResiduals(inputs).at("y")(0), 9.0);
+    EXPECT_EQ(discipline->solve_calls_, 1);
+
+    // residuals are cached separately from solutions
+    inputs["y"] = Variable(client.GetVariableMeta("y"));
+    inputs["y"](0) = 8.0;
+    EXPECT_DOUBLE_EQ(client.ComputeResiduals(inputs).at("y")(0), 1.0);
+    EXPECT_DOUBLE_EQ(client.ComputeResiduals(inputs).at("y")(0), 1.0);
+    EXPECT_EQ(discipline->residual_calls_, 1);
+
+    EXPECT_EQ(client.GetResultCacheStats().hits, 2u);
+
+    // disabling the cache evaluates every call remotely
+    client.EnableResultCache(0);
+    client.ComputeResiduals(inputs);
+    EXPECT_EQ(discipline->residual_calls_, 2);
+}
@@ -558,3 +558,122 @@ TEST_F(ImplicitIntegrationTest, VerifySolutionSatisfiesResidual) {
     // Residual should be near zero
     EXPECT_NEAR(residuals["x"](0), 0.0, 1e-10);
 }
+
+TEST_F(ImplicitIntegrationTest, SharedMemoryTransport) {
+    auto discipline = std::make_shared<SimpleImplicitDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.EnableSharedMemory();
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    // client and server run in the same process
+    ASSERT_TRUE(client.UsesSharedMemory());
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(4.0);
+    Variables outputs = client.SolveResiduals(inputs);
+    EXPECT_DOUBLE_EQ(outputs["y"](0), 16.0);
+
+    Variables vars;
+    vars["x"] = Variable(client.GetVariableMeta("x"));
+    vars["x"](0) = 5.0;
+    vars["y"] = Variable(client.GetVariableMeta("y"));
+    vars["y"](0) = 24.0;
+
+    Variables residuals = client.ComputeResiduals(vars);
+    EXPECT_NEAR(residuals["y"](0), 1.0, 1e-10);
+
+    Partials partials = client.ComputeResidualGradients(vars);
+    EXPECT_DOUBLE_EQ((partials[{"y", "x"}](0)), 10.0);
+    EXPECT_DOUBLE_EQ((partials[{"y", "y"}](0)), -1.0);
+}
+
+TEST_F(ImplicitIntegrationTest, ServeInProcess) {
+    auto discipline = std::make_shared<SimpleImplicitDiscipline>();
+    std::unique_ptr<ImplicitClient> client = discipline->ServeInProcess();
+
+    Variables inputs;
+    inputs["x"] = CreateScalarVariable(4.0);
+
+    Variables outputs = client->SolveResiduals(inputs);
+    EXPECT_DOUBLE_EQ(outputs["y"](0), 16.0);
+}
+
+TEST_F(ImplicitIntegrationTest, SimpleImplicitJacobianProducts) {
+    // R = x^2 - y, so dR = 2x dx - dy
+    auto discipline = std::make_shared<SimpleImplicitDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+
+    Variables vars;
+    vars["x"] = Variable(client.GetVariableMeta("x"));
+    vars["x"](0) = 3.0;
+    vars["y"] = Variable(client.GetVariableMeta("y"));
+    vars["y"](0) = 9.0;
+
+    Variables seeds;
+    seeds["x"] = Variable(client.GetVariableMeta("x"));
+    seeds["x"](0) = 1.0;
+    seeds["y"] = Variable(client.GetVariableMeta("y"));
+    seeds["y"](0) = 2.0;
+    Variables jac_vec = client.ComputeJacVec(vars, seeds);
+    ASSERT_EQ(jac_vec.size(), 1u);
+    EXPECT_NEAR(jac_vec["y"](0), 6.0 - 2.0, 1e-10);
+
+    Variables weights;
+    weights["y"] = Variable(client.GetVariableMeta("y"));
+    weights["y"](0) = 2.0;
+    Variables vec_jac = client.ComputeVecJac(vars, weights);
+    ASSERT_EQ(vec_jac.size(), 2u);
+    EXPECT_NEAR(vec_jac["x"](0), 12.0, 1e-10);
+    EXPECT_NEAR(vec_jac["y"](0), -2.0, 1e-10);
+}
+
+TEST_F(ImplicitIntegrationTest, SimpleImplicitLinearSolves) {
+    // dR/dy = -1, so both solves negate the right-hand side
+    auto discipline = std::make_shared<SimpleImplicitDiscipline>();
+
+    std::string address = server_manager_->StartServer(discipline);
+    ASSERT_FALSE(address.empty());
+
+    ImplicitClient client;
+    client.ConnectChannel(CreateTestChannel(address));
+    client.GetInfo();
+    client.Setup();
+    client.GetVariableDefinitions();
+    client.GetPartialDefinitions();
+    ASSERT_TRUE(client.ServerSupports(philote::kFeatureLinearSolves));
+
+    Variables vars;
+    vars["x"] = Variable(client.GetVariableMeta("x"));
+    vars["x"](0) = 3.0;
+    vars["y"] = Variable(client.GetVariableMeta("y"));
+    vars["y"](0) = 9.0;
+
+    Variables rhs;
+    rhs["y"] = Variable(client.GetVariableMeta("y"));
+    rhs["y"](0) = 3.0;
+
+    Variables solution = client.SolveLinear(vars, rhs);
+    ASSERT_EQ(solution.size(), 1u);
+    EXPECT_NEAR(solution["y"](0), -3.0, 1e-10);
+
+    Variables adjoint = client.SolveAdjointLinear(vars, rhs);
+    ASSERT_EQ(adjoint.size(), 1u);
+    EXPECT_NEAR(adjoint["y"](0), -3.0, 1e-10);
+}
@@ -0,0 +1,206 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/test/server_context_test_spouse.h>
+
+#include <callback_server.h>
+#include <chunk_pipeline.h>
+#include <input_session.h>
+#include <protocol_extensions.h>
+
+using namespace philote;
+
+namespace
+{
+    Variable MakeVector(const std::vector<double> &values)
+    {
+        Variable var(kInput, {values.size()});
+        for (size_t i = 0; i < values.size(); i++)
+            var(i) = values[i];
+        return var;
+    }
+
+    //! Sends the staged variables of a call and returns the written messages
+    std::vector<Array> SendCall(InputSession &session, const Variables &inputs, size_t chunk_size)
+    {
+        BufferedArrayStream buffer;
+        {
+            ChunkPipeline pipeline(&buffer, false);
+            for (const auto &entry : inputs)
+                if (session.Stage(entry.first, entry.second))
+                    session.Send(entry.first, entry.second, &pipeline, chunk_size);
+            pipeline.Finish();
+        }
+        return buffer.written();
+    }
+}
+
+TEST(InputSessionTests, RequestRoundTrip)
+{
+    InputSessionRequest request;
+    request.id = "abc";
+    request.base = 3;
+    request.version = 4;
+    EXPECT_EQ(FormatInputSession(request), "abc,3,4");
+
+    InputSessionRequest parsed;
+    ASSERT_TRUE(ParseInputSession("abc,3,4", parsed));
+    EXPECT_EQ(parsed.id, "abc");
+    EXPECT_EQ(parsed.base, 3u);
+    EXPECT_EQ(parsed.version, 4u);
+    EXPECT_TRUE(parsed.IsDelta());
+
+    ASSERT_TRUE(ParseInputSession("abc,0,1", parsed));
+    EXPECT_FALSE(parsed.IsDelta());
+}
+
+TEST(InputSessionTests, ParseRejectsInvalidRequests)
+{
+    InputSessionRequest request;
+    EXPECT_FALSE(ParseInputSession("", request));
+    EXPECT_FALSE(ParseInputSession("abc", request));
+    EXPECT_FALSE(ParseInputSession(",0,1", request));
+    EXPECT_FALSE(ParseInputSession("abc,1", request));
+    EXPECT_FALSE(ParseInputSession("abc,1,1", request));
+    EXPECT_FALSE(ParseInputSession("abc,-1,1", request));
+    EXPECT_FALSE(ParseInputSession("abc,0,x", request));
+}
+
+TEST(InputSessionTests, SendsOnlyChangedChunks)
+{
+    InputSession session;
+    EXPECT_FALSE(session.id().empty());
+
+    Variables inputs;
+    inputs["x"] = MakeVector({1.0, 2.0, 3.0, 4.0, 5.0});
+    inputs["y"] = MakeVector({6.0});
+
+    // the first call sends everything
+    EXPECT_EQ(session.Begin(), session.id() + ",0,1");
+    EXPECT_EQ(SendCall(session, inputs, 2).size(), 4u);
+    session.Commit();
+    EXPECT_TRUE(session.IsDelta());
+
+    // unchanged variables and chunks are skipped
+    inputs["x"](3) = 40.0;
+    EXPECT_EQ(session.Begin(), session.id() + ",1,2");
+    std::vector<Array> messages = SendCall(session, inputs, 2);
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0].name(), "x");
+    EXPECT_EQ(messages[0].start(), 2);
+    EXPECT_EQ(messages[0].end(), 3);
+    EXPECT_DOUBLE_EQ(messages[0].data(1), 40.0);
+    session.Commit();
+
+    EXPECT_EQ(session.Begin(), session.id() + ",2,3");
+    EXPECT_TRUE(SendCall(session, inputs, 2).empty());
+
+    // failed calls start over with all values
+    session.Reset();
+    EXPECT_EQ(session.Begin(), session.id() + ",0,1");
+    EXPECT_EQ(SendCall(session, inputs, 2).size(), 4u);
+}
+
+TEST(InputSessionTests, CacheRestoresBaseVersion)
+{
+    FlatVariables inputs;
+    inputs.Add("x", kInput, {3});
+    inputs.data()[0] = 1.0;
+    inputs.data()[1] = 2.0;
+    inputs.data()[2] = 3.0;
+
+    InputSessionCache cache;
+    InputSessionRequest request;
+
+    // calls without a session are not affected
+    EXPECT_TRUE(cache.Restore(nullptr, request, inputs).ok());
+    EXPECT_TRUE(request.id.empty());
+
+    grpc::ServerContext first;
+    grpc::testing::ServerContextTestSpouse first_spouse(&first);
+    first_spouse.AddClientMetadata(kInputSessionMetadataKey, "s,0,1");
+    ASSERT_TRUE(cache.Restore(&first, request, inputs).ok());
+    cache.Store(request, inputs);
+
+    inputs.data()[0] = 0.0;
+    inputs.data()[1] = 0.0;
+    grpc::ServerContext second;
+    grpc::testing::ServerContextTestSpouse second_spouse(&second);
+    second_spouse.AddClientMetadata(kInputSessionMetadataKey, "s,1,2");
+    ASSERT_TRUE(cache.Restore(&second, request, inputs).ok());
+    EXPECT_TRUE(request.IsDelta());
+    EXPECT_DOUBLE_EQ(inputs.data()[0], 1.0);
+    EXPECT_DOUBLE_EQ(inputs.data()[1], 2.0);
+    EXPECT_DOUBLE_EQ(inputs.data()[2], 3.0);
+    cache.Store(request, inputs);
+
+    // outdated base versions have to be resent in full
+    grpc::ServerContext outdated;
+    grpc::testing::ServerContextTestSpouse outdated_spouse(&outdated);
+    outdated_spouse.AddClientMetadata(kInputSessionMetadataKey, "s,1,2");
+    EXPECT_EQ(cache.Restore(&outdated, request, inputs).error_code(), grpc::StatusCode::FAILED_PRECONDITION);
+
+    grpc::ServerContext malformed;
+    grpc::testing::ServerContextTestSpouse malformed_spouse(&malformed);
+    malformed_spouse.AddClientMetadata(kInputSessionMetadataKey, "s,2");
+    EXPECT_EQ(cache.Restore(&malformed, request, inputs).error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+}
+
+TEST(InputSessionTests, CacheEvictsLeastRecentlyUsedSessions)
+{
+    FlatVariables inputs;
+    inputs.Add("x", kInput, {1});
+
+    InputSessionCache cache(2);
+    for (const std::string id : {"a", "b", "c"})
+    {
+        InputSessionRequest request;
+        request.id = id;
+        request.version = 1;
+        cache.Store(request, inputs);
+    }
+
+    InputSessionRequest request;
+    grpc::ServerContext evicted;
+    grpc::testing::ServerContextTestSpouse evicted_spouse(&evicted);
+    evicted_spouse.AddClientMetadata(kInputSessionMetadataKey, "a,1,2");
+    EXPECT_EQ(cache.Restore(&evicted, request, inputs).error_code(), grpc::StatusCode::FAILED_PRECONDITION);
+
+    grpc::ServerContext kept;
+    grpc::testing::ServerContextTestSpouse kept_spouse(&kept);
+    kept_spouse.AddClientMetadata(kInputSessionMetadataKey, "c,1,2");
+    EXPECT_TRUE(cache.Restore(&kept, request, inputs).ok());
+}
@@ -0,0 +1,374 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <instance_pool.h>
+#include "test_helpers.h"
+
+using namespace philote;
+using namespace philote::test;
+
+// ============================================================================
+// Test Discipline
+// ============================================================================
+
+/**
+ * Scales its input by a configurable factor: y = scale * x
+ *
+ * Counts how many calls are running on each instance concurrently, so that
+ * tests can detect instances being shared between RPCs.
+ */
+class ScaleDiscipline : public ExplicitDiscipline {
+public:
+    explicit ScaleDiscipline(int sleep_ms = 0) : sleep_ms_(sleep_ms) {}
+
+    void Initialize() override {
+        AddOption("scale", "float");
+    }
+
+    void SetOptions(const google::protobuf::Struct &options_struct) override {
+        auto it = options_struct.fields().find("scale");
+        if (it != options_struct.fields().end())
+            scale_ = it->second.number_value();
+
+        ExplicitDiscipline::SetOptions(options_struct);
+    }
+
+    void Setup() override {
+        AddInput("x", {1}, "");
+        AddOutput("y", {1}, "");
+        setup_count_++;
+    }
+
+    void Compute(const Variables &inputs, Variables &outputs) override {
+        if (++active_ > 1)
+            shared_ = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms_));
+        outputs.at("y")(0) = scale_ * inputs.at("x")(0);
+        active_--;
+    }
+
+    double scale() const { return scale_; }
+    int setup_count() const { return setup_count_; }
+    bool WasShared() const { return shared_; }
+
+private:
+    int sleep_ms_;
+    double scale_ = 1.0;
+    int setup_count_ = 0;
+    std::atomic<int> active_{0};
+    std::atomic<bool> shared_{false};
+};
+
+google::protobuf::Struct ScaleOption(double scale) {
+    google::protobuf::Struct options;
+    (*options.mutable_fields())["scale"].set_number_value(scale);
+    return options;
+}
+
+// ============================================================================
+// Instance Pool Tests
+// ============================================================================
+
+TEST(InstancePoolTest, RejectsInvalidConstruction) {
+    EXPECT_THROW(InstancePool<ExplicitDiscipline>(nullptr, 2), std::invalid_argument);
+    EXPECT_THROW(InstancePool<ExplicitDiscipline>(
+                     [] { return std::make_shared<ScaleDiscipline>(); }, 0),
+                 std::invalid_argument);
+}
+
+TEST(InstancePoolTest, CreatesInstancesLazilyAndReusesThem) {
+    ScaleDiscipline primary;
+    InstancePool<ExplicitDiscipline> pool([] { return std::make_shared<ScaleDiscipline>(); }, 4);
+    EXPECT_EQ(pool.created(), 0u);
+
+    {
+        auto first = pool.Acquire(primary);
+        auto second = pool.Acquire(primary);
+        EXPECT_NE(first.get(), second.get());
+        EXPECT_NE(first.get(), &primary);
+        EXPECT_EQ(pool.created(), 2u);
+    }
+
+    // returned instances are handed out again instead of creating new ones
+    auto again = pool.Acquire(primary);
+    EXPECT_TRUE(static_cast<bool>(again));
+    EXPECT_EQ(pool.created(), 2u);
+}
+
+TEST(InstancePoolTest, ReplaysPrimaryConfiguration) {
+    ScaleDiscipline primary;
+    primary.Initialize();
+    primary.SetOptions(ScaleOption(3.0));
+    primary.Setup();
+    primary.stream_opts().set_num_double(42);
+
+    InstancePool<ExplicitDiscipline> pool([] { return std::make_shared<ScaleDiscipline>(); }, 1);
+
+    {
+        auto lease = pool.Acquire(primary);
+        auto *instance = static_cast<ScaleDiscipline *>(lease.get());
+        EXPECT_DOUBLE_EQ(instance->scale(), 3.0);
+        EXPECT_EQ(instance->var_meta().size(), 2u);
+        EXPECT_EQ(instance->stream_opts().num_double(), 42);
+        EXPECT_EQ(instance->setup_count(), 1);
+    }
+
+    // unchanged configuration is not replayed again
+    {
+        auto lease = pool.Acquire(primary);
+        EXPECT_EQ(static_cast<ScaleDiscipline *>(lease.get())->setup_count(), 1);
+    }
+
+    // a configuration change is picked up on the next acquisition
+    primary.SetOptions(ScaleOption(5.0));
+    {
+        auto lease = pool.Acquire(primary);
+        auto *instance = static_cast<ScaleDiscipline *>(lease.get());
+        EXPECT_DOUBLE_EQ(instance->scale(), 5.0);
+        EXPECT_EQ(instance->setup_count(), 2);
+        EXPECT_EQ(instance->var_meta().size(), 2u);
+    }
+}
+
+TEST(InstancePoolTest, PlacesInstancesRoundRobin) {
+    ScaleDiscipline primary;
+    InstancePool<ExplicitDiscipline> pool([] { return std::make_shared<ScaleDiscipline>(); }, 3);
+
+    const std::vector<int> cpus = AvailableCpus();
+    ASSERT_FALSE(cpus.empty());
+    pool.SetPlacement({{cpus.front()}, {cpus.back()}});
+
+    auto first = pool.Acquire(primary);
+    auto second = pool.Acquire(primary);
+    auto third = pool.Acquire(primary);
+    EXPECT_EQ(first->placement(), (std::vector<int>{cpus.front()}));
+    EXPECT_EQ(second->placement(), (std::vector<int>{cpus.back()}));
+    EXPECT_EQ(third->placement(), (std::vector<int>{cpus.front()}));
+
+    // the acquiring thread is not left pinned
+    EXPECT_EQ(AvailableCpus(), cpus);
+}
+
+TEST(InstancePoolTest, PlacementRequiresAPool) {
+    auto discipline = std::make_shared<ScaleDiscipline>();
+    ThreadPlacement placement;
+    placement.policy = PlacementPolicy::kNumaNodes;
+
+    grpc::ServerBuilder builder;
+    EXPECT_THROW(discipline->RegisterServices(builder, ServerEngine::kSynchronous, 0, placement),
+                 std::invalid_argument);
+
+    discipline->EnableInstancePool([] { return std::make_shared<ScaleDiscipline>(); }, 2);
+    EXPECT_NO_THROW(discipline->RegisterServices(builder, ServerEngine::kSynchronous, 0, placement));
+}
+
+// ScaleDiscipline with a scale that does not change the definitions
+class ShapelessScaleDiscipline : public ScaleDiscipline {
+public:
+    void Initialize() override {
+        AddOption("scale", "float", false);
+    }
+};
+
+TEST(InstancePoolTest, ShapelessOptionsKeepPooledDefinitions) {
+    ShapelessScaleDiscipline primary;
+    primary.Initialize();
+    primary.SetOptions(ScaleOption(3.0));
+    primary.Setup();
+    primary.MarkConfigurationChanged();
+
+    InstancePool<ExplicitDiscipline> pool([] {
+        auto instance = std::make_shared<ShapelessScaleDiscipline>();
+        instance->Initialize();
+        return instance;
+    }, 1);
+
+    {
+        auto lease = pool.Acquire(primary);
+        EXPECT_EQ(static_cast<ScaleDiscipline *>(lease.get())->setup_count(), 1);
+    }
+
+    // the new scale is replayed without rerunning Setup
+    primary.SetOptions(ScaleOption(5.0));
+    {
+        auto lease = pool.Acquire(primary);
+        auto *instance = static_cast<ScaleDiscipline *>(lease.get());
+        EXPECT_DOUBLE_EQ(instance->scale(), 5.0);
+        EXPECT_EQ(instance->setup_count(), 1);
+        EXPECT_EQ(instance->var_meta().size(), 2u);
+    }
+}
+
+TEST(InstancePoolTest, BlocksWhenAllInstancesAreLeased) {
+    ScaleDiscipline primary;
+    InstancePool<ExplicitDiscipline> pool([] { return std::make_shared<ScaleDiscipline>(); }, 1);
+
+    auto lease = std::make_unique<InstancePool<ExplicitDiscipline>::Lease>(pool.Acquire(primary));
+
+    auto waiting = std::async(std::launch::async, [&] {
+        auto second = pool.Acquire(primary);
+        return second.get();
+    });
+
+    EXPECT_EQ(waiting.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+
+    ExplicitDiscipline *leased = lease->get();
+    lease.reset();
+
+    ASSERT_EQ(waiting.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(waiting.get(), leased);
+    EXPECT_EQ(pool.created(), 1u);
+}
+
+TEST(InstancePoolTest, WaitEndsAtTheDeadline) {
+    ScaleDiscipline primary;
+    InstancePool<ExplicitDiscipline> pool([] { return std::make_shared<ScaleDiscipline>(); }, 1);
+    auto lease = pool.Acquire(primary);
+
+    const auto start = std::chrono::system_clock::now();
+    auto late = pool.Acquire(primary, start + std::chrono::milliseconds(50), CancellationToken());
+    EXPECT_FALSE(static_cast<bool>(late));
+    EXPECT_GE(std::chrono::system_clock::now() - start, std::chrono::milliseconds(50));
+    EXPECT_LT(std::chrono::system_clock::now() - start, std::chrono::seconds(2));
+
+    // an available instance is leased regardless of the deadline
+    lease = InstancePool<ExplicitDiscipline>::Lease();
+    EXPECT_TRUE(static_cast<bool>(pool.Acquire(primary, start, CancellationToken())));
+}
+
+TEST(InstancePoolTest, WaitEndsWithTheCancellation) {
+    ScaleDiscipline primary;
+    InstancePool<ExplicitDiscipline> pool([] { return std::make_shared<ScaleDiscipline>(); }, 1);
+    auto lease = pool.Acquire(primary);
+
+    CancellationToken cancellation;
+    auto waiting = std::async(std::launch::async, [&] {
+        return static_cast<bool>(pool.Acquire(primary, std::chrono::system_clock::time_point::max(),
+                                              cancellation));
+    });
+    EXPECT_EQ(waiting.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+
+    cancellation.Cancel();
+    ASSERT_EQ(waiting.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_FALSE(waiting.get());
+    EXPECT_EQ(pool.created(), 1u);
+}
+
+TEST(InstancePoolTest, FactoryFailureDoesNotConsumeSlot) {
+    ScaleDiscipline primary;
+    int calls = 0;
+    InstancePool<ExplicitDiscipline> pool([&calls]() -> std::shared_ptr<ExplicitDiscipline> {
+        if (calls++ == 0)
+            throw std::runtime_error("factory failure");
+        return std::make_shared<ScaleDiscipline>();
+    }, 1);
+
+    EXPECT_THROW(pool.Acquire(primary), std::runtime_error);
+    EXPECT_EQ(pool.created(), 0u);
+
+    auto lease = pool.Acquire(primary);
+    EXPECT_TRUE(static_cast<bool>(lease));
+}
+
+TEST(InstancePoolTest, NullFactoryResultThrows) {
+    ScaleDiscipline primary;
+    InstancePool<ExplicitDiscipline> pool([] { return std::shared_ptr<ExplicitDiscipline>(); }, 1);
+
+    EXPECT_THROW(pool.Acquire(primary), std::runtime_error);
+    EXPECT_EQ(pool.created(), 0u);
+}
+
+// ============================================================================
+// Server Tests
+// ============================================================================
+
+TEST(InstancePoolServerTest, ConcurrentCallsUseSeparateInstances) {
+    constexpr int kThreads = 4;
+
+    std::vector<std::shared_ptr<ScaleDiscipline>> instances;
+    std::mutex instances_mutex;
+
+    auto discipline = std::make_shared<ScaleDiscipline>();
+    discipline->EnableInstancePool([&] {
+        auto instance = std::make_shared<ScaleDiscipline>(50);
+        std::lock_guard<std::mutex> lock(instances_mutex);
+        instances.push_back(instance);
+        return instance;
+    }, kThreads);
+
+    TestServerManager server;
+    std::string address = server.StartServer(discipline);
+    auto channel = CreateTestChannel(address);
+
+    // configure the primary discipline through the client
+    ExplicitClient setup_client;
+    setup_client.ConnectChannel(channel);
+    DisciplineOptions options;
+    *options.mutable_options() = ScaleOption(2.0);
+    setup_client.SendOptions(options);
+    setup_client.Setup();
+
+    std::vector<std::future<double>> results;
+    for (int i = 0; i < kThreads; i++)
+    {
+        results.push_back(std::async(std::launch::async, [&channel, i] {
+            ExplicitClient client;
+            client.ConnectChannel(channel);
+            client.GetVariableDefinitions();
+
+            Variables inputs;
+            inputs["x"] = CreateScalarVariable(static_cast<double>(i));
+            return client.ComputeFunction(inputs).at("y")(0);
+        }));
+    }
+
+    for (int i = 0; i < kThreads; i++)
+        EXPECT_DOUBLE_EQ(results[i].get(), 2.0 * i);
+
+    server.StopServer();
+
+    // the primary discipline never computes, and no instance was shared
+    EXPECT_FALSE(discipline->WasShared());
+    EXPECT_LE(instances.size(), static_cast<size_t>(kThreads));
+    for (const auto &instance : instances)
+    {
+        EXPECT_FALSE(instance->WasShared());
+        EXPECT_DOUBLE_EQ(instance->scale(), 2.0);
+    }
+}
@@ -0,0 +1,160 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <jacobian_product.h>
+
+using philote::MultiplyJacobian;
+using philote::MultiplyJacobianTranspose;
+using philote::Partials;
+using philote::PartialsSparsity;
+using philote::Variable;
+using philote::Variables;
+
+namespace
+{
+    //! f (size 2) and g (size 1) of x (size 3) and y (size 1)
+    Partials DensePartials()
+    {
+        Partials partials;
+        partials[{"f", "x"}] = Variable(philote::kOutput, {2, 3});
+        partials[{"f", "y"}] = Variable(philote::kOutput, {2, 1});
+        partials[{"g", "x"}] = Variable(philote::kOutput, {1, 3});
+
+        // df/dx = [[1, 2, 3], [4, 5, 6]], df/dy = [7, 8], dg/dx = [9, 10, 11]
+        for (size_t i = 0; i < 6; i++)
+            partials[{"f", "x"}](i) = static_cast<double>(i + 1);
+        partials[{"f", "y"}](0) = 7.0;
+        partials[{"f", "y"}](1) = 8.0;
+        for (size_t i = 0; i < 3; i++)
+            partials[{"g", "x"}](i) = static_cast<double>(i + 9);
+
+        return partials;
+    }
+
+    Variables Allocate(const std::map<std::string, size_t> &sizes)
+    {
+        Variables vars;
+        for (const auto &size : sizes)
+            vars[size.first] = Variable(philote::kOutput, {size.second});
+        return vars;
+    }
+}
+
+TEST(JacobianProductTests, DenseForwardProduct)
+{
+    Variables seeds = Allocate({{"x", 3}, {"y", 1}});
+    seeds["x"](0) = 1.0;
+    seeds["x"](1) = -1.0;
+    seeds["x"](2) = 2.0;
+    seeds["y"](0) = 0.5;
+
+    Variables products = Allocate({{"f", 2}, {"g", 1}});
+    MultiplyJacobian(DensePartials(), PartialsSparsity(), seeds, products);
+
+    EXPECT_DOUBLE_EQ(products["f"](0), 1.0 - 2.0 + 6.0 + 3.5);
+    EXPECT_DOUBLE_EQ(products["f"](1), 4.0 - 5.0 + 12.0 + 4.0);
+    EXPECT_DOUBLE_EQ(products["g"](0), 9.0 - 10.0 + 22.0);
+}
+
+TEST(JacobianProductTests, DenseReverseProduct)
+{
+    Variables seeds = Allocate({{"f", 2}, {"g", 1}});
+    seeds["f"](0) = 1.0;
+    seeds["f"](1) = 2.0;
+    seeds["g"](0) = -1.0;
+
+    Variables products = Allocate({{"x", 3}, {"y", 1}});
+    MultiplyJacobianTranspose(DensePartials(), PartialsSparsity(), seeds, products);
+
+    EXPECT_DOUBLE_EQ(products["x"](0), 1.0 + 8.0 - 9.0);
+    EXPECT_DOUBLE_EQ(products["x"](1), 2.0 + 10.0 - 10.0);
+    EXPECT_DOUBLE_EQ(products["x"](2), 3.0 + 12.0 - 11.0);
+    EXPECT_DOUBLE_EQ(products["y"](0), 7.0 + 16.0);
+}
+
+TEST(JacobianProductTests, MissingSeedsAreZero)
+{
+    Variables seeds = Allocate({{"y", 1}});
+    seeds["y"](0) = 1.0;
+
+    Variables products = Allocate({{"f", 2}, {"g", 1}});
+    products["g"](0) = 42.0;
+    MultiplyJacobian(DensePartials(), PartialsSparsity(), seeds, products);
+
+    EXPECT_DOUBLE_EQ(products["f"](0), 7.0);
+    EXPECT_DOUBLE_EQ(products["f"](1), 8.0);
+    EXPECT_DOUBLE_EQ(products["g"](0), 0.0);
+}
+
+TEST(JacobianProductTests, SparseProductsMatchDenseProducts)
+{
+    // diagonal df/dx of size 3 stored as non-zeros
+    PartialsSparsity sparsity;
+    sparsity[{"f", "x"}].rows = {0, 1, 2};
+    sparsity[{"f", "x"}].cols = {0, 1, 2};
+    sparsity[{"f", "x"}].num_cols = 3;
+    sparsity[{"f", "x"}].dense_shape = {3, 3};
+
+    Partials partials;
+    partials[{"f", "x"}] = Variable(philote::kOutput, {3});
+    for (size_t i = 0; i < 3; i++)
+        partials[{"f", "x"}](i) = static_cast<double>(i + 2);
+
+    Variables seeds = Allocate({{"x", 3}});
+    for (size_t i = 0; i < 3; i++)
+        seeds["x"](i) = static_cast<double>(i + 1);
+
+    Variables forward = Allocate({{"f", 3}});
+    MultiplyJacobian(partials, sparsity, seeds, forward);
+
+    Variables reverse_seeds = Allocate({{"f", 3}});
+    for (size_t i = 0; i < 3; i++)
+        reverse_seeds["f"](i) = static_cast<double>(i + 1);
+    Variables reverse = Allocate({{"x", 3}});
+    MultiplyJacobianTranspose(partials, sparsity, reverse_seeds, reverse);
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        EXPECT_DOUBLE_EQ(forward["f"](i), static_cast<double>((i + 2) * (i + 1)));
+        EXPECT_DOUBLE_EQ(reverse["x"](i), static_cast<double>((i + 2) * (i + 1)));
+    }
+}
+
+TEST(JacobianProductTests, RejectsMismatchedSizes)
+{
+    Variables seeds = Allocate({{"x", 2}});
+    Variables products = Allocate({{"f", 2}, {"g", 1}});
+
+    EXPECT_THROW(MultiplyJacobian(DensePartials(), PartialsSparsity(), seeds, products), std::length_error);
+}
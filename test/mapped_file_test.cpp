@@ -0,0 +1,179 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <flat_variables.h>
+#include <mapped_file.h>
+#include <variable.h>
+
+using philote::FileStorage;
+using philote::FlatVariables;
+using philote::kOutput;
+using philote::MappedFile;
+using philote::Variable;
+using philote::VariableMetaData;
+
+namespace
+{
+    VariableMetaData Meta(const std::string &name, philote::VariableType type,
+                          const std::vector<int64_t> &shape)
+    {
+        VariableMetaData meta;
+        meta.set_name(name);
+        meta.set_type(type);
+        for (int64_t dim : shape)
+            meta.add_shape(dim);
+        return meta;
+    }
+
+    FileStorage TempStorage(size_t min_size)
+    {
+        FileStorage storage;
+        storage.directory = ::testing::TempDir();
+        storage.min_size = min_size;
+        return storage;
+    }
+}
+
+TEST(MappedFileTests, TemporaryFileIsZeroAndWritable)
+{
+    auto file = MappedFile::CreateTemporary(::testing::TempDir(), 5000);
+    ASSERT_EQ(file->size(), 5000u);
+    for (size_t i = 0; i < file->size(); i++)
+        ASSERT_EQ(file->data()[i], 0.0);
+
+    file->data()[4999] = 3.0;
+    EXPECT_EQ(file->data()[4999], 3.0);
+}
+
+TEST(MappedFileTests, ReleaseKeepsTheValues)
+{
+    auto file = MappedFile::CreateTemporary(::testing::TempDir(), 10000);
+    for (size_t i = 0; i < file->size(); i++)
+        file->data()[i] = static_cast<double>(i);
+
+    file->Release(0, file->size() - 1);
+    for (size_t i = 0; i < file->size(); i++)
+        ASSERT_EQ(file->data()[i], static_cast<double>(i));
+}
+
+TEST(MappedFileTests, ZeroDiscardsTheValues)
+{
+    auto file = MappedFile::CreateTemporary(::testing::TempDir(), 1000);
+    file->data()[10] = 1.0;
+    file->Zero();
+    EXPECT_EQ(file->data()[10], 0.0);
+}
+
+TEST(MappedFileTests, NamedFileKeepsItsValues)
+{
+    const std::string path = ::testing::TempDir() + "philote_mapped_file_test.bin";
+    MappedFile::Create(path, 4)->data()[2] = 7.0;
+
+    auto file = MappedFile::Create(path, 4);
+    EXPECT_EQ(file->data()[2], 7.0);
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTests, FileBackedVariable)
+{
+    auto file = MappedFile::CreateTemporary(::testing::TempDir(), 6);
+    Variable var(kOutput, {2, 2}, file, 2);
+
+    EXPECT_TRUE(var.IsView());
+    EXPECT_TRUE(var.IsFileBacked());
+    EXPECT_EQ(var.Size(), 4u);
+
+    var(0) = 1.0;
+    EXPECT_EQ(file->data()[2], 1.0);
+
+    // copies are held in memory
+    Variable copy(var);
+    EXPECT_FALSE(copy.IsFileBacked());
+    EXPECT_EQ(copy(0), 1.0);
+
+    Variable moved(std::move(var));
+    EXPECT_TRUE(moved.IsFileBacked());
+
+    EXPECT_THROW(Variable(kOutput, {7}, file), std::invalid_argument);
+}
+
+TEST(MappedFileTests, AssignedChunksReachTheFile)
+{
+    Variable var = philote::AllocateVariable(Meta("f", kOutput, {3}), TempStorage(1));
+    ASSERT_TRUE(var.IsFileBacked());
+
+    philote::Array chunk;
+    chunk.set_start(1);
+    chunk.set_end(2);
+    chunk.add_data(4.0);
+    chunk.add_data(5.0);
+    var.AssignChunk(chunk);
+
+    EXPECT_EQ(var(1), 4.0);
+    EXPECT_EQ(var(2), 5.0);
+}
+
+TEST(MappedFileTests, SmallVariablesStayInMemory)
+{
+    Variable var = philote::AllocateVariable(Meta("f", kOutput, {3}), TempStorage(4));
+    EXPECT_FALSE(var.IsFileBacked());
+
+    Variable in_memory = philote::AllocateVariable(Meta("f", kOutput, {3}), FileStorage());
+    EXPECT_FALSE(in_memory.IsFileBacked());
+}
+
+TEST(MappedFileTests, FileBackedFlatVariables)
+{
+    std::vector<VariableMetaData> meta = {Meta("f", kOutput, {2}), Meta("g", kOutput, {3})};
+    FlatVariables outputs(meta, kOutput, TempStorage(1));
+
+    ASSERT_TRUE(outputs.IsFileBacked());
+    EXPECT_EQ(outputs.size(), 11u);
+    EXPECT_TRUE(outputs.map().at("g").IsFileBacked());
+    EXPECT_EQ(outputs.map().at("g").data(), outputs.data() + 8);
+
+    outputs.map().at("g")(2) = 3.0;
+    EXPECT_EQ(outputs.data()[10], 3.0);
+
+    outputs.Fill(0.0);
+    EXPECT_EQ(outputs.data()[10], 0.0);
+
+    EXPECT_THROW(outputs.Add("h", kOutput, {1}), std::logic_error);
+
+    FlatVariables copy(outputs);
+    EXPECT_FALSE(copy.IsFileBacked());
+    EXPECT_EQ(copy.size(), 5u);
+}
@@ -0,0 +1,110 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <meta_index.h>
+
+using namespace philote;
+
+namespace
+{
+    VariableMetaData Meta(const std::string &name, VariableType type)
+    {
+        VariableMetaData meta;
+        meta.set_name(name);
+        meta.set_type(type);
+        return meta;
+    }
+}
+
+TEST(MetaIndexTest, FindsIndexedEntries)
+{
+    std::vector<VariableMetaData> meta;
+    VariableMetaIndex index;
+    for (int i = 0; i < 100; i++)
+    {
+        meta.push_back(Meta("x" + std::to_string(i), kInput));
+        index.Update(meta);
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        const VariableMetaData *var = index.Find(meta, "x" + std::to_string(i));
+        ASSERT_NE(var, nullptr);
+        EXPECT_EQ(var, &meta[i]);
+    }
+    EXPECT_EQ(index.Find(meta, "y"), nullptr);
+}
+
+TEST(MetaIndexTest, KeepsFirstEntryOfName)
+{
+    std::vector<VariableMetaData> meta = {Meta("x", kInput), Meta("x", kOutput)};
+    VariableMetaIndex index;
+    index.Update(meta);
+
+    EXPECT_EQ(index.Find(meta, "x"), &meta[0]);
+}
+
+TEST(MetaIndexTest, DetectsUnindexedChanges)
+{
+    std::vector<VariableMetaData> meta = {Meta("x", kInput), Meta("f", kOutput)};
+    VariableMetaIndex index;
+    index.Update(meta);
+
+    // appended without an update
+    meta.push_back(Meta("y", kInput));
+    ASSERT_NE(index.Find(meta, "y"), nullptr);
+    EXPECT_EQ(index.Find(meta, "y")->name(), "y");
+
+    // renamed without an update
+    meta[0].set_name("z");
+    EXPECT_EQ(index.Find(meta, "x"), nullptr);
+
+    // a shrinking list rebuilds the index
+    meta = {Meta("f", kOutput)};
+    index.Update(meta);
+    EXPECT_EQ(index.Find(meta, "f"), &meta[0]);
+    EXPECT_EQ(index.Find(meta, "x"), nullptr);
+}
+
+TEST(MetaIndexTest, Clear)
+{
+    std::vector<VariableMetaData> meta = {Meta("x", kInput)};
+    VariableMetaIndex index;
+    index.Update(meta);
+    index.Clear();
+
+    meta.clear();
+    EXPECT_EQ(index.Find(meta, "x"), nullptr);
+}
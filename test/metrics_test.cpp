@@ -0,0 +1,172 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <callback_server.h>
+#include <metrics.h>
+#include <tracing.h>
+
+using namespace philote;
+using ::testing::HasSubstr;
+
+namespace
+{
+    Array MakeArray(const std::string &name, size_t size)
+    {
+        Array array;
+        array.set_name(name);
+        array.set_start(0);
+        array.set_end(size - 1);
+        for (size_t i = 0; i < size; i++)
+            array.add_data(static_cast<double>(i));
+        return array;
+    }
+}
+
+TEST(MetricsTests, MeteredStreamCountsMessages)
+{
+    BufferedArrayStream buffer;
+    buffer.Push(MakeArray("x", 4));
+    buffer.Push(MakeArray("y", 2));
+    const size_t received_bytes = MakeArray("x", 4).ByteSizeLong() + MakeArray("y", 2).ByteSizeLong();
+
+    MeteredArrayStream stream(&buffer);
+    Array message;
+    while (stream.Read(&message))
+        ;
+
+    const Array output = MakeArray("f", 3);
+    EXPECT_TRUE(stream.Write(output));
+
+    CallMetrics metrics = stream.Finish("ComputeFunction", grpc::Status::OK);
+
+    EXPECT_EQ(metrics.rpc, "ComputeFunction");
+    EXPECT_EQ(metrics.messages_received, 2u);
+    EXPECT_EQ(metrics.bytes_received, received_bytes);
+    EXPECT_EQ(metrics.messages_sent, 1u);
+    EXPECT_EQ(metrics.bytes_sent, output.ByteSizeLong());
+    EXPECT_EQ(metrics.status, grpc::StatusCode::OK);
+    EXPECT_GE(metrics.receive.count(), 0);
+    EXPECT_GE(metrics.compute.count(), 0);
+    EXPECT_GE(metrics.send.count(), 0);
+
+    // the messages are forwarded
+    ASSERT_EQ(buffer.written().size(), 1u);
+    EXPECT_EQ(buffer.written()[0].name(), "f");
+}
+
+TEST(MetricsTests, ObserveCallWithoutRecorderPassesStream)
+{
+    BufferedArrayStream buffer;
+    grpc::ServerReaderWriterInterface<Array, Array> *seen = nullptr;
+
+    grpc::Status status = ObserveCall(nullptr, nullptr, nullptr, "ComputeFunction", &buffer,
+                                      [&](auto *stream)
+                                      {
+                                          seen = stream;
+                                          return grpc::Status::OK;
+                                      });
+
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(seen, &buffer);
+}
+
+TEST(MetricsTests, ObserveCallRecordsStatus)
+{
+    BufferedArrayStream buffer;
+    buffer.Push(MakeArray("x", 1));
+    MetricsRegistry registry;
+
+    grpc::Status status = ObserveCall(&registry, nullptr, nullptr, "ComputeGradient", &buffer,
+                                      [](auto *stream)
+                                      {
+                                          Array message;
+                                          while (stream->Read(&message))
+                                              ;
+                                          return grpc::Status(grpc::StatusCode::INTERNAL, "failed");
+                                      });
+    ObserveCall(&registry, nullptr, nullptr, "ComputeGradient", &buffer,
+                [](auto *) { return grpc::Status(grpc::StatusCode::CANCELLED, "cancelled"); });
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INTERNAL);
+
+    std::map<std::string, RpcMetrics> rpcs = registry.Snapshot();
+    ASSERT_EQ(rpcs.count("ComputeGradient"), 1u);
+    EXPECT_EQ(rpcs["ComputeGradient"].calls, 2u);
+    EXPECT_EQ(rpcs["ComputeGradient"].errors, 1u);
+    EXPECT_EQ(rpcs["ComputeGradient"].cancellations, 1u);
+    EXPECT_EQ(rpcs["ComputeGradient"].messages_received, 1u);
+    EXPECT_EQ(rpcs["ComputeGradient"].messages_sent, 0u);
+}
+
+TEST(MetricsTests, RegistryAccumulatesAndResets)
+{
+    MetricsRegistry registry;
+
+    CallMetrics call;
+    call.rpc = "ComputeFunction";
+    call.compute = std::chrono::milliseconds(250);
+    call.bytes_sent = 100;
+    registry.Record(call);
+    registry.Record(call);
+
+    RpcMetrics rpc = registry.Snapshot().at("ComputeFunction");
+    EXPECT_EQ(rpc.calls, 2u);
+    EXPECT_EQ(rpc.errors, 0u);
+    EXPECT_EQ(rpc.compute, std::chrono::milliseconds(500));
+    EXPECT_EQ(rpc.bytes_sent, 200u);
+
+    registry.Reset();
+    EXPECT_TRUE(registry.Snapshot().empty());
+}
+
+TEST(MetricsTests, PrometheusText)
+{
+    MetricsRegistry registry;
+
+    CallMetrics call;
+    call.rpc = "SolveResiduals";
+    call.compute = std::chrono::milliseconds(500);
+    call.messages_received = 3;
+    registry.Record(call);
+
+    const std::string text = registry.ToPrometheusText();
+
+    EXPECT_THAT(text, HasSubstr("# TYPE philote_rpc_calls_total counter"));
+    EXPECT_THAT(text, HasSubstr("philote_rpc_calls_total{rpc=\"SolveResiduals\"} 1\n"));
+    EXPECT_THAT(text, HasSubstr("philote_rpc_phase_seconds_total{rpc=\"SolveResiduals\",phase=\"compute\"} 0.5\n"));
+    EXPECT_THAT(text, HasSubstr("philote_rpc_messages_total{rpc=\"SolveResiduals\",direction=\"received\"} 3\n"));
+    EXPECT_THAT(text, HasSubstr("philote_rpc_errors_total{rpc=\"SolveResiduals\"} 0\n"));
+}
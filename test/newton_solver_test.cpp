@@ -0,0 +1,204 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <newton_solver.h>
+
+using philote::CoordinateMatrix;
+using philote::DenseLUSolver;
+using philote::LinearSolver;
+using philote::NewtonOptions;
+using philote::NewtonSolver;
+using philote::NonlinearMethod;
+using philote::SparseLUSolver;
+
+namespace
+{
+    //! [[0, 2, 0], [1, 1, 0], [0, 3, 4]] (requires pivoting)
+    CoordinateMatrix PivotingMatrix()
+    {
+        CoordinateMatrix matrix;
+        matrix.Clear(3);
+        matrix.Add(0, 1, 2.0);
+        matrix.Add(1, 0, 1.0);
+        matrix.Add(1, 1, 0.5);
+        matrix.Add(1, 1, 0.5);  // duplicates are summed
+        matrix.Add(2, 1, 3.0);
+        matrix.Add(2, 2, 4.0);
+        return matrix;
+    }
+
+    void ExpectSolves(LinearSolver &solver)
+    {
+        solver.Factorize(PivotingMatrix());
+
+        // x = [1, 2, 3]
+        std::vector<double> rhs = {4.0, 3.0, 18.0};
+        solver.Solve(rhs);
+        EXPECT_NEAR(rhs[0], 1.0, 1e-14);
+        EXPECT_NEAR(rhs[1], 2.0, 1e-14);
+        EXPECT_NEAR(rhs[2], 3.0, 1e-14);
+    }
+
+    //! R(y) = [y0^2 + y1^2 - 4, y0 - y1], solved by y0 = y1 = sqrt(2)
+    void Residual(const std::vector<double> &y, std::vector<double> &r)
+    {
+        r[0] = y[0] * y[0] + y[1] * y[1] - 4.0;
+        r[1] = y[0] - y[1];
+    }
+
+    void Jacobian(const std::vector<double> &y, CoordinateMatrix &jacobian)
+    {
+        jacobian.Add(0, 0, 2.0 * y[0]);
+        jacobian.Add(0, 1, 2.0 * y[1]);
+        jacobian.Add(1, 0, 1.0);
+        jacobian.Add(1, 1, -1.0);
+    }
+}
+
+TEST(NewtonSolverTests, DenseLUSolves)
+{
+    DenseLUSolver solver;
+    ExpectSolves(solver);
+}
+
+TEST(NewtonSolverTests, SparseLUSolves)
+{
+    SparseLUSolver solver;
+    ExpectSolves(solver);
+}
+
+TEST(NewtonSolverTests, SparseLUMatchesDenseLUWithFillIn)
+{
+    // arrow matrix: the first row and column are dense
+    const size_t n = 6;
+    CoordinateMatrix matrix;
+    matrix.Clear(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        matrix.Add(i, i, 4.0 + static_cast<double>(i));
+        if (i > 0)
+        {
+            matrix.Add(0, i, 1.0);
+            matrix.Add(i, 0, -1.0);
+        }
+    }
+
+    DenseLUSolver dense;
+    SparseLUSolver sparse;
+    dense.Factorize(matrix);
+    sparse.Factorize(matrix);
+
+    std::vector<double> a(n), b(n);
+    for (size_t i = 0; i < n; i++)
+        a[i] = b[i] = static_cast<double>(i) - 2.5;
+    dense.Solve(a);
+    sparse.Solve(b);
+    for (size_t i = 0; i < n; i++)
+        EXPECT_NEAR(a[i], b[i], 1e-13);
+}
+
+TEST(NewtonSolverTests, SingularMatricesThrow)
+{
+    CoordinateMatrix matrix;
+    matrix.Clear(2);
+    matrix.Add(0, 0, 1.0);
+    matrix.Add(1, 0, 2.0);
+
+    DenseLUSolver dense;
+    SparseLUSolver sparse;
+    EXPECT_THROW(dense.Factorize(matrix), std::runtime_error);
+    EXPECT_THROW(sparse.Factorize(matrix), std::runtime_error);
+    EXPECT_THROW(matrix.Add(2, 0, 1.0), std::out_of_range);
+}
+
+TEST(NewtonSolverTests, NewtonConverges)
+{
+    NewtonSolver solver;
+    NewtonOptions options;
+    std::vector<double> y = {1.0, 2.0};
+
+    const size_t iterations = solver.Solve(options, y, Residual, Jacobian);
+    EXPECT_GT(iterations, 0u);
+    EXPECT_LT(iterations, 10u);
+    EXPECT_NEAR(y[0], std::sqrt(2.0), 1e-10);
+    EXPECT_NEAR(y[1], std::sqrt(2.0), 1e-10);
+}
+
+TEST(NewtonSolverTests, BroydenConvergesWithFewerJacobians)
+{
+    NewtonSolver solver;
+    NewtonOptions options;
+    options.method = NonlinearMethod::kBroyden;
+    options.linear_solver = []
+    { return std::make_unique<SparseLUSolver>(); };
+
+    size_t jacobians = 0;
+    std::vector<double> y = {1.0, 2.0};
+    const size_t iterations = solver.Solve(options, y, Residual,
+                                           [&jacobians](const std::vector<double> &y, CoordinateMatrix &jacobian)
+                                           {
+                                               jacobians++;
+                                               Jacobian(y, jacobian);
+                                           });
+
+    EXPECT_NEAR(y[0], std::sqrt(2.0), 1e-9);
+    EXPECT_NEAR(y[1], std::sqrt(2.0), 1e-9);
+    EXPECT_EQ(jacobians, 1u);
+    EXPECT_GT(iterations, 1u);
+}
+
+TEST(NewtonSolverTests, ConvergedGuessNeedsNoIteration)
+{
+    NewtonSolver solver;
+    std::vector<double> y = {std::sqrt(2.0), std::sqrt(2.0)};
+    NewtonOptions options;
+    options.absolute_tolerance = 1e-12;
+
+    EXPECT_EQ(solver.Solve(options, y, Residual, [](const std::vector<double> &, CoordinateMatrix &)
+                           { FAIL() << "Jacobian of a converged guess"; }),
+              0u);
+}
+
+TEST(NewtonSolverTests, ThrowsWithoutConvergence)
+{
+    NewtonSolver solver;
+    NewtonOptions options;
+    options.max_iterations = 1;
+    std::vector<double> y = {1.0, 2.0};
+
+    EXPECT_THROW(solver.Solve(options, y, Residual, Jacobian), std::runtime_error);
+}
@@ -0,0 +1,92 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <output_writer.h>
+
+using namespace philote;
+
+namespace
+{
+    FlatVariables MakeOutputs()
+    {
+        FlatVariables outputs;
+        outputs.Add("a", kOutput, {2});
+        outputs.Add("b", kOutput, {1});
+        return outputs;
+    }
+}
+
+TEST(OutputWriterTests, FinalizeSendsOnce)
+{
+    FlatVariables outputs = MakeOutputs();
+    outputs.at("a")(0) = 1.0;
+    outputs.at("a")(1) = 2.0;
+
+    std::vector<std::string> sent;
+    std::vector<double> values;
+    OutputWriter writer(outputs, [&](const std::string &name, const Variable &value)
+                        {
+                            sent.push_back(name);
+                            values.push_back(value(1)); });
+
+    EXPECT_FALSE(writer.IsFinal("a"));
+    writer.Finalize("a");
+    writer.Finalize("a");
+
+    EXPECT_TRUE(writer.IsFinal("a"));
+    EXPECT_FALSE(writer.IsFinal("b"));
+    EXPECT_EQ(sent, std::vector<std::string>{"a"});
+    EXPECT_DOUBLE_EQ(values[0], 2.0);
+}
+
+TEST(OutputWriterTests, FinalizeUnknownOutput)
+{
+    FlatVariables outputs = MakeOutputs();
+    OutputWriter writer(outputs, [](const std::string &, const Variable &) {});
+
+    EXPECT_THROW(writer.Finalize("c"), std::out_of_range);
+    EXPECT_FALSE(writer.IsFinal("c"));
+}
+
+TEST(OutputWriterTests, FailedSendIsNotFinal)
+{
+    FlatVariables outputs = MakeOutputs();
+    OutputWriter writer(outputs, [](const std::string &, const Variable &)
+                        { throw std::runtime_error("stream closed"); });
+
+    EXPECT_THROW(writer.Finalize("b"), std::runtime_error);
+    EXPECT_FALSE(writer.IsFinal("b"));
+}
@@ -0,0 +1,233 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <parallel_assembly.h>
+
+using philote::Array;
+using philote::ParallelAssembly;
+using philote::Partials;
+using philote::PartialsSparsity;
+using philote::SerializeInOrder;
+using philote::SendPartialsInOrder;
+using philote::ThreadPool;
+using philote::Variable;
+using philote::WirePrecision;
+
+namespace
+{
+    Array Message(const std::string &name, int start, int end)
+    {
+        Array message;
+        message.set_name(name);
+        message.set_start(start);
+        message.set_end(end);
+        for (int i = start; i <= end; i++)
+            message.add_data(i);
+
+        return message;
+    }
+}
+
+TEST(ParallelAssemblyTests, AssignsInlineWithoutPool)
+{
+    ParallelAssembly assembly(nullptr);
+
+    int calls = 0;
+    Array message = Message("x", 0, 1);
+    grpc::Status status = assembly.Submit("x", message, [&calls](const Array &received)
+                                          {
+                                              calls++;
+                                              EXPECT_EQ(received.name(), "x");
+                                              return grpc::Status::OK; });
+
+    // the task ran before Submit returned and the message was left intact
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(message.name(), "x");
+}
+
+TEST(ParallelAssemblyTests, AssignsMessagesOfAVariableInOrder)
+{
+    ThreadPool pool(4);
+    std::vector<Variable> values(8, Variable(philote::kInput, {64}));
+    std::vector<std::vector<int>> order(values.size());
+
+    {
+        ParallelAssembly assembly(&pool);
+        Array message;
+        for (int chunk = 0; chunk < 16; chunk++)
+        {
+            for (size_t v = 0; v < values.size(); v++)
+            {
+                const std::string name = "v" + std::to_string(v);
+                message = Message(name, 4 * chunk, 4 * chunk + 3);
+                grpc::Status status = assembly.Submit(name, message, [&values, &order, v](const Array &received)
+                                                      {
+                                                          values[v].AssignChunk(received);
+                                                          order[v].push_back(static_cast<int>(received.start()));
+                                                          return grpc::Status::OK; });
+                ASSERT_TRUE(status.ok());
+
+                // the caller received a cleared message to read into
+                EXPECT_TRUE(message.name().empty());
+            }
+        }
+
+        EXPECT_TRUE(assembly.Finish().ok());
+    }
+
+    for (size_t v = 0; v < values.size(); v++)
+    {
+        ASSERT_EQ(order[v].size(), 16u);
+        for (int chunk = 0; chunk < 16; chunk++)
+            EXPECT_EQ(order[v][chunk], 4 * chunk);
+        for (size_t i = 0; i < 64; i++)
+            EXPECT_DOUBLE_EQ(values[v](i), static_cast<double>(i));
+    }
+}
+
+TEST(ParallelAssemblyTests, ReportsFirstError)
+{
+    ThreadPool pool(2);
+    ParallelAssembly assembly(&pool);
+
+    std::atomic<int> calls{0};
+    Array message = Message("x", 0, 0);
+    grpc::Status status = assembly.Submit("x", message, [&calls](const Array &)
+                                          {
+                                              calls++;
+                                              return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "bad chunk"); });
+    EXPECT_TRUE(status.ok());
+
+    status = assembly.Finish();
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_EQ(status.error_message(), "bad chunk");
+
+    // later messages are rejected
+    message = Message("x", 1, 1);
+    status = assembly.Submit("x", message, [&calls](const Array &)
+                             {
+                                 calls++;
+                                 return grpc::Status::OK; });
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::INVALID_ARGUMENT);
+    EXPECT_EQ(assembly.Finish().error_message(), "bad chunk");
+    EXPECT_EQ(calls.load(), 1);
+}
+
+TEST(ParallelAssemblyTests, SerializesInOrder)
+{
+    ThreadPool pool(3);
+    std::vector<size_t> written;
+
+    SerializeInOrder(pool, 20,
+        [](size_t i, std::vector<Array> &messages)
+        {
+            messages.push_back(Message(std::to_string(i), 0, static_cast<int>(i)));
+        },
+        [&written](size_t i, std::vector<Array> &messages)
+        {
+            ASSERT_EQ(messages.size(), 1u);
+            EXPECT_EQ(messages[0].name(), std::to_string(i));
+            written.push_back(i);
+        });
+
+    ASSERT_EQ(written.size(), 20u);
+    for (size_t i = 0; i < written.size(); i++)
+        EXPECT_EQ(written[i], i);
+}
+
+TEST(ParallelAssemblyTests, SerializeRethrowsErrors)
+{
+    ThreadPool pool(2);
+    size_t writes = 0;
+
+    EXPECT_THROW(SerializeInOrder(pool, 10,
+                     [](size_t i, std::vector<Array> &)
+                     {
+                         if (i == 3)
+                             throw std::runtime_error("serialization failed");
+                     },
+                     [&writes](size_t, std::vector<Array> &)
+                     { writes++; }),
+                 std::runtime_error);
+
+    // the partials before the failing one were written
+    EXPECT_EQ(writes, 3u);
+}
+
+TEST(ParallelAssemblyTests, SendsPartialsLikeVariableSend)
+{
+    ThreadPool pool(2);
+
+    Partials partials;
+    for (int p = 0; p < 5; p++)
+    {
+        Variable value(philote::kPartial, {7});
+        for (size_t i = 0; i < value.Size(); i++)
+            value(i) = p * 10.0 + static_cast<double>(i);
+        partials[{"f", "x" + std::to_string(p)}] = value;
+    }
+
+    std::vector<Array> expected;
+    for (const auto &par : partials)
+        par.second.Send(par.first.first, par.first.second, &expected, 3);
+
+    std::vector<Array> sent;
+    SendPartialsInOrder(pool, partials, nullptr, 3, WirePrecision::kDouble, nullptr,
+                        [&sent](const Array &message)
+                        {
+                            sent.push_back(message);
+                            return true;
+                        });
+
+    ASSERT_EQ(sent.size(), expected.size());
+    for (size_t i = 0; i < sent.size(); i++)
+        EXPECT_EQ(sent[i].SerializeAsString(), expected[i].SerializeAsString());
+
+    // a closed stream names the partial
+    try
+    {
+        SendPartialsInOrder(pool, partials, nullptr, 3, WirePrecision::kDouble, nullptr,
+                            [](const Array &)
+                            { return false; });
+        FAIL() << "expected an exception";
+    }
+    catch (const std::runtime_error &e)
+    {
+        EXPECT_NE(std::string(e.what()).find("f/x0"), std::string::npos);
+    }
+}
@@ -0,0 +1,266 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+
+#include "protocol_extensions.h"
+
+using namespace philote;
+
+// ============================================================================
+// Feature List Tests
+// ============================================================================
+
+TEST(ProtocolExtensionsTest, SupportedFeaturesRoundTrip) {
+    std::set<std::string> features = ParseFeatures(SupportedFeatures());
+    EXPECT_EQ(features.count(kFeatureBatch), 1u);
+    EXPECT_EQ(features.count(kFeatureSparsePartials), 1u);
+    EXPECT_EQ(features.count(kFeatureChunkNegotiation), 1u);
+    EXPECT_EQ(features.count(kFeatureFusedGradient), 1u);
+    EXPECT_EQ(features.count(kFeatureSharedMemory), 1u);
+    EXPECT_EQ(features.count(kFeatureWirePrecision), 1u);
+    EXPECT_EQ(features.count(kFeatureCompression), 1u);
+    EXPECT_EQ(features.count(kFeatureInputSessions), 1u);
+    EXPECT_EQ(features.count(kFeatureEvaluationStreams), 1u);
+    EXPECT_EQ(features.count(kFeatureDefinitionsHash), 1u);
+    EXPECT_EQ(features.count(kFeatureJacobianProducts), 1u);
+    EXPECT_EQ(features.count(kFeatureLinearSolves), 1u);
+    EXPECT_EQ(features.count(kFeatureDiscreteVariables), 1u);
+    EXPECT_EQ(features.count(kFeatureOptionsHotReload), 1u);
+    EXPECT_EQ(features.count(kFeatureAdmissionControl), 1u);
+}
+
+TEST(ProtocolExtensionsTest, ParseFeaturesHandlesWhitespaceAndEmptyEntries) {
+    std::set<std::string> features = ParseFeatures(" batch, ,other ,,");
+    EXPECT_EQ(features, (std::set<std::string>{"batch", "other"}));
+
+    EXPECT_TRUE(ParseFeatures("").empty());
+}
+
+// ============================================================================
+// Chunk Size Tests
+// ============================================================================
+
+TEST(ProtocolExtensionsTest, ChunkSizeForMessageBytes) {
+    // the chunk plus the reserve fits into the limit
+    size_t chunk = ChunkSizeForMessageBytes(kDefaultMaxMessageBytes);
+    EXPECT_GT(chunk, 500000u);
+    EXPECT_LT(chunk * sizeof(double), kDefaultMaxMessageBytes);
+
+    EXPECT_EQ(ChunkSizeForMessageBytes(1024), 64u);
+    EXPECT_EQ(ChunkSizeForMessageBytes(0), 1u);
+    EXPECT_EQ(ChunkSizeForMessageBytes(8), 1u);
+}
+
+// ============================================================================
+// Metadata Tests
+// ============================================================================
+
+TEST(ProtocolExtensionsTest, FindMetadata) {
+    std::string key = "philote-test", value = "value";
+    std::multimap<grpc::string_ref, grpc::string_ref> metadata;
+    metadata.emplace(grpc::string_ref(key), grpc::string_ref(value));
+
+    EXPECT_EQ(FindMetadata(metadata, "philote-test"), "value");
+    EXPECT_EQ(FindMetadata(metadata, "missing"), "");
+    EXPECT_EQ(FindClientMetadata(nullptr, "philote-test"), "");
+    EXPECT_EQ(RequestedWirePrecision(nullptr), WirePrecision::kDouble);
+}
+
+// ============================================================================
+// Index Parsing Tests
+// ============================================================================
+
+TEST(ProtocolExtensionsTest, ParseIndex) {
+    size_t value = 99;
+
+    EXPECT_TRUE(ParseIndex("0", 10, value));
+    EXPECT_EQ(value, 0u);
+    EXPECT_TRUE(ParseIndex("9", 10, value));
+    EXPECT_EQ(value, 9u);
+
+    EXPECT_FALSE(ParseIndex("10", 10, value));
+    EXPECT_FALSE(ParseIndex("", 10, value));
+    EXPECT_FALSE(ParseIndex("-1", 10, value));
+    EXPECT_FALSE(ParseIndex("1a", 10, value));
+    EXPECT_FALSE(ParseIndex("123456789012345678901234", static_cast<size_t>(-1), value));
+    EXPECT_EQ(value, 9u);
+}
+
+// ============================================================================
+// Sparsity Pattern Tests
+// ============================================================================
+
+TEST(ProtocolExtensionsTest, SparsityPatternRoundTrip) {
+    SparsityPattern pattern;
+    pattern.rows = {0, 0, 1, 2, 2};
+    pattern.cols = {1, 3, 0, 2, 3};
+    pattern.num_cols = 4;
+
+    std::vector<PartialsMetaData> messages = EncodeSparsityPattern("f", "x", pattern, 2);
+    ASSERT_EQ(messages.size(), 3u);
+
+    SparsityPattern decoded;
+    for (const PartialsMetaData &message : messages) {
+        EXPECT_EQ(message.name(), "f");
+        EXPECT_EQ(message.subname(), "x");
+        EXPECT_TRUE(IsSparsityPatternMessage(message));
+        DecodeSparsityPattern(message, decoded);
+    }
+
+    EXPECT_EQ(decoded.rows, pattern.rows);
+    EXPECT_EQ(decoded.cols, pattern.cols);
+    EXPECT_EQ(decoded.num_cols, 4);
+
+    // messages must be decoded in order
+    SparsityPattern out_of_order;
+    EXPECT_THROW(DecodeSparsityPattern(messages[1], out_of_order), std::invalid_argument);
+}
+
+TEST(ProtocolExtensionsTest, EmptySparsityPattern) {
+    SparsityPattern pattern;
+    pattern.num_cols = 3;
+
+    std::vector<PartialsMetaData> messages = EncodeSparsityPattern("f", "x", pattern, 10);
+    ASSERT_EQ(messages.size(), 1u);
+
+    SparsityPattern decoded;
+    DecodeSparsityPattern(messages[0], decoded);
+    EXPECT_EQ(decoded.nnz(), 0u);
+
+    EXPECT_THROW(EncodeSparsityPattern("f", "x", pattern, 0), std::invalid_argument);
+}
+
+TEST(ProtocolExtensionsTest, MalformedSparsityPattern) {
+    PartialsMetaData regular;
+    regular.add_shape(2);
+    regular.add_shape(3);
+    EXPECT_FALSE(IsSparsityPatternMessage(regular));
+
+    SparsityPattern pattern;
+    EXPECT_THROW(DecodeSparsityPattern(regular, pattern), std::invalid_argument);
+
+    // odd number of indices
+    PartialsMetaData odd;
+    for (int64_t value : {kSparsePatternMarker, int64_t(3), int64_t(0), int64_t(1)})
+        odd.add_shape(value);
+    EXPECT_TRUE(IsSparsityPatternMessage(odd));
+    EXPECT_THROW(DecodeSparsityPattern(odd, pattern), std::invalid_argument);
+}
+
+// ============================================================================
+// Packed Variable Tests
+// ============================================================================
+
+TEST(ProtocolExtensionsTest, PackedVariablesRoundTrip) {
+    Variable x(kInput, {1}), y(kInput, {3}), big(kInput, {4});
+    x(0) = 1.0;
+    for (size_t i = 0; i < 3; i++)
+        y(i) = 2.0 + i;
+
+    ArrayPacker packer(kInput, 4);
+    EXPECT_TRUE(packer.Add("x", x));
+    EXPECT_TRUE(packer.Add("y", y));
+    EXPECT_FALSE(packer.Add("big", big));
+
+    const std::vector<Array> &messages = packer.Finish();
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_TRUE(IsPackedArray(messages[0]));
+    EXPECT_EQ(messages[0].type(), kInput);
+    EXPECT_EQ(messages[0].data_size(), 4);
+
+    std::vector<PackedEntry> entries = DecodePackedIndex(messages[0]);
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].name, "x");
+    EXPECT_EQ(entries[0].offset, 0u);
+    EXPECT_EQ(entries[0].size, 1u);
+    EXPECT_EQ(entries[1].name, "y");
+    EXPECT_EQ(entries[1].offset, 1u);
+    EXPECT_EQ(entries[1].size, 3u);
+
+    Variable x2(kInput, {1}), y2(kInput, {3});
+    AssignPackedEntry(messages[0], entries[0], x2);
+    AssignPackedEntry(messages[0], entries[1], y2);
+    EXPECT_DOUBLE_EQ(x2(0), 1.0);
+    for (size_t i = 0; i < 3; i++)
+        EXPECT_DOUBLE_EQ(y2(i), 2.0 + i);
+
+    // sizes must match
+    EXPECT_THROW(AssignPackedEntry(messages[0], entries[1], x2), std::length_error);
+    EXPECT_THROW(ArrayPacker(kInput, 0), std::invalid_argument);
+}
+
+TEST(ProtocolExtensionsTest, DiscreteMarkers) {
+    VariableMetaData meta;
+    meta.set_name("mask");
+    meta.set_type(kInput);
+    meta.add_shape(4);
+    EXPECT_FALSE(IsDiscreteMarker(meta));
+
+    VariableMetaData marker = DiscreteMarker(meta);
+    EXPECT_TRUE(IsDiscreteMarker(marker));
+    EXPECT_EQ(marker.name(), "mask");
+    EXPECT_EQ(marker.type(), kInput);
+
+    // integer-encoded variables are never packed
+    ArrayPacker packer(kInput, 8);
+    EXPECT_FALSE(packer.Add("mask", Variable(kInput, {4}, kDiscrete)));
+    EXPECT_TRUE(packer.Finish().empty());
+
+    // without client metadata, discrete variables use the regular precision
+    EXPECT_EQ(RequestedWirePrecision(nullptr, true), WirePrecision::kDouble);
+}
+
+TEST(ProtocolExtensionsTest, PackedVariablesSplitAtChunkSize) {
+    // names containing the separator survive the length prefix
+    Variable a(kOutput, {2}), b(kOutput, {2}), c(kOutput, {1});
+
+    ArrayPacker packer(kOutput, 3);
+    EXPECT_TRUE(packer.Add("a,1", a));
+    EXPECT_TRUE(packer.Add("b", b));
+    EXPECT_TRUE(packer.Add("c", c));
+
+    const std::vector<Array> &messages = packer.Finish();
+    ASSERT_EQ(messages.size(), 2u);
+
+    std::vector<PackedEntry> first = DecodePackedIndex(messages[0]);
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0].name, "a,1");
+
+    std::vector<PackedEntry> second = DecodePackedIndex(messages[1]);
+    ASSERT_EQ(second.size(), 2u);
+    EXPECT_EQ(second[0].size, 2u);
+    EXPECT_EQ(second[1].size, 1u);
+}
+
+TEST(ProtocolExtensionsTest, MalformedPackedIndex) {
+    Array array;
+    array.add_data(1.0);
+
+    array.set_subname("0,5,x");
+    EXPECT_THROW(DecodePackedIndex(array), std::invalid_argument);
+
+    array.set_subname("2,1,x");
+    EXPECT_THROW(DecodePackedIndex(array), std::invalid_argument);
+
+    array.set_subname("1,1,x0,1,y");
+    EXPECT_THROW(DecodePackedIndex(array), std::invalid_argument);
+
+    array.set_subname("a,1,x");
+    EXPECT_THROW(DecodePackedIndex(array), std::invalid_argument);
+}
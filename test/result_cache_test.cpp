@@ -0,0 +1,173 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <gtest/gtest.h>
+
+#include <result_cache.h>
+
+using philote::Partials;
+using philote::ResultCache;
+using philote::ResultCacheStats;
+using philote::Variable;
+using philote::Variables;
+
+namespace
+{
+    Variables MakeInputs(double x, size_t n = 1)
+    {
+        Variables vars;
+        vars["x"] = Variable(philote::kInput, {n});
+        for (size_t i = 0; i < n; i++)
+            vars["x"](i) = x;
+
+        return vars;
+    }
+}
+
+TEST(ResultCacheTests, DisabledByDefault)
+{
+    ResultCache<Variables> cache;
+    EXPECT_FALSE(cache.enabled());
+
+    Variables inputs = MakeInputs(1.0);
+    cache.Insert(inputs, 0, MakeInputs(2.0));
+
+    Variables result;
+    EXPECT_FALSE(cache.Find(inputs, 0, result));
+
+    ResultCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 0u);
+    EXPECT_EQ(stats.entries, 0u);
+}
+
+TEST(ResultCacheTests, HitReturnsStoredResult)
+{
+    ResultCache<Variables> cache(1 << 20);
+
+    Variables result;
+    EXPECT_FALSE(cache.Find(MakeInputs(1.0), 0, result));
+
+    cache.Insert(MakeInputs(1.0), 0, MakeInputs(5.0));
+    ASSERT_TRUE(cache.Find(MakeInputs(1.0), 0, result));
+    EXPECT_DOUBLE_EQ(result.at("x")(0), 5.0);
+
+    // different values miss
+    EXPECT_FALSE(cache.Find(MakeInputs(1.5), 0, result));
+
+    ResultCacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.entries, 1u);
+    EXPECT_EQ(stats.bytes, 2 * sizeof(double));
+}
+
+TEST(ResultCacheTests, GenerationMismatchMisses)
+{
+    ResultCache<Variables> cache(1 << 20);
+    cache.Insert(MakeInputs(1.0), 3, MakeInputs(5.0));
+
+    Variables result;
+    EXPECT_FALSE(cache.Find(MakeInputs(1.0), 4, result));
+    EXPECT_TRUE(cache.Find(MakeInputs(1.0), 3, result));
+}
+
+TEST(ResultCacheTests, EvictsLeastRecentlyUsed)
+{
+    // room for exactly two entries of two doubles each
+    ResultCache<Variables> cache(4 * sizeof(double));
+    cache.Insert(MakeInputs(1.0), 0, MakeInputs(10.0));
+    cache.Insert(MakeInputs(2.0), 0, MakeInputs(20.0));
+
+    // touch the first entry, so that the second is evicted next
+    Variables result;
+    ASSERT_TRUE(cache.Find(MakeInputs(1.0), 0, result));
+
+    cache.Insert(MakeInputs(3.0), 0, MakeInputs(30.0));
+
+    EXPECT_TRUE(cache.Find(MakeInputs(1.0), 0, result));
+    EXPECT_FALSE(cache.Find(MakeInputs(2.0), 0, result));
+    EXPECT_TRUE(cache.Find(MakeInputs(3.0), 0, result));
+    EXPECT_EQ(cache.stats().entries, 2u);
+    EXPECT_LE(cache.stats().bytes, 4 * sizeof(double));
+}
+
+TEST(ResultCacheTests, OversizedResultsAreNotStored)
+{
+    ResultCache<Variables> cache(4 * sizeof(double));
+    cache.Insert(MakeInputs(1.0, 4), 0, MakeInputs(2.0, 4));
+
+    Variables result;
+    EXPECT_FALSE(cache.Find(MakeInputs(1.0, 4), 0, result));
+    EXPECT_EQ(cache.stats().entries, 0u);
+}
+
+TEST(ResultCacheTests, ShrinkingTheCapEvicts)
+{
+    ResultCache<Variables> cache(1 << 20);
+    cache.Insert(MakeInputs(1.0), 0, MakeInputs(10.0));
+    cache.Insert(MakeInputs(2.0), 0, MakeInputs(20.0));
+
+    cache.SetMaxBytes(2 * sizeof(double));
+    EXPECT_EQ(cache.stats().entries, 1u);
+
+    cache.SetMaxBytes(0);
+    EXPECT_FALSE(cache.enabled());
+    EXPECT_EQ(cache.stats().entries, 0u);
+}
+
+TEST(ResultCacheTests, CachesPartials)
+{
+    ResultCache<Partials> cache(1 << 20);
+
+    Partials partials;
+    partials[std::make_pair("f", "x")] = Variable(philote::kOutput, {1});
+    partials[std::make_pair("f", "x")](0) = 7.0;
+    cache.Insert(MakeInputs(1.0), 0, partials);
+
+    Partials result;
+    ASSERT_TRUE(cache.Find(MakeInputs(1.0), 0, result));
+    EXPECT_DOUBLE_EQ(result[std::make_pair("f", "x")](0), 7.0);
+}
+
+TEST(ResultCacheTests, HashDependsOnNamesShapesAndValues)
+{
+    const uint64_t base = philote::HashVariables(MakeInputs(1.0));
+    EXPECT_EQ(base, philote::HashVariables(MakeInputs(1.0)));
+    EXPECT_NE(base, philote::HashVariables(MakeInputs(1.0 + 1e-15)));
+    EXPECT_NE(base, philote::HashVariables(MakeInputs(1.0, 2)));
+    EXPECT_NE(base, philote::HashVariables(MakeInputs(1.0), 1));
+
+    Variables renamed;
+    renamed["y"] = MakeInputs(1.0).at("x");
+    EXPECT_NE(base, philote::HashVariables(renamed));
+    EXPECT_FALSE(philote::IdenticalVariables(renamed, MakeInputs(1.0)));
+    EXPECT_TRUE(philote::IdenticalVariables(MakeInputs(1.0), MakeInputs(1.0)));
+}
@@ -0,0 +1,207 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <shared_memory.h>
+
+using namespace philote;
+
+namespace
+{
+    //! Stream stand-in collecting the written messages
+    struct MessageList
+    {
+        bool Write(Array &&message)
+        {
+            messages.push_back(std::move(message));
+            return true;
+        }
+
+        std::vector<Array> messages;
+    };
+
+    Variable MakeVariable(const std::vector<double> &values)
+    {
+        Variable var(kInput, {values.size()});
+        for (size_t i = 0; i < values.size(); i++)
+            var(i) = values[i];
+        return var;
+    }
+}
+
+TEST(SharedMemoryTests, OpenMapsCreatedSegment)
+{
+    auto created = SharedMemorySegment::Create(8);
+    ASSERT_GE(created->size(), 8u);
+    for (size_t i = 0; i < 8; i++)
+        created->data()[i] = static_cast<double>(i) + 0.5;
+
+    auto opened = SharedMemorySegment::Open(created->name());
+    EXPECT_EQ(opened->size(), created->size());
+    EXPECT_NE(opened->data(), created->data());
+    for (size_t i = 0; i < 8; i++)
+        EXPECT_DOUBLE_EQ(opened->data()[i], static_cast<double>(i) + 0.5);
+
+    // both mappings view the same memory
+    opened->data()[3] = -1.0;
+    EXPECT_DOUBLE_EQ(created->data()[3], -1.0);
+}
+
+TEST(SharedMemoryTests, SegmentIsUnlinkedByCreator)
+{
+    std::string name;
+    {
+        auto created = SharedMemorySegment::Create(1);
+        name = created->name();
+    }
+
+    EXPECT_THROW(SharedMemorySegment::Open(name), std::runtime_error);
+}
+
+TEST(SharedMemoryTests, OpenRejectsForeignNames)
+{
+    EXPECT_THROW(SharedMemorySegment::Open(""), std::invalid_argument);
+    EXPECT_THROW(SharedMemorySegment::Open("/other-segment"), std::invalid_argument);
+    EXPECT_THROW(SharedMemorySegment::Open("/philote-../etc"), std::invalid_argument);
+}
+
+TEST(SharedMemoryTests, TransferRoundTrip)
+{
+    auto client_segment = SharedMemorySegment::Create(5);
+    SharedMemoryTransfer client(client_segment);
+    SharedMemoryTransfer server(SharedMemorySegment::Open(client_segment->name()));
+
+    // client -> server
+    MessageList inputs;
+    client.Send("x", "", MakeVariable({1.0, 2.0, 3.0}), &inputs);
+    ASSERT_EQ(inputs.messages.size(), 1u);
+    EXPECT_EQ(inputs.messages[0].name(), "x");
+    EXPECT_EQ(inputs.messages[0].start(), 0);
+    EXPECT_EQ(inputs.messages[0].end(), 2);
+    EXPECT_EQ(inputs.messages[0].data_size(), 0);
+
+    Variable x(kInput, {3});
+    EXPECT_EQ(server.Assign(inputs.messages[0], x), 3u);
+    EXPECT_DOUBLE_EQ(x(2), 3.0);
+
+    // server -> client, after the inputs
+    MessageList results;
+    server.Send("f", "x", MakeVariable({4.0, 5.0}), &results);
+    EXPECT_EQ(server.offset(), 5u);
+
+    Variable f(kOutput, {2});
+    client.Assign(results.messages[0], f);
+    EXPECT_EQ(results.messages[0].subname(), "x");
+    EXPECT_DOUBLE_EQ(f(0), 4.0);
+    EXPECT_DOUBLE_EQ(f(1), 5.0);
+}
+
+TEST(SharedMemoryTests, TransferRejectsOverflow)
+{
+    auto segment = SharedMemorySegment::Create(2);
+    SharedMemoryTransfer transfer(segment);
+    MessageList messages;
+
+    const size_t size = segment->size();
+    EXPECT_THROW(transfer.Send("x", "", MakeVariable(std::vector<double>(size + 1, 1.0)), &messages),
+                 std::length_error);
+
+    Array message;
+    message.set_start(0);
+    message.set_end(static_cast<int64_t>(size));
+    Variable var(kInput, {size + 1});
+    EXPECT_THROW(transfer.Assign(message, var), std::length_error);
+}
+
+TEST(SharedMemoryTests, TransferWithoutSegmentUsesMessageData)
+{
+    SharedMemoryTransfer transfer;
+    EXPECT_FALSE(transfer);
+
+    Variable var(kInput, {2});
+    Array message = MakeVariable({7.0, 8.0}).CreateChunk(0, 1);
+    EXPECT_EQ(transfer.Assign(message, var), 2u);
+    EXPECT_DOUBLE_EQ(var(1), 8.0);
+}
+
+TEST(SharedMemoryTests, CacheReusesMappings)
+{
+    auto segment = SharedMemorySegment::Create(1);
+    SharedMemoryCache cache(1);
+
+    auto first = cache.Open(segment->name());
+    EXPECT_EQ(cache.Open(segment->name()), first);
+
+    // evicted once another segment is opened
+    auto other = SharedMemorySegment::Create(1);
+    cache.Open(other->name());
+    EXPECT_NE(cache.Open(segment->name()), first);
+}
+
+TEST(SharedMemoryTests, CacheRemapsReplacedSegments)
+{
+    auto segment = SharedMemorySegment::Create(1);
+    const std::string name = segment->name();
+    SharedMemoryCache cache;
+
+    auto first = cache.Open(name);
+    EXPECT_TRUE(first->IsCurrent());
+
+    // another process unlinks the segment and creates one with the same name
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(ftruncate(fd, sizeof(double)), 0);
+    close(fd);
+    EXPECT_FALSE(first->IsCurrent());
+
+    auto second = cache.Open(name);
+    EXPECT_NE(second, first);
+    EXPECT_TRUE(second->IsCurrent());
+
+    segment->data()[0] = 1.0;
+    EXPECT_EQ(second->data()[0], 0.0);
+}
+
+TEST(SharedMemoryTests, HostIdIsStable)
+{
+    EXPECT_FALSE(SharedMemoryHostId().empty());
+    EXPECT_EQ(SharedMemoryHostId(), SharedMemoryHostId());
+}
@@ -510,7 +510,8 @@ ImplicitTestServerManager::~ImplicitTestServerManager() {
     }
 }
 
-std::string ImplicitTestServerManager::StartServer(std::shared_ptr<ImplicitDiscipline> discipline) {
+std::string ImplicitTestServerManager::StartServer(std::shared_ptr<ImplicitDiscipline> discipline,
+                                                   ServerEngine engine) {
     if (running_) {
         throw std::runtime_error("Server is already running");
     }
@@ -530,7 +531,7 @@ std::string ImplicitTestServerManager::StartServer(std::shared_ptr<ImplicitDisci
     // Build and start server
     grpc::ServerBuilder builder;
     builder.AddListeningPort(address_, grpc::InsecureServerCredentials());
-    discipline_->RegisterServices(builder);
+    discipline_->RegisterServices(builder, engine);
 
     server_ = builder.BuildAndStart();
     if (!server_) {
@@ -660,7 +661,8 @@ TestServerManager::~TestServerManager() {
     }
 }
 
-std::string TestServerManager::StartServer(std::shared_ptr<ExplicitDiscipline> discipline) {
+std::string TestServerManager::StartServer(std::shared_ptr<ExplicitDiscipline> discipline,
+                                           ServerEngine engine) {
     if (running_) {
         throw std::runtime_error("Server is already running");
     }
@@ -680,7 +682,7 @@ std::string TestServerManager::StartServer(std::shared_ptr<ExplicitDiscipline> d
     // Build and start server
     grpc::ServerBuilder builder;
     builder.AddListeningPort(address_, grpc::InsecureServerCredentials());
-    discipline_->RegisterServices(builder);
+    discipline_->RegisterServices(builder, engine);
 
     server_ = builder.BuildAndStart();
     if (!server_) {
@@ -705,6 +707,72 @@ void TestServerManager::StopServer() {
     discipline_ = nullptr;
 }
 
+// ============================================================================
+// Tracing Helpers
+// ============================================================================
+
+namespace {
+
+class RecordingSpan : public Span {
+public:
+    explicit RecordingSpan(std::shared_ptr<RecordedSpan> record) : record_(std::move(record)) {}
+
+    TraceContext context() const override { return record_->context; }
+
+    void End(const grpc::Status &status, std::chrono::system_clock::time_point end) override {
+        record_->end = end;
+        record_->status = status.error_code();
+        record_->ended = true;
+    }
+
+private:
+    std::shared_ptr<RecordedSpan> record_;
+};
+
+std::string HexId(uint64_t value, size_t digits) {
+    std::string id(digits, '0');
+    for (size_t i = 0; i < digits && value > 0; i++, value >>= 4)
+        id[digits - 1 - i] = "0123456789abcdef"[value & 0xf];
+    return id;
+}
+
+} // namespace
+
+std::unique_ptr<Span> RecordingTracer::StartSpan(const std::string &name, SpanKind kind,
+                                                 const TraceContext &parent,
+                                                 std::chrono::system_clock::time_point start) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t id = next_id_++;
+
+    auto record = std::make_shared<RecordedSpan>();
+    record->name = name;
+    record->kind = kind;
+    record->parent = parent;
+    record->context.trace_id = parent.valid() ? parent.trace_id : HexId(id, 32);
+    record->context.span_id = HexId(id, 16);
+    record->start = start;
+    spans_.push_back(record);
+
+    return std::make_unique<RecordingSpan>(record);
+}
+
+std::vector<RecordedSpan> RecordingTracer::spans() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<RecordedSpan> spans;
+    for (const auto &span : spans_)
+        spans.push_back(*span);
+    return spans;
+}
+
+RecordedSpan RecordingTracer::Find(const std::string &name) const {
+    for (const RecordedSpan &span : spans()) {
+        if (span.name == name)
+            return span;
+    }
+    ADD_FAILURE() << "No span named " << name;
+    return RecordedSpan();
+}
+
 std::shared_ptr<grpc::Channel> CreateTestChannel(const std::string &address) {
     return grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
 }
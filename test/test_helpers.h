@@ -2,13 +2,16 @@
 #define PHILOTE_TEST_HELPERS_H
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <grpcpp/grpcpp.h>
 
 #include "explicit.h"
 #include "implicit.h"
+#include "tracing.h"
 #include "variable.h"
 
 namespace philote {
@@ -215,9 +218,11 @@ public:
 
     /**
      * Start server with given discipline on a random available port
+     * (using the given engine for the compute RPCs)
      * Returns the server address (e.g., "localhost:12345")
      */
-    std::string StartServer(std::shared_ptr<ImplicitDiscipline> discipline);
+    std::string StartServer(std::shared_ptr<ImplicitDiscipline> discipline,
+                            ServerEngine engine = ServerEngine::kSynchronous);
 
     /**
      * Stop the server and clean up
@@ -309,9 +314,11 @@ public:
 
     /**
      * Start server with given discipline on a random available port
+     * (using the given engine for the compute RPCs)
      * Returns the server address (e.g., "localhost:12345")
      */
-    std::string StartServer(std::shared_ptr<ExplicitDiscipline> discipline);
+    std::string StartServer(std::shared_ptr<ExplicitDiscipline> discipline,
+                            ServerEngine engine = ServerEngine::kSynchronous);
 
     /**
      * Stop the server and clean up
@@ -335,6 +342,49 @@ private:
     std::shared_ptr<ExplicitDiscipline> discipline_;
 };
 
+// ============================================================================
+// Tracing Helpers
+// ============================================================================
+
+/**
+ * Span recorded by a RecordingTracer
+ */
+struct RecordedSpan {
+    std::string name;
+    SpanKind kind = SpanKind::kInternal;
+    TraceContext parent;
+    TraceContext context;
+    std::chrono::system_clock::time_point start;
+    std::chrono::system_clock::time_point end;
+    grpc::StatusCode status = grpc::StatusCode::OK;
+    bool ended = false;
+};
+
+/**
+ * Tracer that keeps all spans in memory (thread-safe)
+ */
+class RecordingTracer : public Tracer {
+public:
+    std::unique_ptr<Span> StartSpan(const std::string &name, SpanKind kind,
+                                    const TraceContext &parent,
+                                    std::chrono::system_clock::time_point start) override;
+
+    /**
+     * Returns copies of the recorded spans in start order
+     */
+    std::vector<RecordedSpan> spans() const;
+
+    /**
+     * Returns the first span with the given name (fails the test if missing)
+     */
+    RecordedSpan Find(const std::string &name) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<RecordedSpan>> spans_;
+    uint64_t next_id_ = 1;
+};
+
 /**
  * Create a gRPC channel to the given address with appropriate options
  */
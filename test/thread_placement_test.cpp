@@ -0,0 +1,87 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "thread_placement.h"
+
+using namespace philote;
+
+TEST(ThreadPlacementTest, ParsesCpuLists) {
+    EXPECT_EQ(ParseCpuList("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(ParseCpuList("5"), (std::vector<int>{5}));
+    EXPECT_TRUE(ParseCpuList("").empty());
+
+    EXPECT_THROW(ParseCpuList("3-1"), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("a"), std::invalid_argument);
+    EXPECT_THROW(ParseCpuList("1-2x"), std::invalid_argument);
+}
+
+TEST(ThreadPlacementTest, NoPlacementHasNoSlots) {
+    EXPECT_TRUE(PlacementSlots(ThreadPlacement()).empty());
+}
+
+TEST(ThreadPlacementTest, CoresAreSeparateSlots) {
+    ThreadPlacement placement;
+    placement.policy = PlacementPolicy::kCores;
+    placement.cpus = {0, 2};
+
+    EXPECT_EQ(PlacementSlots(placement), (std::vector<std::vector<int>>{{0}, {2}}));
+
+    // by default, instances are placed on the CPUs of the process
+    placement.cpus.clear();
+    EXPECT_EQ(PlacementSlots(placement).size(), AvailableCpus().size());
+}
+
+TEST(ThreadPlacementTest, NumaNodesCoverTheCpus) {
+    const std::vector<int> cpus = AvailableCpus();
+    ASSERT_FALSE(cpus.empty());
+
+    ThreadPlacement placement;
+    placement.policy = PlacementPolicy::kNumaNodes;
+    const auto nodes = PlacementSlots(placement);
+    ASSERT_FALSE(nodes.empty());
+
+    std::vector<int> covered;
+    for (const auto &node : nodes)
+        covered.insert(covered.end(), node.begin(), node.end());
+    std::sort(covered.begin(), covered.end());
+    EXPECT_EQ(covered, cpus);
+}
+
+TEST(ThreadPlacementTest, AffinityScopePinsAndRestores) {
+    const std::vector<int> cpus = AvailableCpus();
+    ASSERT_FALSE(cpus.empty());
+
+    {
+        AffinityScope scope({cpus.back()});
+        EXPECT_TRUE(scope.pinned());
+        EXPECT_EQ(AvailableCpus(), (std::vector<int>{cpus.back()}));
+    }
+
+    EXPECT_EQ(AvailableCpus(), cpus);
+}
+
+TEST(ThreadPlacementTest, EmptyAffinityScopeKeepsTheThread) {
+    const std::vector<int> cpus = AvailableCpus();
+    AffinityScope scope({});
+    EXPECT_FALSE(scope.pinned());
+    EXPECT_EQ(AvailableCpus(), cpus);
+}
@@ -0,0 +1,105 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <thread_pool.h>
+
+using philote::ThreadPool;
+
+TEST(ThreadPoolTests, DefaultSize)
+{
+    ThreadPool pool;
+    EXPECT_GE(pool.size(), 1u);
+}
+
+TEST(ThreadPoolTests, ExecutesAllTasks)
+{
+    std::atomic<int> count{0};
+    {
+        ThreadPool pool(4);
+        EXPECT_EQ(pool.size(), 4u);
+
+        for (int i = 0; i < 100; i++)
+            pool.Submit([&count]
+                        { count++; });
+    }
+
+    // destruction finishes the queued tasks
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPoolTests, RunsTasksConcurrently)
+{
+    ThreadPool pool(2);
+
+    std::promise<void> first_started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    pool.Submit([&first_started, released]
+                {
+                    first_started.set_value();
+                    released.wait(); });
+    first_started.get_future().wait();
+
+    // the second worker is still available
+    std::promise<void> second;
+    pool.Submit([&second]
+                { second.set_value(); });
+    EXPECT_EQ(second.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+    release.set_value();
+}
+
+TEST(ThreadPoolTests, ExceptionsDoNotStopWorkers)
+{
+    ThreadPool pool(1);
+
+    pool.Submit([]
+                { throw std::runtime_error("task failed"); });
+
+    std::promise<void> done;
+    pool.Submit([&done]
+                { done.set_value(); });
+    EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+}
+
+TEST(ThreadPoolTests, RejectsEmptyTask)
+{
+    ThreadPool pool(1);
+    EXPECT_THROW(pool.Submit(nullptr), std::invalid_argument);
+}
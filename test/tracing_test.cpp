@@ -0,0 +1,170 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <grpcpp/grpcpp.h>
+#include <grpcpp/test/server_context_test_spouse.h>
+
+#include <callback_server.h>
+#include <tracing.h>
+
+#include "test_helpers.h"
+
+using namespace philote;
+using philote::test::RecordedSpan;
+using philote::test::RecordingTracer;
+
+namespace
+{
+    const char kTraceId[] = "4bf92f3577b34da6a3ce929d0e0e4736";
+    const char kSpanId[] = "00f067aa0ba902b7";
+    const char kHeader[] = "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01";
+}
+
+TEST(TracingTests, TraceparentRoundTrip)
+{
+    TraceContext context;
+    ASSERT_TRUE(ParseTraceparent(kHeader, context));
+
+    EXPECT_EQ(context.trace_id, kTraceId);
+    EXPECT_EQ(context.span_id, kSpanId);
+    EXPECT_TRUE(context.sampled);
+    EXPECT_EQ(FormatTraceparent(context), kHeader);
+
+    context.sampled = false;
+    EXPECT_EQ(FormatTraceparent(context), "00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00");
+}
+
+TEST(TracingTests, TraceparentRejectsInvalidHeaders)
+{
+    TraceContext context;
+    context.trace_id = "unchanged";
+
+    EXPECT_FALSE(ParseTraceparent("", context));
+    EXPECT_FALSE(ParseTraceparent("01-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01", context));
+    EXPECT_FALSE(ParseTraceparent("00-00000000000000000000000000000000-00f067aa0ba902b7-01", context));
+    EXPECT_FALSE(ParseTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-0000000000000000-01", context));
+    EXPECT_FALSE(ParseTraceparent("00-4BF92F3577B34DA6A3CE929D0E0E4736-00f067aa0ba902b7-01", context));
+    EXPECT_FALSE(ParseTraceparent("00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-zz", context));
+    EXPECT_EQ(context.trace_id, "unchanged");
+}
+
+TEST(TracingTests, ClientCallSpanEndsWithStatus)
+{
+    RecordingTracer tracer;
+    TraceContext parent;
+    ASSERT_TRUE(ParseTraceparent(kHeader, parent));
+
+    {
+        grpc::ClientContext context;
+        ClientCallSpan span(&tracer, parent, "ComputeFunction", context);
+        span.Finish(grpc::Status(grpc::StatusCode::UNAVAILABLE, "down"));
+    }
+    {
+        grpc::ClientContext context;
+        ClientCallSpan span(&tracer, parent, "ComputeGradient", context);
+        // abandoned, e.g., by an exception
+    }
+
+    RecordedSpan function = tracer.Find("ComputeFunction");
+    EXPECT_EQ(function.kind, SpanKind::kClient);
+    EXPECT_EQ(function.parent.span_id, kSpanId);
+    EXPECT_EQ(function.context.trace_id, kTraceId);
+    EXPECT_TRUE(function.ended);
+    EXPECT_EQ(function.status, grpc::StatusCode::UNAVAILABLE);
+
+    RecordedSpan gradient = tracer.Find("ComputeGradient");
+    EXPECT_TRUE(gradient.ended);
+    EXPECT_EQ(gradient.status, grpc::StatusCode::ABORTED);
+}
+
+TEST(TracingTests, ObserveCallRecordsServerAndPhaseSpans)
+{
+    RecordingTracer tracer;
+    grpc::ServerContext context;
+    grpc::testing::ServerContextTestSpouse spouse(&context);
+    spouse.AddClientMetadata(kTraceparentMetadataKey, kHeader);
+
+    BufferedArrayStream buffer;
+    Array input;
+    input.set_name("x");
+    input.add_data(1.0);
+    buffer.Push(input);
+
+    grpc::Status status = ObserveCall(nullptr, &tracer, &context, "ComputeFunction", &buffer,
+                                      [](auto *stream)
+                                      {
+                                          Array message;
+                                          while (stream->Read(&message))
+                                              ;
+                                          stream->Write(message);
+                                          return grpc::Status::OK;
+                                      });
+    ASSERT_TRUE(status.ok());
+
+    ASSERT_EQ(tracer.spans().size(), 4u);
+
+    RecordedSpan server = tracer.Find("ComputeFunction");
+    EXPECT_EQ(server.kind, SpanKind::kServer);
+    EXPECT_EQ(server.parent.span_id, kSpanId);
+    EXPECT_EQ(server.context.trace_id, kTraceId);
+    EXPECT_TRUE(server.ended);
+    EXPECT_EQ(server.status, grpc::StatusCode::OK);
+
+    auto previous_end = server.start;
+    for (const char *phase : {"ComputeFunction/receive", "ComputeFunction/compute", "ComputeFunction/send"})
+    {
+        RecordedSpan child = tracer.Find(phase);
+        EXPECT_EQ(child.kind, SpanKind::kInternal);
+        EXPECT_EQ(child.parent.span_id, server.context.span_id);
+        EXPECT_EQ(child.start, previous_end);
+        EXPECT_LE(child.end, server.end);
+        previous_end = child.end;
+    }
+    EXPECT_EQ(previous_end, server.end);
+}
+
+TEST(TracingTests, ObserveCallStartsTraceWithoutParent)
+{
+    RecordingTracer tracer;
+    grpc::ServerContext context;
+    BufferedArrayStream buffer;
+
+    ObserveCall(nullptr, &tracer, &context, "ComputeGradient", &buffer,
+                [](auto *) { return grpc::Status(grpc::StatusCode::INTERNAL, "failed"); });
+
+    RecordedSpan server = tracer.Find("ComputeGradient");
+    EXPECT_FALSE(server.parent.valid());
+    EXPECT_TRUE(server.context.valid());
+    EXPECT_EQ(server.status, grpc::StatusCode::INTERNAL);
+}
@@ -28,7 +28,9 @@
 	therein. The DoD does not exercise any editorial, security, or other
 	control over the information you may find at these locations.
 */
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -565,4 +567,480 @@ TEST(VariableTests, SendSuccessWithMultipleChunks)
     EXPECT_NO_THROW({
         var.Send("test_var", "", &succeeding_stream, 5); // 2 chunks, both succeed
     });
-}
\ No newline at end of file
+}
+// Mock ClientReaderWriterInterface that records every written message
+template <typename W, typename R>
+class RecordingClientReaderWriter : public grpc::ClientReaderWriterInterface<W, R>
+{
+public:
+    std::vector<W> written;
+
+    bool Write(const W &msg, grpc::WriteOptions options) override
+    {
+        written.push_back(msg);
+        return true;
+    }
+
+    bool Read(R *msg) override { return false; }
+    bool WritesDone() override { return true; }
+    grpc::Status Finish() override { return grpc::Status::OK; }
+    void WaitForInitialMetadata() override {}
+    bool NextMessageSize(uint32_t *sz) override { return false; }
+};
+
+/*
+	Test that Variable::Send() transmits the trailing elements when the size
+	is not a multiple of the chunk size
+*/
+TEST(VariableTests, SendPartialLastChunk)
+{
+    Variable var(kOutput, {25});
+    for (size_t i = 0; i < var.Size(); i++)
+        var(i) = static_cast<double>(i);
+
+    RecordingClientReaderWriter<philote::Array, philote::Array> stream;
+    var.Send("f", "x", &stream, 10);
+
+    ASSERT_EQ(stream.written.size(), 3u);
+    EXPECT_EQ(stream.written[2].start(), 20);
+    EXPECT_EQ(stream.written[2].end(), 24);
+    EXPECT_EQ(stream.written[2].data_size(), 5);
+
+    // every chunk carries the name, subname and type
+    for (const auto &chunk : stream.written)
+    {
+        EXPECT_EQ(chunk.name(), "f");
+        EXPECT_EQ(chunk.subname(), "x");
+        EXPECT_EQ(chunk.type(), kOutput);
+    }
+
+    // reassembling the chunks reproduces the variable
+    Variable received(kOutput, {25});
+    for (const auto &chunk : stream.written)
+        received.AssignChunk(chunk, WirePrecision::kFloat32);
+    for (size_t i = 0; i < var.Size(); i++)
+        EXPECT_EQ(received(i), var(i));
+}
+
+/*
+	Test that Variable::Send() rejects a zero chunk size
+*/
+TEST(VariableTests, SendZeroChunkSize)
+{
+    Variable var(kInput, {4});
+    RecordingClientReaderWriter<philote::Array, philote::Array> stream;
+
+    EXPECT_THROW(var.Send("x", "", &stream, 0), std::invalid_argument);
+    EXPECT_TRUE(stream.written.empty());
+}
+
+/*
+	Test that filling an existing chunk replaces its previous contents
+*/
+TEST(VariableTests, CreateChunkReusesMessage)
+{
+    Variable var(kInput, {6});
+    std::vector<double> data = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    var.Segment(0, 5, data);
+
+    Array chunk;
+    chunk.set_name("x");
+    var.CreateChunk(0, 3, chunk);
+    EXPECT_EQ(chunk.data_size(), 4);
+
+    var.CreateChunk(4, 5, chunk);
+    ASSERT_EQ(chunk.data_size(), 2);
+    EXPECT_EQ(chunk.data(0), 5.0);
+    EXPECT_EQ(chunk.data(1), 6.0);
+    EXPECT_EQ(chunk.start(), 4);
+    EXPECT_EQ(chunk.end(), 5);
+    EXPECT_EQ(chunk.name(), "x");
+}
+
+/*
+	Test that float32-encoded chunks pack two values per double
+*/
+TEST(VariableTests, Float32ChunkRoundTrip)
+{
+    Variable var(kOutput, {5});
+    std::vector<double> data = {1.0 / 3.0, -2.5, 1e-8, 12345.678, -0.1};
+    var.Segment(0, 4, data);
+
+    Array chunk;
+    var.CreateChunk(0, 4, chunk, WirePrecision::kFloat32);
+    EXPECT_EQ(chunk.start(), 0);
+    EXPECT_EQ(chunk.end(), 4);
+    EXPECT_EQ(chunk.data_size(), 3);
+
+    Variable received(kOutput, {5});
+    received.AssignChunk(chunk, WirePrecision::kFloat32);
+    for (size_t i = 0; i < data.size(); i++)
+        EXPECT_EQ(received(i), static_cast<double>(static_cast<float>(data[i])));
+
+    // single values keep double precision
+    var.CreateChunk(0, 0, chunk, WirePrecision::kFloat32);
+    ASSERT_EQ(chunk.data_size(), 1);
+    EXPECT_EQ(chunk.data(0), 1.0 / 3.0);
+}
+
+/*
+	Test that float32 messages hold twice as many values as the chunk size
+*/
+TEST(VariableTests, SendFloat32DoublesValuesPerChunk)
+{
+    Variable var(kOutput, {25});
+    for (size_t i = 0; i < var.Size(); i++)
+        var(i) = 0.1 * static_cast<double>(i);
+
+    RecordingClientReaderWriter<philote::Array, philote::Array> stream;
+    var.Send("f", "x", &stream, 10, WirePrecision::kFloat32);
+
+    ASSERT_EQ(stream.written.size(), 2u);
+    EXPECT_EQ(stream.written[0].end(), 19);
+    EXPECT_EQ(stream.written[0].data_size(), 10);
+    EXPECT_EQ(stream.written[1].start(), 20);
+    EXPECT_EQ(stream.written[1].end(), 24);
+    EXPECT_EQ(stream.written[1].data_size(), 3);
+
+    Variable received(kOutput, {25});
+    for (const auto &chunk : stream.written)
+        received.AssignChunk(chunk, WirePrecision::kFloat32);
+    for (size_t i = 0; i < var.Size(); i++)
+        EXPECT_EQ(received(i), static_cast<double>(static_cast<float>(var(i))));
+}
+
+/*
+	Test that chunks matching neither encoding are rejected
+*/
+TEST(VariableTests, AssignChunkRejectsMismatchedDataSize)
+{
+    Variable var(kInput, {4});
+
+    Array chunk;
+    chunk.set_start(0);
+    chunk.set_end(3);
+    chunk.add_data(1.0);
+    EXPECT_THROW(var.AssignChunk(chunk), std::length_error);
+
+    chunk.add_data(2.0);
+    chunk.add_data(3.0);
+    EXPECT_THROW(var.AssignChunk(chunk), std::length_error);
+}
+
+/*
+	Test that float32 chunks are only accepted if the call negotiated them
+*/
+TEST(VariableTests, Float32ChunksRequireNegotiation)
+{
+    Variable var(kInput, {4});
+
+    // a truncated double chunk has the size of four float32 values
+    Array chunk;
+    chunk.set_start(0);
+    chunk.set_end(3);
+    chunk.add_data(1.0);
+    chunk.add_data(2.0);
+    std::vector<double> buffer;
+    EXPECT_THROW(var.AssignChunk(chunk), std::length_error);
+    EXPECT_THROW(DecodeChunk(chunk, buffer), std::length_error);
+
+    // double chunks are accepted in float32 calls as well
+    chunk.add_data(3.0);
+    chunk.add_data(4.0);
+    var.AssignChunk(chunk, WirePrecision::kFloat32);
+    EXPECT_EQ(var(3), 4.0);
+    EXPECT_EQ(DecodeChunk(chunk, buffer, WirePrecision::kFloat32)[2], 3.0);
+
+    Variable values(kInput, {4});
+    for (size_t i = 0; i < values.Size(); i++)
+        values(i) = 0.5 * static_cast<double>(i);
+    values.CreateChunk(0, 3, chunk, WirePrecision::kFloat32);
+    EXPECT_THROW(var.AssignChunk(chunk), std::length_error);
+    EXPECT_EQ(DecodeChunk(chunk, buffer, WirePrecision::kFloat32)[3], 1.5);
+}
+
+/*
+	Test the storage and element access of discrete variables
+*/
+TEST(VariableTests, DiscreteStorage)
+{
+    Variable var(kInput, {2, 3}, kDiscrete);
+    EXPECT_TRUE(var.IsDiscrete());
+    EXPECT_EQ(var.Size(), 6u);
+    EXPECT_EQ(var.data(), nullptr);
+    ASSERT_NE(var.discrete_data(), nullptr);
+
+    var.Discrete(4) = -7;
+    EXPECT_EQ(var.discrete_data()[4], -7);
+    EXPECT_THROW(var.Discrete(6), std::out_of_range);
+    EXPECT_THROW(var(0), std::logic_error);
+
+    // doubles are rounded to integers
+    var.Fill(2.6);
+    EXPECT_EQ(var.Discrete(0), 3);
+    var.Segment(1, 2, {-1.4, 8.0});
+    EXPECT_EQ(var.Discrete(1), -1);
+    EXPECT_EQ(var.Segment(1, 2), (std::vector<double>{-1.0, 8.0}));
+
+    Variable copy(var);
+    EXPECT_TRUE(copy.IsDiscrete());
+    EXPECT_EQ(copy.Discrete(2), 8);
+
+    Variable moved(std::move(copy));
+    EXPECT_TRUE(moved.IsDiscrete());
+    EXPECT_EQ(moved.Discrete(2), 8);
+
+    Variable continuous(kInput, {2});
+    EXPECT_FALSE(continuous.IsDiscrete());
+    EXPECT_EQ(continuous.discrete_data(), nullptr);
+    EXPECT_THROW(continuous.Discrete(0), std::logic_error);
+}
+
+/*
+	Test that integer-encoded chunks round trip and are compact
+*/
+TEST(VariableTests, IntegerChunkRoundTrip)
+{
+    const std::vector<int64_t> values = {0, 1, -1, 63, -64, 300, std::numeric_limits<int64_t>::max(),
+                                         std::numeric_limits<int64_t>::min()};
+    Variable var(kOutput, {values.size()}, kDiscrete);
+    for (size_t i = 0; i < values.size(); i++)
+        var.Discrete(i) = values[i];
+
+    Array chunk;
+    var.CreateChunk(0, values.size() - 1, chunk, WirePrecision::kInteger);
+    EXPECT_TRUE(IsDiscreteChunk(chunk));
+    EXPECT_EQ(chunk.data_size(), 4);
+
+    Variable received(kOutput, {values.size()}, kDiscrete);
+    received.AssignChunk(chunk);
+    for (size_t i = 0; i < values.size(); i++)
+        EXPECT_EQ(received.Discrete(i), values[i]);
+
+    // continuous receivers get doubles
+    Variable small(kOutput, {3}, kDiscrete);
+    small.Segment(0, 2, {5.0, -2.0, 40.0});
+    small.CreateChunk(0, 2, chunk, WirePrecision::kInteger);
+    EXPECT_EQ(chunk.data_size(), 1);
+    Variable doubles(kOutput, {3});
+    doubles.AssignChunk(chunk);
+    EXPECT_EQ(doubles(2), 40.0);
+
+    std::vector<double> buffer;
+    EXPECT_EQ(DecodeChunk(chunk, buffer)[1], -2.0);
+
+    // without integer encoding, discrete values are sent as doubles
+    small.CreateChunk(0, 2, chunk, WirePrecision::kDouble);
+    EXPECT_FALSE(IsDiscreteChunk(chunk));
+    ASSERT_EQ(chunk.data_size(), 3);
+    EXPECT_EQ(chunk.data(0), 5.0);
+    received = Variable(kOutput, {3}, kDiscrete);
+    received.AssignChunk(chunk);
+    EXPECT_EQ(received.Discrete(1), -2);
+}
+
+/*
+	Test that integer encoding does not overwrite the subname of a message
+*/
+TEST(VariableTests, CreateChunkRejectsSubnamedIntegerChunks)
+{
+    Variable var(kOutput, {3}, kDiscrete);
+    Array chunk;
+    chunk.set_subname("x");
+    EXPECT_THROW(var.CreateChunk(0, 2, chunk, WirePrecision::kInteger), std::invalid_argument);
+    EXPECT_EQ(chunk.subname(), "x");
+
+    std::vector<Array> messages;
+    EXPECT_THROW(var.Send("y", "x", &messages, 10, WirePrecision::kInteger), std::invalid_argument);
+
+    // reused integer chunks keep their marker
+    chunk.clear_subname();
+    var.CreateChunk(0, 2, chunk, WirePrecision::kInteger);
+    var.CreateChunk(0, 1, chunk, WirePrecision::kInteger);
+    EXPECT_TRUE(IsDiscreteChunk(chunk));
+}
+
+/*
+	Test that truncated or padded integer chunks are rejected
+*/
+TEST(VariableTests, AssignChunkRejectsMalformedIntegers)
+{
+    Variable var(kInput, {2}, kDiscrete);
+
+    Array chunk;
+    chunk.set_start(0);
+    chunk.set_end(1);
+    chunk.set_subname(kDiscreteChunkSubname);
+    EXPECT_THROW(var.AssignChunk(chunk), std::length_error);
+
+    // two varints followed by a second, unused double
+    chunk.add_data(0.0);
+    chunk.add_data(0.0);
+    EXPECT_THROW(var.AssignChunk(chunk), std::length_error);
+}
+
+/*
+	Test that integer messages stay within the chunk size for ten-byte values
+*/
+TEST(VariableTests, SendIntegersWithinChunkSize)
+{
+    Variable var(kOutput, {25}, kDiscrete);
+    var.Fill(-1.0);
+    var.Discrete(3) = std::numeric_limits<int64_t>::min();
+
+    RecordingClientReaderWriter<philote::Array, philote::Array> stream;
+    var.Send("n", "", &stream, 10, WirePrecision::kInteger);
+
+    ASSERT_EQ(stream.written.size(), 4u);
+    EXPECT_EQ(stream.written[0].end(), 7);
+    for (const auto &chunk : stream.written)
+        EXPECT_LE(chunk.data_size(), 10);
+
+    Variable received(kOutput, {25}, kDiscrete);
+    for (const auto &chunk : stream.written)
+        received.AssignChunk(chunk, WirePrecision::kFloat32);
+    EXPECT_EQ(received.Discrete(3), std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(received.Discrete(24), -1);
+}
+
+/*
+	Test views of external storage
+*/
+TEST(VariableTests, ViewWritesThroughToStorage)
+{
+    std::vector<double> storage(6, 0.0);
+    Variable view(philote::kInput, {2, 3}, storage.data());
+
+    EXPECT_TRUE(view.IsView());
+    EXPECT_EQ(view.Size(), 6u);
+    EXPECT_EQ(view.data(), storage.data());
+
+    view(4) = 2.5;
+    view.Fill(1.0);
+    view(0) = 3.0;
+    EXPECT_EQ(storage[0], 3.0);
+    EXPECT_EQ(storage[4], 1.0);
+
+    // the chunk interface reads and writes the external storage
+    philote::Array chunk;
+    chunk.set_start(1);
+    chunk.set_end(2);
+    chunk.add_data(7.0);
+    chunk.add_data(8.0);
+    view.AssignChunk(chunk);
+    EXPECT_EQ(storage[1], 7.0);
+    EXPECT_EQ(storage[2], 8.0);
+    EXPECT_EQ(view.CreateChunk(0, 2).data(2), 8.0);
+}
+
+/*
+	Test that copies of views own their data
+*/
+TEST(VariableTests, CopyOfViewOwnsData)
+{
+    std::vector<double> storage = {1.0, 2.0, 3.0};
+    Variable view(philote::kOutput, {3}, storage.data());
+
+    Variable copy(view);
+    EXPECT_FALSE(copy.IsView());
+    EXPECT_NE(copy.data(), storage.data());
+    copy(0) = 5.0;
+    EXPECT_EQ(storage[0], 1.0);
+    EXPECT_EQ(copy(1), 2.0);
+
+    Variable assigned;
+    assigned = view;
+    EXPECT_FALSE(assigned.IsView());
+    EXPECT_EQ(assigned.Size(), 3u);
+
+    // moving keeps the view
+    Variable moved(std::move(view));
+    EXPECT_TRUE(moved.IsView());
+    EXPECT_EQ(moved.data(), storage.data());
+}
+
+/*
+	Test that owned storage is aligned for vector loads
+*/
+TEST(VariableTests, OwnedStorageIsAligned)
+{
+    for (size_t n : {1u, 3u, 17u, 1000u})
+    {
+        Variable var(philote::kInput, {n});
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(var.data()) % philote::kSimdAlignment, 0u);
+
+        Variable copy(var);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(copy.data()) % philote::kSimdAlignment, 0u);
+
+        Variable discrete(philote::kInput, {n}, philote::kDiscrete);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(discrete.discrete_data()) % philote::kSimdAlignment, 0u);
+    }
+}
+
+/*
+	Test the view accessors of continuous and discrete variables
+*/
+TEST(VariableTests, ValuesViewTheStorage)
+{
+    Variable var(philote::kInput, {2, 2});
+    philote::ArrayView<double> values = var.values();
+    EXPECT_EQ(values.data(), var.data());
+    EXPECT_EQ(values.size(), 4u);
+
+    for (size_t i = 0; i < values.size(); i++)
+        values[i] = static_cast<double>(i);
+    EXPECT_EQ(var(3), 3.0);
+
+    const Variable &constant = var;
+    double sum = 0.0;
+    for (double value : constant.values())
+        sum += value;
+    EXPECT_EQ(sum, 6.0);
+    EXPECT_TRUE(constant.discrete_values().empty());
+
+    // views of external storage expose that storage
+    std::vector<double> storage = {1.0, 2.0};
+    Variable view(philote::kOutput, {2}, storage.data());
+    EXPECT_EQ(view.values().data(), storage.data());
+
+    Variable discrete(philote::kInput, {3}, philote::kDiscrete);
+    EXPECT_TRUE(discrete.values().empty());
+    discrete.discrete_values()[2] = 7;
+    EXPECT_EQ(discrete.Discrete(2), 7);
+    EXPECT_EQ(discrete.discrete_values().size(), 3u);
+}
+
+/*
+	Test that a view requires storage
+*/
+TEST(VariableTests, ViewRejectsNullStorage)
+{
+    EXPECT_THROW(Variable(philote::kInput, {2}, nullptr), std::invalid_argument);
+}
+
+/*
+	Test expanding sparse partial values into the dense partial
+*/
+TEST(VariableTests, SparsityPatternDensify)
+{
+    philote::SparsityPattern pattern;
+    pattern.rows = {0, 1};
+    pattern.cols = {2, 0};
+    pattern.num_cols = 3;
+    pattern.dense_shape = {2, 3};
+
+    Variable values(philote::kPartial, {2});
+    values(0) = 4.0;
+    values(1) = 5.0;
+
+    Variable dense = pattern.Densify(values);
+    EXPECT_EQ(dense.Shape(), (std::vector<size_t>{2, 3}));
+    EXPECT_EQ(dense(2), 4.0);
+    EXPECT_EQ(dense(3), 5.0);
+    EXPECT_EQ(dense(0), 0.0);
+
+    EXPECT_THROW(pattern.Densify(Variable(philote::kPartial, {3})), std::length_error);
+
+    pattern.cols[0] = 3;
+    EXPECT_THROW(pattern.Densify(values), std::out_of_range);
+}
@@ -0,0 +1,161 @@
+/*
+    Philote C++ Bindings
+
+    Copyright 2022-2025 Christopher A. Lupp
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+
+    This work has been cleared for public release, distribution unlimited, case
+    number: AFRL-2023-5716.
+
+    The views expressed are those of the authors and do not reflect the
+    official guidance or position of the United States Government, the
+    Department of Defense or of the United States Air Force.
+
+    Statement from DoD: The Appearance of external hyperlinks does not
+    constitute endorsement by the United States Department of Defense (DoD) of
+    the linked websites, of the information, products, or services contained
+    therein. The DoD does not exercise any editorial, security, or other
+    control over the information you may find at these locations.
+*/
+#include <gtest/gtest.h>
+
+#include <explicit.h>
+#include <workspace.h>
+
+using philote::ExplicitDiscipline;
+using philote::kInput;
+using philote::kOutput;
+using philote::PartialsMetaData;
+using philote::VariableMetaData;
+using philote::Workspace;
+using philote::WorkspaceCache;
+
+namespace
+{
+    class WorkspaceDiscipline : public ExplicitDiscipline
+    {
+    public:
+        void Setup() override
+        {
+            AddInput("x", {3}, "m");
+            AddOutput("f", {2}, "m");
+        }
+
+        void SetupPartials() override
+        {
+            DeclarePartials("f", "x");
+        }
+    };
+}
+
+TEST(WorkspaceTests, BuildsVariablesFromMetaData)
+{
+    WorkspaceDiscipline discipline;
+    discipline.Setup();
+    discipline.SetupPartials();
+
+    Workspace workspace(discipline.var_meta(), discipline.partials_meta(), 7);
+
+    EXPECT_EQ(workspace.generation, 7u);
+    ASSERT_EQ(workspace.inputs.map().count("x"), 1u);
+    EXPECT_EQ(workspace.inputs.at("x").Size(), 3u);
+    ASSERT_EQ(workspace.outputs.map().count("f"), 1u);
+    EXPECT_EQ(workspace.outputs.at("f").Size(), 2u);
+    EXPECT_EQ(workspace.residuals.at("f").Size(), 2u);
+    EXPECT_EQ((workspace.partials.at({"f", "x"}).Size()), 6u);
+    EXPECT_EQ(workspace.types.at("x"), kInput);
+    EXPECT_EQ(workspace.types.at("f"), kOutput);
+}
+
+TEST(WorkspaceTests, ReusesAndZeroesWorkspaces)
+{
+    WorkspaceDiscipline discipline;
+    discipline.Setup();
+    discipline.SetupPartials();
+
+    const Workspace *first = nullptr;
+    {
+        WorkspaceCache::Lease workspace = discipline.AcquireWorkspace();
+        first = workspace.get();
+        workspace->inputs.at("x")(1) = 4.0;
+        workspace->outputs.at("f")(0) = 5.0;
+        workspace->partials.at({"f", "x"})(3) = 6.0;
+    }
+
+    WorkspaceCache::Lease workspace = discipline.AcquireWorkspace();
+    EXPECT_EQ(workspace.get(), first);
+    EXPECT_DOUBLE_EQ(workspace->inputs.at("x")(1), 0.0);
+    EXPECT_DOUBLE_EQ(workspace->outputs.at("f")(0), 0.0);
+    EXPECT_DOUBLE_EQ((workspace->partials.at({"f", "x"})(3)), 0.0);
+}
+
+TEST(WorkspaceTests, ConcurrentLeasesUseSeparateWorkspaces)
+{
+    WorkspaceDiscipline discipline;
+    discipline.Setup();
+
+    WorkspaceCache::Lease first = discipline.AcquireWorkspace();
+    WorkspaceCache::Lease second = discipline.AcquireWorkspace();
+    EXPECT_NE(first.get(), second.get());
+}
+
+TEST(WorkspaceTests, ConfigurationChangeInvalidatesWorkspaces)
+{
+    WorkspaceDiscipline discipline;
+    discipline.Setup();
+
+    uint64_t generation = 0;
+    {
+        WorkspaceCache::Lease workspace = discipline.AcquireWorkspace();
+        generation = workspace->generation;
+    }
+
+    discipline.MarkConfigurationChanged();
+
+    WorkspaceCache::Lease workspace = discipline.AcquireWorkspace();
+    EXPECT_NE(workspace->generation, generation);
+    EXPECT_EQ(workspace->generation, discipline.configuration_generation());
+}
+
+TEST(WorkspaceTests, MetaDataChangeInvalidatesWorkspaces)
+{
+    WorkspaceDiscipline discipline;
+    discipline.Setup();
+
+    {
+        WorkspaceCache::Lease workspace = discipline.AcquireWorkspace();
+        EXPECT_EQ(workspace->inputs.count(), 1u);
+    }
+
+    discipline.AddInput("y", {1}, "m");
+
+    WorkspaceCache::Lease workspace = discipline.AcquireWorkspace();
+    EXPECT_EQ(workspace->inputs.count(), 2u);
+}
+
+TEST(WorkspaceTests, ClearDiscardsIdleWorkspaces)
+{
+    WorkspaceCache cache;
+    std::vector<VariableMetaData> var_meta;
+    std::vector<PartialsMetaData> partials_meta;
+
+    {
+        WorkspaceCache::Lease workspace = cache.Acquire(var_meta, partials_meta, 0);
+        EXPECT_TRUE(workspace);
+    }
+    EXPECT_EQ(cache.idle(), 1u);
+
+    cache.Clear();
+    EXPECT_EQ(cache.idle(), 0u);
+}